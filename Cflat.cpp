@@ -30,6 +30,18 @@
 
 #include "Cflat.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+# define CflatMemoryMappedFiles
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 
 //
 //  Internal definitions
@@ -50,6 +62,12 @@ namespace Cflat
       return pA > pB ? pA : pB;
    }
 
+   static uint64_t getTime()
+   {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()).count();
+   }
+
    Hash hash(const char* pString)
    {
       static const Hash kOffsetBasis = 2166136261u;
@@ -67,6 +85,53 @@ namespace Cflat
       return hash;
    }
 
+   Hash hash(const char* pString, size_t pLength)
+   {
+      static const Hash kOffsetBasis = 2166136261u;
+      static const Hash kFNVPrime = 16777619u;
+
+      Hash hash = kOffsetBasis;
+
+      for(size_t i = 0u; i < pLength; i++)
+      {
+         hash ^= pString[i];
+         hash *= kFNVPrime;
+      }
+
+      return hash;
+   }
+
+   Hash hash(const Token* pTokens, size_t pTokensCount, bool pIncludeLines)
+   {
+      static const Hash kOffsetBasis = 2166136261u;
+      static const Hash kFNVPrime = 16777619u;
+
+      Hash hash = kOffsetBasis;
+
+      for(size_t i = 0u; i < pTokensCount; i++)
+      {
+         const Token& token = pTokens[i];
+
+         for(size_t j = 0u; j < token.mLength; j++)
+         {
+            hash ^= token.mStart[j];
+            hash *= kFNVPrime;
+         }
+
+         // relative to the first token, so moving the tokens around does not alter the hash
+         if(pIncludeLines)
+         {
+            hash ^= (Hash)(token.mLine - pTokens[0].mLine);
+            hash *= kFNVPrime;
+         }
+
+         hash ^= '\0';
+         hash *= kFNVPrime;
+      }
+
+      return hash;
+   }
+
    template<typename T>
    void toArgsVector(const CflatSTLVector(T) pSTLVector, CflatArgsVector(T)& pArgsVector)
    {
@@ -80,6 +145,116 @@ namespace Cflat
    }
 
 
+   //
+   //  Execution context bound to the calling thread
+   //
+   struct ExecutionContextBinding
+   {
+      const Environment* mEnvironment;
+      ExecutionContext* mContext;
+   };
+
+   static thread_local ExecutionContextBinding gExecutionContextBinding = { nullptr, nullptr };
+
+   // used to give each environment a unique ID
+   static std::atomic<uint32_t> gEnvironmentsCount(0u);
+
+
+   //
+   //  Script file contents
+   //
+   class SourceFile
+   {
+   private:
+      char* mCode;
+      size_t mSize;
+      bool mMapped;
+
+   public:
+      SourceFile()
+         : mCode(nullptr)
+         , mSize(0u)
+         , mMapped(false)
+      {
+      }
+
+      ~SourceFile()
+      {
+#if defined CflatMemoryMappedFiles
+         if(mMapped)
+         {
+            munmap(mCode, mSize);
+            return;
+         }
+#endif
+         if(mCode)
+         {
+            CflatDeallocate(mCode);
+         }
+      }
+
+      bool read(const char* pFilePath)
+      {
+#if defined CflatMemoryMappedFiles
+         // the file gets mapped when its last page has room for the null terminator, since the
+         // rest of the page is filled with zeros
+         const int fileDescriptor = ::open(pFilePath, O_RDONLY);
+
+         if(fileDescriptor < 0)
+         {
+            return false;
+         }
+
+         struct stat fileStatus;
+         const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+         if(fstat(fileDescriptor, &fileStatus) == 0 &&
+            fileStatus.st_size > 0 &&
+            ((size_t)fileStatus.st_size % pageSize) != 0u)
+         {
+            void* mapping = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE,
+               fileDescriptor, 0);
+
+            if(mapping != MAP_FAILED)
+            {
+               mCode = (char*)mapping;
+               mSize = (size_t)fileStatus.st_size;
+               mMapped = true;
+            }
+         }
+
+         ::close(fileDescriptor);
+
+         if(mMapped)
+         {
+            return true;
+         }
+#endif
+         FILE* file = fopen(pFilePath, "rb");
+
+         if(!file)
+            return false;
+
+         fseek(file, 0, SEEK_END);
+         mSize = (size_t)ftell(file);
+         rewind(file);
+
+         mCode = (char*)CflatAllocate(mSize + 1u, SyntaxTree);
+         mCode[mSize] = '\0';
+
+         fread(mCode, 1u, mSize, file);
+         fclose(file);
+
+         return true;
+      }
+
+      const char* getCode() const
+      {
+         return mCode;
+      }
+   };
+
+
    //
    //  AST Types
    //
@@ -115,6 +290,9 @@ namespace Cflat
       }
 
    public:
+      // type of the value the expression evaluates to, resolved once the expression gets parsed
+      TypeUsage mValueTypeUsage;
+
       virtual ~Expression()
       {
       }
@@ -129,13 +307,25 @@ namespace Cflat
    {
       Value mValue;
 
+      // pool holding the string, for string literals, which get released along with the expression
+      Memory::StringsPool* mStringsPool;
+
       ExpressionValue(const Value& pValue)
+         : mStringsPool(nullptr)
       {
          mType = ExpressionType::Value;
 
          mValue.initOnHeap(pValue.mTypeUsage);
          mValue.set(pValue.mValueBuffer);
       }
+
+      virtual ~ExpressionValue()
+      {
+         if(mStringsPool)
+         {
+            mStringsPool->releaseString(CflatValueAs(&mValue, const char*));
+         }
+      }
    };
 
    struct ExpressionNullPointer : Expression
@@ -148,10 +338,19 @@ namespace Cflat
 
    struct ExpressionVariableAccess : Expression
    {
+      static const uint32_t kInvalidLocalSlot = UINT32_MAX;
+
       Identifier mVariableIdentifier;
 
+      // resolved at parse time: namespace-level variables and static members get bound to their
+      // instance, whereas local variables get an index relative to the frame of their function
+      Instance* mInstance;
+      uint32_t mLocalSlot;
+
       ExpressionVariableAccess(const Identifier& pVariableIdentifier)
          : mVariableIdentifier(pVariableIdentifier)
+         , mInstance(nullptr)
+         , mLocalSlot(kInvalidLocalSlot)
       {
          mType = ExpressionType::VariableAccess;
       }
@@ -160,7 +359,6 @@ namespace Cflat
    struct ExpressionMemberAccess : Expression
    {
       Expression* mMemberOwner;
-      Value mMemberOwnerValue;
       Identifier mMemberIdentifier;
       TypeUsage mMemberTypeUsage;
 
@@ -178,7 +376,6 @@ namespace Cflat
          if(mMemberOwner)
          {
             CflatInvokeDtor(Expression, mMemberOwner);
-            CflatFree(mMemberOwner);
          }
       }
    };
@@ -200,13 +397,11 @@ namespace Cflat
          if(mArray)
          {
             CflatInvokeDtor(Expression, mArray);
-            CflatFree(mArray);
          }
 
          if(mArrayElementIndex)
          {
             CflatInvokeDtor(Expression, mArrayElementIndex);
-            CflatFree(mArrayElementIndex);
          }
       }
    };
@@ -214,15 +409,15 @@ namespace Cflat
    struct ExpressionUnaryOperation : Expression
    {
       Expression* mExpression;
-      char mOperator[3];
+      OperatorType mOperator;
       bool mPostOperator;
 
-      ExpressionUnaryOperation(Expression* pExpression, const char* pOperator, bool pPostOperator)
+      ExpressionUnaryOperation(Expression* pExpression, OperatorType pOperator, bool pPostOperator)
          : mExpression(pExpression)
+         , mOperator(pOperator)
          , mPostOperator(pPostOperator)
       {
          mType = ExpressionType::UnaryOperation;
-         strcpy(mOperator, pOperator);
       }
 
       virtual ~ExpressionUnaryOperation()
@@ -230,7 +425,6 @@ namespace Cflat
          if(mExpression)
          {
             CflatInvokeDtor(Expression, mExpression);
-            CflatFree(mExpression);
          }
       }
    };
@@ -239,17 +433,28 @@ namespace Cflat
    {
       Expression* mLeft;
       Expression* mRight;
-      char mOperator[4];
+      OperatorType mOperator;
+      OperationKernel mKernel;
       TypeUsage mOverloadedOperatorTypeUsage;
 
-      ExpressionBinaryOperation(Expression* pLeft, Expression* pRight, const char* pOperator,
-         const TypeUsage& pOverloadedOperatorTypeUsage)
+      // overloaded operator resolved when parsing (either a method or a function); the method is
+      // kept as a position in mMethods, which gets reallocated when more methods are registered
+      Struct* mOperatorMethodOwner;
+      size_t mOperatorMethodIndex;
+      Function* mOperatorFunction;
+
+      ExpressionBinaryOperation(Expression* pLeft, Expression* pRight, OperatorType pOperator,
+         OperationKernel pKernel, const TypeUsage& pOverloadedOperatorTypeUsage)
          : mLeft(pLeft)
          , mRight(pRight)
+         , mOperator(pOperator)
+         , mKernel(pKernel)
          , mOverloadedOperatorTypeUsage(pOverloadedOperatorTypeUsage)
+         , mOperatorMethodOwner(nullptr)
+         , mOperatorMethodIndex(SIZE_MAX)
+         , mOperatorFunction(nullptr)
       {
          mType = ExpressionType::BinaryOperation;
-         strcpy(mOperator, pOperator);
       }
 
       virtual ~ExpressionBinaryOperation()
@@ -257,13 +462,11 @@ namespace Cflat
          if(mLeft)
          {
             CflatInvokeDtor(Expression, mLeft);
-            CflatFree(mLeft);
          }
 
          if(mRight)
          {
             CflatInvokeDtor(Expression, mRight);
-            CflatFree(mRight);
          }
       }
    };
@@ -283,7 +486,6 @@ namespace Cflat
          if(mExpression)
          {
             CflatInvokeDtor(Expression, mExpression);
-            CflatFree(mExpression);
          }
       }
    };
@@ -303,7 +505,6 @@ namespace Cflat
          if(mExpression)
          {
             CflatInvokeDtor(Expression, mExpression);
-            CflatFree(mExpression);
          }
       }
    };
@@ -323,7 +524,6 @@ namespace Cflat
          if(mExpression)
          {
             CflatInvokeDtor(Expression, mExpression);
-            CflatFree(mExpression);
          }
       }
    };
@@ -344,7 +544,6 @@ namespace Cflat
          if(mExpression)
          {
             CflatInvokeDtor(Expression, mExpression);
-            CflatFree(mExpression);
          }
       }
    };
@@ -368,7 +567,6 @@ namespace Cflat
          if(mExpression)
          {
             CflatInvokeDtor(Expression, mExpression);
-            CflatFree(mExpression);
          }
       }
    };
@@ -393,19 +591,16 @@ namespace Cflat
          if(mCondition)
          {
             CflatInvokeDtor(Expression, mCondition);
-            CflatFree(mCondition);
          }
 
          if(mIfExpression)
          {
             CflatInvokeDtor(Expression, mIfExpression);
-            CflatFree(mIfExpression);
          }
 
          if(mElseExpression)
          {
             CflatInvokeDtor(Expression, mElseExpression);
-            CflatFree(mElseExpression);
          }
       }
    };
@@ -414,14 +609,17 @@ namespace Cflat
    {
       Expression* mLeftValue;
       Expression* mRightValue;
-      char mOperator[4];
+      OperatorType mOperator;
+      OperationKernel mKernel;
 
-      ExpressionAssignment(Expression* pLeftValue, Expression* pRightValue, const char* pOperator)
+      ExpressionAssignment(Expression* pLeftValue, Expression* pRightValue, OperatorType pOperator,
+         OperationKernel pKernel)
          : mLeftValue(pLeftValue)
          , mRightValue(pRightValue)
+         , mOperator(pOperator)
+         , mKernel(pKernel)
       {
          mType = ExpressionType::Assignment;
-         strcpy(mOperator, pOperator);
       }
 
       virtual ~ExpressionAssignment()
@@ -429,13 +627,11 @@ namespace Cflat
          if(mLeftValue)
          {
             CflatInvokeDtor(Expression, mLeftValue);
-            CflatFree(mLeftValue);
          }
 
          if(mRightValue)
          {
             CflatInvokeDtor(Expression, mRightValue);
-            CflatFree(mRightValue);
          }
       }
    };
@@ -459,7 +655,6 @@ namespace Cflat
          for(size_t i = 0u; i < mArguments.size(); i++)
          {
             CflatInvokeDtor(Expression, mArguments[i]);
-            CflatFree(mArguments[i]);
          }
       }
    };
@@ -483,13 +678,11 @@ namespace Cflat
          if(mMemberAccess)
          {
             CflatInvokeDtor(Expression, mMemberAccess);
-            CflatFree(mMemberAccess);
          }
 
          for(size_t i = 0u; i < mArguments.size(); i++)
          {
             CflatInvokeDtor(Expression, mArguments[i]);
-            CflatFree(mArguments[i]);
          }
       }
    };
@@ -510,7 +703,6 @@ namespace Cflat
          for(size_t i = 0u; i < mValues.size(); i++)
          {
             CflatInvokeDtor(Expression, mValues[i]);
-            CflatFree(mValues[i]);
          }
       }
    };
@@ -533,12 +725,55 @@ namespace Cflat
          for(size_t i = 0u; i < mArguments.size(); i++)
          {
             CflatInvokeDtor(Expression, mArguments[i]);
-            CflatFree(mArguments[i]);
          }
       }
    };
 
 
+   enum class InstructionType : uint8_t
+   {
+      Statement,     // executes a statement walking its tree
+      Expression,    // evaluates an expression, discarding its value
+      BlockBegin,
+      BlockEnd,
+      ScopeBegin,
+      ScopeEnd,
+      Jump,
+      JumpIfFalse,
+      JumpIfTrue,
+      Leave,         // unwinds blocks and scopes down to a given depth, then jumps
+      Switch
+   };
+
+   struct Instruction
+   {
+      InstructionType mType;
+      bool mAlterScope;
+      uint16_t mBlockDepth;
+      uint16_t mScopeDepth;
+      uint32_t mOperand;
+      Statement* mStatement;
+      Expression* mExpression;
+
+      Instruction(InstructionType pType, Statement* pStatement, Expression* pExpression)
+         : mType(pType)
+         , mAlterScope(false)
+         , mBlockDepth(0u)
+         , mScopeDepth(0u)
+         , mOperand(0u)
+         , mStatement(pStatement)
+         , mExpression(pExpression)
+      {
+      }
+   };
+
+   struct Bytecode
+   {
+      CflatSTLVector(Instruction) mInstructions;
+      CflatSTLVector(uint32_t) mCaseTargets;
+   };
+
+
    enum class StatementType
    {
       Expression,
@@ -600,7 +835,6 @@ namespace Cflat
          if(mExpression)
          {
             CflatInvokeDtor(Expression, mExpression);
-            CflatFree(mExpression);
          }
       }
    };
@@ -621,7 +855,6 @@ namespace Cflat
          for(size_t i = 0u; i < mStatements.size(); i++)
          {
             CflatInvokeDtor(Statement, mStatements[i]);
-            CflatFree(mStatements[i]);
          }
       }
    };
@@ -667,12 +900,19 @@ namespace Cflat
       Expression* mInitialValue;
       bool mStatic;
 
+      // instance of a static local variable, shared by all the execution contexts, which the
+      // accesses to the variable get bound to while parsing
+      Instance* mStaticInstance;
+      std::atomic<bool> mStaticInstanceInitialized;
+
       StatementVariableDeclaration(const TypeUsage& pTypeUsage, const Identifier& pVariableIdentifier,
-         Expression* pInitialValue, bool pStatic)
+         Expression* pInitialValue, bool pStatic, Instance* pStaticInstance = nullptr)
          : mTypeUsage(pTypeUsage)
          , mVariableIdentifier(pVariableIdentifier)
          , mInitialValue(pInitialValue)
          , mStatic(pStatic)
+         , mStaticInstance(pStaticInstance)
+         , mStaticInstanceInitialized(false)
       {
          mType = StatementType::VariableDeclaration;
       }
@@ -682,7 +922,12 @@ namespace Cflat
          if(mInitialValue)
          {
             CflatInvokeDtor(Expression, mInitialValue);
-            CflatFree(mInitialValue);
+         }
+
+         if(mStaticInstance)
+         {
+            CflatInvokeDtor(Instance, mStaticInstance);
+            CflatDeallocate(mStaticInstance);
          }
       }
    };
@@ -704,7 +949,6 @@ namespace Cflat
          if(mBody)
          {
             CflatInvokeDtor(StatementBlock, mBody);
-            CflatFree(mBody);
          }
       }
    };
@@ -716,13 +960,17 @@ namespace Cflat
       CflatSTLVector(Identifier) mParameterIdentifiers;
       CflatSTLVector(TypeUsage) mParameterTypes;
       StatementBlock* mBody;
+      Bytecode* mBytecode;
       Function* mFunction;
+      Namespace* mNamespace;
 
       StatementFunctionDeclaration(const TypeUsage& pReturnType, const Identifier& pFunctionIdentifier)
          : mReturnType(pReturnType)
          , mFunctionIdentifier(pFunctionIdentifier)
          , mBody(nullptr)
+         , mBytecode(nullptr)
          , mFunction(nullptr)
+         , mNamespace(nullptr)
       {
          mType = StatementType::FunctionDeclaration;
       }
@@ -732,13 +980,23 @@ namespace Cflat
          if(mBody)
          {
             CflatInvokeDtor(StatementBlock, mBody);
-            CflatFree(mBody);
+         }
+
+         if(mBytecode)
+         {
+            CflatInvokeDtor(Bytecode, mBytecode);
+            CflatDeallocate(mBytecode);
          }
 
          if(mFunction && mFunction->mProgram == mProgram)
          {
             mFunction->execute = nullptr;
          }
+
+         if(mFunction && mFunction->mDeclaration == this)
+         {
+            mFunction->mDeclaration = nullptr;
+         }
       }
    };
 
@@ -772,19 +1030,16 @@ namespace Cflat
          if(mCondition)
          {
             CflatInvokeDtor(Expression, mCondition);
-            CflatFree(mCondition);
          }
 
          if(mIfStatement)
          {
             CflatInvokeDtor(Statement, mIfStatement);
-            CflatFree(mIfStatement);
          }
 
          if(mElseStatement)
          {
             CflatInvokeDtor(Statement, mElseStatement);
-            CflatFree(mElseStatement);
          }
       }
    };
@@ -800,18 +1055,65 @@ namespace Cflat
       Expression* mCondition;
       CflatSTLVector(CaseSection) mCaseSections;
 
+      // when all the case labels are constants, the case section to start executing from gets
+      // looked up by value instead of evaluating the labels one after the other: straight from a
+      // table if the values are dense enough, or through a binary search over them otherwise
+      struct CaseLookupEntry
+      {
+         int64_t mValue;
+         size_t mCaseSectionIndex;
+      };
+      CflatSTLVector(CaseLookupEntry) mSortedCases;
+      CflatSTLVector(size_t) mJumpTable;
+      int64_t mJumpTableFirstValue;
+      size_t mDefaultCaseSectionIndex;
+      bool mCaseLookup;
+
       StatementSwitch(Expression* pCondition)
          : mCondition(pCondition)
+         , mJumpTableFirstValue(0)
+         , mDefaultCaseSectionIndex(0u)
+         , mCaseLookup(false)
       {
          mType = StatementType::Switch;
       }
 
+      // returns the number of case sections when none of them gets executed
+      size_t findCaseSection(int64_t pValue) const
+      {
+         if(!mJumpTable.empty())
+         {
+            const uint64_t offset = (uint64_t)pValue - (uint64_t)mJumpTableFirstValue;
+            return offset < mJumpTable.size() ? mJumpTable[offset] : mDefaultCaseSectionIndex;
+         }
+
+         size_t first = 0u;
+         size_t last = mSortedCases.size();
+
+         while(first < last)
+         {
+            const size_t middle = first + (last - first) / 2u;
+
+            if(mSortedCases[middle].mValue < pValue)
+            {
+               first = middle + 1u;
+            }
+            else
+            {
+               last = middle;
+            }
+         }
+
+         return first < mSortedCases.size() && mSortedCases[first].mValue == pValue
+            ? mSortedCases[first].mCaseSectionIndex
+            : mDefaultCaseSectionIndex;
+      }
+
       virtual ~StatementSwitch()
       {
          if(mCondition)
          {
             CflatInvokeDtor(Expression, mCondition);
-            CflatFree(mCondition);
          }
 
          for(size_t i = 0u; i < mCaseSections.size(); i++)
@@ -819,7 +1121,6 @@ namespace Cflat
             if(mCaseSections[i].mExpression)
             {
                CflatInvokeDtor(Expression, mCaseSections[i].mExpression);
-               CflatFree(mCaseSections[i].mExpression);
             }
 
             for(size_t j = 0u; j < mCaseSections[i].mStatements.size(); j++)
@@ -827,7 +1128,6 @@ namespace Cflat
                if(mCaseSections[i].mStatements[j])
                {
                   CflatInvokeDtor(Statement, mCaseSections[i].mStatements[j]);
-                  CflatFree(mCaseSections[i].mStatements[j]);
                }
             }
          }
@@ -851,13 +1151,11 @@ namespace Cflat
          if(mCondition)
          {
             CflatInvokeDtor(Expression, mCondition);
-            CflatFree(mCondition);
          }
 
          if(mLoopStatement)
          {
             CflatInvokeDtor(Statement, mLoopStatement);
-            CflatFree(mLoopStatement);
          }
       }
    };
@@ -893,25 +1191,21 @@ namespace Cflat
          if(mInitialization)
          {
             CflatInvokeDtor(Statement, mInitialization);
-            CflatFree(mInitialization);
          }
 
          if(mCondition)
          {
             CflatInvokeDtor(Expression, mCondition);
-            CflatFree(mCondition);
          }
 
          if(mIncrement)
          {
             CflatInvokeDtor(Expression, mIncrement);
-            CflatFree(mIncrement);
          }
 
          if(mLoopStatement)
          {
             CflatInvokeDtor(Statement, mLoopStatement);
-            CflatFree(mLoopStatement);
          }
       }
    };
@@ -938,13 +1232,11 @@ namespace Cflat
          if(mCollection)
          {
             CflatInvokeDtor(Expression, mCollection);
-            CflatFree(mCollection);
          }
 
          if(mLoopStatement)
          {
             CflatInvokeDtor(Statement, mLoopStatement);
-            CflatFree(mLoopStatement);
          }
       }
    };
@@ -980,1682 +1272,1937 @@ namespace Cflat
          if(mExpression)
          {
             CflatInvokeDtor(Expression, mExpression);
-            CflatFree(mExpression);
          }
       }
    };
 
 
    //
-   //  Error messages
+   //  Bytecode compiler
    //
-   const char* kPreprocessorErrorStrings[] = 
+   class BytecodeCompiler
    {
-      "invalid preprocessor directive",
-      "invalid number of arguments for the '%s' macro"
-   };
-   const size_t kPreprocessorErrorStringsCount = sizeof(kPreprocessorErrorStrings) / sizeof(const char*);
+   private:
+      struct JumpScope
+      {
+         CflatSTLVector(size_t) mBreakInstructions;
+         CflatSTLVector(size_t) mContinueInstructions;
+         uint16_t mBlockDepth;
+         uint16_t mScopeDepth;
+         bool mContinueAllowed;
+      };
 
-   const char* kCompileErrorStrings[] = 
-   {
-      "unexpected symbol ('%s')",
-      "'%s' expected",
-      "undefined type ('%s')",
-      "undefined variable ('%s')",
-      "undefined function ('%s') or invalid arguments in call",
-      "variable redefinition ('%s')",
-      "uninitialized reference ('%s')",
-      "array initialization expected",
-      "no default constructor defined for the '%s' type",
-      "no copy constructor defined for the '%s' type",
-      "invalid literal ('%s')",
-      "invalid type ('%s')",
-      "invalid assignment",
-      "invalid member access operator ('%s' is a pointer)",
-      "invalid member access operator ('%s' is not a pointer)",
-      "invalid operator for the '%s' type (%s)",
-      "invalid conditional expression",
-      "invalid cast",
-      "no member named '%s'",
-      "no static member named '%s' in the '%s' type",
-      "no constructor matches the given list of arguments",
-      "no method named '%s'",
-      "no static method named '%s' in the '%s' type",
-      "'%s' must be an integer value",
-      "unknown namespace ('%s')",
-      "cannot modify constant expression"
-   };
-   const size_t kCompileErrorStringsCount = sizeof(kCompileErrorStrings) / sizeof(const char*);
+      Bytecode* mBytecode;
+      CflatSTLVector(JumpScope) mJumpScopes;
+      uint16_t mBlockDepth;
+      uint16_t mScopeDepth;
 
-   const char* kRuntimeErrorStrings[] = 
-   {
-      "null pointer access ('%s')",
-      "invalid array index (%s)",
-      "division by zero"
-   };
-   const size_t kRuntimeErrorStringsCount = sizeof(kRuntimeErrorStrings) / sizeof(const char*);
-}
+      size_t emit(InstructionType pType, Statement* pStatement = nullptr,
+         Expression* pExpression = nullptr)
+      {
+         mBytecode->mInstructions.emplace_back(pType, pStatement, pExpression);
+         return mBytecode->mInstructions.size() - 1u;
+      }
 
+      uint32_t getCurrentIndex() const
+      {
+         return (uint32_t)mBytecode->mInstructions.size();
+      }
 
-//
-//  Memory
-//
-using namespace Cflat;
+      void beginJumpScope(bool pContinueAllowed)
+      {
+         mJumpScopes.emplace_back();
+         mJumpScopes.back().mBlockDepth = mBlockDepth;
+         mJumpScopes.back().mScopeDepth = mScopeDepth;
+         mJumpScopes.back().mContinueAllowed = pContinueAllowed;
+      }
 
-void* (*Memory::malloc)(size_t pSize) = ::malloc;
-void (*Memory::free)(void* pPtr) = ::free;
+      void endJumpScope(uint32_t pBreakTarget, uint32_t pContinueTarget)
+      {
+         const JumpScope& jumpScope = mJumpScopes.back();
 
+         for(size_t i = 0u; i < jumpScope.mBreakInstructions.size(); i++)
+         {
+            mBytecode->mInstructions[jumpScope.mBreakInstructions[i]].mOperand = pBreakTarget;
+         }
 
-//
-//  Identifier
-//
-Identifier::NamesRegistry* Identifier::smNames = nullptr;
+         for(size_t i = 0u; i < jumpScope.mContinueInstructions.size(); i++)
+         {
+            mBytecode->mInstructions[jumpScope.mContinueInstructions[i]].mOperand = pContinueTarget;
+         }
 
-Identifier::Identifier()
-   : mName(getNamesRegistry()->mMemory)
-   , mNameLength(0u)
-   , mHash(0u)
-{
-}
+         mJumpScopes.pop_back();
+      }
 
-Identifier::Identifier(const char* pName)
-{
-   mHash = pName[0] != '\0' ? hash(pName) : 0u;
-   mName = getNamesRegistry()->registerString(mHash, pName);
-   mNameLength = (uint32_t)strlen(mName);
-}
+      void emitLeave(Statement* pStatement, bool pContinue)
+      {
+         int jumpScopeIndex = (int)mJumpScopes.size() - 1;
 
-Identifier::NamesRegistry* Identifier::getNamesRegistry()
-{
-   if(!smNames)
-   {
-      smNames = (NamesRegistry*)CflatMalloc(sizeof(NamesRegistry));
-      CflatInvokeCtor(NamesRegistry, smNames);
-   }
+         while(pContinue && !mJumpScopes[jumpScopeIndex].mContinueAllowed)
+         {
+            jumpScopeIndex--;
+         }
 
-   return smNames;
-}
+         JumpScope& jumpScope = mJumpScopes[jumpScopeIndex];
 
-void Identifier::releaseNamesRegistry()
-{
-   if(smNames)
-   {
-      CflatInvokeDtor(NamesRegistry, smNames);
-      CflatFree(smNames);
-      smNames = nullptr;
-   }
-}
+         const size_t instructionIndex = emit(InstructionType::Leave, pStatement);
+         mBytecode->mInstructions[instructionIndex].mBlockDepth = jumpScope.mBlockDepth;
+         mBytecode->mInstructions[instructionIndex].mScopeDepth = jumpScope.mScopeDepth;
 
-const char* Identifier::findFirstSeparator() const
-{
-   if(mNameLength > 0u)
-   {
-      for(uint32_t i = 1u; i < (mNameLength - 1u); i++)
-      {
-         if(mName[i] == ':' && mName[i + 1u] == ':')
+         if(pContinue)
          {
-            return (mName + i);
+            jumpScope.mContinueInstructions.push_back(instructionIndex);
+         }
+         else
+         {
+            jumpScope.mBreakInstructions.push_back(instructionIndex);
          }
       }
-   }
 
-   return nullptr;
-}
-const char* Identifier::findLastSeparator() const
-{
-   if(mNameLength > 0u)
-   {
-      for(uint32_t i = (mNameLength - 1u); i > 1u; i--)
+      void compileStatement(Statement* pStatement)
       {
-         if(mName[i] == ':' && mName[i - 1u] == ':')
+         switch(pStatement->getType())
          {
-            return (mName + i - 1);
-         }
-      }
-   }
+         case StatementType::Expression:
+            {
+               StatementExpression* statement = static_cast<StatementExpression*>(pStatement);
+               emit(InstructionType::Expression, statement, statement->mExpression);
+            }
+            break;
+         case StatementType::Block:
+            {
+               StatementBlock* statement = static_cast<StatementBlock*>(pStatement);
 
-   return nullptr;
-}
+               const size_t beginIndex = emit(InstructionType::BlockBegin, statement);
+               mBytecode->mInstructions[beginIndex].mAlterScope = statement->mAlterScope;
 
-bool Identifier::operator==(const Identifier& pOther) const
-{
-   return mHash == pOther.mHash;
-}
-bool Identifier::operator!=(const Identifier& pOther) const
-{
-   return mHash != pOther.mHash;
-}
+               mBlockDepth++;
 
+               if(statement->mAlterScope)
+               {
+                  mScopeDepth++;
+               }
 
-//
-//  Type
-//
-Type::~Type()
-{
-}
+               for(size_t i = 0u; i < statement->mStatements.size(); i++)
+               {
+                  compileStatement(statement->mStatements[i]);
+               }
 
-Type::Type(Namespace* pNamespace, const Identifier& pIdentifier)
-   : mNamespace(pNamespace)
-   , mParent(nullptr)
-   , mIdentifier(pIdentifier)
-   , mSize(0u)
-{
-}
+               if(statement->mAlterScope)
+               {
+                  mScopeDepth--;
+               }
 
-Hash Type::getHash() const
-{
-   return mIdentifier.mHash;
-}
+               mBlockDepth--;
 
-bool Type::isDecimal() const
-{
-   return mCategory == TypeCategory::BuiltIn &&
-      (strncmp(mIdentifier.mName, "float", 5u) == 0 ||
-         strcmp(mIdentifier.mName, "double") == 0);
-}
+               const size_t endIndex = emit(InstructionType::BlockEnd);
+               mBytecode->mInstructions[endIndex].mAlterScope = statement->mAlterScope;
+            }
+            break;
+         case StatementType::If:
+            {
+               StatementIf* statement = static_cast<StatementIf*>(pStatement);
 
-bool Type::isInteger() const
-{
-   return (mCategory == TypeCategory::BuiltIn && !isDecimal()) || mCategory == TypeCategory::Enum;
-}
+               const size_t conditionIndex =
+                  emit(InstructionType::JumpIfFalse, statement, statement->mCondition);
+               compileStatement(statement->mIfStatement);
 
-bool Type::compatibleWith(const Type& pOther) const
-{
-   return this == &pOther || (isInteger() && pOther.isInteger());
-}
+               if(statement->mElseStatement)
+               {
+                  const size_t jumpToEndIndex = emit(InstructionType::Jump);
+                  mBytecode->mInstructions[conditionIndex].mOperand = getCurrentIndex();
+                  compileStatement(statement->mElseStatement);
+                  mBytecode->mInstructions[jumpToEndIndex].mOperand = getCurrentIndex();
+               }
+               else
+               {
+                  mBytecode->mInstructions[conditionIndex].mOperand = getCurrentIndex();
+               }
+            }
+            break;
+         case StatementType::Switch:
+            {
+               StatementSwitch* statement = static_cast<StatementSwitch*>(pStatement);
 
+               const size_t switchIndex =
+                  emit(InstructionType::Switch, statement, statement->mCondition);
 
-//
-//  TypeUsage
-//
-const CflatArgsVector(TypeUsage) TypeUsage::kEmptyList;
+               // one target per case section, plus the end of the switch
+               const size_t firstCaseTargetIndex = mBytecode->mCaseTargets.size();
+               const size_t caseSectionsCount = statement->mCaseSections.size();
+               mBytecode->mCaseTargets.resize(firstCaseTargetIndex + caseSectionsCount + 1u);
+               mBytecode->mInstructions[switchIndex].mOperand = (uint32_t)firstCaseTargetIndex;
 
-TypeUsage::TypeUsage()
-   : mType(nullptr)
-   , mArraySize(1u)
-   , mPointerLevel(0u)
-   , mFlags(0u)
-{
-}
+               beginJumpScope(false);
 
-size_t TypeUsage::getSize() const
-{
-   if(mPointerLevel > 0u)
-   {
-      return sizeof(void*);
-   }
+               for(size_t i = 0u; i < caseSectionsCount; i++)
+               {
+                  const StatementSwitch::CaseSection& caseSection = statement->mCaseSections[i];
+                  mBytecode->mCaseTargets[firstCaseTargetIndex + i] = getCurrentIndex();
 
-   return mType ? mType->mSize * mArraySize : 0u;
-}
+                  for(size_t j = 0u; j < caseSection.mStatements.size(); j++)
+                  {
+                     compileStatement(caseSection.mStatements[j]);
+                  }
+               }
 
-bool TypeUsage::isPointer() const
-{
-   return mPointerLevel > 0u;
-}
+               const uint32_t endIndex = getCurrentIndex();
+               mBytecode->mCaseTargets[firstCaseTargetIndex + caseSectionsCount] = endIndex;
 
-bool TypeUsage::isConst() const
-{
-   return CflatHasFlag(mFlags, TypeUsageFlags::Const);
-}
+               endJumpScope(endIndex, 0u);
+            }
+            break;
+         case StatementType::While:
+            {
+               StatementWhile* statement = static_cast<StatementWhile*>(pStatement);
 
-bool TypeUsage::isReference() const
-{
-   return CflatHasFlag(mFlags, TypeUsageFlags::Reference);
-}
+               const size_t conditionIndex =
+                  emit(InstructionType::JumpIfFalse, statement, statement->mCondition);
 
-bool TypeUsage::isArray() const
-{
-   return CflatHasFlag(mFlags, TypeUsageFlags::Array);
-}
+               beginJumpScope(true);
 
-bool TypeUsage::compatibleWith(const TypeUsage& pOther) const
-{
-   return
-      mType->compatibleWith(*pOther.mType) &&
-      mArraySize == pOther.mArraySize &&
-      mPointerLevel == pOther.mPointerLevel;
-}
+               const uint32_t loopIndex = getCurrentIndex();
+               compileStatement(statement->mLoopStatement);
 
-bool TypeUsage::operator==(const TypeUsage& pOther) const
-{
-   return
-      mType == pOther.mType &&
-      mArraySize == pOther.mArraySize &&
-      mPointerLevel == pOther.mPointerLevel &&
-      isReference() == pOther.isReference();
-}
-bool TypeUsage::operator!=(const TypeUsage& pOther) const
-{
-   return !operator==(pOther);
-}
+               const uint32_t continueIndex = getCurrentIndex();
+               const size_t loopConditionIndex =
+                  emit(InstructionType::JumpIfTrue, nullptr, statement->mCondition);
+               mBytecode->mInstructions[loopConditionIndex].mOperand = loopIndex;
 
+               const uint32_t endIndex = getCurrentIndex();
+               mBytecode->mInstructions[conditionIndex].mOperand = endIndex;
 
-//
-//  TypeAlias
-//
-TypeAlias::TypeAlias()
-  : mScopeLevel(0u)
-{
-}
+               endJumpScope(endIndex, continueIndex);
+            }
+            break;
+         case StatementType::DoWhile:
+            {
+               StatementDoWhile* statement = static_cast<StatementDoWhile*>(pStatement);
 
-TypeAlias::TypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
-  : mIdentifier(pIdentifier)
-  , mTypeUsage(pTypeUsage)
-  , mScopeLevel(0u)
-{
-}
+               beginJumpScope(true);
 
+               const uint32_t loopIndex = getCurrentIndex();
+               compileStatement(statement->mLoopStatement);
 
-//
-//  Member
-//
-Member::Member(const Identifier& pIdentifier)
-   : mIdentifier(pIdentifier)
-   , mOffset(0u)
-{
-}
+               const uint32_t continueIndex = getCurrentIndex();
+               const size_t loopConditionIndex =
+                  emit(InstructionType::JumpIfTrue, nullptr, statement->mCondition);
+               mBytecode->mInstructions[loopConditionIndex].mOperand = loopIndex;
 
+               endJumpScope(getCurrentIndex(), continueIndex);
+            }
+            break;
+         case StatementType::For:
+            {
+               StatementFor* statement = static_cast<StatementFor*>(pStatement);
 
-//
-//  Value
-//
-const CflatArgsVector(Value) Value::kEmptyList;
+               emit(InstructionType::ScopeBegin, statement);
+               mScopeDepth++;
 
-Value::Value()
-   : mValueBufferType(ValueBufferType::Uninitialized)
-   , mValueInitializationHint(ValueInitializationHint::None)
-   , mValueBuffer(nullptr)
-   , mStack(nullptr)
-{
-}
+               if(statement->mInitialization)
+               {
+                  compileStatement(statement->mInitialization);
+               }
 
-Value::Value(const Value& pOther)
-   : mValueBufferType(ValueBufferType::Uninitialized)
-   , mValueInitializationHint(ValueInitializationHint::None)
-   , mValueBuffer(nullptr)
-   , mStack(nullptr)
-{
-   *this = pOther;
-}
+               size_t conditionIndex = 0u;
 
-Value::~Value()
-{
-   if(mValueBufferType == ValueBufferType::Stack)
-   {
-      CflatAssert(mStack);
-      mStack->pop(mTypeUsage.getSize());
-      CflatAssert(mStack->mPointer == mValueBuffer);
-   }
-   else if(mValueBufferType == ValueBufferType::Heap)
-   {
-      CflatAssert(mValueBuffer);
-      CflatFree(mValueBuffer);
-   }
-}
+               if(statement->mCondition)
+               {
+                  conditionIndex = emit(InstructionType::JumpIfFalse, nullptr, statement->mCondition);
+               }
 
-void Value::reset()
-{
-   CflatInvokeDtor(Value, this);
-   CflatInvokeCtor(Value, this);
-}
+               beginJumpScope(true);
 
-void Value::initOnStack(const TypeUsage& pTypeUsage, EnvironmentStack* pStack)
-{
-   CflatAssert(mValueBufferType == ValueBufferType::Uninitialized);
-   CflatAssert(pStack);
+               const uint32_t loopIndex = getCurrentIndex();
+               compileStatement(statement->mLoopStatement);
 
-   mTypeUsage = pTypeUsage;
-   mValueBufferType = ValueBufferType::Stack;
-   mValueBuffer = (char*)pStack->push(pTypeUsage.getSize());
-   mStack = pStack;
-}
+               const uint32_t continueIndex = getCurrentIndex();
 
-void Value::initOnHeap(const TypeUsage& pTypeUsage)
-{
-   CflatAssert(mValueBufferType != ValueBufferType::Stack);
+               if(statement->mIncrement)
+               {
+                  emit(InstructionType::Expression, nullptr, statement->mIncrement);
+               }
 
-   const bool allocationRequired =
-      mValueBufferType == ValueBufferType::Uninitialized ||
-      mTypeUsage.getSize() != pTypeUsage.getSize();
+               const size_t loopConditionIndex = statement->mCondition
+                  ? emit(InstructionType::JumpIfTrue, nullptr, statement->mCondition)
+                  : emit(InstructionType::Jump);
+               mBytecode->mInstructions[loopConditionIndex].mOperand = loopIndex;
 
-   if(allocationRequired && mValueBuffer)
-   {
-      CflatFree(mValueBuffer);
-      mValueBuffer = nullptr;
-   }
+               const uint32_t endIndex = getCurrentIndex();
 
-   mTypeUsage = pTypeUsage;
-   mValueBufferType = ValueBufferType::Heap;
+               if(statement->mCondition)
+               {
+                  mBytecode->mInstructions[conditionIndex].mOperand = endIndex;
+               }
 
-   if(allocationRequired)
-   {
-      mValueBuffer = (char*)CflatMalloc(pTypeUsage.getSize());
-   }
-}
+               endJumpScope(endIndex, continueIndex);
 
-void Value::initExternal(const TypeUsage& pTypeUsage)
-{
-   CflatAssert(mValueBufferType == ValueBufferType::Uninitialized);
-   mTypeUsage = pTypeUsage;
-   mValueBufferType = ValueBufferType::External;
-}
+               mScopeDepth--;
+               emit(InstructionType::ScopeEnd);
+            }
+            break;
+         case StatementType::Break:
+            {
+               emitLeave(pStatement, false);
+            }
+            break;
+         case StatementType::Continue:
+            {
+               emitLeave(pStatement, true);
+            }
+            break;
+         default:
+            {
+               emit(InstructionType::Statement, pStatement);
+            }
+            break;
+         }
+      }
 
-void Value::set(const void* pDataSource)
-{
-   CflatAssert(mValueBufferType != ValueBufferType::Uninitialized);
-   CflatAssert(pDataSource);
+   public:
+      BytecodeCompiler(Bytecode* pBytecode)
+         : mBytecode(pBytecode)
+         , mBlockDepth(0u)
+         , mScopeDepth(0u)
+      {
+      }
 
-   if(mValueBufferType == ValueBufferType::External)
+      void compile(StatementBlock* pBody)
+      {
+         // jumps with no enclosing loop leave the function, as they do when walking the tree
+         beginJumpScope(true);
+         compileStatement(pBody);
+         endJumpScope(getCurrentIndex(), getCurrentIndex());
+      }
+   };
+
+
+   //
+   //  Operators
+   //
+   const char* kOperatorTypeStrings[] =
    {
-      mValueBuffer = (char*)pDataSource;
-   }
-   else
+      "",
+      "+", "-", "*", "/", "%", "&", "|", "^", "<<", ">>",
+      "==", "!=", "<", ">", "<=", ">=", "&&", "||",
+      "!", "~", "-", "++", "--", "*",
+      "=", "+=", "-=", "*=", "/=", "&=", "|="
+   };
+   const size_t kOperatorTypeStringsCount = sizeof(kOperatorTypeStrings) / sizeof(const char*);
+
+   OperatorType getOperatorType(const char* pOperator, bool pUnary)
    {
-      memcpy(mValueBuffer, pDataSource, mTypeUsage.getSize());
+      if(pUnary)
+      {
+         if(strcmp(pOperator, "-") == 0)
+         {
+            return OperatorType::Negate;
+         }
+         else if(strcmp(pOperator, "*") == 0)
+         {
+            return OperatorType::Dereference;
+         }
+      }
+
+      for(size_t i = 1u; i < kOperatorTypeStringsCount; i++)
+      {
+         if(strcmp(pOperator, kOperatorTypeStrings[i]) == 0)
+         {
+            return (OperatorType)i;
+         }
+      }
+
+      return OperatorType::None;
    }
-}
 
-void Value::assign(const void* pDataSource)
-{
-   CflatAssert(mValueBufferType != ValueBufferType::Uninitialized);
-   CflatAssert(pDataSource);
+   const char* getOperatorString(OperatorType pOperator)
+   {
+      return kOperatorTypeStrings[(size_t)pOperator];
+   }
 
-   memcpy(mValueBuffer, pDataSource, mTypeUsage.getSize());
-}
+   bool isLogicalOperator(OperatorType pOperator)
+   {
+      return pOperator >= OperatorType::Equal && pOperator <= OperatorType::LogicalOr;
+   }
 
-Value& Value::operator=(const Value& pOther)
-{
-   if(pOther.mValueBufferType == ValueBufferType::Uninitialized)
+   OperatorType getCompoundAssignmentOperator(OperatorType pAssignmentOperator)
    {
-      reset();
+      switch(pAssignmentOperator)
+      {
+      case OperatorType::AddAssign:
+         return OperatorType::Add;
+      case OperatorType::SubtractAssign:
+         return OperatorType::Subtract;
+      case OperatorType::MultiplyAssign:
+         return OperatorType::Multiply;
+      case OperatorType::DivideAssign:
+         return OperatorType::Divide;
+      case OperatorType::BitwiseAndAssign:
+         return OperatorType::BitwiseAnd;
+      case OperatorType::BitwiseOrAssign:
+         return OperatorType::BitwiseOr;
+      default:
+         return OperatorType::None;
+      }
    }
-   else
+
+
+   //
+   //  Operation kernels
+   //
+   //  They read and write the operands with their actual types, and return false for anything
+   //  they do not handle (including divisions by zero), so the caller falls back to the generic
+   //  implementation, which produces the same results and reports the errors
+   //
+   inline bool isValidDivisor(int64_t pDivisor)
    {
-      switch(mValueBufferType)
+      return pDivisor != 0;
+   }
+   inline bool isValidDivisor(double pDivisor)
+   {
+      return fabs(pDivisor) > 0.000000001;
+   }
+
+   inline bool applyIntegerOperation(OperatorType pOperator, int64_t pLeft, int64_t pRight,
+      int64_t* pOutResult)
+   {
+      switch(pOperator)
       {
-      case ValueBufferType::Uninitialized:
-      case ValueBufferType::External:
-         mTypeUsage = pOther.mTypeUsage;
-         mValueBufferType = ValueBufferType::External;
-         mValueBuffer = pOther.mValueBuffer;
+      case OperatorType::Modulo:
+         if(pRight == 0)
+            return false;
+         *pOutResult = pLeft % pRight;
+         return true;
+      case OperatorType::BitwiseAnd:
+         *pOutResult = pLeft & pRight;
+         return true;
+      case OperatorType::BitwiseOr:
+         *pOutResult = pLeft | pRight;
+         return true;
+      case OperatorType::BitwiseXor:
+         *pOutResult = pLeft ^ pRight;
+         return true;
+      case OperatorType::ShiftLeft:
+         *pOutResult = pLeft << pRight;
+         return true;
+      case OperatorType::ShiftRight:
+         *pOutResult = pLeft >> pRight;
+         return true;
+      default:
+         return false;
+      }
+   }
+   inline bool applyIntegerOperation(OperatorType, double, double, double*)
+   {
+      return false;
+   }
+
+   template<typename T>
+   bool applyComparisonKernel(OperatorType pOperator, T pLeft, T pRight, Value* pOutValue)
+   {
+      bool result = false;
+
+      switch(pOperator)
+      {
+      case OperatorType::Equal:
+         result = pLeft == pRight;
          break;
-      case ValueBufferType::Stack:
-         CflatAssert(mTypeUsage.compatibleWith(pOther.mTypeUsage));
-         memcpy(mValueBuffer, pOther.mValueBuffer, mTypeUsage.getSize());
+      case OperatorType::NotEqual:
+         result = pLeft != pRight;
          break;
-      case ValueBufferType::Heap:
-         initOnHeap(pOther.mTypeUsage);
-         memcpy(mValueBuffer, pOther.mValueBuffer, mTypeUsage.getSize());
+      case OperatorType::Less:
+         result = pLeft < pRight;
+         break;
+      case OperatorType::Greater:
+         result = pLeft > pRight;
          break;
+      case OperatorType::LessOrEqual:
+         result = pLeft <= pRight;
+         break;
+      case OperatorType::GreaterOrEqual:
+         result = pLeft >= pRight;
+         break;
+      default:
+         return false;
       }
+
+      if(pOutValue->mTypeUsage.getSize() != sizeof(bool))
+         return false;
+
+      pOutValue->assign(&result);
+      return true;
    }
 
-   return *this;
-}
+   // T: storage type of the operands, TWide: type the generic implementation computes in
+   template<typename T, typename TWide>
+   bool applyArithmeticKernel(OperatorType pOperator, const Value& pLeft, const Value& pRight,
+      Value* pOutValue)
+   {
+      const TWide left = (TWide)*reinterpret_cast<const T*>(pLeft.mValueBuffer);
+      const TWide right = (TWide)*reinterpret_cast<const T*>(pRight.mValueBuffer);
 
+      if(pOperator >= OperatorType::Equal && pOperator <= OperatorType::GreaterOrEqual)
+      {
+         return applyComparisonKernel<TWide>(pOperator, left, right, pOutValue);
+      }
 
-//
-//  UsingDirective
-//
-UsingDirective::UsingDirective(Namespace* pNamespace)
-   : mNamespace(pNamespace)
-   , mBlockLevel(0u)
-{
+      if(pOutValue->mTypeUsage.mType != pLeft.mTypeUsage.mType || pOutValue->mTypeUsage.isPointer())
+         return false;
+
+      TWide result = (TWide)0;
+
+      switch(pOperator)
+      {
+      case OperatorType::Add:
+         result = left + right;
+         break;
+      case OperatorType::Subtract:
+         result = left - right;
+         break;
+      case OperatorType::Multiply:
+         result = left * right;
+         break;
+      case OperatorType::Divide:
+         if(!isValidDivisor(right))
+            return false;
+         result = left / right;
+         break;
+      default:
+         if(!applyIntegerOperation(pOperator, left, right, &result))
+            return false;
+         break;
+      }
+
+      const T value = (T)result;
+      pOutValue->assign(&value);
+      return true;
+   }
+
+   bool applyOperationKernel(OperationKernel pKernel, OperatorType pOperator,
+      const Value& pLeft, const Value& pRight, Value* pOutValue)
+   {
+      switch(pKernel)
+      {
+      case OperationKernel::Int32:
+         return applyArithmeticKernel<int32_t, int64_t>(pOperator, pLeft, pRight, pOutValue);
+      case OperationKernel::Int64:
+         return applyArithmeticKernel<int64_t, int64_t>(pOperator, pLeft, pRight, pOutValue);
+      case OperationKernel::Float:
+         return applyArithmeticKernel<float, double>(pOperator, pLeft, pRight, pOutValue);
+      case OperationKernel::Double:
+         return applyArithmeticKernel<double, double>(pOperator, pLeft, pRight, pOutValue);
+      case OperationKernel::Pointer:
+         return applyComparisonKernel<uintptr_t>(pOperator,
+            (uintptr_t)CflatValueAs(&pLeft, void*), (uintptr_t)CflatValueAs(&pRight, void*), pOutValue);
+      default:
+         return false;
+      }
+   }
+
+
+   //
+   //  Precompiled data
+   //
+   //  Header, followed by the tokens, the code of the tokens (one per line, null-terminated) and
+   //  the null-terminated definitions and bodies of the macros defined by the program
+   //
+   static const uint32_t kPrecompiledDataMagic = 0x43504643u; // 'CFPC'
+   static const uint32_t kPrecompiledDataVersion = 2u;
+
+   struct PrecompiledDataHeader
+   {
+      uint32_t mMagic;
+      uint32_t mVersion;
+      Hash mCodeHash;
+      Hash mMacrosHash;
+      uint32_t mTokensCount;
+      uint32_t mTokensCodeLength;
+      uint32_t mMacroDefinitionsCount;
+   };
+
+   struct PrecompiledToken
+   {
+      uint32_t mOffset;
+      uint32_t mLength;
+      uint16_t mLine;
+      uint8_t mType;
+      uint8_t mPadding;
+   };
+
+   bool readPrecompiledDataHeader(const void* pData, size_t pDataSize,
+      PrecompiledDataHeader* pOutHeader)
+   {
+      if(!pData || pDataSize < sizeof(PrecompiledDataHeader))
+      {
+         return false;
+      }
+
+      memcpy(pOutHeader, pData, sizeof(PrecompiledDataHeader));
+
+      if(pOutHeader->mMagic != kPrecompiledDataMagic ||
+         pOutHeader->mVersion != kPrecompiledDataVersion)
+      {
+         return false;
+      }
+
+      const size_t minimumDataSize = sizeof(PrecompiledDataHeader) +
+         (size_t)pOutHeader->mTokensCount * sizeof(PrecompiledToken) +
+         (size_t)pOutHeader->mTokensCodeLength;
+
+      return pDataSize >= minimumDataSize;
+   }
+
+
+   //
+   //  Error messages
+   //
+   const char* kPreprocessorErrorStrings[] = 
+   {
+      "invalid preprocessor directive",
+      "invalid number of arguments for the '%s' macro"
+   };
+   const size_t kPreprocessorErrorStringsCount = sizeof(kPreprocessorErrorStrings) / sizeof(const char*);
+
+   const char* kCompileErrorStrings[] = 
+   {
+      "unexpected symbol ('%s')",
+      "'%s' expected",
+      "undefined type ('%s')",
+      "undefined variable ('%s')",
+      "undefined function ('%s') or invalid arguments in call",
+      "variable redefinition ('%s')",
+      "uninitialized reference ('%s')",
+      "array initialization expected",
+      "no default constructor defined for the '%s' type",
+      "no copy constructor defined for the '%s' type",
+      "invalid literal ('%s')",
+      "invalid type ('%s')",
+      "invalid assignment",
+      "invalid member access operator ('%s' is a pointer)",
+      "invalid member access operator ('%s' is not a pointer)",
+      "invalid operator for the '%s' type (%s)",
+      "invalid conditional expression",
+      "invalid cast",
+      "no member named '%s'",
+      "no static member named '%s' in the '%s' type",
+      "no constructor matches the given list of arguments",
+      "no method named '%s'",
+      "no static method named '%s' in the '%s' type",
+      "'%s' must be an integer value",
+      "unknown namespace ('%s')",
+      "cannot modify constant expression"
+   };
+   const size_t kCompileErrorStringsCount = sizeof(kCompileErrorStrings) / sizeof(const char*);
+
+   const char* kRuntimeErrorStrings[] = 
+   {
+      "null pointer access ('%s')",
+      "invalid array index (%s)",
+      "division by zero",
+      "stack overflow"
+   };
+   const size_t kRuntimeErrorStringsCount = sizeof(kRuntimeErrorStrings) / sizeof(const char*);
 }
 
 
 //
-//  Function
+//  Memory
 //
-Function::Function(const Identifier& pIdentifier)
-   : mNamespace(nullptr)
-   , mIdentifier(pIdentifier)
-   , mProgram(nullptr)
-   , mLine(0u)
-   , execute(nullptr)
+using namespace Cflat;
+
+void* (*Memory::malloc)(size_t pSize) = ::malloc;
+void (*Memory::free)(void* pPtr) = ::free;
+
+namespace Cflat
 {
+   // placed right before the memory of each allocation
+   struct AllocationHeader
+   {
+      Allocator* mAllocator;
+      uint64_t mSize : 56;
+      uint64_t mCategory : 8;
+   };
+
+   static_assert(sizeof(AllocationHeader) == 16u, "Unexpected size of the allocation header");
+
+   static thread_local Allocator* gBoundAllocator = nullptr;
 }
 
-Function::~Function()
+void* Memory::allocate(size_t pSize, Category pCategory)
 {
-   execute = nullptr;
-}
+   // identifiers outlive the environments, so their names cannot come from any of them
+   Allocator* allocator = gBoundAllocator && pCategory != Category::Identifiers
+      ? gBoundAllocator
+      : getDefaultAllocator();
 
+   AllocationHeader* header =
+      (AllocationHeader*)allocator->allocate(sizeof(AllocationHeader) + pSize, pCategory);
+   CflatAssert(header);
 
-//
-//  Method
-//
-Method::Method(const Identifier& pIdentifier)
-   : mIdentifier(pIdentifier)
-   , execute(nullptr)
-{
+   header->mAllocator = allocator;
+   header->mSize = pSize;
+   header->mCategory = (uint64_t)pCategory;
+
+   const size_t categoryIndex = (size_t)pCategory;
+   allocator->mBytes[categoryIndex].fetch_add(pSize, std::memory_order_relaxed);
+   allocator->mAllocationsCount[categoryIndex].fetch_add(1u, std::memory_order_relaxed);
+   allocator->mTotalAllocationsCount[categoryIndex].fetch_add(1u, std::memory_order_relaxed);
+
+   return header + 1;
 }
 
-Method::~Method()
+void Memory::deallocate(void* pPtr)
 {
-   execute = nullptr;
-}
+   if(!pPtr)
+   {
+      return;
+   }
 
+   AllocationHeader* header = (AllocationHeader*)pPtr - 1;
+   Allocator* allocator = header->mAllocator;
+   const size_t size = (size_t)header->mSize;
+   const Category category = (Category)header->mCategory;
 
-//
-//  Instance
-//
-Instance::Instance()
-   : mScopeLevel(0u)
+   const size_t categoryIndex = (size_t)category;
+   allocator->mBytes[categoryIndex].fetch_sub(size, std::memory_order_relaxed);
+   allocator->mAllocationsCount[categoryIndex].fetch_sub(1u, std::memory_order_relaxed);
+
+   allocator->deallocate(header, sizeof(AllocationHeader) + size, category);
+}
+
+Allocator* Memory::getDefaultAllocator()
 {
+   // never destroyed, so memory can still be released while destroying static objects
+   alignas(DefaultAllocator) static char defaultAllocatorMemory[sizeof(DefaultAllocator)];
+   static DefaultAllocator* defaultAllocator =
+      CflatInvokeCtor(DefaultAllocator, defaultAllocatorMemory)();
+
+   return defaultAllocator;
 }
 
-Instance::Instance(const TypeUsage& pTypeUsage, const Identifier& pIdentifier)
-   : mTypeUsage(pTypeUsage)
-   , mIdentifier(pIdentifier)
-   , mScopeLevel(0u)
+Allocator* Memory::bindAllocator(Allocator* pAllocator)
 {
+   Allocator* previousAllocator = gBoundAllocator;
+   gBoundAllocator = pAllocator;
+
+   return previousAllocator;
 }
 
 
 //
-//  TypesHolder
+//  Allocator
 //
-TypesHolder::~TypesHolder()
+Allocator::Allocator()
 {
-   for(TypesRegistry::iterator it = mTypes.begin(); it != mTypes.end(); it++)
+   for(size_t i = 0u; i < (size_t)Memory::Category::Count; i++)
    {
-      Type* type = it->second;
-      CflatInvokeDtor(Type, type);
-      CflatFree(type);
+      mBytes[i].store(0u, std::memory_order_relaxed);
+      mAllocationsCount[i].store(0u, std::memory_order_relaxed);
+      mTotalAllocationsCount[i].store(0u, std::memory_order_relaxed);
    }
 }
 
-Type* TypesHolder::getType(const Identifier& pIdentifier)
+Allocator::Stats Allocator::getStats(Memory::Category pCategory) const
 {
-   TypesRegistry::const_iterator it = mTypes.find(pIdentifier.mHash);
-   return it != mTypes.end() ? it->second : nullptr;
+   const size_t categoryIndex = (size_t)pCategory;
+
+   Stats stats;
+   stats.mBytes = mBytes[categoryIndex].load(std::memory_order_relaxed);
+   stats.mAllocationsCount = mAllocationsCount[categoryIndex].load(std::memory_order_relaxed);
+   stats.mTotalAllocationsCount = mTotalAllocationsCount[categoryIndex].load(std::memory_order_relaxed);
+
+   return stats;
 }
 
-Type* TypesHolder::getType(const Identifier& pIdentifier, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+Allocator::Stats Allocator::getStats() const
 {
-   Hash hash = pIdentifier.mHash;
+   Stats stats = {};
 
-   for(size_t i = 0u; i < pTemplateTypes.size(); i++)
+   for(size_t i = 0u; i < (size_t)Memory::Category::Count; i++)
    {
-      hash += pTemplateTypes[i].mType->getHash();
-      hash += (Hash)pTemplateTypes[i].mPointerLevel;
+      const Stats categoryStats = getStats((Memory::Category)i);
+      stats.mBytes += categoryStats.mBytes;
+      stats.mAllocationsCount += categoryStats.mAllocationsCount;
+      stats.mTotalAllocationsCount += categoryStats.mTotalAllocationsCount;
    }
 
-   TypesRegistry::const_iterator it = mTypes.find(hash);
-   return it != mTypes.end() ? it->second : nullptr;
+   return stats;
 }
 
-void TypesHolder::registerTypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
+
+//
+//  DefaultAllocator
+//
+void* DefaultAllocator::allocate(size_t pSize, Memory::Category)
 {
-   TypeAlias typeAlias(pIdentifier, pTypeUsage);
-   mTypeAliases[pIdentifier.mHash] = typeAlias;
+   return CflatMalloc(pSize);
 }
 
-const TypeAlias* TypesHolder::getTypeAlias(const Identifier& pIdentifier)
+void DefaultAllocator::deallocate(void* pPtr, size_t, Memory::Category)
 {
-   TypeAliasesRegistry::const_iterator it = mTypeAliases.find(pIdentifier.mHash);
-   return it != mTypeAliases.end() ? &it->second : nullptr;
+   CflatFree(pPtr);
 }
 
 
 //
-//  FunctionsHolder
+//  Memory::StringsPool
 //
-FunctionsHolder::~FunctionsHolder()
+Memory::StringsPool::StringsPool()
+   : mChunk(nullptr)
+   , mChunkUsedSize(0u)
 {
-   for(FunctionsRegistry::iterator it = mFunctions.begin(); it != mFunctions.end(); it++)
-   {
-      CflatSTLVector(Function*)& functions = it->second;
-
-      for(size_t i = 0u; i < functions.size(); i++)
-      {
-         Function* function = functions[i];
-         CflatInvokeDtor(Function, function);
-         CflatFree(function);
-      }
-   }
+   memset(&mStats, 0, sizeof(Stats));
 }
 
-Function* FunctionsHolder::getFunction(const Identifier& pIdentifier)
+Memory::StringsPool::~StringsPool()
 {
-   FunctionsRegistry::iterator it = mFunctions.find(pIdentifier.mHash);
-   return it != mFunctions.end() ? it->second.at(0) : nullptr;
+   while(mChunk)
+   {
+      Chunk* previousChunk = mChunk->mPrevious;
+      CflatDeallocate(mChunk);
+      mChunk = previousChunk;
+   }
 }
 
-Function* FunctionsHolder::getFunction(const Identifier& pIdentifier,
-   const CflatArgsVector(TypeUsage)& pParameterTypes, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+const char* Memory::StringsPool::registerString(Hash pHash, const char* pString)
 {
-   Function* function = nullptr;
-   CflatSTLVector(Function*)* functions = getFunctions(pIdentifier);
+   Registry::const_iterator it = mRegistry.find(pHash);
 
-   if(functions)
+   if(it != mRegistry.end())
    {
-      // first pass: look for a perfect argument match
-      for(size_t i = 0u; i < functions->size(); i++)
-      {
-         Function* functionOverload = functions->at(i);
+      it->second->mReferencesCount++;
+      return it->second->getString();
+   }
 
-         if(functionOverload->mParameters.size() == pParameterTypes.size() &&
-            functionOverload->mTemplateTypes == pTemplateTypes)
-         {
-            bool parametersMatch = true;
+   // the blocks are kept aligned, so the released ones can hold the link to the next one
+   const size_t alignment = 16u;
+   const size_t stringLength = strlen(pString);
+   const size_t size = (sizeof(Entry) + stringLength + alignment) & ~(alignment - 1u);
 
-            for(size_t j = 0u; j < pParameterTypes.size(); j++)
-            {
-               const TypeHelper::Compatibility compatibility =
-                  TypeHelper::getCompatibility(functionOverload->mParameters[j], pParameterTypes[j]);
+   Entry* entry = allocateEntry(size);
+   entry->mHash = pHash;
+   entry->mReferencesCount = 1u;
 
-               if(compatibility != TypeHelper::Compatibility::PerfectMatch)
-               {
-                  parametersMatch = false;
-                  break;
-               }
-            }
+   char* string = entry->getString();
+   memcpy(string, pString, stringLength);
+   string[stringLength] = '\0';
 
-            if(parametersMatch)
-            {
-               function = functionOverload;
-               break;
-            }
-         }
-      }
+   mRegistry[pHash] = entry;
 
-      // second pass: look for a compatible argument match
-      if(!function)
-      {
-         for(size_t i = 0u; i < functions->size(); i++)
-         {
-            Function* functionOverload = functions->at(i);
+   mStats.mStringsCount++;
+   mStats.mUsedSize += entry->mSize;
 
-            if(functionOverload->mParameters.size() == pParameterTypes.size() &&
-               functionOverload->mTemplateTypes == pTemplateTypes)
-            {
-               bool parametersMatch = true;
+   if(mStats.mUsedSize > mStats.mPeakUsedSize)
+   {
+      mStats.mPeakUsedSize = mStats.mUsedSize;
+   }
 
-               for(size_t j = 0u; j < pParameterTypes.size(); j++)
-               {
-                  const TypeHelper::Compatibility compatibility =
-                     TypeHelper::getCompatibility(functionOverload->mParameters[j], pParameterTypes[j]);
+   return string;
+}
 
-                  if(compatibility == TypeHelper::Compatibility::Incompatible)
-                  {
-                     parametersMatch = false;
-                     break;
-                  }
-               }
+const char* Memory::StringsPool::retrieveString(Hash pHash)
+{
+   Registry::const_iterator it = mRegistry.find(pHash);
+   return it != mRegistry.end() ? it->second->getString() : "";
+}
 
-               if(parametersMatch)
-               {
-                  function = functionOverload;
-                  break;
-               }
-            }
-         }
-      }
+void Memory::StringsPool::releaseString(const char* pString)
+{
+   Entry* entry = reinterpret_cast<Entry*>(const_cast<char*>(pString)) - 1;
+   CflatAssert(entry->mReferencesCount > 0u);
+
+   if(--entry->mReferencesCount > 0u)
+   {
+      return;
    }
 
-   return function;
+   mRegistry.erase(entry->mHash);
+
+   mStats.mStringsCount--;
+   mStats.mUsedSize -= entry->mSize;
+   mStats.mReleasedSize += entry->mSize;
+
+   // the string is left intact, since the host might still be pointing to it
+   mReleasedEntries.push_back(entry);
 }
 
-Function* FunctionsHolder::getFunction(const Identifier& pIdentifier,
-   const CflatArgsVector(Value)& pArguments, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+void Memory::StringsPool::compact()
 {
-   CflatArgsVector(TypeUsage) typeUsages;
-
-   for(size_t i = 0u; i < pArguments.size(); i++)
+   for(size_t i = 0u; i < mReleasedEntries.size(); i++)
    {
-      typeUsages.push_back(pArguments[i].mTypeUsage);
+      Entry* entry = mReleasedEntries[i];
+      Entry*& firstFreeEntry = mFreeEntries[entry->mSize];
+      entry->getNextFreeEntry() = firstFreeEntry;
+      firstFreeEntry = entry;
    }
 
-   return getFunction(pIdentifier, typeUsages, pTemplateTypes);
+   mReleasedEntries.clear();
+   mStats.mReleasedSize = 0u;
 }
 
-CflatSTLVector(Function*)* FunctionsHolder::getFunctions(const Identifier& pIdentifier)
+const Memory::StringsPool::Stats& Memory::StringsPool::getStats() const
 {
-   FunctionsRegistry::iterator it = mFunctions.find(pIdentifier.mHash);
-   return it != mFunctions.end() ? &it->second : nullptr;
+   return mStats;
 }
 
-void FunctionsHolder::getAllFunctions(CflatSTLVector(Function*)* pOutFunctions)
+Memory::StringsPool::Entry* Memory::StringsPool::allocateEntry(size_t pSize)
 {
-   for(FunctionsRegistry::const_iterator it = mFunctions.begin(); it != mFunctions.end(); it++)
+   // the smallest released block which fits gets reused, unless it would waste most of it
+   FreeEntriesRegistry::iterator it = mFreeEntries.lower_bound(pSize);
+
+   if(it != mFreeEntries.end() && it->first < pSize * 2u)
    {
-      const CflatSTLVector(Function*)& functions = it->second;
+      Entry* entry = it->second;
+      it->second = entry->getNextFreeEntry();
 
-      for(size_t i = 0u; i < functions.size(); i++)
+      if(!it->second)
       {
-         pOutFunctions->push_back(functions[i]);
+         mFreeEntries.erase(it);
       }
-   }
-}
-
-Function* FunctionsHolder::registerFunction(const Identifier& pIdentifier)
-{
-   Function* function = (Function*)CflatMalloc(sizeof(Function));
-   CflatInvokeCtor(Function, function)(pIdentifier);
-   FunctionsRegistry::iterator it = mFunctions.find(pIdentifier.mHash);
 
-   if(it == mFunctions.end())
-   {
-      CflatSTLVector(Function*) functions;
-      functions.push_back(function);
-      mFunctions[pIdentifier.mHash] = functions;
+      return entry;
    }
-   else
+
+   if(!mChunk || (mChunkUsedSize + pSize) > mChunk->mSize)
    {
-      it->second.push_back(function);
+      const size_t chunkSize = pSize > kLiteralStringsPoolSize ? pSize : kLiteralStringsPoolSize;
+
+      Chunk* chunk = (Chunk*)CflatAllocate(sizeof(Chunk) + chunkSize, SyntaxTree);
+      chunk->mPrevious = mChunk;
+      chunk->mSize = chunkSize;
+
+      mChunk = chunk;
+      mChunkUsedSize = 0u;
+
+      mStats.mReservedSize += chunkSize;
    }
 
-   return function;
+   Entry* entry = reinterpret_cast<Entry*>(mChunk->getMemory() + mChunkUsedSize);
+   entry->mSize = pSize;
+   mChunkUsedSize += pSize;
+
+   return entry;
 }
 
 
 //
-//  InstancesHolder
+//  Memory::NamesRegistry
 //
-InstancesHolder::InstancesHolder()
+Memory::NamesRegistry::Slot::Slot()
+   : mHash(0u)
+   , mString(nullptr)
 {
 }
 
-InstancesHolder::~InstancesHolder()
+Memory::NamesRegistry::NamesRegistry()
+   : mNamesCount(0u)
+   , mChunk(nullptr)
+   , mChunkUsedSize(0u)
+   , mNamesSize(0u)
 {
-   releaseInstances(0u, true);
+   mTable.store(createTable(kIdentifierNamesTableInitialCapacity, nullptr), std::memory_order_release);
 }
 
-void InstancesHolder::setVariable(const TypeUsage& pTypeUsage, const Identifier& pIdentifier,
-   const Value& pValue)
+Memory::NamesRegistry::~NamesRegistry()
 {
-   Instance* instance = retrieveInstance(pIdentifier);
+   Table* table = mTable.load(std::memory_order_acquire);
 
-   if(!instance)
+   while(table)
    {
-      instance = registerInstance(pTypeUsage, pIdentifier);
+      Table* previousTable = table->mPrevious;
+      CflatDeallocate(table);
+      table = previousTable;
    }
 
-   instance->mValue = pValue;
-}
-
-Value* InstancesHolder::getVariable(const Identifier& pIdentifier)
-{
-   Instance* instance = retrieveInstance(pIdentifier);
-   return instance ? &instance->mValue : nullptr;
+   while(mChunk)
+   {
+      Chunk* previousChunk = mChunk->mPrevious;
+      CflatDeallocate(mChunk);
+      mChunk = previousChunk;
+   }
 }
 
-Instance* InstancesHolder::registerInstance(const TypeUsage& pTypeUsage, const Identifier& pIdentifier)
+const char* Memory::NamesRegistry::registerString(Hash pHash, const char* pString)
 {
-   mInstances.emplace_back(pTypeUsage, pIdentifier);
-   return &mInstances.back();
-}
+   if(pHash == 0u)
+   {
+      return "";
+   }
 
-Instance* InstancesHolder::retrieveInstance(const Identifier& pIdentifier)
-{
-   Instance* instance = nullptr;
+   const char* registeredString = find(mTable.load(std::memory_order_acquire), pHash);
 
-   for(int i = (int)mInstances.size() - 1; i >= 0; i--)
+   if(registeredString)
    {
-      if(mInstances[i].mIdentifier == pIdentifier)
-      {
-         instance = &mInstances[i];
-         break;
-      }
+      return registeredString;
    }
 
-   return instance;
-}
+   std::lock_guard<std::mutex> lock(mMutex);
 
-void InstancesHolder::releaseInstances(uint32_t pScopeLevel, bool pExecuteDestructors)
-{
-   while(!mInstances.empty() && mInstances.back().mScopeLevel >= pScopeLevel)
+   // the name might have been registered from another thread in the meantime
+   Table* table = mTable.load(std::memory_order_acquire);
+   registeredString = find(table, pHash);
+
+   if(registeredString)
    {
-      if(pExecuteDestructors)
+      return registeredString;
+   }
+
+   // keep the table at most half full, so probing sequences stay short
+   if((mNamesCount + 1u) * 2u > table->mCapacity)
+   {
+      Table* newTable = createTable(table->mCapacity * 2u, table);
+      Slot* slots = table->getSlots();
+
+      for(size_t i = 0u; i < table->mCapacity; i++)
       {
-         Instance& instance = mInstances.back();
-         Type* instanceType = instance.mTypeUsage.mType;
+         const char* string = slots[i].mString.load(std::memory_order_relaxed);
 
-         if(instanceType->mCategory == TypeCategory::StructOrClass &&
-            !instance.mTypeUsage.isPointer() &&
-            !instance.mTypeUsage.isReference())
+         if(string)
          {
-            const Identifier dtorId("~");
-            Struct* structOrClassType = static_cast<Struct*>(instanceType);
+            insert(newTable, slots[i].mHash, string);
+         }
+      }
 
-            for(size_t i = 0u; i < structOrClassType->mMethods.size(); i++)
-            {
-               if(structOrClassType->mMethods[i].mIdentifier == dtorId)
-               {
-                  Method& dtor = structOrClassType->mMethods[i];
+      mTable.store(newTable, std::memory_order_release);
+      table = newTable;
+   }
 
-                  TypeUsage thisPtrTypeUsage;
-                  thisPtrTypeUsage.mType = instanceType;
-                  thisPtrTypeUsage.mPointerLevel = 1u;
+   const size_t stringLength = strlen(pString);
+   char* string = allocateString(stringLength);
+   memcpy(string, pString, stringLength);
+   string[stringLength] = '\0';
 
-                  Value thisPtrValue;
-                  thisPtrValue.initExternal(thisPtrTypeUsage);
-                  thisPtrValue.set(&instance.mValue.mValueBuffer);
+   insert(table, pHash, string);
+   mNamesCount++;
+   mNamesSize += stringLength + 1u;
 
-                  CflatArgsVector(Value) args;
-                  dtor.execute(thisPtrValue, args, nullptr);
+   return string;
+}
 
-                  break;
-               }
-            }
-         }
-      }
+const char* Memory::NamesRegistry::retrieveString(Hash pHash)
+{
+   const char* registeredString =
+      pHash != 0u ? find(mTable.load(std::memory_order_acquire), pHash) : nullptr;
 
-      mInstances.pop_back();
-   }
+   return registeredString ? registeredString : "";
 }
 
-void InstancesHolder::getAllInstances(CflatSTLVector(Instance*)* pOutInstances)
+Memory::NamesRegistry::Stats Memory::NamesRegistry::getStats()
 {
-   for(size_t i = 0u; i < mInstances.size(); i++)
+   std::lock_guard<std::mutex> lock(mMutex);
+
+   Stats stats;
+   stats.mNamesCount = mNamesCount;
+   stats.mUsedSize = mNamesSize;
+   stats.mReservedSize = 0u;
+   stats.mTableCapacity = mTable.load(std::memory_order_relaxed)->mCapacity;
+
+   for(Table* table = mTable.load(std::memory_order_relaxed); table; table = table->mPrevious)
    {
-      pOutInstances->push_back(&mInstances[i]);
+      stats.mReservedSize += sizeof(Table) + table->mCapacity * sizeof(Slot);
    }
-}
 
+   for(Chunk* chunk = mChunk; chunk; chunk = chunk->mPrevious)
+   {
+      stats.mReservedSize += sizeof(Chunk) + chunk->mSize;
+   }
 
-//
-//  BuiltInType
-//
-BuiltInType::BuiltInType(Namespace* pNamespace, const Identifier& pIdentifier)
-   : Type(pNamespace, pIdentifier)
-{
-   mCategory = TypeCategory::BuiltIn;
+   return stats;
 }
 
-
-//
-//  Enum
-//
-Enum::Enum(Namespace* pNamespace, const Identifier& pIdentifier)
-   : Type(pNamespace, pIdentifier)
+const char* Memory::NamesRegistry::find(Table* pTable, Hash pHash)
 {
-   mCategory = TypeCategory::Enum;
-}
+   Slot* slots = pTable->getSlots();
+   const size_t mask = pTable->mCapacity - 1u;
 
+   for(size_t i = pHash & mask; ; i = (i + 1u) & mask)
+   {
+      const char* string = slots[i].mString.load(std::memory_order_acquire);
 
-//
-//  EnumClass
-//
-EnumClass::EnumClass(Namespace* pNamespace, const Identifier& pIdentifier)
-   : Type(pNamespace, pIdentifier)
-{
-   mCategory = TypeCategory::EnumClass;
-}
+      if(!string)
+      {
+         return nullptr;
+      }
 
+      if(slots[i].mHash == pHash)
+      {
+         return string;
+      }
+   }
+}
 
-//
-//  Struct
-//
-Struct::Struct(Namespace* pNamespace, const Identifier& pIdentifier)
-   : Type(pNamespace, pIdentifier)
+void Memory::NamesRegistry::insert(Table* pTable, Hash pHash, const char* pString)
 {
-   mCategory = TypeCategory::StructOrClass;
+   Slot* slots = pTable->getSlots();
+   const size_t mask = pTable->mCapacity - 1u;
+   size_t i = pHash & mask;
+
+   while(slots[i].mString.load(std::memory_order_relaxed))
+   {
+      i = (i + 1u) & mask;
+   }
+
+   // the hash has to be set before publishing the string
+   slots[i].mHash = pHash;
+   slots[i].mString.store(pString, std::memory_order_release);
 }
 
-Hash Struct::getHash() const
+Memory::NamesRegistry::Table* Memory::NamesRegistry::createTable(size_t pCapacity, Table* pPrevious)
 {
-   Hash hash = mIdentifier.mHash;
+   CflatAssert((pCapacity & (pCapacity - 1u)) == 0u);
 
-   for(size_t i = 0u; i < mTemplateTypes.size(); i++)
+   Table* table = (Table*)CflatAllocate(sizeof(Table) + pCapacity * sizeof(Slot), Identifiers);
+   table->mPrevious = pPrevious;
+   table->mCapacity = pCapacity;
+
+   Slot* slots = table->getSlots();
+
+   for(size_t i = 0u; i < pCapacity; i++)
    {
-      hash += mTemplateTypes[i].mType->getHash();
-      hash += (Hash)mTemplateTypes[i].mPointerLevel;
+      CflatInvokeCtor(Slot, &slots[i]);
    }
 
-   return hash;
+   return table;
 }
 
-bool Struct::derivedFrom(Type* pBaseType) const
+char* Memory::NamesRegistry::allocateString(size_t pLength)
 {
-   for(size_t i = 0u; i < mBaseTypes.size(); i++)
+   const size_t size = pLength + 1u;
+
+   if(!mChunk || (mChunkUsedSize + size) > mChunk->mSize)
    {
-      if(mBaseTypes[i].mType == pBaseType)
-         return true;
+      const size_t chunkSize =
+         size > kIdentifierStringsPoolSize ? size : kIdentifierStringsPoolSize;
+
+      Chunk* chunk = (Chunk*)CflatAllocate(sizeof(Chunk) + chunkSize, Identifiers);
+      chunk->mPrevious = mChunk;
+      chunk->mSize = chunkSize;
+
+      mChunk = chunk;
+      mChunkUsedSize = 0u;
    }
 
-   return false;
+   char* string = mChunk->getMemory() + mChunkUsedSize;
+   mChunkUsedSize += size;
+
+   return string;
 }
 
-uint16_t Struct::getOffset(Type* pBaseType) const
-{
-   for(size_t i = 0u; i < mBaseTypes.size(); i++)
-   {
-      if(mBaseTypes[i].mType == pBaseType)
-         return mBaseTypes[i].mOffset;
-   }
 
-   return 0u;
+//
+//  Identifier
+//
+std::atomic<Identifier::NamesRegistry*> Identifier::smNames(nullptr);
+
+Identifier::Identifier()
+   : mName("")
+   , mNameLength(0u)
+   , mHash(0u)
+{
 }
 
-Type* Struct::getType(const Identifier& pIdentifier)
+Identifier::Identifier(const char* pName)
 {
-   return mTypesHolder.getType(pIdentifier);
+   mHash = pName[0] != '\0' ? hash(pName) : 0u;
+   mName = getNamesRegistry()->registerString(mHash, pName);
+   mNameLength = (uint32_t)strlen(mName);
 }
 
-Type* Struct::getType(const Identifier& pIdentifier, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+Identifier::Identifier(const char* pName, Hash pHash)
+   : mHash(pHash)
 {
-   return mTypesHolder.getType(pIdentifier, pTemplateTypes);
+   CflatAssert(pHash == (pName[0] != '\0' ? hash(pName) : 0u));
+
+   mName = getNamesRegistry()->registerString(mHash, pName);
+   mNameLength = (uint32_t)strlen(mName);
 }
 
-void Struct::registerTypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
+Identifier::NamesRegistry* Identifier::getNamesRegistry()
 {
-   mTypesHolder.registerTypeAlias(pIdentifier, pTypeUsage);
+   NamesRegistry* names = smNames.load(std::memory_order_acquire);
+
+   if(!names)
+   {
+      NamesRegistry* newNames = (NamesRegistry*)CflatAllocate(sizeof(NamesRegistry), Identifiers);
+      CflatInvokeCtor(NamesRegistry, newNames);
+
+      // another thread might have created the registry first
+      if(smNames.compare_exchange_strong(names, newNames, std::memory_order_acq_rel))
+      {
+         names = newNames;
+      }
+      else
+      {
+         CflatInvokeDtor(NamesRegistry, newNames);
+         CflatDeallocate(newNames);
+      }
+   }
+
+   return names;
 }
 
-const TypeAlias* Struct::getTypeAlias(const Identifier& pIdentifier)
+void Identifier::releaseNamesRegistry()
 {
-   return mTypesHolder.getTypeAlias(pIdentifier);
+   NamesRegistry* names = smNames.exchange(nullptr, std::memory_order_acq_rel);
+
+   if(names)
+   {
+      CflatInvokeDtor(NamesRegistry, names);
+      CflatDeallocate(names);
+   }
 }
 
-Function* Struct::registerStaticMethod(const Identifier& pIdentifier)
+const char* Identifier::findFirstSeparator() const
 {
-   return mFunctionsHolder.registerFunction(pIdentifier);
+   if(mNameLength > 0u)
+   {
+      for(uint32_t i = 1u; i < (mNameLength - 1u); i++)
+      {
+         if(mName[i] == ':' && mName[i + 1u] == ':')
+         {
+            return (mName + i);
+         }
+      }
+   }
+
+   return nullptr;
+}
+const char* Identifier::findLastSeparator() const
+{
+   if(mNameLength > 0u)
+   {
+      for(uint32_t i = (mNameLength - 1u); i > 1u; i--)
+      {
+         if(mName[i] == ':' && mName[i - 1u] == ':')
+         {
+            return (mName + i - 1);
+         }
+      }
+   }
+
+   return nullptr;
 }
 
-Function* Struct::getStaticMethod(const Identifier& pIdentifier)
+bool Identifier::operator==(const Identifier& pOther) const
 {
-   return mFunctionsHolder.getFunction(pIdentifier);
+   return mHash == pOther.mHash;
+}
+bool Identifier::operator!=(const Identifier& pOther) const
+{
+   return mHash != pOther.mHash;
 }
 
-Function* Struct::getStaticMethod(const Identifier& pIdentifier,
-   const CflatArgsVector(TypeUsage)& pParameterTypes,
-   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+
+//
+//  Type
+//
+Type::~Type()
 {
-   return mFunctionsHolder.getFunction(pIdentifier, pParameterTypes, pTemplateTypes);
 }
 
-Function* Struct::getStaticMethod(const Identifier& pIdentifier,
-   const CflatArgsVector(Value)& pArguments,
-   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+Type::Type(Namespace* pNamespace, const Identifier& pIdentifier)
+   : mNamespace(pNamespace)
+   , mParent(nullptr)
+   , mIdentifier(pIdentifier)
+   , mSize(0u)
 {
-   return mFunctionsHolder.getFunction(pIdentifier, pArguments, pTemplateTypes);
 }
 
-CflatSTLVector(Function*)* Struct::getStaticMethods(const Identifier& pIdentifier)
+Hash Type::getHash() const
 {
-   return mFunctionsHolder.getFunctions(pIdentifier);
+   return mIdentifier.mHash;
 }
 
-void Struct::setStaticMember(const TypeUsage& pTypeUsage, const Identifier& pIdentifier,
-   const Value& pValue)
+bool Type::isDecimal() const
 {
-   mInstancesHolder.setVariable(pTypeUsage, pIdentifier, pValue);
+   return mCategory == TypeCategory::BuiltIn &&
+      (strncmp(mIdentifier.mName, "float", 5u) == 0 ||
+         strcmp(mIdentifier.mName, "double") == 0);
 }
 
-Value* Struct::getStaticMember(const Identifier& pIdentifier)
+bool Type::isInteger() const
 {
-   return mInstancesHolder.getVariable(pIdentifier);
+   return (mCategory == TypeCategory::BuiltIn && !isDecimal()) || mCategory == TypeCategory::Enum;
 }
 
-Instance* Struct::getStaticMemberInstance(const Identifier& pIdentifier)
+bool Type::compatibleWith(const Type& pOther) const
 {
-   return mInstancesHolder.retrieveInstance(pIdentifier);
+   return this == &pOther || (isInteger() && pOther.isInteger());
 }
 
 
 //
-//  Class
+//  TypeUsage
 //
-Class::Class(Namespace* pNamespace, const Identifier& pIdentifier)
-   : Struct(pNamespace, pIdentifier)
+const CflatArgsVector(TypeUsage) TypeUsage::kEmptyList;
+
+TypeUsage::TypeUsage()
+   : mType(nullptr)
+   , mArraySize(1u)
+   , mPointerLevel(0u)
+   , mFlags(0u)
 {
 }
 
-
-//
-//  TypeHelper
-//
-TypeHelper::Compatibility TypeHelper::getCompatibility(
-   const TypeUsage& pParameter, const TypeUsage& pArgument)
+size_t TypeUsage::getSize() const
 {
-   if(pParameter == pArgument)
+   if(mPointerLevel > 0u)
    {
-      return Compatibility::PerfectMatch;
+      return sizeof(void*);
    }
 
-   if(pParameter.mType == pArgument.mType &&
-      pParameter.mPointerLevel == pArgument.mPointerLevel &&
-      pParameter.getSize() == pArgument.getSize())
-   {
-      return Compatibility::PerfectMatch;
-   }
+   return mType ? mType->mSize * mArraySize : 0u;
+}
 
-   if(pArgument.compatibleWith(pParameter))
-   {
-      return Compatibility::ImplicitCastableInteger;
-   }
+bool TypeUsage::isPointer() const
+{
+   return mPointerLevel > 0u;
+}
 
-   if(pArgument.mType->mCategory == TypeCategory::BuiltIn &&
-      !pArgument.isPointer() &&
-      !pArgument.isReference() &&
-      pParameter.mType->mCategory == TypeCategory::BuiltIn &&
-      !pParameter.isPointer() &&
-      !pParameter.isReference())
-   {
-      if(pArgument.mType->isDecimal() && pParameter.mType->isDecimal())
-      {
-         return Compatibility::ImplicitCastableFloat;
-      }
+bool TypeUsage::isConst() const
+{
+   return CflatHasFlag(mFlags, TypeUsageFlags::Const);
+}
 
-      return Compatibility::ImplicitCastableIntegerFloat;
-   }
+bool TypeUsage::isReference() const
+{
+   return CflatHasFlag(mFlags, TypeUsageFlags::Reference);
+}
 
-   if(pArgument.mType->mCategory == TypeCategory::StructOrClass &&
-      pArgument.isPointer() &&
-      pParameter.mType->mCategory == TypeCategory::StructOrClass &&
-      pParameter.isPointer())
-   {
-      Struct* argumentType = static_cast<Struct*>(pArgument.mType);
-      Struct* parameterType = static_cast<Struct*>(pParameter.mType);
+bool TypeUsage::isArray() const
+{
+   return CflatHasFlag(mFlags, TypeUsageFlags::Array);
+}
 
-      if(argumentType->derivedFrom(parameterType))
-      {
-         return Compatibility::ImplicitCastableInheritance;
-      }
-   }
+bool TypeUsage::compatibleWith(const TypeUsage& pOther) const
+{
+   return
+      mType->compatibleWith(*pOther.mType) &&
+      mArraySize == pOther.mArraySize &&
+      mPointerLevel == pOther.mPointerLevel;
+}
 
-   return Compatibility::Incompatible;
+bool TypeUsage::operator==(const TypeUsage& pOther) const
+{
+   return
+      mType == pOther.mType &&
+      mArraySize == pOther.mArraySize &&
+      mPointerLevel == pOther.mPointerLevel &&
+      isReference() == pOther.isReference();
+}
+bool TypeUsage::operator!=(const TypeUsage& pOther) const
+{
+   return !operator==(pOther);
 }
 
 
 //
-//  Tokenizer
+//  TypeAlias
 //
-const char* kCflatPunctuation[] =
-{
-   ".", ",", ":", ";", "->", "(", ")", "{", "}", "[", "]", "::"
-};
-const size_t kCflatPunctuationCount = sizeof(kCflatPunctuation) / sizeof(const char*);
-
-const char* kCflatOperators[] =
-{
-   "+", "-", "*", "/", "%",
-   "++", "--", "!",
-   "=", "+=", "-=", "*=", "/=", "&=", "|=",
-   "<<", ">>",
-   "==", "!=", ">", "<", ">=", "<=",
-   "&&", "||", "&", "|", "~", "^"
-};
-const size_t kCflatOperatorsCount = sizeof(kCflatOperators) / sizeof(const char*);
-
-const char* kCflatAssignmentOperators[] =
+TypeAlias::TypeAlias()
+  : mScopeLevel(0u)
 {
-   "=", "+=", "-=", "*=", "/=", "&=", "|="
-};
-const size_t kCflatAssignmentOperatorsCount = sizeof(kCflatAssignmentOperators) / sizeof(const char*);
+}
 
-const char* kCflatLogicalOperators[] =
+TypeAlias::TypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
+  : mIdentifier(pIdentifier)
+  , mTypeUsage(pTypeUsage)
+  , mScopeLevel(0u)
 {
-   "==", "!=", ">", "<", ">=", "<=", "&&", "||"
-};
-const size_t kCflatLogicalOperatorsCount = sizeof(kCflatLogicalOperators) / sizeof(const char*);
+}
 
-const char* kCflatConditionalOperator = "?";
 
-const char* kCflatBinaryOperators[] =
-{
-   "*", "/", "%",
-   "+", "-",
-   "<<", ">>",
-   "<", "<=", ">", ">=",
-   "==", "!=",
-   "&",
-   "^",
-   "|",
-   "&&",
-   "||"
-};
-const uint8_t kCflatBinaryOperatorsPrecedence[] =
+//
+//  Member
+//
+Member::Member(const Identifier& pIdentifier)
+   : mIdentifier(pIdentifier)
+   , mOffset(0u)
 {
-   1u, 1u, 1u,
-   2u, 2u,
-   3u, 3u,
-   4u, 4u, 4u, 4u,
-   5u, 5u,
-   6u,
-   7u,
-   8u,
-   9u,
-   10u
-};
-const size_t kCflatBinaryOperatorsCount = sizeof(kCflatBinaryOperators) / sizeof(const char*);
-static_assert
-(
-   kCflatBinaryOperatorsCount == (sizeof(kCflatBinaryOperatorsPrecedence) / sizeof(uint8_t)),
-   "Precedence must be defined for all binary operators"
-);
+}
 
-const char* kCflatKeywords[] =
-{
-   "break", "case", "class", "const", "const_cast", "continue", "default",
-   "delete", "do", "dynamic_cast", "else", "enum", "false", "for", "if",
-   "namespace", "new", "nullptr", "operator", "private", "protected", "public",
-   "reinterpret_cast", "return", "sizeof", "static", "static_cast",
-   "struct", "switch", "this", "true", "typedef", "union", "unsigned",
-   "using", "virtual", "void", "while"
-};
-const size_t kCflatKeywordsCount = sizeof(kCflatKeywords) / sizeof(const char*);
 
-void Tokenizer::tokenize(const char* pCode, CflatSTLVector(Token)& pTokens)
+//
+//  Value
+//
+const CflatArgsVector(Value) Value::kEmptyList;
+
+Value::Value()
+   : mValueBufferType(ValueBufferType::Uninitialized)
+   , mValueInitializationHint(ValueInitializationHint::None)
+   , mValueBuffer(nullptr)
+   , mStack(nullptr)
 {
-   char* cursor = const_cast<char*>(pCode);
-   uint16_t currentLine = 1u;
+}
 
-   pTokens.clear();
+Value::Value(const Value& pOther)
+   : mValueBufferType(ValueBufferType::Uninitialized)
+   , mValueInitializationHint(ValueInitializationHint::None)
+   , mValueBuffer(nullptr)
+   , mStack(nullptr)
+{
+   *this = pOther;
+}
 
-   while(*cursor != '\0')
+Value::~Value()
+{
+   if(mValueBufferType == ValueBufferType::Stack)
    {
-      while(*cursor == ' ' || *cursor == '\t' || *cursor == '\n')
-      {
-         if(*cursor == '\n')
-         {
-            currentLine++;
-         }
-
-         cursor++;
-      }
-
-      if(*cursor == '\0')
-      {
-         break;
-      }
-
-      Token token;
-      token.mStart = cursor;
-      token.mLength = 1u;
-      token.mLine = currentLine;
-
-      // string
-      if(*cursor == '"')
-      {
-         do
-         {
-            cursor++;
-         }
-         while(!(*cursor == '"' && *(cursor - 1) != '\\'));
-
-         cursor++;
-         token.mLength = cursor - token.mStart;
-         token.mType = TokenType::String;
-         pTokens.push_back(token);
-         continue;
-      }
-
-      // numeric value
-      if(isdigit(*cursor) || (*cursor == '.' && isdigit(*(cursor + 1))))
-      {
-         if(*cursor == '0' && *(cursor + 1) == 'x')
-         {
-            cursor++;
-
-            do
-            {
-               cursor++;
-            }
-            while(isxdigit(*cursor));
-         }
-         else
-         {
-            do
-            {
-               cursor++;
-            }
-            while(isdigit(*cursor) || *cursor == '.' || *cursor == 'f' || *cursor == 'u');
-         }
-
-         token.mLength = cursor - token.mStart;
-         token.mType = TokenType::Number;
-         pTokens.push_back(token);
-         continue;
-      }
-
-      // punctuation (2 characters)
-      const size_t tokensCount = pTokens.size();
-
-      for(size_t i = 0u; i < kCflatPunctuationCount; i++)
-      {
-         if(strncmp(token.mStart, kCflatPunctuation[i], 2u) == 0)
-         {
-            cursor += 2u;
-            token.mLength = cursor - token.mStart;
-            token.mType = TokenType::Punctuation;
-            pTokens.push_back(token);
-            break;
-         }
-      }
-
-      if(pTokens.size() > tokensCount)
-      {
-         continue;
-      }
+      CflatAssert(mStack);
+      CflatAssert(mStack->mPointer == mValueBuffer + mTypeUsage.getSize());
+      mStack->pop(mTypeUsage.getSize());
+   }
+   else if(mValueBufferType == ValueBufferType::Heap)
+   {
+      CflatAssert(mValueBuffer);
+      CflatDeallocate(mValueBuffer);
+   }
+}
 
-      // operator (2 characters)
-      for(size_t i = 0u; i < kCflatOperatorsCount; i++)
-      {
-         if(strncmp(token.mStart, kCflatOperators[i], 2u) == 0)
-         {
-            cursor += 2u;
-            token.mLength = cursor - token.mStart;
-            token.mType = TokenType::Operator;
-            pTokens.push_back(token);
-            break;
-         }
-      }
+void Value::reset()
+{
+   CflatInvokeDtor(Value, this);
+   CflatInvokeCtor(Value, this);
+}
 
-      if(pTokens.size() > tokensCount)
-      {
-         continue;
-      }
+void Value::initOnStack(const TypeUsage& pTypeUsage, EnvironmentStack* pStack)
+{
+   CflatAssert(mValueBufferType == ValueBufferType::Uninitialized);
+   CflatAssert(pStack);
 
-      // punctuation (1 character)
-      for(size_t i = 0u; i < kCflatPunctuationCount; i++)
-      {
-         if(token.mStart[0] == kCflatPunctuation[i][0] && kCflatPunctuation[i][1] == '\0')
-         {
-            cursor++;
-            token.mType = TokenType::Punctuation;
-            pTokens.push_back(token);
-            break;
-         }
-      }
+   mTypeUsage = pTypeUsage;
 
-      if(pTokens.size() > tokensCount)
-      {
-         continue;
-      }
+   if(pTypeUsage.getSize() <= kValueInlineBufferSize)
+   {
+      mValueBufferType = ValueBufferType::Inline;
+      mValueBuffer = mInlineBuffer;
+   }
+   else
+   {
+      mValueBuffer = (char*)pStack->push(pTypeUsage.getSize());
 
-      // operator (1 character)
-      if(token.mStart[0] == kCflatConditionalOperator[0])
+      if(mValueBuffer)
       {
-         cursor++;
-         token.mType = TokenType::Operator;
-         pTokens.push_back(token);
+         mValueBufferType = ValueBufferType::Stack;
+         mStack = pStack;
       }
+      // the stack has overflown, which the environment reports as a runtime error, so the value
+      // takes its memory from the heap until the execution unwinds
       else
       {
-         for(size_t i = 0u; i < kCflatOperatorsCount; i++)
-         {
-            if(token.mStart[0] == kCflatOperators[i][0])
-            {
-               cursor++;
-               token.mType = TokenType::Operator;
-               pTokens.push_back(token);
-               break;
-            }
-         }
-      }
-
-      if(pTokens.size() > tokensCount)
-      {
-         continue;
+         mValueBufferType = ValueBufferType::Heap;
+         mValueBuffer = (char*)CflatAllocate(pTypeUsage.getSize(), Values);
       }
+   }
+}
 
-      // keywords
-      for(size_t i = 0u; i < kCflatKeywordsCount; i++)
-      {
-         const size_t keywordLength = strlen(kCflatKeywords[i]);
-
-         if(strncmp(token.mStart, kCflatKeywords[i], keywordLength) == 0 &&
-            !isalnum(token.mStart[keywordLength]) &&
-            token.mStart[keywordLength] != '_')
-         {
-            cursor += keywordLength;
-            token.mLength = cursor - token.mStart;
-            token.mType = TokenType::Keyword;
-            pTokens.push_back(token);
-            break;
-         }
-      }
+void Value::initOnHeap(const TypeUsage& pTypeUsage)
+{
+   CflatAssert(mValueBufferType != ValueBufferType::Stack);
 
-      if(pTokens.size() > tokensCount)
-      {
-         continue;
-      }
+   const size_t size = pTypeUsage.getSize();
+   const bool allocationRequired =
+      (mValueBufferType != ValueBufferType::Heap && mValueBufferType != ValueBufferType::Inline) ||
+      mTypeUsage.getSize() != size;
 
-      // identifier
-      do
-      {
-         cursor++;
-      }
-      while(isalnum(*cursor) || *cursor == '_');
+   mTypeUsage = pTypeUsage;
 
-      token.mLength = cursor - token.mStart;
-      token.mType = TokenType::Identifier;
-      pTokens.push_back(token);
+   if(!allocationRequired)
+   {
+      return;
    }
-}
-
 
-//
-//  Program
-//
-Program::~Program()
-{
-   for(size_t i = 0u; i < mStatements.size(); i++)
+   if(mValueBufferType == ValueBufferType::Heap)
    {
-      CflatInvokeDtor(Statement, mStatements[i]);
-      CflatFree(mStatements[i]);
+      CflatDeallocate(mValueBuffer);
    }
-}
 
-
-//
-//  Namespace
-//
-Namespace::Namespace(const Identifier& pIdentifier, Namespace* pParent, Environment* pEnvironment)
-   : mIdentifier(pIdentifier)
-   , mFullIdentifier(pIdentifier)
-   , mParent(pParent)
-   , mEnvironment(pEnvironment)
-{
-   if(pParent && pParent->getParent())
+   if(size <= kValueInlineBufferSize)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      sprintf(buffer, "%s::%s", mParent->mFullIdentifier.mName, mIdentifier.mName);
-      mFullIdentifier = Identifier(buffer);
+      mValueBufferType = ValueBufferType::Inline;
+      mValueBuffer = mInlineBuffer;
    }
-}
-
-Namespace::~Namespace()
-{
-   for(NamespacesRegistry::iterator it = mNamespaces.begin(); it != mNamespaces.end(); it++)
+   else
    {
-      Namespace* ns = it->second;
-      CflatInvokeDtor(Namespace, ns);
-      CflatFree(ns);
+      mValueBufferType = ValueBufferType::Heap;
+      mValueBuffer = (char*)CflatAllocate(size, Values);
    }
-
-   mInstancesHolder.releaseInstances(0u, true);
 }
 
-const Identifier& Namespace::getIdentifier() const
+void Value::initExternal(const TypeUsage& pTypeUsage)
 {
-   return mIdentifier;
+   CflatAssert(mValueBufferType == ValueBufferType::Uninitialized);
+   mTypeUsage = pTypeUsage;
+   mValueBufferType = ValueBufferType::External;
 }
 
-const Identifier& Namespace::getFullIdentifier() const
+void Value::set(const void* pDataSource)
 {
-   return mFullIdentifier;
-}
+   CflatAssert(mValueBufferType != ValueBufferType::Uninitialized);
+   CflatAssert(pDataSource);
 
-Namespace* Namespace::getParent()
-{
-   return mParent;
+   if(mValueBufferType == ValueBufferType::External)
+   {
+      mValueBuffer = (char*)pDataSource;
+   }
+   else
+   {
+      memcpy(mValueBuffer, pDataSource, mTypeUsage.getSize());
+   }
 }
 
-Namespace* Namespace::getChild(Hash pNameHash)
+void Value::assign(const void* pDataSource)
 {
-   NamespacesRegistry::const_iterator it = mNamespaces.find(pNameHash);
-   return it != mNamespaces.end() ? it->second : nullptr;
+   CflatAssert(mValueBufferType != ValueBufferType::Uninitialized);
+   CflatAssert(pDataSource);
+
+   memcpy(mValueBuffer, pDataSource, mTypeUsage.getSize());
 }
 
-Namespace* Namespace::getNamespace(const Identifier& pName)
+Value& Value::operator=(const Value& pOther)
 {
-   const char* separator = pName.findFirstSeparator();
-
-   if(separator)
+   if(pOther.mValueBufferType == ValueBufferType::Uninitialized)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t childIdentifierLength = separator - pName.mName;
-      strncpy(buffer, pName.mName, childIdentifierLength);
-      buffer[childIdentifierLength] = '\0';
-
-      const Hash childNameHash = hash(buffer);
-      Namespace* child = getChild(childNameHash);
-
-      if(child)
+      reset();
+   }
+   else
+   {
+      switch(mValueBufferType)
       {
-         const Identifier subIdentifier(separator + 2);
-         return child->getNamespace(subIdentifier);
+      case ValueBufferType::Uninitialized:
+      case ValueBufferType::External:
+         mTypeUsage = pOther.mTypeUsage;
+         mValueBufferType = ValueBufferType::External;
+         mValueBuffer = pOther.mValueBuffer;
+         break;
+      case ValueBufferType::Stack:
+         CflatAssert(mTypeUsage.compatibleWith(pOther.mTypeUsage));
+         memcpy(mValueBuffer, pOther.mValueBuffer, mTypeUsage.getSize());
+         break;
+      case ValueBufferType::Heap:
+      case ValueBufferType::Inline:
+         initOnHeap(pOther.mTypeUsage);
+         memcpy(mValueBuffer, pOther.mValueBuffer, mTypeUsage.getSize());
+         break;
       }
-
-      return nullptr;
    }
 
-   return getChild(pName.mHash);
+   return *this;
 }
 
-Namespace* Namespace::requestNamespace(const Identifier& pName)
-{
-   const char* separator = pName.findFirstSeparator();
-
-   if(separator)
-   {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t childIdentifierLength = separator - pName.mName;
-      strncpy(buffer, pName.mName, childIdentifierLength);
-      buffer[childIdentifierLength] = '\0';
 
-      const Identifier childIdentifier(buffer);
-      Namespace* child = getChild(childIdentifier.mHash);
+//
+//  UsingDirective
+//
+UsingDirective::UsingDirective(Namespace* pNamespace)
+   : mNamespace(pNamespace)
+   , mBlockLevel(0u)
+{
+}
 
-      if(!child)
-      {
-         child = (Namespace*)CflatMalloc(sizeof(Namespace));
-         CflatInvokeCtor(Namespace, child)(childIdentifier, this, mEnvironment);
-         mNamespaces[childIdentifier.mHash] = child;
-      }
 
-      const Identifier subIdentifier(separator + 2);
-      return child->requestNamespace(subIdentifier);
-   }
+//
+//  Function
+//
+Function::Function(const Identifier& pIdentifier)
+   : mNamespace(nullptr)
+   , mIdentifier(pIdentifier)
+   , mProgram(nullptr)
+   , mLine(0u)
+   , mDeclaration(nullptr)
+   , mNativeCall(nullptr)
+   , execute(nullptr)
+{
+}
 
-   Namespace* child = getChild(pName.mHash);
+Function::~Function()
+{
+   execute = nullptr;
+}
 
-   if(!child)
-   {
-      child = (Namespace*)CflatMalloc(sizeof(Namespace));
-      CflatInvokeCtor(Namespace, child)(pName, this, mEnvironment);
-      mNamespaces[pName.mHash] = child;
-   }
 
-   return child;
+//
+//  Method
+//
+Method::Method(const Identifier& pIdentifier)
+   : mIdentifier(pIdentifier)
+   , mNativeCall(nullptr)
+   , execute(nullptr)
+{
 }
 
-Type* Namespace::getType(const Identifier& pIdentifier, bool pExtendSearchToParent)
+Method::~Method()
 {
-   return getType(pIdentifier, TypeUsage::kEmptyList, pExtendSearchToParent);
+   execute = nullptr;
 }
 
-Type* Namespace::getType(const Identifier& pIdentifier,
-   const CflatArgsVector(TypeUsage)& pTemplateTypes, bool pExtendSearchToParent)
-{
-   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-   if(lastSeparator)
+//
+//  Native calls
+//
+namespace Cflat
+{
+   static void invokeNativeCall(NativeCall pNativeCall, void* pThis, const void* const* pArgumentsData,
+      const TypeUsage& pReturnTypeUsage, Value* pOutReturnValue)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier typeIdentifier(lastSeparator + 2);
-
-      Namespace* ns = getNamespace(nsIdentifier);
-
-      if(ns)
+      if(!pOutReturnValue)
       {
-         return ns->getType(typeIdentifier, pTemplateTypes);
+         pNativeCall(pThis, pArgumentsData, nullptr);
       }
-
-      Type* type = nullptr;
-
-      if(pExtendSearchToParent && mParent)
+      // references come back as the address of the data they refer to
+      else if(pReturnTypeUsage.isReference())
       {
-         type = mParent->getType(pIdentifier, pTemplateTypes, true);
+         const void* referencedData = nullptr;
+         pNativeCall(pThis, pArgumentsData, &referencedData);
+         pOutReturnValue->set(referencedData);
       }
-
-      if(!type)
+      else
       {
-         Type* parentType = getType(nsIdentifier);
-
-         if(parentType && parentType->mCategory == TypeCategory::StructOrClass)
-         {
-            type = static_cast<Struct*>(parentType)->getType(typeIdentifier, pTemplateTypes);
-         }
+         pNativeCall(pThis, pArgumentsData, pOutReturnValue->mValueBuffer);
       }
-
-      return type;
    }
+}
 
-   const TypeAlias* typeAlias = getTypeAlias(pIdentifier);
+void Cflat::bindNativeCall(Function* pFunction, NativeCall pNativeCall)
+{
+   pFunction->mNativeCall = pNativeCall;
 
-   if(typeAlias && typeAlias->mTypeUsage.mFlags == 0u)
+   // calls made through 'execute' (e.g. from the host) end up in the native call as well
+   pFunction->execute = [pFunction, pNativeCall](const CflatArgsVector(Value)& pArguments,
+      Value* pOutReturnValue)
    {
-      return typeAlias->mTypeUsage.mType;
-   }
+      const void* argumentsData[kArgsVectorSize];
 
-   Type* type = mTypesHolder.getType(pIdentifier, pTemplateTypes);
+      for(size_t i = 0u; i < pArguments.size(); i++)
+      {
+         argumentsData[i] = pArguments[i].mValueBuffer;
+      }
 
-   if(type)
-   {
-      return type;
-   }
+      invokeNativeCall(pNativeCall, nullptr, argumentsData, pFunction->mReturnTypeUsage,
+         pOutReturnValue);
+   };
+}
 
-   if(pExtendSearchToParent && mParent)
+void Cflat::bindNativeCall(Method* pMethod, NativeCall pNativeCall)
+{
+   pMethod->mNativeCall = pNativeCall;
+
+   pMethod->execute = [pMethod, pNativeCall](const Value& pThis,
+      const CflatArgsVector(Value)& pArguments, Value* pOutReturnValue)
    {
-      return mParent->getType(pIdentifier, pTemplateTypes, true);
-   }
+      const void* argumentsData[kArgsVectorSize];
 
-   return nullptr;
+      for(size_t i = 0u; i < pArguments.size(); i++)
+      {
+         argumentsData[i] = pArguments[i].mValueBuffer;
+      }
+
+      invokeNativeCall(pNativeCall, CflatValueAs(&pThis, void*), argumentsData,
+         pMethod->mReturnTypeUsage, pOutReturnValue);
+   };
 }
 
-void Namespace::registerTypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
+
+//
+//  Instance
+//
+Instance::Instance()
+   : mScopeLevel(0u)
 {
-   mTypesHolder.registerTypeAlias(pIdentifier, pTypeUsage);
 }
 
-const TypeAlias* Namespace::getTypeAlias(const Identifier& pIdentifier)
+Instance::Instance(const TypeUsage& pTypeUsage, const Identifier& pIdentifier)
+   : mTypeUsage(pTypeUsage)
+   , mIdentifier(pIdentifier)
+   , mScopeLevel(0u)
 {
-   return mTypesHolder.getTypeAlias(pIdentifier);
 }
 
-TypeUsage Namespace::getTypeUsage(const char* pTypeName)
+
+//
+//  TypesHolder
+//
+TypesHolder::~TypesHolder()
 {
-   return mEnvironment->getTypeUsage(pTypeName, this);
+   for(TypesRegistry::iterator it = mTypes.begin(); it != mTypes.end(); it++)
+   {
+      Type* type = it->second;
+      CflatInvokeDtor(Type, type);
+      CflatDeallocate(type);
+   }
 }
 
-Function* Namespace::getFunction(const Identifier& pIdentifier, bool pExtendSearchToParent)
+Type* TypesHolder::getType(const Identifier& pIdentifier)
 {
-   const char* lastSeparator = pIdentifier.findLastSeparator();
+   TypesRegistry::const_iterator it = mTypes.find(pIdentifier.mHash);
+   return it != mTypes.end() ? it->second : nullptr;
+}
 
-   if(lastSeparator)
+Type* TypesHolder::getType(const Identifier& pIdentifier, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   Hash hash = pIdentifier.mHash;
+
+   for(size_t i = 0u; i < pTemplateTypes.size(); i++)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier functionIdentifier(lastSeparator + 2);
+      hash += pTemplateTypes[i].mType->getHash();
+      hash += (Hash)pTemplateTypes[i].mPointerLevel;
+   }
 
-      Namespace* ns = getNamespace(nsIdentifier);
+   TypesRegistry::const_iterator it = mTypes.find(hash);
+   return it != mTypes.end() ? it->second : nullptr;
+}
 
-      if(ns)
-      {
-         return ns->getFunction(functionIdentifier);
-      }
+void TypesHolder::registerTypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
+{
+   TypeAlias typeAlias(pIdentifier, pTypeUsage);
+   mTypeAliases[pIdentifier.mHash] = typeAlias;
+}
 
-      Function* function = nullptr;
+const TypeAlias* TypesHolder::getTypeAlias(const Identifier& pIdentifier)
+{
+   TypeAliasesRegistry::const_iterator it = mTypeAliases.find(pIdentifier.mHash);
+   return it != mTypeAliases.end() ? &it->second : nullptr;
+}
 
-      if(pExtendSearchToParent && mParent)
+void TypesHolder::registerSharedTypes(TypesHolder* pSource)
+{
+   for(TypesRegistry::const_iterator it = pSource->mTypes.begin(); it != pSource->mTypes.end(); it++)
+   {
+      Type* type = it->second;
+
+      // the special methods get looked up lazily, which cannot happen once the type is shared,
+      // since it might be in use from several threads
+      if(type->mCategory == TypeCategory::StructOrClass)
       {
-         function = mParent->getFunction(pIdentifier, true);
+         static_cast<Struct*>(type)->lookUpSpecialMethods();
       }
 
-      return function;
+      mTypes[it->first] = type;
    }
 
-   Function* function = mFunctionsHolder.getFunction(pIdentifier);
-
-   if(!function && pExtendSearchToParent && mParent)
+   for(TypeAliasesRegistry::const_iterator it = pSource->mTypeAliases.begin();
+      it != pSource->mTypeAliases.end(); it++)
    {
-      function = mParent->getFunction(pIdentifier, true);
+      mTypeAliases[it->first] = it->second;
    }
-
-   return function;
 }
 
-Function* Namespace::getFunction(const Identifier& pIdentifier,
-   const CflatArgsVector(TypeUsage)& pParameterTypes,
-   const CflatArgsVector(TypeUsage)& pTemplateTypes,
-   bool pExtendSearchToParent)
+void TypesHolder::unregisterSharedTypes(const Namespace* pOwner)
 {
-   const char* lastSeparator = pIdentifier.findLastSeparator();
-
-   if(lastSeparator)
+   for(TypesRegistry::iterator it = mTypes.begin(); it != mTypes.end(); )
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier functionIdentifier(lastSeparator + 2);
-
-      Namespace* ns = getNamespace(nsIdentifier);
-
-      if(ns)
+      if(it->second->mNamespace != pOwner)
       {
-         return ns->getFunction(functionIdentifier, pParameterTypes, pTemplateTypes);
+         it = mTypes.erase(it);
       }
-
-      Function* function = nullptr;
-
-      if(pExtendSearchToParent && mParent)
+      else
       {
-         function = mParent->getFunction(pIdentifier, pParameterTypes, pTemplateTypes, true);
+         it++;
       }
-
-      return function;
    }
+}
 
-   Function* function = mFunctionsHolder.getFunction(pIdentifier, pParameterTypes, pTemplateTypes);
 
-   if(!function && pExtendSearchToParent && mParent)
+//
+//  FunctionsHolder
+//
+FunctionsHolder::~FunctionsHolder()
+{
+   for(FunctionsRegistry::iterator it = mFunctions.begin(); it != mFunctions.end(); it++)
    {
-      function = mParent->getFunction(pIdentifier, pParameterTypes, pTemplateTypes, true);
+      CflatSTLVector(Function*)& functions = it->second;
+
+      for(size_t i = 0u; i < functions.size(); i++)
+      {
+         Function* function = functions[i];
+         CflatInvokeDtor(Function, function);
+         CflatDeallocate(function);
+      }
    }
+}
 
-   return function;
+Function* FunctionsHolder::getFunction(const Identifier& pIdentifier)
+{
+   FunctionsRegistry::iterator it = mFunctions.find(pIdentifier.mHash);
+   return it != mFunctions.end() ? it->second.at(0) : nullptr;
 }
 
-Function* Namespace::getFunction(const Identifier& pIdentifier,
-   const CflatArgsVector(Value)& pArguments,
-   const CflatArgsVector(TypeUsage)& pTemplateTypes,
-   bool pExtendSearchToParent)
+Function* FunctionsHolder::getFunction(const Identifier& pIdentifier,
+   const CflatArgsVector(TypeUsage)& pParameterTypes, const CflatArgsVector(TypeUsage)& pTemplateTypes)
 {
-   const char* lastSeparator = pIdentifier.findLastSeparator();
+   Function* function = nullptr;
+   CflatSTLVector(Function*)* functions = getFunctions(pIdentifier);
 
-   if(lastSeparator)
+   if(functions)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier functionIdentifier(lastSeparator + 2);
+      // first pass: look for a perfect argument match
+      for(size_t i = 0u; i < functions->size(); i++)
+      {
+         Function* functionOverload = functions->at(i);
 
-      Namespace* ns = getNamespace(nsIdentifier);
+         if(functionOverload->mParameters.size() == pParameterTypes.size() &&
+            functionOverload->mTemplateTypes == pTemplateTypes)
+         {
+            bool parametersMatch = true;
 
-      if(ns)
-      {
-         return ns->getFunction(functionIdentifier, pArguments, pTemplateTypes);
+            for(size_t j = 0u; j < pParameterTypes.size(); j++)
+            {
+               const TypeHelper::Compatibility compatibility =
+                  TypeHelper::getCompatibility(functionOverload->mParameters[j], pParameterTypes[j]);
+
+               if(compatibility != TypeHelper::Compatibility::PerfectMatch)
+               {
+                  parametersMatch = false;
+                  break;
+               }
+            }
+
+            if(parametersMatch)
+            {
+               function = functionOverload;
+               break;
+            }
+         }
       }
-      
-      Function* function = nullptr;
 
-      if(pExtendSearchToParent && mParent)
+      // second pass: look for a compatible argument match
+      if(!function)
       {
-         function = mParent->getFunction(pIdentifier, pArguments, pTemplateTypes, true);
-      }
+         for(size_t i = 0u; i < functions->size(); i++)
+         {
+            Function* functionOverload = functions->at(i);
 
-      return function;
-   }
+            if(functionOverload->mParameters.size() == pParameterTypes.size() &&
+               functionOverload->mTemplateTypes == pTemplateTypes)
+            {
+               bool parametersMatch = true;
 
-   Function* function = mFunctionsHolder.getFunction(pIdentifier, pArguments, pTemplateTypes);
+               for(size_t j = 0u; j < pParameterTypes.size(); j++)
+               {
+                  const TypeHelper::Compatibility compatibility =
+                     TypeHelper::getCompatibility(functionOverload->mParameters[j], pParameterTypes[j]);
 
-   if(!function && pExtendSearchToParent && mParent)
-   {
-      function = mParent->getFunction(pIdentifier, pArguments, pTemplateTypes, true);
+                  if(compatibility == TypeHelper::Compatibility::Incompatible)
+                  {
+                     parametersMatch = false;
+                     break;
+                  }
+               }
+
+               if(parametersMatch)
+               {
+                  function = functionOverload;
+                  break;
+               }
+            }
+         }
+      }
    }
 
    return function;
 }
 
-CflatSTLVector(Function*)* Namespace::getFunctions(const Identifier& pIdentifier,
-   bool pExtendSearchToParent)
+Function* FunctionsHolder::getFunction(const Identifier& pIdentifier,
+   const CflatArgsVector(Value)& pArguments, const CflatArgsVector(TypeUsage)& pTemplateTypes)
 {
-   const char* lastSeparator = pIdentifier.findLastSeparator();
+   CflatArgsVector(TypeUsage) typeUsages;
 
-   if(lastSeparator)
+   for(size_t i = 0u; i < pArguments.size(); i++)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier functionIdentifier(lastSeparator + 2);
+      typeUsages.push_back(pArguments[i].mTypeUsage);
+   }
 
-      Namespace* ns = getNamespace(nsIdentifier);
+   return getFunction(pIdentifier, typeUsages, pTemplateTypes);
+}
 
-      if(ns)
-      {
-         return ns->getFunctions(functionIdentifier);
-      }
+CflatSTLVector(Function*)* FunctionsHolder::getFunctions(const Identifier& pIdentifier)
+{
+   FunctionsRegistry::iterator it = mFunctions.find(pIdentifier.mHash);
+   return it != mFunctions.end() ? &it->second : nullptr;
+}
 
-      CflatSTLVector(Function*)* functions = nullptr;
+void FunctionsHolder::getAllFunctions(CflatSTLVector(Function*)* pOutFunctions)
+{
+   for(FunctionsRegistry::const_iterator it = mFunctions.begin(); it != mFunctions.end(); it++)
+   {
+      const CflatSTLVector(Function*)& functions = it->second;
 
-      if(pExtendSearchToParent && mParent)
+      for(size_t i = 0u; i < functions.size(); i++)
       {
-         functions = mParent->getFunctions(pIdentifier, true);
+         pOutFunctions->push_back(functions[i]);
       }
+   }
+}
 
-      if(!functions)
-      {
-         Type* parentType = getType(nsIdentifier);
+void FunctionsHolder::registerSharedFunctions(FunctionsHolder* pSource)
+{
+   for(FunctionsRegistry::const_iterator it = pSource->mFunctions.begin();
+      it != pSource->mFunctions.end(); it++)
+   {
+      CflatSTLVector(Function*)& functions = mFunctions[it->first];
+      functions.insert(functions.end(), it->second.begin(), it->second.end());
+   }
+}
 
-         if(parentType && parentType->mCategory == TypeCategory::StructOrClass)
+void FunctionsHolder::unregisterSharedFunctions(const Namespace* pOwner)
+{
+   for(FunctionsRegistry::iterator it = mFunctions.begin(); it != mFunctions.end(); it++)
+   {
+      CflatSTLVector(Function*)& functions = it->second;
+
+      for(size_t i = 0u; i < functions.size(); )
+      {
+         if(functions[i]->mNamespace != pOwner)
          {
-            functions = static_cast<Struct*>(parentType)->getStaticMethods(pIdentifier);
+            functions.erase(functions.begin() + i);
+         }
+         else
+         {
+            i++;
          }
       }
-
-      return functions;
    }
+}
 
-   CflatSTLVector(Function*)* functions = mFunctionsHolder.getFunctions(pIdentifier);
+Function* FunctionsHolder::registerFunction(const Identifier& pIdentifier)
+{
+   Function* function = (Function*)CflatAllocate(sizeof(Function), Types);
+   CflatInvokeCtor(Function, function)(pIdentifier);
+   FunctionsRegistry::iterator it = mFunctions.find(pIdentifier.mHash);
 
-   if(!functions && pExtendSearchToParent && mParent)
+   if(it == mFunctions.end())
    {
-      functions = mParent->getFunctions(pIdentifier, true);
+      CflatSTLVector(Function*) functions;
+      functions.push_back(function);
+      mFunctions[pIdentifier.mHash] = functions;
+   }
+   else
+   {
+      it->second.push_back(function);
    }
 
-   return functions;
+   return function;
 }
 
-Function* Namespace::registerFunction(const Identifier& pIdentifier)
-{
-   const char* lastSeparator = pIdentifier.findLastSeparator();
-
-   if(lastSeparator)
-   {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier functionIdentifier(lastSeparator + 2);
 
-      Namespace* ns = requestNamespace(nsIdentifier);
-      return ns->registerFunction(functionIdentifier);
-   }
+//
+//  InstancesHolder
+//
+const uint32_t InstancesHolder::kInvalidIndex;
+const size_t InstancesHolder::kInitialBucketsCount;
 
-   Function* function = mFunctionsHolder.registerFunction(pIdentifier);
-   function->mNamespace = this;
+InstancesHolder::InstancesHolder()
+{
+}
 
-   return function;
+InstancesHolder::~InstancesHolder()
+{
+   releaseInstances(0u, true);
 }
 
-void Namespace::setVariable(const TypeUsage& pTypeUsage, const Identifier& pIdentifier,
+void InstancesHolder::setVariable(const TypeUsage& pTypeUsage, const Identifier& pIdentifier,
    const Value& pValue)
 {
-   const char* lastSeparator = pIdentifier.findLastSeparator();
-
-   if(lastSeparator)
-   {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier variableIdentifier(lastSeparator + 2);
-
-      Namespace* ns = requestNamespace(nsIdentifier);
-      return ns->setVariable(pTypeUsage, variableIdentifier, pValue);
-   }
-
    Instance* instance = retrieveInstance(pIdentifier);
 
    if(!instance)
@@ -2663,6462 +3210,10887 @@ void Namespace::setVariable(const TypeUsage& pTypeUsage, const Identifier& pIden
       instance = registerInstance(pTypeUsage, pIdentifier);
    }
 
-   instance->mValue.initOnHeap(pTypeUsage);
-   instance->mValue.set(pValue.mValueBuffer);
+   instance->mValue = pValue;
 }
 
-Value* Namespace::getVariable(const Identifier& pIdentifier, bool pExtendSearchToParent)
+Value* InstancesHolder::getVariable(const Identifier& pIdentifier)
 {
-   const char* lastSeparator = pIdentifier.findLastSeparator();
+   Instance* instance = retrieveInstance(pIdentifier);
+   return instance ? &instance->mValue : nullptr;
+}
 
-   if(lastSeparator)
+Instance* InstancesHolder::registerInstance(const TypeUsage& pTypeUsage, const Identifier& pIdentifier)
+{
+   mInstances.emplace_back(pTypeUsage, pIdentifier);
+   mPreviousInBucket.push_back(kInvalidIndex);
+
+   if(pIdentifier.mHash != 0u)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier variableIdentifier(lastSeparator + 2);
-
-      Namespace* ns = getNamespace(nsIdentifier);
-
-      if(ns)
+      if(mInstances.size() > mBuckets.size())
       {
-         return ns->getVariable(variableIdentifier);
+         rebuildBuckets(mBuckets.empty() ? kInitialBucketsCount : mBuckets.size() * 2u);
       }
-
-      Value* value = nullptr;
-
-      if(pExtendSearchToParent && mParent)
+      else
       {
-         value = mParent->getVariable(pIdentifier, true);
+         linkInstance((uint32_t)(mInstances.size() - 1u));
       }
-
-      return value;
    }
 
-   Value* value = mInstancesHolder.getVariable(pIdentifier);
-
-   if(!value && pExtendSearchToParent && mParent)
-   {
-      value = mParent->getVariable(pIdentifier, true);
-   }
+   return &mInstances.back();
+}
 
-   return value;
+Instance* InstancesHolder::retrieveInstance(const Identifier& pIdentifier)
+{
+   size_t index = 0u;
+   return retrieveInstance(pIdentifier, &index);
 }
 
-Instance* Namespace::registerInstance(const TypeUsage& pTypeUsage, const Identifier& pIdentifier)
+Instance* InstancesHolder::retrieveInstance(const Identifier& pIdentifier, size_t* pOutIndex)
 {
-   const char* lastSeparator = pIdentifier.findLastSeparator();
+   if(mBuckets.empty() || pIdentifier.mHash == 0u)
+   {
+      return nullptr;
+   }
 
-   if(lastSeparator)
+   uint32_t index = *getBucket(pIdentifier.mHash);
+
+   while(index != kInvalidIndex)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier instanceIdentifier(lastSeparator + 2);
+      if(mInstances[index].mIdentifier == pIdentifier)
+      {
+         *pOutIndex = (size_t)index;
+         return &mInstances[index];
+      }
 
-      Namespace* ns = requestNamespace(nsIdentifier);
-      return ns->registerInstance(pTypeUsage, instanceIdentifier);
+      index = mPreviousInBucket[index];
    }
 
-   return mInstancesHolder.registerInstance(pTypeUsage, pIdentifier);
+   return nullptr;
 }
 
-Instance* Namespace::retrieveInstance(const Identifier& pIdentifier, bool pExtendSearchToParent)
+void InstancesHolder::setInstanceIdentifier(size_t pIndex, const Identifier& pIdentifier)
 {
-   const char* lastSeparator = pIdentifier.findLastSeparator();
+   CflatAssert(pIndex < mInstances.size());
+   CflatAssert(mInstances[pIndex].mIdentifier.mHash == 0u);
 
-   if(lastSeparator)
+   mInstances[pIndex].mIdentifier = pIdentifier;
+
+   if(pIdentifier.mHash != 0u)
    {
-      char buffer[kDefaultLocalStringBufferSize];
-      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
-      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
-      buffer[nsIdentifierLength] = '\0';
-      const Identifier nsIdentifier(buffer);
-      const Identifier instanceIdentifier(lastSeparator + 2);
+      if(mBuckets.empty())
+      {
+         rebuildBuckets(kInitialBucketsCount);
+      }
+      else
+      {
+         linkInstance((uint32_t)pIndex);
+      }
+   }
+}
 
-      Namespace* ns = getNamespace(nsIdentifier);
+void InstancesHolder::releaseInstances(uint32_t pScopeLevel, bool pExecuteDestructors)
+{
+   while(!mInstances.empty() && mInstances.back().mScopeLevel >= pScopeLevel)
+   {
+      Instance& instance = mInstances.back();
 
-      if(ns)
+      if(pExecuteDestructors)
       {
-         return ns->retrieveInstance(instanceIdentifier);
-      }
+         Type* instanceType = instance.mTypeUsage.mType;
 
-      Instance* instance = nullptr;
+         if(instanceType->mCategory == TypeCategory::StructOrClass &&
+            !instance.mTypeUsage.isPointer() &&
+            !instance.mTypeUsage.isReference())
+         {
+            Method* dtor = static_cast<Struct*>(instanceType)->getDestructor();
 
-      if(pExtendSearchToParent && mParent)
+            if(dtor)
+            {
+               TypeUsage thisPtrTypeUsage;
+               thisPtrTypeUsage.mType = instanceType;
+               thisPtrTypeUsage.mPointerLevel = 1u;
+
+               Value thisPtrValue;
+               thisPtrValue.initExternal(thisPtrTypeUsage);
+               thisPtrValue.set(&instance.mValue.mValueBuffer);
+
+               CflatArgsVector(Value) args;
+               dtor->execute(thisPtrValue, args, nullptr);
+            }
+         }
+      }
+
+      // the last instance is always the last one registered in its bucket
+      if(instance.mIdentifier.mHash != 0u)
       {
-         instance = mParent->retrieveInstance(pIdentifier, true);
+         uint32_t* bucket = getBucket(instance.mIdentifier.mHash);
+         CflatAssert(*bucket == (uint32_t)(mInstances.size() - 1u));
+         *bucket = mPreviousInBucket.back();
       }
 
-      return instance;
+      mInstances.pop_back();
+      mPreviousInBucket.pop_back();
    }
+}
 
-   Instance* instance = mInstancesHolder.retrieveInstance(pIdentifier);
+uint32_t* InstancesHolder::getBucket(Hash pHash)
+{
+   CflatAssert(!mBuckets.empty());
+   return &mBuckets[pHash & (Hash)(mBuckets.size() - 1u)];
+}
 
-   if(!instance && pExtendSearchToParent && mParent)
+void InstancesHolder::linkInstance(uint32_t pIndex)
+{
+   uint32_t* bucket = getBucket(mInstances[pIndex].mIdentifier.mHash);
+
+   // keep the bucket sorted from the last registered instance to the first one, so the first match
+   // found is always the innermost one (renamed instances might not be the last ones)
+   while(*bucket != kInvalidIndex && *bucket > pIndex)
    {
-      instance = mParent->retrieveInstance(pIdentifier, true);
+      bucket = &mPreviousInBucket[*bucket];
    }
 
-   return instance;
+   mPreviousInBucket[pIndex] = *bucket;
+   *bucket = pIndex;
 }
 
-void Namespace::releaseInstances(uint32_t pScopeLevel, bool pExecuteDestructors)
+void InstancesHolder::rebuildBuckets(size_t pBucketsCount)
 {
-   mInstancesHolder.releaseInstances(pScopeLevel, pExecuteDestructors);
+   mBuckets.assign(pBucketsCount, kInvalidIndex);
 
-   for(NamespacesRegistry::iterator it = mNamespaces.begin(); it != mNamespaces.end(); it++)
+   for(size_t i = 0u; i < mInstances.size(); i++)
    {
-      Namespace* ns = it->second;
-      ns->releaseInstances(pScopeLevel, pExecuteDestructors);
+      mPreviousInBucket[i] = kInvalidIndex;
+
+      if(mInstances[i].mIdentifier.mHash != 0u)
+      {
+         linkInstance((uint32_t)i);
+      }
    }
 }
 
-void Namespace::getAllNamespaces(CflatSTLVector(Namespace*)* pOutNamespaces)
+size_t InstancesHolder::getInstancesCount() const
 {
-   for(NamespacesRegistry::const_iterator it = mNamespaces.begin(); it != mNamespaces.end(); it++)
-   {
-      pOutNamespaces->push_back(it->second);
-   }
+   return mInstances.size();
 }
 
-void Namespace::getAllInstances(CflatSTLVector(Instance*)* pOutInstances)
+Instance* InstancesHolder::getInstance(size_t pIndex)
 {
-   mInstancesHolder.getAllInstances(pOutInstances);
+   CflatAssert(pIndex < mInstances.size());
+   return &mInstances[pIndex];
 }
 
-void Namespace::getAllFunctions(CflatSTLVector(Function*)* pOutFunctions)
+void InstancesHolder::getAllInstances(CflatSTLVector(Instance*)* pOutInstances)
 {
-   mFunctionsHolder.getAllFunctions(pOutFunctions);
+   for(size_t i = 0u; i < mInstances.size(); i++)
+   {
+      pOutInstances->push_back(&mInstances[i]);
+   }
 }
 
 
 //
-//  Context
+//  BuiltInType
 //
-Context::Context(ContextType pType, Namespace* pGlobalNamespace)
-   : mType(pType)
-   , mProgram(nullptr)
-   , mBlockLevel(0u)
-   , mScopeLevel(0u)
+BuiltInType::BuiltInType(Namespace* pNamespace, const Identifier& pIdentifier)
+   : Type(pNamespace, pIdentifier)
 {
-   mNamespaceStack.push_back(pGlobalNamespace);
+   mCategory = TypeCategory::BuiltIn;
 }
 
 
 //
-//  ParsingContext
+//  Enum
 //
-ParsingContext::ParsingContext(Namespace* pGlobalNamespace)
-   : Context(ContextType::Parsing, pGlobalNamespace)
-   , mTokenIndex(0u)
-   , mLocalNamespaceGlobalIndex(0u)
+Enum::Enum(Namespace* pNamespace, const Identifier& pIdentifier)
+   : Type(pNamespace, pIdentifier)
 {
+   mCategory = TypeCategory::Enum;
 }
 
 
 //
-//  CallStackEntry
+//  EnumClass
 //
-CallStackEntry::CallStackEntry(const Program* pProgram, const Function* pFunction)
-   : mProgram(pProgram)
-   , mFunction(pFunction)
-   , mLine(0u)
+EnumClass::EnumClass(Namespace* pNamespace, const Identifier& pIdentifier)
+   : Type(pNamespace, pIdentifier)
 {
+   mCategory = TypeCategory::EnumClass;
 }
 
 
 //
-//  ExecutionContext
+//  Struct
 //
-ExecutionContext::ExecutionContext(Namespace* pGlobalNamespace)
-   : Context(ContextType::Execution, pGlobalNamespace)
-   , mJumpStatement(JumpStatement::None)
+Struct::Struct(Namespace* pNamespace, const Identifier& pIdentifier)
+   : Type(pNamespace, pIdentifier)
+   , mDefaultConstructorIndex(SIZE_MAX)
+   , mDestructorIndex(SIZE_MAX)
+   , mCopyAssignmentOperatorIndex(SIZE_MAX)
+   , mSpecialMethodsLookupMethodsCount(0u)
+   , mContiguousData(nullptr)
+   , mContiguousSize(nullptr)
 {
+   mCategory = TypeCategory::StructOrClass;
 }
 
-
-//
-//  Environment
-//
-Environment::Environment()
-   : mTypesParsingContext(&mGlobalNamespace)
-   , mExecutionContext(&mGlobalNamespace)
-   , mGlobalNamespace("", nullptr, this)
-   , mExecutionHook(nullptr)
+Hash Struct::getHash() const
 {
-   static_assert(kPreprocessorErrorStringsCount == (size_t)Environment::PreprocessorError::Count,
-      "Missing preprocessor error strings");
-   static_assert(kCompileErrorStringsCount == (size_t)Environment::CompileError::Count,
-      "Missing compile error strings");
-   static_assert(kRuntimeErrorStringsCount == (size_t)Environment::RuntimeError::Count,
-      "Missing runtime error strings");
+   Hash hash = mIdentifier.mHash;
 
-   registerBuiltInTypes();
+   for(size_t i = 0u; i < mTemplateTypes.size(); i++)
+   {
+      hash += mTemplateTypes[i].mType->getHash();
+      hash += (Hash)mTemplateTypes[i].mPointerLevel;
+   }
 
-   mTypeAuto = registerType<BuiltInType>("auto");
-   mTypeVoid = registerType<BuiltInType>("void");
-   mTypeInt32 = getType("int");
-   mTypeUInt32 = getType("uint32_t");
-   mTypeFloat = getType("float");
-   mTypeDouble = getType("double");
+   return hash;
+}
 
-   mTypeUsageSizeT = getTypeUsage("size_t");
-   mTypeUsageBool = getTypeUsage("bool");
-   mTypeUsageCString = getTypeUsage("const char*");
-   mTypeUsageVoidPtr = getTypeUsage("void*");
+bool Struct::derivedFrom(Type* pBaseType) const
+{
+   for(size_t i = 0u; i < mBaseTypes.size(); i++)
+   {
+      if(mBaseTypes[i].mType == pBaseType)
+         return true;
+   }
+
+   return false;
 }
 
-Environment::~Environment()
+uint16_t Struct::getOffset(Type* pBaseType) const
 {
-   for(ProgramsRegistry::iterator it = mPrograms.begin(); it != mPrograms.end(); it++)
+   for(size_t i = 0u; i < mBaseTypes.size(); i++)
    {
-      CflatInvokeDtor(Program, it->second);
-      CflatFree(it->second);
+      if(mBaseTypes[i].mType == pBaseType)
+         return mBaseTypes[i].mOffset;
    }
+
+   return 0u;
 }
 
-void Environment::defineMacro(const char* pDefinition, const char* pBody)
+Method* Struct::getDefaultConstructor()
 {
-   Macro macro;
+   lookUpSpecialMethods();
+   return mDefaultConstructorIndex != SIZE_MAX ? &mMethods[mDefaultConstructorIndex] : nullptr;
+}
 
-   // process definition
-   const size_t definitionLength = strlen(pDefinition);
+Method* Struct::getDestructor()
+{
+   lookUpSpecialMethods();
+   return mDestructorIndex != SIZE_MAX ? &mMethods[mDestructorIndex] : nullptr;
+}
 
-   CflatSTLVector(CflatSTLString) parameters;
-   int8_t currentParameterIndex = -1;
+Method* Struct::getCopyAssignmentOperator()
+{
+   lookUpSpecialMethods();
+   return mCopyAssignmentOperatorIndex != SIZE_MAX ? &mMethods[mCopyAssignmentOperatorIndex] : nullptr;
+}
 
-   for(size_t i = 0u; i < definitionLength; i++)
+void Struct::lookUpSpecialMethods()
+{
+   if(mSpecialMethodsLookupMethodsCount == mMethods.size())
+      return;
+
+   mDefaultConstructorIndex = SIZE_MAX;
+   mDestructorIndex = SIZE_MAX;
+   mCopyAssignmentOperatorIndex = SIZE_MAX;
+   mSpecialMethodsLookupMethodsCount = mMethods.size();
+
+   for(size_t i = 0u; i < mMethods.size(); i++)
    {
-      char currentChar = pDefinition[i];
+      const Method& method = mMethods[i];
 
-      if(currentChar == '(' || currentChar == ',')
-      {
-         currentParameterIndex++;
-         parameters.emplace_back();
-         continue;
-      }
-      else if(currentChar == ')')
+      if(method.mIdentifier.mHash == 0u)
       {
-         break;
+         if(method.mParameters.empty() && mDefaultConstructorIndex == SIZE_MAX)
+         {
+            mDefaultConstructorIndex = i;
+         }
       }
-
-      if(currentParameterIndex < 0)
+      else if(method.mIdentifier.mName[0] == '~')
       {
-         macro.mName.push_back(currentChar);
+         if(mDestructorIndex == SIZE_MAX)
+         {
+            mDestructorIndex = i;
+         }
       }
-      else
+      else if(strcmp(method.mIdentifier.mName, "operator=") == 0)
       {
-         parameters[currentParameterIndex].push_back(currentChar);
+         if(method.mParameters.size() == 1u &&
+            method.mParameters[0].mType == this &&
+            !method.mParameters[0].isPointer() &&
+            mCopyAssignmentOperatorIndex == SIZE_MAX)
+         {
+            mCopyAssignmentOperatorIndex = i;
+         }
       }
    }
+}
 
-   macro.mParametersCount = (uint8_t)(currentParameterIndex + 1);
-
-   // process body
-   const size_t bodyLength = strlen(pBody);
+Type* Struct::getType(const Identifier& pIdentifier)
+{
+   return mTypesHolder.getType(pIdentifier);
+}
 
-   if(bodyLength > 0u)
-   {
-      int bodyChunkIndex = -1;
+Type* Struct::getType(const Identifier& pIdentifier, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   return mTypesHolder.getType(pIdentifier, pTemplateTypes);
+}
 
-      for(size_t i = 0u; i < bodyLength; i++)
-      {
-         char currentChar = pBody[i];
-         bool anyParameterProcessed = false;
-
-         for(uint8_t j = 0u; j < macro.mParametersCount; j++)
-         {
-            if(strncmp(pBody + i, parameters[j].c_str(), parameters[j].length()) == 0)
-            {
-               MacroArgumentType argumentType = MacroArgumentType::Default;
-
-               if(i >= 2u && pBody[i - 1u] == '#' && pBody[i - 2u] == '#')
-               {
-                  argumentType = MacroArgumentType::TokenPaste;
-               }
-               else if(i >= 1u && pBody[i - 1u] == '#')
-               {
-                  argumentType = MacroArgumentType::Stringize;
-               }
-
-               macro.mBody.emplace_back();
-               bodyChunkIndex++;
-
-               // argument char ('$')
-               macro.mBody[bodyChunkIndex].push_back('$');
-               // parameter index (1, 2, 3, etc.)
-               macro.mBody[bodyChunkIndex].push_back((char)('1' + (char)j));
-               // argument type (0: Default, 1: Stringize, 2: TokenPaste)
-               macro.mBody[bodyChunkIndex].push_back((char)('0' + (char)argumentType));
+void Struct::registerTypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
+{
+   mTypesHolder.registerTypeAlias(pIdentifier, pTypeUsage);
+}
 
-               i += parameters[j].length() - 1u;
+const TypeAlias* Struct::getTypeAlias(const Identifier& pIdentifier)
+{
+   return mTypesHolder.getTypeAlias(pIdentifier);
+}
 
-               anyParameterProcessed = true;
-               break;
-            }
-         }
+Function* Struct::registerStaticMethod(const Identifier& pIdentifier)
+{
+   return mFunctionsHolder.registerFunction(pIdentifier);
+}
 
-         if(!anyParameterProcessed && currentChar != '#')
-         {
-            if(macro.mBody.empty() || macro.mBody[macro.mBody.size() - 1u][0] == '$')
-            {
-               macro.mBody.emplace_back();
-               bodyChunkIndex++;
-            }
+Function* Struct::getStaticMethod(const Identifier& pIdentifier)
+{
+   return mFunctionsHolder.getFunction(pIdentifier);
+}
 
-            macro.mBody[bodyChunkIndex].push_back(currentChar);
-         }
-      }
-   }
+Function* Struct::getStaticMethod(const Identifier& pIdentifier,
+   const CflatArgsVector(TypeUsage)& pParameterTypes,
+   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   return mFunctionsHolder.getFunction(pIdentifier, pParameterTypes, pTemplateTypes);
+}
 
-   // register macro in the environment
-   bool newEntryRequired = true;
+Function* Struct::getStaticMethod(const Identifier& pIdentifier,
+   const CflatArgsVector(Value)& pArguments,
+   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   return mFunctionsHolder.getFunction(pIdentifier, pArguments, pTemplateTypes);
+}
 
-   for(size_t i = 0u; i < mMacros.size(); i++)
-   {
-      if(mMacros[i].mName == macro.mName)
-      {
-         mMacros[i].mBody = macro.mBody;
-         mMacros[i].mParametersCount = macro.mParametersCount;
-         newEntryRequired = false;
-         break;
-      }
-   }
+CflatSTLVector(Function*)* Struct::getStaticMethods(const Identifier& pIdentifier)
+{
+   return mFunctionsHolder.getFunctions(pIdentifier);
+}
 
-   if(newEntryRequired)
-   {
-      mMacros.push_back(macro);
-   }
+void Struct::setStaticMember(const TypeUsage& pTypeUsage, const Identifier& pIdentifier,
+   const Value& pValue)
+{
+   mInstancesHolder.setVariable(pTypeUsage, pIdentifier, pValue);
 }
 
-void Environment::registerBuiltInTypes()
+Value* Struct::getStaticMember(const Identifier& pIdentifier)
 {
-   CflatRegisterBuiltInType(this, int);
-   CflatRegisterBuiltInType(this, int32_t);
-   CflatRegisterBuiltInType(this, uint32_t);
-   CflatRegisterBuiltInType(this, size_t);
-   CflatRegisterBuiltInType(this, char);
-   CflatRegisterBuiltInType(this, bool);
-   CflatRegisterBuiltInType(this, int8_t);
-   CflatRegisterBuiltInType(this, uint8_t);
-   CflatRegisterBuiltInType(this, short);
-   CflatRegisterBuiltInType(this, int16_t);
-   CflatRegisterBuiltInType(this, uint16_t);
-   CflatRegisterBuiltInType(this, int64_t);
-   CflatRegisterBuiltInType(this, uint64_t);
-   CflatRegisterBuiltInType(this, float);
-   CflatRegisterBuiltInType(this, double);
+   return mInstancesHolder.getVariable(pIdentifier);
 }
 
-TypeUsage Environment::parseTypeUsage(ParsingContext& pContext, size_t pTokenLastIndex)
+Instance* Struct::getStaticMemberInstance(const Identifier& pIdentifier)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   size_t cachedTokenIndex = tokenIndex;
+   return mInstancesHolder.retrieveInstance(pIdentifier);
+}
 
-   TypeUsage typeUsage;
-   char baseTypeName[kDefaultLocalStringBufferSize];
 
-   if(tokens[tokenIndex].mType == TokenType::Keyword &&
-      strncmp(tokens[tokenIndex].mStart, "const", 5u) == 0)
-   {
-      CflatSetFlag(typeUsage.mFlags, TypeUsageFlags::Const);
-      tokenIndex++;
-   }
+//
+//  Class
+//
+Class::Class(Namespace* pNamespace, const Identifier& pIdentifier)
+   : Struct(pNamespace, pIdentifier)
+{
+}
 
-   pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
 
-   while(tokenIndex < (tokens.size() - 1u) &&
-      tokens[tokenIndex + 1u].mLength == 2u &&
-      strncmp(tokens[tokenIndex + 1u].mStart, "::", 2u) == 0)
+//
+//  TypeHelper
+//
+TypeHelper::Compatibility TypeHelper::getCompatibility(
+   const TypeUsage& pParameter, const TypeUsage& pArgument)
+{
+   if(pParameter == pArgument)
    {
-      tokenIndex += 2u;
-      pContext.mStringBuffer.append("::");
-      pContext.mStringBuffer.append(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+      return Compatibility::PerfectMatch;
    }
 
-   strcpy(baseTypeName, pContext.mStringBuffer.c_str());
-   const Identifier baseTypeIdentifier(baseTypeName);
-   CflatArgsVector(TypeUsage) templateTypes;
-
-   if(tokenIndex < (tokens.size() - 1u) && tokens[tokenIndex + 1u].mStart[0] == '<')
-   {
-      tokenIndex += 2u;
-      const size_t closureTokenIndex = findClosureTokenIndex(pContext, '<', '>');
-
-      if((pTokenLastIndex == 0u || closureTokenIndex <= pTokenLastIndex) &&
-         isTemplate(pContext, tokenIndex - 1u, closureTokenIndex))
-      {
-         while(tokenIndex < closureTokenIndex)
-         {
-            templateTypes.push_back(parseTypeUsage(pContext, closureTokenIndex - 1u));
-            tokenIndex++;
-         }
-
-         tokenIndex = closureTokenIndex;
-      }
-   }
-   
-   for(size_t i = 0u; i < pContext.mTypeAliases.size(); i++)
+   if(pParameter.mType == pArgument.mType &&
+      pParameter.mPointerLevel == pArgument.mPointerLevel &&
+      pParameter.getSize() == pArgument.getSize())
    {
-      if(pContext.mTypeAliases[i].mIdentifier == baseTypeIdentifier)
-      {
-         typeUsage = pContext.mTypeAliases[i].mTypeUsage;
-         break;
-      }
+      return Compatibility::PerfectMatch;
    }
 
-   if(!typeUsage.mType)
+   if(pArgument.compatibleWith(pParameter))
    {
-      for(int i = (int)pContext.mLocalNamespaceStack.size() - 1; i >= 0; i--)
-      {
-         Namespace* ns = pContext.mLocalNamespaceStack[i].mNamespace;
-         typeUsage.mType = ns->getType(baseTypeIdentifier, templateTypes);
-
-         if(typeUsage.mType)
-         {
-            break;
-         }
-      }
+      return Compatibility::ImplicitCastableInteger;
    }
 
-   if(!typeUsage.mType)
+   if(pArgument.mType->mCategory == TypeCategory::BuiltIn &&
+      !pArgument.isPointer() &&
+      !pArgument.isReference() &&
+      pParameter.mType->mCategory == TypeCategory::BuiltIn &&
+      !pParameter.isPointer() &&
+      !pParameter.isReference())
    {
-      for(int i = (int)pContext.mNamespaceStack.size() - 1; i >= 0; i--)
+      if(pArgument.mType->isDecimal() && pParameter.mType->isDecimal())
       {
-         Namespace* ns = pContext.mNamespaceStack[i];
-         const TypeAlias* typeAlias = ns->getTypeAlias(baseTypeIdentifier);
-
-         if(typeAlias)
-         {
-            typeUsage = typeAlias->mTypeUsage;
-            break;
-         }
+         return Compatibility::ImplicitCastableFloat;
       }
 
-      if(!typeUsage.mType)
-      {
-         typeUsage.mType = findType(pContext, baseTypeIdentifier, templateTypes);
-      }
+      return Compatibility::ImplicitCastableIntegerFloat;
    }
 
-   if(typeUsage.mType)
+   if(pArgument.mType->mCategory == TypeCategory::StructOrClass &&
+      pArgument.isPointer() &&
+      pParameter.mType->mCategory == TypeCategory::StructOrClass &&
+      pParameter.isPointer())
    {
-      if(tokenIndex < (tokens.size() - 1u) && *tokens[tokenIndex + 1u].mStart == '&')
-      {
-         CflatSetFlag(typeUsage.mFlags, TypeUsageFlags::Reference);
-         tokenIndex++;
-      }
+      Struct* argumentType = static_cast<Struct*>(pArgument.mType);
+      Struct* parameterType = static_cast<Struct*>(pParameter.mType);
 
-      while(tokenIndex < (tokens.size() - 1u) && *tokens[tokenIndex + 1u].mStart == '*')
+      if(argumentType->derivedFrom(parameterType))
       {
-         typeUsage.mPointerLevel++;
-         tokenIndex++;
+         return Compatibility::ImplicitCastableInheritance;
       }
-
-      tokenIndex++;
-   }
-   else
-   {
-      tokenIndex = cachedTokenIndex;
    }
 
-   return typeUsage;
+   return Compatibility::Incompatible;
 }
 
-void Environment::throwPreprocessorError(ParsingContext& pContext, PreprocessorError pError,
-   size_t pCursor, const char* pArg)
-{
-   char errorMsg[kDefaultLocalStringBufferSize];
-   sprintf(errorMsg, kPreprocessorErrorStrings[(int)pError], pArg);
-
-   const char* code = pContext.mProgram->mCode.c_str();
-   uint16_t line = 1u;
 
-   for(size_t i = 0u; i < pCursor; i++)
-   {
-      if(code[i] == '\n')
-      {
-         line++;
-      }
-   }
+//
+//  Tokenizer
+//
+const char* kCflatPunctuation[] =
+{
+   ".", ",", ":", ";", "->", "(", ")", "{", "}", "[", "]", "::"
+};
+const size_t kCflatPunctuationCount = sizeof(kCflatPunctuation) / sizeof(const char*);
 
-   char lineAsString[16];
-   sprintf(lineAsString, "%d", line);
-
-   mErrorMessage.assign("[Preprocessor Error] '");
-   mErrorMessage.append(pContext.mProgram->mIdentifier.mName);
-   mErrorMessage.append("' -- Line ");
-   mErrorMessage.append(lineAsString);
-   mErrorMessage.append(": ");
-   mErrorMessage.append(errorMsg);
-}
+const char* kCflatOperators[] =
+{
+   "+", "-", "*", "/", "%",
+   "++", "--", "!",
+   "=", "+=", "-=", "*=", "/=", "&=", "|=",
+   "<<", ">>",
+   "==", "!=", ">", "<", ">=", "<=",
+   "&&", "||", "&", "|", "~", "^"
+};
+const size_t kCflatOperatorsCount = sizeof(kCflatOperators) / sizeof(const char*);
 
-void Environment::throwCompileError(ParsingContext& pContext, CompileError pError,
-   const char* pArg1, const char* pArg2)
+const char* kCflatAssignmentOperators[] =
 {
-   if(!mErrorMessage.empty())
-      return;
+   "=", "+=", "-=", "*=", "/=", "&=", "|="
+};
+const size_t kCflatAssignmentOperatorsCount = sizeof(kCflatAssignmentOperators) / sizeof(const char*);
 
-   const Token& token = pContext.mTokenIndex < pContext.mTokens.size()
-      ? pContext.mTokens[pContext.mTokenIndex]
-      : pContext.mTokens[pContext.mTokens.size() - 1u];
+const char* kCflatConditionalOperator = "?";
 
-   char errorMsg[kDefaultLocalStringBufferSize];
-   sprintf(errorMsg, kCompileErrorStrings[(int)pError], pArg1, pArg2);
+// brackets matched after tokenizing ('<' and '>' as well, since they can enclose template types)
+const char kOpeningBrackets[] = { '(', '[', '{', '<' };
+const char kClosureBrackets[] = { ')', ']', '}', '>' };
+const size_t kBracketKindsCount = sizeof(kOpeningBrackets) / sizeof(char);
+const uint32_t kNoMatchingTokenIndex = UINT32_MAX;
 
-   char lineAsString[16];
-   sprintf(lineAsString, "%d", token.mLine);
+static bool isBracketPair(char pOpeningChar, char pClosureChar)
+{
+   for(size_t i = 0u; i < kBracketKindsCount; i++)
+   {
+      if(pOpeningChar == kOpeningBrackets[i])
+      {
+         return pClosureChar == kClosureBrackets[i];
+      }
+   }
 
-   mErrorMessage.assign("[Compile Error] '");
-   mErrorMessage.append(pContext.mProgram->mIdentifier.mName);
-   mErrorMessage.append("' -- Line ");
-   mErrorMessage.append(lineAsString);
-   mErrorMessage.append(": ");
-   mErrorMessage.append(errorMsg);
+   return false;
 }
 
-void Environment::throwCompileErrorUnexpectedSymbol(ParsingContext& pContext)
+const char* kCflatBinaryOperators[] =
 {
-   const Token& token = pContext.mTokens[pContext.mTokenIndex];
-   pContext.mStringBuffer.assign(token.mStart, token.mLength);
-   throwCompileError(pContext, CompileError::UnexpectedSymbol, pContext.mStringBuffer.c_str());
-}
-
-void Environment::preprocess(ParsingContext& pContext, const char* pCode)
+   "*", "/", "%",
+   "+", "-",
+   "<<", ">>",
+   "<", "<=", ">", ">=",
+   "==", "!=",
+   "&",
+   "^",
+   "|",
+   "&&",
+   "||"
+};
+const uint8_t kCflatBinaryOperatorsPrecedence[] =
 {
-   CflatSTLString& preprocessedCode = pContext.mPreprocessedCode;
-
-   const size_t codeLength = strlen(pCode);
-   preprocessedCode.clear();
+   1u, 1u, 1u,
+   2u, 2u,
+   3u, 3u,
+   4u, 4u, 4u, 4u,
+   5u, 5u,
+   6u,
+   7u,
+   8u,
+   9u,
+   10u
+};
+const size_t kCflatBinaryOperatorsCount = sizeof(kCflatBinaryOperators) / sizeof(const char*);
+static_assert
+(
+   kCflatBinaryOperatorsCount == (sizeof(kCflatBinaryOperatorsPrecedence) / sizeof(uint8_t)),
+   "Precedence must be defined for all binary operators"
+);
 
-   size_t cursor = 0u;
+const char* kCflatKeywords[] =
+{
+   "break", "case", "class", "const", "const_cast", "continue", "default",
+   "delete", "do", "dynamic_cast", "else", "enum", "false", "for", "if",
+   "namespace", "new", "nullptr", "operator", "private", "protected", "public",
+   "reinterpret_cast", "return", "sizeof", "static", "static_cast",
+   "struct", "switch", "this", "true", "typedef", "union", "unsigned",
+   "using", "virtual", "void", "while"
+};
+const size_t kCflatKeywordsCount = sizeof(kCflatKeywords) / sizeof(const char*);
 
-   while(cursor < codeLength)
+bool Tokenizer::skipBlanks(const char*& pCursor, uint16_t& pLine)
+{
+   while(true)
    {
-      // line comment
-      if(strncmp(pCode + cursor, "//", 2u) == 0)
+      if(*pCursor == ' ' || *pCursor == '\t' || *pCursor == '\r')
       {
-         while(pCode[cursor] != '\n' && pCode[cursor] != '\0')
-         {
-            cursor++;
-         }
+         pCursor++;
       }
-      // block comment
-      else if(strncmp(pCode + cursor, "/*", 2u) == 0)
+      else if(*pCursor == '\n')
       {
-         while(strncmp(pCode + cursor, "*/", 2u) != 0)
-         {
-            cursor++;
-
-            if(pCode[cursor] == '\n')
-            {
-               preprocessedCode.push_back('\n');
-            }
-         }
-
-         cursor += 2u;
-         continue;
+         pLine++;
+         pCursor++;
       }
-      // preprocessor directive
-      else if(pCode[cursor] == '#')
+      else if(pCursor[0] == '/' && pCursor[1] == '/')
       {
-         cursor++;
-
-         while(pCode[cursor] == ' ' || pCode[cursor] == '\t')
+         while(*pCursor != '\n' && *pCursor != '\0')
          {
-            cursor++;
+            pCursor++;
          }
+      }
+      else if(pCursor[0] == '/' && pCursor[1] == '*')
+      {
+         pCursor += 2u;
 
-         // #include (valid, but ignored)
-         if(strncmp(pCode + cursor, "include", 7u) == 0)
-         {
-            cursor += 7u;
-         }
-         // #ifdef (valid, but ignored)
-         else if(strncmp(pCode + cursor, "ifdef", 5u) == 0)
-         {
-            cursor += 5u;
-         }
-         // #if (valid, but ignored)
-         else if(strncmp(pCode + cursor, "if", 2u) == 0)
-         {
-            cursor += 2u;
-         }
-         // #pragma (valid, but ignored)
-         else if(strncmp(pCode + cursor, "pragma", 6u) == 0)
-         {
-            cursor += 6u;
-         }
-         // #define
-         else if(strncmp(pCode + cursor, "define", 6u) == 0)
+         while(*pCursor != '\0' && !(pCursor[0] == '*' && pCursor[1] == '/'))
          {
-            cursor += 6u;
-
-            if(pCode[cursor] != ' ' && pCode[cursor] != '\t')
-            {
-               throwPreprocessorError(pContext, PreprocessorError::InvalidPreprocessorDirective,
-                  cursor);
-               return;
-            }
-
-            while(pCode[cursor] == ' ' || pCode[cursor] == '\t')
-            {
-               cursor++;
-            }
-
-            if(pCode[cursor] == '\n' || pCode[cursor] == '\0')
+            if(*pCursor == '\n')
             {
-               throwPreprocessorError(pContext, PreprocessorError::InvalidPreprocessorDirective,
-                  cursor);
-               return;
+               pLine++;
             }
 
-            char macroDefinition[kDefaultLocalStringBufferSize];
-            size_t macroCursor = 0u;
+            pCursor++;
+         }
 
-            while(pCode[cursor] != ' ' &&
-               pCode[cursor] != '\t' &&
-               pCode[cursor] != '\n' &&
-               pCode[cursor] != '\0')
-            {
-               macroDefinition[macroCursor++] = pCode[cursor++];
-            }
+         if(*pCursor != '\0')
+         {
+            pCursor += 2u;
+         }
+      }
+      else
+      {
+         break;
+      }
+   }
 
-            macroDefinition[macroCursor] = '\0';
+   return *pCursor != '\0';
+}
 
-            while(pCode[cursor] == ' ' || pCode[cursor] == '\t')
-            {
-               cursor++;
-            }
+Token Tokenizer::readToken(const char*& pCursor, uint16_t pLine)
+{
+   Token token;
+   token.mStart = pCursor;
+   token.mLength = 1u;
+   token.mLine = pLine;
 
-            char macroBody[kDefaultLocalStringBufferSize];
-            macroCursor = 0u;
+   // string
+   if(*pCursor == '"')
+   {
+      do
+      {
+         pCursor++;
+      }
+      while(!(*pCursor == '"' && *(pCursor - 1) != '\\'));
 
-            while(pCode[cursor] != '\n' && pCode[cursor] != '\0')
-            {
-               macroBody[macroCursor++] = pCode[cursor++];
-            }
+      pCursor++;
+      token.mLength = pCursor - token.mStart;
+      token.mType = TokenType::String;
+      return token;
+   }
 
-            macroBody[macroCursor] = '\0';
+   // numeric value
+   if(isdigit(*pCursor) || (*pCursor == '.' && isdigit(*(pCursor + 1))))
+   {
+      if(*pCursor == '0' && *(pCursor + 1) == 'x')
+      {
+         pCursor++;
 
-            defineMacro(macroDefinition, macroBody);
-         }
-         else
+         do
          {
-            throwPreprocessorError(pContext, PreprocessorError::InvalidPreprocessorDirective,
-               cursor);
-            return;
+            pCursor++;
          }
-
-         while(pCode[cursor] != '\n' && pCode[cursor] != '\0')
+         while(isxdigit(*pCursor));
+      }
+      else
+      {
+         do
          {
-            cursor++;
+            pCursor++;
          }
+         while(isdigit(*pCursor) || *pCursor == '.' || *pCursor == 'f' || *pCursor == 'u');
       }
 
-      // skip carriage return characters
-      while(pCode[cursor] == '\r')
+      token.mLength = pCursor - token.mStart;
+      token.mType = TokenType::Number;
+      return token;
+   }
+
+   // punctuation (2 characters)
+   for(size_t i = 0u; i < kCflatPunctuationCount; i++)
+   {
+      if(kCflatPunctuation[i][1] != '\0' && strncmp(token.mStart, kCflatPunctuation[i], 2u) == 0)
       {
-         cursor++;
+         pCursor += 2u;
+         token.mLength = pCursor - token.mStart;
+         token.mType = TokenType::Punctuation;
+         return token;
       }
+   }
 
-      // perform macro replacement
-      for(size_t i = 0u; i < mMacros.size(); i++)
+   // operator (2 characters)
+   for(size_t i = 0u; i < kCflatOperatorsCount; i++)
+   {
+      if(kCflatOperators[i][1] != '\0' && strncmp(token.mStart, kCflatOperators[i], 2u) == 0)
       {
-         Macro& macro = mMacros[i];
-
-         if(strncmp(pCode + cursor, macro.mName.c_str(), macro.mName.length()) == 0)
-         {
-            cursor += macro.mName.length();
-
-            // parse arguments
-            CflatSTLVector(CflatSTLString) arguments;
-
-            if(pCode[cursor] == '(')
-            {
-               arguments.emplace_back();
-               cursor++;
-
-               while(pCode[cursor] != ')')
-               {
-                  if(pCode[cursor] == ',')
-                  {
-                     arguments.emplace_back();
-                     cursor++;
-
-                     while(pCode[cursor++] == ' ');
-                  }
-                  else
-                  {
-                     arguments[arguments.size() - 1u].push_back(pCode[cursor]);
-                     cursor++;
-                  }
-               }
-            }
-
-            // append the replaced strings
-            for(size_t j = 0u; j < macro.mBody.size(); j++)
-            {
-               const CflatSTLString& bodyChunk = macro.mBody[j];
-
-               if(bodyChunk[0] == '$')
-               {
-                  const size_t parameterIndex = (size_t)(bodyChunk[1] - '1');
-
-                  if(parameterIndex >= arguments.size())
-                  {
-                     throwPreprocessorError(pContext, PreprocessorError::InvalidMacroArgumentCount,
-                        cursor, macro.mName.c_str());
-                     return;
-                  }
-
-                  const MacroArgumentType argumentType = (MacroArgumentType)(bodyChunk[2] - '0');
-
-                  if(argumentType == MacroArgumentType::Stringize)
-                  {
-                     preprocessedCode.push_back('\"');
-                     preprocessedCode.append(arguments[parameterIndex]);
-                     preprocessedCode.push_back('\"');
-                  }
-                  else
-                  {
-                     preprocessedCode.append(arguments[parameterIndex]);
-                  }
-               }
-               else
-               {
-                  preprocessedCode.append(bodyChunk);
-               }
-            }
+         pCursor += 2u;
+         token.mLength = pCursor - token.mStart;
+         token.mType = TokenType::Operator;
+         return token;
+      }
+   }
 
-            if(!arguments.empty())
-            {
-               cursor++;
-            }
+   // punctuation (1 character)
+   for(size_t i = 0u; i < kCflatPunctuationCount; i++)
+   {
+      if(token.mStart[0] == kCflatPunctuation[i][0] && kCflatPunctuation[i][1] == '\0')
+      {
+         pCursor++;
+         token.mType = TokenType::Punctuation;
+         return token;
+      }
+   }
 
-            break;
+   // operator (1 character)
+   if(token.mStart[0] == kCflatConditionalOperator[0])
+   {
+      pCursor++;
+      token.mType = TokenType::Operator;
+      return token;
+   }
+   else
+   {
+      for(size_t i = 0u; i < kCflatOperatorsCount; i++)
+      {
+         if(token.mStart[0] == kCflatOperators[i][0])
+         {
+            pCursor++;
+            token.mType = TokenType::Operator;
+            return token;
          }
       }
+   }
 
-      // add the current character to the preprocessed code
-      preprocessedCode.push_back(pCode[cursor]);
+   // keywords
+   for(size_t i = 0u; i < kCflatKeywordsCount; i++)
+   {
+      const size_t keywordLength = strlen(kCflatKeywords[i]);
 
-      cursor++;
+      if(strncmp(token.mStart, kCflatKeywords[i], keywordLength) == 0 &&
+         !isalnum(token.mStart[keywordLength]) &&
+         token.mStart[keywordLength] != '_')
+      {
+         pCursor += keywordLength;
+         token.mLength = pCursor - token.mStart;
+         token.mType = TokenType::Keyword;
+         return token;
+      }
    }
 
-   if(preprocessedCode.back() != '\n')
+   // identifier
+   do
    {
-      preprocessedCode.push_back('\n');
+      pCursor++;
    }
+   while(isalnum(*pCursor) || *pCursor == '_');
 
-   preprocessedCode.shrink_to_fit();
-}
+   token.mLength = pCursor - token.mStart;
+   token.mType = TokenType::Identifier;
 
-void Environment::tokenize(ParsingContext& pContext)
-{
-   Tokenizer::tokenize(pContext.mPreprocessedCode.c_str(), pContext.mTokens);
+   return token;
 }
 
-void Environment::parse(ParsingContext& pContext)
+void Tokenizer::tokenize(const char* pCode, CflatSTLVector(Token)& pTokens)
 {
-   size_t& tokenIndex = pContext.mTokenIndex;
+   const char* cursor = pCode;
+   uint16_t currentLine = 1u;
 
-   for(tokenIndex = 0u; tokenIndex < pContext.mTokens.size(); tokenIndex++)
+   pTokens.clear();
+
+   while(skipBlanks(cursor, currentLine))
    {
-      Statement* statement = parseStatement(pContext);
+      pTokens.push_back(readToken(cursor, currentLine));
+   }
+}
 
-      if(!mErrorMessage.empty())
-      {
-         break;
-      }
 
-      if(statement)
+//
+//  Program
+//
+Program::~Program()
+{
+   for(size_t i = 0u; i < mStatements.size(); i++)
+   {
+      CflatInvokeDtor(Statement, mStatements[i]);
+   }
+
+   for(size_t i = 0u; i < mStatementSources.size(); i++)
+   {
+      if(mStatementSources[i].mArena)
       {
-         pContext.mProgram->mStatements.push_back(statement);
+         CflatInvokeDtor(Arena, mStatementSources[i].mArena);
+         CflatDeallocate(mStatementSources[i].mArena);
       }
    }
 }
 
-Expression* Environment::parseExpression(ParsingContext& pContext, size_t pTokenLastIndex,
-   bool pNullAllowed)
-{
-   Expression* expression = nullptr;
 
-   const size_t tokensCount = pTokenLastIndex - pContext.mTokenIndex + 1u;
-
-   if(tokensCount == 1u)
-   {
-      expression = parseExpressionSingleToken(pContext);
-   }
-   else
+//
+//  Namespace
+//
+Namespace::Namespace(const Identifier& pIdentifier, Namespace* pParent, Environment* pEnvironment)
+   : mIdentifier(pIdentifier)
+   , mFullIdentifier(pIdentifier)
+   , mParent(pParent)
+   , mEnvironment(pEnvironment)
+{
+   if(pParent && pParent->getParent())
    {
-      expression = parseExpressionMultipleTokens(pContext, pTokenLastIndex);
+      char buffer[kDefaultLocalStringBufferSize];
+      sprintf(buffer, "%s::%s", mParent->mFullIdentifier.mName, mIdentifier.mName);
+      mFullIdentifier = Identifier(buffer);
    }
+}
 
-   if(!pNullAllowed && !expression)
+Namespace::~Namespace()
+{
+   for(NamespacesRegistry::iterator it = mNamespaces.begin(); it != mNamespaces.end(); it++)
    {
-      throwCompileErrorUnexpectedSymbol(pContext);
+      Namespace* ns = it->second;
+      CflatInvokeDtor(Namespace, ns);
+      CflatDeallocate(ns);
    }
 
-   return expression;
+   mInstancesHolder.releaseInstances(0u, true);
+
+   mTypesHolder.unregisterSharedTypes(this);
+   mFunctionsHolder.unregisterSharedFunctions(this);
 }
 
-Expression* Environment::parseExpressionSingleToken(ParsingContext& pContext)
+const Identifier& Namespace::getIdentifier() const
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
-   Expression* expression = nullptr;
+   return mIdentifier;
+}
 
-   if(token.mType == TokenType::Number)
-   {
-      TypeUsage typeUsage;
-      Value value;
+const Identifier& Namespace::getFullIdentifier() const
+{
+   return mFullIdentifier;
+}
 
-      pContext.mStringBuffer.assign(token.mStart, token.mLength);
-      const char* numberStr = pContext.mStringBuffer.c_str();
-      const size_t numberStrLength = strlen(numberStr);
+Namespace* Namespace::getParent()
+{
+   return mParent;
+}
 
-      // decimal value
-      if(strchr(numberStr, '.'))
+Environment* Namespace::getEnvironment()
+{
+   return mEnvironment;
+}
+
+void Namespace::registerShared(Namespace* pSource)
+{
+   mTypesHolder.registerSharedTypes(&pSource->mTypesHolder);
+   mFunctionsHolder.registerSharedFunctions(&pSource->mFunctionsHolder);
+
+   CflatSTLVector(Instance*) instances;
+   pSource->getAllInstances(&instances);
+
+   for(size_t i = 0u; i < instances.size(); i++)
+   {
+      const Instance* instance = instances[i];
+
+      if(instance->mValue.mValueBufferType == ValueBufferType::Uninitialized)
       {
-         // float
-         if(numberStr[numberStrLength - 1u] == 'f')
-         {
-            typeUsage.mType = mTypeFloat;
-            const float number = (float)strtod(numberStr, nullptr);
-            value.initOnStack(typeUsage, &mExecutionContext.mStack);
-            value.set(&number);
-         }
-         // double
-         else
-         {
-            typeUsage.mType = mTypeDouble;
-            const double number = strtod(numberStr, nullptr);
-            value.initOnStack(typeUsage, &mExecutionContext.mStack);
-            value.set(&number);
-         }
+         registerInstance(instance->mTypeUsage, instance->mIdentifier);
       }
-      // integer value
       else
       {
-         // unsigned
-         if(numberStr[numberStrLength - 1u] == 'u')
-         {
-            typeUsage.mType = mTypeUInt32;
-            const uint32_t number = (uint32_t)atoi(numberStr);
-            value.initOnStack(typeUsage, &mExecutionContext.mStack);
-            value.set(&number);
-         }
-         // hex
-         else if(numberStr[0] == '0' && numberStr[1] == 'x')
-         {
-            typeUsage.mType = mTypeUInt32;
-            const uint32_t number = (uint32_t)strtoul(numberStr, nullptr, 16);
-            value.initOnStack(typeUsage, &mExecutionContext.mStack);
-            value.set(&number);
-         }
-         // invalid float
-         else if(numberStr[numberStrLength - 1u] == 'f')
-         {
-            throwCompileError(pContext, CompileError::InvalidLiteral, numberStr);
-            return nullptr;
-         }
-         // signed
-         else
-         {
-            typeUsage.mType = mTypeInt32;
-            const int number = atoi(numberStr);
-            value.initOnStack(typeUsage, &mExecutionContext.mStack);
-            value.set(&number);
-         }
+         setVariable(instance->mTypeUsage, instance->mIdentifier, instance->mValue);
       }
+   }
 
-      expression = (ExpressionValue*)CflatMalloc(sizeof(ExpressionValue));
-      CflatInvokeCtor(ExpressionValue, expression)(value);
+   for(NamespacesRegistry::const_iterator it = pSource->mNamespaces.begin();
+      it != pSource->mNamespaces.end(); it++)
+   {
+      requestNamespace(it->second->mIdentifier)->registerShared(it->second);
    }
-   else if(token.mType == TokenType::Identifier)
+}
+
+Namespace* Namespace::getChild(Hash pNameHash)
+{
+   NamespacesRegistry::const_iterator it = mNamespaces.find(pNameHash);
+   return it != mNamespaces.end() ? it->second : nullptr;
+}
+
+Namespace* Namespace::getNamespace(const Identifier& pName)
+{
+   const char* separator = pName.findFirstSeparator();
+
+   if(separator)
    {
-      // variable access
-      pContext.mStringBuffer.assign(token.mStart, token.mLength);
-      const Identifier identifier(pContext.mStringBuffer.c_str());
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t childIdentifierLength = separator - pName.mName;
+      strncpy(buffer, pName.mName, childIdentifierLength);
+      buffer[childIdentifierLength] = '\0';
 
-      Instance* instance = retrieveInstance(pContext, identifier);
+      const Hash childNameHash = hash(buffer);
+      Namespace* child = getChild(childNameHash);
 
-      if(instance)
-      {
-         expression = (ExpressionVariableAccess*)CflatMalloc(sizeof(ExpressionVariableAccess));
-         CflatInvokeCtor(ExpressionVariableAccess, expression)(identifier);
-      }
-      else
+      if(child)
       {
-         throwCompileError(pContext, CompileError::UndefinedVariable, identifier.mName);
+         const Identifier subIdentifier(separator + 2);
+         return child->getNamespace(subIdentifier);
       }
+
+      return nullptr;
    }
-   else if(token.mType == TokenType::Keyword)
-   {
-      if(strncmp(token.mStart, "nullptr", 7u) == 0)
-      {
-         expression = (ExpressionNullPointer*)CflatMalloc(sizeof(ExpressionNullPointer));
-         CflatInvokeCtor(ExpressionNullPointer, expression)();
-      }
-      else if(strncmp(token.mStart, "true", 4u) == 0)
-      {
-         Value value;
-         value.initOnStack(mTypeUsageBool, &mExecutionContext.mStack);
 
-         const bool boolValue = true;
-         value.set(&boolValue);
+   return getChild(pName.mHash);
+}
 
-         expression = (ExpressionValue*)CflatMalloc(sizeof(ExpressionValue));
-         CflatInvokeCtor(ExpressionValue, expression)(value);
-      }
-      else if(strncmp(token.mStart, "false", 5u) == 0)
-      {
-         Value value;
-         value.initOnStack(mTypeUsageBool, &mExecutionContext.mStack);
+Namespace* Namespace::requestNamespace(const Identifier& pName)
+{
+   const char* separator = pName.findFirstSeparator();
 
-         const bool boolValue = false;
-         value.set(&boolValue);
+   if(separator)
+   {
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t childIdentifierLength = separator - pName.mName;
+      strncpy(buffer, pName.mName, childIdentifierLength);
+      buffer[childIdentifierLength] = '\0';
 
-         expression = (ExpressionValue*)CflatMalloc(sizeof(ExpressionValue));
-         CflatInvokeCtor(ExpressionValue, expression)(value);
+      const Identifier childIdentifier(buffer);
+      Namespace* child = getChild(childIdentifier.mHash);
+
+      if(!child)
+      {
+         child = (Namespace*)CflatAllocate(sizeof(Namespace), Types);
+         CflatInvokeCtor(Namespace, child)(childIdentifier, this, mEnvironment);
+         mNamespaces[childIdentifier.mHash] = child;
       }
+
+      const Identifier subIdentifier(separator + 2);
+      return child->requestNamespace(subIdentifier);
    }
-   else if(token.mType == TokenType::String)
+
+   Namespace* child = getChild(pName.mHash);
+
+   if(!child)
    {
-      expression = parseExpressionLiteralString(pContext);
+      child = (Namespace*)CflatAllocate(sizeof(Namespace), Types);
+      CflatInvokeCtor(Namespace, child)(pName, this, mEnvironment);
+      mNamespaces[pName.mHash] = child;
    }
 
-   return expression;
+   return child;
 }
 
-Expression* Environment::parseExpressionMultipleTokens(ParsingContext& pContext, size_t pTokenLastIndex)
+Type* Namespace::getType(const Identifier& pIdentifier, bool pExtendSearchToParent)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
-   Expression* expression = nullptr;
-
-   size_t assignmentOperatorTokenIndex = 0u;
-   size_t binaryOperatorTokenIndex = 0u;
-   uint8_t binaryOperatorPrecedence = 0u;
-   size_t memberAccessTokenIndex = 0u;
-   size_t conditionalTokenIndex = 0u;
+   return getType(pIdentifier, TypeUsage::kEmptyList, pExtendSearchToParent);
+}
 
-   uint32_t parenthesisLevel = tokens[pTokenLastIndex].mStart[0] == ')' ? 1u : 0u;
-   uint32_t squareBracketLevel = tokens[pTokenLastIndex].mStart[0] == ']' ? 1u : 0u;
-   uint32_t templateLevel = tokens[pTokenLastIndex].mStart[0] == '>' ? 1u : 0u;
+Type* Namespace::getType(const Identifier& pIdentifier,
+   const CflatArgsVector(TypeUsage)& pTemplateTypes, bool pExtendSearchToParent)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-   for(size_t i = pTokenLastIndex - 1u; i > tokenIndex; i--)
+   if(lastSeparator)
    {
-      if(tokens[i].mLength == 1u)
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier typeIdentifier(lastSeparator + 2);
+
+      Namespace* ns = getNamespace(nsIdentifier);
+
+      if(ns)
       {
-         if(tokens[i].mStart[0] == ')')
+         return ns->getType(typeIdentifier, pTemplateTypes);
+      }
+
+      Type* type = nullptr;
+
+      if(pExtendSearchToParent && mParent)
+      {
+         type = mParent->getType(pIdentifier, pTemplateTypes, true);
+      }
+
+      if(!type)
+      {
+         Type* parentType = getType(nsIdentifier);
+
+         if(parentType && parentType->mCategory == TypeCategory::StructOrClass)
          {
-            parenthesisLevel++;
-            continue;
-         }
-         else if(tokens[i].mStart[0] == '(')
-         {
-            parenthesisLevel--;
-            continue;
-         }
-         else if(tokens[i].mStart[0] == ']')
-         {
-            squareBracketLevel++;
-            continue;
-         }
-         else if(tokens[i].mStart[0] == '[')
-         {
-            squareBracketLevel--;
-            continue;
-         }
-         else if(tokens[i].mStart[0] == '>')
-         {
-            const size_t templateOpeningIndex = findOpeningTokenIndex(pContext, '<', '>', i);
-            const bool isTemplateClosure =
-               templateOpeningIndex < i && isTemplate(pContext, templateOpeningIndex, i);
-
-            if(isTemplateClosure)
-            {
-               templateLevel++;
-               continue;
-            }
-         }
-         else if(tokens[i].mStart[0] == '<')
-         {
-            const size_t cachedTokenIndex = tokenIndex;
-            tokenIndex = i;
-            const size_t templateClosureIndex =
-               findClosureTokenIndex(pContext, '<', '>', pTokenLastIndex - 1u);
-            tokenIndex = cachedTokenIndex;
-
-            const bool isTemplateOpening =
-               templateClosureIndex > i && isTemplate(pContext, i, templateClosureIndex);
-
-            if(isTemplateOpening)
-            {
-               templateLevel--;
-               continue;
-            }
+            type = static_cast<Struct*>(parentType)->getType(typeIdentifier, pTemplateTypes);
          }
       }
 
-      if(parenthesisLevel == 0u && squareBracketLevel == 0u && templateLevel == 0u)
-      {
-         if(i > tokenIndex &&
-            tokens[i].mType == TokenType::Operator &&
-            tokens[i - 1u].mType != TokenType::Operator)
-         {
-            if(tokens[i].mLength == 1u && tokens[i].mStart[0] == '?')
-            {
-               conditionalTokenIndex = i;
-            }
-            else
-            {
-               for(size_t j = 0u; j < kCflatAssignmentOperatorsCount; j++)
-               {
-                  const size_t operatorLength = strlen(kCflatAssignmentOperators[j]);
-
-                  if(tokens[i].mLength == operatorLength &&
-                     strncmp(tokens[i].mStart, kCflatAssignmentOperators[j], operatorLength) == 0)
-                  {
-                     assignmentOperatorTokenIndex = i;
-                     break;
-                  }
-               }
+      return type;
+   }
 
-               if(assignmentOperatorTokenIndex == 0u)
-               {
-                  const uint8_t precedence = getBinaryOperatorPrecedence(pContext, i);
+   const TypeAlias* typeAlias = getTypeAlias(pIdentifier);
 
-                  if(precedence > binaryOperatorPrecedence)
-                  {
-                     binaryOperatorTokenIndex = i;
-                     binaryOperatorPrecedence = precedence;
-                  }
-               }
-            }
-         }
-         else if(tokens[i].mType == TokenType::Punctuation && memberAccessTokenIndex == 0u)
-         {
-            if(tokens[i].mStart[0] == '.' || strncmp(tokens[i].mStart, "->", 2u) == 0)
-            {
-               memberAccessTokenIndex = i;
-            }
-         }
-      }
+   if(typeAlias && typeAlias->mTypeUsage.mFlags == 0u)
+   {
+      return typeAlias->mTypeUsage.mType;
    }
 
-   bool isCStyleCast = false;
+   Type* type = mTypesHolder.getType(pIdentifier, pTemplateTypes);
 
-   if(tokens[tokenIndex].mStart[0] == '(')
+   if(type)
    {
-      const size_t cachedTokenIndex = tokenIndex;
-      tokenIndex++;
-
-      const TypeUsage typeUsage = parseTypeUsage(pContext, pTokenLastIndex - 1u);
-      isCStyleCast = typeUsage.mType != nullptr;
-      tokenIndex = cachedTokenIndex;
+      return type;
    }
 
-   // assignment
-   if(assignmentOperatorTokenIndex > 0u)
+   if(pExtendSearchToParent && mParent)
    {
-      Expression* left = parseExpression(pContext, assignmentOperatorTokenIndex - 1u);
+      return mParent->getType(pIdentifier, pTemplateTypes, true);
+   }
 
-      if(left)
-      {
-         const TypeUsage leftTypeUsage = getTypeUsage(pContext, left);
+   return nullptr;
+}
 
-         if(!leftTypeUsage.isConst())
-         {
-            const Token& operatorToken = pContext.mTokens[assignmentOperatorTokenIndex];
-            CflatSTLString operatorStr(operatorToken.mStart, operatorToken.mLength);
+void Namespace::registerTypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
+{
+   mTypesHolder.registerTypeAlias(pIdentifier, pTypeUsage);
+}
 
-            tokenIndex = assignmentOperatorTokenIndex + 1u;
-            Expression* right = parseExpression(pContext, pTokenLastIndex);
+const TypeAlias* Namespace::getTypeAlias(const Identifier& pIdentifier)
+{
+   return mTypesHolder.getTypeAlias(pIdentifier);
+}
 
-            if(right)
-            {
-               expression = (ExpressionAssignment*)CflatMalloc(sizeof(ExpressionAssignment));
-               CflatInvokeCtor(ExpressionAssignment, expression)(left, right, operatorStr.c_str());
-            }
-            else
-            {
-               CflatInvokeDtor(Expression, left);
-               CflatFree(left);
-            }
+TypeUsage Namespace::getTypeUsage(const char* pTypeName)
+{
+   return mEnvironment->getTypeUsage(pTypeName, this);
+}
 
-            tokenIndex = pTokenLastIndex + 1u;
-         }
-         else
-         {
-            throwCompileError(pContext, Environment::CompileError::CannotModifyConstExpression);
-         }
-      }
-   }
-   // conditional expression
-   else if(conditionalTokenIndex > 0u)
+Function* Namespace::getFunction(const Identifier& pIdentifier, bool pExtendSearchToParent)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
+
+   if(lastSeparator)
    {
-      const size_t elseTokenIndex = findClosureTokenIndex(pContext, 0, ':', pTokenLastIndex - 1u);
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier functionIdentifier(lastSeparator + 2);
 
-      if(elseTokenIndex > 0u)
-      {
-         Expression* condition = parseExpression(pContext, conditionalTokenIndex - 1u);
-         tokenIndex = conditionalTokenIndex + 1u;
+      Namespace* ns = getNamespace(nsIdentifier);
 
-         Expression* ifExpression = parseExpression(pContext, elseTokenIndex - 1u);
-         tokenIndex = elseTokenIndex + 1u;
+      if(ns)
+      {
+         return ns->getFunction(functionIdentifier);
+      }
 
-         Expression* elseExpression = parseExpression(pContext, pTokenLastIndex);
-         tokenIndex = pTokenLastIndex + 1u;
+      Function* function = nullptr;
 
-         expression = (ExpressionConditional*)CflatMalloc(sizeof(ExpressionConditional));
-         CflatInvokeCtor(ExpressionConditional, expression)
-            (condition, ifExpression, elseExpression);
-      }
-      else
+      if(pExtendSearchToParent && mParent)
       {
-         throwCompileError(pContext, CompileError::InvalidConditionalExpression);
+         function = mParent->getFunction(pIdentifier, true);
       }
+
+      return function;
    }
-   // binary operator
-   else if(binaryOperatorTokenIndex > 0u)
-   {
-      Expression* left = parseExpression(pContext, binaryOperatorTokenIndex - 1u);
 
-      if(left)
-      {
-         const TypeUsage leftTypeUsage = getTypeUsage(pContext, left);
+   Function* function = mFunctionsHolder.getFunction(pIdentifier);
 
-         const Token& operatorToken = pContext.mTokens[binaryOperatorTokenIndex];
-         CflatSTLString operatorStr(operatorToken.mStart, operatorToken.mLength);
+   if(!function && pExtendSearchToParent && mParent)
+   {
+      function = mParent->getFunction(pIdentifier, true);
+   }
 
-         tokenIndex = binaryOperatorTokenIndex + 1u;
-         Expression* right = parseExpression(pContext, pTokenLastIndex);
+   return function;
+}
 
-         if(right)
-         {
-            bool operatorIsValid = true;
-            TypeUsage overloadedOperatorTypeUsage;
+Function* Namespace::getFunction(const Identifier& pIdentifier,
+   const CflatArgsVector(TypeUsage)& pParameterTypes,
+   const CflatArgsVector(TypeUsage)& pTemplateTypes,
+   bool pExtendSearchToParent)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-            if(!leftTypeUsage.isPointer() &&
-               leftTypeUsage.mType &&
-               leftTypeUsage.mType->mCategory == TypeCategory::StructOrClass)
-            {
-               const TypeUsage rightTypeUsage = getTypeUsage(pContext, right);
+   if(lastSeparator)
+   {
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier functionIdentifier(lastSeparator + 2);
 
-               if(rightTypeUsage.mType)
-               {
-                  CflatArgsVector(TypeUsage) args;
-                  args.push_back(rightTypeUsage);
+      Namespace* ns = getNamespace(nsIdentifier);
 
-                  pContext.mStringBuffer.assign("operator");
-                  pContext.mStringBuffer.append(operatorStr);
-                  const Identifier operatorIdentifier(pContext.mStringBuffer.c_str());
+      if(ns)
+      {
+         return ns->getFunction(functionIdentifier, pParameterTypes, pTemplateTypes);
+      }
 
-                  Method* operatorMethod =
-                     findMethod(leftTypeUsage.mType, operatorIdentifier, args);
+      Function* function = nullptr;
 
-                  if(operatorMethod)
-                  {
-                     overloadedOperatorTypeUsage = operatorMethod->mReturnTypeUsage;
-                  }
-                  else
-                  {
-                     args.insert(args.begin(), leftTypeUsage);
+      if(pExtendSearchToParent && mParent)
+      {
+         function = mParent->getFunction(pIdentifier, pParameterTypes, pTemplateTypes, true);
+      }
 
-                     Function* operatorFunction =
-                        leftTypeUsage.mType->mNamespace->getFunction(operatorIdentifier, args);
+      return function;
+   }
 
-                     if(!operatorFunction)
-                     {
-                        operatorFunction = findFunction(pContext, operatorIdentifier, args);
+   Function* function = mFunctionsHolder.getFunction(pIdentifier, pParameterTypes, pTemplateTypes);
 
-                        if(!operatorFunction)
-                        {
-                           CflatSTLString typeFullName;
-                           getTypeFullName(leftTypeUsage.mType, &typeFullName);
-
-                           throwCompileError(pContext, CompileError::InvalidOperator,
-                              typeFullName.c_str(), operatorStr.c_str());
-                           operatorIsValid = false;
-                        }
-                     }
+   if(!function && pExtendSearchToParent && mParent)
+   {
+      function = mParent->getFunction(pIdentifier, pParameterTypes, pTemplateTypes, true);
+   }
 
-                     if(operatorFunction)
-                     {
-                        overloadedOperatorTypeUsage = operatorFunction->mReturnTypeUsage;
-                     }
-                  }
-               }
-            }
+   return function;
+}
 
-            if(operatorIsValid)
-            {
-               expression =
-                  (ExpressionBinaryOperation*)CflatMalloc(sizeof(ExpressionBinaryOperation));
-               CflatInvokeCtor(ExpressionBinaryOperation, expression)
-                  (left, right, operatorStr.c_str(), overloadedOperatorTypeUsage);
-            }
-         }
-         else
-         {
-            CflatInvokeDtor(Expression, left);
-            CflatFree(left);
-         }
-      }
+Function* Namespace::getFunction(const Identifier& pIdentifier,
+   const CflatArgsVector(Value)& pArguments,
+   const CflatArgsVector(TypeUsage)& pTemplateTypes,
+   bool pExtendSearchToParent)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-      tokenIndex = pTokenLastIndex + 1u;
-   }
-   // unary operator
-   else if(token.mType == TokenType::Operator)
+   if(lastSeparator)
    {
-      // address of
-      if(token.mStart[0] == '&')
-      {
-         tokenIndex++;
-         Expression* addressOfExpression = parseExpression(pContext, pTokenLastIndex);
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier functionIdentifier(lastSeparator + 2);
 
-         expression = (ExpressionAddressOf*)CflatMalloc(sizeof(ExpressionAddressOf));
-         CflatInvokeCtor(ExpressionAddressOf, expression)(addressOfExpression);
+      Namespace* ns = getNamespace(nsIdentifier);
+
+      if(ns)
+      {
+         return ns->getFunction(functionIdentifier, pArguments, pTemplateTypes);
       }
-      // indirection
-      else if(token.mStart[0] == '*')
+      
+      Function* function = nullptr;
+
+      if(pExtendSearchToParent && mParent)
       {
-         tokenIndex++;
-         Expression* indirectionExpression = parseExpression(pContext, pTokenLastIndex);
-         const TypeUsage indirectionExpressionTypeUsage =
-            getTypeUsage(pContext, indirectionExpression);
-         Type* indirectionExpressionType = indirectionExpressionTypeUsage.mType;
+         function = mParent->getFunction(pIdentifier, pArguments, pTemplateTypes, true);
+      }
 
-         const Identifier operatorMethodID("operator*");
-         Method* operatorMethod = nullptr;
+      return function;
+   }
 
-         if(indirectionExpressionType &&
-            indirectionExpressionType->mCategory == TypeCategory::StructOrClass)
-         {
-            operatorMethod =
-               findMethod(indirectionExpressionType, operatorMethodID, TypeUsage::kEmptyList);
-         }
+   Function* function = mFunctionsHolder.getFunction(pIdentifier, pArguments, pTemplateTypes);
 
-         if(operatorMethod)
-         {
-            ExpressionMemberAccess* memberAccess =
-               (ExpressionMemberAccess*)CflatMalloc(sizeof(ExpressionMemberAccess));
-            CflatInvokeCtor(ExpressionMemberAccess, memberAccess)
-               (indirectionExpression, operatorMethodID, operatorMethod->mReturnTypeUsage);
+   if(!function && pExtendSearchToParent && mParent)
+   {
+      function = mParent->getFunction(pIdentifier, pArguments, pTemplateTypes, true);
+   }
 
-            ExpressionMethodCall* methodCall =
-               (ExpressionMethodCall*)CflatMalloc(sizeof(ExpressionMethodCall));
-            CflatInvokeCtor(ExpressionMethodCall, methodCall)(memberAccess);
-            expression = methodCall;
+   return function;
+}
 
-            methodCall->mMethod = operatorMethod;
-         }
-         else
-         {
-            expression = (ExpressionIndirection*)CflatMalloc(sizeof(ExpressionIndirection));
-            CflatInvokeCtor(ExpressionIndirection, expression)(indirectionExpression);
-         }
-      }
-      // unary operator (pre)
-      else
-      {
-         const Token& operatorToken = token;
-         CflatSTLString operatorStr(operatorToken.mStart, operatorToken.mLength);
-         tokenIndex++;
-         Expression* operandExpression = parseExpression(pContext, pTokenLastIndex);
+CflatSTLVector(Function*)* Namespace::getFunctions(const Identifier& pIdentifier,
+   bool pExtendSearchToParent)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-         if(operandExpression)
-         {
-            expression =
-               parseExpressionUnaryOperator(pContext, operandExpression, operatorStr.c_str(), false);
-         }
-      }
-   }
-   // C-style cast
-   else if(isCStyleCast)
+   if(lastSeparator)
    {
-      const size_t closureTokenIndex = findClosureTokenIndex(pContext, '(', ')', pTokenLastIndex);
-      tokenIndex++;
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier functionIdentifier(lastSeparator + 2);
 
-      const TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex);
+      Namespace* ns = getNamespace(nsIdentifier);
 
-      if(tokenIndex == closureTokenIndex)
+      if(ns)
       {
-         tokenIndex++;
-         Expression* expressionToCast = parseExpression(pContext, pTokenLastIndex);
+         return ns->getFunctions(functionIdentifier);
+      }
 
-         expression = (ExpressionCast*)CflatMalloc(sizeof(ExpressionCast));
-         CflatInvokeCtor(ExpressionCast, expression)(CastType::CStyle, typeUsage, expressionToCast);
+      CflatSTLVector(Function*)* functions = nullptr;
 
-         const TypeUsage sourceTypeUsage = getTypeUsage(pContext, expressionToCast);
+      if(pExtendSearchToParent && mParent)
+      {
+         functions = mParent->getFunctions(pIdentifier, true);
+      }
 
-         if(!isCastAllowed(CastType::CStyle, sourceTypeUsage, typeUsage))
+      if(!functions)
+      {
+         Type* parentType = getType(nsIdentifier);
+
+         if(parentType && parentType->mCategory == TypeCategory::StructOrClass)
          {
-            throwCompileError(pContext, CompileError::InvalidCast);
+            functions = static_cast<Struct*>(parentType)->getStaticMethods(pIdentifier);
          }
       }
-      else
-      {
-         throwCompileErrorUnexpectedSymbol(pContext);
-      }
+
+      return functions;
    }
-   // member access
-   else if(memberAccessTokenIndex > 0u)
+
+   CflatSTLVector(Function*)* functions = mFunctionsHolder.getFunctions(pIdentifier);
+
+   if(!functions && pExtendSearchToParent && mParent)
    {
-      if(tokens[memberAccessTokenIndex + 1u].mType == TokenType::Identifier)
-      {
-         Expression* memberOwner = parseExpression(pContext, memberAccessTokenIndex - 1u);
-         tokenIndex = memberAccessTokenIndex + 1u;
+      functions = mParent->getFunctions(pIdentifier, true);
+   }
 
-         if(memberOwner)
-         {
-            pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-            const Identifier memberIdentifier(pContext.mStringBuffer.c_str());
+   return functions;
+}
 
-            const bool isMemberAccess = tokens[memberAccessTokenIndex].mStart[0] == '.';
-            const bool isPtrMemberAccess =
-               !isMemberAccess && strncmp(tokens[memberAccessTokenIndex].mStart, "->", 2u) == 0;
+Function* Namespace::registerFunction(const Identifier& pIdentifier)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-            bool memberAccessIsValid = true;
+   if(lastSeparator)
+   {
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier functionIdentifier(lastSeparator + 2);
 
-            const TypeUsage ownerTypeUsage = getTypeUsage(pContext, memberOwner);
-            TypeUsage memberTypeUsage;
+      Namespace* ns = requestNamespace(nsIdentifier);
+      return ns->registerFunction(functionIdentifier);
+   }
 
-            bool isMethodCall = false;
+   Function* function = mFunctionsHolder.registerFunction(pIdentifier);
+   function->mNamespace = this;
 
-            if((tokenIndex + 1u) < tokens.size())
-            {
-               isMethodCall = tokens[tokenIndex + 1u].mStart[0] == '(';
+   return function;
+}
 
-               if(!isMethodCall)
-               {
-                  tokenIndex++;
-                  isMethodCall = isTemplate(pContext, pTokenLastIndex);
-                  tokenIndex--;
-               }
+void Namespace::setVariable(const TypeUsage& pTypeUsage, const Identifier& pIdentifier,
+   const Value& pValue)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-               if(!isMethodCall)
-               {
-                  Struct* type = static_cast<Struct*>(ownerTypeUsage.mType);
-                  Member* member = nullptr;
+   if(lastSeparator)
+   {
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier variableIdentifier(lastSeparator + 2);
 
-                  for(size_t i = 0u; i < type->mMembers.size(); i++)
-                  {
-                     if(type->mMembers[i].mIdentifier == memberIdentifier)
-                     {
-                        member = &type->mMembers[i];
-                        break;
-                     }
-                  }
+      Namespace* ns = requestNamespace(nsIdentifier);
+      return ns->setVariable(pTypeUsage, variableIdentifier, pValue);
+   }
 
-                  if(member)
-                  {
-                     memberTypeUsage = member->mTypeUsage;
-                  }
-                  else
-                  {
-                     throwCompileError(pContext, CompileError::MissingMember,
-                        memberIdentifier.mName);
-                     memberAccessIsValid = false;
-                  }
-               }
-            }
+   Instance* instance = retrieveInstance(pIdentifier);
 
-            if(memberAccessIsValid)
-            {
-               if(ownerTypeUsage.isPointer())
-               {
-                  if(!isPtrMemberAccess)
-                  {
-                     throwCompileError(pContext, CompileError::InvalidMemberAccessOperatorPtr,
-                        memberIdentifier.mName);
-                     memberAccessIsValid = false;
-                  }
-               }
-               else
-               {
-                  if(isPtrMemberAccess)
-                  {
-                     throwCompileError(pContext, CompileError::InvalidMemberAccessOperatorNonPtr,
-                        memberIdentifier.mName);
-                     memberAccessIsValid = false;
-                  }
-               }
-            }
-
-            if(memberAccessIsValid)
-            {
-               ExpressionMemberAccess* memberAccess =
-                  (ExpressionMemberAccess*)CflatMalloc(sizeof(ExpressionMemberAccess));
-               CflatInvokeCtor(ExpressionMemberAccess, memberAccess)
-                  (memberOwner, memberIdentifier, memberTypeUsage);
-               expression = memberAccess;
+   if(!instance)
+   {
+      instance = registerInstance(pTypeUsage, pIdentifier);
+   }
 
-               // method call
-               if(isMethodCall)
-               {
-                  expression = parseExpressionMethodCall(pContext, memberAccess);
+   instance->mValue.initOnHeap(pTypeUsage);
+   instance->mValue.set(pValue.mValueBuffer);
+}
 
-                  if(expression)
-                  {
-                     Method* method = static_cast<ExpressionMethodCall*>(expression)->mMethod;
+Value* Namespace::getVariable(const Identifier& pIdentifier, bool pExtendSearchToParent)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-                     if(method)
-                     {
-                        memberAccess->mMemberTypeUsage = method->mReturnTypeUsage;
-                     }
-                  }
-               }
-            }
-         }
-      }
-      else
-      {
-         tokenIndex = memberAccessTokenIndex;
-         throwCompileErrorUnexpectedSymbol(pContext);
-      }
-   }
-   // parenthesized expression
-   else if(tokens[tokenIndex].mStart[0] == '(')
+   if(lastSeparator)
    {
-      const size_t closureTokenIndex = findClosureTokenIndex(pContext, '(', ')', pTokenLastIndex);
-      tokenIndex++;
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier variableIdentifier(lastSeparator + 2);
 
-      if(closureTokenIndex > tokenIndex)
+      Namespace* ns = getNamespace(nsIdentifier);
+
+      if(ns)
       {
-         Expression* innerExpression = parseExpression(pContext, closureTokenIndex - 1u);
+         return ns->getVariable(variableIdentifier);
+      }
 
-         if(innerExpression)
-         {
-            expression = (ExpressionParenthesized*)CflatMalloc(sizeof(ExpressionParenthesized));
-            CflatInvokeCtor(ExpressionParenthesized, expression)(innerExpression);
-         }
+      Value* value = nullptr;
 
-         tokenIndex = closureTokenIndex + 1u;
-      }
-      else
+      if(pExtendSearchToParent && mParent)
       {
-         throwCompileErrorUnexpectedSymbol(pContext);
+         value = mParent->getVariable(pIdentifier, true);
       }
+
+      return value;
    }
-   // array initialization
-   else if(tokens[tokenIndex].mStart[0] == '{')
-   {
-      tokenIndex++;
 
-      ExpressionArrayInitialization* concreteExpression =
-         (ExpressionArrayInitialization*)CflatMalloc(sizeof(ExpressionArrayInitialization));
-      CflatInvokeCtor(ExpressionArrayInitialization, concreteExpression)();
-      expression = concreteExpression;
+   Value* value = mInstancesHolder.getVariable(pIdentifier);
 
-      const size_t closureIndex = findClosureTokenIndex(pContext, '{', '}', pTokenLastIndex);
+   if(!value && pExtendSearchToParent && mParent)
+   {
+      value = mParent->getVariable(pIdentifier, true);
+   }
 
-      while(tokenIndex < closureIndex)
-      {
-         const size_t separatorIndex = findSeparationTokenIndex(pContext, ',', closureIndex);
-         const size_t lastArrayValueIndex = separatorIndex > 0u
-            ? separatorIndex - 1u
-            : closureIndex - 1u;
+   return value;
+}
 
-         Expression* arrayValueExpression = parseExpression(pContext, lastArrayValueIndex);
-         concreteExpression->mValues.push_back(arrayValueExpression);
+Instance* Namespace::registerInstance(const TypeUsage& pTypeUsage, const Identifier& pIdentifier)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
 
-         tokenIndex = lastArrayValueIndex + 2u;
-      }
+   if(lastSeparator)
+   {
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier instanceIdentifier(lastSeparator + 2);
+
+      Namespace* ns = requestNamespace(nsIdentifier);
+      return ns->registerInstance(pTypeUsage, instanceIdentifier);
    }
-   // unary operator (post)
-   else if(tokens[pTokenLastIndex].mType == TokenType::Operator)
+
+   return mInstancesHolder.registerInstance(pTypeUsage, pIdentifier);
+}
+
+Instance* Namespace::retrieveInstance(const Identifier& pIdentifier, bool pExtendSearchToParent)
+{
+   const char* lastSeparator = pIdentifier.findLastSeparator();
+
+   if(lastSeparator)
    {
-      const Token& operatorToken = tokens[pTokenLastIndex];
+      char buffer[kDefaultLocalStringBufferSize];
+      const size_t nsIdentifierLength = lastSeparator - pIdentifier.mName;
+      strncpy(buffer, pIdentifier.mName, nsIdentifierLength);
+      buffer[nsIdentifierLength] = '\0';
+      const Identifier nsIdentifier(buffer);
+      const Identifier instanceIdentifier(lastSeparator + 2);
 
-      if(operatorToken.mLength == 2u)
-      {
-         if(strncmp(operatorToken.mStart, "++", 2u) == 0 ||
-            strncmp(operatorToken.mStart, "--", 2u) == 0)
-         {
-            CflatSTLString operatorStr(operatorToken.mStart, operatorToken.mLength);
-            Expression* operandExpression = parseExpression(pContext, pTokenLastIndex - 1u);
+      Namespace* ns = getNamespace(nsIdentifier);
 
-            expression =
-               parseExpressionUnaryOperator(pContext, operandExpression, operatorStr.c_str(), true);
-         }
+      if(ns)
+      {
+         return ns->retrieveInstance(instanceIdentifier);
       }
 
-      if(!expression)
+      Instance* instance = nullptr;
+
+      if(pExtendSearchToParent && mParent)
       {
-         throwCompileErrorUnexpectedSymbol(pContext);
+         instance = mParent->retrieveInstance(pIdentifier, true);
       }
+
+      return instance;
    }
-   // array element access / operator[]
-   else if(tokens[pTokenLastIndex].mStart[0] == ']')
-   {
-      const size_t openingIndex = findOpeningTokenIndex(pContext, '[', ']', pTokenLastIndex);
 
-      if(pTokenLastIndex > (openingIndex + 1u))
-      {
-         Expression* arrayAccess = parseExpression(pContext, openingIndex - 1u);
+   Instance* instance = mInstancesHolder.retrieveInstance(pIdentifier);
 
-         tokenIndex = openingIndex + 1u;
-         Expression* arrayElementIndex = parseExpression(pContext, pTokenLastIndex - 1u);
+   if(!instance && pExtendSearchToParent && mParent)
+   {
+      instance = mParent->retrieveInstance(pIdentifier, true);
+   }
 
-         const TypeUsage typeUsage = getTypeUsage(pContext, arrayAccess);
+   return instance;
+}
 
-         if(typeUsage.isArray() || typeUsage.isPointer())
-         {
-            expression =
-               (ExpressionArrayElementAccess*)CflatMalloc(sizeof(ExpressionArrayElementAccess));
-            CflatInvokeCtor(ExpressionArrayElementAccess, expression)
-               (arrayAccess, arrayElementIndex);
-         }
-         else if(typeUsage.mType->mCategory == TypeCategory::StructOrClass)
-         {
-            const Identifier operatorMethodID("operator[]");
-            Method* operatorMethod = findMethod(typeUsage.mType, operatorMethodID);
+void Namespace::releaseInstances(uint32_t pScopeLevel, bool pExecuteDestructors)
+{
+   mInstancesHolder.releaseInstances(pScopeLevel, pExecuteDestructors);
 
-            if(operatorMethod)
-            {
-               ExpressionMemberAccess* memberAccess =
-                  (ExpressionMemberAccess*)CflatMalloc(sizeof(ExpressionMemberAccess));
-               CflatInvokeCtor(ExpressionMemberAccess, memberAccess)
-                  (arrayAccess, operatorMethodID, operatorMethod->mReturnTypeUsage);
+   for(NamespacesRegistry::iterator it = mNamespaces.begin(); it != mNamespaces.end(); it++)
+   {
+      Namespace* ns = it->second;
+      ns->releaseInstances(pScopeLevel, pExecuteDestructors);
+   }
+}
 
-               ExpressionMethodCall* methodCall =
-                  (ExpressionMethodCall*)CflatMalloc(sizeof(ExpressionMethodCall));
-               CflatInvokeCtor(ExpressionMethodCall, methodCall)(memberAccess);
-               expression = methodCall;
+void Namespace::getAllNamespaces(CflatSTLVector(Namespace*)* pOutNamespaces)
+{
+   for(NamespacesRegistry::const_iterator it = mNamespaces.begin(); it != mNamespaces.end(); it++)
+   {
+      pOutNamespaces->push_back(it->second);
+   }
+}
 
-               methodCall->mArguments.push_back(arrayElementIndex);
-               methodCall->mMethod = operatorMethod;
-            }
-            else
-            {
-               throwCompileErrorUnexpectedSymbol(pContext);
-            }
-         }
-         else
-         {
-            throwCompileErrorUnexpectedSymbol(pContext);
-         }
+void Namespace::getAllInstances(CflatSTLVector(Instance*)* pOutInstances)
+{
+   mInstancesHolder.getAllInstances(pOutInstances);
+}
 
-         tokenIndex = pTokenLastIndex + 1u;
-      }
-      else
-      {
-         throwCompileErrorUnexpectedSymbol(pContext);
-      }
-   }
-   else if(token.mType == TokenType::Identifier)
-   {
-      pContext.mStringBuffer.assign(token.mStart, token.mLength);
+void Namespace::getAllFunctions(CflatSTLVector(Function*)* pOutFunctions)
+{
+   mFunctionsHolder.getAllFunctions(pOutFunctions);
+}
 
-      while(tokenIndex < (tokens.size() - 1u) && strncmp(tokens[++tokenIndex].mStart, "::", 2u) == 0)
-      {
-         tokenIndex++;
-         pContext.mStringBuffer.append("::");
-         pContext.mStringBuffer.append(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-      }
 
-      const Identifier fullIdentifier(pContext.mStringBuffer.c_str());
-      bool isFunctionCall = tokens[tokenIndex].mStart[0] == '(';
-         
-      if(!isFunctionCall && isTemplate(pContext, pTokenLastIndex))
-      {
-         const size_t templateClosureIndex =
-            findClosureTokenIndex(pContext, '<', '>', pTokenLastIndex);
-         isFunctionCall =
-            templateClosureIndex > 0u && tokens[templateClosureIndex + 1u].mStart[0] == '(';
-      }
+//
+//  Context
+//
+Context::Context(ContextType pType, Namespace* pGlobalNamespace,
+   size_t pStackSize, bool pGrowableStack)
+   : mType(pType)
+   , mProgram(nullptr)
+   , mBlockLevel(0u)
+   , mScopeLevel(0u)
+   , mStack(pStackSize, pGrowableStack)
+{
+   mNamespaceStack.push_back(pGlobalNamespace);
+}
 
-      // function call / object construction
-      if(isFunctionCall)
-      {
-         Type* type = findType(pContext, fullIdentifier);
-         expression = type
-            ? parseExpressionObjectConstruction(pContext, type)
-            : parseExpressionFunctionCall(pContext, fullIdentifier);
-      }
-      // variable access with namespace / static member access
-      else
-      {
-         Instance* instance = retrieveInstance(pContext, fullIdentifier);
 
-         if(!instance)
-         {
-            const char* lastSeparator = fullIdentifier.findLastSeparator();
+//
+//  ParsingContext
+//
+ParsingContext::ParsingContext(Namespace* pGlobalNamespace)
+   : Context(ContextType::Parsing, pGlobalNamespace, kParsingStackSegmentSize, true)
+   , mCode(nullptr)
+   , mArena(nullptr)
+   , mTokenIndex(0u)
+   , mLocalFrameBase(0u)
+   , mSwitchLocalsBase(SIZE_MAX)
+   , mLocalNamespaceGlobalIndex(0u)
+{
+}
 
-            if(lastSeparator)
-            {
-               char buffer[kDefaultLocalStringBufferSize];
-               const size_t containerIdentifierLength = lastSeparator - fullIdentifier.mName;
-               strncpy(buffer, fullIdentifier.mName, containerIdentifierLength);
-               buffer[containerIdentifierLength] = '\0';
-               const Identifier containerIdentifier(buffer);
-               const Identifier memberIdentifier(lastSeparator + 2);
 
-               Type* type = findType(pContext, containerIdentifier);
+//
+//  CallStackEntry
+//
+CallStackEntry::CallStackEntry(const Program* pProgram, const Function* pFunction)
+   : mProgram(pProgram)
+   , mFunction(pFunction)
+   , mLine(0u)
+{
+}
 
-               if(type && type->mCategory == TypeCategory::StructOrClass)
-               {
-                  instance =
-                     static_cast<Struct*>(type)->mInstancesHolder.retrieveInstance(memberIdentifier);
 
-                  if(!instance)
-                  {
-                     CflatSTLString typeFullName;
-                     getTypeFullName(type, &typeFullName);
+//
+//  SlicedCall
+//
+SlicedCall::SlicedCall()
+   : mFunction(nullptr)
+   , mReturnValue(nullptr)
+   , mProfiler(nullptr)
+   , mCallDepth(0u)
+   , mPreviousLocalFrameBase(0u)
+   , mInstructionIndex(0u)
+   , mBaseBlockLevel(0u)
+   , mBaseScopeLevel(0u)
+   , mInstructionsBudget(0u)
+   , mExecutedInstructionsCount(0u)
+   , mDeadline(0u)
+   , mBudgetExhausted(false)
+   , mSuspended(false)
+{
+}
 
-                     throwCompileError(pContext, Environment::CompileError::MissingStaticMember,
-                        memberIdentifier.mName, typeFullName.c_str());
-                  }
-               }
-            }
-         }
 
-         if(instance)
-         {
-            expression = (ExpressionVariableAccess*)CflatMalloc(sizeof(ExpressionVariableAccess));
-            CflatInvokeCtor(ExpressionVariableAccess, expression)(fullIdentifier);
-         }
-         else
-         {
-            throwCompileError(pContext, Environment::CompileError::UndefinedType,
-               fullIdentifier.mName);
-         }
-      }
+//
+//  ExecutionContext
+//
+ExecutionContext::ExecutionContext(Namespace* pGlobalNamespace,
+   size_t pStackSize, bool pGrowableStack)
+   : Context(ContextType::Execution, pGlobalNamespace, pStackSize, pGrowableStack)
+   , mJumpStatement(JumpStatement::None)
+   , mLocalFrameBase(0u)
+   , mLineHookProgram(nullptr)
+   , mLineHookLine(0u)
+   , mLineHookCallDepth(0u)
+   , mSampledHookCounter(0u)
+   , mTimerHookCounter(0u)
+   , mTimerHookTime(0u)
+   , mProfiler(nullptr)
+{
+   mNamespaceStack.reserve(kMaxNestedFunctionCalls * 2u);
+   mCallStack.reserve(kMaxNestedFunctionCalls);
+}
+
+
+//
+//  Profiler
+//
+Profiler::Profiler(bool pTraceEnabled)
+   : mCurrentLineRecordIndex(SIZE_MAX)
+   , mCurrentLineStartTime(0u)
+   , mStartTime(getTime())
+   , mTracksCount(1u)
+   , mTraceEnabled(pTraceEnabled)
+{
+}
+
+size_t Profiler::getFunctionRecordIndex(const void* pFunction, const Namespace* pNamespace,
+   const Type* pOwnerType, const Identifier& pIdentifier)
+{
+   FunctionRecordsRegistry::const_iterator it = mFunctionRecordsRegistry.find(pFunction);
+
+   if(it != mFunctionRecordsRegistry.end())
+   {
+      return it->second;
    }
-   else if(token.mType == TokenType::Keyword)
+
+   FunctionRecord functionRecord;
+   functionRecord.mFunction = pFunction;
+   functionRecord.mCallsCount = 0u;
+   functionRecord.mInclusiveTime = 0u;
+   functionRecord.mExclusiveTime = 0u;
+   functionRecord.mActiveCallsCount = 0u;
+
+   if(pOwnerType)
    {
-      if(strncmp(token.mStart, "sizeof", 6u) == 0)
-      {
-         if(tokens[tokenIndex + 1u].mStart[0] == '(')
-         {
-            tokenIndex++;
-            const size_t closureTokenIndex =
-               findClosureTokenIndex(pContext, '(', ')', pTokenLastIndex);
-            tokenIndex++;
+      pNamespace = pOwnerType->mNamespace;
+   }
 
-            ExpressionSizeOf* concreteExpression =
-               (ExpressionSizeOf*)CflatMalloc(sizeof(ExpressionSizeOf));
-            CflatInvokeCtor(ExpressionSizeOf, concreteExpression)();
-            expression = concreteExpression;
+   if(pNamespace && pNamespace->getFullIdentifier().mNameLength > 0u)
+   {
+      functionRecord.mName.append(pNamespace->getFullIdentifier().mName);
+      functionRecord.mName.append("::");
+   }
 
-            concreteExpression->mTypeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+   if(pOwnerType)
+   {
+      functionRecord.mName.append(pOwnerType->mIdentifier.mName);
+      functionRecord.mName.append("::");
+   }
 
-            if(!concreteExpression->mTypeUsage.mType)
-            {
-               concreteExpression->mExpression = parseExpression(pContext, closureTokenIndex - 1u);
-            }
+   functionRecord.mName.append(pIdentifier.mName);
 
-            tokenIndex = closureTokenIndex;
-         }
-         else
-         {
-            throwCompileErrorUnexpectedSymbol(pContext);
-         }
-      }
-      else if(strncmp(token.mStart, "static_cast", 11u) == 0)
-      {
-         tokenIndex++;
-         expression = parseExpressionCast(pContext, CastType::Static, pTokenLastIndex);
-      }
-      else if(strncmp(token.mStart, "dynamic_cast", 12u) == 0)
-      {
-         tokenIndex++;
-         expression = parseExpressionCast(pContext, CastType::Dynamic, pTokenLastIndex);
-      }
-      else if(strncmp(token.mStart, "reinterpret_cast", 16u) == 0)
-      {
-         tokenIndex++;
-         expression = parseExpressionCast(pContext, CastType::Reinterpret, pTokenLastIndex);
-      }
+   const size_t functionRecordIndex = mFunctionRecords.size();
+   mFunctionRecords.push_back(functionRecord);
+   mFunctionRecordsRegistry[pFunction] = functionRecordIndex;
+
+   return functionRecordIndex;
+}
+
+void Profiler::beginCall(size_t pFunctionRecordIndex, bool pScriptFunction)
+{
+   const uint64_t time = getTime();
+
+   Frame frame;
+   frame.mFunctionRecordIndex = pFunctionRecordIndex;
+   frame.mStartTime = time;
+   frame.mChildrenTime = 0u;
+   frame.mCallerLineRecordIndex = mCurrentLineRecordIndex;
+   frame.mScriptFunction = pScriptFunction;
+   mFrames.push_back(frame);
+
+   FunctionRecord& functionRecord = mFunctionRecords[pFunctionRecordIndex];
+   functionRecord.mCallsCount++;
+   functionRecord.mActiveCallsCount++;
+
+   // the time spent in script functions gets charged to their own lines
+   if(pScriptFunction)
+   {
+      chargeCurrentLine(time);
+      mCurrentLineRecordIndex = SIZE_MAX;
    }
-   else if(token.mType == TokenType::String)
+}
+
+void Profiler::chargeCurrentLine(uint64_t pTime)
+{
+   if(mCurrentLineRecordIndex != SIZE_MAX)
    {
-      expression = parseExpressionLiteralString(pContext);
+      mLineRecords[mCurrentLineRecordIndex].mTime += pTime - mCurrentLineStartTime;
    }
 
-   return expression;
+   mCurrentLineStartTime = pTime;
 }
 
-Expression* Environment::parseExpressionLiteralString(ParsingContext& pContext)
+void Profiler::reset()
 {
-   pContext.mStringBuffer.clear();
+   mFunctionRecords.clear();
+   mFunctionRecordsRegistry.clear();
+   mLineRecords.clear();
+   mLineRecordsRegistry.clear();
+   mTraceEvents.clear();
+   mFrames.clear();
 
-   do
-   {
-      const Token& token = pContext.mTokens[pContext.mTokenIndex];
+   mCurrentLineRecordIndex = SIZE_MAX;
+   mStartTime = getTime();
+   mTracksCount = 1u;
+}
 
-      for(size_t i = 1u; i < (token.mLength - 1u); i++)
-      {
-         const char currentChar = *(token.mStart + i);
+void Profiler::merge(const Profiler& pOther)
+{
+   CflatAssert(pOther.mFrames.empty());
 
-         if(currentChar == '\\')
-         {
-            const char escapeChar = *(token.mStart + i + 1u);
+   CflatSTLVector(size_t) functionRecordIndices;
+   functionRecordIndices.resize(pOther.mFunctionRecords.size());
 
-            if(escapeChar == 'n')
-            {
-               pContext.mStringBuffer.push_back('\n');
-            }
-            else
-            {
-               pContext.mStringBuffer.push_back('\\');
-            }
+   for(size_t i = 0u; i < pOther.mFunctionRecords.size(); i++)
+   {
+      const FunctionRecord& otherRecord = pOther.mFunctionRecords[i];
+      FunctionRecordsRegistry::const_iterator it = mFunctionRecordsRegistry.find(otherRecord.mFunction);
 
-            i++;
-         }
-         else
-         {
-            pContext.mStringBuffer.push_back(currentChar);
-         }
+      if(it != mFunctionRecordsRegistry.end())
+      {
+         FunctionRecord& functionRecord = mFunctionRecords[it->second];
+         functionRecord.mCallsCount += otherRecord.mCallsCount;
+         functionRecord.mInclusiveTime += otherRecord.mInclusiveTime;
+         functionRecord.mExclusiveTime += otherRecord.mExclusiveTime;
+         functionRecordIndices[i] = it->second;
+      }
+      else
+      {
+         functionRecordIndices[i] = mFunctionRecords.size();
+         mFunctionRecords.push_back(otherRecord);
+         mFunctionRecords.back().mActiveCallsCount = 0u;
+         mFunctionRecordsRegistry[otherRecord.mFunction] = functionRecordIndices[i];
       }
-
-      pContext.mTokenIndex++;
    }
-   while(pContext.mTokenIndex < pContext.mTokens.size() &&
-      pContext.mTokens[pContext.mTokenIndex].mType == TokenType::String);
 
-   pContext.mStringBuffer.push_back('\0');
+   for(LineRecordsRegistry::const_iterator otherIt = pOther.mLineRecordsRegistry.begin();
+      otherIt != pOther.mLineRecordsRegistry.end();
+      otherIt++)
+   {
+      const LineRecord& otherRecord = pOther.mLineRecords[otherIt->second];
+      LineRecordsRegistry::const_iterator it = mLineRecordsRegistry.find(otherIt->first);
 
-   const Hash stringHash = hash(pContext.mStringBuffer.c_str());
-   const char* string =
-      mLiteralStringsPool.registerString(stringHash, pContext.mStringBuffer.c_str());
+      if(it != mLineRecordsRegistry.end())
+      {
+         mLineRecords[it->second].mExecutionsCount += otherRecord.mExecutionsCount;
+         mLineRecords[it->second].mTime += otherRecord.mTime;
+      }
+      else
+      {
+         mLineRecordsRegistry[otherIt->first] = mLineRecords.size();
+         mLineRecords.push_back(otherRecord);
+      }
+   }
 
-   Value value;
-   value.initOnStack(mTypeUsageCString, &mExecutionContext.mStack);
-   value.set(&string);
+   // the times of the events are absolute, so the trace starts with the earliest profiler
+   for(size_t i = 0u; i < pOther.mTraceEvents.size(); i++)
+   {
+      mTraceEvents.push_back(pOther.mTraceEvents[i]);
+      mTraceEvents.back().mFunctionRecordIndex =
+         functionRecordIndices[pOther.mTraceEvents[i].mFunctionRecordIndex];
+      mTraceEvents.back().mTrackIndex += mTracksCount;
+   }
 
-   ExpressionValue* expression = (ExpressionValue*)CflatMalloc(sizeof(ExpressionValue));
-   CflatInvokeCtor(ExpressionValue, expression)(value);
+   mStartTime = min(mStartTime, pOther.mStartTime);
+   mTracksCount += pOther.mTracksCount;
+}
 
-   return expression;
+const CflatSTLVector(Profiler::FunctionRecord)& Profiler::getFunctionRecords() const
+{
+   return mFunctionRecords;
 }
 
-Expression* Environment::parseExpressionUnaryOperator(ParsingContext& pContext, Expression* pOperand,
-   const char* pOperator, bool pPostOperator)
+const CflatSTLVector(Profiler::LineRecord)& Profiler::getLineRecords() const
 {
-   Expression* expression = nullptr;
-   bool validOperation = true;
+   return mLineRecords;
+}
 
-   const bool isIncrementOrDecrement =
-      strncmp(pOperator, "++", 2u) == 0 ||
-      strncmp(pOperator, "--", 2u) == 0;
+const CflatSTLVector(Profiler::TraceEvent)& Profiler::getTraceEvents() const
+{
+   return mTraceEvents;
+}
 
-   if(isIncrementOrDecrement)
+const Profiler::FunctionRecord* Profiler::getFunctionRecord(const char* pName) const
+{
+   for(size_t i = 0u; i < mFunctionRecords.size(); i++)
    {
-      const TypeUsage operandTypeUsage = getTypeUsage(pContext, pOperand);
-
-      if(operandTypeUsage.isConst())
+      if(strcmp(mFunctionRecords[i].mName.c_str(), pName) == 0)
       {
-         throwCompileError(pContext, Environment::CompileError::CannotModifyConstExpression);
-         validOperation = false;
+         return &mFunctionRecords[i];
       }
    }
 
-   if(validOperation)
+   return nullptr;
+}
+
+const Profiler::LineRecord* Profiler::getLineRecord(const char* pProgramName, uint16_t pLine) const
+{
+   const Hash programNameHash = hash(pProgramName);
+
+   for(size_t i = 0u; i < mLineRecords.size(); i++)
    {
-      expression = (ExpressionUnaryOperation*)CflatMalloc(sizeof(ExpressionUnaryOperation));
-      CflatInvokeCtor(ExpressionUnaryOperation, expression)(pOperand, pOperator, pPostOperator);
+      if(mLineRecords[i].mProgramIdentifier.mHash == programNameHash && mLineRecords[i].mLine == pLine)
+      {
+         return &mLineRecords[i];
+      }
    }
 
-   return expression;
+   return nullptr;
 }
 
-Expression* Environment::parseExpressionCast(ParsingContext& pContext, CastType pCastType,
-   size_t pTokenLastIndex)
+void Profiler::writeReport(CflatSTLString* pOutReport) const
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   Expression* expression = nullptr;
+   CflatAssert(pOutReport);
 
-   if(tokens[tokenIndex].mStart[0] == '<')
+   CflatSTLVector(const FunctionRecord*) functionRecords;
+   functionRecords.reserve(mFunctionRecords.size());
+
+   for(size_t i = 0u; i < mFunctionRecords.size(); i++)
    {
-      tokenIndex++;
-      const TypeUsage targetTypeUsage = parseTypeUsage(pContext, pTokenLastIndex - 1u);
+      functionRecords.push_back(&mFunctionRecords[i]);
+   }
 
-      if(targetTypeUsage.mType)
+   std::sort(functionRecords.begin(), functionRecords.end(),
+      [](const FunctionRecord* pA, const FunctionRecord* pB)
       {
-         if(tokens[tokenIndex].mStart[0] == '>')
-         {
-            tokenIndex++;
-
-            if(tokens[tokenIndex].mStart[0] == '(')
-            {
-               tokenIndex++;
-               const size_t closureTokenIndex =
-                  findClosureTokenIndex(pContext, '(', ')', pTokenLastIndex);
+         return pA->mExclusiveTime > pB->mExclusiveTime;
+      });
 
-               if(closureTokenIndex > 0u)
-               {
-                  Expression* expressionToCast = parseExpression(pContext, closureTokenIndex - 1u);
-                  const TypeUsage sourceTypeUsage = getTypeUsage(pContext, expressionToCast);
+   CflatSTLVector(const LineRecord*) lineRecords;
+   lineRecords.reserve(mLineRecords.size());
 
-                  if(isCastAllowed(pCastType, sourceTypeUsage, targetTypeUsage))
-                  {
-                     expression = (ExpressionCast*)CflatMalloc(sizeof(ExpressionCast));
-                     CflatInvokeCtor(ExpressionCast, expression)
-                        (pCastType, targetTypeUsage, expressionToCast);
-                  }
-                  else
-                  {
-                     throwCompileError(pContext, CompileError::InvalidCast);
-                  }
-               }
-               else
-               {
-                  tokenIndex = pTokenLastIndex - 1u;
-                  throwCompileErrorUnexpectedSymbol(pContext);
-               }
-            }
-            else
-            {
-               throwCompileErrorUnexpectedSymbol(pContext);
-            }
-         }
-      }
-      else
-      {
-         throwCompileErrorUnexpectedSymbol(pContext);
-      }
-   }
-   else
+   for(size_t i = 0u; i < mLineRecords.size(); i++)
    {
-      throwCompileErrorUnexpectedSymbol(pContext);
+      lineRecords.push_back(&mLineRecords[i]);
    }
 
-   return expression;
-}
+   std::sort(lineRecords.begin(), lineRecords.end(),
+      [](const LineRecord* pA, const LineRecord* pB)
+      {
+         return pA->mTime > pB->mTime;
+      });
 
-Expression* Environment::parseExpressionFunctionCall(ParsingContext& pContext,
-   const Identifier& pFunctionIdentifier)
-{
-   ExpressionFunctionCall* expression =
-      (ExpressionFunctionCall*)CflatMalloc(sizeof(ExpressionFunctionCall));
-   CflatInvokeCtor(ExpressionFunctionCall, expression)(pFunctionIdentifier);
+   char buffer[kDefaultLocalStringBufferSize];
 
-   parseFunctionCallArguments(pContext, &expression->mArguments, &expression->mTemplateTypes);
+   pOutReport->append("Calls          Inclusive (ms)   Exclusive (ms)   Function\n");
 
-   if(!mErrorMessage.empty())
+   for(size_t i = 0u; i < functionRecords.size(); i++)
    {
-      return nullptr;
+      const FunctionRecord* functionRecord = functionRecords[i];
+      snprintf(buffer, sizeof(buffer), "%-14llu %-16.3f %-16.3f %s\n",
+         (unsigned long long)functionRecord->mCallsCount,
+         (double)functionRecord->mInclusiveTime / 1000000.0,
+         (double)functionRecord->mExclusiveTime / 1000000.0,
+         functionRecord->mName.c_str());
+      pOutReport->append(buffer);
    }
 
-   CflatArgsVector(TypeUsage) argumentTypes;
+   pOutReport->append("\nExecutions     Time (ms)        Line\n");
 
-   for(size_t i = 0u; i < expression->mArguments.size(); i++)
+   for(size_t i = 0u; i < lineRecords.size(); i++)
    {
-      const TypeUsage typeUsage = getTypeUsage(pContext, expression->mArguments[i]);
-      argumentTypes.push_back(typeUsage);
+      const LineRecord* lineRecord = lineRecords[i];
+      snprintf(buffer, sizeof(buffer), "%-14llu %-16.3f %s:%u\n",
+         (unsigned long long)lineRecord->mExecutionsCount,
+         (double)lineRecord->mTime / 1000000.0,
+         lineRecord->mProgramIdentifier.mName,
+         (unsigned int)lineRecord->mLine);
+      pOutReport->append(buffer);
    }
+}
 
-   CflatArgsVector(TypeUsage) templateTypes;
-   toArgsVector(expression->mTemplateTypes, templateTypes);
-
-   expression->mFunction = findFunction(pContext, pFunctionIdentifier, argumentTypes, templateTypes);
-
-   if(!expression->mFunction)
-   {
-      const char* lastSeparator = pFunctionIdentifier.findLastSeparator();
-
-      if(lastSeparator)
-      {
-         char buffer[kDefaultLocalStringBufferSize];
-         const size_t typeIdentifierLength = lastSeparator - pFunctionIdentifier.mName;
-         strncpy(buffer, pFunctionIdentifier.mName, typeIdentifierLength);
-         buffer[typeIdentifierLength] = '\0';
-         const Identifier typeIdentifier(buffer);
-         const Identifier staticMethodIdentifier(lastSeparator + 2);
-
-         Type* type = findType(pContext, typeIdentifier);
-
-         if(type && type->mCategory == TypeCategory::StructOrClass)
-         {
-            Struct* castedType = static_cast<Struct*>(type);
-            expression->mFunction =
-               castedType->getStaticMethod(staticMethodIdentifier, argumentTypes, templateTypes);
+void Profiler::writeChromeTrace(CflatSTLString* pOutTrace) const
+{
+   CflatAssert(pOutTrace);
 
-            if(!expression->mFunction)
-            {
-               CflatSTLString typeFullName;
-               getTypeFullName(type, &typeFullName);
+   char buffer[kDefaultLocalStringBufferSize];
 
-               throwCompileError(pContext, CompileError::MissingStaticMethod,
-                  staticMethodIdentifier.mName, typeFullName.c_str());
-            }
-         }
-      }
-   }
+   pOutTrace->append("{\"traceEvents\":[");
 
-   if(!expression->mFunction)
+   for(size_t i = 0u; i < mTraceEvents.size(); i++)
    {
-      CflatInvokeDtor(ExpressionFunctionCall, expression);
-      CflatFree(expression);
-      expression = nullptr;
+      const TraceEvent& traceEvent = mTraceEvents[i];
+      const FunctionRecord& functionRecord = mFunctionRecords[traceEvent.mFunctionRecordIndex];
 
-      throwCompileError(pContext, CompileError::UndefinedFunction, pFunctionIdentifier.mName);
+      // timestamps and durations are expressed in microseconds
+      snprintf(buffer, sizeof(buffer),
+         "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+         i > 0u ? "," : "",
+         functionRecord.mName.c_str(),
+         (double)(traceEvent.mStartTime - mStartTime) / 1000.0,
+         (double)traceEvent.mDuration / 1000.0,
+         traceEvent.mTrackIndex);
+      pOutTrace->append(buffer);
    }
 
-   return expression;
+   pOutTrace->append("\n],\"displayTimeUnit\":\"ms\"}\n");
 }
 
-Expression* Environment::parseExpressionMethodCall(ParsingContext& pContext, Expression* pMemberAccess)
+void Profiler::beginFunctionCall(const Function* pFunction)
 {
-   ExpressionMethodCall* expression = 
-      (ExpressionMethodCall*)CflatMalloc(sizeof(ExpressionMethodCall));
-   CflatInvokeCtor(ExpressionMethodCall, expression)(pMemberAccess);
+   const size_t functionRecordIndex =
+      getFunctionRecordIndex(pFunction, pFunction->mNamespace, nullptr, pFunction->mIdentifier);
+   beginCall(functionRecordIndex, pFunction->mProgram != nullptr);
+}
 
-   pContext.mTokenIndex++;
-   parseFunctionCallArguments(pContext, &expression->mArguments, &expression->mTemplateTypes);
+void Profiler::beginMethodCall(const Method* pMethod, const Type* pOwnerType)
+{
+   const size_t functionRecordIndex =
+      getFunctionRecordIndex(pMethod, nullptr, pOwnerType, pMethod->mIdentifier);
+   beginCall(functionRecordIndex, false);
+}
 
-   if(!mErrorMessage.empty())
-   {
-      return nullptr;
-   }
+void Profiler::endCall()
+{
+   // the profiler might have been reset in the middle of a call
+   if(mFrames.empty())
+      return;
 
-   ExpressionMemberAccess* memberAccess = static_cast<ExpressionMemberAccess*>(pMemberAccess);
-   const TypeUsage methodOwnerTypeUsage = getTypeUsage(pContext, memberAccess->mMemberOwner);
+   const uint64_t time = getTime();
+   const Frame frame = mFrames.back();
+   mFrames.pop_back();
 
-   Type* methodOwnerType = methodOwnerTypeUsage.mType;
-   CflatAssert(methodOwnerType);
-   CflatAssert(methodOwnerType->mCategory == TypeCategory::StructOrClass);
+   const uint64_t duration = time - frame.mStartTime;
 
-   CflatArgsVector(TypeUsage) argumentTypes;
+   FunctionRecord& functionRecord = mFunctionRecords[frame.mFunctionRecordIndex];
+   functionRecord.mExclusiveTime += duration - frame.mChildrenTime;
+   functionRecord.mActiveCallsCount--;
 
-   for(size_t i = 0u; i < expression->mArguments.size(); i++)
+   // recursive calls are already included in the outermost one
+   if(functionRecord.mActiveCallsCount == 0u)
    {
-      const TypeUsage typeUsage = getTypeUsage(pContext, expression->mArguments[i]);
-      argumentTypes.push_back(typeUsage);
+      functionRecord.mInclusiveTime += duration;
    }
 
-   CflatArgsVector(TypeUsage) templateTypes;
-   toArgsVector(expression->mTemplateTypes, templateTypes);
-
-   const Identifier& methodId = memberAccess->mMemberIdentifier;
-   expression->mMethod = findMethod(methodOwnerType, methodId, argumentTypes, templateTypes);
+   if(!mFrames.empty())
+   {
+      mFrames.back().mChildrenTime += duration;
+   }
 
-   if(!expression->mMethod)
+   if(frame.mScriptFunction)
    {
-      throwCompileError(pContext, CompileError::MissingMethod, methodId.mName);
+      chargeCurrentLine(time);
+      mCurrentLineRecordIndex = frame.mCallerLineRecordIndex;
    }
 
-   return expression;
+   if(mTraceEnabled)
+   {
+      TraceEvent traceEvent;
+      traceEvent.mFunctionRecordIndex = frame.mFunctionRecordIndex;
+      traceEvent.mStartTime = frame.mStartTime;
+      traceEvent.mDuration = duration;
+      traceEvent.mTrackIndex = 0u;
+      mTraceEvents.push_back(traceEvent);
+   }
 }
 
-Expression* Environment::parseExpressionObjectConstruction(ParsingContext& pContext, Type* pType)
+void Profiler::beginLine(const Program* pProgram, uint16_t pLine)
 {
-   ExpressionObjectConstruction* expression =
-      (ExpressionObjectConstruction*)CflatMalloc(sizeof(ExpressionObjectConstruction));
-   CflatInvokeCtor(ExpressionObjectConstruction, expression)(pType);
+   chargeCurrentLine(getTime());
 
-   parseFunctionCallArguments(pContext, &expression->mArguments);
+   const uint64_t lineKey = ((uint64_t)pProgram->mIdentifier.mHash << 16u) | (uint64_t)pLine;
+   LineRecordsRegistry::const_iterator it = mLineRecordsRegistry.find(lineKey);
 
-   if(!mErrorMessage.empty())
+   if(it != mLineRecordsRegistry.end())
    {
-      return nullptr;
+      mCurrentLineRecordIndex = it->second;
    }
-
-   CflatArgsVector(TypeUsage) argumentTypes;
-
-   for(size_t i = 0u; i < expression->mArguments.size(); i++)
+   else
    {
-      const TypeUsage typeUsage = getTypeUsage(pContext, expression->mArguments[i]);
-      argumentTypes.push_back(typeUsage);
+      LineRecord lineRecord;
+      lineRecord.mProgramIdentifier = pProgram->mIdentifier;
+      lineRecord.mLine = pLine;
+      lineRecord.mExecutionsCount = 0u;
+      lineRecord.mTime = 0u;
+
+      mCurrentLineRecordIndex = mLineRecords.size();
+      mLineRecords.push_back(lineRecord);
+      mLineRecordsRegistry[lineKey] = mCurrentLineRecordIndex;
    }
 
-   expression->mConstructor = findConstructor(pType, argumentTypes);
+   mLineRecords[mCurrentLineRecordIndex].mExecutionsCount++;
+}
 
-   if(!expression->mConstructor)
-   {
-      throwCompileError(pContext, CompileError::MissingConstructor);
-   }
+void Profiler::endLine()
+{
+   chargeCurrentLine(getTime());
+   mCurrentLineRecordIndex = SIZE_MAX;
+}
 
-   return expression;
+
+//
+//  Environment
+//
+Environment::Environment(Allocator* pAllocator)
+   : Environment(nullptr, pAllocator)
+{
 }
 
-size_t Environment::findClosureTokenIndex(ParsingContext& pContext, char pOpeningChar, char pClosureChar,
-   size_t pTokenIndexLimit)
+Environment::Environment(Environment* pBaseEnvironment, Allocator* pAllocator)
+   : mAllocator(pAllocator ? pAllocator : Memory::getDefaultAllocator())
+   , mTypesParsingContext(&mGlobalNamespace)
+   , mExecutionContext(&mGlobalNamespace)
+   , mGlobalNamespace("", nullptr, this)
+   , mExecutionHook(nullptr)
+   , mLineHook(nullptr)
+   , mSampledHook(nullptr)
+   , mSampledHookInterval(0u)
+   , mTimerHook(nullptr)
+   , mTimerHookInterval(0u)
+   , mFunctionHook(nullptr)
+   , mStatementHooksEnabled(false)
+   , mExecutionMode(ExecutionMode::SyntaxTree)
+   , mId(++gEnvironmentsCount)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t closureTokenIndex = 0u;
+   static_assert(kPreprocessorErrorStringsCount == (size_t)Environment::PreprocessorError::Count,
+      "Missing preprocessor error strings");
+   static_assert(kCompileErrorStringsCount == (size_t)Environment::CompileError::Count,
+      "Missing compile error strings");
+   static_assert(kRuntimeErrorStringsCount == (size_t)Environment::RuntimeError::Count,
+      "Missing runtime error strings");
+   static_assert(kOperatorTypeStringsCount == (size_t)OperatorType::Count,
+      "Missing operator strings");
 
-   if(pTokenIndexLimit == 0u)
-   {
-      pTokenIndexLimit = pContext.mTokens.size() - 1u;
-   }
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   if(tokens[pContext.mTokenIndex].mStart[0] == pClosureChar)
+   if(pBaseEnvironment)
    {
-      closureTokenIndex = pContext.mTokenIndex;
+      // the syntax trees of the programs point to the instances of the environment, so programs
+      // cannot be shared, and their instances would not make sense without them
+      CflatAssert(pBaseEnvironment->mPrograms.empty());
+
+      // the built-in types get shared as well, so all the types in use are the same ones
+      mGlobalNamespace.registerShared(&pBaseEnvironment->mGlobalNamespace);
+      mMacros = pBaseEnvironment->mMacros;
+      mExecutionMode = pBaseEnvironment->mExecutionMode;
    }
    else
    {
-      uint32_t scopeLevel = 0u;
-
-      for(size_t i = (pContext.mTokenIndex + 1u); i <= pTokenIndexLimit; i++)
-      {
-         if(tokens[i].mLength > 1u)
-         {
-            continue;
-         }
-
-         if(tokens[i].mStart[0] == pClosureChar)
-         {
-            if(scopeLevel == 0u)
-            {
-               closureTokenIndex = i;
-               break;
-            }
+      registerBuiltInTypes();
 
-            scopeLevel--;
-         }
-         else if(tokens[i].mStart[0] == pOpeningChar)
-         {
-            scopeLevel++;
-         }
-      }
+      registerType<BuiltInType>("auto");
+      registerType<BuiltInType>("void");
    }
 
-   return closureTokenIndex;
+   mTypeAuto = getType("auto");
+   mTypeVoid = getType("void");
+   mTypeInt32 = getType("int");
+   mTypeInt64 = getType("int64_t");
+   mTypeUInt32 = getType("uint32_t");
+   mTypeFloat = getType("float");
+   mTypeDouble = getType("double");
+
+   mTypeUsageSizeT = getTypeUsage("size_t");
+   mTypeUsageBool = getTypeUsage("bool");
+   mTypeUsageCString = getTypeUsage("const char*");
+   mTypeUsageVoidPtr = getTypeUsage("void*");
 }
 
-size_t Environment::findOpeningTokenIndex(ParsingContext& pContext, char pOpeningChar, char pClosureChar,
-   size_t pClosureIndex)
+Environment::~Environment()
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t openingTokenIndex = pClosureIndex;
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   if(openingTokenIndex > 0u)
+   while(!mExecutionContexts.empty())
    {
-      uint32_t scopeLevel = 0u;
-
-      for(int i = (int)pClosureIndex - 1; i >= (int)pContext.mTokenIndex; i--)
-      {
-         if(tokens[i].mLength > 1u)
-         {
-            continue;
-         }
-
-         if(tokens[i].mStart[0] == pOpeningChar)
-         {
-            if(scopeLevel == 0u)
-            {
-               openingTokenIndex = i;
-               break;
-            }
-
-            scopeLevel--;
-         }
-         else if(tokens[i].mStart[0] == pClosureChar)
-         {
-            scopeLevel++;
-         }
-      }
+      destroyExecutionContext(mExecutionContexts.back());
    }
 
-   return openingTokenIndex;
+   for(ProgramsRegistry::iterator it = mPrograms.begin(); it != mPrograms.end(); it++)
+   {
+      CflatInvokeDtor(Program, it->second);
+      CflatDeallocate(it->second);
+   }
 }
 
-size_t Environment::findSeparationTokenIndex(ParsingContext& pContext, char pSeparationChar,
-   size_t pClosureIndex)
+void Environment::defineMacro(const char* pDefinition, const char* pBody)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t separationTokenIndex = 0u;
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   uint32_t scopeLevel = 0u;
+   Macro macro;
 
-   for(size_t i = pContext.mTokenIndex; i < pClosureIndex; i++)
+   // process definition
+   const size_t definitionLength = strlen(pDefinition);
+
+   CflatSTLVector(CflatSTLString) parameters;
+   int8_t currentParameterIndex = -1;
+
+   for(size_t i = 0u; i < definitionLength; i++)
    {
-      if(tokens[i].mLength > 1u)
+      char currentChar = pDefinition[i];
+
+      if(currentChar == '(' || currentChar == ',')
       {
+         currentParameterIndex++;
+         parameters.emplace_back();
          continue;
       }
-
-      if(i > pContext.mTokenIndex && tokens[i].mStart[0] == pSeparationChar && scopeLevel == 0u)
+      else if(currentChar == ')')
       {
-         separationTokenIndex = i;
          break;
       }
 
-      if(tokens[i].mStart[0] == '(')
+      if(currentParameterIndex < 0)
       {
-         scopeLevel++;
+         macro.mName.push_back(currentChar);
       }
-      else if(tokens[i].mStart[0] == ')')
+      else if(currentChar != ' ' && currentChar != '\t')
       {
-         scopeLevel--;
+         parameters[currentParameterIndex].push_back(currentChar);
       }
    }
 
-   return separationTokenIndex;
-}
-
-uint8_t Environment::getBinaryOperatorPrecedence(ParsingContext& pContext, size_t pTokenIndex)
-{
-   const Token& token = pContext.mTokens[pTokenIndex];
-   CflatAssert(token.mType == TokenType::Operator);
+   macro.mParametersCount = (uint8_t)(currentParameterIndex + 1);
 
-   uint8_t precedence = 0u;
+   // process body
+   const size_t bodyLength = strlen(pBody);
 
-   for(size_t i = 0u; i < kCflatBinaryOperatorsCount; i++)
+   if(bodyLength > 0u)
    {
-      const size_t operatorLength = strlen(kCflatBinaryOperators[i]);
+      int bodyChunkIndex = -1;
 
-      if(token.mLength == operatorLength &&
-         strncmp(token.mStart, kCflatBinaryOperators[i], operatorLength) == 0)
+      for(size_t i = 0u; i < bodyLength; i++)
       {
-         precedence = kCflatBinaryOperatorsPrecedence[i];
-         break;
-      }
-   }
+         char currentChar = pBody[i];
+         bool anyParameterProcessed = false;
 
-   return precedence;
-}
+         // token pasting: the blanks around '##' get dropped, so the code on both sides is joined
+         if(currentChar == '#' && pBody[i + 1u] == '#')
+         {
+            if(bodyChunkIndex >= 0 && macro.mBody[bodyChunkIndex][0] != '$')
+            {
+               CflatSTLString& bodyChunk = macro.mBody[bodyChunkIndex];
 
-bool Environment::isTemplate(ParsingContext& pContext, size_t pOpeningTokenIndex, size_t pClosureTokenIndex)
-{
-   if(pClosureTokenIndex <= pOpeningTokenIndex)
-      return false;
+               while(!bodyChunk.empty() && (bodyChunk.back() == ' ' || bodyChunk.back() == '\t'))
+               {
+                  bodyChunk.pop_back();
+               }
 
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
+               if(bodyChunk.empty())
+               {
+                  macro.mBody.pop_back();
+                  bodyChunkIndex--;
+               }
+            }
 
-   const Token& openingToken = tokens[pOpeningTokenIndex];
+            i++;
 
-   if(openingToken.mLength != 1u || openingToken.mStart[0] != '<')
-      return false;
+            while(pBody[i + 1u] == ' ' || pBody[i + 1u] == '\t')
+            {
+               i++;
+            }
 
-   const Token& closureToken = tokens[pClosureTokenIndex];
+            continue;
+         }
 
-   if(closureToken.mLength != 1u || closureToken.mStart[0] != '>')
-      return false;
+         for(uint8_t j = 0u; j < macro.mParametersCount; j++)
+         {
+            const size_t parameterLength = parameters[j].length();
 
-   for(size_t i = pOpeningTokenIndex + 1u; i < pClosureTokenIndex; i++)
-   {
-      if(tokens[i].mType == TokenType::Operator)
-      {
-         const bool isPointerOperator =
-            tokens[i].mLength == 1u &&
-            tokens[i].mStart[0] == '*' &&
-            tokens[i - 1u].mType == TokenType::Identifier;
+            // parameters are only replaced where they appear as whole identifiers
+            if(parameterLength > 0u &&
+               strncmp(pBody + i, parameters[j].c_str(), parameterLength) == 0 &&
+               !isalnum(pBody[i + parameterLength]) && pBody[i + parameterLength] != '_' &&
+               (i == 0u || (!isalnum(pBody[i - 1u]) && pBody[i - 1u] != '_')))
+            {
+               MacroArgumentType argumentType = MacroArgumentType::Default;
 
-         if(!isPointerOperator)
-            return false;
+               if(i >= 2u && pBody[i - 1u] == '#' && pBody[i - 2u] == '#')
+               {
+                  argumentType = MacroArgumentType::TokenPaste;
+               }
+               else if(i >= 1u && pBody[i - 1u] == '#')
+               {
+                  argumentType = MacroArgumentType::Stringize;
+               }
+
+               macro.mBody.emplace_back();
+               bodyChunkIndex++;
+
+               // argument char ('$')
+               macro.mBody[bodyChunkIndex].push_back('$');
+               // parameter index (1, 2, 3, etc.)
+               macro.mBody[bodyChunkIndex].push_back((char)('1' + (char)j));
+               // argument type (0: Default, 1: Stringize, 2: TokenPaste)
+               macro.mBody[bodyChunkIndex].push_back((char)('0' + (char)argumentType));
+
+               i += parameterLength - 1u;
+
+               anyParameterProcessed = true;
+               break;
+            }
+         }
+
+         if(!anyParameterProcessed && currentChar != '#')
+         {
+            if(macro.mBody.empty() || macro.mBody[macro.mBody.size() - 1u][0] == '$')
+            {
+               macro.mBody.emplace_back();
+               bodyChunkIndex++;
+            }
+
+            macro.mBody[bodyChunkIndex].push_back(currentChar);
+         }
       }
    }
 
-   return true;
+   // register macro in the environment, replacing the previous definition if there is one
+   mMacros[hash(macro.mName.c_str())] = macro;
 }
 
-bool Environment::isTemplate(ParsingContext& pContext, size_t pTokenLastIndex)
+void Environment::updateStatementHooks()
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+   mStatementHooksEnabled =
+      mExecutionHook || mLineHook || mSampledHook || mTimerHook;
+}
 
-   if(tokens[tokenIndex].mLength != 1u || tokens[tokenIndex].mStart[0] != '<')
-      return false;
+void Environment::executeStatementHooks(ExecutionContext& pContext, const Statement* pStatement)
+{
+   if(mExecutionHook)
+   {
+      mExecutionHook(this, pContext.mCallStack);
+   }
 
-   const size_t templateClosureTokenIndex =
-      findClosureTokenIndex(pContext, '<', '>', pTokenLastIndex);
+   if(mLineHook)
+   {
+      // returning to the line a function got called from also counts as a line change
+      const size_t callDepth = pContext.mCallStack.size();
 
-   return isTemplate(pContext, tokenIndex, templateClosureTokenIndex);
-}
+      if(pStatement->mLine != pContext.mLineHookLine ||
+         pStatement->mProgram != pContext.mLineHookProgram ||
+         callDepth != pContext.mLineHookCallDepth)
+      {
+         pContext.mLineHookProgram = pStatement->mProgram;
+         pContext.mLineHookLine = pStatement->mLine;
+         pContext.mLineHookCallDepth = callDepth;
 
-bool Environment::isCastAllowed(CastType pCastType, const TypeUsage& pFrom, const TypeUsage& pTo)
-{
-   bool castAllowed = false;
+         mLineHook(this, pContext.mCallStack);
+      }
+   }
 
-   switch(pCastType)
+   if(mSampledHook && ++pContext.mSampledHookCounter >= mSampledHookInterval)
    {
-   case CastType::CStyle:
-   case CastType::Static:
-      if(pFrom.mType->mCategory == TypeCategory::BuiltIn &&
-         pTo.mType->mCategory == TypeCategory::BuiltIn)
+      pContext.mSampledHookCounter = 0u;
+      mSampledHook(this, pContext.mCallStack);
+   }
+
+   if(mTimerHook && ++pContext.mTimerHookCounter >= kTimerHookCheckInterval)
+   {
+      pContext.mTimerHookCounter = 0u;
+
+      const uint64_t time = getTime();
+
+      if(pContext.mTimerHookTime == 0u)
       {
-         castAllowed = true;
+         pContext.mTimerHookTime = time;
       }
-      else if(pFrom.mType->mCategory == TypeCategory::StructOrClass &&
-         pFrom.isPointer() &&
-         pTo.mType->mCategory == TypeCategory::StructOrClass &&
-         pTo.isPointer())
+      else if((time - pContext.mTimerHookTime) >= mTimerHookInterval)
       {
-         Struct* sourceType = static_cast<Struct*>(pFrom.mType);
-         Struct* targetType = static_cast<Struct*>(pTo.mType);
-         castAllowed =
-            sourceType->derivedFrom(targetType) || targetType->derivedFrom(sourceType);
+         pContext.mTimerHookTime = time;
+         mTimerHook(this, pContext.mCallStack);
       }
-      break;
-   case CastType::Dynamic:
-      castAllowed =
-         pFrom.isPointer() &&
-         pFrom.mType->mCategory == TypeCategory::StructOrClass &&
-         pTo.isPointer() &&
-         pTo.mType->mCategory == TypeCategory::StructOrClass;
-      break;
-   case CastType::Reinterpret:
-      castAllowed =
-         pFrom.isPointer() &&
-         pTo.isPointer();
-      break;
-   default:
-      break;
    }
 
-   return castAllowed;
+   if(pContext.mProfiler)
+   {
+      pContext.mProfiler->beginLine(pStatement->mProgram, pStatement->mLine);
+   }
 }
 
-Statement* Environment::parseStatement(ParsingContext& pContext)
+void Environment::resetTimerHook(ExecutionContext& pContext)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
+   pContext.mTimerHookCounter = 0u;
+   pContext.mTimerHookTime = getTime();
+}
 
-   Statement* statement = nullptr;
-   const uint16_t statementLine = token.mLine;
+void Environment::buildSwitchCaseLookup(ParsingContext& pContext, StatementSwitch* pStatement)
+{
+   pStatement->mSortedCases.clear();
+   pStatement->mJumpTable.clear();
+   pStatement->mCaseLookup = false;
 
-   if(token.mType == TokenType::Punctuation && (token.mStart[0] == '{' || token.mStart[0] == '}'))
-   {
-      // block
-      if(token.mStart[0] == '{')
-      {
-         statement = parseStatementBlock(pContext, true, false);
-      }
-   }
-   else if(token.mType == TokenType::Keyword &&
-      strncmp(token.mStart, "const", 5u) != 0 &&
-      strncmp(token.mStart, "static", 6u) != 0 &&
-      strncmp(token.mStart, "void", 4u) != 0)
+   const size_t caseSectionsCount = pStatement->mCaseSections.size();
+   size_t defaultCaseSectionIndex = caseSectionsCount;
+
+   CflatSTLVector(StatementSwitch::CaseLookupEntry) caseLookupEntries;
+   caseLookupEntries.reserve(caseSectionsCount);
+
+   for(size_t i = 0u; i < caseSectionsCount; i++)
    {
-      // if
-      if(strncmp(token.mStart, "if", 2u) == 0)
-      {
-         tokenIndex++;
-         statement = parseStatementIf(pContext);
-      }
-      // switch
-      else if(strncmp(token.mStart, "switch", 6u) == 0)
-      {
-         tokenIndex++;
-         statement = parseStatementSwitch(pContext);
-      }
-      // while
-      else if(strncmp(token.mStart, "while", 5u) == 0)
+      Expression* caseExpression = pStatement->mCaseSections[i].mExpression;
+
+      if(!caseExpression)
       {
-         tokenIndex++;
-         statement = parseStatementWhile(pContext);
+         defaultCaseSectionIndex = min(defaultCaseSectionIndex, i);
+         continue;
       }
-      // do
-      else if(strncmp(token.mStart, "do", 2u) == 0)
+
+      const Value* caseValue = getConstantValue(pContext, caseExpression);
+
+      if(!caseValue)
       {
-         tokenIndex++;
-         statement = parseStatementDoWhile(pContext);
+         return;
       }
-      // for
-      else if(strncmp(token.mStart, "for", 3u) == 0)
+
+      // the sections get checked in order, and the execution starts from the default section
+      // if it comes before the matching one
+      StatementSwitch::CaseLookupEntry caseLookupEntry;
+      caseLookupEntry.mValue = getValueAsInteger(*caseValue);
+      caseLookupEntry.mCaseSectionIndex = min(defaultCaseSectionIndex, i);
+      caseLookupEntries.push_back(caseLookupEntry);
+   }
+
+   // for repeated values, the first section keeps taking precedence
+   std::stable_sort(caseLookupEntries.begin(), caseLookupEntries.end(),
+      [](const StatementSwitch::CaseLookupEntry& pA, const StatementSwitch::CaseLookupEntry& pB)
       {
-         tokenIndex++;
-         statement = parseStatementFor(pContext);
-      }
-      // break
-      else if(strncmp(token.mStart, "break", 5u) == 0)
+         return pA.mValue < pB.mValue;
+      });
+   caseLookupEntries.erase(std::unique(caseLookupEntries.begin(), caseLookupEntries.end(),
+      [](const StatementSwitch::CaseLookupEntry& pA, const StatementSwitch::CaseLookupEntry& pB)
       {
-         tokenIndex++;
-         statement = parseStatementBreak(pContext);
-      }
-      // continue
-      else if(strncmp(token.mStart, "continue", 8u) == 0)
+         return pA.mValue == pB.mValue;
+      }), caseLookupEntries.end());
+
+   pStatement->mDefaultCaseSectionIndex = defaultCaseSectionIndex;
+   pStatement->mCaseLookup = true;
+
+   if(caseLookupEntries.empty())
+   {
+      return;
+   }
+
+   // the table is used as long as it does not take more than four slots per case
+   const uint64_t valuesRange =
+      (uint64_t)caseLookupEntries.back().mValue - (uint64_t)caseLookupEntries.front().mValue;
+
+   if(valuesRange < (uint64_t)caseLookupEntries.size() * 4u)
+   {
+      pStatement->mJumpTableFirstValue = caseLookupEntries.front().mValue;
+      pStatement->mJumpTable.resize((size_t)valuesRange + 1u, defaultCaseSectionIndex);
+
+      for(size_t i = 0u; i < caseLookupEntries.size(); i++)
       {
-         tokenIndex++;
-         statement = parseStatementContinue(pContext);
-      }
-      // return
-      else if(strncmp(token.mStart, "return", 6u) == 0)
-      {
-         tokenIndex++;
-         statement = parseStatementReturn(pContext);
-      }
-      // using
-      else if(strncmp(token.mStart, "using", 5u) == 0)
-      {
-         tokenIndex++;
-         statement = parseStatementUsingDirective(pContext);
-      }
-      // struct
-      else if(strncmp(token.mStart, "struct", 6u) == 0)
-      {
-         tokenIndex++;
-         statement = parseStatementStructDeclaration(pContext);
-      }
-      // namespace
-      else if(strncmp(token.mStart, "namespace", 9u) == 0)
-      {
-         tokenIndex++;
-         statement = parseStatementNamespaceDeclaration(pContext);
-      }
-      // typedef
-      else if(strncmp(token.mStart, "typedef", 7u) == 0)
-      {
-         tokenIndex++;
-         statement = parseStatementTypeDefinition(pContext);
-      }
-      // (unexpected)
-      else
-      {
-         throwCompileErrorUnexpectedSymbol(pContext);
+         const uint64_t offset =
+            (uint64_t)caseLookupEntries[i].mValue - (uint64_t)pStatement->mJumpTableFirstValue;
+         pStatement->mJumpTable[(size_t)offset] = caseLookupEntries[i].mCaseSectionIndex;
       }
    }
    else
    {
-      // static?
-      bool staticDeclaration = false;
-
-      if(strncmp(token.mStart, "static", 6u) == 0)
-      {
-         staticDeclaration = true;
-         tokenIndex++;
-      }
-
-      // type
-      TypeUsage typeUsage = parseTypeUsage(pContext, 0u);
-
-      if(typeUsage.mType)
-      {
-         const Token& identifierToken = tokens[tokenIndex];
-         pContext.mStringBuffer.assign(identifierToken.mStart, identifierToken.mLength);
-         const Identifier identifier(pContext.mStringBuffer.c_str());
-         tokenIndex++;
-
-         if(tokens[tokenIndex].mType != TokenType::Operator &&
-            tokens[tokenIndex].mType != TokenType::Punctuation)
-         {
-            pContext.mStringBuffer.assign(token.mStart, token.mLength);
-            throwCompileError(pContext, CompileError::UnexpectedSymbol, pContext.mStringBuffer.c_str());
-            return nullptr;
-         }
-
-         bool isFunctionDeclaration = tokens[tokenIndex].mStart[0] == '(';
-
-         if(isFunctionDeclaration)
-         {
-            const size_t nextSemicolonIndex = findClosureTokenIndex(pContext, 0, ';');
-            const size_t nextBracketIndex = findClosureTokenIndex(pContext, 0, '{');
-               
-            if(nextBracketIndex == 0u ||
-               (nextSemicolonIndex > 0u && nextSemicolonIndex < nextBracketIndex))
-            {
-               // object construction
-               isFunctionDeclaration = false;
-            }
-         }
-
-         // function declaration
-         if(isFunctionDeclaration)
-         {
-            tokenIndex--;
-            statement = parseStatementFunctionDeclaration(pContext, typeUsage);
-         }
-         // variable / const declaration
-         else
-         {
-            if(typeUsage.mType != mTypeVoid || typeUsage.mPointerLevel > 0u)
-            {
-               statement =
-                  parseStatementVariableDeclaration(pContext, typeUsage, identifier, staticDeclaration);
-            }
-            else
-            {
-               throwCompileError(pContext, Environment::CompileError::InvalidType, "void");
-            }
-         }
-      }
-      // expression
-      else
-      {
-         const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+      pStatement->mSortedCases.swap(caseLookupEntries);
+   }
+}
 
-         if(closureTokenIndex == 0u)
-         {
-            throwCompileError(pContext, CompileError::Expected, ";");
-            return nullptr;
-         }
+void Environment::registerBuiltInTypes()
+{
+   CflatRegisterBuiltInType(this, int);
+   CflatRegisterBuiltInType(this, int32_t);
+   CflatRegisterBuiltInType(this, uint32_t);
+   CflatRegisterBuiltInType(this, size_t);
+   CflatRegisterBuiltInType(this, char);
+   CflatRegisterBuiltInType(this, bool);
+   CflatRegisterBuiltInType(this, int8_t);
+   CflatRegisterBuiltInType(this, uint8_t);
+   CflatRegisterBuiltInType(this, short);
+   CflatRegisterBuiltInType(this, int16_t);
+   CflatRegisterBuiltInType(this, uint16_t);
+   CflatRegisterBuiltInType(this, int64_t);
+   CflatRegisterBuiltInType(this, uint64_t);
+   CflatRegisterBuiltInType(this, float);
+   CflatRegisterBuiltInType(this, double);
+}
 
-         Expression* expression = parseExpression(pContext, closureTokenIndex - 1u);
-         tokenIndex = closureTokenIndex;
+TypeUsage Environment::parseTypeUsage(ParsingContext& pContext, size_t pTokenLastIndex)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   size_t cachedTokenIndex = tokenIndex;
 
-         statement = (StatementExpression*)CflatMalloc(sizeof(StatementExpression));
-         CflatInvokeCtor(StatementExpression, statement)(expression);
-      }
-   }
+   TypeUsage typeUsage;
+   char baseTypeName[kDefaultLocalStringBufferSize];
 
-   if(statement)
+   if(tokens[tokenIndex].mType == TokenType::Keyword &&
+      strncmp(tokens[tokenIndex].mStart, "const", 5u) == 0)
    {
-      statement->mProgram = pContext.mProgram;
-      statement->mLine = statementLine;
+      CflatSetFlag(typeUsage.mFlags, TypeUsageFlags::Const);
+      tokenIndex++;
    }
 
-   return statement;
-}
+   pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
 
-StatementBlock* Environment::parseStatementBlock(ParsingContext& pContext,
-   bool pAlterScope, bool pAllowInGlobalScope)
-{
-   if(!pAllowInGlobalScope && pContext.mScopeLevel == 0u)
+   while(tokenIndex < (tokens.size() - 1u) &&
+      tokens[tokenIndex + 1u].mLength == 2u &&
+      strncmp(tokens[tokenIndex + 1u].mStart, "::", 2u) == 0)
    {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
+      tokenIndex += 2u;
+      pContext.mStringBuffer.append("::");
+      pContext.mStringBuffer.append(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
    }
 
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
+   strcpy(baseTypeName, pContext.mStringBuffer.c_str());
+   const Identifier baseTypeIdentifier(baseTypeName);
+   CflatArgsVector(TypeUsage) templateTypes;
 
-   if(token.mStart[0] != '{')
+   if(tokenIndex < (tokens.size() - 1u) && tokens[tokenIndex + 1u].mStart[0] == '<')
    {
-      throwCompileError(pContext, CompileError::Expected, "{");
-      return nullptr;
-   }
-
-   StatementBlock* block = (StatementBlock*)CflatMalloc(sizeof(StatementBlock));
-   CflatInvokeCtor(StatementBlock, block)(pAlterScope);
+      tokenIndex += 2u;
+      const size_t closureTokenIndex = findClosureTokenIndex(pContext, '<', '>');
 
-   const size_t closureTokenIndex = findClosureTokenIndex(pContext, '{', '}');
+      if((pTokenLastIndex == 0u || closureTokenIndex <= pTokenLastIndex) &&
+         isTemplate(pContext, tokenIndex - 1u, closureTokenIndex))
+      {
+         while(tokenIndex < closureTokenIndex)
+         {
+            templateTypes.push_back(parseTypeUsage(pContext, closureTokenIndex - 1u));
+            tokenIndex++;
+         }
 
-   if(closureTokenIndex > 0u)
+         tokenIndex = closureTokenIndex;
+      }
+   }
+   
+   for(size_t i = 0u; i < pContext.mTypeAliases.size(); i++)
    {
-      incrementBlockLevel(pContext);
-
-      if(pAlterScope)
+      if(pContext.mTypeAliases[i].mIdentifier == baseTypeIdentifier)
       {
-         incrementScopeLevel(pContext);
-         incrementScopeLevel(mExecutionContext);
+         typeUsage = pContext.mTypeAliases[i].mTypeUsage;
+         break;
       }
+   }
 
-      while(tokenIndex < closureTokenIndex)
+   if(!typeUsage.mType)
+   {
+      for(int i = (int)pContext.mLocalNamespaceStack.size() - 1; i >= 0; i--)
       {
-         tokenIndex++;
-         Statement* statement = parseStatement(pContext);
+         Namespace* ns = pContext.mLocalNamespaceStack[i].mNamespace;
+         typeUsage.mType = ns->getType(baseTypeIdentifier, templateTypes);
 
-         if(!mErrorMessage.empty())
+         if(typeUsage.mType)
          {
             break;
          }
+      }
+   }
 
-         if(statement)
+   if(!typeUsage.mType)
+   {
+      for(int i = (int)pContext.mNamespaceStack.size() - 1; i >= 0; i--)
+      {
+         Namespace* ns = pContext.mNamespaceStack[i];
+         const TypeAlias* typeAlias = ns->getTypeAlias(baseTypeIdentifier);
+
+         if(typeAlias)
          {
-            block->mStatements.push_back(statement);
+            typeUsage = typeAlias->mTypeUsage;
+            break;
          }
       }
 
-      if(pAlterScope)
+      if(!typeUsage.mType)
       {
-         decrementScopeLevel(mExecutionContext);
-         decrementScopeLevel(pContext);
+         typeUsage.mType = findType(pContext, baseTypeIdentifier, templateTypes);
       }
-
-      decrementBlockLevel(pContext);
-   }
-   else
-   {
-      throwCompileError(pContext, CompileError::Expected, "}");
    }
 
-   if(mErrorMessage.empty())
+   if(typeUsage.mType)
    {
-      block->mProgram = pContext.mProgram;
-      block->mLine = token.mLine;
+      if(tokenIndex < (tokens.size() - 1u) && *tokens[tokenIndex + 1u].mStart == '&')
+      {
+         CflatSetFlag(typeUsage.mFlags, TypeUsageFlags::Reference);
+         tokenIndex++;
+      }
+
+      while(tokenIndex < (tokens.size() - 1u) && *tokens[tokenIndex + 1u].mStart == '*')
+      {
+         typeUsage.mPointerLevel++;
+         tokenIndex++;
+      }
+
+      tokenIndex++;
    }
    else
    {
-      CflatInvokeDtor(StatementBlock, block);
-      CflatFree(block);
-      block = nullptr;
+      tokenIndex = cachedTokenIndex;
    }
 
-   return block;
+   return typeUsage;
 }
 
-StatementUsingDirective* Environment::parseStatementUsingDirective(ParsingContext& pContext)
+void Environment::throwPreprocessorError(ParsingContext& pContext, PreprocessorError pError,
+   size_t pCursor, const char* pArg)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
+   char errorMsg[kDefaultLocalStringBufferSize];
+   sprintf(errorMsg, kPreprocessorErrorStrings[(int)pError], pArg);
 
-   StatementUsingDirective* statement = nullptr;
-   const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+   const char* code = pContext.mCode;
+   uint16_t line = 1u;
 
-   if(closureTokenIndex > 0u)
+   for(size_t i = 0u; i < pCursor; i++)
    {
-      if(strncmp(token.mStart, "namespace", 9u) == 0)
+      if(code[i] == '\n')
       {
-         tokenIndex++;
-         Token& namespaceToken = const_cast<Token&>(pContext.mTokens[tokenIndex]);
-         pContext.mStringBuffer.clear();
+         line++;
+      }
+   }
 
-         do
-         {
-            pContext.mStringBuffer.append(namespaceToken.mStart, namespaceToken.mLength);
-            tokenIndex++;
-            namespaceToken = tokens[tokenIndex];
-         }
-         while(*namespaceToken.mStart != ';');
+   char lineAsString[16];
+   sprintf(lineAsString, "%d", line);
 
-         const Identifier identifier(pContext.mStringBuffer.c_str());
-         Namespace* ns = nullptr;
+   mErrorMessage.assign("[Preprocessor Error] '");
+   mErrorMessage.append(pContext.mProgram->mIdentifier.mName);
+   mErrorMessage.append("' -- Line ");
+   mErrorMessage.append(lineAsString);
+   mErrorMessage.append(": ");
+   mErrorMessage.append(errorMsg);
+}
 
-         for(int i = (int)pContext.mNamespaceStack.size() - 1; i >= 0; i--)
-         {
-            ns = pContext.mNamespaceStack[i]->getNamespace(identifier);
+void Environment::throwCompileError(ParsingContext& pContext, CompileError pError,
+   const char* pArg1, const char* pArg2)
+{
+   if(!mErrorMessage.empty())
+      return;
 
-            if(ns)
-            {
-               break;
-            }
-         }
+   const Token& token = pContext.mTokenIndex < pContext.mTokens.size()
+      ? pContext.mTokens[pContext.mTokenIndex]
+      : pContext.mTokens[pContext.mTokens.size() - 1u];
 
-         if(ns)
-         {
-            UsingDirective usingDirective(ns);
-            usingDirective.mBlockLevel = pContext.mBlockLevel;
-            pContext.mUsingDirectives.push_back(usingDirective);
+   char errorMsg[kDefaultLocalStringBufferSize];
+   sprintf(errorMsg, kCompileErrorStrings[(int)pError], pArg1, pArg2);
 
-            statement = (StatementUsingDirective*)CflatMalloc(sizeof(StatementUsingDirective));
-            CflatInvokeCtor(StatementUsingDirective, statement)(ns);
-         }
-         else
-         {
-            throwCompileError(pContext, CompileError::UnknownNamespace, identifier.mName);
-         }
-      }
-      else if(tokenIndex < closureTokenIndex && tokens[tokenIndex].mType == TokenType::Identifier)
-      {
-         const size_t equalTokenIndex = findClosureTokenIndex(pContext, 0, '=', closureTokenIndex);
+   char lineAsString[16];
+   sprintf(lineAsString, "%d", token.mLine);
 
-         if(equalTokenIndex > 0u)
-         {
-            pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-            const Identifier alias(pContext.mStringBuffer.c_str());
-            tokenIndex++;
+   mErrorMessage.assign("[Compile Error] '");
+   mErrorMessage.append(pContext.mProgram->mIdentifier.mName);
+   mErrorMessage.append("' -- Line ");
+   mErrorMessage.append(lineAsString);
+   mErrorMessage.append(": ");
+   mErrorMessage.append(errorMsg);
+}
 
-            if(tokenIndex == equalTokenIndex)
-            {
-               tokenIndex++;
+void Environment::throwCompileErrorUnexpectedSymbol(ParsingContext& pContext)
+{
+   const Token& token = pContext.mTokens[pContext.mTokenIndex];
+   pContext.mStringBuffer.assign(token.mStart, token.mLength);
+   throwCompileError(pContext, CompileError::UnexpectedSymbol, pContext.mStringBuffer.c_str());
+}
 
-               const TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+const Macro* Environment::findMacro(const Token& pToken)
+{
+   MacrosRegistry::const_iterator it = mMacros.find(hash(pToken.mStart, pToken.mLength));
 
-               if(typeUsage.mType && tokenIndex == closureTokenIndex)
-               {
-                  registerTypeAlias(pContext, alias, typeUsage);
+   if(it == mMacros.end() ||
+      it->second.mName.length() != pToken.mLength ||
+      strncmp(it->second.mName.c_str(), pToken.mStart, pToken.mLength) != 0)
+   {
+      return nullptr;
+   }
 
-                  statement = (StatementUsingDirective*)CflatMalloc(sizeof(StatementUsingDirective));
-                  CflatInvokeCtor(StatementUsingDirective, statement)(alias, typeUsage);
-               }
-               else
-               {
-                  throwCompileErrorUnexpectedSymbol(pContext);
-               }
-            }
-            else
-            {
-               throwCompileErrorUnexpectedSymbol(pContext);
-            }
-         }
-         else
+   return &it->second;
+}
+
+void Environment::preprocess(ParsingContext& pContext, const char* pCode)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+
+   pContext.mCode = pCode;
+
+   // comments and carriage returns are skipped by the tokenizer, so code without directives
+   // gets tokenized straight away unless there are macros to look for
+   if(mMacros.empty() && !strchr(pCode, '#'))
+   {
+      Tokenizer::tokenize(pCode, tokens);
+      matchBrackets(pContext);
+      return;
+   }
+
+   tokens.clear();
+
+   // directives and macros are processed as the code gets tokenized, so the tokens point into
+   // the source code, and only the code resulting from macro expansions gets stored elsewhere
+   const char* cursor = pCode;
+   uint16_t currentLine = 1u;
+
+   while(Tokenizer::skipBlanks(cursor, currentLine))
+   {
+      if(*cursor == '#')
+      {
+         if(!preprocessDirective(pContext, cursor))
          {
-            const TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+            return;
+         }
 
-            if(typeUsage.mType && tokenIndex == closureTokenIndex && typeUsage.mFlags == 0u)
-            {
-               const Identifier& alias = typeUsage.mType->mIdentifier;
-               registerTypeAlias(pContext, alias, typeUsage);
+         continue;
+      }
 
-               statement = (StatementUsingDirective*)CflatMalloc(sizeof(StatementUsingDirective));
-               CflatInvokeCtor(StatementUsingDirective, statement)(alias, typeUsage);
-            }
-            else
+      const Token token = Tokenizer::readToken(cursor, currentLine);
+
+      if(token.mType == TokenType::Identifier || token.mType == TokenType::Keyword)
+      {
+         const Macro* macro = !mMacros.empty() ? findMacro(token) : nullptr;
+
+         if(macro)
+         {
+            if(!expandMacro(pContext, *macro, token, cursor, currentLine))
             {
-               throwCompileErrorUnexpectedSymbol(pContext);
+               return;
             }
+
+            continue;
          }
       }
-      else
-      {
-         throwCompileError(pContext, CompileError::UnexpectedSymbol, "using");
-      }
 
-      tokenIndex = closureTokenIndex;
-   }
-   else
-   {
-      throwCompileError(pContext, CompileError::Expected, ";");
+      tokens.push_back(token);
    }
 
-   return statement;
+   matchBrackets(pContext);
 }
 
-StatementTypeDefinition* Environment::parseStatementTypeDefinition(ParsingContext& pContext)
+bool Environment::preprocessDirective(ParsingContext& pContext, const char*& pCursor)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+   pCursor++;
 
-   StatementTypeDefinition* statement = nullptr;
-   const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+   while(*pCursor == ' ' || *pCursor == '\t')
+   {
+      pCursor++;
+   }
 
-   if(closureTokenIndex > 0u)
+   // #include (valid, but ignored)
+   if(strncmp(pCursor, "include", 7u) == 0)
    {
-      const TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+      pCursor += 7u;
+   }
+   // #ifdef (valid, but ignored)
+   else if(strncmp(pCursor, "ifdef", 5u) == 0)
+   {
+      pCursor += 5u;
+   }
+   // #if (valid, but ignored)
+   else if(strncmp(pCursor, "if", 2u) == 0)
+   {
+      pCursor += 2u;
+   }
+   // #pragma (valid, but ignored)
+   else if(strncmp(pCursor, "pragma", 6u) == 0)
+   {
+      pCursor += 6u;
+   }
+   // #define
+   else if(strncmp(pCursor, "define", 6u) == 0)
+   {
+      pCursor += 6u;
 
-      if(typeUsage.mType)
+      if(*pCursor != ' ' && *pCursor != '\t')
       {
-         if(tokenIndex == (closureTokenIndex - 1u) && tokens[tokenIndex].mType == TokenType::Identifier)
-         {
-            pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-            const Identifier alias(pContext.mStringBuffer.c_str());
-            registerTypeAlias(pContext, alias, typeUsage);
+         throwPreprocessorError(pContext, PreprocessorError::InvalidPreprocessorDirective,
+            pCursor - pContext.mCode);
+         return false;
+      }
 
-            statement = (StatementTypeDefinition*)CflatMalloc(sizeof(StatementTypeDefinition));
-            CflatInvokeCtor(StatementTypeDefinition, statement)(alias, typeUsage);
-         }
-         else
-         {
-            throwCompileErrorUnexpectedSymbol(pContext);
-         }
+      while(*pCursor == ' ' || *pCursor == '\t')
+      {
+         pCursor++;
       }
-      else
+
+      if(*pCursor == '\n' || *pCursor == '\0')
       {
-         pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-         throwCompileError(pContext, CompileError::UndefinedType, pContext.mStringBuffer.c_str());
+         throwPreprocessorError(pContext, PreprocessorError::InvalidPreprocessorDirective,
+            pCursor - pContext.mCode);
+         return false;
       }
 
-      tokenIndex = closureTokenIndex;
-   }
-   else
-   {
-      throwCompileError(pContext, CompileError::Expected, ";");
-   }
+      char macroDefinition[kDefaultLocalStringBufferSize];
+      size_t macroCursor = 0u;
+      bool parametersList = false;
 
-   return statement;
-}
+      // the list of parameters can contain blanks between them
+      while((parametersList || (*pCursor != ' ' && *pCursor != '\t')) &&
+         *pCursor != '\n' &&
+         *pCursor != '\0')
+      {
+         if(*pCursor == '(')
+         {
+            parametersList = true;
+         }
+         else if(*pCursor == ')')
+         {
+            parametersList = false;
+         }
 
-StatementNamespaceDeclaration* Environment::parseStatementNamespaceDeclaration(ParsingContext& pContext)
-{
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
+         macroDefinition[macroCursor++] = *pCursor++;
+      }
 
-   StatementNamespaceDeclaration* statement = nullptr;
+      macroDefinition[macroCursor] = '\0';
 
-   if(token.mType == TokenType::Identifier)
-   {
-      pContext.mStringBuffer.assign(token.mStart, token.mLength);
-      const Identifier nsIdentifier(pContext.mStringBuffer.c_str());
+      while(*pCursor == ' ' || *pCursor == '\t')
+      {
+         pCursor++;
+      }
 
-      Namespace* ns = pContext.mNamespaceStack.back()->requestNamespace(nsIdentifier);
-      pContext.mNamespaceStack.push_back(ns);
-      mExecutionContext.mNamespaceStack.push_back(ns);
+      char macroBody[kDefaultLocalStringBufferSize];
+      macroCursor = 0u;
 
-      statement = (StatementNamespaceDeclaration*)CflatMalloc(sizeof(StatementNamespaceDeclaration));
-      CflatInvokeCtor(StatementNamespaceDeclaration, statement)(nsIdentifier);
+      while(*pCursor != '\n' && *pCursor != '\0')
+      {
+         macroBody[macroCursor++] = *pCursor++;
+      }
 
-      tokenIndex++;
-      statement->mBody = parseStatementBlock(pContext, false, true);
+      macroBody[macroCursor] = '\0';
 
-      mExecutionContext.mNamespaceStack.pop_back();
-      pContext.mNamespaceStack.pop_back();
+      defineMacro(macroDefinition, macroBody);
+
+      pContext.mMacroDefinitions.emplace_back(macroDefinition);
+      pContext.mMacroDefinitions.emplace_back(macroBody);
    }
    else
    {
-      throwCompileError(pContext, CompileError::UnexpectedSymbol, "namespace");
+      throwPreprocessorError(pContext, PreprocessorError::InvalidPreprocessorDirective,
+         pCursor - pContext.mCode);
+      return false;
    }
 
-   return statement;
+
+   while(*pCursor != '\n' && *pCursor != '\0')
+   {
+      pCursor++;
+   }
+
+   return true;
 }
 
-StatementVariableDeclaration* Environment::parseStatementVariableDeclaration(ParsingContext& pContext,
-   TypeUsage& pTypeUsage, const Identifier& pIdentifier, bool pStatic)
+bool Environment::expandMacro(ParsingContext& pContext, const Macro& pMacro, const Token& pNameToken,
+   const char*& pCursor, uint16_t& pLine)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
-
-   StatementVariableDeclaration* statement = nullptr;
+   struct MacroArgument
+   {
+      const char* mStart;
+      size_t mLength;
+   };
+   CflatSTLVector(MacroArgument) arguments;
 
-   bool instanceAlreadyRegistered = false;
+   // parse arguments, which span from their first token to their last one in the source code
+   const char* cursor = pCursor;
+   uint16_t line = pLine;
 
-   for(size_t i = 0u; i < pContext.mRegisteredInstances.size(); i++)
+   if(pMacro.mParametersCount > 0u && Tokenizer::skipBlanks(cursor, line) && *cursor == '(')
    {
-      if(pContext.mRegisteredInstances[i].mIdentifier == pIdentifier &&
-         pContext.mRegisteredInstances[i].mNamespace == pContext.mNamespaceStack.back() &&
-         pContext.mRegisteredInstances[i].mScopeLevel == pContext.mScopeLevel)
-      {
-         instanceAlreadyRegistered = true;
-         break;
-      }
-   }
-
-   if(!instanceAlreadyRegistered)
-   {
-      Expression* initialValueExpression = nullptr;
+      cursor++;
 
-      // array
-      if(token.mStart[0] == '[')
-      {
-         uint16_t arraySize = 0u;
+      MacroArgument argument;
+      argument.mStart = nullptr;
+      argument.mLength = 0u;
+      arguments.push_back(argument);
 
-         const size_t arrayClosure = findClosureTokenIndex(pContext, '[', ']');
-         const bool arraySizeSpecified = arrayClosure > (tokenIndex + 1u);
+      uint32_t parenthesesLevel = 0u;
 
-         if(arraySizeSpecified)
+      while(true)
+      {
+         if(!Tokenizer::skipBlanks(cursor, line))
          {
-            tokenIndex++;
-            Expression* arraySizeExpression = parseExpression(pContext, arrayClosure - 1u);
-            CflatAssert(arraySizeExpression);
-
-            Value arraySizeValue;
-            arraySizeValue.initOnStack(mTypeUsageSizeT, &mExecutionContext.mStack);
-            evaluateExpression(mExecutionContext, arraySizeExpression, &arraySizeValue);
-
-            arraySize = (uint16_t)CflatValueAs(&arraySizeValue, size_t);
-
-            CflatInvokeDtor(Expression, arraySizeExpression);
-            CflatFree(arraySizeExpression);
+            throwPreprocessorError(pContext, PreprocessorError::InvalidMacroArgumentCount,
+               pNameToken.mStart - pContext.mCode, pMacro.mName.c_str());
+            return false;
          }
 
-         tokenIndex = arrayClosure + 1u;
+         const Token token = Tokenizer::readToken(cursor, line);
 
-         if(tokens[tokenIndex].mStart[0] == '=')
+         if(token.mType == TokenType::Punctuation && token.mLength == 1u)
          {
-            tokenIndex++;
-
-            const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
-
-            if(closureTokenIndex > 0u)
+            if(token.mStart[0] == '(')
             {
-               initialValueExpression = parseExpression(pContext, closureTokenIndex - 1u);
-
-               if(!initialValueExpression ||
-                  initialValueExpression->getType() != ExpressionType::ArrayInitialization)
-               {
-                  throwCompileError(pContext, CompileError::ArrayInitializationExpected);
-                  return nullptr;
-               }
-
-               ExpressionArrayInitialization* arrayInitialization =
-                  static_cast<ExpressionArrayInitialization*>(initialValueExpression);
-               arrayInitialization->mElementType = pTypeUsage.mType;
-
-               if(!arraySizeSpecified)
+               parenthesesLevel++;
+            }
+            else if(token.mStart[0] == ')')
+            {
+               if(parenthesesLevel == 0u)
                {
-                  arraySize = (uint16_t)arrayInitialization->mValues.size();
+                  break;
                }
 
-               tokenIndex = closureTokenIndex;
+               parenthesesLevel--;
             }
-            else
+            else if(token.mStart[0] == ',' && parenthesesLevel == 0u)
             {
-               throwCompileError(pContext, CompileError::Expected, ";");
-               return nullptr;
+               arguments.push_back(argument);
+               continue;
             }
          }
-         else if(!arraySizeSpecified)
+
+         MacroArgument& currentArgument = arguments.back();
+
+         if(!currentArgument.mStart)
          {
-            throwCompileError(pContext, CompileError::ArrayInitializationExpected);
-            return nullptr;
+            currentArgument.mStart = token.mStart;
          }
 
-         CflatAssert(arraySize > 0u);
-         CflatSetFlag(pTypeUsage.mFlags, TypeUsageFlags::Array);
-         pTypeUsage.mArraySize = arraySize;
+         currentArgument.mLength = (size_t)(token.mStart + token.mLength - currentArgument.mStart);
       }
-      // variable/object
-      else if(token.mStart[0] == '=')
-      {
-         tokenIndex++;
 
-         const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+      pCursor = cursor;
+      pLine = line;
+   }
 
-         if(closureTokenIndex > 0u)
+   // compose the replaced code
+   CflatSTLString& expansion = pContext.mStringBuffer;
+   expansion.clear();
+
+   for(size_t i = 0u; i < pMacro.mBody.size(); i++)
+   {
+      const CflatSTLString& bodyChunk = pMacro.mBody[i];
+
+      if(bodyChunk[0] == '$')
+      {
+         const size_t parameterIndex = (size_t)(bodyChunk[1] - '1');
+
+         if(parameterIndex >= arguments.size())
          {
-            initialValueExpression = parseExpression(pContext, closureTokenIndex - 1u);
+            throwPreprocessorError(pContext, PreprocessorError::InvalidMacroArgumentCount,
+               pNameToken.mStart - pContext.mCode, pMacro.mName.c_str());
+            return false;
+         }
 
-            if(pTypeUsage.mType == mTypeAuto)
-            {
-               const TypeUsage resolvedTypeUsage = getTypeUsage(pContext, initialValueExpression);
-               pTypeUsage.mType = resolvedTypeUsage.mType;
-            }
+         const MacroArgument& argument = arguments[parameterIndex];
+         const MacroArgumentType argumentType = (MacroArgumentType)(bodyChunk[2] - '0');
 
-            tokenIndex = closureTokenIndex;
+         if(argumentType == MacroArgumentType::Stringize)
+         {
+            expansion.push_back('\"');
+            expansion.append(argument.mStart ? argument.mStart : "", argument.mLength);
+            expansion.push_back('\"');
          }
          else
          {
-            throwCompileError(pContext, CompileError::Expected, ";");
-            return nullptr;
+            expansion.append(argument.mStart ? argument.mStart : "", argument.mLength);
          }
       }
-      // object with construction
-      else if(pTypeUsage.mType &&
-         pTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
-         !pTypeUsage.isPointer())
+      else
       {
-         Type* type = pTypeUsage.mType;
+         expansion.append(bodyChunk);
+      }
+   }
 
-         if(token.mStart[0] == '(')
-         {
-            initialValueExpression = parseExpressionObjectConstruction(pContext, type);
-         }
-         else
-         {
-            const Identifier emptyId;
-            Method* anyCtor = findMethod(type, emptyId);
+   if(expansion.empty())
+   {
+      return true;
+   }
 
-            if(anyCtor)
-            {
-               Method* defaultCtor = getDefaultConstructor(type);
+   // tokenize the replaced code, whose tokens take the line where the macro is used
+   char* expansionCode = (char*)pContext.mMacroExpansionsArena.allocate(expansion.length() + 1u);
+   memcpy(expansionCode, expansion.c_str(), expansion.length() + 1u);
 
-               if(!defaultCtor)
-               {
-                  CflatSTLString typeFullName;
-                  getTypeFullName(type, &typeFullName);
+   const char* expansionCursor = expansionCode;
+   uint16_t expansionLine = pNameToken.mLine;
 
-                  throwCompileError(pContext, CompileError::NoDefaultConstructor,
-                     typeFullName.c_str());
-                  return nullptr;
-               }
-            }
-         }
+   while(Tokenizer::skipBlanks(expansionCursor, expansionLine))
+   {
+      pContext.mTokens.push_back(Tokenizer::readToken(expansionCursor, pNameToken.mLine));
+   }
+
+   return true;
+}
+
+void Environment::parse(ParsingContext& pContext)
+{
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   CflatSTLVector(Program::StatementSource)& statementSources = pContext.mProgram->mStatementSources;
+   bool statementSourcesValid = true;
+
+   for(tokenIndex = 0u; tokenIndex < pContext.mTokens.size(); tokenIndex++)
+   {
+      const size_t firstTokenIndex = tokenIndex;
+      Statement* statement = parseStatement(pContext);
+
+      if(!mErrorMessage.empty())
+      {
+         break;
       }
 
-      if(pTypeUsage.isReference() && !initialValueExpression)
+      if(statement)
       {
-         throwCompileError(pContext, CompileError::UninitializedReference, pIdentifier.mName);
-         return nullptr;
+         pContext.mProgram->mStatements.push_back(statement);
       }
 
-      registerInstance(pContext, pTypeUsage, pIdentifier);
+      // the statement sources are only valid if their token ranges match the parsed ones
+      if(statementSourcesValid)
+      {
+         Program::StatementSource statementSource;
+         size_t lastTokenIndex = 0u;
 
-      ParsingContext::RegisteredInstance registeredInstance;
-      registeredInstance.mIdentifier = pIdentifier;
-      registeredInstance.mNamespace = pContext.mNamespaceStack.back();
-      registeredInstance.mScopeLevel = pContext.mScopeLevel;
-      pContext.mRegisteredInstances.push_back(registeredInstance);
+         statementSourcesValid =
+            getStatementSource(pContext, firstTokenIndex, &statementSource, &lastTokenIndex) &&
+            lastTokenIndex == tokenIndex;
 
-      statement = (StatementVariableDeclaration*)CflatMalloc(sizeof(StatementVariableDeclaration));
-      CflatInvokeCtor(StatementVariableDeclaration, statement)
-         (pTypeUsage, pIdentifier, initialValueExpression, pStatic);
+         statementSource.mStatement = statement;
+         statementSource.mArena = nullptr;
+         statementSources.push_back(statementSource);
+      }
+   }
 
-      if(initialValueExpression)
-      {
-         bool validAssignment = false;
+   if(!statementSourcesValid)
+   {
+      statementSources.clear();
+   }
+}
 
-         if(pTypeUsage.isPointer() && initialValueExpression->getType() == ExpressionType::NullPointer)
-         {
-            validAssignment = true;
-         }
-         else
-         {
-            const TypeUsage initialValueTypeUsage = getTypeUsage(pContext, initialValueExpression);
+bool Environment::getStatementSource(ParsingContext& pContext, size_t pFirstTokenIndex,
+   Program::StatementSource* pOutStatementSource, size_t* pOutLastTokenIndex)
+{
+   const CflatSTLVector(Token)& tokens = pContext.mTokens;
 
-            if(initialValueTypeUsage.mType)
+   size_t headerTokensCount = 0u;
+   uint32_t scopeLevel = 0u;
+
+   for(size_t i = pFirstTokenIndex; i < tokens.size(); i++)
+   {
+      const Token& token = tokens[i];
+      bool lastToken = false;
+
+      if(token.mType == TokenType::Punctuation)
+      {
+         if(token.mStart[0] == '{')
+         {
+            if(scopeLevel == 0u && headerTokensCount == 0u)
             {
-               if(initialValueTypeUsage.mType != mTypeVoid || initialValueTypeUsage.isPointer())
-               {
-                  if(pTypeUsage.isPointer() && !pTypeUsage.isArray() &&
-                     !initialValueTypeUsage.isPointer() && initialValueTypeUsage.isArray() &&
-                     pTypeUsage.mType == initialValueTypeUsage.mType)
-                  {
-                     validAssignment = true;
-                  }
-                  else
-                  {
-                     const TypeHelper::Compatibility compatibility =
-                        TypeHelper::getCompatibility(pTypeUsage, initialValueTypeUsage);
-                     validAssignment = compatibility != TypeHelper::Compatibility::Incompatible;
-                  }
-               }
+               headerTokensCount = i - pFirstTokenIndex;
             }
-         }
 
-         if(validAssignment)
+            scopeLevel++;
+         }
+         else if(token.mStart[0] == '}')
          {
-            if(pStatic && pTypeUsage.isConst())
+            if(scopeLevel == 0u)
             {
-               Instance* execInstance = registerInstance(mExecutionContext, pTypeUsage, pIdentifier);
+               return false;
+            }
 
-               Value initialValue;
-               initialValue.mValueInitializationHint = ValueInitializationHint::Stack;
-               evaluateExpression(mExecutionContext, initialValueExpression, &initialValue);
+            scopeLevel--;
 
-               assignValue(mExecutionContext, initialValue, &execInstance->mValue, true);
-            }
+            // a closing bracket ends the statement unless a semicolon follows (e.g. 'struct S {};')
+            lastToken = scopeLevel == 0u &&
+               ((i + 1u) == tokens.size() || tokens[i + 1u].mStart[0] != ';');
          }
-         else
+         else if(token.mStart[0] == ';')
          {
-            throwCompileError(pContext, CompileError::InvalidAssignment);
+            lastToken = scopeLevel == 0u;
          }
       }
-   }
-   else
-   {
-      throwCompileError(pContext, CompileError::VariableRedefinition, pIdentifier.mName);
+
+      if(lastToken)
+      {
+         const size_t tokensCount = i - pFirstTokenIndex + 1u;
+
+         if(headerTokensCount == 0u)
+         {
+            headerTokensCount = tokensCount;
+         }
+
+         pOutStatementSource->mHash = hash(&tokens[pFirstTokenIndex], tokensCount, true);
+         pOutStatementSource->mHeaderHash =
+            hash(&tokens[pFirstTokenIndex], headerTokensCount, false);
+         pOutStatementSource->mLine = tokens[pFirstTokenIndex].mLine;
+         pOutStatementSource->mStatement = nullptr;
+         *pOutLastTokenIndex = i;
+
+         return true;
+      }
    }
 
-   return statement;
+   return false;
 }
 
-StatementFunctionDeclaration* Environment::parseStatementFunctionDeclaration(ParsingContext& pContext,
-   const TypeUsage& pReturnType)
+void Environment::moveStatementLines(Statement* pStatement, int pLinesOffset)
 {
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
-
-   pContext.mStringBuffer.assign(token.mStart, token.mLength);
-   const Identifier functionIdentifier(pContext.mStringBuffer.c_str());
-
-   if(pReturnType.mType &&
-      pReturnType.mType->mCategory == TypeCategory::StructOrClass &&
-      !pReturnType.isPointer() &&
-      !pReturnType.isReference())
+   if(!pStatement)
    {
-      TypeUsage returnTypeReference;
-      returnTypeReference.mType = pReturnType.mType;
-      returnTypeReference.mFlags |= (uint8_t)TypeUsageFlags::Reference;
-
-      CflatArgsVector(TypeUsage) argumentTypes;
-      argumentTypes.push_back(returnTypeReference);
+      return;
+   }
 
-      Method* copyConstructor = findConstructor(pReturnType.mType, argumentTypes);
+   const uint16_t previousLine = pStatement->mLine;
+   pStatement->mLine = (uint16_t)(pStatement->mLine + pLinesOffset);
 
-      if(!copyConstructor)
+   switch(pStatement->getType())
+   {
+   case StatementType::Block:
       {
-         CflatSTLString typeFullName;
-         getTypeFullName(pReturnType.mType, &typeFullName);
+         StatementBlock* statement = static_cast<StatementBlock*>(pStatement);
 
-         throwCompileError(pContext, CompileError::NoCopyConstructor, typeFullName.c_str());
-         return nullptr;
-      }
-   }
-
-   StatementFunctionDeclaration* statement =
-      (StatementFunctionDeclaration*)CflatMalloc(sizeof(StatementFunctionDeclaration));
-   CflatInvokeCtor(StatementFunctionDeclaration, statement)(pReturnType, functionIdentifier);
-
-   tokenIndex++;
-
-   while(tokens[tokenIndex++].mStart[0] != ')')
-   {
-      // no arguments
-      if(tokens[tokenIndex].mStart[0] == ')')
+         for(size_t i = 0u; i < statement->mStatements.size(); i++)
+         {
+            moveStatementLines(statement->mStatements[i], pLinesOffset);
+         }
+      }
+      break;
+   case StatementType::NamespaceDeclaration:
       {
-         tokenIndex++;
-         break;
+         StatementNamespaceDeclaration* statement = static_cast<StatementNamespaceDeclaration*>(pStatement);
+         moveStatementLines(statement->mBody, pLinesOffset);
       }
+      break;
+   case StatementType::FunctionDeclaration:
+      {
+         StatementFunctionDeclaration* statement = static_cast<StatementFunctionDeclaration*>(pStatement);
+         moveStatementLines(statement->mBody, pLinesOffset);
 
-      TypeUsage parameterType = parseTypeUsage(pContext, 0u);
-
-      if(!parameterType.mType)
+         // the function takes the line of the declaration which got executed last
+         if(statement->mFunction && statement->mFunction->mLine == previousLine)
+         {
+            statement->mFunction->mLine = statement->mLine;
+         }
+      }
+      break;
+   case StatementType::If:
       {
-         pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-         throwCompileError(pContext, Environment::CompileError::UndefinedType,
-            pContext.mStringBuffer.c_str());
-         return statement;
+         StatementIf* statement = static_cast<StatementIf*>(pStatement);
+         moveStatementLines(statement->mIfStatement, pLinesOffset);
+         moveStatementLines(statement->mElseStatement, pLinesOffset);
       }
+      break;
+   case StatementType::Switch:
+      {
+         StatementSwitch* statement = static_cast<StatementSwitch*>(pStatement);
 
-      statement->mParameterTypes.push_back(parameterType);
-
-      pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-      Identifier parameterIdentifier(pContext.mStringBuffer.c_str());
-      statement->mParameterIdentifiers.push_back(parameterIdentifier);
-      tokenIndex++;
-
-      pContext.mScopeLevel++;
-      registerInstance(pContext, parameterType, parameterIdentifier);
-      pContext.mScopeLevel--;
-   }
-
-   CflatArgsVector(TypeUsage) parameterTypes;
-   toArgsVector(statement->mParameterTypes, parameterTypes);
-
-   Function* function =
-      pContext.mNamespaceStack.back()->getFunction(statement->mFunctionIdentifier, parameterTypes);
-
-   if(!function)
-   {
-      function = pContext.mNamespaceStack.back()->registerFunction(statement->mFunctionIdentifier);
-      function->mReturnTypeUsage = statement->mReturnType;
-      function->mProgram = pContext.mProgram;
-      function->mLine = token.mLine;
-
-      for(size_t i = 0u; i < statement->mParameterTypes.size(); i++)
+         for(size_t i = 0u; i < statement->mCaseSections.size(); i++)
+         {
+            for(size_t j = 0u; j < statement->mCaseSections[i].mStatements.size(); j++)
+            {
+               moveStatementLines(statement->mCaseSections[i].mStatements[j], pLinesOffset);
+            }
+         }
+      }
+      break;
+   case StatementType::While:
+   case StatementType::DoWhile:
       {
-         function->mParameters.push_back(statement->mParameterTypes[i]);
-         function->mParameterIdentifiers.push_back(statement->mParameterIdentifiers[i]);
+         StatementWhile* statement = static_cast<StatementWhile*>(pStatement);
+         moveStatementLines(statement->mLoopStatement, pLinesOffset);
       }
-   }
-
-   pContext.mCurrentFunctionIdentifier = functionIdentifier;
-
-   statement->mBody = parseStatementBlock(pContext, true, true);
-
-   pContext.mCurrentFunctionIdentifier = Identifier();
-
-   return statement;
-}
-
-StatementStructDeclaration* Environment::parseStatementStructDeclaration(ParsingContext& pContext)
-{
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
-   const Token& token = tokens[tokenIndex];
-
-   pContext.mStringBuffer.assign(token.mStart, token.mLength);
-   const Identifier structIdentifier(pContext.mStringBuffer.c_str());
-   tokenIndex++;
-
-   if(tokens[tokenIndex].mStart[0] != '{')
-   {
-      throwCompileError(pContext, CompileError::Expected, "{");
-      return nullptr;
-   }
-
-   const size_t closureTokenIndex = findClosureTokenIndex(pContext, '{', '}');
-
-   if(closureTokenIndex == 0u)
-   {
-      tokenIndex = tokens.size() - 1u;
-      throwCompileError(pContext, CompileError::Expected, "}");
-      return nullptr;
-   }
-
-   tokenIndex++;
-
-   StatementStructDeclaration* statement =
-      (StatementStructDeclaration*)CflatMalloc(sizeof(StatementStructDeclaration));
-   CflatInvokeCtor(StatementStructDeclaration, statement)();
-
-   Namespace* ns = pContext.mNamespaceStack.back();
-
-   if(pContext.mScopeLevel > 0u)
-   {
-      ns = ns->requestNamespace(pContext.mCurrentFunctionIdentifier);
-
-      char buffer[kDefaultLocalStringBufferSize];
-      sprintf(buffer, "__local%u", pContext.mLocalNamespaceGlobalIndex);
-      const Identifier internalNamespaceIdentifier(buffer);
-      ns = ns->requestNamespace(internalNamespaceIdentifier);
-
-      pContext.mLocalNamespaceStack.emplace_back();
-      ParsingContext::LocalNamespace& localNamespace = pContext.mLocalNamespaceStack.back();
-      localNamespace.mNamespace = ns;
-      localNamespace.mScopeLevel = pContext.mScopeLevel;
-
-      pContext.mLocalNamespaceGlobalIndex++;
-   }
-
-   statement->mStruct = ns->registerType<Struct>(structIdentifier);
-
-   size_t structSize = 0u;
-
-   do
-   {
-      TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
-
-      if(!typeUsage.mType)
+      break;
+   case StatementType::For:
       {
-         pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-         throwCompileError(pContext, CompileError::UndefinedType, pContext.mStringBuffer.c_str());
-         break;
+         StatementFor* statement = static_cast<StatementFor*>(pStatement);
+         moveStatementLines(statement->mInitialization, pLinesOffset);
+         moveStatementLines(statement->mLoopStatement, pLinesOffset);
       }
-
-      pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-      tokenIndex++;
-
-      if(tokens[tokenIndex].mStart[0] != ';')
+      break;
+   case StatementType::ForRangeBased:
       {
-         throwCompileError(pContext, CompileError::Expected, ";");
-         break;
+         StatementForRangeBased* statement = static_cast<StatementForRangeBased*>(pStatement);
+         moveStatementLines(statement->mLoopStatement, pLinesOffset);
       }
-
-      const Identifier memberIdentifier(pContext.mStringBuffer.c_str());
-      Member member(memberIdentifier);
-      member.mTypeUsage = typeUsage;
-      member.mOffset = (uint16_t)structSize;
-
-      statement->mStruct->mMembers.push_back(member);
-      structSize += typeUsage.getSize();
-   }
-   while(++tokenIndex < closureTokenIndex);
-
-   statement->mStruct->mSize = structSize;
-
-   if(tokens[++tokenIndex].mStart[0] != ';')
-   {
-      throwCompileError(pContext, CompileError::Expected, ";");
+      break;
+   default:
+      break;
    }
-
-   return statement;
 }
 
-StatementIf* Environment::parseStatementIf(ParsingContext& pContext)
+Expression* Environment::parseExpression(ParsingContext& pContext, size_t pTokenLastIndex,
+   bool pNullAllowed)
 {
-   if(pContext.mScopeLevel == 0u)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
+   Expression* expression = nullptr;
 
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+   const size_t tokensCount = pTokenLastIndex - pContext.mTokenIndex + 1u;
 
-   if(tokens[tokenIndex].mStart[0] != '(')
+   if(tokensCount == 1u)
    {
-      throwCompileError(pContext, CompileError::UnexpectedSymbol, "if");
-      return nullptr;
+      expression = parseExpressionSingleToken(pContext);
    }
-
-   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
-
-   if(conditionClosureTokenIndex == 0u)
+   else
    {
-      throwCompileError(pContext, CompileError::Expected, ")");
-      return nullptr;
+      expression = parseExpressionMultipleTokens(pContext, pTokenLastIndex);
    }
 
-   tokenIndex++;
-   Expression* condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
-   tokenIndex = conditionClosureTokenIndex + 1u;
-
-   Statement* ifStatement = parseStatement(pContext);
-
-   if(!ifStatement)
+   if(!pNullAllowed && !expression)
    {
       throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
    }
 
-   const size_t tokenIndexForElseCheck = tokenIndex + 1u;
-   Statement* elseStatement = nullptr;
-
-   if(tokens[tokenIndexForElseCheck].mType == TokenType::Keyword &&
-      strncmp(tokens[tokenIndexForElseCheck].mStart, "else", 4u) == 0)
+   if(expression && mErrorMessage.empty())
    {
-      tokenIndex = tokenIndexForElseCheck + 1u;
-      elseStatement = parseStatement(pContext);
+      expression->mValueTypeUsage = getTypeUsage(pContext, expression);
+      expression = foldConstantExpression(pContext, expression);
    }
 
-   StatementIf* statement = (StatementIf*)CflatMalloc(sizeof(StatementIf));
-   CflatInvokeCtor(StatementIf, statement)(condition, ifStatement, elseStatement);
-
-   return statement;
+   return expression;
 }
 
-StatementSwitch* Environment::parseStatementSwitch(ParsingContext& pContext)
+Expression* Environment::parseExpressionSingleToken(ParsingContext& pContext)
 {
-   if(pContext.mScopeLevel == 0u)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
-
    CflatSTLVector(Token)& tokens = pContext.mTokens;
    size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
+   Expression* expression = nullptr;
 
-   if(tokens[tokenIndex].mStart[0] != '(')
+   if(token.mType == TokenType::Number)
    {
-      throwCompileError(pContext, CompileError::UnexpectedSymbol, "switch");
-      return nullptr;
-   }
-
-   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+      TypeUsage typeUsage;
+      Value value;
 
-   if(conditionClosureTokenIndex == 0u)
-   {
-      throwCompileError(pContext, CompileError::Expected, ")");
-      return nullptr;
-   }
+      pContext.mStringBuffer.assign(token.mStart, token.mLength);
+      const char* numberStr = pContext.mStringBuffer.c_str();
+      const size_t numberStrLength = strlen(numberStr);
 
-   if(tokens[conditionClosureTokenIndex + 1u].mStart[0] != '{')
-   {
-      pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-      throwCompileError(pContext, CompileError::UnexpectedSymbol, pContext.mStringBuffer.c_str());
-      return nullptr;
-   }
-
-   tokenIndex++;
-   Expression* condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
-   tokenIndex = conditionClosureTokenIndex + 1u;
-
-   tokenIndex++;
-   const size_t lastSwitchTokenIndex = findClosureTokenIndex(pContext, '{', '}');
-
-   if(lastSwitchTokenIndex == 0u)
-   {
-      if(condition)
-      {
-         CflatInvokeDtor(Expression, condition);
-         CflatFree(condition);
-      }
-
-      throwCompileError(pContext, CompileError::Expected, "}");
-      return nullptr;
-   }
-
-   StatementSwitch* statement = (StatementSwitch*)CflatMalloc(sizeof(StatementSwitch));
-   CflatInvokeCtor(StatementSwitch, statement)(condition);
-
-   StatementSwitch::CaseSection* currentCaseSection = nullptr;
-
-   for(; tokenIndex < lastSwitchTokenIndex; tokenIndex++)
-   {
-      if(tokens[tokenIndex].mType == TokenType::Keyword)
+      // decimal value
+      if(strchr(numberStr, '.'))
       {
-         if(strncmp(tokens[tokenIndex].mStart, "case", 4u) == 0)
+         // float
+         if(numberStr[numberStrLength - 1u] == 'f')
          {
-            tokenIndex++;
-            const size_t lastCaseTokenIndex =
-               findClosureTokenIndex(pContext, 0, ':', lastSwitchTokenIndex);
-
-            StatementSwitch::CaseSection caseSection;
-            caseSection.mExpression = parseExpression(pContext, lastCaseTokenIndex - 1u);
-            tokenIndex = lastCaseTokenIndex + 1u;
-
-            statement->mCaseSections.push_back(caseSection);
-            currentCaseSection = &statement->mCaseSections.back();
+            typeUsage.mType = mTypeFloat;
+            const float number = (float)strtod(numberStr, nullptr);
+            value.initOnStack(typeUsage, &mExecutionContext.mStack);
+            value.set(&number);
          }
-         else if(strncmp(tokens[tokenIndex].mStart, "default", 7u) == 0)
+         // double
+         else
          {
-            tokenIndex += 2u;
-
-            StatementSwitch::CaseSection caseSection;
-            caseSection.mExpression = nullptr;
-
-            statement->mCaseSections.push_back(caseSection);
-            currentCaseSection = &statement->mCaseSections.back();
+            typeUsage.mType = mTypeDouble;
+            const double number = strtod(numberStr, nullptr);
+            value.initOnStack(typeUsage, &mExecutionContext.mStack);
+            value.set(&number);
          }
       }
-
-      if(!currentCaseSection)
+      // integer value
+      else
       {
-         if(condition)
+         // unsigned
+         if(numberStr[numberStrLength - 1u] == 'u')
          {
-            CflatInvokeDtor(Expression, condition);
-            CflatFree(condition);
+            typeUsage.mType = mTypeUInt32;
+            const uint32_t number = (uint32_t)atoi(numberStr);
+            value.initOnStack(typeUsage, &mExecutionContext.mStack);
+            value.set(&number);
+         }
+         // hex
+         else if(numberStr[0] == '0' && numberStr[1] == 'x')
+         {
+            typeUsage.mType = mTypeUInt32;
+            const uint32_t number = (uint32_t)strtoul(numberStr, nullptr, 16);
+            value.initOnStack(typeUsage, &mExecutionContext.mStack);
+            value.set(&number);
+         }
+         // invalid float
+         else if(numberStr[numberStrLength - 1u] == 'f')
+         {
+            throwCompileError(pContext, CompileError::InvalidLiteral, numberStr);
+            return nullptr;
+         }
+         // signed
+         else
+         {
+            typeUsage.mType = mTypeInt32;
+            const int number = atoi(numberStr);
+            value.initOnStack(typeUsage, &mExecutionContext.mStack);
+            value.set(&number);
          }
-
-         pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-         throwCompileError(pContext, CompileError::UnexpectedSymbol, pContext.mStringBuffer.c_str());
-         return nullptr;
       }
 
-      Statement* caseSectionStatement = parseStatement(pContext);
+      expression = (ExpressionValue*)pContext.mArena->allocate(sizeof(ExpressionValue));
+      CflatInvokeCtor(ExpressionValue, expression)(value);
+   }
+   else if(token.mType == TokenType::Identifier)
+   {
+      // variable access
+      pContext.mStringBuffer.assign(token.mStart, token.mLength);
+      const Identifier identifier(pContext.mStringBuffer.c_str());
 
-      if(caseSectionStatement)
+      Instance* instance = retrieveInstance(pContext, identifier);
+
+      if(instance)
       {
-         currentCaseSection->mStatements.push_back(caseSectionStatement);
+         ExpressionVariableAccess* variableAccess =
+            (ExpressionVariableAccess*)pContext.mArena->allocate(sizeof(ExpressionVariableAccess));
+         CflatInvokeCtor(ExpressionVariableAccess, variableAccess)(identifier);
+         bindVariableAccess(pContext, instance, variableAccess);
+
+         expression = variableAccess;
+      }
+      else
+      {
+         throwCompileError(pContext, CompileError::UndefinedVariable, identifier.mName);
       }
    }
-
-   return statement;
-}
-
-StatementWhile* Environment::parseStatementWhile(ParsingContext& pContext)
-{
-   if(pContext.mScopeLevel == 0u)
+   else if(token.mType == TokenType::Keyword)
    {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
+      if(strncmp(token.mStart, "nullptr", 7u) == 0)
+      {
+         expression = (ExpressionNullPointer*)pContext.mArena->allocate(sizeof(ExpressionNullPointer));
+         CflatInvokeCtor(ExpressionNullPointer, expression)();
+      }
+      else if(strncmp(token.mStart, "true", 4u) == 0)
+      {
+         Value value;
+         value.initOnStack(mTypeUsageBool, &mExecutionContext.mStack);
 
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+         const bool boolValue = true;
+         value.set(&boolValue);
 
-   if(tokens[tokenIndex].mStart[0] != '(')
-   {
-      throwCompileError(pContext, CompileError::UnexpectedSymbol, "while");
-      return nullptr;
-   }
+         expression = (ExpressionValue*)pContext.mArena->allocate(sizeof(ExpressionValue));
+         CflatInvokeCtor(ExpressionValue, expression)(value);
+      }
+      else if(strncmp(token.mStart, "false", 5u) == 0)
+      {
+         Value value;
+         value.initOnStack(mTypeUsageBool, &mExecutionContext.mStack);
 
-   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+         const bool boolValue = false;
+         value.set(&boolValue);
 
-   if(conditionClosureTokenIndex == 0u)
+         expression = (ExpressionValue*)pContext.mArena->allocate(sizeof(ExpressionValue));
+         CflatInvokeCtor(ExpressionValue, expression)(value);
+      }
+   }
+   else if(token.mType == TokenType::String)
    {
-      throwCompileError(pContext, CompileError::Expected, ")");
-      return nullptr;
+      expression = parseExpressionLiteralString(pContext);
    }
 
-   tokenIndex++;
-   Expression* condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
-   tokenIndex = conditionClosureTokenIndex + 1u;
-
-   Statement* loopStatement = parseStatement(pContext);
-
-   StatementWhile* statement = (StatementWhile*)CflatMalloc(sizeof(StatementWhile));
-   CflatInvokeCtor(StatementWhile, statement)(condition, loopStatement);
-
-   return statement;
+   return expression;
 }
 
-StatementDoWhile* Environment::parseStatementDoWhile(ParsingContext& pContext)
+Expression* Environment::parseExpressionMultipleTokens(ParsingContext& pContext, size_t pTokenLastIndex)
 {
-   if(pContext.mScopeLevel == 0u)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
-
    CflatSTLVector(Token)& tokens = pContext.mTokens;
    size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
+   Expression* expression = nullptr;
 
-   Statement* loopStatement = parseStatement(pContext);
-   tokenIndex++;
-
-   if(strncmp(tokens[tokenIndex].mStart, "while", 5u) != 0)
-   {
-      if(loopStatement)
-      {
-         CflatInvokeDtor(Statement, loopStatement);
-         CflatFree(loopStatement);
-      }
+   size_t assignmentOperatorTokenIndex = 0u;
+   size_t binaryOperatorTokenIndex = 0u;
+   uint8_t binaryOperatorPrecedence = 0u;
+   size_t memberAccessTokenIndex = 0u;
+   size_t conditionalTokenIndex = 0u;
 
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
+   uint32_t parenthesisLevel = tokens[pTokenLastIndex].mStart[0] == ')' ? 1u : 0u;
+   uint32_t squareBracketLevel = tokens[pTokenLastIndex].mStart[0] == ']' ? 1u : 0u;
+   uint32_t templateLevel = tokens[pTokenLastIndex].mStart[0] == '>' ? 1u : 0u;
 
-   tokenIndex++;
+   // no operators are looked for between a pair of parentheses or square brackets, so the
+   // enclosed tokens get skipped at once when the opening bracket is part of the expression
+   const bool bracketsMatched = pContext.mMatchingTokenIndices.size() == tokens.size();
+   size_t firstScannedTokenIndex = pTokenLastIndex - 1u;
 
-   if(tokens[tokenIndex].mStart[0] != '(')
+   if(bracketsMatched && (parenthesisLevel > 0u || squareBracketLevel > 0u))
    {
-      if(loopStatement)
+      const uint32_t matchingTokenIndex = pContext.mMatchingTokenIndices[pTokenLastIndex];
+
+      if(matchingTokenIndex != kNoMatchingTokenIndex && matchingTokenIndex < pTokenLastIndex)
       {
-         CflatInvokeDtor(Statement, loopStatement);
-         CflatFree(loopStatement);
+         firstScannedTokenIndex = matchingTokenIndex > tokenIndex ? matchingTokenIndex : tokenIndex;
       }
-
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
    }
 
-   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
-
-   if(conditionClosureTokenIndex == 0u)
+   for(size_t i = firstScannedTokenIndex; i > tokenIndex; i--)
    {
-      if(loopStatement)
+      if(tokens[i].mLength == 1u)
       {
-         CflatInvokeDtor(Statement, loopStatement);
-         CflatFree(loopStatement);
-      }
-
-      throwCompileError(pContext, CompileError::Expected, ")");
-      return nullptr;
-   }
-
-   tokenIndex++;
-   Expression* condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
-   tokenIndex = conditionClosureTokenIndex + 1u;
-
-   StatementDoWhile* statement = (StatementDoWhile*)CflatMalloc(sizeof(StatementDoWhile));
-   CflatInvokeCtor(StatementDoWhile, statement)(condition, loopStatement);
-
-   return statement;
-}
+         if(tokens[i].mStart[0] == ')' || tokens[i].mStart[0] == ']')
+         {
+            const uint32_t matchingTokenIndex =
+               bracketsMatched ? pContext.mMatchingTokenIndices[i] : kNoMatchingTokenIndex;
 
-Statement* Environment::parseStatementFor(ParsingContext& pContext)
-{
-   if(pContext.mScopeLevel == 0u)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
+            if(matchingTokenIndex != kNoMatchingTokenIndex && matchingTokenIndex < i)
+            {
+               if(matchingTokenIndex <= tokenIndex)
+               {
+                  break;
+               }
 
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+               i = matchingTokenIndex;
+               continue;
+            }
+         }
 
-   if(tokens[tokenIndex].mStart[0] != '(')
-   {
-      throwCompileError(pContext, CompileError::UnexpectedSymbol, "for");
-      return nullptr;
-   }
-
-   incrementScopeLevel(pContext);
-   incrementScopeLevel(mExecutionContext);
-
-   tokenIndex++;
-
-   const size_t initializationClosureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
-   const size_t variableClosureTokenIndex = findClosureTokenIndex(pContext, 0, ':');
+         if(tokens[i].mStart[0] == ')')
+         {
+            parenthesisLevel++;
+            continue;
+         }
+         else if(tokens[i].mStart[0] == '(')
+         {
+            parenthesisLevel--;
+            continue;
+         }
+         else if(tokens[i].mStart[0] == ']')
+         {
+            squareBracketLevel++;
+            continue;
+         }
+         else if(tokens[i].mStart[0] == '[')
+         {
+            squareBracketLevel--;
+            continue;
+         }
+         else if(tokens[i].mStart[0] == '>')
+         {
+            const size_t templateOpeningIndex = findOpeningTokenIndex(pContext, '<', '>', i);
+            const bool isTemplateClosure =
+               templateOpeningIndex < i && isTemplate(pContext, templateOpeningIndex, i);
 
-   if(initializationClosureTokenIndex == 0u && variableClosureTokenIndex == 0u)
-   {
-      throwCompileError(pContext, CompileError::Expected, "';' or variable declaration");
-      return nullptr;
-   }
+            if(isTemplateClosure)
+            {
+               templateLevel++;
+               continue;
+            }
+         }
+         else if(tokens[i].mStart[0] == '<')
+         {
+            const size_t cachedTokenIndex = tokenIndex;
+            tokenIndex = i;
+            const size_t templateClosureIndex =
+               findClosureTokenIndex(pContext, '<', '>', pTokenLastIndex - 1u);
+            tokenIndex = cachedTokenIndex;
 
-   Statement* statement = nullptr;
+            const bool isTemplateOpening =
+               templateClosureIndex > i && isTemplate(pContext, i, templateClosureIndex);
 
-   if((initializationClosureTokenIndex > 0u && variableClosureTokenIndex == 0u) ||
-      (initializationClosureTokenIndex < variableClosureTokenIndex))
-   {
-      statement = parseStatementForRegular(pContext, initializationClosureTokenIndex);
-   }
-   else
-   {
-      statement = parseStatementForRangeBased(pContext, variableClosureTokenIndex);
-   }
+            if(isTemplateOpening)
+            {
+               templateLevel--;
+               continue;
+            }
+         }
+      }
 
-   decrementScopeLevel(mExecutionContext);
-   decrementScopeLevel(pContext);
+      if(parenthesisLevel == 0u && squareBracketLevel == 0u && templateLevel == 0u)
+      {
+         if(i > tokenIndex &&
+            tokens[i].mType == TokenType::Operator &&
+            tokens[i - 1u].mType != TokenType::Operator)
+         {
+            if(tokens[i].mLength == 1u && tokens[i].mStart[0] == '?')
+            {
+               conditionalTokenIndex = i;
+            }
+            else
+            {
+               for(size_t j = 0u; j < kCflatAssignmentOperatorsCount; j++)
+               {
+                  const size_t operatorLength = strlen(kCflatAssignmentOperators[j]);
 
-   return statement;
-}
+                  if(tokens[i].mLength == operatorLength &&
+                     strncmp(tokens[i].mStart, kCflatAssignmentOperators[j], operatorLength) == 0)
+                  {
+                     assignmentOperatorTokenIndex = i;
+                     break;
+                  }
+               }
 
-StatementFor* Environment::parseStatementForRegular(ParsingContext& pContext,
-   size_t pInitializationClosureTokenIndex)
-{
-   size_t& tokenIndex = pContext.mTokenIndex;
+               if(assignmentOperatorTokenIndex == 0u)
+               {
+                  const uint8_t precedence = getBinaryOperatorPrecedence(pContext, i);
 
-   Statement* initialization = nullptr;
-   
-   if(pInitializationClosureTokenIndex > tokenIndex)
-   {
-      initialization = parseStatement(pContext);
+                  if(precedence > binaryOperatorPrecedence)
+                  {
+                     binaryOperatorTokenIndex = i;
+                     binaryOperatorPrecedence = precedence;
+                  }
+               }
+            }
+         }
+         else if(tokens[i].mType == TokenType::Punctuation && memberAccessTokenIndex == 0u)
+         {
+            if(tokens[i].mStart[0] == '.' || strncmp(tokens[i].mStart, "->", 2u) == 0)
+            {
+               memberAccessTokenIndex = i;
+            }
+         }
+      }
    }
 
-   tokenIndex = pInitializationClosureTokenIndex + 1u;
-
-   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+   bool isCStyleCast = false;
 
-   if(conditionClosureTokenIndex == 0u)
+   if(tokens[tokenIndex].mStart[0] == '(')
    {
-      throwCompileError(pContext, CompileError::Expected, ";");
-      return nullptr;
-   }
+      const size_t cachedTokenIndex = tokenIndex;
+      tokenIndex++;
 
-   Expression* condition = nullptr;
-   
-   if(conditionClosureTokenIndex > tokenIndex)
-   {
-      condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
+      const TypeUsage typeUsage = parseTypeUsage(pContext, pTokenLastIndex - 1u);
+      isCStyleCast = typeUsage.mType != nullptr;
+      tokenIndex = cachedTokenIndex;
    }
 
-   tokenIndex = conditionClosureTokenIndex + 1u;
-
-   const size_t incrementClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
-
-   if(incrementClosureTokenIndex == 0u)
+   // assignment
+   if(assignmentOperatorTokenIndex > 0u)
    {
-      throwCompileError(pContext, CompileError::Expected, ")");
-      return nullptr;
-   }
+      Expression* left = parseExpression(pContext, assignmentOperatorTokenIndex - 1u);
 
-   Expression* increment = nullptr;
-   
-   if(incrementClosureTokenIndex > tokenIndex)
-   {
-      increment = parseExpression(pContext, incrementClosureTokenIndex - 1u);
-   }
+      if(left)
+      {
+         const TypeUsage leftTypeUsage = getTypeUsage(pContext, left);
 
-   tokenIndex = incrementClosureTokenIndex + 1u;
+         if(!leftTypeUsage.isConst())
+         {
+            const Token& operatorToken = pContext.mTokens[assignmentOperatorTokenIndex];
+            CflatSTLString operatorStr(operatorToken.mStart, operatorToken.mLength);
 
-   Statement* loopStatement = parseStatement(pContext);
+            tokenIndex = assignmentOperatorTokenIndex + 1u;
+            Expression* right = parseExpression(pContext, pTokenLastIndex);
 
-   StatementFor* statement = (StatementFor*)CflatMalloc(sizeof(StatementFor));
-   CflatInvokeCtor(StatementFor, statement)(initialization, condition, increment, loopStatement);
+            if(right)
+            {
+               const OperatorType operatorType = getOperatorType(operatorStr.c_str(), false);
+               const OperationKernel kernel = operatorType != OperatorType::Assign
+                  ? getOperationKernel(leftTypeUsage, getTypeUsage(pContext, right))
+                  : OperationKernel::Generic;
 
-   return statement;
-}
+               expression = (ExpressionAssignment*)pContext.mArena->allocate(sizeof(ExpressionAssignment));
+               CflatInvokeCtor(ExpressionAssignment, expression)(left, right, operatorType, kernel);
+            }
+            else
+            {
+               CflatInvokeDtor(Expression, left);
+            }
 
-StatementForRangeBased* Environment::parseStatementForRangeBased(ParsingContext& pContext,
-   size_t pVariableClosureTokenIndex)
-{
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+            tokenIndex = pTokenLastIndex + 1u;
+         }
+         else
+         {
+            throwCompileError(pContext, Environment::CompileError::CannotModifyConstExpression);
+         }
+      }
+   }
+   // conditional expression
+   else if(conditionalTokenIndex > 0u)
+   {
+      const size_t elseTokenIndex = findClosureTokenIndex(pContext, 0, ':', pTokenLastIndex - 1u);
 
-   TypeUsage variableTypeUsage = parseTypeUsage(pContext, pVariableClosureTokenIndex - 1u);
+      if(elseTokenIndex > 0u)
+      {
+         Expression* condition = parseExpression(pContext, conditionalTokenIndex - 1u);
+         tokenIndex = conditionalTokenIndex + 1u;
 
-   if(!variableTypeUsage.mType)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
+         Expression* ifExpression = parseExpression(pContext, elseTokenIndex - 1u);
+         tokenIndex = elseTokenIndex + 1u;
 
-   Identifier variableIdentifier;
+         Expression* elseExpression = parseExpression(pContext, pTokenLastIndex);
+         tokenIndex = pTokenLastIndex + 1u;
 
-   if(tokens[tokenIndex].mType == TokenType::Identifier)
-   {
-      pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-      variableIdentifier = Identifier(pContext.mStringBuffer.c_str());
+         expression = (ExpressionConditional*)pContext.mArena->allocate(sizeof(ExpressionConditional));
+         CflatInvokeCtor(ExpressionConditional, expression)
+            (condition, ifExpression, elseExpression);
+      }
+      else
+      {
+         throwCompileError(pContext, CompileError::InvalidConditionalExpression);
+      }
    }
-   else
+   // binary operator
+   else if(binaryOperatorTokenIndex > 0u)
    {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
-
-   registerInstance(pContext, variableTypeUsage, variableIdentifier);
+      Expression* left = parseExpression(pContext, binaryOperatorTokenIndex - 1u);
 
-   tokenIndex = pVariableClosureTokenIndex + 1u;
-   const size_t collectionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+      if(left)
+      {
+         const TypeUsage leftTypeUsage = getTypeUsage(pContext, left);
 
-   if(collectionClosureTokenIndex <= tokenIndex)
-   {
-      throwCompileError(pContext, CompileError::Expected, ")");
-      return nullptr;
-   }
+         const Token& operatorToken = pContext.mTokens[binaryOperatorTokenIndex];
+         CflatSTLString operatorStr(operatorToken.mStart, operatorToken.mLength);
 
-   Expression* collection = parseExpression(pContext, collectionClosureTokenIndex - 1u);
+         tokenIndex = binaryOperatorTokenIndex + 1u;
+         Expression* right = parseExpression(pContext, pTokenLastIndex);
 
-   if(!collection)
-   {
-      return nullptr;
-   }
+         if(right)
+         {
+            bool operatorIsValid = true;
+            TypeUsage overloadedOperatorTypeUsage;
+            Method* overloadedOperatorMethod = nullptr;
+            Function* overloadedOperatorFunction = nullptr;
 
-   bool validStatement = false;
-   const TypeUsage collectionTypeUsage = getTypeUsage(pContext, collection);
+            if(!leftTypeUsage.isPointer() &&
+               leftTypeUsage.mType &&
+               leftTypeUsage.mType->mCategory == TypeCategory::StructOrClass)
+            {
+               const TypeUsage rightTypeUsage = getTypeUsage(pContext, right);
 
-   if(collectionTypeUsage.isArray() && !variableTypeUsage.isArray() &&
-      collectionTypeUsage.mPointerLevel == variableTypeUsage.mPointerLevel)
-   {
-      if(variableTypeUsage.mType == mTypeAuto)
-      {
-         variableTypeUsage.mType = collectionTypeUsage.mType;
-      }
+               if(rightTypeUsage.mType)
+               {
+                  CflatArgsVector(TypeUsage) args;
+                  args.push_back(rightTypeUsage);
 
-      validStatement = collectionTypeUsage.mType == variableTypeUsage.mType;
-   }
-   else if(collectionTypeUsage.mType->mCategory == TypeCategory::StructOrClass)
-   {
-      Struct* collectionType = static_cast<Struct*>(collectionTypeUsage.mType);
-      Method* beginMethod = findMethod(collectionType, "begin", TypeUsage::kEmptyList);
+                  pContext.mStringBuffer.assign("operator");
+                  pContext.mStringBuffer.append(operatorStr);
+                  const Identifier operatorIdentifier(pContext.mStringBuffer.c_str());
 
-      if(beginMethod)
-      {
-         Method* endMethod = findMethod(collectionType, "end", TypeUsage::kEmptyList);
+                  Method* operatorMethod =
+                     findMethod(leftTypeUsage.mType, operatorIdentifier, args);
 
-         if(endMethod && beginMethod->mReturnTypeUsage == endMethod->mReturnTypeUsage)
-         {
-            const TypeUsage iteratorTypeUsage = beginMethod->mReturnTypeUsage;
-            Type* iteratorType = iteratorTypeUsage.mType;
+                  if(operatorMethod)
+                  {
+                     overloadedOperatorTypeUsage = operatorMethod->mReturnTypeUsage;
+                     overloadedOperatorMethod = operatorMethod;
+                  }
+                  else
+                  {
+                     args.insert(args.begin(), leftTypeUsage);
 
-            if(iteratorType->mCategory == TypeCategory::StructOrClass)
-            {
-               Method* indirectionOperatorMethod =
-                  findMethod(iteratorType, "operator*", TypeUsage::kEmptyList);
+                     Function* operatorFunction =
+                        leftTypeUsage.mType->mNamespace->getFunction(operatorIdentifier, args);
 
-               if(indirectionOperatorMethod)
-               {
-                  CflatArgsVector(TypeUsage) nonEqualOperatorParameterTypes;
-                  nonEqualOperatorParameterTypes.push_back(iteratorTypeUsage);
+                     if(!operatorFunction)
+                     {
+                        operatorFunction = findFunction(pContext, operatorIdentifier, args);
 
-                  validStatement = 
-                     findMethod(iteratorType, "operator!=", nonEqualOperatorParameterTypes) &&
-                     findMethod(iteratorType, "operator++", TypeUsage::kEmptyList);
+                        if(!operatorFunction)
+                        {
+                           CflatSTLString typeFullName;
+                           getTypeFullName(leftTypeUsage.mType, &typeFullName);
 
-                  if(validStatement && variableTypeUsage.mType == mTypeAuto)
-                  {
-                     variableTypeUsage.mType = indirectionOperatorMethod->mReturnTypeUsage.mType;
+                           throwCompileError(pContext, CompileError::InvalidOperator,
+                              typeFullName.c_str(), operatorStr.c_str());
+                           operatorIsValid = false;
+                        }
+                     }
+
+                     if(operatorFunction)
+                     {
+                        overloadedOperatorTypeUsage = operatorFunction->mReturnTypeUsage;
+                        overloadedOperatorFunction = operatorFunction;
+                     }
                   }
                }
             }
-            else
+
+            if(operatorIsValid)
             {
-               if(variableTypeUsage.mType == mTypeAuto)
+               const OperatorType operatorType = getOperatorType(operatorStr.c_str(), false);
+               const OperationKernel kernel = !overloadedOperatorTypeUsage.mType
+                  ? getOperationKernel(leftTypeUsage, getTypeUsage(pContext, right))
+                  : OperationKernel::Generic;
+
+               ExpressionBinaryOperation* binaryOperation =
+                  (ExpressionBinaryOperation*)pContext.mArena->allocate(sizeof(ExpressionBinaryOperation));
+               CflatInvokeCtor(ExpressionBinaryOperation, binaryOperation)
+                  (left, right, operatorType, kernel, overloadedOperatorTypeUsage);
+
+               if(overloadedOperatorMethod)
                {
-                  variableTypeUsage.mType = iteratorTypeUsage.mType;
+                  Struct* operatorMethodOwner = static_cast<Struct*>(leftTypeUsage.mType);
+                  binaryOperation->mOperatorMethodOwner = operatorMethodOwner;
+                  binaryOperation->mOperatorMethodIndex =
+                     (size_t)(overloadedOperatorMethod - operatorMethodOwner->mMethods.data());
                }
 
-               validStatement = iteratorTypeUsage.isPointer();
+               binaryOperation->mOperatorFunction = overloadedOperatorFunction;
+               expression = binaryOperation;
             }
          }
+         else
+         {
+            CflatInvokeDtor(Expression, left);
+         }
       }
-   }
 
-   if(!validStatement)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
+      tokenIndex = pTokenLastIndex + 1u;
    }
+   // unary operator
+   else if(token.mType == TokenType::Operator)
+   {
+      // address of
+      if(token.mStart[0] == '&')
+      {
+         tokenIndex++;
+         Expression* addressOfExpression = parseExpression(pContext, pTokenLastIndex);
 
-   tokenIndex = collectionClosureTokenIndex + 1u;
-   Statement* loopStatement = parseStatement(pContext);
+         expression = (ExpressionAddressOf*)pContext.mArena->allocate(sizeof(ExpressionAddressOf));
+         CflatInvokeCtor(ExpressionAddressOf, expression)(addressOfExpression);
+      }
+      // indirection
+      else if(token.mStart[0] == '*')
+      {
+         tokenIndex++;
+         Expression* indirectionExpression = parseExpression(pContext, pTokenLastIndex);
+         const TypeUsage indirectionExpressionTypeUsage =
+            getTypeUsage(pContext, indirectionExpression);
+         Type* indirectionExpressionType = indirectionExpressionTypeUsage.mType;
 
-   StatementForRangeBased* statement =
-      (StatementForRangeBased*)CflatMalloc(sizeof(StatementForRangeBased));
-   CflatInvokeCtor(StatementForRangeBased, statement)
-      (variableTypeUsage, variableIdentifier, collection, loopStatement);
+         const Identifier operatorMethodID("operator*");
+         Method* operatorMethod = nullptr;
 
-   return statement;
-}
+         if(indirectionExpressionType &&
+            indirectionExpressionType->mCategory == TypeCategory::StructOrClass)
+         {
+            operatorMethod =
+               findMethod(indirectionExpressionType, operatorMethodID, TypeUsage::kEmptyList);
+         }
 
-StatementBreak* Environment::parseStatementBreak(ParsingContext& pContext)
-{
-   if(pContext.mScopeLevel == 0u)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
+         if(operatorMethod)
+         {
+            ExpressionMemberAccess* memberAccess =
+               (ExpressionMemberAccess*)pContext.mArena->allocate(sizeof(ExpressionMemberAccess));
+            CflatInvokeCtor(ExpressionMemberAccess, memberAccess)
+               (indirectionExpression, operatorMethodID, operatorMethod->mReturnTypeUsage);
 
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+            ExpressionMethodCall* methodCall =
+               (ExpressionMethodCall*)pContext.mArena->allocate(sizeof(ExpressionMethodCall));
+            CflatInvokeCtor(ExpressionMethodCall, methodCall)(memberAccess);
+            expression = methodCall;
 
-   if(tokens[tokenIndex].mStart[0] != ';')
-   {
-      throwCompileError(pContext, CompileError::UnexpectedSymbol, "break");
-      return nullptr;
+            methodCall->mMethod = operatorMethod;
+         }
+         else
+         {
+            expression = (ExpressionIndirection*)pContext.mArena->allocate(sizeof(ExpressionIndirection));
+            CflatInvokeCtor(ExpressionIndirection, expression)(indirectionExpression);
+         }
+      }
+      // unary operator (pre)
+      else
+      {
+         const Token& operatorToken = token;
+         CflatSTLString operatorStr(operatorToken.mStart, operatorToken.mLength);
+         tokenIndex++;
+         Expression* operandExpression = parseExpression(pContext, pTokenLastIndex);
+
+         if(operandExpression)
+         {
+            expression =
+               parseExpressionUnaryOperator(pContext, operandExpression, operatorStr.c_str(), false);
+         }
+      }
    }
+   // C-style cast
+   else if(isCStyleCast)
+   {
+      const size_t closureTokenIndex = findClosureTokenIndex(pContext, '(', ')', pTokenLastIndex);
+      tokenIndex++;
 
-   StatementBreak* statement = (StatementBreak*)CflatMalloc(sizeof(StatementBreak));
-   CflatInvokeCtor(StatementBreak, statement)();
+      const TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex);
 
-   return statement;
-}
+      if(tokenIndex == closureTokenIndex)
+      {
+         tokenIndex++;
+         Expression* expressionToCast = parseExpression(pContext, pTokenLastIndex);
 
-StatementContinue* Environment::parseStatementContinue(ParsingContext& pContext)
-{
-   if(pContext.mScopeLevel == 0u)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
+         expression = (ExpressionCast*)pContext.mArena->allocate(sizeof(ExpressionCast));
+         CflatInvokeCtor(ExpressionCast, expression)(CastType::CStyle, typeUsage, expressionToCast);
 
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+         const TypeUsage sourceTypeUsage = getTypeUsage(pContext, expressionToCast);
 
-   if(tokens[tokenIndex].mStart[0] != ';')
-   {
-      throwCompileError(pContext, CompileError::UnexpectedSymbol, "continue");
-      return nullptr;
+         if(!isCastAllowed(CastType::CStyle, sourceTypeUsage, typeUsage))
+         {
+            throwCompileError(pContext, CompileError::InvalidCast);
+         }
+      }
+      else
+      {
+         throwCompileErrorUnexpectedSymbol(pContext);
+      }
    }
+   // member access
+   else if(memberAccessTokenIndex > 0u)
+   {
+      if(tokens[memberAccessTokenIndex + 1u].mType == TokenType::Identifier)
+      {
+         Expression* memberOwner = parseExpression(pContext, memberAccessTokenIndex - 1u);
+         tokenIndex = memberAccessTokenIndex + 1u;
 
-   StatementContinue* statement = (StatementContinue*)CflatMalloc(sizeof(StatementContinue));
-   CflatInvokeCtor(StatementContinue, statement)();
+         if(memberOwner)
+         {
+            pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+            const Identifier memberIdentifier(pContext.mStringBuffer.c_str());
 
-   return statement;
-}
+            const bool isMemberAccess = tokens[memberAccessTokenIndex].mStart[0] == '.';
+            const bool isPtrMemberAccess =
+               !isMemberAccess && strncmp(tokens[memberAccessTokenIndex].mStart, "->", 2u) == 0;
 
-StatementReturn* Environment::parseStatementReturn(ParsingContext& pContext)
-{
-   if(pContext.mScopeLevel == 0u)
-   {
-      throwCompileErrorUnexpectedSymbol(pContext);
-      return nullptr;
-   }
+            bool memberAccessIsValid = true;
 
-   const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+            const TypeUsage ownerTypeUsage = getTypeUsage(pContext, memberOwner);
+            TypeUsage memberTypeUsage;
 
-   if(closureTokenIndex == 0u)
-   {
-      throwCompileError(pContext, CompileError::Expected, ")");
-      return nullptr;
-   }
+            bool isMethodCall = false;
 
-   Expression* expression = parseExpression(pContext, closureTokenIndex - 1u, true);
+            if((tokenIndex + 1u) < tokens.size())
+            {
+               isMethodCall = tokens[tokenIndex + 1u].mStart[0] == '(';
 
-   StatementReturn* statement = (StatementReturn*)CflatMalloc(sizeof(StatementReturn));
-   CflatInvokeCtor(StatementReturn, statement)(expression);
+               if(!isMethodCall)
+               {
+                  tokenIndex++;
+                  isMethodCall = isTemplate(pContext, pTokenLastIndex);
+                  tokenIndex--;
+               }
 
-   pContext.mTokenIndex = closureTokenIndex;
+               if(!isMethodCall)
+               {
+                  Struct* type = static_cast<Struct*>(ownerTypeUsage.mType);
+                  Member* member = nullptr;
 
-   return statement;
-}
-
-bool Environment::parseFunctionCallArguments(ParsingContext& pContext,
-   CflatSTLVector(Expression*)* pArguments, CflatSTLVector(TypeUsage)* pTemplateTypes)
-{
-   CflatSTLVector(Token)& tokens = pContext.mTokens;
-   size_t& tokenIndex = pContext.mTokenIndex;
+                  for(size_t i = 0u; i < type->mMembers.size(); i++)
+                  {
+                     if(type->mMembers[i].mIdentifier == memberIdentifier)
+                     {
+                        member = &type->mMembers[i];
+                        break;
+                     }
+                  }
 
-   if(tokens[tokenIndex].mStart[0] == '<')
-   {
-      if(pTemplateTypes)
-      {
-         const size_t closureTokenIndex = findClosureTokenIndex(pContext, '<', '>');
+                  if(member)
+                  {
+                     memberTypeUsage = member->mTypeUsage;
+                  }
+                  else
+                  {
+                     throwCompileError(pContext, CompileError::MissingMember,
+                        memberIdentifier.mName);
+                     memberAccessIsValid = false;
+                  }
+               }
+            }
 
-         if(closureTokenIndex > 0u)
-         {
-            while(tokenIndex++ < closureTokenIndex)
+            if(memberAccessIsValid)
             {
-               TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
-
-               if(typeUsage.mType)
+               if(ownerTypeUsage.isPointer())
                {
-                  pTemplateTypes->push_back(typeUsage);
+                  if(!isPtrMemberAccess)
+                  {
+                     throwCompileError(pContext, CompileError::InvalidMemberAccessOperatorPtr,
+                        memberIdentifier.mName);
+                     memberAccessIsValid = false;
+                  }
                }
                else
                {
-                  pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
-                  throwCompileError(pContext, Environment::CompileError::UndefinedType,
-                     pContext.mStringBuffer.c_str());
-                  return false;
+                  if(isPtrMemberAccess)
+                  {
+                     throwCompileError(pContext, CompileError::InvalidMemberAccessOperatorNonPtr,
+                        memberIdentifier.mName);
+                     memberAccessIsValid = false;
+                  }
+               }
+            }
+
+            if(memberAccessIsValid)
+            {
+               ExpressionMemberAccess* memberAccess =
+                  (ExpressionMemberAccess*)pContext.mArena->allocate(sizeof(ExpressionMemberAccess));
+               CflatInvokeCtor(ExpressionMemberAccess, memberAccess)
+                  (memberOwner, memberIdentifier, memberTypeUsage);
+               expression = memberAccess;
+
+               // method call
+               if(isMethodCall)
+               {
+                  expression = parseExpressionMethodCall(pContext, memberAccess);
+
+                  if(expression)
+                  {
+                     Method* method = static_cast<ExpressionMethodCall*>(expression)->mMethod;
+
+                     if(method)
+                     {
+                        memberAccess->mMemberTypeUsage = method->mReturnTypeUsage;
+                     }
+                  }
                }
             }
-         }
-         else
-         {
-            throwCompileError(pContext, CompileError::Expected, ">");
-            return false;
          }
       }
       else
       {
-         throwCompileError(pContext, CompileError::Expected, "(");
-         return false;
+         tokenIndex = memberAccessTokenIndex;
+         throwCompileErrorUnexpectedSymbol(pContext);
       }
    }
-
-   const size_t closureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
-
-   if(closureTokenIndex > 0u)
+   // parenthesized expression
+   else if(tokens[tokenIndex].mStart[0] == '(')
    {
-      while(tokenIndex++ < closureTokenIndex)
-      {
-         const size_t separatorTokenIndex =
-            findSeparationTokenIndex(pContext, ',', closureTokenIndex);
-         const size_t tokenLastIndex = 
-           separatorTokenIndex > 0u ? separatorTokenIndex : closureTokenIndex;
+      const size_t closureTokenIndex = findClosureTokenIndex(pContext, '(', ')', pTokenLastIndex);
+      tokenIndex++;
 
-         Expression* argument = parseExpression(pContext, tokenLastIndex - 1u, true);
+      if(closureTokenIndex > tokenIndex)
+      {
+         Expression* innerExpression = parseExpression(pContext, closureTokenIndex - 1u);
 
-         if(argument)
+         if(innerExpression)
          {
-            pArguments->push_back(argument);
+            expression = (ExpressionParenthesized*)pContext.mArena->allocate(sizeof(ExpressionParenthesized));
+            CflatInvokeCtor(ExpressionParenthesized, expression)(innerExpression);
          }
 
-         tokenIndex = tokenLastIndex;
+         tokenIndex = closureTokenIndex + 1u;
+      }
+      else
+      {
+         throwCompileErrorUnexpectedSymbol(pContext);
       }
    }
-   else
+   // array initialization
+   else if(tokens[tokenIndex].mStart[0] == '{')
    {
-      throwCompileError(pContext, CompileError::Expected, ")");
-      return false;
-   }
+      tokenIndex++;
 
-   return true;
-}
+      ExpressionArrayInitialization* concreteExpression =
+         (ExpressionArrayInitialization*)pContext.mArena->allocate(sizeof(ExpressionArrayInitialization));
+      CflatInvokeCtor(ExpressionArrayInitialization, concreteExpression)();
+      expression = concreteExpression;
 
-TypeUsage Environment::getTypeUsage(Context& pContext, Expression* pExpression)
-{
-   TypeUsage typeUsage;
+      const size_t closureIndex = findClosureTokenIndex(pContext, '{', '}', pTokenLastIndex);
+
+      while(tokenIndex < closureIndex)
+      {
+         const size_t separatorIndex = findSeparationTokenIndex(pContext, ',', closureIndex);
+         const size_t lastArrayValueIndex = separatorIndex > 0u
+            ? separatorIndex - 1u
+            : closureIndex - 1u;
+
+         Expression* arrayValueExpression = parseExpression(pContext, lastArrayValueIndex);
+         concreteExpression->mValues.push_back(arrayValueExpression);
 
-   if(pExpression && mErrorMessage.empty())
+         tokenIndex = lastArrayValueIndex + 2u;
+      }
+   }
+   // unary operator (post)
+   else if(tokens[pTokenLastIndex].mType == TokenType::Operator)
    {
-      switch(pExpression->getType())
+      const Token& operatorToken = tokens[pTokenLastIndex];
+
+      if(operatorToken.mLength == 2u)
       {
-      case ExpressionType::Value:
-         {
-            ExpressionValue* expression = static_cast<ExpressionValue*>(pExpression);
-            typeUsage = expression->mValue.mTypeUsage;
-         }
-         break;
-      case ExpressionType::NullPointer:
-         {
-            typeUsage = mTypeUsageVoidPtr;
-         }
-         break;
-      case ExpressionType::VariableAccess:
+         if(strncmp(operatorToken.mStart, "++", 2u) == 0 ||
+            strncmp(operatorToken.mStart, "--", 2u) == 0)
          {
-            ExpressionVariableAccess* expression = static_cast<ExpressionVariableAccess*>(pExpression);
-            Instance* instance = retrieveInstance(pContext, expression->mVariableIdentifier);
-            typeUsage = instance->mTypeUsage;
+            CflatSTLString operatorStr(operatorToken.mStart, operatorToken.mLength);
+            Expression* operandExpression = parseExpression(pContext, pTokenLastIndex - 1u);
+
+            expression =
+               parseExpressionUnaryOperator(pContext, operandExpression, operatorStr.c_str(), true);
          }
-         break;
-      case ExpressionType::MemberAccess:
+      }
+
+      if(!expression)
+      {
+         throwCompileErrorUnexpectedSymbol(pContext);
+      }
+   }
+   // array element access / operator[]
+   else if(tokens[pTokenLastIndex].mStart[0] == ']')
+   {
+      const size_t openingIndex = findOpeningTokenIndex(pContext, '[', ']', pTokenLastIndex);
+
+      if(pTokenLastIndex > (openingIndex + 1u))
+      {
+         Expression* arrayAccess = parseExpression(pContext, openingIndex - 1u);
+
+         tokenIndex = openingIndex + 1u;
+         Expression* arrayElementIndex = parseExpression(pContext, pTokenLastIndex - 1u);
+
+         const TypeUsage typeUsage = getTypeUsage(pContext, arrayAccess);
+
+         if(typeUsage.isArray() || typeUsage.isPointer())
          {
-            ExpressionMemberAccess* expression = static_cast<ExpressionMemberAccess*>(pExpression);
-            typeUsage = expression->mMemberTypeUsage;
+            expression =
+               (ExpressionArrayElementAccess*)pContext.mArena->allocate(sizeof(ExpressionArrayElementAccess));
+            CflatInvokeCtor(ExpressionArrayElementAccess, expression)
+               (arrayAccess, arrayElementIndex);
          }
-         break;
-      case ExpressionType::ArrayElementAccess:
+         else if(typeUsage.mType->mCategory == TypeCategory::StructOrClass)
          {
-            ExpressionArrayElementAccess* expression =
-               static_cast<ExpressionArrayElementAccess*>(pExpression);
-            typeUsage = getTypeUsage(pContext, expression->mArray);
-            CflatAssert(typeUsage.isArray() || typeUsage.isPointer());
+            const Identifier operatorMethodID("operator[]");
+            Method* operatorMethod = findMethod(typeUsage.mType, operatorMethodID);
 
-            if(typeUsage.isArray())
+            if(operatorMethod)
             {
-               CflatResetFlag(typeUsage.mFlags, TypeUsageFlags::Array);
-               typeUsage.mArraySize = 1u;
+               ExpressionMemberAccess* memberAccess =
+                  (ExpressionMemberAccess*)pContext.mArena->allocate(sizeof(ExpressionMemberAccess));
+               CflatInvokeCtor(ExpressionMemberAccess, memberAccess)
+                  (arrayAccess, operatorMethodID, operatorMethod->mReturnTypeUsage);
+
+               ExpressionMethodCall* methodCall =
+                  (ExpressionMethodCall*)pContext.mArena->allocate(sizeof(ExpressionMethodCall));
+               CflatInvokeCtor(ExpressionMethodCall, methodCall)(memberAccess);
+               expression = methodCall;
+
+               methodCall->mArguments.push_back(arrayElementIndex);
+               methodCall->mMethod = operatorMethod;
             }
             else
             {
-               typeUsage.mPointerLevel--;
+               throwCompileErrorUnexpectedSymbol(pContext);
             }
          }
-         break;
-      case ExpressionType::UnaryOperation:
+         else
          {
-            ExpressionUnaryOperation* expression = static_cast<ExpressionUnaryOperation*>(pExpression);
-            typeUsage = expression->mOperator[0] == '!'
-               ? mTypeUsageBool
-               : getTypeUsage(pContext, expression->mExpression);
-            CflatResetFlag(typeUsage.mFlags, TypeUsageFlags::Reference);
+            throwCompileErrorUnexpectedSymbol(pContext);
          }
-         break;
-      case ExpressionType::BinaryOperation:
-         {
-            ExpressionBinaryOperation* expression = static_cast<ExpressionBinaryOperation*>(pExpression);
-
-            if(expression->mOverloadedOperatorTypeUsage.mType)
-            {
-               typeUsage = expression->mOverloadedOperatorTypeUsage;
-            }
-            else
-            {
-               bool logicalOperator = false;
-
-               for(size_t i = 0u; i < kCflatLogicalOperatorsCount; i++)
-               {
-                  if(strcmp(expression->mOperator, kCflatLogicalOperators[i]) == 0)
-                  {
-                     logicalOperator = true;
-                     break;
-                  }
-               }
 
-               if(logicalOperator)
-               {
-                  typeUsage = mTypeUsageBool;
-               }
-               else
+         tokenIndex = pTokenLastIndex + 1u;
+      }
+      else
+      {
+         throwCompileErrorUnexpectedSymbol(pContext);
+      }
+   }
+   else if(token.mType == TokenType::Identifier)
+   {
+      pContext.mStringBuffer.assign(token.mStart, token.mLength);
+
+      while(tokenIndex < (tokens.size() - 1u) && strncmp(tokens[++tokenIndex].mStart, "::", 2u) == 0)
+      {
+         tokenIndex++;
+         pContext.mStringBuffer.append("::");
+         pContext.mStringBuffer.append(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+      }
+
+      const Identifier fullIdentifier(pContext.mStringBuffer.c_str());
+      bool isFunctionCall = tokens[tokenIndex].mStart[0] == '(';
+         
+      if(!isFunctionCall && isTemplate(pContext, pTokenLastIndex))
+      {
+         const size_t templateClosureIndex =
+            findClosureTokenIndex(pContext, '<', '>', pTokenLastIndex);
+         isFunctionCall =
+            templateClosureIndex > 0u && tokens[templateClosureIndex + 1u].mStart[0] == '(';
+      }
+
+      // function call / object construction
+      if(isFunctionCall)
+      {
+         Type* type = findType(pContext, fullIdentifier);
+         expression = type
+            ? parseExpressionObjectConstruction(pContext, type)
+            : parseExpressionFunctionCall(pContext, fullIdentifier);
+      }
+      // variable access with namespace / static member access
+      else
+      {
+         Instance* instance = retrieveInstance(pContext, fullIdentifier);
+
+         if(!instance)
+         {
+            const char* lastSeparator = fullIdentifier.findLastSeparator();
+
+            if(lastSeparator)
+            {
+               char buffer[kDefaultLocalStringBufferSize];
+               const size_t containerIdentifierLength = lastSeparator - fullIdentifier.mName;
+               strncpy(buffer, fullIdentifier.mName, containerIdentifierLength);
+               buffer[containerIdentifierLength] = '\0';
+               const Identifier containerIdentifier(buffer);
+               const Identifier memberIdentifier(lastSeparator + 2);
+
+               Type* type = findType(pContext, containerIdentifier);
+
+               if(type && type->mCategory == TypeCategory::StructOrClass)
                {
-                  const TypeUsage leftTypeUsage = getTypeUsage(pContext, expression->mLeft);
-                  const TypeUsage rightTypeUsage = getTypeUsage(pContext, expression->mRight);
+                  instance =
+                     static_cast<Struct*>(type)->mInstancesHolder.retrieveInstance(memberIdentifier);
 
-                  if(leftTypeUsage.mType->isInteger() && !rightTypeUsage.mType->isInteger())
-                  {
-                     typeUsage = rightTypeUsage;
-                  }
-                  else
+                  if(!instance)
                   {
-                     typeUsage = leftTypeUsage;
-                  }
+                     CflatSTLString typeFullName;
+                     getTypeFullName(type, &typeFullName);
 
-                  CflatResetFlag(typeUsage.mFlags, TypeUsageFlags::Reference);
+                     throwCompileError(pContext, Environment::CompileError::MissingStaticMember,
+                        memberIdentifier.mName, typeFullName.c_str());
+                  }
                }
             }
          }
-         break;
-      case ExpressionType::Parenthesized:
-         {
-            ExpressionParenthesized* expression = static_cast<ExpressionParenthesized*>(pExpression);
-            typeUsage = getTypeUsage(pContext, expression->mExpression);
-         }
-         break;
-      case ExpressionType::AddressOf:
-         {
-            ExpressionAddressOf* expression = static_cast<ExpressionAddressOf*>(pExpression);
-            typeUsage = getTypeUsage(pContext, expression->mExpression);
-            typeUsage.mPointerLevel++;
-         }
-         break;
-      case ExpressionType::Indirection:
-         {
-            ExpressionIndirection* expression = static_cast<ExpressionIndirection*>(pExpression);
-            typeUsage = getTypeUsage(pContext, expression->mExpression);
-            typeUsage.mPointerLevel--;
-         }
-         break;
-      case ExpressionType::SizeOf:
-         {
-            typeUsage = mTypeUsageSizeT;
-         }
-         break;
-      case ExpressionType::Cast:
-         {
-            ExpressionCast* expression = static_cast<ExpressionCast*>(pExpression);
-            typeUsage = expression->mTypeUsage;
-         }
-         break;
-      case ExpressionType::Conditional:
-         {
-            ExpressionConditional* expression = static_cast<ExpressionConditional*>(pExpression);
-            typeUsage = getTypeUsage(pContext, expression->mIfExpression);
-         }
-         break;
-      case ExpressionType::Assignment:
-         {
-            ExpressionAssignment* expression = static_cast<ExpressionAssignment*>(pExpression);
-            typeUsage = getTypeUsage(pContext, expression->mRightValue);
-         }
-         break;
-      case ExpressionType::FunctionCall:
+
+         if(instance)
          {
-            ExpressionFunctionCall* expression = static_cast<ExpressionFunctionCall*>(pExpression);
-            typeUsage = expression->mFunction->mReturnTypeUsage;
+            ExpressionVariableAccess* variableAccess =
+               (ExpressionVariableAccess*)pContext.mArena->allocate(sizeof(ExpressionVariableAccess));
+            CflatInvokeCtor(ExpressionVariableAccess, variableAccess)(fullIdentifier);
+            bindVariableAccess(pContext, instance, variableAccess);
+
+            expression = variableAccess;
          }
-         break;
-      case ExpressionType::MethodCall:
+         else
          {
-            ExpressionMethodCall* expression = static_cast<ExpressionMethodCall*>(pExpression);
-            typeUsage = expression->mMethod->mReturnTypeUsage;
+            throwCompileError(pContext, Environment::CompileError::UndefinedType,
+               fullIdentifier.mName);
          }
-         break;
-      case ExpressionType::ArrayInitialization:
+      }
+   }
+   else if(token.mType == TokenType::Keyword)
+   {
+      if(strncmp(token.mStart, "sizeof", 6u) == 0)
+      {
+         if(tokens[tokenIndex + 1u].mStart[0] == '(')
          {
-            ExpressionArrayInitialization* expression =
-               static_cast<ExpressionArrayInitialization*>(pExpression);
-            typeUsage.mType = expression->mElementType;
-            CflatSetFlag(typeUsage.mFlags, TypeUsageFlags::Array);
-            typeUsage.mArraySize = (uint16_t)expression->mValues.size();
+            tokenIndex++;
+            const size_t closureTokenIndex =
+               findClosureTokenIndex(pContext, '(', ')', pTokenLastIndex);
+            tokenIndex++;
+
+            ExpressionSizeOf* concreteExpression =
+               (ExpressionSizeOf*)pContext.mArena->allocate(sizeof(ExpressionSizeOf));
+            CflatInvokeCtor(ExpressionSizeOf, concreteExpression)();
+            expression = concreteExpression;
+
+            concreteExpression->mTypeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+
+            if(!concreteExpression->mTypeUsage.mType)
+            {
+               concreteExpression->mExpression = parseExpression(pContext, closureTokenIndex - 1u);
+            }
+
+            tokenIndex = closureTokenIndex;
          }
-         break;
-      case ExpressionType::ObjectConstruction:
+         else
          {
-            ExpressionObjectConstruction* expression =
-              static_cast<ExpressionObjectConstruction*>(pExpression);
-            typeUsage.mType = expression->mObjectType;
+            throwCompileErrorUnexpectedSymbol(pContext);
          }
-         break;
-      default:
-         CflatAssert(false);
-         break;
       }
+      else if(strncmp(token.mStart, "static_cast", 11u) == 0)
+      {
+         tokenIndex++;
+         expression = parseExpressionCast(pContext, CastType::Static, pTokenLastIndex);
+      }
+      else if(strncmp(token.mStart, "dynamic_cast", 12u) == 0)
+      {
+         tokenIndex++;
+         expression = parseExpressionCast(pContext, CastType::Dynamic, pTokenLastIndex);
+      }
+      else if(strncmp(token.mStart, "reinterpret_cast", 16u) == 0)
+      {
+         tokenIndex++;
+         expression = parseExpressionCast(pContext, CastType::Reinterpret, pTokenLastIndex);
+      }
+   }
+   else if(token.mType == TokenType::String)
+   {
+      expression = parseExpressionLiteralString(pContext);
    }
 
-   return typeUsage;
+   return expression;
 }
 
-Type* Environment::findType(const Context& pContext, const Identifier& pIdentifier,
-   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+Expression* Environment::parseExpressionLiteralString(ParsingContext& pContext)
 {
-   Type* type = nullptr;
+   pContext.mStringBuffer.clear();
 
-   for(size_t i = 0u; i < pContext.mTypeAliases.size(); i++)
+   do
    {
-      if(pContext.mTypeAliases[i].mIdentifier == pIdentifier)
+      const Token& token = pContext.mTokens[pContext.mTokenIndex];
+
+      for(size_t i = 1u; i < (token.mLength - 1u); i++)
       {
-         const TypeUsage& typeUsage = pContext.mTypeAliases[i].mTypeUsage;
+         const char currentChar = *(token.mStart + i);
 
-         if(typeUsage.mFlags == 0u)
+         if(currentChar == '\\')
          {
-            type = typeUsage.mType;
-            break;
-         }
-      }
-   }
-
-   if(!type)
-   {
-      type = pContext.mNamespaceStack.back()->getType(pIdentifier, pTemplateTypes, true);
-   }
+            const char escapeChar = *(token.mStart + i + 1u);
 
-   if(!type)
-   {
-      for(size_t i = 0u; i < pContext.mUsingDirectives.size(); i++)
-      {
-         type = pContext.mUsingDirectives[i].mNamespace->getType(pIdentifier, pTemplateTypes);
+            if(escapeChar == 'n')
+            {
+               pContext.mStringBuffer.push_back('\n');
+            }
+            else
+            {
+               pContext.mStringBuffer.push_back('\\');
+            }
 
-         if(type)
+            i++;
+         }
+         else
          {
-            break;
+            pContext.mStringBuffer.push_back(currentChar);
          }
       }
+
+      pContext.mTokenIndex++;
    }
+   while(pContext.mTokenIndex < pContext.mTokens.size() &&
+      pContext.mTokens[pContext.mTokenIndex].mType == TokenType::String);
 
-   return type;
-}
+   pContext.mStringBuffer.push_back('\0');
 
-Function* Environment::findFunction(const Context& pContext, const Identifier& pIdentifier,
-   const CflatArgsVector(TypeUsage)& pParameterTypes,
-   const CflatArgsVector(TypeUsage)& pTemplateTypes)
-{
-   Namespace* ns = pContext.mNamespaceStack.back();
-   Function* function = ns->getFunction(pIdentifier, pParameterTypes, pTemplateTypes, true);
+   const Hash stringHash = hash(pContext.mStringBuffer.c_str());
+   const char* string =
+      mLiteralStringsPool.registerString(stringHash, pContext.mStringBuffer.c_str());
 
-   if(!function)
-   {
-      for(size_t i = 0u; i < pContext.mUsingDirectives.size(); i++)
-      {
-         Namespace* usingNS = pContext.mUsingDirectives[i].mNamespace;
-         function =
-            usingNS->getFunction(pIdentifier, pParameterTypes, pTemplateTypes, true);
+   Value value;
+   value.initOnStack(mTypeUsageCString, &mExecutionContext.mStack);
+   value.set(&string);
 
-         if(function)
-         {
-            break;
-         }
-      }
-   }
+   ExpressionValue* expression = (ExpressionValue*)pContext.mArena->allocate(sizeof(ExpressionValue));
+   CflatInvokeCtor(ExpressionValue, expression)(value);
+   expression->mStringsPool = &mLiteralStringsPool;
 
-   return function;
+   return expression;
 }
 
-Function* Environment::findFunction(const Context& pContext, const Identifier& pIdentifier,
-   const CflatArgsVector(Value)& pArguments,
-   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+Expression* Environment::parseExpressionUnaryOperator(ParsingContext& pContext, Expression* pOperand,
+   const char* pOperator, bool pPostOperator)
 {
-   CflatArgsVector(TypeUsage) typeUsages;
-
-   for(size_t i = 0u; i < pArguments.size(); i++)
-   {
-      typeUsages.push_back(pArguments[i].mTypeUsage);
-   }
+   Expression* expression = nullptr;
+   bool validOperation = true;
 
-   return findFunction(pContext, pIdentifier, typeUsages, pTemplateTypes);
-}
+   const bool isIncrementOrDecrement =
+      strncmp(pOperator, "++", 2u) == 0 ||
+      strncmp(pOperator, "--", 2u) == 0;
 
-void Environment::registerTypeAlias(
-  Context& pContext, const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
-{
-   if(pContext.mScopeLevel > 0u)
+   if(isIncrementOrDecrement)
    {
-      TypeAlias typeAlias(pIdentifier, pTypeUsage);
-      typeAlias.mScopeLevel = pContext.mScopeLevel;
-      pContext.mTypeAliases.push_back(typeAlias);
+      const TypeUsage operandTypeUsage = getTypeUsage(pContext, pOperand);
+
+      if(operandTypeUsage.isConst())
+      {
+         throwCompileError(pContext, Environment::CompileError::CannotModifyConstExpression);
+         validOperation = false;
+      }
    }
-   else
+
+   if(validOperation)
    {
-      pContext.mNamespaceStack.back()->registerTypeAlias(pIdentifier, pTypeUsage);
+      expression = (ExpressionUnaryOperation*)pContext.mArena->allocate(sizeof(ExpressionUnaryOperation));
+      CflatInvokeCtor(ExpressionUnaryOperation, expression)
+         (pOperand, getOperatorType(pOperator, true), pPostOperator);
    }
+
+   return expression;
 }
 
-Instance* Environment::registerInstance(Context& pContext,
-   const TypeUsage& pTypeUsage, const Identifier& pIdentifier)
+Expression* Environment::parseExpressionCast(ParsingContext& pContext, CastType pCastType,
+   size_t pTokenLastIndex)
 {
-   Instance* instance = nullptr;
-   bool initializationRequired = false;
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   Expression* expression = nullptr;
 
-   if(pContext.mScopeLevel > 0u)
-   {
-      instance = pContext.mLocalInstancesHolder.registerInstance(pTypeUsage, pIdentifier);
-      initializationRequired = true;
-   }
-   else
+   if(tokens[tokenIndex].mStart[0] == '<')
    {
-      instance = pContext.mNamespaceStack.back()->retrieveInstance(pIdentifier);
+      tokenIndex++;
+      const TypeUsage targetTypeUsage = parseTypeUsage(pContext, pTokenLastIndex - 1u);
 
-      if(!instance)
-      {
-         instance = pContext.mNamespaceStack.back()->registerInstance(pTypeUsage, pIdentifier);
-         initializationRequired = true;
-      }
-      else if(instance->mTypeUsage != pTypeUsage)
+      if(targetTypeUsage.mType)
       {
-         instance->mTypeUsage = pTypeUsage;
-         initializationRequired = true;
-      }
-   }
+         if(tokens[tokenIndex].mStart[0] == '>')
+         {
+            tokenIndex++;
 
-   CflatAssert(instance);
+            if(tokens[tokenIndex].mStart[0] == '(')
+            {
+               tokenIndex++;
+               const size_t closureTokenIndex =
+                  findClosureTokenIndex(pContext, '(', ')', pTokenLastIndex);
 
-   if(initializationRequired)
-   {
-      if(instance->mTypeUsage.isReference())
-      {
-         instance->mValue.initExternal(instance->mTypeUsage);
-      }
-      else if(pContext.mScopeLevel == 0u)
-      {
-         instance->mValue.initOnHeap(instance->mTypeUsage);
+               if(closureTokenIndex > 0u)
+               {
+                  Expression* expressionToCast = parseExpression(pContext, closureTokenIndex - 1u);
+                  const TypeUsage sourceTypeUsage = getTypeUsage(pContext, expressionToCast);
+
+                  if(isCastAllowed(pCastType, sourceTypeUsage, targetTypeUsage))
+                  {
+                     expression = (ExpressionCast*)pContext.mArena->allocate(sizeof(ExpressionCast));
+                     CflatInvokeCtor(ExpressionCast, expression)
+                        (pCastType, targetTypeUsage, expressionToCast);
+                  }
+                  else
+                  {
+                     throwCompileError(pContext, CompileError::InvalidCast);
+                  }
+               }
+               else
+               {
+                  tokenIndex = pTokenLastIndex - 1u;
+                  throwCompileErrorUnexpectedSymbol(pContext);
+               }
+            }
+            else
+            {
+               throwCompileErrorUnexpectedSymbol(pContext);
+            }
+         }
       }
       else
       {
-         instance->mValue.initOnStack(instance->mTypeUsage, &pContext.mStack);
+         throwCompileErrorUnexpectedSymbol(pContext);
       }
    }
+   else
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+   }
 
-   CflatAssert(instance->mTypeUsage == pTypeUsage);
-
-   instance->mScopeLevel = pContext.mScopeLevel;
-
-   return instance;
+   return expression;
 }
 
-Instance* Environment::registerStaticInstance(Context& pContext, const TypeUsage& pTypeUsage,
-   const Identifier& pIdentifier, void* pUniquePtr)
+Expression* Environment::parseExpressionFunctionCall(ParsingContext& pContext,
+   const Identifier& pFunctionIdentifier)
 {
-   Instance* instance = pContext.mNamespaceStack.back()->registerInstance(pTypeUsage, pIdentifier);
-   instance->mScopeLevel = pContext.mScopeLevel;
-
-   Value* staticValue = nullptr;
+   ExpressionFunctionCall* expression =
+      (ExpressionFunctionCall*)pContext.mArena->allocate(sizeof(ExpressionFunctionCall));
+   CflatInvokeCtor(ExpressionFunctionCall, expression)(pFunctionIdentifier);
 
-   const uint64_t uniqueID = (uint64_t)pUniquePtr;
-   StaticValuesRegistry::const_iterator it = mStaticValues.find(uniqueID);
+   parseFunctionCallArguments(pContext, &expression->mArguments, &expression->mTemplateTypes);
 
-   if(it == mStaticValues.end())
+   if(!mErrorMessage.empty())
    {
-      mStaticValues[uniqueID] = Value();
-      staticValue = &mStaticValues[uniqueID];
-      staticValue->initOnHeap(pTypeUsage);
+      return nullptr;
    }
 
-   instance->mValue = mStaticValues[uniqueID];
+   CflatArgsVector(TypeUsage) argumentTypes;
 
-   return instance;
-}
+   for(size_t i = 0u; i < expression->mArguments.size(); i++)
+   {
+      const TypeUsage typeUsage = getTypeUsage(pContext, expression->mArguments[i]);
+      argumentTypes.push_back(typeUsage);
+   }
 
-Instance* Environment::retrieveInstance(Context& pContext, const Identifier& pIdentifier)
-{
-   Instance* instance = pContext.mLocalInstancesHolder.retrieveInstance(pIdentifier);
+   CflatArgsVector(TypeUsage) templateTypes;
+   toArgsVector(expression->mTemplateTypes, templateTypes);
 
-   if(!instance)
+   expression->mFunction = findFunction(pContext, pFunctionIdentifier, argumentTypes, templateTypes);
+
+   if(!expression->mFunction)
    {
-      instance = pContext.mNamespaceStack.back()->retrieveInstance(pIdentifier, true);
+      const char* lastSeparator = pFunctionIdentifier.findLastSeparator();
 
-      if(!instance)
+      if(lastSeparator)
       {
-         for(size_t i = 0u; i < pContext.mUsingDirectives.size(); i++)
-         {
-            instance = pContext.mUsingDirectives[i].mNamespace->retrieveInstance(pIdentifier, true);
-
-            if(instance)
-            {
-               break;
-            }
-         }
-      }
+         char buffer[kDefaultLocalStringBufferSize];
+         const size_t typeIdentifierLength = lastSeparator - pFunctionIdentifier.mName;
+         strncpy(buffer, pFunctionIdentifier.mName, typeIdentifierLength);
+         buffer[typeIdentifierLength] = '\0';
+         const Identifier typeIdentifier(buffer);
+         const Identifier staticMethodIdentifier(lastSeparator + 2);
 
-      if(!instance)
-      {
-         const char* lastSeparator = pIdentifier.findLastSeparator();
+         Type* type = findType(pContext, typeIdentifier);
 
-         if(lastSeparator)
+         if(type && type->mCategory == TypeCategory::StructOrClass)
          {
-            char buffer[kDefaultLocalStringBufferSize];
-            const size_t typeIdentifierLength = lastSeparator - pIdentifier.mName;
-            strncpy(buffer, pIdentifier.mName, typeIdentifierLength);
-            buffer[typeIdentifierLength] = '\0';
-            const Identifier typeIdentifier(buffer);
-            const Identifier staticMemberIdentifier(lastSeparator + 2);
-
-            Type* type = findType(pContext, typeIdentifier);
+            Struct* castedType = static_cast<Struct*>(type);
+            expression->mFunction =
+               castedType->getStaticMethod(staticMethodIdentifier, argumentTypes, templateTypes);
 
-            if(type && type->mCategory == TypeCategory::StructOrClass)
+            if(!expression->mFunction)
             {
-               instance = static_cast<Struct*>(type)->getStaticMemberInstance(staticMemberIdentifier);
+               CflatSTLString typeFullName;
+               getTypeFullName(type, &typeFullName);
+
+               throwCompileError(pContext, CompileError::MissingStaticMethod,
+                  staticMethodIdentifier.mName, typeFullName.c_str());
             }
          }
       }
    }
 
-   return instance;
-}
-
-void Environment::incrementBlockLevel(Context& pContext)
-{
-   pContext.mBlockLevel++;
-}
-
-void Environment::decrementBlockLevel(Context& pContext)
-{
-   while(!pContext.mUsingDirectives.empty() &&
-      pContext.mUsingDirectives.back().mBlockLevel >= pContext.mBlockLevel)
+   if(!expression->mFunction)
    {
-      pContext.mUsingDirectives.pop_back();
+      CflatInvokeDtor(ExpressionFunctionCall, expression);
+      expression = nullptr;
+
+      throwCompileError(pContext, CompileError::UndefinedFunction, pFunctionIdentifier.mName);
    }
 
-   pContext.mBlockLevel--;
+   return expression;
 }
 
-void Environment::incrementScopeLevel(Context& pContext)
+Expression* Environment::parseExpressionMethodCall(ParsingContext& pContext, Expression* pMemberAccess)
 {
-   pContext.mScopeLevel++;
-}
+   ExpressionMethodCall* expression = 
+      (ExpressionMethodCall*)pContext.mArena->allocate(sizeof(ExpressionMethodCall));
+   CflatInvokeCtor(ExpressionMethodCall, expression)(pMemberAccess);
 
-void Environment::decrementScopeLevel(Context& pContext)
-{
-   const bool isExecutionContext = pContext.mType == ContextType::Execution;
+   pContext.mTokenIndex++;
+   parseFunctionCallArguments(pContext, &expression->mArguments, &expression->mTemplateTypes);
 
-   if(!isExecutionContext)
+   if(!mErrorMessage.empty())
    {
-      ParsingContext& parsingContext = static_cast<ParsingContext&>(pContext);
+      return nullptr;
+   }
 
-      while(!parsingContext.mRegisteredInstances.empty() &&
-         parsingContext.mRegisteredInstances.back().mScopeLevel >= pContext.mScopeLevel)
-      {
-         parsingContext.mRegisteredInstances.pop_back();
-      }
+   ExpressionMemberAccess* memberAccess = static_cast<ExpressionMemberAccess*>(pMemberAccess);
+   const TypeUsage methodOwnerTypeUsage = getTypeUsage(pContext, memberAccess->mMemberOwner);
 
-      while(!parsingContext.mLocalNamespaceStack.empty() &&
-         parsingContext.mLocalNamespaceStack.back().mScopeLevel >= pContext.mScopeLevel)
-      {
-         parsingContext.mLocalNamespaceStack.pop_back();
-      }
-   }
+   Type* methodOwnerType = methodOwnerTypeUsage.mType;
+   CflatAssert(methodOwnerType);
+   CflatAssert(methodOwnerType->mCategory == TypeCategory::StructOrClass);
 
-   while(!pContext.mTypeAliases.empty() &&
-      pContext.mTypeAliases.back().mScopeLevel >= pContext.mScopeLevel)
+   CflatArgsVector(TypeUsage) argumentTypes;
+
+   for(size_t i = 0u; i < expression->mArguments.size(); i++)
    {
-      pContext.mTypeAliases.pop_back();
+      const TypeUsage typeUsage = getTypeUsage(pContext, expression->mArguments[i]);
+      argumentTypes.push_back(typeUsage);
    }
 
-   pContext.mLocalInstancesHolder.releaseInstances(pContext.mScopeLevel, isExecutionContext);
-   mGlobalNamespace.releaseInstances(pContext.mScopeLevel, isExecutionContext);
+   CflatArgsVector(TypeUsage) templateTypes;
+   toArgsVector(expression->mTemplateTypes, templateTypes);
 
-   pContext.mScopeLevel--;
+   const Identifier& methodId = memberAccess->mMemberIdentifier;
+   expression->mMethod = findMethod(methodOwnerType, methodId, argumentTypes, templateTypes);
+
+   if(!expression->mMethod)
+   {
+      throwCompileError(pContext, CompileError::MissingMethod, methodId.mName);
+   }
+
+   return expression;
 }
 
-void Environment::throwRuntimeError(ExecutionContext& pContext, RuntimeError pError, const char* pArg)
+Expression* Environment::parseExpressionObjectConstruction(ParsingContext& pContext, Type* pType)
 {
+   ExpressionObjectConstruction* expression =
+      (ExpressionObjectConstruction*)pContext.mArena->allocate(sizeof(ExpressionObjectConstruction));
+   CflatInvokeCtor(ExpressionObjectConstruction, expression)(pType);
+
+   parseFunctionCallArguments(pContext, &expression->mArguments);
+
    if(!mErrorMessage.empty())
-      return;
+   {
+      return nullptr;
+   }
 
-   char errorMsg[kDefaultLocalStringBufferSize];
-   sprintf(errorMsg, kRuntimeErrorStrings[(int)pError], pArg);
+   CflatArgsVector(TypeUsage) argumentTypes;
 
-   char lineAsString[16];
-   sprintf(lineAsString, "%d", pContext.mCallStack.back().mLine);
+   for(size_t i = 0u; i < expression->mArguments.size(); i++)
+   {
+      const TypeUsage typeUsage = getTypeUsage(pContext, expression->mArguments[i]);
+      argumentTypes.push_back(typeUsage);
+   }
 
-   mErrorMessage.assign("[Runtime Error] '");
-   mErrorMessage.append(pContext.mProgram->mIdentifier.mName);
-   mErrorMessage.append("' -- Line ");
-   mErrorMessage.append(lineAsString);
-   mErrorMessage.append(": ");
-   mErrorMessage.append(errorMsg);
+   expression->mConstructor = findConstructor(pType, argumentTypes);
+
+   if(!expression->mConstructor)
+   {
+      throwCompileError(pContext, CompileError::MissingConstructor);
+   }
+
+   return expression;
 }
 
-void Environment::evaluateExpression(ExecutionContext& pContext, Expression* pExpression, Value* pOutValue)
+void Environment::matchBrackets(ParsingContext& pContext)
 {
-   if(!mErrorMessage.empty())
-      return;
+   const CflatSTLVector(Token)& tokens = pContext.mTokens;
+   CflatSTLVector(uint32_t)& matchingTokenIndices = pContext.mMatchingTokenIndices;
+   matchingTokenIndices.assign(tokens.size(), kNoMatchingTokenIndex);
 
-   switch(pExpression->getType())
+   // each kind of bracket gets matched regardless of the others, which gives the same results
+   // as counting the opening and closure tokens of a given kind when scanning the tokens
+   CflatSTLVector(uint32_t) openingTokenIndices[kBracketKindsCount];
+
+   for(size_t i = 0u; i < tokens.size(); i++)
    {
-   case ExpressionType::Value:
-      {
-         ExpressionValue* expression = static_cast<ExpressionValue*>(pExpression);
-         *pOutValue = expression->mValue;
-      }
-      break;
-   case ExpressionType::NullPointer:
+      if(tokens[i].mLength != 1u)
       {
-         assertValueInitialization(pContext, mTypeUsageVoidPtr, pOutValue);
-         const void* nullPointer = nullptr;
-         pOutValue->set(&nullPointer);
+         continue;
       }
-      break;
-   case ExpressionType::VariableAccess:
-      {
-         ExpressionVariableAccess* expression = static_cast<ExpressionVariableAccess*>(pExpression);
-         Instance* instance = retrieveInstance(pContext, expression->mVariableIdentifier);
 
-         if(pOutValue->mTypeUsage.isPointer() && instance->mTypeUsage.isArray())
+      for(size_t j = 0u; j < kBracketKindsCount; j++)
+      {
+         if(tokens[i].mStart[0] == kOpeningBrackets[j])
          {
-            getAddressOfValue(pContext, instance->mValue, pOutValue);
+            openingTokenIndices[j].push_back((uint32_t)i);
+            break;
          }
-         else
+         else if(tokens[i].mStart[0] == kClosureBrackets[j])
          {
-            *pOutValue = instance->mValue;
+            if(!openingTokenIndices[j].empty())
+            {
+               const uint32_t openingTokenIndex = openingTokenIndices[j].back();
+               openingTokenIndices[j].pop_back();
+
+               matchingTokenIndices[openingTokenIndex] = (uint32_t)i;
+               matchingTokenIndices[i] = openingTokenIndex;
+            }
+
+            break;
          }
       }
-      break;
-   case ExpressionType::MemberAccess:
-      {
-         ExpressionMemberAccess* expression = static_cast<ExpressionMemberAccess*>(pExpression);
-         getInstanceDataValue(pContext, expression, pOutValue);
-      }
-      break;
-   case ExpressionType::ArrayElementAccess:
-      {
-         ExpressionArrayElementAccess* expression =
-            static_cast<ExpressionArrayElementAccess*>(pExpression);
+   }
+}
 
-         TypeUsage arrayTypeUsage = getTypeUsage(pContext, expression->mArray);
-         CflatAssert(arrayTypeUsage.isArray() || arrayTypeUsage.isPointer());
+size_t Environment::findClosureTokenIndex(ParsingContext& pContext, char pOpeningChar, char pClosureChar,
+   size_t pTokenIndexLimit)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t closureTokenIndex = 0u;
 
-         TypeUsage arrayElementTypeUsage = arrayTypeUsage;
+   if(pTokenIndexLimit == 0u)
+   {
+      pTokenIndexLimit = pContext.mTokens.size() - 1u;
+   }
 
-         if(arrayElementTypeUsage.isArray())
-         {
-            CflatResetFlag(arrayElementTypeUsage.mFlags, TypeUsageFlags::Array);
-            arrayElementTypeUsage.mArraySize = 1u;
-         }
-         else
+   const bool bracketsMatched =
+      isBracketPair(pOpeningChar, pClosureChar) &&
+      pContext.mMatchingTokenIndices.size() == tokens.size();
+
+   if(tokens[pContext.mTokenIndex].mStart[0] == pClosureChar)
+   {
+      closureTokenIndex = pContext.mTokenIndex;
+   }
+   else if(bracketsMatched &&
+      tokens[pContext.mTokenIndex].mLength == 1u &&
+      tokens[pContext.mTokenIndex].mStart[0] == pOpeningChar)
+   {
+      const uint32_t matchingTokenIndex = pContext.mMatchingTokenIndices[pContext.mTokenIndex];
+
+      if(matchingTokenIndex != kNoMatchingTokenIndex && matchingTokenIndex <= pTokenIndexLimit)
+      {
+         closureTokenIndex = matchingTokenIndex;
+      }
+   }
+   else
+   {
+      uint32_t scopeLevel = 0u;
+
+      for(size_t i = (pContext.mTokenIndex + 1u); i <= pTokenIndexLimit; i++)
+      {
+         if(tokens[i].mLength > 1u)
          {
-            arrayElementTypeUsage.mPointerLevel--;
+            continue;
          }
-         
-         assertValueInitialization(pContext, arrayElementTypeUsage, pOutValue);
 
-         Value arrayValue;
-         arrayValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, expression->mArray, &arrayValue);
+         if(tokens[i].mStart[0] == pClosureChar)
+         {
+            if(scopeLevel == 0u)
+            {
+               closureTokenIndex = i;
+               break;
+            }
 
-         Value indexValue;
-         indexValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, expression->mArrayElementIndex, &indexValue);
-         const size_t index = (size_t)getValueAsInteger(indexValue);
-         
-         if(arrayValue.mTypeUsage.isArray())
+            scopeLevel--;
+         }
+         else if(tokens[i].mStart[0] == pOpeningChar)
          {
-            const size_t arraySize = (size_t)arrayTypeUsage.mArraySize;
+            // the enclosed tokens get skipped at once
+            const uint32_t matchingTokenIndex =
+               bracketsMatched ? pContext.mMatchingTokenIndices[i] : kNoMatchingTokenIndex;
 
-            if(index < arraySize)
+            if(matchingTokenIndex != kNoMatchingTokenIndex && matchingTokenIndex <= pTokenIndexLimit)
             {
-               const size_t arrayElementSize = arrayElementTypeUsage.mType->mSize;
-               const size_t offset = arrayElementSize * index;
-               pOutValue->set(arrayValue.mValueBuffer + offset);
+               i = matchingTokenIndex;
             }
             else
             {
-               char buffer[kDefaultLocalStringBufferSize];
-               sprintf(buffer, "size %zu, index %zu", arraySize, index);
-               throwRuntimeError(pContext, RuntimeError::InvalidArrayIndex, buffer);
+               scopeLevel++;
             }
          }
-         else
-         {
-            const size_t arrayElementTypeSize = arrayElementTypeUsage.mType->mSize;
-            const size_t ptrOffset = arrayElementTypeSize * index;
-            const char* ptr = CflatValueAs(&arrayValue, char*) + ptrOffset;
-            memcpy(pOutValue->mValueBuffer, ptr, arrayElementTypeSize);
-         }
       }
-      break;
-   case ExpressionType::UnaryOperation:
-      {
-         ExpressionUnaryOperation* expression = static_cast<ExpressionUnaryOperation*>(pExpression);
+   }
 
-         const TypeUsage typeUsage = getTypeUsage(pContext, expression->mExpression);
-         assertValueInitialization(pContext, typeUsage, pOutValue);
+   return closureTokenIndex;
+}
 
-         Value preValue;
-         preValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, expression->mExpression, &preValue);
+size_t Environment::findOpeningTokenIndex(ParsingContext& pContext, char pOpeningChar, char pClosureChar,
+   size_t pClosureIndex)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t openingTokenIndex = pClosureIndex;
 
-         pOutValue->set(preValue.mValueBuffer);
+   const bool bracketsMatched =
+      isBracketPair(pOpeningChar, pClosureChar) &&
+      pContext.mMatchingTokenIndices.size() == tokens.size();
 
-         const bool isIncrementOrDecrement =
-            strncmp(expression->mOperator, "++", 2u) == 0 ||
-            strncmp(expression->mOperator, "--", 2u) == 0;
+   if(openingTokenIndex > 0u &&
+      bracketsMatched &&
+      tokens[pClosureIndex].mLength == 1u &&
+      tokens[pClosureIndex].mStart[0] == pClosureChar)
+   {
+      const uint32_t matchingTokenIndex = pContext.mMatchingTokenIndices[pClosureIndex];
 
-         if(isIncrementOrDecrement)
-         {
-            applyUnaryOperator(pContext, preValue, expression->mOperator, &preValue);
+      if(matchingTokenIndex != kNoMatchingTokenIndex && matchingTokenIndex >= pContext.mTokenIndex)
+      {
+         openingTokenIndex = matchingTokenIndex;
+      }
+   }
+   else if(openingTokenIndex > 0u)
+   {
+      uint32_t scopeLevel = 0u;
 
-            if(!expression->mPostOperator)
-            {
-               pOutValue->set(preValue.mValueBuffer);
-            }
-         }
-         else
+      for(int i = (int)pClosureIndex - 1; i >= (int)pContext.mTokenIndex; i--)
+      {
+         if(tokens[i].mLength > 1u)
          {
-            applyUnaryOperator(pContext, preValue, expression->mOperator, pOutValue);
+            continue;
          }
-      }
-      break;
-   case ExpressionType::BinaryOperation:
-      {
-         ExpressionBinaryOperation* expression = static_cast<ExpressionBinaryOperation*>(pExpression);
-
-         const TypeUsage typeUsage = getTypeUsage(pContext, expression);
-         assertValueInitialization(pContext, typeUsage, pOutValue);
-
-         Value leftValue;
-         leftValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, expression->mLeft, &leftValue);
 
-         Value rightValue;
-         bool evaluateRightValue = true;
-
-         if(strcmp(expression->mOperator, "&&") == 0)
+         if(tokens[i].mStart[0] == pOpeningChar)
          {
-            if(!getValueAsInteger(leftValue))
+            if(scopeLevel == 0u)
             {
-               const bool value = false;
-               rightValue.initOnStack(mTypeUsageBool, &pContext.mStack);
-               rightValue.set(&value);
-               evaluateRightValue = false;
+               openingTokenIndex = i;
+               break;
             }
+
+            scopeLevel--;
          }
-         else if(strcmp(expression->mOperator, "||") == 0)
+         else if(tokens[i].mStart[0] == pClosureChar)
          {
-            if(getValueAsInteger(leftValue))
+            // the enclosed tokens get skipped at once
+            const uint32_t matchingTokenIndex =
+               bracketsMatched ? pContext.mMatchingTokenIndices[i] : kNoMatchingTokenIndex;
+
+            if(matchingTokenIndex != kNoMatchingTokenIndex &&
+               matchingTokenIndex >= pContext.mTokenIndex)
             {
-               const bool value = true;
-               rightValue.initOnStack(mTypeUsageBool, &pContext.mStack);
-               rightValue.set(&value);
-               evaluateRightValue = false;
+               i = (int)matchingTokenIndex;
+            }
+            else
+            {
+               scopeLevel++;
             }
          }
-
-         if(evaluateRightValue)
-         {
-            rightValue.mValueInitializationHint = ValueInitializationHint::Stack;
-            evaluateExpression(pContext, expression->mRight, &rightValue);
-         }
-
-         applyBinaryOperator(pContext, leftValue, rightValue, expression->mOperator, pOutValue);
-      }
-      break;
-   case ExpressionType::Parenthesized:
-      {
-         ExpressionParenthesized* expression = static_cast<ExpressionParenthesized*>(pExpression);
-         evaluateExpression(pContext, expression->mExpression, pOutValue);
-      }
-      break;
-   case ExpressionType::AddressOf:
-      {
-         ExpressionAddressOf* expression = static_cast<ExpressionAddressOf*>(pExpression);
-
-         Value value;
-         value.initExternal(getTypeUsage(pContext, expression->mExpression));
-         evaluateExpression(pContext, expression->mExpression, &value);
-
-         pOutValue->mValueInitializationHint = ValueInitializationHint::Stack;
-         getAddressOfValue(pContext, value, pOutValue);
       }
-      break;
-   case ExpressionType::Indirection:
-      {
-         ExpressionIndirection* expression = static_cast<ExpressionIndirection*>(pExpression);
+   }
 
-         const TypeUsage expressionTypeUsage = getTypeUsage(pContext, expression->mExpression);
-         CflatAssert(expressionTypeUsage.mPointerLevel > 0u);
+   return openingTokenIndex;
+}
 
-         TypeUsage typeUsage = expressionTypeUsage;
-         typeUsage.mPointerLevel--;
-         pOutValue->mValueInitializationHint = ValueInitializationHint::Stack;
-         assertValueInitialization(pContext, typeUsage, pOutValue);
+size_t Environment::findSeparationTokenIndex(ParsingContext& pContext, char pSeparationChar,
+   size_t pClosureIndex)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t separationTokenIndex = 0u;
 
-         Value value;
-         value.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, expression->mExpression, &value);
+   const bool bracketsMatched = pContext.mMatchingTokenIndices.size() == tokens.size();
+   uint32_t scopeLevel = 0u;
 
-         applyUnaryOperator(pContext, value, "*", pOutValue);
-      }
-      break;
-   case ExpressionType::SizeOf:
+   for(size_t i = pContext.mTokenIndex; i < pClosureIndex; i++)
+   {
+      if(tokens[i].mLength > 1u)
       {
-         ExpressionSizeOf* expression = static_cast<ExpressionSizeOf*>(pExpression);
-         size_t size = 0u;
-         
-         if(expression->mTypeUsage.mType)
-         {
-            size = expression->mTypeUsage.getSize();
-         }
-         else if(expression->mExpression)
-         {
-            Value value;
-            value.mValueInitializationHint = ValueInitializationHint::Stack;
-            evaluateExpression(pContext, expression->mExpression, &value);
-            size = value.mTypeUsage.getSize();
-         }
-
-         assertValueInitialization(pContext, mTypeUsageSizeT, pOutValue);
-         pOutValue->set(&size);
+         continue;
       }
-      break;
-   case ExpressionType::Cast:
-      {
-         ExpressionCast* expression = static_cast<ExpressionCast*>(pExpression);
-
-         assertValueInitialization(pContext, expression->mTypeUsage, pOutValue);
 
-         Value valueToCast;
-         valueToCast.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, expression->mExpression, &valueToCast);
+      if(i > pContext.mTokenIndex && tokens[i].mStart[0] == pSeparationChar && scopeLevel == 0u)
+      {
+         separationTokenIndex = i;
+         break;
+      }
 
-         const TypeUsage& targetTypeUsage = expression->mTypeUsage;
+      if(tokens[i].mStart[0] == '(')
+      {
+         // the enclosed tokens get skipped at once
+         const uint32_t matchingTokenIndex =
+            bracketsMatched ? pContext.mMatchingTokenIndices[i] : kNoMatchingTokenIndex;
 
-         if(expression->mCastType == CastType::CStyle || expression->mCastType == CastType::Static)
-         {
-            performStaticCast(pContext, valueToCast, targetTypeUsage, pOutValue);
-         }
-         else if(expression->mCastType == CastType::Dynamic)
+         if(matchingTokenIndex != kNoMatchingTokenIndex && matchingTokenIndex < pClosureIndex)
          {
-            performInheritanceCast(pContext, valueToCast, targetTypeUsage, pOutValue);
+            i = matchingTokenIndex;
          }
-         else if(expression->mCastType == CastType::Reinterpret)
+         else
          {
-            const void* ptr = CflatValueAs(&valueToCast, void*);
-            pOutValue->set(&ptr);
+            scopeLevel++;
          }
       }
-      break;
-   case ExpressionType::Conditional:
+      else if(tokens[i].mStart[0] == ')')
       {
-         ExpressionConditional* expression = static_cast<ExpressionConditional*>(pExpression);
-
-         bool conditionMet = false;
-         {
-            Value conditionValue;
-            conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
-            evaluateExpression(pContext, expression->mCondition, &conditionValue);
-            conditionMet = getValueAsInteger(conditionValue) != 0;
-         }
-
-         Expression* valueSource = conditionMet
-            ? expression->mIfExpression
-            : expression->mElseExpression;
-         evaluateExpression(pContext, valueSource, pOutValue);
+         scopeLevel--;
       }
-      break;
-   case ExpressionType::Assignment:
-      {
-         ExpressionAssignment* expression = static_cast<ExpressionAssignment*>(pExpression);
+   }
 
-         const TypeUsage expressionTypeUsage = getTypeUsage(pContext, expression->mRightValue);
-         Value expressionValue;
-         expressionValue.initOnStack(expressionTypeUsage, &pContext.mStack);
-         evaluateExpression(pContext, expression->mRightValue, &expressionValue);
+   return separationTokenIndex;
+}
 
-         Value instanceDataValue;
-         getInstanceDataValue(pContext, expression->mLeftValue, &instanceDataValue);
+uint8_t Environment::getBinaryOperatorPrecedence(ParsingContext& pContext, size_t pTokenIndex)
+{
+   const Token& token = pContext.mTokens[pTokenIndex];
+   CflatAssert(token.mType == TokenType::Operator);
 
-         performAssignment(pContext, expressionValue, expression->mOperator, &instanceDataValue);
-         *pOutValue = instanceDataValue;
-      }
-      break;
-   case ExpressionType::FunctionCall:
-      {
-         ExpressionFunctionCall* expression = static_cast<ExpressionFunctionCall*>(pExpression);
+   uint8_t precedence = 0u;
 
-         Function* function = expression->mFunction;
-         CflatAssert(function);
+   for(size_t i = 0u; i < kCflatBinaryOperatorsCount; i++)
+   {
+      const size_t operatorLength = strlen(kCflatBinaryOperators[i]);
 
-         assertValueInitialization(pContext, function->mReturnTypeUsage, pOutValue);
+      if(token.mLength == operatorLength &&
+         strncmp(token.mStart, kCflatBinaryOperators[i], operatorLength) == 0)
+      {
+         precedence = kCflatBinaryOperatorsPrecedence[i];
+         break;
+      }
+   }
 
-         CflatArgsVector(Value) argumentValues;
-         getArgumentValues(pContext, expression->mArguments, argumentValues);
+   return precedence;
+}
 
-         CflatArgsVector(Value) preparedArgumentValues;
-         prepareArgumentsForFunctionCall(pContext, function->mParameters, argumentValues,
-            preparedArgumentValues);
+bool Environment::isTemplate(ParsingContext& pContext, size_t pOpeningTokenIndex, size_t pClosureTokenIndex)
+{
+   if(pClosureTokenIndex <= pOpeningTokenIndex)
+      return false;
 
-         const bool functionReturnValueIsConst =
-            CflatHasFlag(function->mReturnTypeUsage.mFlags, TypeUsageFlags::Const);
-         const bool outValueIsConst =
-            CflatHasFlag(pOutValue->mTypeUsage.mFlags, TypeUsageFlags::Const);
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
 
-         if(outValueIsConst && !functionReturnValueIsConst)
-         {
-            CflatResetFlag(pOutValue->mTypeUsage.mFlags, TypeUsageFlags::Const);
-         }
+   const Token& openingToken = tokens[pOpeningTokenIndex];
 
-         function->execute(preparedArgumentValues, pOutValue);
+   if(openingToken.mLength != 1u || openingToken.mStart[0] != '<')
+      return false;
 
-         if(outValueIsConst && !functionReturnValueIsConst)
-         {
-            CflatSetFlag(pOutValue->mTypeUsage.mFlags, TypeUsageFlags::Const);
-         }
+   const Token& closureToken = tokens[pClosureTokenIndex];
 
-         while(!preparedArgumentValues.empty())
-         {
-            preparedArgumentValues.pop_back();
-         }
+   if(closureToken.mLength != 1u || closureToken.mStart[0] != '>')
+      return false;
 
-         while(!argumentValues.empty())
-         {
-            argumentValues.pop_back();
-         }
-      }
-      break;
-   case ExpressionType::MethodCall:
+   for(size_t i = pOpeningTokenIndex + 1u; i < pClosureTokenIndex; i++)
+   {
+      if(tokens[i].mType == TokenType::Operator)
       {
-         ExpressionMethodCall* expression = static_cast<ExpressionMethodCall*>(pExpression);
-         ExpressionMemberAccess* memberAccess =
-            static_cast<ExpressionMemberAccess*>(expression->mMemberAccess);
-
-         Method* method = expression->mMethod;
-         CflatAssert(method);
-
-         assertValueInitialization(pContext, method->mReturnTypeUsage, pOutValue);
-
-         Value instanceDataValue;
-         getInstanceDataValue(pContext, memberAccess->mMemberOwner, &instanceDataValue);
+         const bool isPointerOperator =
+            tokens[i].mLength == 1u &&
+            tokens[i].mStart[0] == '*' &&
+            tokens[i - 1u].mType == TokenType::Identifier;
 
-         if(instanceDataValue.mTypeUsage.isPointer() && !CflatValueAs(&instanceDataValue, void*))
-         {
-            throwRuntimeError(pContext, RuntimeError::NullPointerAccess,
-               memberAccess->mMemberIdentifier.mName);
-         }
+         if(!isPointerOperator)
+            return false;
+      }
+   }
 
-         if(!mErrorMessage.empty())
-            break;
+   return true;
+}
 
-         CflatArgsVector(Value) argumentValues;
-         getArgumentValues(pContext, expression->mArguments, argumentValues);
+bool Environment::isTemplate(ParsingContext& pContext, size_t pTokenLastIndex)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
 
-         CflatArgsVector(Value) preparedArgumentValues;
-         prepareArgumentsForFunctionCall(pContext, method->mParameters, argumentValues,
-            preparedArgumentValues);
+   if(tokens[tokenIndex].mLength != 1u || tokens[tokenIndex].mStart[0] != '<')
+      return false;
 
-         {
-            Value thisPtr;
+   const size_t templateClosureTokenIndex =
+      findClosureTokenIndex(pContext, '<', '>', pTokenLastIndex);
 
-            if(instanceDataValue.mTypeUsage.isPointer())
-            {
-               thisPtr.initOnStack(instanceDataValue.mTypeUsage, &pContext.mStack);
-               thisPtr.set(instanceDataValue.mValueBuffer);
-            }
-            else
-            {
-               thisPtr.mValueInitializationHint = ValueInitializationHint::Stack;
-               getAddressOfValue(pContext, instanceDataValue, &thisPtr);
-            }
+   return isTemplate(pContext, tokenIndex, templateClosureTokenIndex);
+}
 
-            method->execute(thisPtr, preparedArgumentValues, pOutValue);
-         }
+bool Environment::isCastAllowed(CastType pCastType, const TypeUsage& pFrom, const TypeUsage& pTo)
+{
+   bool castAllowed = false;
 
-         while(!preparedArgumentValues.empty())
-         {
-            preparedArgumentValues.pop_back();
-         }
-
-         while(!argumentValues.empty())
-         {
-            argumentValues.pop_back();
-         }
-      }
-      break;
-   case ExpressionType::ArrayInitialization:
+   switch(pCastType)
+   {
+   case CastType::CStyle:
+   case CastType::Static:
+      if(pFrom.mType->mCategory == TypeCategory::BuiltIn &&
+         pTo.mType->mCategory == TypeCategory::BuiltIn)
       {
-         ExpressionArrayInitialization* expression =
-            static_cast<ExpressionArrayInitialization*>(pExpression);
-
-         TypeUsage arrayElementTypeUsage;
-         arrayElementTypeUsage.mType = expression->mElementType;
-
-         TypeUsage arrayTypeUsage;
-         arrayTypeUsage.mType = expression->mElementType;
-         CflatSetFlag(arrayTypeUsage.mFlags, TypeUsageFlags::Array);
-         arrayTypeUsage.mArraySize = (uint16_t)expression->mValues.size();
-
-         assertValueInitialization(pContext, arrayTypeUsage, pOutValue);
-
-         for(size_t i = 0u; i < expression->mValues.size(); i++)
-         {
-            Value arrayElementValue;
-            arrayElementValue.initOnStack(arrayElementTypeUsage, &pContext.mStack);
-            evaluateExpression(pContext, expression->mValues[i], &arrayElementValue);
-
-            const size_t arrayElementSize = expression->mElementType->mSize;
-            const size_t offset = i * arrayElementSize;
-            memcpy(pOutValue->mValueBuffer + offset, arrayElementValue.mValueBuffer, arrayElementSize);
-         }
+         castAllowed = true;
       }
-      break;
-   case ExpressionType::ObjectConstruction:
+      else if(pFrom.mType->mCategory == TypeCategory::StructOrClass &&
+         pFrom.isPointer() &&
+         pTo.mType->mCategory == TypeCategory::StructOrClass &&
+         pTo.isPointer())
       {
-         ExpressionObjectConstruction* expression =
-            static_cast<ExpressionObjectConstruction*>(pExpression);
-
-         Method* ctor = expression->mConstructor;
-         CflatAssert(ctor);
-
-         TypeUsage typeUsage;
-         typeUsage.mType = expression->mObjectType;
-         assertValueInitialization(pContext, typeUsage, pOutValue);
-
-         CflatArgsVector(Value) argumentValues;
-         getArgumentValues(pContext, expression->mArguments, argumentValues);
-
-         {
-            Value thisPtr;
-            thisPtr.mValueInitializationHint = ValueInitializationHint::Stack;
-            getAddressOfValue(pContext, *pOutValue, &thisPtr);
-
-            ctor->execute(thisPtr, argumentValues, nullptr);
-         }
-
-         while(!argumentValues.empty())
-         {
-            argumentValues.pop_back();
-         }
+         Struct* sourceType = static_cast<Struct*>(pFrom.mType);
+         Struct* targetType = static_cast<Struct*>(pTo.mType);
+         castAllowed =
+            sourceType->derivedFrom(targetType) || targetType->derivedFrom(sourceType);
       }
       break;
+   case CastType::Dynamic:
+      castAllowed =
+         pFrom.isPointer() &&
+         pFrom.mType->mCategory == TypeCategory::StructOrClass &&
+         pTo.isPointer() &&
+         pTo.mType->mCategory == TypeCategory::StructOrClass;
+      break;
+   case CastType::Reinterpret:
+      castAllowed =
+         pFrom.isPointer() &&
+         pTo.isPointer();
+      break;
    default:
       break;
    }
+
+   return castAllowed;
 }
 
-void Environment::getInstanceDataValue(ExecutionContext& pContext, Expression* pExpression,
-   Value* pOutValue)
+Statement* Environment::parseStatement(ParsingContext& pContext)
 {
-   if(pExpression->getType() == ExpressionType::VariableAccess)
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
+
+   Statement* statement = nullptr;
+   const uint16_t statementLine = token.mLine;
+
+   if(token.mType == TokenType::Punctuation && (token.mStart[0] == '{' || token.mStart[0] == '}'))
    {
-      ExpressionVariableAccess* variableAccess =
-         static_cast<ExpressionVariableAccess*>(pExpression);
-      Instance* instance = retrieveInstance(pContext, variableAccess->mVariableIdentifier);
-      *pOutValue = instance->mValue;
+      // block
+      if(token.mStart[0] == '{')
+      {
+         statement = parseStatementBlock(pContext, true, false);
+      }
    }
-   else if(pExpression->getType() == ExpressionType::MemberAccess)
+   else if(token.mType == TokenType::Keyword &&
+      strncmp(token.mStart, "const", 5u) != 0 &&
+      strncmp(token.mStart, "static", 6u) != 0 &&
+      strncmp(token.mStart, "void", 4u) != 0)
    {
-      ExpressionMemberAccess* memberAccess =
-         static_cast<ExpressionMemberAccess*>(pExpression);
-
-      Member* member = nullptr;
-      char* instanceDataPtr = nullptr;
-
-      evaluateExpression(pContext, memberAccess->mMemberOwner, &memberAccess->mMemberOwnerValue);
-
-      if(memberAccess->mMemberOwnerValue.mTypeUsage.isPointer() &&
-         !CflatValueAs(&memberAccess->mMemberOwnerValue, void*))
+      // if
+      if(strncmp(token.mStart, "if", 2u) == 0)
       {
-         throwRuntimeError(pContext, RuntimeError::NullPointerAccess,
-            memberAccess->mMemberIdentifier.mName);
+         tokenIndex++;
+         statement = parseStatementIf(pContext);
       }
-
-      if(!mErrorMessage.empty())
-         return;
-
-      Struct* type = static_cast<Struct*>(memberAccess->mMemberOwnerValue.mTypeUsage.mType);
-
-      for(size_t j = 0u; j < type->mMembers.size(); j++)
+      // switch
+      else if(strncmp(token.mStart, "switch", 6u) == 0)
       {
-         if(type->mMembers[j].mIdentifier == memberAccess->mMemberIdentifier)
-         {
-            member = &type->mMembers[j];
-            instanceDataPtr = memberAccess->mMemberOwnerValue.mTypeUsage.isPointer()
-               ? CflatValueAs(&memberAccess->mMemberOwnerValue, char*)
-               : memberAccess->mMemberOwnerValue.mValueBuffer;
-            break;
-         }
+         tokenIndex++;
+         statement = parseStatementSwitch(pContext);
       }
-
-      if(member && instanceDataPtr)
+      // while
+      else if(strncmp(token.mStart, "while", 5u) == 0)
       {
-         if(pOutValue->mValueBufferType != ValueBufferType::Uninitialized)
-         {
-            pOutValue->reset();
-         }
-
-         pOutValue->initExternal(member->mTypeUsage);
-         pOutValue->set(instanceDataPtr + member->mOffset);
+         tokenIndex++;
+         statement = parseStatementWhile(pContext);
+      }
+      // do
+      else if(strncmp(token.mStart, "do", 2u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementDoWhile(pContext);
+      }
+      // for
+      else if(strncmp(token.mStart, "for", 3u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementFor(pContext);
+      }
+      // break
+      else if(strncmp(token.mStart, "break", 5u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementBreak(pContext);
+      }
+      // continue
+      else if(strncmp(token.mStart, "continue", 8u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementContinue(pContext);
+      }
+      // return
+      else if(strncmp(token.mStart, "return", 6u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementReturn(pContext);
+      }
+      // using
+      else if(strncmp(token.mStart, "using", 5u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementUsingDirective(pContext);
+      }
+      // struct
+      else if(strncmp(token.mStart, "struct", 6u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementStructDeclaration(pContext);
+      }
+      // namespace
+      else if(strncmp(token.mStart, "namespace", 9u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementNamespaceDeclaration(pContext);
+      }
+      // typedef
+      else if(strncmp(token.mStart, "typedef", 7u) == 0)
+      {
+         tokenIndex++;
+         statement = parseStatementTypeDefinition(pContext);
+      }
+      // (unexpected)
+      else
+      {
+         throwCompileErrorUnexpectedSymbol(pContext);
       }
    }
-   else if(pExpression->getType() == ExpressionType::ArrayElementAccess)
+   else
    {
-      ExpressionArrayElementAccess* arrayElementAccess =
-         static_cast<ExpressionArrayElementAccess*>(pExpression);
+      // static?
+      bool staticDeclaration = false;
 
-      Value arrayDataValue;
-      getInstanceDataValue(pContext, arrayElementAccess->mArray, &arrayDataValue);
+      if(strncmp(token.mStart, "static", 6u) == 0)
+      {
+         staticDeclaration = true;
+         tokenIndex++;
+      }
 
-      Value arrayIndexValue;
-      arrayIndexValue.mValueInitializationHint = ValueInitializationHint::Stack;
-      evaluateExpression(pContext, arrayElementAccess->mArrayElementIndex, &arrayIndexValue);
-      const size_t arrayIndex = (size_t)getValueAsInteger(arrayIndexValue);
+      // type
+      TypeUsage typeUsage = parseTypeUsage(pContext, 0u);
 
-      TypeUsage arrayElementTypeUsage;
-      arrayElementTypeUsage.mType = arrayDataValue.mTypeUsage.mType;
+      if(typeUsage.mType)
+      {
+         const Token& identifierToken = tokens[tokenIndex];
+         pContext.mStringBuffer.assign(identifierToken.mStart, identifierToken.mLength);
+         const Identifier identifier(pContext.mStringBuffer.c_str());
+         tokenIndex++;
 
-      pOutValue->initExternal(arrayElementTypeUsage);
-      pOutValue->mValueBuffer =
-         arrayDataValue.mValueBuffer + (arrayIndex * arrayElementTypeUsage.getSize());
-   }
-   else if(pExpression->getType() == ExpressionType::Indirection)
-   {
-      ExpressionIndirection* indirection = static_cast<ExpressionIndirection*>(pExpression);
+         if(tokens[tokenIndex].mType != TokenType::Operator &&
+            tokens[tokenIndex].mType != TokenType::Punctuation)
+         {
+            pContext.mStringBuffer.assign(token.mStart, token.mLength);
+            throwCompileError(pContext, CompileError::UnexpectedSymbol, pContext.mStringBuffer.c_str());
+            return nullptr;
+         }
 
-      Value value;
-      value.mValueInitializationHint = ValueInitializationHint::Stack;
-      evaluateExpression(pContext, indirection->mExpression, &value);
-      CflatAssert(value.mTypeUsage.isPointer());
+         bool isFunctionDeclaration = tokens[tokenIndex].mStart[0] == '(';
 
-      TypeUsage typeUsage = value.mTypeUsage;
-      typeUsage.mPointerLevel--;
+         if(isFunctionDeclaration)
+         {
+            const size_t nextSemicolonIndex = findClosureTokenIndex(pContext, 0, ';');
+            const size_t nextBracketIndex = findClosureTokenIndex(pContext, 0, '{');
+               
+            if(nextBracketIndex == 0u ||
+               (nextSemicolonIndex > 0u && nextSemicolonIndex < nextBracketIndex))
+            {
+               // object construction
+               isFunctionDeclaration = false;
+            }
+         }
 
-      const void* ptr = CflatValueAs(&value, void*);
-      pOutValue->initExternal(typeUsage);
-      pOutValue->set(ptr);
+         // function declaration
+         if(isFunctionDeclaration)
+         {
+            tokenIndex--;
+            statement = parseStatementFunctionDeclaration(pContext, typeUsage);
+         }
+         // variable / const declaration
+         else
+         {
+            if(typeUsage.mType != mTypeVoid || typeUsage.mPointerLevel > 0u)
+            {
+               statement =
+                  parseStatementVariableDeclaration(pContext, typeUsage, identifier, staticDeclaration);
+            }
+            else
+            {
+               throwCompileError(pContext, Environment::CompileError::InvalidType, "void");
+            }
+         }
+      }
+      // expression
+      else
+      {
+         const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+
+         if(closureTokenIndex == 0u)
+         {
+            throwCompileError(pContext, CompileError::Expected, ";");
+            return nullptr;
+         }
+
+         Expression* expression = parseExpression(pContext, closureTokenIndex - 1u);
+         tokenIndex = closureTokenIndex;
+
+         statement = (StatementExpression*)pContext.mArena->allocate(sizeof(StatementExpression));
+         CflatInvokeCtor(StatementExpression, statement)(expression);
+      }
    }
-   else
+
+   if(statement)
    {
-      Value expressionValue;
-      expressionValue.mValueInitializationHint = ValueInitializationHint::Stack;
-      evaluateExpression(pContext, pExpression, &expressionValue);
+      statement->mProgram = pContext.mProgram;
+      statement->mLine = statementLine;
 
-      assertValueInitialization(pContext, expressionValue.mTypeUsage, pOutValue);
-      *pOutValue = expressionValue;
+      if(mErrorMessage.empty())
+      {
+         statement = eliminateDeadBranches(pContext, statement);
+      }
    }
-}
-
-void Environment::getAddressOfValue(ExecutionContext& pContext, const Value& pInstanceDataValue,
-   Value* pOutValue)
-{
-   TypeUsage pointerTypeUsage = pInstanceDataValue.mTypeUsage;
-   pointerTypeUsage.mPointerLevel++;
 
-   assertValueInitialization(pContext, pointerTypeUsage, pOutValue);
-   pOutValue->set(&pInstanceDataValue.mValueBuffer);
+   return statement;
 }
 
-void Environment::getArgumentValues(ExecutionContext& pContext,
-   const CflatSTLVector(Expression*)& pExpressions, CflatArgsVector(Value)& pValues)
+StatementBlock* Environment::parseStatementBlock(ParsingContext& pContext,
+   bool pAlterScope, bool pAllowInGlobalScope)
 {
-   pValues.resize(pExpressions.size());
+   if(!pAllowInGlobalScope && pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
 
-   for(size_t i = 0u; i < pExpressions.size(); i++)
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
+
+   if(token.mStart[0] != '{')
    {
-      pValues[i].mValueInitializationHint = ValueInitializationHint::Stack;
-      evaluateExpression(pContext, pExpressions[i], &pValues[i]);
+      throwCompileError(pContext, CompileError::Expected, "{");
+      return nullptr;
    }
-}
 
-void Environment::prepareArgumentsForFunctionCall(ExecutionContext& pContext,
-   const CflatSTLVector(TypeUsage)& pParameters, const CflatArgsVector(Value)& pOriginalValues,
-   CflatArgsVector(Value)& pPreparedValues)
-{
-   CflatAssert(pParameters.size() == pOriginalValues.size());
-   pPreparedValues.resize(pParameters.size());
+   StatementBlock* block = (StatementBlock*)pContext.mArena->allocate(sizeof(StatementBlock));
+   CflatInvokeCtor(StatementBlock, block)(pAlterScope);
 
-   for(size_t i = 0u; i < pParameters.size(); i++)
+   const size_t closureTokenIndex = findClosureTokenIndex(pContext, '{', '}');
+
+   if(closureTokenIndex > 0u)
    {
-      // pass by reference
-      if(pParameters[i].isReference())
+      incrementBlockLevel(pContext);
+
+      if(pAlterScope)
       {
-         pPreparedValues[i] = pOriginalValues[i];
-         CflatSetFlag(pPreparedValues[i].mTypeUsage.mFlags, TypeUsageFlags::Reference);
+         incrementScopeLevel(pContext);
+         incrementScopeLevel(mExecutionContext);
       }
-      // pass by value
-      else
+
+      while(tokenIndex < closureTokenIndex)
       {
-         pPreparedValues[i].initOnStack(pParameters[i], &pContext.mStack);
-         assignValue(pContext, pOriginalValues[i], &pPreparedValues[i], false);
+         tokenIndex++;
+         Statement* statement = parseStatement(pContext);
+
+         if(!mErrorMessage.empty())
+         {
+            break;
+         }
+
+         if(statement)
+         {
+            block->mStatements.push_back(statement);
+         }
+      }
+
+      if(pAlterScope)
+      {
+         decrementScopeLevel(mExecutionContext);
+         decrementScopeLevel(pContext);
       }
+
+      decrementBlockLevel(pContext);
+   }
+   else
+   {
+      throwCompileError(pContext, CompileError::Expected, "}");
+   }
+
+   if(mErrorMessage.empty())
+   {
+      block->mProgram = pContext.mProgram;
+      block->mLine = token.mLine;
+   }
+   else
+   {
+      CflatInvokeDtor(StatementBlock, block);
+      block = nullptr;
    }
+
+   return block;
 }
 
-void Environment::applyUnaryOperator(ExecutionContext& pContext, const Value& pOperand,
-   const char* pOperator, Value* pOutValue)
+StatementUsingDirective* Environment::parseStatementUsingDirective(ParsingContext& pContext)
 {
-   Type* type = pOperand.mTypeUsage.mType;
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
 
-   // integer built-in / pointer
-   if(type->isInteger() || pOperand.mTypeUsage.isPointer())
+   StatementUsingDirective* statement = nullptr;
+   const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+
+   if(closureTokenIndex > 0u)
    {
-      if(pOperator[0] == '*')
+      if(strncmp(token.mStart, "namespace", 9u) == 0)
       {
-         CflatAssert(pOperand.mTypeUsage.isPointer());
-         CflatAssert(pOperand.mTypeUsage.mType == pOutValue->mTypeUsage.mType);
-         CflatAssert(pOperand.mTypeUsage.mPointerLevel == (pOutValue->mTypeUsage.mPointerLevel + 1u));
+         tokenIndex++;
+         Token& namespaceToken = const_cast<Token&>(pContext.mTokens[tokenIndex]);
+         pContext.mStringBuffer.clear();
 
-         const void* ptr = CflatValueAs(&pOperand, void*);
-         pOutValue->set(ptr);
-      }
-      else
-      {
-         const int64_t valueAsInteger = getValueAsInteger(pOperand);
+         do
+         {
+            pContext.mStringBuffer.append(namespaceToken.mStart, namespaceToken.mLength);
+            tokenIndex++;
+            namespaceToken = tokens[tokenIndex];
+         }
+         while(*namespaceToken.mStart != ';');
+
+         const Identifier identifier(pContext.mStringBuffer.c_str());
+         Namespace* ns = nullptr;
 
-         if(pOperator[0] == '!')
+         for(int i = (int)pContext.mNamespaceStack.size() - 1; i >= 0; i--)
          {
-            setValueAsInteger(!valueAsInteger, pOutValue);
+            ns = pContext.mNamespaceStack[i]->getNamespace(identifier);
+
+            if(ns)
+            {
+               break;
+            }
          }
-         else if(strcmp(pOperator, "++") == 0)
+
+         if(ns)
          {
-            const int64_t increment = pOutValue->mTypeUsage.isPointer()
-               ? (int64_t)pOutValue->mTypeUsage.mType->mSize
-               : 1;
-            setValueAsInteger(valueAsInteger + increment, pOutValue);
+            UsingDirective usingDirective(ns);
+            usingDirective.mBlockLevel = pContext.mBlockLevel;
+            pContext.mUsingDirectives.push_back(usingDirective);
+
+            statement = (StatementUsingDirective*)pContext.mArena->allocate(sizeof(StatementUsingDirective));
+            CflatInvokeCtor(StatementUsingDirective, statement)(ns);
          }
-         else if(strcmp(pOperator, "--") == 0)
+         else
          {
-            const int64_t decrement = pOutValue->mTypeUsage.isPointer()
-               ? (int64_t)pOutValue->mTypeUsage.mType->mSize
-               : 1;
-            setValueAsInteger(valueAsInteger - decrement, pOutValue);
+            throwCompileError(pContext, CompileError::UnknownNamespace, identifier.mName);
          }
-         else if(pOperator[0] == '-')
+      }
+      else if(tokenIndex < closureTokenIndex && tokens[tokenIndex].mType == TokenType::Identifier)
+      {
+         const size_t equalTokenIndex = findClosureTokenIndex(pContext, 0, '=', closureTokenIndex);
+
+         if(equalTokenIndex > 0u)
          {
-            setValueAsInteger(-valueAsInteger, pOutValue);
+            pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+            const Identifier alias(pContext.mStringBuffer.c_str());
+            tokenIndex++;
+
+            if(tokenIndex == equalTokenIndex)
+            {
+               tokenIndex++;
+
+               const TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+
+               if(typeUsage.mType && tokenIndex == closureTokenIndex)
+               {
+                  registerTypeAlias(pContext, alias, typeUsage);
+
+                  statement = (StatementUsingDirective*)pContext.mArena->allocate(sizeof(StatementUsingDirective));
+                  CflatInvokeCtor(StatementUsingDirective, statement)(alias, typeUsage);
+               }
+               else
+               {
+                  throwCompileErrorUnexpectedSymbol(pContext);
+               }
+            }
+            else
+            {
+               throwCompileErrorUnexpectedSymbol(pContext);
+            }
          }
-         else if(pOperator[0] == '~')
+         else
          {
-            setValueAsInteger(~valueAsInteger, pOutValue);
+            const TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+
+            if(typeUsage.mType && tokenIndex == closureTokenIndex && typeUsage.mFlags == 0u)
+            {
+               const Identifier& alias = typeUsage.mType->mIdentifier;
+               registerTypeAlias(pContext, alias, typeUsage);
+
+               statement = (StatementUsingDirective*)pContext.mArena->allocate(sizeof(StatementUsingDirective));
+               CflatInvokeCtor(StatementUsingDirective, statement)(alias, typeUsage);
+            }
+            else
+            {
+               throwCompileErrorUnexpectedSymbol(pContext);
+            }
+         }
+      }
+      else
+      {
+         throwCompileError(pContext, CompileError::UnexpectedSymbol, "using");
+      }
+
+      tokenIndex = closureTokenIndex;
+   }
+   else
+   {
+      throwCompileError(pContext, CompileError::Expected, ";");
+   }
+
+   return statement;
+}
+
+StatementTypeDefinition* Environment::parseStatementTypeDefinition(ParsingContext& pContext)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   StatementTypeDefinition* statement = nullptr;
+   const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+
+   if(closureTokenIndex > 0u)
+   {
+      const TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+
+      if(typeUsage.mType)
+      {
+         if(tokenIndex == (closureTokenIndex - 1u) && tokens[tokenIndex].mType == TokenType::Identifier)
+         {
+            pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+            const Identifier alias(pContext.mStringBuffer.c_str());
+            registerTypeAlias(pContext, alias, typeUsage);
+
+            statement = (StatementTypeDefinition*)pContext.mArena->allocate(sizeof(StatementTypeDefinition));
+            CflatInvokeCtor(StatementTypeDefinition, statement)(alias, typeUsage);
+         }
+         else
+         {
+            throwCompileErrorUnexpectedSymbol(pContext);
+         }
+      }
+      else
+      {
+         pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+         throwCompileError(pContext, CompileError::UndefinedType, pContext.mStringBuffer.c_str());
+      }
+
+      tokenIndex = closureTokenIndex;
+   }
+   else
+   {
+      throwCompileError(pContext, CompileError::Expected, ";");
+   }
+
+   return statement;
+}
+
+StatementNamespaceDeclaration* Environment::parseStatementNamespaceDeclaration(ParsingContext& pContext)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
+
+   StatementNamespaceDeclaration* statement = nullptr;
+
+   if(token.mType == TokenType::Identifier)
+   {
+      pContext.mStringBuffer.assign(token.mStart, token.mLength);
+      const Identifier nsIdentifier(pContext.mStringBuffer.c_str());
+
+      Namespace* ns = pContext.mNamespaceStack.back()->requestNamespace(nsIdentifier);
+      pContext.mNamespaceStack.push_back(ns);
+      mExecutionContext.mNamespaceStack.push_back(ns);
+
+      statement = (StatementNamespaceDeclaration*)pContext.mArena->allocate(sizeof(StatementNamespaceDeclaration));
+      CflatInvokeCtor(StatementNamespaceDeclaration, statement)(nsIdentifier);
+
+      tokenIndex++;
+      statement->mBody = parseStatementBlock(pContext, false, true);
+
+      mExecutionContext.mNamespaceStack.pop_back();
+      pContext.mNamespaceStack.pop_back();
+   }
+   else
+   {
+      throwCompileError(pContext, CompileError::UnexpectedSymbol, "namespace");
+   }
+
+   return statement;
+}
+
+StatementVariableDeclaration* Environment::parseStatementVariableDeclaration(ParsingContext& pContext,
+   TypeUsage& pTypeUsage, const Identifier& pIdentifier, bool pStatic)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
+
+   StatementVariableDeclaration* statement = nullptr;
+
+   bool instanceAlreadyRegistered = false;
+
+   for(size_t i = 0u; i < pContext.mRegisteredInstances.size(); i++)
+   {
+      if(pContext.mRegisteredInstances[i].mIdentifier == pIdentifier &&
+         pContext.mRegisteredInstances[i].mNamespace == pContext.mNamespaceStack.back() &&
+         pContext.mRegisteredInstances[i].mScopeLevel == pContext.mScopeLevel)
+      {
+         instanceAlreadyRegistered = true;
+         break;
+      }
+   }
+
+   if(!instanceAlreadyRegistered)
+   {
+      Expression* initialValueExpression = nullptr;
+
+      // array
+      if(token.mStart[0] == '[')
+      {
+         uint16_t arraySize = 0u;
+
+         const size_t arrayClosure = findClosureTokenIndex(pContext, '[', ']');
+         const bool arraySizeSpecified = arrayClosure > (tokenIndex + 1u);
+
+         if(arraySizeSpecified)
+         {
+            tokenIndex++;
+            Expression* arraySizeExpression = parseExpression(pContext, arrayClosure - 1u);
+            CflatAssert(arraySizeExpression);
+
+            Value arraySizeValue;
+            arraySizeValue.initOnStack(mTypeUsageSizeT, &mExecutionContext.mStack);
+            evaluateExpression(mExecutionContext, arraySizeExpression, &arraySizeValue);
+
+            arraySize = (uint16_t)CflatValueAs(&arraySizeValue, size_t);
+
+            CflatInvokeDtor(Expression, arraySizeExpression);
+         }
+
+         tokenIndex = arrayClosure + 1u;
+
+         if(tokens[tokenIndex].mStart[0] == '=')
+         {
+            tokenIndex++;
+
+            const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+
+            if(closureTokenIndex > 0u)
+            {
+               initialValueExpression = parseExpression(pContext, closureTokenIndex - 1u);
+
+               if(!initialValueExpression ||
+                  initialValueExpression->getType() != ExpressionType::ArrayInitialization)
+               {
+                  throwCompileError(pContext, CompileError::ArrayInitializationExpected);
+                  return nullptr;
+               }
+
+               ExpressionArrayInitialization* arrayInitialization =
+                  static_cast<ExpressionArrayInitialization*>(initialValueExpression);
+               arrayInitialization->mElementType = pTypeUsage.mType;
+
+               if(!arraySizeSpecified)
+               {
+                  arraySize = (uint16_t)arrayInitialization->mValues.size();
+               }
+
+               tokenIndex = closureTokenIndex;
+            }
+            else
+            {
+               throwCompileError(pContext, CompileError::Expected, ";");
+               return nullptr;
+            }
+         }
+         else if(!arraySizeSpecified)
+         {
+            throwCompileError(pContext, CompileError::ArrayInitializationExpected);
+            return nullptr;
+         }
+
+         CflatAssert(arraySize > 0u);
+         CflatSetFlag(pTypeUsage.mFlags, TypeUsageFlags::Array);
+         pTypeUsage.mArraySize = arraySize;
+      }
+      // variable/object
+      else if(token.mStart[0] == '=')
+      {
+         tokenIndex++;
+
+         const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+
+         if(closureTokenIndex > 0u)
+         {
+            initialValueExpression = parseExpression(pContext, closureTokenIndex - 1u);
+
+            if(pTypeUsage.mType == mTypeAuto)
+            {
+               const TypeUsage resolvedTypeUsage = getTypeUsage(pContext, initialValueExpression);
+               pTypeUsage.mType = resolvedTypeUsage.mType;
+            }
+
+            tokenIndex = closureTokenIndex;
+         }
+         else
+         {
+            throwCompileError(pContext, CompileError::Expected, ";");
+            return nullptr;
+         }
+      }
+      // object with construction
+      else if(pTypeUsage.mType &&
+         pTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
+         !pTypeUsage.isPointer())
+      {
+         Type* type = pTypeUsage.mType;
+
+         if(token.mStart[0] == '(')
+         {
+            initialValueExpression = parseExpressionObjectConstruction(pContext, type);
+         }
+         else
+         {
+            const Identifier emptyId;
+            Method* anyCtor = findMethod(type, emptyId);
+
+            if(anyCtor)
+            {
+               Method* defaultCtor = getDefaultConstructor(type);
+
+               if(!defaultCtor)
+               {
+                  CflatSTLString typeFullName;
+                  getTypeFullName(type, &typeFullName);
+
+                  throwCompileError(pContext, CompileError::NoDefaultConstructor,
+                     typeFullName.c_str());
+                  return nullptr;
+               }
+            }
+         }
+      }
+
+      if(pTypeUsage.isReference() && !initialValueExpression)
+      {
+         throwCompileError(pContext, CompileError::UninitializedReference, pIdentifier.mName);
+         return nullptr;
+      }
+
+      Instance* instance = nullptr;
+      Instance* staticInstance = nullptr;
+
+      // static variables do not live in the frame of the function during execution, so they do
+      // not take a local instance slot while parsing either
+      if(pStatic && pContext.mScopeLevel > 0u && !pTypeUsage.isConst())
+      {
+         staticInstance = (Instance*)CflatAllocate(sizeof(Instance), Values);
+         CflatInvokeCtor(Instance, staticInstance)(pTypeUsage, pIdentifier);
+
+         if(pTypeUsage.isReference())
+         {
+            staticInstance->mValue.initExternal(pTypeUsage);
+         }
+         else
+         {
+            staticInstance->mValue.initOnHeap(pTypeUsage);
+            memset(staticInstance->mValue.mValueBuffer, 0, pTypeUsage.getSize());
+         }
+
+         ParsingContext::StaticInstance staticInstanceEntry;
+         staticInstanceEntry.mInstance = staticInstance;
+         staticInstanceEntry.mScopeLevel = pContext.mScopeLevel;
+         pContext.mStaticInstances.push_back(staticInstanceEntry);
+      }
+      else
+      {
+         instance = registerInstance(pContext, pTypeUsage, pIdentifier);
+      }
+
+      ParsingContext::RegisteredInstance registeredInstance;
+      registeredInstance.mIdentifier = pIdentifier;
+      registeredInstance.mNamespace = pContext.mNamespaceStack.back();
+      registeredInstance.mScopeLevel = pContext.mScopeLevel;
+      pContext.mRegisteredInstances.push_back(registeredInstance);
+
+      statement = (StatementVariableDeclaration*)pContext.mArena->allocate(sizeof(StatementVariableDeclaration));
+      CflatInvokeCtor(StatementVariableDeclaration, statement)
+         (pTypeUsage, pIdentifier, initialValueExpression, pStatic, staticInstance);
+
+      if(initialValueExpression)
+      {
+         bool validAssignment = false;
+
+         if(pTypeUsage.isPointer() && initialValueExpression->getType() == ExpressionType::NullPointer)
+         {
+            validAssignment = true;
+         }
+         else
+         {
+            const TypeUsage initialValueTypeUsage = getTypeUsage(pContext, initialValueExpression);
+
+            if(initialValueTypeUsage.mType)
+            {
+               if(initialValueTypeUsage.mType != mTypeVoid || initialValueTypeUsage.isPointer())
+               {
+                  if(pTypeUsage.isPointer() && !pTypeUsage.isArray() &&
+                     !initialValueTypeUsage.isPointer() && initialValueTypeUsage.isArray() &&
+                     pTypeUsage.mType == initialValueTypeUsage.mType)
+                  {
+                     validAssignment = true;
+                  }
+                  else
+                  {
+                     const TypeHelper::Compatibility compatibility =
+                        TypeHelper::getCompatibility(pTypeUsage, initialValueTypeUsage);
+                     validAssignment = compatibility != TypeHelper::Compatibility::Incompatible;
+                  }
+               }
+            }
+         }
+
+         if(validAssignment)
+         {
+            // the value of the constant gets stored in the instance while parsing, so the
+            // expressions which read the constant can use it instead
+            if(instance && pTypeUsage.isConst() && isFoldable(pTypeUsage))
+            {
+               inlineConstant(pContext, &statement->mInitialValue);
+               const Value* constantValue = getConstantValue(pContext, statement->mInitialValue);
+
+               if(constantValue && mExecutionContext.mErrorMessage.empty())
+               {
+                  assignValue(mExecutionContext, *constantValue, &instance->mValue, true);
+
+                  ParsingContext::ConstantInstance constantInstance;
+                  constantInstance.mInstance = instance;
+                  constantInstance.mScopeLevel = pContext.mScopeLevel;
+                  pContext.mConstantInstances.push_back(constantInstance);
+               }
+            }
+
+            if(pStatic && pTypeUsage.isConst())
+            {
+               Instance* execInstance = registerInstance(mExecutionContext, pTypeUsage, pIdentifier);
+
+               Value initialValue;
+               initialValue.mValueInitializationHint = ValueInitializationHint::Stack;
+               evaluateExpression(mExecutionContext, initialValueExpression, &initialValue);
+
+               assignValue(mExecutionContext, initialValue, &execInstance->mValue, true);
+            }
+         }
+         else
+         {
+            throwCompileError(pContext, CompileError::InvalidAssignment);
+         }
+      }
+   }
+   else
+   {
+      throwCompileError(pContext, CompileError::VariableRedefinition, pIdentifier.mName);
+   }
+
+   return statement;
+}
+
+StatementFunctionDeclaration* Environment::parseStatementFunctionDeclaration(ParsingContext& pContext,
+   const TypeUsage& pReturnType)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
+
+   pContext.mStringBuffer.assign(token.mStart, token.mLength);
+   const Identifier functionIdentifier(pContext.mStringBuffer.c_str());
+
+   pContext.mLocalFrameBase = pContext.mLocalInstancesHolder.getInstancesCount();
+
+   if(pReturnType.mType &&
+      pReturnType.mType->mCategory == TypeCategory::StructOrClass &&
+      !pReturnType.isPointer() &&
+      !pReturnType.isReference())
+   {
+      TypeUsage returnTypeReference;
+      returnTypeReference.mType = pReturnType.mType;
+      returnTypeReference.mFlags |= (uint8_t)TypeUsageFlags::Reference;
+
+      CflatArgsVector(TypeUsage) argumentTypes;
+      argumentTypes.push_back(returnTypeReference);
+
+      Method* copyConstructor = findConstructor(pReturnType.mType, argumentTypes);
+
+      if(!copyConstructor)
+      {
+         CflatSTLString typeFullName;
+         getTypeFullName(pReturnType.mType, &typeFullName);
+
+         throwCompileError(pContext, CompileError::NoCopyConstructor, typeFullName.c_str());
+         return nullptr;
+      }
+   }
+
+   StatementFunctionDeclaration* statement =
+      (StatementFunctionDeclaration*)pContext.mArena->allocate(sizeof(StatementFunctionDeclaration));
+   CflatInvokeCtor(StatementFunctionDeclaration, statement)(pReturnType, functionIdentifier);
+
+   tokenIndex++;
+
+   while(tokens[tokenIndex++].mStart[0] != ')')
+   {
+      // no arguments
+      if(tokens[tokenIndex].mStart[0] == ')')
+      {
+         tokenIndex++;
+         break;
+      }
+
+      TypeUsage parameterType = parseTypeUsage(pContext, 0u);
+
+      if(!parameterType.mType)
+      {
+         pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+         throwCompileError(pContext, Environment::CompileError::UndefinedType,
+            pContext.mStringBuffer.c_str());
+         return statement;
+      }
+
+      statement->mParameterTypes.push_back(parameterType);
+
+      pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+      Identifier parameterIdentifier(pContext.mStringBuffer.c_str());
+      statement->mParameterIdentifiers.push_back(parameterIdentifier);
+      tokenIndex++;
+
+      pContext.mScopeLevel++;
+      registerInstance(pContext, parameterType, parameterIdentifier);
+      pContext.mScopeLevel--;
+   }
+
+   CflatArgsVector(TypeUsage) parameterTypes;
+   toArgsVector(statement->mParameterTypes, parameterTypes);
+
+   Function* function =
+      pContext.mNamespaceStack.back()->getFunction(statement->mFunctionIdentifier, parameterTypes);
+
+   // functions shared with the base environment cannot be altered, so another one replaces them
+   Function* sharedFunction = nullptr;
+
+   if(function && function->mNamespace->getEnvironment() != this)
+   {
+      sharedFunction = function;
+      function = nullptr;
+   }
+
+   if(!function)
+   {
+      function = pContext.mNamespaceStack.back()->registerFunction(statement->mFunctionIdentifier);
+      function->mReturnTypeUsage = statement->mReturnType;
+      function->mProgram = pContext.mProgram;
+      function->mLine = token.mLine;
+
+      for(size_t i = 0u; i < statement->mParameterTypes.size(); i++)
+      {
+         function->mParameters.push_back(statement->mParameterTypes[i]);
+         function->mParameterIdentifiers.push_back(statement->mParameterIdentifiers[i]);
+      }
+
+      if(sharedFunction)
+      {
+         CflatSTLVector(Function*)& functions =
+            *function->mNamespace->getFunctions(function->mIdentifier);
+         functions.pop_back();
+
+         for(size_t i = 0u; i < functions.size(); i++)
+         {
+            if(functions[i] == sharedFunction)
+            {
+               functions[i] = function;
+               break;
+            }
+         }
+      }
+   }
+
+   pContext.mCurrentFunctionIdentifier = functionIdentifier;
+
+   statement->mBody = parseStatementBlock(pContext, true, true);
+
+   pContext.mCurrentFunctionIdentifier = Identifier();
+
+   if(statement->mBody && mExecutionMode == ExecutionMode::Bytecode && mErrorMessage.empty())
+   {
+      statement->mBytecode = (Bytecode*)CflatAllocate(sizeof(Bytecode), SyntaxTree);
+      CflatInvokeCtor(Bytecode, statement->mBytecode);
+
+      BytecodeCompiler bytecodeCompiler(statement->mBytecode);
+      bytecodeCompiler.compile(statement->mBody);
+   }
+
+   return statement;
+}
+
+StatementStructDeclaration* Environment::parseStatementStructDeclaration(ParsingContext& pContext)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+   const Token& token = tokens[tokenIndex];
+
+   pContext.mStringBuffer.assign(token.mStart, token.mLength);
+   const Identifier structIdentifier(pContext.mStringBuffer.c_str());
+   tokenIndex++;
+
+   if(tokens[tokenIndex].mStart[0] != '{')
+   {
+      throwCompileError(pContext, CompileError::Expected, "{");
+      return nullptr;
+   }
+
+   const size_t closureTokenIndex = findClosureTokenIndex(pContext, '{', '}');
+
+   if(closureTokenIndex == 0u)
+   {
+      tokenIndex = tokens.size() - 1u;
+      throwCompileError(pContext, CompileError::Expected, "}");
+      return nullptr;
+   }
+
+   tokenIndex++;
+
+   StatementStructDeclaration* statement =
+      (StatementStructDeclaration*)pContext.mArena->allocate(sizeof(StatementStructDeclaration));
+   CflatInvokeCtor(StatementStructDeclaration, statement)();
+
+   Namespace* ns = pContext.mNamespaceStack.back();
+
+   if(pContext.mScopeLevel > 0u)
+   {
+      ns = ns->requestNamespace(pContext.mCurrentFunctionIdentifier);
+
+      char buffer[kDefaultLocalStringBufferSize];
+      sprintf(buffer, "__local%u", pContext.mLocalNamespaceGlobalIndex);
+      const Identifier internalNamespaceIdentifier(buffer);
+      ns = ns->requestNamespace(internalNamespaceIdentifier);
+
+      pContext.mLocalNamespaceStack.emplace_back();
+      ParsingContext::LocalNamespace& localNamespace = pContext.mLocalNamespaceStack.back();
+      localNamespace.mNamespace = ns;
+      localNamespace.mScopeLevel = pContext.mScopeLevel;
+
+      pContext.mLocalNamespaceGlobalIndex++;
+   }
+
+   statement->mStruct = ns->registerType<Struct>(structIdentifier);
+
+   size_t structSize = 0u;
+
+   do
+   {
+      TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+
+      if(!typeUsage.mType)
+      {
+         pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+         throwCompileError(pContext, CompileError::UndefinedType, pContext.mStringBuffer.c_str());
+         break;
+      }
+
+      pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+      tokenIndex++;
+
+      if(tokens[tokenIndex].mStart[0] != ';')
+      {
+         throwCompileError(pContext, CompileError::Expected, ";");
+         break;
+      }
+
+      const Identifier memberIdentifier(pContext.mStringBuffer.c_str());
+      Member member(memberIdentifier);
+      member.mTypeUsage = typeUsage;
+      member.mOffset = (uint16_t)structSize;
+
+      statement->mStruct->mMembers.push_back(member);
+      structSize += typeUsage.getSize();
+   }
+   while(++tokenIndex < closureTokenIndex);
+
+   statement->mStruct->mSize = structSize;
+
+   if(tokens[++tokenIndex].mStart[0] != ';')
+   {
+      throwCompileError(pContext, CompileError::Expected, ";");
+   }
+
+   return statement;
+}
+
+StatementIf* Environment::parseStatementIf(ParsingContext& pContext)
+{
+   if(pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   if(tokens[tokenIndex].mStart[0] != '(')
+   {
+      throwCompileError(pContext, CompileError::UnexpectedSymbol, "if");
+      return nullptr;
+   }
+
+   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+
+   if(conditionClosureTokenIndex == 0u)
+   {
+      throwCompileError(pContext, CompileError::Expected, ")");
+      return nullptr;
+   }
+
+   tokenIndex++;
+   Expression* condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
+   tokenIndex = conditionClosureTokenIndex + 1u;
+
+   Statement* ifStatement = parseStatement(pContext);
+
+   if(!ifStatement)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   const size_t tokenIndexForElseCheck = tokenIndex + 1u;
+   Statement* elseStatement = nullptr;
+
+   if(tokens[tokenIndexForElseCheck].mType == TokenType::Keyword &&
+      strncmp(tokens[tokenIndexForElseCheck].mStart, "else", 4u) == 0)
+   {
+      tokenIndex = tokenIndexForElseCheck + 1u;
+      elseStatement = parseStatement(pContext);
+   }
+
+   StatementIf* statement = (StatementIf*)pContext.mArena->allocate(sizeof(StatementIf));
+   CflatInvokeCtor(StatementIf, statement)(condition, ifStatement, elseStatement);
+
+   return statement;
+}
+
+StatementSwitch* Environment::parseStatementSwitch(ParsingContext& pContext)
+{
+   if(pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   if(tokens[tokenIndex].mStart[0] != '(')
+   {
+      throwCompileError(pContext, CompileError::UnexpectedSymbol, "switch");
+      return nullptr;
+   }
+
+   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+
+   if(conditionClosureTokenIndex == 0u)
+   {
+      throwCompileError(pContext, CompileError::Expected, ")");
+      return nullptr;
+   }
+
+   if(tokens[conditionClosureTokenIndex + 1u].mStart[0] != '{')
+   {
+      pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+      throwCompileError(pContext, CompileError::UnexpectedSymbol, pContext.mStringBuffer.c_str());
+      return nullptr;
+   }
+
+   tokenIndex++;
+   Expression* condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
+   tokenIndex = conditionClosureTokenIndex + 1u;
+
+   tokenIndex++;
+   const size_t lastSwitchTokenIndex = findClosureTokenIndex(pContext, '{', '}');
+
+   if(lastSwitchTokenIndex == 0u)
+   {
+      if(condition)
+      {
+         CflatInvokeDtor(Expression, condition);
+      }
+
+      throwCompileError(pContext, CompileError::Expected, "}");
+      return nullptr;
+   }
+
+   StatementSwitch* statement = (StatementSwitch*)pContext.mArena->allocate(sizeof(StatementSwitch));
+   CflatInvokeCtor(StatementSwitch, statement)(condition);
+
+   StatementSwitch::CaseSection* currentCaseSection = nullptr;
+
+   const size_t previousSwitchLocalsBase = pContext.mSwitchLocalsBase;
+   pContext.mSwitchLocalsBase =
+      min(pContext.mSwitchLocalsBase, pContext.mLocalInstancesHolder.getInstancesCount());
+
+   for(; tokenIndex < lastSwitchTokenIndex; tokenIndex++)
+   {
+      if(tokens[tokenIndex].mType == TokenType::Keyword)
+      {
+         if(strncmp(tokens[tokenIndex].mStart, "case", 4u) == 0)
+         {
+            tokenIndex++;
+            const size_t lastCaseTokenIndex =
+               findClosureTokenIndex(pContext, 0, ':', lastSwitchTokenIndex);
+
+            StatementSwitch::CaseSection caseSection;
+            caseSection.mExpression = parseExpression(pContext, lastCaseTokenIndex - 1u);
+            tokenIndex = lastCaseTokenIndex + 1u;
+
+            statement->mCaseSections.push_back(caseSection);
+            currentCaseSection = &statement->mCaseSections.back();
+         }
+         else if(strncmp(tokens[tokenIndex].mStart, "default", 7u) == 0)
+         {
+            tokenIndex += 2u;
+
+            StatementSwitch::CaseSection caseSection;
+            caseSection.mExpression = nullptr;
+
+            statement->mCaseSections.push_back(caseSection);
+            currentCaseSection = &statement->mCaseSections.back();
+         }
+      }
+
+      if(!currentCaseSection)
+      {
+         if(condition)
+         {
+            CflatInvokeDtor(Expression, condition);
+         }
+
+         pContext.mSwitchLocalsBase = previousSwitchLocalsBase;
+
+         pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+         throwCompileError(pContext, CompileError::UnexpectedSymbol, pContext.mStringBuffer.c_str());
+         return nullptr;
+      }
+
+      Statement* caseSectionStatement = parseStatement(pContext);
+
+      if(caseSectionStatement)
+      {
+         currentCaseSection->mStatements.push_back(caseSectionStatement);
+      }
+   }
+
+   pContext.mSwitchLocalsBase = previousSwitchLocalsBase;
+
+   buildSwitchCaseLookup(pContext, statement);
+
+   return statement;
+}
+
+StatementWhile* Environment::parseStatementWhile(ParsingContext& pContext)
+{
+   if(pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   if(tokens[tokenIndex].mStart[0] != '(')
+   {
+      throwCompileError(pContext, CompileError::UnexpectedSymbol, "while");
+      return nullptr;
+   }
+
+   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+
+   if(conditionClosureTokenIndex == 0u)
+   {
+      throwCompileError(pContext, CompileError::Expected, ")");
+      return nullptr;
+   }
+
+   tokenIndex++;
+   Expression* condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
+   tokenIndex = conditionClosureTokenIndex + 1u;
+
+   Statement* loopStatement = parseStatement(pContext);
+
+   StatementWhile* statement = (StatementWhile*)pContext.mArena->allocate(sizeof(StatementWhile));
+   CflatInvokeCtor(StatementWhile, statement)(condition, loopStatement);
+
+   return statement;
+}
+
+StatementDoWhile* Environment::parseStatementDoWhile(ParsingContext& pContext)
+{
+   if(pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   Statement* loopStatement = parseStatement(pContext);
+   tokenIndex++;
+
+   if(strncmp(tokens[tokenIndex].mStart, "while", 5u) != 0)
+   {
+      if(loopStatement)
+      {
+         CflatInvokeDtor(Statement, loopStatement);
+      }
+
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   tokenIndex++;
+
+   if(tokens[tokenIndex].mStart[0] != '(')
+   {
+      if(loopStatement)
+      {
+         CflatInvokeDtor(Statement, loopStatement);
+      }
+
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+
+   if(conditionClosureTokenIndex == 0u)
+   {
+      if(loopStatement)
+      {
+         CflatInvokeDtor(Statement, loopStatement);
+      }
+
+      throwCompileError(pContext, CompileError::Expected, ")");
+      return nullptr;
+   }
+
+   tokenIndex++;
+   Expression* condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
+   tokenIndex = conditionClosureTokenIndex + 1u;
+
+   StatementDoWhile* statement = (StatementDoWhile*)pContext.mArena->allocate(sizeof(StatementDoWhile));
+   CflatInvokeCtor(StatementDoWhile, statement)(condition, loopStatement);
+
+   return statement;
+}
+
+Statement* Environment::parseStatementFor(ParsingContext& pContext)
+{
+   if(pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   if(tokens[tokenIndex].mStart[0] != '(')
+   {
+      throwCompileError(pContext, CompileError::UnexpectedSymbol, "for");
+      return nullptr;
+   }
+
+   incrementScopeLevel(pContext);
+   incrementScopeLevel(mExecutionContext);
+
+   tokenIndex++;
+
+   const size_t initializationClosureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+   const size_t variableClosureTokenIndex = findClosureTokenIndex(pContext, 0, ':');
+
+   if(initializationClosureTokenIndex == 0u && variableClosureTokenIndex == 0u)
+   {
+      throwCompileError(pContext, CompileError::Expected, "';' or variable declaration");
+      return nullptr;
+   }
+
+   Statement* statement = nullptr;
+
+   if((initializationClosureTokenIndex > 0u && variableClosureTokenIndex == 0u) ||
+      (initializationClosureTokenIndex < variableClosureTokenIndex))
+   {
+      statement = parseStatementForRegular(pContext, initializationClosureTokenIndex);
+   }
+   else
+   {
+      statement = parseStatementForRangeBased(pContext, variableClosureTokenIndex);
+   }
+
+   decrementScopeLevel(mExecutionContext);
+   decrementScopeLevel(pContext);
+
+   return statement;
+}
+
+StatementFor* Environment::parseStatementForRegular(ParsingContext& pContext,
+   size_t pInitializationClosureTokenIndex)
+{
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   Statement* initialization = nullptr;
+   
+   if(pInitializationClosureTokenIndex > tokenIndex)
+   {
+      initialization = parseStatement(pContext);
+   }
+
+   tokenIndex = pInitializationClosureTokenIndex + 1u;
+
+   const size_t conditionClosureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+
+   if(conditionClosureTokenIndex == 0u)
+   {
+      throwCompileError(pContext, CompileError::Expected, ";");
+      return nullptr;
+   }
+
+   Expression* condition = nullptr;
+   
+   if(conditionClosureTokenIndex > tokenIndex)
+   {
+      condition = parseExpression(pContext, conditionClosureTokenIndex - 1u);
+   }
+
+   tokenIndex = conditionClosureTokenIndex + 1u;
+
+   const size_t incrementClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+
+   if(incrementClosureTokenIndex == 0u)
+   {
+      throwCompileError(pContext, CompileError::Expected, ")");
+      return nullptr;
+   }
+
+   Expression* increment = nullptr;
+   
+   if(incrementClosureTokenIndex > tokenIndex)
+   {
+      increment = parseExpression(pContext, incrementClosureTokenIndex - 1u);
+   }
+
+   tokenIndex = incrementClosureTokenIndex + 1u;
+
+   Statement* loopStatement = parseStatement(pContext);
+
+   StatementFor* statement = (StatementFor*)pContext.mArena->allocate(sizeof(StatementFor));
+   CflatInvokeCtor(StatementFor, statement)(initialization, condition, increment, loopStatement);
+
+   return statement;
+}
+
+StatementForRangeBased* Environment::parseStatementForRangeBased(ParsingContext& pContext,
+   size_t pVariableClosureTokenIndex)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   TypeUsage variableTypeUsage = parseTypeUsage(pContext, pVariableClosureTokenIndex - 1u);
+
+   if(!variableTypeUsage.mType)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   Identifier variableIdentifier;
+
+   if(tokens[tokenIndex].mType == TokenType::Identifier)
+   {
+      pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+      variableIdentifier = Identifier(pContext.mStringBuffer.c_str());
+   }
+   else
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   registerInstance(pContext, variableTypeUsage, variableIdentifier);
+
+   tokenIndex = pVariableClosureTokenIndex + 1u;
+   const size_t collectionClosureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+
+   if(collectionClosureTokenIndex <= tokenIndex)
+   {
+      throwCompileError(pContext, CompileError::Expected, ")");
+      return nullptr;
+   }
+
+   Expression* collection = parseExpression(pContext, collectionClosureTokenIndex - 1u);
+
+   if(!collection)
+   {
+      return nullptr;
+   }
+
+   bool validStatement = false;
+   const TypeUsage collectionTypeUsage = getTypeUsage(pContext, collection);
+
+   if(collectionTypeUsage.isArray() && !variableTypeUsage.isArray() &&
+      collectionTypeUsage.mPointerLevel == variableTypeUsage.mPointerLevel)
+   {
+      if(variableTypeUsage.mType == mTypeAuto)
+      {
+         variableTypeUsage.mType = collectionTypeUsage.mType;
+      }
+
+      validStatement = collectionTypeUsage.mType == variableTypeUsage.mType;
+   }
+   else if(collectionTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
+      static_cast<Struct*>(collectionTypeUsage.mType)->mContiguousData)
+   {
+      const TypeUsage& elementTypeUsage =
+         static_cast<Struct*>(collectionTypeUsage.mType)->mContiguousElementTypeUsage;
+
+      if(variableTypeUsage.mType == mTypeAuto)
+      {
+         variableTypeUsage.mType = elementTypeUsage.mType;
+      }
+
+      validStatement = elementTypeUsage.mType == variableTypeUsage.mType &&
+         elementTypeUsage.mPointerLevel == variableTypeUsage.mPointerLevel;
+   }
+   else if(collectionTypeUsage.mType->mCategory == TypeCategory::StructOrClass)
+   {
+      Struct* collectionType = static_cast<Struct*>(collectionTypeUsage.mType);
+      Method* beginMethod = findMethod(collectionType, "begin", TypeUsage::kEmptyList);
+
+      if(beginMethod)
+      {
+         Method* endMethod = findMethod(collectionType, "end", TypeUsage::kEmptyList);
+
+         if(endMethod && beginMethod->mReturnTypeUsage == endMethod->mReturnTypeUsage)
+         {
+            const TypeUsage iteratorTypeUsage = beginMethod->mReturnTypeUsage;
+            Type* iteratorType = iteratorTypeUsage.mType;
+
+            if(iteratorType->mCategory == TypeCategory::StructOrClass)
+            {
+               Method* indirectionOperatorMethod =
+                  findMethod(iteratorType, "operator*", TypeUsage::kEmptyList);
+
+               if(indirectionOperatorMethod)
+               {
+                  CflatArgsVector(TypeUsage) nonEqualOperatorParameterTypes;
+                  nonEqualOperatorParameterTypes.push_back(iteratorTypeUsage);
+
+                  validStatement = 
+                     findMethod(iteratorType, "operator!=", nonEqualOperatorParameterTypes) &&
+                     findMethod(iteratorType, "operator++", TypeUsage::kEmptyList);
+
+                  if(validStatement && variableTypeUsage.mType == mTypeAuto)
+                  {
+                     variableTypeUsage.mType = indirectionOperatorMethod->mReturnTypeUsage.mType;
+                  }
+               }
+            }
+            else
+            {
+               if(variableTypeUsage.mType == mTypeAuto)
+               {
+                  variableTypeUsage.mType = iteratorTypeUsage.mType;
+               }
+
+               validStatement = iteratorTypeUsage.isPointer();
+            }
+         }
+      }
+   }
+
+   if(!validStatement)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   tokenIndex = collectionClosureTokenIndex + 1u;
+   Statement* loopStatement = parseStatement(pContext);
+
+   StatementForRangeBased* statement =
+      (StatementForRangeBased*)pContext.mArena->allocate(sizeof(StatementForRangeBased));
+   CflatInvokeCtor(StatementForRangeBased, statement)
+      (variableTypeUsage, variableIdentifier, collection, loopStatement);
+
+   return statement;
+}
+
+StatementBreak* Environment::parseStatementBreak(ParsingContext& pContext)
+{
+   if(pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   if(tokens[tokenIndex].mStart[0] != ';')
+   {
+      throwCompileError(pContext, CompileError::UnexpectedSymbol, "break");
+      return nullptr;
+   }
+
+   StatementBreak* statement = (StatementBreak*)pContext.mArena->allocate(sizeof(StatementBreak));
+   CflatInvokeCtor(StatementBreak, statement)();
+
+   return statement;
+}
+
+StatementContinue* Environment::parseStatementContinue(ParsingContext& pContext)
+{
+   if(pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   if(tokens[tokenIndex].mStart[0] != ';')
+   {
+      throwCompileError(pContext, CompileError::UnexpectedSymbol, "continue");
+      return nullptr;
+   }
+
+   StatementContinue* statement = (StatementContinue*)pContext.mArena->allocate(sizeof(StatementContinue));
+   CflatInvokeCtor(StatementContinue, statement)();
+
+   return statement;
+}
+
+StatementReturn* Environment::parseStatementReturn(ParsingContext& pContext)
+{
+   if(pContext.mScopeLevel == 0u)
+   {
+      throwCompileErrorUnexpectedSymbol(pContext);
+      return nullptr;
+   }
+
+   const size_t closureTokenIndex = findClosureTokenIndex(pContext, 0, ';');
+
+   if(closureTokenIndex == 0u)
+   {
+      throwCompileError(pContext, CompileError::Expected, ")");
+      return nullptr;
+   }
+
+   Expression* expression = parseExpression(pContext, closureTokenIndex - 1u, true);
+
+   StatementReturn* statement = (StatementReturn*)pContext.mArena->allocate(sizeof(StatementReturn));
+   CflatInvokeCtor(StatementReturn, statement)(expression);
+
+   pContext.mTokenIndex = closureTokenIndex;
+
+   return statement;
+}
+
+bool Environment::parseFunctionCallArguments(ParsingContext& pContext,
+   CflatSTLVector(Expression*)* pArguments, CflatSTLVector(TypeUsage)* pTemplateTypes)
+{
+   CflatSTLVector(Token)& tokens = pContext.mTokens;
+   size_t& tokenIndex = pContext.mTokenIndex;
+
+   if(tokens[tokenIndex].mStart[0] == '<')
+   {
+      if(pTemplateTypes)
+      {
+         const size_t closureTokenIndex = findClosureTokenIndex(pContext, '<', '>');
+
+         if(closureTokenIndex > 0u)
+         {
+            while(tokenIndex++ < closureTokenIndex)
+            {
+               TypeUsage typeUsage = parseTypeUsage(pContext, closureTokenIndex - 1u);
+
+               if(typeUsage.mType)
+               {
+                  pTemplateTypes->push_back(typeUsage);
+               }
+               else
+               {
+                  pContext.mStringBuffer.assign(tokens[tokenIndex].mStart, tokens[tokenIndex].mLength);
+                  throwCompileError(pContext, Environment::CompileError::UndefinedType,
+                     pContext.mStringBuffer.c_str());
+                  return false;
+               }
+            }
+         }
+         else
+         {
+            throwCompileError(pContext, CompileError::Expected, ">");
+            return false;
+         }
+      }
+      else
+      {
+         throwCompileError(pContext, CompileError::Expected, "(");
+         return false;
+      }
+   }
+
+   const size_t closureTokenIndex = findClosureTokenIndex(pContext, '(', ')');
+
+   if(closureTokenIndex > 0u)
+   {
+      while(tokenIndex++ < closureTokenIndex)
+      {
+         const size_t separatorTokenIndex =
+            findSeparationTokenIndex(pContext, ',', closureTokenIndex);
+         const size_t tokenLastIndex = 
+           separatorTokenIndex > 0u ? separatorTokenIndex : closureTokenIndex;
+
+         Expression* argument = parseExpression(pContext, tokenLastIndex - 1u, true);
+
+         if(argument)
+         {
+            pArguments->push_back(argument);
+         }
+
+         tokenIndex = tokenLastIndex;
+      }
+   }
+   else
+   {
+      throwCompileError(pContext, CompileError::Expected, ")");
+      return false;
+   }
+
+   return true;
+}
+
+void Environment::bindVariableAccess(ParsingContext& pContext, Instance* pInstance,
+   ExpressionVariableAccess* pVariableAccess)
+{
+   const Identifier& identifier = pVariableAccess->mVariableIdentifier;
+
+   size_t instanceIndex = 0u;
+   Instance* localInstance =
+      pContext.mLocalInstancesHolder.retrieveInstance(identifier, &instanceIndex);
+
+   if(localInstance == pInstance)
+   {
+      const bool insideFunction = pContext.mCurrentFunctionIdentifier.mHash != 0u;
+
+      if(insideFunction &&
+         instanceIndex >= pContext.mLocalFrameBase &&
+         instanceIndex < pContext.mSwitchLocalsBase)
+      {
+         pVariableAccess->mLocalSlot = (uint32_t)(instanceIndex - pContext.mLocalFrameBase);
+      }
+   }
+   else if(pInstance->mScopeLevel == 0u)
+   {
+      pVariableAccess->mInstance = pInstance;
+   }
+}
+
+TypeUsage Environment::getTypeUsage(Context& pContext, Expression* pExpression)
+{
+   if(pExpression && pExpression->mValueTypeUsage.mType)
+   {
+      return pExpression->mValueTypeUsage;
+   }
+
+   TypeUsage typeUsage;
+
+   const bool errorFound = pContext.mType == ContextType::Execution
+      ? !static_cast<ExecutionContext&>(pContext).mErrorMessage.empty()
+      : !mErrorMessage.empty();
+
+   if(pExpression && !errorFound)
+   {
+      switch(pExpression->getType())
+      {
+      case ExpressionType::Value:
+         {
+            ExpressionValue* expression = static_cast<ExpressionValue*>(pExpression);
+            typeUsage = expression->mValue.mTypeUsage;
+         }
+         break;
+      case ExpressionType::NullPointer:
+         {
+            typeUsage = mTypeUsageVoidPtr;
+         }
+         break;
+      case ExpressionType::VariableAccess:
+         {
+            ExpressionVariableAccess* expression = static_cast<ExpressionVariableAccess*>(pExpression);
+            Instance* instance = retrieveInstance(pContext, expression->mVariableIdentifier);
+            typeUsage = instance->mTypeUsage;
+         }
+         break;
+      case ExpressionType::MemberAccess:
+         {
+            ExpressionMemberAccess* expression = static_cast<ExpressionMemberAccess*>(pExpression);
+            typeUsage = expression->mMemberTypeUsage;
+         }
+         break;
+      case ExpressionType::ArrayElementAccess:
+         {
+            ExpressionArrayElementAccess* expression =
+               static_cast<ExpressionArrayElementAccess*>(pExpression);
+            typeUsage = getTypeUsage(pContext, expression->mArray);
+            CflatAssert(typeUsage.isArray() || typeUsage.isPointer());
+
+            if(typeUsage.isArray())
+            {
+               CflatResetFlag(typeUsage.mFlags, TypeUsageFlags::Array);
+               typeUsage.mArraySize = 1u;
+            }
+            else
+            {
+               typeUsage.mPointerLevel--;
+            }
+         }
+         break;
+      case ExpressionType::UnaryOperation:
+         {
+            ExpressionUnaryOperation* expression = static_cast<ExpressionUnaryOperation*>(pExpression);
+            typeUsage = expression->mOperator == OperatorType::LogicalNot
+               ? mTypeUsageBool
+               : getTypeUsage(pContext, expression->mExpression);
+            CflatResetFlag(typeUsage.mFlags, TypeUsageFlags::Reference);
+         }
+         break;
+      case ExpressionType::BinaryOperation:
+         {
+            ExpressionBinaryOperation* expression = static_cast<ExpressionBinaryOperation*>(pExpression);
+
+            if(expression->mOverloadedOperatorTypeUsage.mType)
+            {
+               typeUsage = expression->mOverloadedOperatorTypeUsage;
+            }
+            else
+            {
+               if(isLogicalOperator(expression->mOperator))
+               {
+                  typeUsage = mTypeUsageBool;
+               }
+               else
+               {
+                  const TypeUsage leftTypeUsage = getTypeUsage(pContext, expression->mLeft);
+                  const TypeUsage rightTypeUsage = getTypeUsage(pContext, expression->mRight);
+
+                  if(leftTypeUsage.mType->isInteger() && !rightTypeUsage.mType->isInteger())
+                  {
+                     typeUsage = rightTypeUsage;
+                  }
+                  else
+                  {
+                     typeUsage = leftTypeUsage;
+                  }
+
+                  CflatResetFlag(typeUsage.mFlags, TypeUsageFlags::Reference);
+               }
+            }
+         }
+         break;
+      case ExpressionType::Parenthesized:
+         {
+            ExpressionParenthesized* expression = static_cast<ExpressionParenthesized*>(pExpression);
+            typeUsage = getTypeUsage(pContext, expression->mExpression);
+         }
+         break;
+      case ExpressionType::AddressOf:
+         {
+            ExpressionAddressOf* expression = static_cast<ExpressionAddressOf*>(pExpression);
+            typeUsage = getTypeUsage(pContext, expression->mExpression);
+            typeUsage.mPointerLevel++;
+         }
+         break;
+      case ExpressionType::Indirection:
+         {
+            ExpressionIndirection* expression = static_cast<ExpressionIndirection*>(pExpression);
+            typeUsage = getTypeUsage(pContext, expression->mExpression);
+            typeUsage.mPointerLevel--;
+         }
+         break;
+      case ExpressionType::SizeOf:
+         {
+            typeUsage = mTypeUsageSizeT;
+         }
+         break;
+      case ExpressionType::Cast:
+         {
+            ExpressionCast* expression = static_cast<ExpressionCast*>(pExpression);
+            typeUsage = expression->mTypeUsage;
+         }
+         break;
+      case ExpressionType::Conditional:
+         {
+            ExpressionConditional* expression = static_cast<ExpressionConditional*>(pExpression);
+            typeUsage = getTypeUsage(pContext, expression->mIfExpression);
+         }
+         break;
+      case ExpressionType::Assignment:
+         {
+            ExpressionAssignment* expression = static_cast<ExpressionAssignment*>(pExpression);
+            typeUsage = getTypeUsage(pContext, expression->mRightValue);
+         }
+         break;
+      case ExpressionType::FunctionCall:
+         {
+            ExpressionFunctionCall* expression = static_cast<ExpressionFunctionCall*>(pExpression);
+            typeUsage = expression->mFunction->mReturnTypeUsage;
+         }
+         break;
+      case ExpressionType::MethodCall:
+         {
+            ExpressionMethodCall* expression = static_cast<ExpressionMethodCall*>(pExpression);
+            typeUsage = expression->mMethod->mReturnTypeUsage;
+         }
+         break;
+      case ExpressionType::ArrayInitialization:
+         {
+            ExpressionArrayInitialization* expression =
+               static_cast<ExpressionArrayInitialization*>(pExpression);
+            typeUsage.mType = expression->mElementType;
+            CflatSetFlag(typeUsage.mFlags, TypeUsageFlags::Array);
+            typeUsage.mArraySize = (uint16_t)expression->mValues.size();
+         }
+         break;
+      case ExpressionType::ObjectConstruction:
+         {
+            ExpressionObjectConstruction* expression =
+              static_cast<ExpressionObjectConstruction*>(pExpression);
+            typeUsage.mType = expression->mObjectType;
+         }
+         break;
+      default:
+         CflatAssert(false);
+         break;
+      }
+   }
+
+   return typeUsage;
+}
+
+OperationKernel Environment::getOperationKernel(const TypeUsage& pLeft, const TypeUsage& pRight)
+{
+   if(!pLeft.mType || pLeft.mType != pRight.mType || pLeft.isArray() || pRight.isArray())
+   {
+      return OperationKernel::Generic;
+   }
+
+   if(pLeft.isPointer() || pRight.isPointer())
+   {
+      return pLeft.isPointer() && pRight.isPointer()
+         ? OperationKernel::Pointer
+         : OperationKernel::Generic;
+   }
+
+   if(pLeft.mType == mTypeInt32)
+   {
+      return OperationKernel::Int32;
+   }
+   else if(pLeft.mType == mTypeInt64)
+   {
+      return OperationKernel::Int64;
+   }
+   else if(pLeft.mType == mTypeFloat)
+   {
+      return OperationKernel::Float;
+   }
+   else if(pLeft.mType == mTypeDouble)
+   {
+      return OperationKernel::Double;
+   }
+
+   return OperationKernel::Generic;
+}
+
+bool Environment::isFoldable(const TypeUsage& pTypeUsage)
+{
+   if(!pTypeUsage.mType || pTypeUsage.isPointer() || pTypeUsage.isReference() || pTypeUsage.isArray())
+   {
+      return false;
+   }
+
+   return pTypeUsage.mType->mCategory == TypeCategory::BuiltIn ||
+      pTypeUsage.mType->mCategory == TypeCategory::Enum ||
+      pTypeUsage.mType->mCategory == TypeCategory::EnumClass;
+}
+
+const Value* Environment::getConstantValue(ParsingContext& pContext, Expression* pExpression)
+{
+   if(!pExpression)
+   {
+      return nullptr;
+   }
+
+   if(pExpression->getType() == ExpressionType::Value)
+   {
+      const Value& value = static_cast<ExpressionValue*>(pExpression)->mValue;
+      return isFoldable(value.mTypeUsage) ? &value : nullptr;
+   }
+
+   if(pExpression->getType() != ExpressionType::VariableAccess)
+   {
+      return nullptr;
+   }
+
+   ExpressionVariableAccess* variableAccess = static_cast<ExpressionVariableAccess*>(pExpression);
+   Instance* instance = retrieveInstance(pContext, variableAccess->mVariableIdentifier);
+
+   if(!instance || !instance->mTypeUsage.isConst() || !isFoldable(instance->mTypeUsage))
+   {
+      return nullptr;
+   }
+
+   for(size_t i = pContext.mConstantInstances.size(); i > 0u; i--)
+   {
+      if(pContext.mConstantInstances[i - 1u].mInstance == instance)
+      {
+         return &instance->mValue;
+      }
+   }
+
+   // enum values registered from the host never change, while the rest of the constants
+   // declared in the program are only known if they are in the list
+   const bool isEnumValue = instance->mScopeLevel == 0u && instance->mValue.mValueBuffer &&
+      (instance->mTypeUsage.mType->mCategory == TypeCategory::Enum ||
+         instance->mTypeUsage.mType->mCategory == TypeCategory::EnumClass);
+
+   if(!isEnumValue)
+   {
+      return nullptr;
+   }
+
+   for(size_t i = 0u; i < pContext.mRegisteredInstances.size(); i++)
+   {
+      if(pContext.mRegisteredInstances[i].mIdentifier == instance->mIdentifier)
+      {
+         return nullptr;
+      }
+   }
+
+   return &instance->mValue;
+}
+
+void Environment::inlineConstant(ParsingContext& pContext, Expression** pExpression)
+{
+   Expression* expression = *pExpression;
+
+   if(!expression || expression->getType() != ExpressionType::VariableAccess)
+   {
+      return;
+   }
+
+   const Value* constantValue = getConstantValue(pContext, expression);
+
+   if(constantValue)
+   {
+      ExpressionValue* valueExpression = (ExpressionValue*)pContext.mArena->allocate(sizeof(ExpressionValue));
+      CflatInvokeCtor(ExpressionValue, valueExpression)(*constantValue);
+      valueExpression->mValueTypeUsage = expression->mValueTypeUsage;
+
+      CflatInvokeDtor(Expression, expression);
+
+      *pExpression = valueExpression;
+   }
+}
+
+Expression* Environment::foldConstantExpression(ParsingContext& pContext, Expression* pExpression)
+{
+   bool foldable = false;
+
+   switch(pExpression->getType())
+   {
+   case ExpressionType::Parenthesized:
+      {
+         ExpressionParenthesized* expression = static_cast<ExpressionParenthesized*>(pExpression);
+         inlineConstant(pContext, &expression->mExpression);
+         foldable = getConstantValue(pContext, expression->mExpression) != nullptr;
+      }
+      break;
+   case ExpressionType::UnaryOperation:
+      {
+         ExpressionUnaryOperation* expression = static_cast<ExpressionUnaryOperation*>(pExpression);
+
+         if(expression->mOperator == OperatorType::LogicalNot ||
+            expression->mOperator == OperatorType::BitwiseNot ||
+            expression->mOperator == OperatorType::Negate)
+         {
+            inlineConstant(pContext, &expression->mExpression);
+            foldable = getConstantValue(pContext, expression->mExpression) != nullptr;
+         }
+      }
+      break;
+   case ExpressionType::BinaryOperation:
+      {
+         ExpressionBinaryOperation* expression = static_cast<ExpressionBinaryOperation*>(pExpression);
+
+         if(!expression->mOverloadedOperatorTypeUsage.mType &&
+            !expression->mOperatorMethodOwner && !expression->mOperatorFunction)
+         {
+            inlineConstant(pContext, &expression->mLeft);
+            inlineConstant(pContext, &expression->mRight);
+
+            const Value* rightValue = getConstantValue(pContext, expression->mRight);
+            foldable = getConstantValue(pContext, expression->mLeft) && rightValue;
+
+            // divisions by zero are left for the execution to report
+            if(foldable &&
+               (expression->mOperator == OperatorType::Divide ||
+                  expression->mOperator == OperatorType::Modulo))
+            {
+               foldable = fabs(getValueAsDecimal(*rightValue)) > 0.000000001;
+            }
+         }
+      }
+      break;
+   case ExpressionType::Cast:
+      {
+         ExpressionCast* expression = static_cast<ExpressionCast*>(pExpression);
+
+         if((expression->mCastType == CastType::CStyle || expression->mCastType == CastType::Static) &&
+            isFoldable(expression->mTypeUsage))
+         {
+            inlineConstant(pContext, &expression->mExpression);
+            foldable = getConstantValue(pContext, expression->mExpression) != nullptr;
+         }
+      }
+      break;
+   case ExpressionType::SizeOf:
+      {
+         ExpressionSizeOf* expression = static_cast<ExpressionSizeOf*>(pExpression);
+         foldable = expression->mTypeUsage.mType ||
+            (expression->mExpression && expression->mExpression->mValueTypeUsage.mType);
+
+         // the operand of 'sizeof' is not evaluated
+         if(foldable && !expression->mTypeUsage.mType)
+         {
+            expression->mTypeUsage = expression->mExpression->mValueTypeUsage;
+         }
+      }
+      break;
+   case ExpressionType::Conditional:
+      {
+         ExpressionConditional* expression = static_cast<ExpressionConditional*>(pExpression);
+         inlineConstant(pContext, &expression->mCondition);
+         inlineConstant(pContext, &expression->mIfExpression);
+         inlineConstant(pContext, &expression->mElseExpression);
+
+         const Value* conditionValue = getConstantValue(pContext, expression->mCondition);
+
+         if(conditionValue)
+         {
+            Expression*& selectedExpression = getValueAsInteger(*conditionValue)
+               ? expression->mIfExpression
+               : expression->mElseExpression;
+
+            // the branch replaces the whole expression, as long as it keeps its type
+            if(selectedExpression &&
+               selectedExpression->mValueTypeUsage == expression->mValueTypeUsage)
+            {
+               Expression* replacement = selectedExpression;
+               selectedExpression = nullptr;
+
+               CflatInvokeDtor(Expression, pExpression);
+
+               return replacement;
+            }
+         }
+      }
+      break;
+   case ExpressionType::ArrayElementAccess:
+      {
+         ExpressionArrayElementAccess* expression =
+            static_cast<ExpressionArrayElementAccess*>(pExpression);
+         inlineConstant(pContext, &expression->mArrayElementIndex);
+      }
+      break;
+   case ExpressionType::Assignment:
+      {
+         ExpressionAssignment* expression = static_cast<ExpressionAssignment*>(pExpression);
+         inlineConstant(pContext, &expression->mRightValue);
+      }
+      break;
+   default:
+      break;
+   }
+
+   if(!foldable || !mExecutionContext.mErrorMessage.empty())
+   {
+      return pExpression;
+   }
+
+   Value value;
+   value.mValueInitializationHint = ValueInitializationHint::Stack;
+   evaluateExpression(mExecutionContext, pExpression, &value);
+
+   ExpressionValue* valueExpression = (ExpressionValue*)pContext.mArena->allocate(sizeof(ExpressionValue));
+   CflatInvokeCtor(ExpressionValue, valueExpression)(value);
+   valueExpression->mValueTypeUsage = pExpression->mValueTypeUsage;
+
+   CflatInvokeDtor(Expression, pExpression);
+
+   return valueExpression;
+}
+
+Statement* Environment::eliminateDeadBranches(ParsingContext& pContext, Statement* pStatement)
+{
+   Statement* replacement = nullptr;
+
+   if(pStatement->getType() == StatementType::If)
+   {
+      StatementIf* statement = static_cast<StatementIf*>(pStatement);
+      inlineConstant(pContext, &statement->mCondition);
+
+      const Value* conditionValue = getConstantValue(pContext, statement->mCondition);
+
+      if(!conditionValue)
+      {
+         return pStatement;
+      }
+
+      const bool conditionMet = getValueAsInteger(*conditionValue) != 0;
+      Statement*& selectedStatement = conditionMet ? statement->mIfStatement : statement->mElseStatement;
+      Statement* discardedStatement = conditionMet ? statement->mElseStatement : statement->mIfStatement;
+
+      // declarations outside of a block take a local instance slot in the enclosing scope
+      if(discardedStatement && discardedStatement->getType() == StatementType::VariableDeclaration)
+      {
+         return pStatement;
+      }
+
+      replacement = selectedStatement;
+      selectedStatement = nullptr;
+   }
+   else if(pStatement->getType() == StatementType::Switch)
+   {
+      StatementSwitch* statement = static_cast<StatementSwitch*>(pStatement);
+      inlineConstant(pContext, &statement->mCondition);
+
+      const Value* conditionValue = getConstantValue(pContext, statement->mCondition);
+
+      if(!conditionValue)
+      {
+         return pStatement;
+      }
+
+      // the case sections before the first one which gets executed can never be reached
+      const int64_t conditionValueAsInteger = getValueAsInteger(*conditionValue);
+      size_t firstExecutedSectionIndex = 0u;
+
+      for(; firstExecutedSectionIndex < statement->mCaseSections.size(); firstExecutedSectionIndex++)
+      {
+         Expression* caseExpression = statement->mCaseSections[firstExecutedSectionIndex].mExpression;
+
+         if(!caseExpression)
+         {
+            break;
+         }
+
+         const Value* caseValue = getConstantValue(pContext, caseExpression);
+
+         if(!caseValue)
+         {
+            return pStatement;
+         }
+
+         if(getValueAsInteger(*caseValue) == conditionValueAsInteger)
+         {
+            break;
+         }
+      }
+
+      if(firstExecutedSectionIndex < statement->mCaseSections.size())
+      {
+         StatementSwitch::CaseSection* caseSections = statement->mCaseSections.data();
+
+         for(size_t i = 0u; i < firstExecutedSectionIndex; i++)
+         {
+            CflatInvokeDtor(Expression, caseSections[i].mExpression);
+
+            for(size_t j = 0u; j < caseSections[i].mStatements.size(); j++)
+            {
+               CflatInvokeDtor(Statement, caseSections[i].mStatements[j]);
+            }
+         }
+
+         statement->mCaseSections.erase(statement->mCaseSections.begin(),
+            statement->mCaseSections.begin() + firstExecutedSectionIndex);
+
+         buildSwitchCaseLookup(pContext, statement);
+
+         return pStatement;
+      }
+   }
+   else
+   {
+      return pStatement;
+   }
+
+   // statements with nothing left to execute get replaced with an empty block
+   if(!replacement)
+   {
+      StatementBlock* emptyBlock = (StatementBlock*)pContext.mArena->allocate(sizeof(StatementBlock));
+      CflatInvokeCtor(StatementBlock, emptyBlock)(false);
+      emptyBlock->mProgram = pStatement->mProgram;
+      emptyBlock->mLine = pStatement->mLine;
+      replacement = emptyBlock;
+   }
+
+   CflatInvokeDtor(Statement, pStatement);
+
+   return replacement;
+}
+
+Type* Environment::findType(const Context& pContext, const Identifier& pIdentifier,
+   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   Type* type = nullptr;
+
+   for(size_t i = 0u; i < pContext.mTypeAliases.size(); i++)
+   {
+      if(pContext.mTypeAliases[i].mIdentifier == pIdentifier)
+      {
+         const TypeUsage& typeUsage = pContext.mTypeAliases[i].mTypeUsage;
+
+         if(typeUsage.mFlags == 0u)
+         {
+            type = typeUsage.mType;
+            break;
+         }
+      }
+   }
+
+   if(!type)
+   {
+      type = pContext.mNamespaceStack.back()->getType(pIdentifier, pTemplateTypes, true);
+   }
+
+   if(!type)
+   {
+      for(size_t i = 0u; i < pContext.mUsingDirectives.size(); i++)
+      {
+         type = pContext.mUsingDirectives[i].mNamespace->getType(pIdentifier, pTemplateTypes);
+
+         if(type)
+         {
+            break;
+         }
+      }
+   }
+
+   return type;
+}
+
+Function* Environment::findFunction(const Context& pContext, const Identifier& pIdentifier,
+   const CflatArgsVector(TypeUsage)& pParameterTypes,
+   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   Namespace* ns = pContext.mNamespaceStack.back();
+   Function* function = ns->getFunction(pIdentifier, pParameterTypes, pTemplateTypes, true);
+
+   if(!function)
+   {
+      for(size_t i = 0u; i < pContext.mUsingDirectives.size(); i++)
+      {
+         Namespace* usingNS = pContext.mUsingDirectives[i].mNamespace;
+         function =
+            usingNS->getFunction(pIdentifier, pParameterTypes, pTemplateTypes, true);
+
+         if(function)
+         {
+            break;
+         }
+      }
+   }
+
+   return function;
+}
+
+Function* Environment::findFunction(const Context& pContext, const Identifier& pIdentifier,
+   const CflatArgsVector(Value)& pArguments,
+   const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   CflatArgsVector(TypeUsage) typeUsages;
+
+   for(size_t i = 0u; i < pArguments.size(); i++)
+   {
+      typeUsages.push_back(pArguments[i].mTypeUsage);
+   }
+
+   return findFunction(pContext, pIdentifier, typeUsages, pTemplateTypes);
+}
+
+void Environment::registerTypeAlias(
+  Context& pContext, const Identifier& pIdentifier, const TypeUsage& pTypeUsage)
+{
+   if(pContext.mScopeLevel > 0u)
+   {
+      TypeAlias typeAlias(pIdentifier, pTypeUsage);
+      typeAlias.mScopeLevel = pContext.mScopeLevel;
+      pContext.mTypeAliases.push_back(typeAlias);
+   }
+   else
+   {
+      pContext.mNamespaceStack.back()->registerTypeAlias(pIdentifier, pTypeUsage);
+   }
+}
+
+Instance* Environment::registerInstance(Context& pContext,
+   const TypeUsage& pTypeUsage, const Identifier& pIdentifier)
+{
+   Instance* instance = nullptr;
+   bool initializationRequired = false;
+
+   if(pContext.mScopeLevel > 0u)
+   {
+      instance = pContext.mLocalInstancesHolder.registerInstance(pTypeUsage, pIdentifier);
+      initializationRequired = true;
+   }
+   else
+   {
+      instance = pContext.mNamespaceStack.back()->retrieveInstance(pIdentifier);
+
+      if(!instance)
+      {
+         instance = pContext.mNamespaceStack.back()->registerInstance(pTypeUsage, pIdentifier);
+         initializationRequired = true;
+      }
+      else if(instance->mTypeUsage != pTypeUsage)
+      {
+         instance->mTypeUsage = pTypeUsage;
+         initializationRequired = true;
+      }
+   }
+
+   CflatAssert(instance);
+
+   if(initializationRequired)
+   {
+      if(instance->mTypeUsage.isReference())
+      {
+         instance->mValue.initExternal(instance->mTypeUsage);
+      }
+      else if(pContext.mScopeLevel == 0u)
+      {
+         instance->mValue.initOnHeap(instance->mTypeUsage);
+      }
+      else
+      {
+         instance->mValue.initOnStack(instance->mTypeUsage, &pContext.mStack);
+      }
+   }
+
+   CflatAssert(instance->mTypeUsage == pTypeUsage);
+
+   instance->mScopeLevel = pContext.mScopeLevel;
+
+   return instance;
+}
+
+Instance* Environment::retrieveInstance(Context& pContext, const Identifier& pIdentifier)
+{
+   Instance* instance = pContext.mLocalInstancesHolder.retrieveInstance(pIdentifier);
+
+   // static local variables hide the local ones declared in outer scopes
+   if(pContext.mType == ContextType::Parsing)
+   {
+      const ParsingContext& parsingContext = static_cast<const ParsingContext&>(pContext);
+
+      for(size_t i = parsingContext.mStaticInstances.size(); i > 0u; i--)
+      {
+         const ParsingContext::StaticInstance& staticInstance = parsingContext.mStaticInstances[i - 1u];
+
+         if(staticInstance.mInstance->mIdentifier == pIdentifier)
+         {
+            if(!instance || staticInstance.mScopeLevel > instance->mScopeLevel)
+            {
+               return staticInstance.mInstance;
+            }
+
+            break;
+         }
+      }
+   }
+
+   if(!instance)
+   {
+      instance = pContext.mNamespaceStack.back()->retrieveInstance(pIdentifier, true);
+
+      if(!instance)
+      {
+         for(size_t i = 0u; i < pContext.mUsingDirectives.size(); i++)
+         {
+            instance = pContext.mUsingDirectives[i].mNamespace->retrieveInstance(pIdentifier, true);
+
+            if(instance)
+            {
+               break;
+            }
+         }
+      }
+
+      if(!instance)
+      {
+         const char* lastSeparator = pIdentifier.findLastSeparator();
+
+         if(lastSeparator)
+         {
+            char buffer[kDefaultLocalStringBufferSize];
+            const size_t typeIdentifierLength = lastSeparator - pIdentifier.mName;
+            strncpy(buffer, pIdentifier.mName, typeIdentifierLength);
+            buffer[typeIdentifierLength] = '\0';
+            const Identifier typeIdentifier(buffer);
+            const Identifier staticMemberIdentifier(lastSeparator + 2);
+
+            Type* type = findType(pContext, typeIdentifier);
+
+            if(type && type->mCategory == TypeCategory::StructOrClass)
+            {
+               instance = static_cast<Struct*>(type)->getStaticMemberInstance(staticMemberIdentifier);
+            }
+         }
+      }
+   }
+
+   return instance;
+}
+
+Instance* Environment::retrieveInstance(ExecutionContext& pContext,
+   const ExpressionVariableAccess* pVariableAccess)
+{
+   if(pVariableAccess->mInstance)
+   {
+      return pVariableAccess->mInstance;
+   }
+
+   if(pVariableAccess->mLocalSlot != ExpressionVariableAccess::kInvalidLocalSlot)
+   {
+      const size_t instanceIndex = pContext.mLocalFrameBase + pVariableAccess->mLocalSlot;
+
+      if(instanceIndex < pContext.mLocalInstancesHolder.getInstancesCount())
+      {
+         Instance* instance = pContext.mLocalInstancesHolder.getInstance(instanceIndex);
+
+         if(instance->mIdentifier == pVariableAccess->mVariableIdentifier)
+         {
+            return instance;
+         }
+      }
+   }
+
+   return retrieveInstance(pContext, pVariableAccess->mVariableIdentifier);
+}
+
+void Environment::incrementBlockLevel(Context& pContext)
+{
+   pContext.mBlockLevel++;
+}
+
+void Environment::decrementBlockLevel(Context& pContext)
+{
+   while(!pContext.mUsingDirectives.empty() &&
+      pContext.mUsingDirectives.back().mBlockLevel >= pContext.mBlockLevel)
+   {
+      pContext.mUsingDirectives.pop_back();
+   }
+
+   pContext.mBlockLevel--;
+}
+
+void Environment::incrementScopeLevel(Context& pContext)
+{
+   pContext.mScopeLevel++;
+}
+
+void Environment::decrementScopeLevel(Context& pContext)
+{
+   const bool isExecutionContext = pContext.mType == ContextType::Execution;
+
+   if(!isExecutionContext)
+   {
+      ParsingContext& parsingContext = static_cast<ParsingContext&>(pContext);
+
+      while(!parsingContext.mRegisteredInstances.empty() &&
+         parsingContext.mRegisteredInstances.back().mScopeLevel >= pContext.mScopeLevel)
+      {
+         parsingContext.mRegisteredInstances.pop_back();
+      }
+
+      while(!parsingContext.mConstantInstances.empty() &&
+         parsingContext.mConstantInstances.back().mScopeLevel >= pContext.mScopeLevel)
+      {
+         parsingContext.mConstantInstances.pop_back();
+      }
+
+      while(!parsingContext.mStaticInstances.empty() &&
+         parsingContext.mStaticInstances.back().mScopeLevel >= pContext.mScopeLevel)
+      {
+         parsingContext.mStaticInstances.pop_back();
+      }
+
+      while(!parsingContext.mLocalNamespaceStack.empty() &&
+         parsingContext.mLocalNamespaceStack.back().mScopeLevel >= pContext.mScopeLevel)
+      {
+         parsingContext.mLocalNamespaceStack.pop_back();
+      }
+   }
+
+   while(!pContext.mTypeAliases.empty() &&
+      pContext.mTypeAliases.back().mScopeLevel >= pContext.mScopeLevel)
+   {
+      pContext.mTypeAliases.pop_back();
+   }
+
+   pContext.mLocalInstancesHolder.releaseInstances(pContext.mScopeLevel, isExecutionContext);
+
+   // execution contexts only register local instances in their own holders, so the instances of
+   // the namespaces, which are shared by all of them, are only registered in scopes while parsing
+   if(!isExecutionContext)
+   {
+      mGlobalNamespace.releaseInstances(pContext.mScopeLevel, false);
+   }
+
+   pContext.mScopeLevel--;
+}
+
+void Environment::throwRuntimeError(ExecutionContext& pContext, RuntimeError pError, const char* pArg)
+{
+   if(!pContext.mErrorMessage.empty())
+      return;
+
+   char errorMsg[kDefaultLocalStringBufferSize];
+   sprintf(errorMsg, kRuntimeErrorStrings[(int)pError], pArg);
+
+   char lineAsString[16];
+   sprintf(lineAsString, "%d", pContext.mCallStack.back().mLine);
+
+   pContext.mErrorMessage.assign("[Runtime Error] '");
+   pContext.mErrorMessage.append(pContext.mProgram->mIdentifier.mName);
+   pContext.mErrorMessage.append("' -- Line ");
+   pContext.mErrorMessage.append(lineAsString);
+   pContext.mErrorMessage.append(": ");
+   pContext.mErrorMessage.append(errorMsg);
+}
+
+void Environment::throwStackOverflowError(ExecutionContext& pContext)
+{
+   pContext.mStack.mOverflown = false;
+   throwRuntimeError(pContext, RuntimeError::StackOverflow);
+}
+
+void Environment::evaluateExpression(ExecutionContext& pContext, Expression* pExpression, Value* pOutValue)
+{
+   if(!pContext.mErrorMessage.empty())
+      return;
+
+   switch(pExpression->getType())
+   {
+   case ExpressionType::Value:
+      {
+         ExpressionValue* expression = static_cast<ExpressionValue*>(pExpression);
+         *pOutValue = expression->mValue;
+      }
+      break;
+   case ExpressionType::NullPointer:
+      {
+         assertValueInitialization(pContext, mTypeUsageVoidPtr, pOutValue);
+         const void* nullPointer = nullptr;
+         pOutValue->set(&nullPointer);
+      }
+      break;
+   case ExpressionType::VariableAccess:
+      {
+         ExpressionVariableAccess* expression = static_cast<ExpressionVariableAccess*>(pExpression);
+         Instance* instance = retrieveInstance(pContext, expression);
+
+         if(pOutValue->mTypeUsage.isPointer() && instance->mTypeUsage.isArray())
+         {
+            getAddressOfValue(pContext, instance->mValue, pOutValue);
+         }
+         else
+         {
+            *pOutValue = instance->mValue;
+         }
+      }
+      break;
+   case ExpressionType::MemberAccess:
+      {
+         ExpressionMemberAccess* expression = static_cast<ExpressionMemberAccess*>(pExpression);
+         getInstanceDataValue(pContext, expression, pOutValue);
+      }
+      break;
+   case ExpressionType::ArrayElementAccess:
+      {
+         ExpressionArrayElementAccess* expression =
+            static_cast<ExpressionArrayElementAccess*>(pExpression);
+
+         const TypeUsage arrayTypeUsage = getTypeUsage(pContext, expression->mArray);
+         CflatAssert(arrayTypeUsage.isArray() || arrayTypeUsage.isPointer());
+
+         const TypeUsage arrayElementTypeUsage = getTypeUsage(pContext, expression);
+         assertValueInitialization(pContext, arrayElementTypeUsage, pOutValue);
+
+         Value arrayValue;
+         arrayValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, expression->mArray, &arrayValue);
+
+         Value indexValue;
+         indexValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, expression->mArrayElementIndex, &indexValue);
+         const size_t index = (size_t)getValueAsInteger(indexValue);
+         
+         if(arrayValue.mTypeUsage.isArray())
+         {
+            const size_t arraySize = (size_t)arrayTypeUsage.mArraySize;
+
+            if(index < arraySize)
+            {
+               const size_t arrayElementSize = arrayElementTypeUsage.mType->mSize;
+               const size_t offset = arrayElementSize * index;
+               pOutValue->set(arrayValue.mValueBuffer + offset);
+            }
+            else
+            {
+               char buffer[kDefaultLocalStringBufferSize];
+               sprintf(buffer, "size %zu, index %zu", arraySize, index);
+               throwRuntimeError(pContext, RuntimeError::InvalidArrayIndex, buffer);
+            }
+         }
+         else
+         {
+            const size_t arrayElementTypeSize = arrayElementTypeUsage.mType->mSize;
+            const size_t ptrOffset = arrayElementTypeSize * index;
+            const char* ptr = CflatValueAs(&arrayValue, char*) + ptrOffset;
+            memcpy(pOutValue->mValueBuffer, ptr, arrayElementTypeSize);
+         }
+      }
+      break;
+   case ExpressionType::UnaryOperation:
+      {
+         ExpressionUnaryOperation* expression = static_cast<ExpressionUnaryOperation*>(pExpression);
+
+         const TypeUsage typeUsage = getTypeUsage(pContext, expression->mExpression);
+         assertValueInitialization(pContext, typeUsage, pOutValue);
+
+         Value preValue;
+         preValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, expression->mExpression, &preValue);
+
+         pOutValue->set(preValue.mValueBuffer);
+
+         const bool isIncrementOrDecrement =
+            expression->mOperator == OperatorType::Increment ||
+            expression->mOperator == OperatorType::Decrement;
+
+         if(isIncrementOrDecrement)
+         {
+            applyUnaryOperator(pContext, preValue, expression->mOperator, &preValue);
+
+            if(!expression->mPostOperator)
+            {
+               pOutValue->set(preValue.mValueBuffer);
+            }
+         }
+         else
+         {
+            applyUnaryOperator(pContext, preValue, expression->mOperator, pOutValue);
+         }
+      }
+      break;
+   case ExpressionType::BinaryOperation:
+      {
+         ExpressionBinaryOperation* expression = static_cast<ExpressionBinaryOperation*>(pExpression);
+
+         const TypeUsage typeUsage = getTypeUsage(pContext, expression);
+         assertValueInitialization(pContext, typeUsage, pOutValue);
+
+         Value leftValue;
+         leftValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, expression->mLeft, &leftValue);
+
+         Value rightValue;
+         bool evaluateRightValue = true;
+
+         if(expression->mOperator == OperatorType::LogicalAnd)
+         {
+            if(!getValueAsInteger(leftValue))
+            {
+               const bool value = false;
+               rightValue.initOnStack(mTypeUsageBool, &pContext.mStack);
+               rightValue.set(&value);
+               evaluateRightValue = false;
+            }
+         }
+         else if(expression->mOperator == OperatorType::LogicalOr)
+         {
+            if(getValueAsInteger(leftValue))
+            {
+               const bool value = true;
+               rightValue.initOnStack(mTypeUsageBool, &pContext.mStack);
+               rightValue.set(&value);
+               evaluateRightValue = false;
+            }
+         }
+
+         if(evaluateRightValue)
+         {
+            rightValue.mValueInitializationHint = ValueInitializationHint::Stack;
+            evaluateExpression(pContext, expression->mRight, &rightValue);
+         }
+
+         if(expression->mOperatorMethodOwner || expression->mOperatorFunction)
+         {
+            Method* operatorMethod = expression->mOperatorMethodOwner
+               ? &expression->mOperatorMethodOwner->mMethods[expression->mOperatorMethodIndex]
+               : nullptr;
+            applyOverloadedBinaryOperator(pContext, leftValue, rightValue,
+               operatorMethod, expression->mOperatorFunction, pOutValue);
+            break;
+         }
+
+         const bool appliedByKernel = expression->mKernel != OperationKernel::Generic &&
+            applyOperationKernel(expression->mKernel, expression->mOperator,
+               leftValue, rightValue, pOutValue);
+
+         if(!appliedByKernel)
+         {
+            applyBinaryOperator(pContext, leftValue, rightValue, expression->mOperator, pOutValue);
+         }
+      }
+      break;
+   case ExpressionType::Parenthesized:
+      {
+         ExpressionParenthesized* expression = static_cast<ExpressionParenthesized*>(pExpression);
+         evaluateExpression(pContext, expression->mExpression, pOutValue);
+      }
+      break;
+   case ExpressionType::AddressOf:
+      {
+         ExpressionAddressOf* expression = static_cast<ExpressionAddressOf*>(pExpression);
+
+         Value value;
+         value.initExternal(getTypeUsage(pContext, expression->mExpression));
+         evaluateExpression(pContext, expression->mExpression, &value);
+
+         pOutValue->mValueInitializationHint = ValueInitializationHint::Stack;
+         getAddressOfValue(pContext, value, pOutValue);
+      }
+      break;
+   case ExpressionType::Indirection:
+      {
+         ExpressionIndirection* expression = static_cast<ExpressionIndirection*>(pExpression);
+
+         const TypeUsage expressionTypeUsage = getTypeUsage(pContext, expression->mExpression);
+         CflatAssert(expressionTypeUsage.mPointerLevel > 0u);
+
+         TypeUsage typeUsage = expressionTypeUsage;
+         typeUsage.mPointerLevel--;
+         pOutValue->mValueInitializationHint = ValueInitializationHint::Stack;
+         assertValueInitialization(pContext, typeUsage, pOutValue);
+
+         Value value;
+         value.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, expression->mExpression, &value);
+
+         applyUnaryOperator(pContext, value, OperatorType::Dereference, pOutValue);
+      }
+      break;
+   case ExpressionType::SizeOf:
+      {
+         ExpressionSizeOf* expression = static_cast<ExpressionSizeOf*>(pExpression);
+         size_t size = 0u;
+         
+         if(expression->mTypeUsage.mType)
+         {
+            size = expression->mTypeUsage.getSize();
+         }
+         else if(expression->mExpression)
+         {
+            Value value;
+            value.mValueInitializationHint = ValueInitializationHint::Stack;
+            evaluateExpression(pContext, expression->mExpression, &value);
+            size = value.mTypeUsage.getSize();
+         }
+
+         assertValueInitialization(pContext, mTypeUsageSizeT, pOutValue);
+         pOutValue->set(&size);
+      }
+      break;
+   case ExpressionType::Cast:
+      {
+         ExpressionCast* expression = static_cast<ExpressionCast*>(pExpression);
+
+         assertValueInitialization(pContext, expression->mTypeUsage, pOutValue);
+
+         Value valueToCast;
+         valueToCast.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, expression->mExpression, &valueToCast);
+
+         const TypeUsage& targetTypeUsage = expression->mTypeUsage;
+
+         if(expression->mCastType == CastType::CStyle || expression->mCastType == CastType::Static)
+         {
+            performStaticCast(pContext, valueToCast, targetTypeUsage, pOutValue);
+         }
+         else if(expression->mCastType == CastType::Dynamic)
+         {
+            performInheritanceCast(pContext, valueToCast, targetTypeUsage, pOutValue);
+         }
+         else if(expression->mCastType == CastType::Reinterpret)
+         {
+            const void* ptr = CflatValueAs(&valueToCast, void*);
+            pOutValue->set(&ptr);
+         }
+      }
+      break;
+   case ExpressionType::Conditional:
+      {
+         ExpressionConditional* expression = static_cast<ExpressionConditional*>(pExpression);
+
+         bool conditionMet = false;
+         {
+            Value conditionValue;
+            conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+            evaluateExpression(pContext, expression->mCondition, &conditionValue);
+            conditionMet = getValueAsInteger(conditionValue) != 0;
+         }
+
+         Expression* valueSource = conditionMet
+            ? expression->mIfExpression
+            : expression->mElseExpression;
+         evaluateExpression(pContext, valueSource, pOutValue);
+      }
+      break;
+   case ExpressionType::Assignment:
+      {
+         ExpressionAssignment* expression = static_cast<ExpressionAssignment*>(pExpression);
+
+         const TypeUsage expressionTypeUsage = getTypeUsage(pContext, expression->mRightValue);
+         Value expressionValue;
+         expressionValue.initOnStack(expressionTypeUsage, &pContext.mStack);
+         evaluateExpression(pContext, expression->mRightValue, &expressionValue);
+
+         Value instanceDataValue;
+         getInstanceDataValue(pContext, expression->mLeftValue, &instanceDataValue);
+
+         performAssignment(pContext, expressionValue, expression->mOperator, expression->mKernel,
+            &instanceDataValue);
+         *pOutValue = instanceDataValue;
+      }
+      break;
+   case ExpressionType::FunctionCall:
+      {
+         ExpressionFunctionCall* expression = static_cast<ExpressionFunctionCall*>(pExpression);
+
+         Function* function = expression->mFunction;
+         CflatAssert(function);
+
+         assertValueInitialization(pContext, function->mReturnTypeUsage, pOutValue);
+
+         const bool functionReturnValueIsConst =
+            CflatHasFlag(function->mReturnTypeUsage.mFlags, TypeUsageFlags::Const);
+         const bool outValueIsConst =
+            CflatHasFlag(pOutValue->mTypeUsage.mFlags, TypeUsageFlags::Const);
+
+         if(outValueIsConst && !functionReturnValueIsConst)
+         {
+            CflatResetFlag(pOutValue->mTypeUsage.mFlags, TypeUsageFlags::Const);
+         }
+
+         // script function: the arguments get evaluated straight into its frame
+         if(function->mDeclaration)
+         {
+            callFunction(pContext, function, expression->mArguments, pOutValue);
+         }
+         else
+         {
+            CflatArgsVector(Value) argumentValues;
+            getArgumentValues(pContext, expression->mArguments, argumentValues);
+
+            CflatArgsVector(Value) preparedArgumentValues;
+
+            Profiler* profiler = pContext.mProfiler;
+
+            if(profiler)
+            {
+               profiler->beginFunctionCall(function);
+            }
+
+            // typed native: the argument data gets passed straight, without going through 'execute'
+            if(function->mNativeCall)
+            {
+               const void* argumentsData[kArgsVectorSize];
+               prepareArgumentsForNativeCall(pContext, function->mParameters, argumentValues,
+                  preparedArgumentValues, argumentsData);
+
+               const bool mustReturnValue =
+                  function->mReturnTypeUsage.mType && function->mReturnTypeUsage.mType != mTypeVoid;
+               invokeNativeCall(function->mNativeCall, nullptr, argumentsData,
+                  function->mReturnTypeUsage, mustReturnValue ? pOutValue : nullptr);
+            }
+            else
+            {
+               prepareArgumentsForFunctionCall(pContext, function->mParameters, argumentValues,
+                  preparedArgumentValues);
+               function->execute(preparedArgumentValues, pOutValue);
+            }
+
+            if(profiler)
+            {
+               profiler->endCall();
+            }
+
+            while(!preparedArgumentValues.empty())
+            {
+               preparedArgumentValues.pop_back();
+            }
+
+            while(!argumentValues.empty())
+            {
+               argumentValues.pop_back();
+            }
+         }
+
+         if(outValueIsConst && !functionReturnValueIsConst)
+         {
+            CflatSetFlag(pOutValue->mTypeUsage.mFlags, TypeUsageFlags::Const);
+         }
+      }
+      break;
+   case ExpressionType::MethodCall:
+      {
+         ExpressionMethodCall* expression = static_cast<ExpressionMethodCall*>(pExpression);
+         ExpressionMemberAccess* memberAccess =
+            static_cast<ExpressionMemberAccess*>(expression->mMemberAccess);
+
+         Method* method = expression->mMethod;
+         CflatAssert(method);
+
+         assertValueInitialization(pContext, method->mReturnTypeUsage, pOutValue);
+
+         Value instanceDataValue;
+         getInstanceDataValue(pContext, memberAccess->mMemberOwner, &instanceDataValue);
+
+         if(instanceDataValue.mTypeUsage.isPointer() && !CflatValueAs(&instanceDataValue, void*))
+         {
+            throwRuntimeError(pContext, RuntimeError::NullPointerAccess,
+               memberAccess->mMemberIdentifier.mName);
+         }
+
+         if(!pContext.mErrorMessage.empty())
+            break;
+
+         CflatArgsVector(Value) argumentValues;
+         getArgumentValues(pContext, expression->mArguments, argumentValues);
+
+         CflatArgsVector(Value) preparedArgumentValues;
+
+         Profiler* profiler = pContext.mProfiler;
+
+         if(profiler)
+         {
+            const Type* ownerType = instanceDataValue.mTypeUsage.mType;
+            profiler->beginMethodCall(method, ownerType);
+         }
+
+         if(method->mNativeCall)
+         {
+            const void* argumentsData[kArgsVectorSize];
+            prepareArgumentsForNativeCall(pContext, method->mParameters, argumentValues,
+               preparedArgumentValues, argumentsData);
+
+            void* thisPtr = instanceDataValue.mTypeUsage.isPointer()
+               ? CflatValueAs(&instanceDataValue, void*)
+               : instanceDataValue.mValueBuffer;
+            const bool mustReturnValue =
+               method->mReturnTypeUsage.mType && method->mReturnTypeUsage.mType != mTypeVoid;
+            invokeNativeCall(method->mNativeCall, thisPtr, argumentsData,
+               method->mReturnTypeUsage, mustReturnValue ? pOutValue : nullptr);
+         }
+         else
+         {
+            prepareArgumentsForFunctionCall(pContext, method->mParameters, argumentValues,
+               preparedArgumentValues);
+
+            Value thisPtr;
+
+            if(instanceDataValue.mTypeUsage.isPointer())
+            {
+               thisPtr.initOnStack(instanceDataValue.mTypeUsage, &pContext.mStack);
+               thisPtr.set(instanceDataValue.mValueBuffer);
+            }
+            else
+            {
+               thisPtr.mValueInitializationHint = ValueInitializationHint::Stack;
+               getAddressOfValue(pContext, instanceDataValue, &thisPtr);
+            }
+
+            method->execute(thisPtr, preparedArgumentValues, pOutValue);
+         }
+
+         if(profiler)
+         {
+            profiler->endCall();
+         }
+
+         while(!preparedArgumentValues.empty())
+         {
+            preparedArgumentValues.pop_back();
+         }
+
+         while(!argumentValues.empty())
+         {
+            argumentValues.pop_back();
+         }
+      }
+      break;
+   case ExpressionType::ArrayInitialization:
+      {
+         ExpressionArrayInitialization* expression =
+            static_cast<ExpressionArrayInitialization*>(pExpression);
+
+         TypeUsage arrayElementTypeUsage;
+         arrayElementTypeUsage.mType = expression->mElementType;
+
+         TypeUsage arrayTypeUsage;
+         arrayTypeUsage.mType = expression->mElementType;
+         CflatSetFlag(arrayTypeUsage.mFlags, TypeUsageFlags::Array);
+         arrayTypeUsage.mArraySize = (uint16_t)expression->mValues.size();
+
+         assertValueInitialization(pContext, arrayTypeUsage, pOutValue);
+
+         for(size_t i = 0u; i < expression->mValues.size(); i++)
+         {
+            Value arrayElementValue;
+            arrayElementValue.initOnStack(arrayElementTypeUsage, &pContext.mStack);
+            evaluateExpression(pContext, expression->mValues[i], &arrayElementValue);
+
+            const size_t arrayElementSize = expression->mElementType->mSize;
+            const size_t offset = i * arrayElementSize;
+            memcpy(pOutValue->mValueBuffer + offset, arrayElementValue.mValueBuffer, arrayElementSize);
+         }
+      }
+      break;
+   case ExpressionType::ObjectConstruction:
+      {
+         ExpressionObjectConstruction* expression =
+            static_cast<ExpressionObjectConstruction*>(pExpression);
+
+         Method* ctor = expression->mConstructor;
+         CflatAssert(ctor);
+
+         TypeUsage typeUsage;
+         typeUsage.mType = expression->mObjectType;
+         assertValueInitialization(pContext, typeUsage, pOutValue);
+
+         CflatArgsVector(Value) argumentValues;
+         getArgumentValues(pContext, expression->mArguments, argumentValues);
+
+         {
+            Value thisPtr;
+            thisPtr.mValueInitializationHint = ValueInitializationHint::Stack;
+            getAddressOfValue(pContext, *pOutValue, &thisPtr);
+
+            Profiler* profiler = pContext.mProfiler;
+
+            if(profiler)
+            {
+               profiler->beginMethodCall(ctor, expression->mObjectType);
+            }
+
+            ctor->execute(thisPtr, argumentValues, nullptr);
+
+            if(profiler)
+            {
+               profiler->endCall();
+            }
+         }
+
+         while(!argumentValues.empty())
+         {
+            argumentValues.pop_back();
+         }
+      }
+      break;
+   default:
+      break;
+   }
+}
+
+void Environment::getInstanceDataValue(ExecutionContext& pContext, Expression* pExpression,
+   Value* pOutValue)
+{
+   if(pExpression->getType() == ExpressionType::VariableAccess)
+   {
+      ExpressionVariableAccess* variableAccess =
+         static_cast<ExpressionVariableAccess*>(pExpression);
+      Instance* instance = retrieveInstance(pContext, variableAccess);
+      *pOutValue = instance->mValue;
+   }
+   else if(pExpression->getType() == ExpressionType::MemberAccess)
+   {
+      ExpressionMemberAccess* memberAccess =
+         static_cast<ExpressionMemberAccess*>(pExpression);
+
+      Member* member = nullptr;
+      char* instanceDataPtr = nullptr;
+
+      // owners which are instances get referenced in place, so only temporaries (e.g. returned
+      // objects) get evaluated into a value of their own
+      Value memberOwnerValue;
+      const ExpressionType memberOwnerExpressionType = memberAccess->mMemberOwner->getType();
+
+      if(memberOwnerExpressionType == ExpressionType::VariableAccess ||
+         memberOwnerExpressionType == ExpressionType::MemberAccess ||
+         memberOwnerExpressionType == ExpressionType::Indirection)
+      {
+         getInstanceDataValue(pContext, memberAccess->mMemberOwner, &memberOwnerValue);
+      }
+      else
+      {
+         evaluateExpression(pContext, memberAccess->mMemberOwner, &memberOwnerValue);
+      }
+
+      if(memberOwnerValue.mTypeUsage.isPointer() && !CflatValueAs(&memberOwnerValue, void*))
+      {
+         throwRuntimeError(pContext, RuntimeError::NullPointerAccess,
+            memberAccess->mMemberIdentifier.mName);
+      }
+
+      if(!pContext.mErrorMessage.empty())
+         return;
+
+      Struct* type = static_cast<Struct*>(memberOwnerValue.mTypeUsage.mType);
+
+      for(size_t j = 0u; j < type->mMembers.size(); j++)
+      {
+         if(type->mMembers[j].mIdentifier == memberAccess->mMemberIdentifier)
+         {
+            member = &type->mMembers[j];
+            instanceDataPtr = memberOwnerValue.mTypeUsage.isPointer()
+               ? CflatValueAs(&memberOwnerValue, char*)
+               : memberOwnerValue.mValueBuffer;
+            break;
+         }
+      }
+
+      if(member && instanceDataPtr)
+      {
+         if(pOutValue->mValueBufferType != ValueBufferType::Uninitialized)
+         {
+            pOutValue->reset();
+         }
+
+         // the owner is a temporary (e.g. a returned object) which gets released when leaving
+         // this scope, so the member gets copied instead of referenced
+         if(memberOwnerValue.mTypeUsage.isPointer() ||
+            memberOwnerValue.mValueBufferType == ValueBufferType::External)
+         {
+            pOutValue->initExternal(member->mTypeUsage);
+         }
+         else
+         {
+            pOutValue->initOnHeap(member->mTypeUsage);
+         }
+
+         pOutValue->set(instanceDataPtr + member->mOffset);
+      }
+   }
+   else if(pExpression->getType() == ExpressionType::ArrayElementAccess)
+   {
+      ExpressionArrayElementAccess* arrayElementAccess =
+         static_cast<ExpressionArrayElementAccess*>(pExpression);
+
+      Value arrayDataValue;
+      getInstanceDataValue(pContext, arrayElementAccess->mArray, &arrayDataValue);
+
+      Value arrayIndexValue;
+      arrayIndexValue.mValueInitializationHint = ValueInitializationHint::Stack;
+      evaluateExpression(pContext, arrayElementAccess->mArrayElementIndex, &arrayIndexValue);
+      const size_t arrayIndex = (size_t)getValueAsInteger(arrayIndexValue);
+
+      TypeUsage arrayElementTypeUsage;
+      arrayElementTypeUsage.mType = arrayDataValue.mTypeUsage.mType;
+
+      pOutValue->initExternal(arrayElementTypeUsage);
+      pOutValue->mValueBuffer =
+         arrayDataValue.mValueBuffer + (arrayIndex * arrayElementTypeUsage.getSize());
+   }
+   else if(pExpression->getType() == ExpressionType::Indirection)
+   {
+      ExpressionIndirection* indirection = static_cast<ExpressionIndirection*>(pExpression);
+
+      Value value;
+      value.mValueInitializationHint = ValueInitializationHint::Stack;
+      evaluateExpression(pContext, indirection->mExpression, &value);
+      CflatAssert(value.mTypeUsage.isPointer());
+
+      TypeUsage typeUsage = value.mTypeUsage;
+      typeUsage.mPointerLevel--;
+
+      const void* ptr = CflatValueAs(&value, void*);
+      pOutValue->initExternal(typeUsage);
+      pOutValue->set(ptr);
+   }
+   else
+   {
+      Value expressionValue;
+      expressionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+      evaluateExpression(pContext, pExpression, &expressionValue);
+
+      assertValueInitialization(pContext, expressionValue.mTypeUsage, pOutValue);
+      *pOutValue = expressionValue;
+   }
+}
+
+void Environment::getAddressOfValue(ExecutionContext& pContext, const Value& pInstanceDataValue,
+   Value* pOutValue)
+{
+   TypeUsage pointerTypeUsage = pInstanceDataValue.mTypeUsage;
+   pointerTypeUsage.mPointerLevel++;
+
+   assertValueInitialization(pContext, pointerTypeUsage, pOutValue);
+   pOutValue->set(&pInstanceDataValue.mValueBuffer);
+}
+
+void Environment::getArgumentValues(ExecutionContext& pContext,
+   const CflatSTLVector(Expression*)& pExpressions, CflatArgsVector(Value)& pValues)
+{
+   pValues.resize(pExpressions.size());
+
+   for(size_t i = 0u; i < pExpressions.size(); i++)
+   {
+      pValues[i].mValueInitializationHint = ValueInitializationHint::Stack;
+      evaluateExpression(pContext, pExpressions[i], &pValues[i]);
+   }
+}
+
+void Environment::prepareArgumentsForFunctionCall(ExecutionContext& pContext,
+   const CflatSTLVector(TypeUsage)& pParameters, const CflatArgsVector(Value)& pOriginalValues,
+   CflatArgsVector(Value)& pPreparedValues)
+{
+   CflatAssert(pParameters.size() == pOriginalValues.size());
+   pPreparedValues.resize(pParameters.size());
+
+   for(size_t i = 0u; i < pParameters.size(); i++)
+   {
+      // pass by reference
+      if(pParameters[i].isReference())
+      {
+         pPreparedValues[i] = pOriginalValues[i];
+         CflatSetFlag(pPreparedValues[i].mTypeUsage.mFlags, TypeUsageFlags::Reference);
+      }
+      // pass by value
+      else
+      {
+         pPreparedValues[i].initOnStack(pParameters[i], &pContext.mStack);
+         assignValue(pContext, pOriginalValues[i], &pPreparedValues[i], false);
+      }
+   }
+}
+
+void Environment::prepareArgumentsForNativeCall(ExecutionContext& pContext,
+   const CflatSTLVector(TypeUsage)& pParameters, const CflatArgsVector(Value)& pOriginalValues,
+   CflatArgsVector(Value)& pConvertedValues, const void** pOutArgumentsData)
+{
+   CflatAssert(pParameters.size() == pOriginalValues.size());
+   pConvertedValues.resize(pParameters.size());
+
+   for(size_t i = 0u; i < pParameters.size(); i++)
+   {
+      // the native call copies arguments passed by value by itself, so only the arguments which
+      // do not match the parameter type need to be converted first
+      if(pParameters[i].isReference() ||
+         TypeHelper::getCompatibility(pParameters[i], pOriginalValues[i].mTypeUsage) ==
+            TypeHelper::Compatibility::PerfectMatch)
+      {
+         pOutArgumentsData[i] = pOriginalValues[i].mValueBuffer;
+      }
+      else
+      {
+         pConvertedValues[i].initOnStack(pParameters[i], &pContext.mStack);
+         assignValue(pContext, pOriginalValues[i], &pConvertedValues[i], false);
+         pOutArgumentsData[i] = pConvertedValues[i].mValueBuffer;
+      }
+   }
+}
+
+void Environment::applyUnaryOperator(ExecutionContext& pContext, const Value& pOperand,
+   OperatorType pOperator, Value* pOutValue)
+{
+   Type* type = pOperand.mTypeUsage.mType;
+
+   // int (most common case, handled without going through 64-bit conversions)
+   if(type == mTypeInt32 && !pOperand.mTypeUsage.isPointer() &&
+      pOutValue->mTypeUsage.mType == mTypeInt32 && !pOutValue->mTypeUsage.isPointer())
+   {
+      const int32_t value = CflatValueAs(&pOperand, int32_t);
+      bool applied = true;
+      int32_t result = 0;
+
+      switch(pOperator)
+      {
+      case OperatorType::Increment:
+         result = (int32_t)((uint32_t)value + 1u);
+         break;
+      case OperatorType::Decrement:
+         result = (int32_t)((uint32_t)value - 1u);
+         break;
+      case OperatorType::Negate:
+         result = (int32_t)(0u - (uint32_t)value);
+         break;
+      case OperatorType::BitwiseNot:
+         result = ~value;
+         break;
+      default:
+         applied = false;
+         break;
+      }
+
+      if(applied)
+      {
+         pOutValue->assign(&result);
+         return;
+      }
+   }
+
+   // integer built-in / pointer
+   if(type->isInteger() || pOperand.mTypeUsage.isPointer())
+   {
+      if(pOperator == OperatorType::Dereference)
+      {
+         CflatAssert(pOperand.mTypeUsage.isPointer());
+         CflatAssert(pOperand.mTypeUsage.mType == pOutValue->mTypeUsage.mType);
+         CflatAssert(pOperand.mTypeUsage.mPointerLevel == (pOutValue->mTypeUsage.mPointerLevel + 1u));
+
+         const void* ptr = CflatValueAs(&pOperand, void*);
+         pOutValue->set(ptr);
+      }
+      else
+      {
+         const int64_t valueAsInteger = getValueAsInteger(pOperand);
+
+         if(pOperator == OperatorType::LogicalNot)
+         {
+            setValueAsInteger(!valueAsInteger, pOutValue);
+         }
+         else if(pOperator == OperatorType::Increment)
+         {
+            const int64_t increment = pOutValue->mTypeUsage.isPointer()
+               ? (int64_t)pOutValue->mTypeUsage.mType->mSize
+               : 1;
+            setValueAsInteger(valueAsInteger + increment, pOutValue);
+         }
+         else if(pOperator == OperatorType::Decrement)
+         {
+            const int64_t decrement = pOutValue->mTypeUsage.isPointer()
+               ? (int64_t)pOutValue->mTypeUsage.mType->mSize
+               : 1;
+            setValueAsInteger(valueAsInteger - decrement, pOutValue);
+         }
+         else if(pOperator == OperatorType::Negate)
+         {
+            setValueAsInteger(-valueAsInteger, pOutValue);
+         }
+         else if(pOperator == OperatorType::BitwiseNot)
+         {
+            setValueAsInteger(~valueAsInteger, pOutValue);
+         }
+      }
+   }
+   // decimal built-in
+   else if(type->mCategory == TypeCategory::BuiltIn)
+   {
+      if(pOperator == OperatorType::Negate)
+      {
+         const double valueAsDecimal = getValueAsDecimal(pOperand);
+         setValueAsDecimal(-valueAsDecimal, pOutValue);
+      }
+   }
+   // struct or class
+   else
+   {
+      pContext.mStringBuffer.assign("operator");
+      pContext.mStringBuffer.append(getOperatorString(pOperator));
+
+      CflatArgsVector(Value) args;
+
+      const Identifier operatorIdentifier(pContext.mStringBuffer.c_str());
+      Method* operatorMethod = findMethod(type, operatorIdentifier);
+      
+      if(operatorMethod)
+      {
+         Value thisPtrValue;
+         thisPtrValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         getAddressOfValue(pContext, pOperand, &thisPtrValue);
+
+         operatorMethod->execute(thisPtrValue, args, pOutValue);
+      }
+      else
+      {
+         args.push_back(pOperand);
+
+         Function* operatorFunction = type->mNamespace->getFunction(operatorIdentifier, args);
+
+         if(!operatorFunction)
+         {
+            operatorFunction = findFunction(pContext, operatorIdentifier, args);
+         }
+
+         CflatAssert(operatorFunction);
+         operatorFunction->execute(args, pOutValue);
+      }
+   }
+}
+
+void Environment::applyBinaryOperator(ExecutionContext& pContext, const Value& pLeft, const Value& pRight,
+   OperatorType pOperator, Value* pOutValue)
+{
+  if(!pContext.mErrorMessage.empty())
+     return;
+
+   Type* leftType = pLeft.mTypeUsage.mType;
+   Type* rightType = pRight.mTypeUsage.mType;
+
+   const bool leftIsNumericValue =
+      leftType->mCategory == TypeCategory::BuiltIn ||
+      leftType->mCategory == TypeCategory::Enum ||
+      pLeft.mTypeUsage.isPointer();
+   const bool rightIsNumericValue =
+      rightType->mCategory == TypeCategory::BuiltIn ||
+      rightType->mCategory == TypeCategory::Enum ||
+      pRight.mTypeUsage.isPointer();
+
+   if(leftIsNumericValue && rightIsNumericValue)
+   {
+      const bool integerLeftValue = leftType->isInteger() || pLeft.mTypeUsage.isPointer();
+      const bool integerRightValue = rightType->isInteger() || pRight.mTypeUsage.isPointer();
+      const bool integerValues = integerLeftValue && integerRightValue;
+
+      int64_t leftValueAsInteger = getValueAsInteger(pLeft);
+      int64_t rightValueAsInteger = getValueAsInteger(pRight);
+      double leftValueAsDecimal = 0.0;
+      double rightValueAsDecimal = 0.0;
+
+      if(integerLeftValue)
+      { 
+         if(!integerRightValue)
+         {
+            leftValueAsDecimal = (double)leftValueAsInteger;
+         }
+      }
+      else
+      {
+         leftValueAsDecimal = getValueAsDecimal(pLeft);
+      }
+
+      if(integerRightValue)
+      {
+         if(!integerLeftValue)
+         {
+            rightValueAsDecimal = (double)rightValueAsInteger;
+         }
+      }
+      else
+      {
+         rightValueAsDecimal = getValueAsDecimal(pRight);
+      }
+
+      if(pOperator == OperatorType::Equal)
+      {
+         const bool result = integerValues
+            ? leftValueAsInteger == rightValueAsInteger
+            : leftValueAsDecimal == rightValueAsDecimal;
+         pOutValue->assign(&result);
+      }
+      else if(pOperator == OperatorType::NotEqual)
+      {
+         const bool result = integerValues
+            ? leftValueAsInteger != rightValueAsInteger
+            : leftValueAsDecimal != rightValueAsDecimal;
+         pOutValue->assign(&result);
+      }
+      else if(pOperator == OperatorType::Less)
+      {
+         const bool result = integerValues
+            ? leftValueAsInteger < rightValueAsInteger
+            : leftValueAsDecimal < rightValueAsDecimal;
+         pOutValue->assign(&result);
+      }
+      else if(pOperator == OperatorType::Greater)
+      {
+         const bool result = integerValues
+            ? leftValueAsInteger > rightValueAsInteger
+            : leftValueAsDecimal > rightValueAsDecimal;
+         pOutValue->assign(&result);
+      }
+      else if(pOperator == OperatorType::LessOrEqual)
+      {
+         const bool result = integerValues
+            ? leftValueAsInteger <= rightValueAsInteger
+            : leftValueAsDecimal <= rightValueAsDecimal;
+         pOutValue->assign(&result);
+      }
+      else if(pOperator == OperatorType::GreaterOrEqual)
+      {
+         const bool result = integerValues
+            ? leftValueAsInteger >= rightValueAsInteger
+            : leftValueAsDecimal >= rightValueAsDecimal;
+         pOutValue->assign(&result);
+      }
+      else if(pOperator == OperatorType::LogicalAnd)
+      {
+         const bool result = leftValueAsInteger && rightValueAsInteger;
+         pOutValue->assign(&result);
+      }
+      else if(pOperator == OperatorType::LogicalOr)
+      {
+         const bool result = leftValueAsInteger || rightValueAsInteger;
+         pOutValue->assign(&result);
+      }
+      else if(pOperator == OperatorType::Add)
+      {
+         if(integerValues)
+         {
+            if(pLeft.mTypeUsage.isPointer())
+            {
+               rightValueAsInteger *= (int64_t)pLeft.mTypeUsage.mType->mSize;
+            }
+
+            setValueAsInteger(leftValueAsInteger + rightValueAsInteger, pOutValue);
+         }
+         else
+         {
+            setValueAsDecimal(leftValueAsDecimal + rightValueAsDecimal, pOutValue);
+         }
+      }
+      else if(pOperator == OperatorType::Subtract)
+      {
+         if(integerValues)
+         {
+            if(pLeft.mTypeUsage.isPointer())
+            {
+               rightValueAsInteger *= (int64_t)pLeft.mTypeUsage.mType->mSize;
+            }
+
+            setValueAsInteger(leftValueAsInteger - rightValueAsInteger, pOutValue);
+         }
+         else
+         {
+            setValueAsDecimal(leftValueAsDecimal - rightValueAsDecimal, pOutValue);
+         }
+      }
+      else if(pOperator == OperatorType::Multiply)
+      {
+         if(integerValues)
+         {
+            setValueAsInteger(leftValueAsInteger * rightValueAsInteger, pOutValue);
+         }
+         else
+         {
+            setValueAsDecimal(leftValueAsDecimal * rightValueAsDecimal, pOutValue);
+         }
+      }
+      else if(pOperator == OperatorType::Divide)
+      {
+         if(integerValues)
+         {
+            if(rightValueAsInteger != 0)
+            {
+               setValueAsInteger(leftValueAsInteger / rightValueAsInteger, pOutValue);
+            }
+            else
+            {
+               throwRuntimeError(pContext, RuntimeError::DivisionByZero);
+            }
+         }
+         else
+         {
+            if(fabs(rightValueAsDecimal) > 0.000000001)
+            {
+               setValueAsDecimal(leftValueAsDecimal / rightValueAsDecimal, pOutValue);
+            }
+            else
+            {
+               throwRuntimeError(pContext, RuntimeError::DivisionByZero);
+            }
+         }
+      }
+      else if(pOperator == OperatorType::Modulo)
+      {
+         setValueAsInteger(leftValueAsInteger % rightValueAsInteger, pOutValue);
+      }
+      else if(pOperator == OperatorType::BitwiseAnd)
+      {
+         setValueAsInteger(leftValueAsInteger & rightValueAsInteger, pOutValue);
+      }
+      else if(pOperator == OperatorType::BitwiseOr)
+      {
+         setValueAsInteger(leftValueAsInteger | rightValueAsInteger, pOutValue);
+      }
+      else if(pOperator == OperatorType::BitwiseXor)
+      {
+         setValueAsInteger(leftValueAsInteger ^ rightValueAsInteger, pOutValue);
+      }
+      else if(pOperator == OperatorType::ShiftLeft)
+      {
+         setValueAsInteger(leftValueAsInteger << rightValueAsInteger, pOutValue);
+      }
+      else if(pOperator == OperatorType::ShiftRight)
+      {
+         setValueAsInteger(leftValueAsInteger >> rightValueAsInteger, pOutValue);
+      }
+   }
+   else
+   {
+      pContext.mStringBuffer.assign("operator");
+      pContext.mStringBuffer.append(getOperatorString(pOperator));
+
+      CflatArgsVector(Value) args;
+      args.push_back(pRight);
+
+      const Identifier operatorIdentifier(pContext.mStringBuffer.c_str());
+      Method* operatorMethod = findMethod(leftType, operatorIdentifier, args);
+      Function* operatorFunction = nullptr;
+
+      if(!operatorMethod)
+      {
+         args.insert(args.begin(), pLeft);
+
+         operatorFunction = leftType->mNamespace->getFunction(operatorIdentifier, args);
+
+         if(!operatorFunction)
+         {
+            operatorFunction = findFunction(pContext, operatorIdentifier, args);
+         }
+      }
+
+      applyOverloadedBinaryOperator(pContext, pLeft, pRight, operatorMethod, operatorFunction,
+         pOutValue);
+   }
+}
+
+void Environment::applyOverloadedBinaryOperator(ExecutionContext& pContext, const Value& pLeft,
+   const Value& pRight, Method* pOperatorMethod, Function* pOperatorFunction, Value* pOutValue)
+{
+   CflatArgsVector(Value) args;
+
+   if(pOperatorMethod)
+   {
+      args.push_back(pRight);
+
+      Value thisPtrValue;
+      thisPtrValue.mValueInitializationHint = ValueInitializationHint::Stack;
+      getAddressOfValue(pContext, pLeft, &thisPtrValue);
+
+      pOperatorMethod->execute(thisPtrValue, args, pOutValue);
+   }
+   else
+   {
+      args.push_back(pLeft);
+      args.push_back(pRight);
+
+      CflatAssert(pOperatorFunction);
+      pOperatorFunction->execute(args, pOutValue);
+   }
+}
+
+void Environment::performAssignment(ExecutionContext& pContext, const Value& pValue,
+   OperatorType pOperator, OperationKernel pKernel, Value* pInstanceDataValue)
+{
+   if(pOperator == OperatorType::Assign)
+   {
+      assignValue(pContext, pValue, pInstanceDataValue, false);
+   }
+   else
+   {
+      const OperatorType binaryOperator = getCompoundAssignmentOperator(pOperator);
+
+      const bool appliedByKernel = pKernel != OperationKernel::Generic &&
+         applyOperationKernel(pKernel, binaryOperator, *pInstanceDataValue, pValue, pInstanceDataValue);
+
+      if(!appliedByKernel)
+      {
+         applyBinaryOperator(pContext, *pInstanceDataValue, pValue, binaryOperator, pInstanceDataValue);
+      }
+   }
+}
+
+void Environment::performStaticCast(ExecutionContext& pContext, const Value& pValueToCast,
+   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+{
+   const TypeUsage& sourceTypeUsage = pValueToCast.mTypeUsage;
+
+   if(sourceTypeUsage.mType->mCategory == TypeCategory::BuiltIn &&
+      pTargetTypeUsage.mType->mCategory == TypeCategory::BuiltIn)
+   {
+      if(sourceTypeUsage.mType->isInteger())
+      {
+         const int64_t sourceValueAsInteger = getValueAsInteger(pValueToCast);
+
+         if(pTargetTypeUsage.mType->isInteger())
+         {
+            setValueAsInteger(sourceValueAsInteger, pOutValue);
+         }
+         else
+         {
+            setValueAsDecimal((double)sourceValueAsInteger, pOutValue);
+         }
+      }
+      else
+      {
+         const double sourceValueAsDecimal = getValueAsDecimal(pValueToCast);
+
+         if(pTargetTypeUsage.mType->isInteger())
+         {
+            setValueAsInteger((int64_t)sourceValueAsDecimal, pOutValue);
+         }
+         else
+         {
+            setValueAsDecimal(sourceValueAsDecimal, pOutValue);
+         }
+      }
+   }
+   else if(sourceTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
+      pTargetTypeUsage.mType->mCategory == TypeCategory::StructOrClass)
+   {
+      performInheritanceCast(pContext, pValueToCast, pTargetTypeUsage, pOutValue);
+   }
+}
+
+void Environment::performIntegerCast(ExecutionContext& pContext, const Value& pValueToCast,
+   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+{
+   setValueAsInteger(getValueAsInteger(pValueToCast), pOutValue);
+}
+
+void Environment::performIntegerFloatCast(ExecutionContext& pContext, const Value& pValueToCast,
+   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+{
+   Type* sourceType = pValueToCast.mTypeUsage.mType;
+   Type* targetType = pTargetTypeUsage.mType;
+
+   CflatAssert(sourceType->mCategory == TypeCategory::BuiltIn);
+   CflatAssert(targetType->mCategory == TypeCategory::BuiltIn);
+
+   if(sourceType->isInteger() && targetType->isDecimal())
+   {
+      const int64_t integerValue = getValueAsInteger(pValueToCast);
+      setValueAsDecimal((double)integerValue, pOutValue);
+   }
+   else if(sourceType->isDecimal() && targetType->isInteger())
+   {
+      const double decimalValue = getValueAsDecimal(pValueToCast);
+      setValueAsInteger((int64_t)decimalValue, pOutValue);
+   }
+}
+
+void Environment::performFloatCast(ExecutionContext& pContext, const Value& pValueToCast,
+   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+{
+   Type* sourceType = pValueToCast.mTypeUsage.mType;
+   Type* targetType = pTargetTypeUsage.mType;
+
+   CflatAssert(sourceType->mCategory == TypeCategory::BuiltIn);
+   CflatAssert(targetType->mCategory == TypeCategory::BuiltIn);
+
+   const double decimalValue = getValueAsDecimal(pValueToCast);
+   setValueAsDecimal(decimalValue, pOutValue);
+}
+
+void Environment::performInheritanceCast(ExecutionContext& pContext, const Value& pValueToCast,
+   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+{
+   CflatAssert(pValueToCast.mTypeUsage.mType->mCategory == TypeCategory::StructOrClass);
+   CflatAssert(pTargetTypeUsage.mType->mCategory == TypeCategory::StructOrClass);
+
+   Struct* sourceType = static_cast<Struct*>(pValueToCast.mTypeUsage.mType);
+   Struct* targetType = static_cast<Struct*>(pTargetTypeUsage.mType);
+
+   char* ptr = nullptr;
+
+   if(sourceType == targetType)
+   {
+      ptr = CflatValueAs(&pValueToCast, char*);
+   }
+   else if(sourceType->derivedFrom(targetType))
+   {
+      ptr = CflatValueAs(&pValueToCast, char*) + sourceType->getOffset(targetType);
+   }
+   else if(targetType->derivedFrom(sourceType))
+   {
+      ptr = CflatValueAs(&pValueToCast, char*) - targetType->getOffset(sourceType);
+   }
+
+   pOutValue->set(&ptr);
+}
+
+void Environment::assignValue(ExecutionContext& pContext, const Value& pSource, Value* pTarget,
+   bool pDeclaration)
+{
+   const TypeUsage typeUsage = pTarget->mTypeUsage;
+   const TypeHelper::Compatibility compatibility =
+      TypeHelper::getCompatibility(typeUsage, pSource.mTypeUsage);
+
+   if(compatibility == TypeHelper::Compatibility::ImplicitCastableInteger)
+   {
+      performIntegerCast(pContext, pSource, typeUsage, pTarget);
+   }
+   else if(compatibility == TypeHelper::Compatibility::ImplicitCastableIntegerFloat)
+   {
+      performIntegerFloatCast(pContext, pSource, typeUsage, pTarget);
+   }
+   else if(compatibility == TypeHelper::Compatibility::ImplicitCastableFloat)
+   {
+      performFloatCast(pContext, pSource, typeUsage, pTarget);
+   }
+   else if(compatibility == TypeHelper::Compatibility::ImplicitCastableInheritance)
+   {
+      performInheritanceCast(pContext, pSource, typeUsage, pTarget);
+   }
+   else
+   {
+      bool valueAssigned = false;
+
+      if(!pTarget->mTypeUsage.isPointer() &&
+         pTarget->mTypeUsage.mType->mCategory == TypeCategory::StructOrClass)
+      {
+         Struct* type = static_cast<Struct*>(pTarget->mTypeUsage.mType);
+
+         CflatArgsVector(Value) args;
+         args.push_back(pSource);
+
+         // assignments between instances of the same type use the cached copy assignment operator
+         Method* operatorMethod = nullptr;
+
+         if(pSource.mTypeUsage.mType == type && !pSource.mTypeUsage.isPointer())
+         {
+            operatorMethod = type->getCopyAssignmentOperator();
+         }
+         else
+         {
+            const Identifier operatorIdentifier("operator=");
+            operatorMethod = findMethod(type, operatorIdentifier, args);
+         }
+
+         if(operatorMethod && operatorMethod->mReturnTypeUsage.mType == type)
+         {
+            Value thisPtrValue;
+            thisPtrValue.mValueInitializationHint = ValueInitializationHint::Stack;
+            getAddressOfValue(pContext, *pTarget, &thisPtrValue);
+
+            operatorMethod->execute(thisPtrValue, args, pTarget);
+
+            valueAssigned = true;
+         }
+      }
+
+      if(!valueAssigned)
+      {
+         if(pDeclaration)
+         {
+            *pTarget = pSource;
+         }
+         else
+         {
+            pTarget->assign(pSource.mValueBuffer);
+         }
+      }
+   }
+}
+
+void Environment::execute(ExecutionContext& pContext, const Program& pProgram)
+{
+   pContext.mJumpStatement = JumpStatement::None;
+
+   pContext.mCallStack.emplace_back(&pProgram);
+
+   for(size_t i = 0u; i < pProgram.mStatements.size(); i++)
+   {
+      execute(pContext, pProgram.mStatements[i]);
+
+      if(!pContext.mErrorMessage.empty())
+      {
+         break;
+      }
+   }
+
+   pContext.mCallStack.pop_back();
+
+   if(mExecutionHook)
+   {
+      mExecutionHook(this, pContext.mCallStack);
+   }
+
+   if(pContext.mProfiler)
+   {
+      pContext.mProfiler->endLine();
+   }
+
+   pContext.mUsingDirectives.clear();
+}
+
+void Environment::assertValueInitialization(ExecutionContext& pContext, const TypeUsage& pTypeUsage,
+   Value* pOutValue)
+{
+   if(pOutValue->mValueBufferType == ValueBufferType::Uninitialized)
+   {
+      if(pTypeUsage.isReference())
+      {
+         pOutValue->initExternal(pTypeUsage);
+      }
+      else if(pOutValue->mValueInitializationHint == ValueInitializationHint::Stack)
+      {
+         pOutValue->initOnStack(pTypeUsage, &pContext.mStack);
+      }
+      else
+      {
+         pOutValue->initOnHeap(pTypeUsage);
+      }
+   }
+}
+
+int64_t Environment::getValueAsInteger(const Value& pValue)
+{
+   const bool signedType =
+      !pValue.mTypeUsage.isPointer() &&
+      pValue.mTypeUsage.mType->mCategory == TypeCategory::BuiltIn &&
+      pValue.mTypeUsage.mType->mIdentifier.mName[0] == 'i';
+
+   const size_t typeUsageSize = pValue.mTypeUsage.getSize();
+   int64_t valueAsInteger = 0;
+
+   if(typeUsageSize == sizeof(int32_t))
+   {
+      valueAsInteger = signedType
+         ? (int64_t)CflatValueAs(&pValue, int32_t)
+         : (int64_t)CflatValueAs(&pValue, uint32_t);
+   }
+   else if(typeUsageSize == sizeof(int64_t))
+   {
+      valueAsInteger = CflatValueAs(&pValue, int64_t);
+   }
+   else if(typeUsageSize == sizeof(int16_t))
+   {
+      valueAsInteger = signedType
+         ? (int64_t)CflatValueAs(&pValue, int16_t)
+         : (int64_t)CflatValueAs(&pValue, uint16_t);
+   }
+   else if(typeUsageSize == sizeof(int8_t))
+   {
+      valueAsInteger = signedType
+         ? (int64_t)CflatValueAs(&pValue, int8_t)
+         : (int64_t)CflatValueAs(&pValue, uint8_t);
+   }
+   else
+   {
+      CflatAssert(false); // Unsupported
+   }
+
+   return valueAsInteger;
+}
+
+double Environment::getValueAsDecimal(const Value& pValue)
+{
+   const size_t typeUsageSize = pValue.mTypeUsage.getSize();
+   double valueAsDecimal = 0.0;
+
+   if(typeUsageSize == sizeof(float))
+   {
+      valueAsDecimal = (double)CflatValueAs(&pValue, float);
+   }
+   else if(typeUsageSize == sizeof(double))
+   {
+      valueAsDecimal = CflatValueAs(&pValue, double);
+   }
+   else
+   {
+      CflatAssert(false); // Unsupported
+   }
+
+   return valueAsDecimal;
+}
+
+void Environment::setValueAsInteger(int64_t pInteger, Value* pOutValue)
+{
+   const size_t typeUsageSize = pOutValue->mTypeUsage.getSize();
+
+   if(typeUsageSize == sizeof(int32_t))
+   {
+      const int32_t value = (int32_t)pInteger;
+      pOutValue->assign(&value);
+   }
+   else if(typeUsageSize == sizeof(int64_t))
+   {
+      pOutValue->assign(&pInteger);
+   }
+   else if(typeUsageSize == sizeof(int16_t))
+   {
+      const int16_t value = (int16_t)pInteger;
+      pOutValue->assign(&value);
+   }
+   else if(typeUsageSize == sizeof(int8_t))
+   {
+      const int8_t value = (int8_t)pInteger;
+      pOutValue->assign(&value);
+   }
+   else
+   {
+      CflatAssert(false); // Unsupported
+   }
+}
+
+void Environment::setValueAsDecimal(double pDecimal, Value* pOutValue)
+{
+   const size_t typeUsageSize = pOutValue->mTypeUsage.getSize();
+
+   if(typeUsageSize == sizeof(float))
+   {
+      const float value = (float)pDecimal;
+      pOutValue->assign(&value);
+   }
+   else if(typeUsageSize == sizeof(double))
+   {
+      pOutValue->assign(&pDecimal);
+   }
+   else
+   {
+      CflatAssert(false); // Unsupported
+   }
+}
+
+void Environment::getTypeFullName(Type* pType, CflatSTLString* pOutString)
+{
+   if(pType->mNamespace->getFullIdentifier().mHash != 0u)
+   {
+      pOutString->append(pType->mNamespace->getFullIdentifier().mName);
+      pOutString->append("::");
+   }
+
+   pOutString->append(pType->mIdentifier.mName);
+
+   if(pType->mCategory == TypeCategory::StructOrClass)
+   {
+      Struct* structOrClassType = static_cast<Struct*>(pType);
+      
+      if(!structOrClassType->mTemplateTypes.empty())
+      {
+         pOutString->append("<");
+
+         for(size_t i = 0u; i < structOrClassType->mTemplateTypes.size(); i++)
+         {
+            if(i > 0u)
+            {
+               pOutString->append(", ");
+            }
+
+            getTypeFullName(structOrClassType->mTemplateTypes[i].mType, pOutString);
+         }
+
+         pOutString->append(">");
+      }
+   }
+}
+
+Method* Environment::getDefaultConstructor(Type* pType)
+{
+   CflatAssert(pType->mCategory == TypeCategory::StructOrClass);
+   return static_cast<Struct*>(pType)->getDefaultConstructor();
+}
+
+Method* Environment::getDestructor(Type* pType)
+{
+   CflatAssert(pType->mCategory == TypeCategory::StructOrClass);
+   return static_cast<Struct*>(pType)->getDestructor();
+}
+
+Method* Environment::findConstructor(Type* pType, const CflatArgsVector(TypeUsage)& pParameterTypes)
+{
+   const Identifier emptyId;
+   return findMethod(pType, emptyId, pParameterTypes);
+}
+
+Method* Environment::findConstructor(Type* pType, const CflatArgsVector(Value)& pArguments)
+{
+   const Identifier emptyId;
+   return findMethod(pType, emptyId, pArguments);
+}
+
+Method* Environment::findMethod(Type* pType, const Identifier& pIdentifier)
+{
+   CflatAssert(pType->mCategory == TypeCategory::StructOrClass);
+
+   Method* method = nullptr;
+   Struct* type = static_cast<Struct*>(pType);
+
+   for(size_t i = 0u; i < type->mMethods.size(); i++)
+   {
+      if(type->mMethods[i].mIdentifier == pIdentifier)
+      {
+         method = &type->mMethods[i];
+         break;
+      }
+   }
+
+   return method;
+}
+
+Method* Environment::findMethod(Type* pType, const Identifier& pIdentifier,
+   const CflatArgsVector(TypeUsage)& pParameterTypes, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   CflatAssert(pType->mCategory == TypeCategory::StructOrClass);
+
+   Method* method = nullptr;
+   Struct* type = static_cast<Struct*>(pType);
+
+   // first pass: look for a perfect argument match
+   for(size_t i = 0u; i < type->mMethods.size(); i++)
+   {
+      if(type->mMethods[i].mIdentifier == pIdentifier &&         
+         type->mMethods[i].mParameters.size() == pParameterTypes.size() &&
+         type->mMethods[i].mTemplateTypes == pTemplateTypes)
+      {
+         bool parametersMatch = true;
+
+         for(size_t j = 0u; j < pParameterTypes.size(); j++)
+         {
+            const TypeHelper::Compatibility compatibility =
+               TypeHelper::getCompatibility(type->mMethods[i].mParameters[j], pParameterTypes[j]);
+
+            if(compatibility != TypeHelper::Compatibility::PerfectMatch)
+            {
+               parametersMatch = false;
+               break;
+            }
+         }
+
+         if(parametersMatch)
+         {
+            method = &type->mMethods[i];
+            break;
+         }
+      }
+   }
+
+   // second pass: look for a compatible argument match
+   if(!method)
+   {
+      for(size_t i = 0u; i < type->mMethods.size(); i++)
+      {
+         if(type->mMethods[i].mIdentifier == pIdentifier &&
+            type->mMethods[i].mParameters.size() == pParameterTypes.size() &&
+            type->mMethods[i].mTemplateTypes == pTemplateTypes)
+         {
+            bool parametersMatch = true;
+
+            for(size_t j = 0u; j < pParameterTypes.size(); j++)
+            {
+               const TypeHelper::Compatibility compatibility =
+                  TypeHelper::getCompatibility(type->mMethods[i].mParameters[j], pParameterTypes[j]);
+
+               if(compatibility == TypeHelper::Compatibility::Incompatible)
+               {
+                  parametersMatch = false;
+                  break;
+               }
+            }
+
+            if(parametersMatch)
+            {
+               method = &type->mMethods[i];
+               break;
+            }
+         }
+      }
+   }
+
+   return method;
+}
+
+Method* Environment::findMethod(Type* pType, const Identifier& pIdentifier,
+   const CflatArgsVector(Value)& pArguments, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+{
+   CflatArgsVector(TypeUsage) typeUsages;
+
+   for(size_t i = 0u; i < pArguments.size(); i++)
+   {
+      typeUsages.push_back(pArguments[i].mTypeUsage);
+   }
+
+   return findMethod(pType, pIdentifier, typeUsages);
+}
+
+void Environment::initArgumentsForFunctionCall(Function* pFunction, CflatArgsVector(Value)& pArgs)
+{
+   pArgs.resize(pFunction->mParameters.size());
+
+   for(size_t i = 0u; i < pFunction->mParameters.size(); i++)
+   {
+      const TypeUsage& typeUsage = pFunction->mParameters[i];
+
+      if(typeUsage.isReference())
+      {
+         pArgs[i].initExternal(typeUsage);
+      }
+      else
+      {
+         pArgs[i].initOnStack(typeUsage, &getCurrentExecutionContext().mStack);
+      }
+   }
+}
+
+void Environment::execute(ExecutionContext& pContext, Statement* pStatement)
+{
+   if(pContext.mStack.mOverflown)
+   {
+      throwStackOverflowError(pContext);
+   }
+
+   if(!pContext.mErrorMessage.empty())
+      return;
+
+   pContext.mProgram = pStatement->mProgram;
+
+   pContext.mCallStack.back().mProgram = pStatement->mProgram;
+   pContext.mCallStack.back().mLine = pStatement->mLine;
+
+   if(mStatementHooksEnabled || pContext.mProfiler)
+   {
+      executeStatementHooks(pContext, pStatement);
+   }
+
+   switch(pStatement->getType())
+   {
+   case StatementType::Expression:
+      {
+         StatementExpression* statement = static_cast<StatementExpression*>(pStatement);
+
+         Value unusedValue;
+         unusedValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, statement->mExpression, &unusedValue);
+      }
+      break;
+   case StatementType::Block:
+      {
+         StatementBlock* statement = static_cast<StatementBlock*>(pStatement);
+
+         incrementBlockLevel(pContext);
+
+         if(statement->mAlterScope)
+         {
+            incrementScopeLevel(pContext);
+         }
+
+         for(size_t i = 0u; i < statement->mStatements.size(); i++)
+         {
+            execute(pContext, statement->mStatements[i]);
+
+            if(pContext.mJumpStatement != JumpStatement::None)
+            {
+               break;
+            }
+         }
+
+         if(statement->mAlterScope)
+         {
+            decrementScopeLevel(pContext);
+         }
+
+         decrementBlockLevel(pContext);
+      }
+      break;
+   case StatementType::UsingDirective:
+      {
+         StatementUsingDirective* statement =
+            static_cast<StatementUsingDirective*>(pStatement);
+
+         if(statement->mNamespace)
+         {
+            UsingDirective usingDirective(statement->mNamespace);
+            usingDirective.mBlockLevel = pContext.mBlockLevel;
+            pContext.mUsingDirectives.push_back(usingDirective);
+         }
+         else
+         {
+            registerTypeAlias(pContext, statement->mAliasIdentifier, statement->mAliasTypeUsage);
+         }
+      }
+      break;
+   case StatementType::TypeDefinition:
+      {
+         StatementTypeDefinition* statement =
+            static_cast<StatementTypeDefinition*>(pStatement);
+
+         TypeAlias typeAlias(statement->mAlias, statement->mReferencedTypeUsage);
+         typeAlias.mScopeLevel = pContext.mScopeLevel;
+         pContext.mTypeAliases.push_back(typeAlias);
+      }
+      break;
+   case StatementType::NamespaceDeclaration:
+      {
+         StatementNamespaceDeclaration* statement =
+            static_cast<StatementNamespaceDeclaration*>(pStatement);
+         Namespace* ns =
+            pContext.mNamespaceStack.back()->requestNamespace(statement->mNamespaceIdentifier);
+
+         pContext.mNamespaceStack.push_back(ns);
+         execute(pContext, statement->mBody);
+         pContext.mNamespaceStack.pop_back();
+      }
+      break;
+   case StatementType::VariableDeclaration:
+      {
+         StatementVariableDeclaration* statement = static_cast<StatementVariableDeclaration*>(pStatement);
+
+         // static variables get initialized only once, while any other execution context which
+         // gets to the declaration in the meantime waits for it
+         if(statement->mStaticInstance)
+         {
+            if(!statement->mStaticInstanceInitialized.load(std::memory_order_acquire))
+            {
+               std::lock_guard<std::recursive_mutex> lock(mStaticInitializationMutex);
+
+               if(!statement->mStaticInstanceInitialized.load(std::memory_order_relaxed))
+               {
+                  initializeVariable(pContext, statement, statement->mStaticInstance);
+                  statement->mStaticInstanceInitialized.store(true, std::memory_order_release);
+               }
+            }
+         }
+         else
+         {
+            Instance* instance =
+               registerInstance(pContext, statement->mTypeUsage, statement->mVariableIdentifier);
+            initializeVariable(pContext, statement, instance);
+         }
+      }
+      break;
+   case StatementType::FunctionDeclaration:
+      {
+         StatementFunctionDeclaration* statement = static_cast<StatementFunctionDeclaration*>(pStatement);
+
+         CflatArgsVector(TypeUsage) parameterTypes;
+         toArgsVector(statement->mParameterTypes, parameterTypes);
+
+         Namespace* functionNS = pContext.mNamespaceStack.back();
+         Function* function = functionNS->getFunction(statement->mFunctionIdentifier, parameterTypes);
+         CflatAssert(function);
+
+         function->mProgram = statement->mProgram;
+         function->mLine = statement->mLine;
+
+         statement->mFunction = function;
+         statement->mNamespace = functionNS;
+
+         if(statement->mBody)
+         {
+            function->mUsingDirectives = pContext.mUsingDirectives;
+            function->mDeclaration = statement;
+            function->execute =
+               [this, function]
+               (const CflatArgsVector(Value)& pArguments, Value* pOutReturnValue)
+            {
+               callFunction(getCurrentExecutionContext(), function, pArguments, pOutReturnValue);
+            };
+         }
+      }
+      break;
+   case StatementType::If:
+      {
+         StatementIf* statement = static_cast<StatementIf*>(pStatement);
+
+         Value conditionValue;
+         conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, statement->mCondition, &conditionValue);
+
+         if(getValueAsInteger(conditionValue))
+         {
+            execute(pContext, statement->mIfStatement);
+         }
+         else if(statement->mElseStatement)
+         {
+            execute(pContext, statement->mElseStatement);
+         }
+      }
+      break;
+   case StatementType::Switch:
+      {
+         StatementSwitch* statement = static_cast<StatementSwitch*>(pStatement);
+
+         Value conditionValue;
+         conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, statement->mCondition, &conditionValue);
+
+         const int64_t conditionValueAsInteger = getValueAsInteger(conditionValue);
+         bool statementExecution = false;
+         size_t i = 0u;
+
+         if(statement->mCaseLookup)
+         {
+            i = statement->findCaseSection(conditionValueAsInteger);
+            statementExecution = true;
+         }
+
+         for(; i < statement->mCaseSections.size(); i++)
+         {
+            const StatementSwitch::CaseSection& caseSection = statement->mCaseSections[i];
+
+            if(!statementExecution)
+            {
+               // case
+               if(caseSection.mExpression)
+               {
+                  Value caseValue;
+                  caseValue.mValueInitializationHint = ValueInitializationHint::Stack;
+                  evaluateExpression(pContext, caseSection.mExpression, &caseValue);
+
+                  const int64_t caseValueAsInteger = getValueAsInteger(caseValue);
+
+                  if(caseValueAsInteger == conditionValueAsInteger)
+                  {
+                     statementExecution = true;
+                  }
+               }
+               // default
+               else
+               {
+                  statementExecution = true;
+               }
+            }
+
+            if(statementExecution)
+            {
+               for(size_t j = 0u; j < caseSection.mStatements.size(); j++)
+               {
+                  execute(pContext, caseSection.mStatements[j]);
+
+                  if(pContext.mJumpStatement == JumpStatement::Break)
+                  {
+                     break;
+                  }
+               }
+            }
+
+            if(pContext.mJumpStatement == JumpStatement::Break)
+            {
+               pContext.mJumpStatement = JumpStatement::None;
+               break;
+            }
+         }
+      }
+      break;
+   case StatementType::While:
+      {
+         StatementWhile* statement = static_cast<StatementWhile*>(pStatement);
+
+         Value conditionValue;
+         conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+         evaluateExpression(pContext, statement->mCondition, &conditionValue);
+
+         while(getValueAsInteger(conditionValue))
+         {
+            execute(pContext, statement->mLoopStatement);
+
+            if(pContext.mJumpStatement == JumpStatement::Continue)
+            {
+               pContext.mJumpStatement = JumpStatement::None;
+            }
+            else if(pContext.mJumpStatement == JumpStatement::Break)
+            {
+               pContext.mJumpStatement = JumpStatement::None;
+               break;
+            }
+
+            evaluateExpression(pContext, statement->mCondition, &conditionValue);
+         }
+      }
+      break;
+   case StatementType::DoWhile:
+      {
+         StatementDoWhile* statement = static_cast<StatementDoWhile*>(pStatement);
+
+         Value conditionValue;
+         conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+
+         do
+         {
+            execute(pContext, statement->mLoopStatement);
+
+            if(pContext.mJumpStatement == JumpStatement::Continue)
+            {
+               pContext.mJumpStatement = JumpStatement::None;
+            }
+            else if(pContext.mJumpStatement == JumpStatement::Break)
+            {
+               pContext.mJumpStatement = JumpStatement::None;
+               break;
+            }
+
+            evaluateExpression(pContext, statement->mCondition, &conditionValue);
+         }
+         while(getValueAsInteger(conditionValue));
+      }
+      break;
+   case StatementType::For:
+      {
+         StatementFor* statement = static_cast<StatementFor*>(pStatement);
+
+         incrementScopeLevel(pContext);
+
+         if(statement->mInitialization)
+         {
+            execute(pContext, statement->mInitialization);
+         }
+
+         {
+            const bool defaultConditionValue = true;
+
+            Value conditionValue;
+            conditionValue.initOnStack(mTypeUsageBool, &pContext.mStack);
+            conditionValue.set(&defaultConditionValue);
+
+            bool conditionMet = defaultConditionValue;
+
+            if(statement->mCondition)
+            {
+               evaluateExpression(pContext, statement->mCondition, &conditionValue);
+               conditionMet = getValueAsInteger(conditionValue) != 0;
+            }
+
+            while(conditionMet)
+            {
+               execute(pContext, statement->mLoopStatement);
+
+               if(pContext.mJumpStatement == JumpStatement::Continue)
+               {
+                  pContext.mJumpStatement = JumpStatement::None;
+               }
+               else if(pContext.mJumpStatement == JumpStatement::Break)
+               {
+                  pContext.mJumpStatement = JumpStatement::None;
+                  break;
+               }
+
+               if(statement->mIncrement)
+               {
+                  Value unusedValue;
+                  evaluateExpression(pContext, statement->mIncrement, &unusedValue);
+               }
+
+               if(statement->mCondition)
+               {
+                  evaluateExpression(pContext, statement->mCondition, &conditionValue);
+                  conditionMet = getValueAsInteger(conditionValue) != 0;
+               }
+            }
+         }
+
+         decrementScopeLevel(pContext);
+      }
+      break;
+   case StatementType::ForRangeBased:
+      {
+         StatementForRangeBased* statement = static_cast<StatementForRangeBased*>(pStatement);
+
+         incrementScopeLevel(pContext);
+
+         {
+            Instance* elementInstance = registerInstance(
+               pContext, statement->mVariableTypeUsage, statement->mVariableIdentifier);
+
+            Value collectionDataValue;
+            collectionDataValue.mValueInitializationHint = ValueInitializationHint::Stack;
+            getInstanceDataValue(pContext, statement->mCollection, &collectionDataValue);
+
+            Value collectionThisValue;
+            collectionThisValue.mValueInitializationHint = ValueInitializationHint::Stack;
+            getAddressOfValue(pContext, collectionDataValue, &collectionThisValue);
+
+            if(collectionDataValue.mTypeUsage.isArray())
+            {
+               size_t elementIndex = 0u;
+
+               while(elementIndex < collectionDataValue.mTypeUsage.mArraySize)
+               {
+                  const size_t arrayElementSize = statement->mVariableTypeUsage.getSize();
+                  const char* arrayElementData =
+                     collectionDataValue.mValueBuffer + (arrayElementSize * elementIndex);
+                  elementInstance->mValue.set(arrayElementData);
+
+                  execute(pContext, statement->mLoopStatement);
+
+                  if(pContext.mJumpStatement == JumpStatement::Continue)
+                  {
+                     pContext.mJumpStatement = JumpStatement::None;
+                  }
+                  else if(pContext.mJumpStatement == JumpStatement::Break)
+                  {
+                     pContext.mJumpStatement = JumpStatement::None;
+                     break;
+                  }
+
+                  elementIndex++;
+               }
+            }
+            else if(static_cast<Struct*>(collectionDataValue.mTypeUsage.mType)->mContiguousData)
+            {
+               // contiguous containers get iterated like arrays, with the data and the size
+               // retrieved once, as the iterators of a range-based for loop would be
+               Struct* collectionType = static_cast<Struct*>(collectionDataValue.mTypeUsage.mType);
+               void* collectionThisPtr = CflatValueAs(&collectionThisValue, void*);
+
+               const char* elementsData = (const char*)collectionType->mContiguousData(collectionThisPtr);
+               const size_t elementsCount = collectionType->mContiguousSize(collectionThisPtr);
+               const size_t elementSize = collectionType->mContiguousElementTypeUsage.getSize();
+
+               for(size_t elementIndex = 0u; elementIndex < elementsCount; elementIndex++)
+               {
+                  elementInstance->mValue.set(elementsData + (elementSize * elementIndex));
+
+                  execute(pContext, statement->mLoopStatement);
+
+                  if(pContext.mJumpStatement == JumpStatement::Continue)
+                  {
+                     pContext.mJumpStatement = JumpStatement::None;
+                  }
+                  else if(pContext.mJumpStatement == JumpStatement::Break)
+                  {
+                     pContext.mJumpStatement = JumpStatement::None;
+                     break;
+                  }
+               }
+            }
+            else
+            {
+               Struct* collectionType = static_cast<Struct*>(collectionDataValue.mTypeUsage.mType);
+
+               Method* collectionBeginMethod =
+                  findMethod(collectionType, "begin", TypeUsage::kEmptyList);
+               Value iteratorValue;
+               iteratorValue.initOnStack(collectionBeginMethod->mReturnTypeUsage, &pContext.mStack);
+               collectionBeginMethod->execute(collectionThisValue, Value::kEmptyList, &iteratorValue);
+
+               Method* collectionEndMethod =
+                  findMethod(collectionType, "end", TypeUsage::kEmptyList);
+               Value collectionEndValue;
+               collectionEndValue.initOnStack(collectionEndMethod->mReturnTypeUsage, &pContext.mStack);
+               collectionEndMethod->execute(collectionThisValue, Value::kEmptyList, &collectionEndValue);
+
+               Type* iteratorType = collectionBeginMethod->mReturnTypeUsage.mType;
+
+               Value conditionValue;
+               conditionValue.initOnStack(mTypeUsageBool, &pContext.mStack);
+               applyBinaryOperator(pContext, iteratorValue, collectionEndValue,
+                  OperatorType::NotEqual, &conditionValue);
+
+               while(CflatValueAs(&conditionValue, bool))
+               {
+                  applyUnaryOperator(pContext, iteratorValue, OperatorType::Dereference,
+                     &elementInstance->mValue);
+
+                  execute(pContext, statement->mLoopStatement);
+
+                  if(pContext.mJumpStatement == JumpStatement::Continue)
+                  {
+                     pContext.mJumpStatement = JumpStatement::None;
+                  }
+                  else if(pContext.mJumpStatement == JumpStatement::Break)
+                  {
+                     pContext.mJumpStatement = JumpStatement::None;
+                     break;
+                  }
+
+                  applyUnaryOperator(pContext, iteratorValue, OperatorType::Increment, &iteratorValue);
+                  applyBinaryOperator(pContext, iteratorValue, collectionEndValue,
+                     OperatorType::NotEqual, &conditionValue);
+               }
+            }
+         }
+
+         decrementScopeLevel(pContext);
+      }
+      break;
+   case StatementType::Break:
+      {
+         pContext.mJumpStatement = JumpStatement::Break;
+      }
+      break;
+   case StatementType::Continue:
+      {
+         pContext.mJumpStatement = JumpStatement::Continue;
+      }
+      break;
+   case StatementType::Return:
+      {
+         StatementReturn* statement = static_cast<StatementReturn*>(pStatement);
+
+         if(statement->mExpression)
+         {
+            Method* copyConstructor = nullptr;
+
+            const TypeUsage& functionReturnTypeUsage =
+               pContext.mCallStack.back().mFunction->mReturnTypeUsage;
+
+            if(functionReturnTypeUsage.mType &&
+               functionReturnTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
+               !functionReturnTypeUsage.isPointer() &&
+               !functionReturnTypeUsage.isReference())
+            {
+               TypeUsage typeUsageReference;
+               typeUsageReference.mType = functionReturnTypeUsage.mType;
+               typeUsageReference.mFlags |= (uint8_t)TypeUsageFlags::Reference;
+
+               CflatArgsVector(TypeUsage) argumentTypes;
+               argumentTypes.push_back(typeUsageReference);
+
+               copyConstructor = findConstructor(functionReturnTypeUsage.mType, argumentTypes);
+
+               if(copyConstructor)
+               {
+                  Value returnValue;
+                  evaluateExpression(pContext, statement->mExpression, &returnValue);
+                  pContext.mReturnValues.back() = returnValue;
+
+                  TypeUsage thisPtrTypeUsage;
+                  thisPtrTypeUsage.mType = functionReturnTypeUsage.mType;
+                  thisPtrTypeUsage.mPointerLevel = 1u;
+
+                  Value thisPtrValue;
+                  thisPtrValue.initExternal(thisPtrTypeUsage);
+                  thisPtrValue.set(&pContext.mReturnValues.back().mValueBuffer);
+
+                  Value referenceValue;
+                  referenceValue.initExternal(typeUsageReference);
+                  referenceValue.set(returnValue.mValueBuffer);
+
+                  CflatArgsVector(Value) args;
+                  args.push_back(referenceValue);
+                  copyConstructor->execute(thisPtrValue, args, nullptr);
+               }
+            }
+
+            if(!copyConstructor)
+            {
+               evaluateExpression(pContext, statement->mExpression, &pContext.mReturnValues.back());
+            }
          }
+
+         pContext.mJumpStatement = JumpStatement::Return;
       }
+      break;
+   default:
+      break;
    }
-   // decimal built-in
-   else if(type->mCategory == TypeCategory::BuiltIn)
-   {
-      if(pOperator[0] == '-')
-      {
-         const double valueAsDecimal = getValueAsDecimal(pOperand);
-         setValueAsDecimal(-valueAsDecimal, pOutValue);
-      }
-   }
-   // struct or class
-   else
-   {
-      pContext.mStringBuffer.assign("operator");
-      pContext.mStringBuffer.append(pOperator);
+}
 
-      CflatArgsVector(Value) args;
+void Environment::initializeVariable(ExecutionContext& pContext,
+   StatementVariableDeclaration* pStatement, Instance* pInstance)
+{
+   const bool isStructOrClassInstance =
+      pInstance->mTypeUsage.mType &&
+      pInstance->mTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
+      !pInstance->mTypeUsage.isPointer() &&
+      !pInstance->mTypeUsage.isReference();
 
-      const Identifier operatorIdentifier(pContext.mStringBuffer.c_str());
-      Method* operatorMethod = findMethod(type, operatorIdentifier);
-      
-      if(operatorMethod)
-      {
-         Value thisPtrValue;
-         thisPtrValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         getAddressOfValue(pContext, pOperand, &thisPtrValue);
+   if(isStructOrClassInstance)
+   {
+      Method* defaultCtor = getDefaultConstructor(pInstance->mTypeUsage.mType);
 
-         operatorMethod->execute(thisPtrValue, args, pOutValue);
-      }
-      else
+      if(defaultCtor)
       {
-         args.push_back(pOperand);
-
-         Function* operatorFunction = type->mNamespace->getFunction(operatorIdentifier, args);
+         pInstance->mValue.mTypeUsage = pInstance->mTypeUsage;
 
-         if(!operatorFunction)
-         {
-            operatorFunction = findFunction(pContext, operatorIdentifier, args);
-         }
+         Value thisPtr;
+         thisPtr.mValueInitializationHint = ValueInitializationHint::Stack;
+         getAddressOfValue(pContext, pInstance->mValue, &thisPtr);
 
-         CflatAssert(operatorFunction);
-         operatorFunction->execute(args, pOutValue);
+         CflatArgsVector(Value) args;
+         defaultCtor->execute(thisPtr, args, nullptr);
       }
    }
+
+   if(pStatement->mInitialValue)
+   {
+      Value initialValue;
+      initialValue.mTypeUsage = pInstance->mTypeUsage;
+      initialValue.mValueInitializationHint = ValueInitializationHint::Stack;
+      evaluateExpression(pContext, pStatement->mInitialValue, &initialValue);
+      assignValue(pContext, initialValue, &pInstance->mValue, true);
+   }
 }
 
-void Environment::applyBinaryOperator(ExecutionContext& pContext, const Value& pLeft, const Value& pRight,
-   const char* pOperator, Value* pOutValue)
+void Environment::execute(ExecutionContext& pContext, const Bytecode& pBytecode)
 {
-  if(!mErrorMessage.empty())
-     return;
-
-   Type* leftType = pLeft.mTypeUsage.mType;
-   Type* rightType = pRight.mTypeUsage.mType;
+   execute(pContext, pBytecode, 0u, pContext.mBlockLevel, pContext.mScopeLevel);
+}
 
-   const bool leftIsNumericValue =
-      leftType->mCategory == TypeCategory::BuiltIn ||
-      leftType->mCategory == TypeCategory::Enum ||
-      pLeft.mTypeUsage.isPointer();
-   const bool rightIsNumericValue =
-      rightType->mCategory == TypeCategory::BuiltIn ||
-      rightType->mCategory == TypeCategory::Enum ||
-      pRight.mTypeUsage.isPointer();
+void Environment::execute(ExecutionContext& pContext, const Bytecode& pBytecode,
+   uint32_t pInstructionIndex, uint32_t pBaseBlockLevel, uint32_t pBaseScopeLevel)
+{
+   const uint32_t baseBlockLevel = pBaseBlockLevel;
+   const uint32_t baseScopeLevel = pBaseScopeLevel;
 
-   if(leftIsNumericValue && rightIsNumericValue)
-   {
-      const bool integerLeftValue = leftType->isInteger() || pLeft.mTypeUsage.isPointer();
-      const bool integerRightValue = rightType->isInteger() || pRight.mTypeUsage.isPointer();
-      const bool integerValues = integerLeftValue && integerRightValue;
+   const Instruction* instructions = pBytecode.mInstructions.data();
+   const uint32_t instructionsCount = (uint32_t)pBytecode.mInstructions.size();
+   uint32_t instructionIndex = pInstructionIndex;
 
-      int64_t leftValueAsInteger = getValueAsInteger(pLeft);
-      int64_t rightValueAsInteger = getValueAsInteger(pRight);
-      double leftValueAsDecimal = 0.0;
-      double rightValueAsDecimal = 0.0;
+   SlicedCall& slicedCall = pContext.mSlicedCall;
 
-      if(integerLeftValue)
-      { 
-         if(!integerRightValue)
-         {
-            leftValueAsDecimal = (double)leftValueAsInteger;
-         }
+   while(instructionIndex < instructionsCount && pContext.mErrorMessage.empty())
+   {
+      if(pContext.mStack.mOverflown)
+      {
+         throwStackOverflowError(pContext);
+         break;
       }
-      else
+
+      // out of budget in a time-sliced call: the blocks and scopes stay open, so the execution
+      // can continue from this very instruction
+      if(slicedCall.mFunction &&
+         consumeExecutionBudget(slicedCall) &&
+         pContext.mCallStack.size() == slicedCall.mCallDepth)
       {
-         leftValueAsDecimal = getValueAsDecimal(pLeft);
+         slicedCall.mInstructionIndex = instructionIndex;
+         slicedCall.mBaseBlockLevel = baseBlockLevel;
+         slicedCall.mBaseScopeLevel = baseScopeLevel;
+         slicedCall.mSuspended = true;
+         return;
       }
 
-      if(integerRightValue)
+      const Instruction& instruction = instructions[instructionIndex++];
+
+      if(instruction.mStatement && instruction.mType != InstructionType::Statement)
       {
-         if(!integerLeftValue)
+         pContext.mProgram = instruction.mStatement->mProgram;
+
+         pContext.mCallStack.back().mProgram = instruction.mStatement->mProgram;
+         pContext.mCallStack.back().mLine = instruction.mStatement->mLine;
+
+         if(mStatementHooksEnabled || pContext.mProfiler)
          {
-            rightValueAsDecimal = (double)rightValueAsInteger;
+            executeStatementHooks(pContext, instruction.mStatement);
          }
       }
-      else
-      {
-         rightValueAsDecimal = getValueAsDecimal(pRight);
-      }
 
-      if(strcmp(pOperator, "==") == 0)
-      {
-         const bool result = leftValueAsInteger == rightValueAsInteger;
-         pOutValue->assign(&result);
-      }
-      else if(strcmp(pOperator, "!=") == 0)
-      {
-         const bool result = leftValueAsInteger != rightValueAsInteger;
-         pOutValue->assign(&result);
-      }
-      else if(strcmp(pOperator, "<") == 0)
-      {
-         const bool result = integerValues
-            ? leftValueAsInteger < rightValueAsInteger
-            : leftValueAsDecimal < rightValueAsDecimal;
-         pOutValue->assign(&result);
-      }
-      else if(strcmp(pOperator, ">") == 0)
-      {
-         const bool result = integerValues
-            ? leftValueAsInteger > rightValueAsInteger
-            : leftValueAsDecimal > rightValueAsDecimal;
-         pOutValue->assign(&result);
-      }
-      else if(strcmp(pOperator, "<=") == 0)
-      {
-         const bool result = integerValues
-            ? leftValueAsInteger <= rightValueAsInteger
-            : leftValueAsDecimal <= rightValueAsDecimal;
-         pOutValue->assign(&result);
-      }
-      else if(strcmp(pOperator, ">=") == 0)
-      {
-         const bool result = integerValues
-            ? leftValueAsInteger >= rightValueAsInteger
-            : leftValueAsDecimal >= rightValueAsDecimal;
-         pOutValue->assign(&result);
-      }
-      else if(strcmp(pOperator, "&&") == 0)
-      {
-         const bool result = leftValueAsInteger && rightValueAsInteger;
-         pOutValue->assign(&result);
-      }
-      else if(strcmp(pOperator, "||") == 0)
-      {
-         const bool result = leftValueAsInteger || rightValueAsInteger;
-         pOutValue->assign(&result);
-      }
-      else if(strcmp(pOperator, "+") == 0)
+      switch(instruction.mType)
       {
-         if(integerValues)
+      case InstructionType::Statement:
          {
-            if(pLeft.mTypeUsage.isPointer())
+            execute(pContext, instruction.mStatement);
+
+            if(pContext.mJumpStatement == JumpStatement::Return)
             {
-               rightValueAsInteger *= (int64_t)pLeft.mTypeUsage.mType->mSize;
+               instructionIndex = instructionsCount;
             }
-
-            setValueAsInteger(leftValueAsInteger + rightValueAsInteger, pOutValue);
          }
-         else
+         break;
+      case InstructionType::Expression:
          {
-            setValueAsDecimal(leftValueAsDecimal + rightValueAsDecimal, pOutValue);
+            Value unusedValue;
+            unusedValue.mValueInitializationHint = ValueInitializationHint::Stack;
+            evaluateExpression(pContext, instruction.mExpression, &unusedValue);
          }
-      }
-      else if(strcmp(pOperator, "-") == 0)
-      {
-         if(integerValues)
+         break;
+      case InstructionType::BlockBegin:
          {
-            if(pLeft.mTypeUsage.isPointer())
+            incrementBlockLevel(pContext);
+
+            if(instruction.mAlterScope)
             {
-               rightValueAsInteger *= (int64_t)pLeft.mTypeUsage.mType->mSize;
+               incrementScopeLevel(pContext);
+            }
+         }
+         break;
+      case InstructionType::BlockEnd:
+         {
+            if(instruction.mAlterScope)
+            {
+               decrementScopeLevel(pContext);
             }
 
-            setValueAsInteger(leftValueAsInteger - rightValueAsInteger, pOutValue);
+            decrementBlockLevel(pContext);
          }
-         else
+         break;
+      case InstructionType::ScopeBegin:
          {
-            setValueAsDecimal(leftValueAsDecimal - rightValueAsDecimal, pOutValue);
+            incrementScopeLevel(pContext);
          }
-      }
-      else if(strcmp(pOperator, "*") == 0)
-      {
-         if(integerValues)
+         break;
+      case InstructionType::ScopeEnd:
          {
-            setValueAsInteger(leftValueAsInteger * rightValueAsInteger, pOutValue);
+            decrementScopeLevel(pContext);
          }
-         else
+         break;
+      case InstructionType::Jump:
          {
-            setValueAsDecimal(leftValueAsDecimal * rightValueAsDecimal, pOutValue);
+            instructionIndex = instruction.mOperand;
          }
-      }
-      else if(strcmp(pOperator, "/") == 0)
-      {
-         if(integerValues)
+         break;
+      case InstructionType::JumpIfFalse:
+      case InstructionType::JumpIfTrue:
          {
-            if(rightValueAsInteger != 0)
-            {
-               setValueAsInteger(leftValueAsInteger / rightValueAsInteger, pOutValue);
-            }
-            else
+            Value conditionValue;
+            conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+            evaluateExpression(pContext, instruction.mExpression, &conditionValue);
+
+            const bool conditionMet = getValueAsInteger(conditionValue) != 0;
+
+            if(conditionMet == (instruction.mType == InstructionType::JumpIfTrue))
             {
-               throwRuntimeError(pContext, RuntimeError::DivisionByZero);
+               instructionIndex = instruction.mOperand;
             }
          }
-         else
+         break;
+      case InstructionType::Leave:
          {
-            if(fabs(rightValueAsDecimal) > 0.000000001)
+            while(pContext.mScopeLevel > (baseScopeLevel + instruction.mScopeDepth))
             {
-               setValueAsDecimal(leftValueAsDecimal / rightValueAsDecimal, pOutValue);
+               decrementScopeLevel(pContext);
             }
-            else
+
+            while(pContext.mBlockLevel > (baseBlockLevel + instruction.mBlockDepth))
             {
-               throwRuntimeError(pContext, RuntimeError::DivisionByZero);
+               decrementBlockLevel(pContext);
             }
+
+            instructionIndex = instruction.mOperand;
          }
-      }
-      else if(strcmp(pOperator, "%") == 0)
-      {
-         setValueAsInteger(leftValueAsInteger % rightValueAsInteger, pOutValue);
-      }
-      else if(strcmp(pOperator, "&") == 0)
-      {
-         setValueAsInteger(leftValueAsInteger & rightValueAsInteger, pOutValue);
-      }
-      else if(strcmp(pOperator, "|") == 0)
-      {
-         setValueAsInteger(leftValueAsInteger | rightValueAsInteger, pOutValue);
-      }
-      else if(strcmp(pOperator, "^") == 0)
-      {
-         setValueAsInteger(leftValueAsInteger ^ rightValueAsInteger, pOutValue);
-      }
-      else if(strcmp(pOperator, "<<") == 0)
-      {
-         setValueAsInteger(leftValueAsInteger << rightValueAsInteger, pOutValue);
-      }
-      else if(strcmp(pOperator, ">>") == 0)
-      {
-         setValueAsInteger(leftValueAsInteger >> rightValueAsInteger, pOutValue);
-      }
-   }
-   else
-   {
-      pContext.mStringBuffer.assign("operator");
-      pContext.mStringBuffer.append(pOperator);
+         break;
+      case InstructionType::Switch:
+         {
+            StatementSwitch* statement = static_cast<StatementSwitch*>(instruction.mStatement);
 
-      CflatArgsVector(Value) args;
-      args.push_back(pRight);
+            Value conditionValue;
+            conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+            evaluateExpression(pContext, instruction.mExpression, &conditionValue);
 
-      const Identifier operatorIdentifier(pContext.mStringBuffer.c_str());
-      Method* operatorMethod = findMethod(leftType, operatorIdentifier, args);
-      
-      if(operatorMethod)
-      {
-         Value thisPtrValue;
-         thisPtrValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         getAddressOfValue(pContext, pLeft, &thisPtrValue);
+            const int64_t conditionValueAsInteger = getValueAsInteger(conditionValue);
+            const size_t caseSectionsCount = statement->mCaseSections.size();
+            size_t caseSectionIndex = statement->mCaseLookup
+               ? statement->findCaseSection(conditionValueAsInteger)
+               : 0u;
 
-         operatorMethod->execute(thisPtrValue, args, pOutValue);
-      }
-      else
-      {
-         args.insert(args.begin(), pLeft);
+            for(; !statement->mCaseLookup && caseSectionIndex < caseSectionsCount; caseSectionIndex++)
+            {
+               const StatementSwitch::CaseSection& caseSection =
+                  statement->mCaseSections[caseSectionIndex];
 
-         Function* operatorFunction = leftType->mNamespace->getFunction(operatorIdentifier, args);
+               // default
+               if(!caseSection.mExpression)
+               {
+                  break;
+               }
 
-         if(!operatorFunction)
-         {
-            operatorFunction = findFunction(pContext, operatorIdentifier, args);
-         }
+               // case
+               Value caseValue;
+               caseValue.mValueInitializationHint = ValueInitializationHint::Stack;
+               evaluateExpression(pContext, caseSection.mExpression, &caseValue);
 
-         CflatAssert(operatorFunction);
-         operatorFunction->execute(args, pOutValue);
+               if(getValueAsInteger(caseValue) == conditionValueAsInteger)
+               {
+                  break;
+               }
+            }
+
+            instructionIndex = pBytecode.mCaseTargets[instruction.mOperand + caseSectionIndex];
+         }
+         break;
+      default:
+         break;
       }
    }
-}
 
-void Environment::performAssignment(ExecutionContext& pContext, const Value& pValue,
-   const char* pOperator, Value* pInstanceDataValue)
-{
-   if(strcmp(pOperator, "=") == 0)
-   {
-      assignValue(pContext, pValue, pInstanceDataValue, false);
-   }
-   else
+   // return statement or error: close the blocks and scopes which are still open
+   while(pContext.mScopeLevel > baseScopeLevel)
    {
-      char binaryOperator[2];
-      binaryOperator[0] = pOperator[0];
-      binaryOperator[1] = '\0';
+      decrementScopeLevel(pContext);
+   }
 
-      applyBinaryOperator(pContext, *pInstanceDataValue, pValue, binaryOperator, pInstanceDataValue);
+   while(pContext.mBlockLevel > baseBlockLevel)
+   {
+      decrementBlockLevel(pContext);
    }
 }
 
-void Environment::performStaticCast(ExecutionContext& pContext, const Value& pValueToCast,
-   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+void Environment::beginFunctionCall(ExecutionContext& pContext, Function* pFunction,
+   Value* pOutReturnValue)
 {
-   const TypeUsage& sourceTypeUsage = pValueToCast.mTypeUsage;
+   const bool mustReturnValue =
+      pFunction->mReturnTypeUsage.mType && pFunction->mReturnTypeUsage.mType != mTypeVoid;
 
-   if(sourceTypeUsage.mType->mCategory == TypeCategory::BuiltIn &&
-      pTargetTypeUsage.mType->mCategory == TypeCategory::BuiltIn)
+   if(mustReturnValue)
    {
-      if(sourceTypeUsage.mType->isInteger())
+      if(pOutReturnValue)
       {
-         const int64_t sourceValueAsInteger = getValueAsInteger(pValueToCast);
-
-         if(pTargetTypeUsage.mType->isInteger())
-         {
-            setValueAsInteger(sourceValueAsInteger, pOutValue);
-         }
-         else
-         {
-            setValueAsDecimal((double)sourceValueAsInteger, pOutValue);
-         }
+         assertValueInitialization(pContext, pFunction->mReturnTypeUsage, pOutReturnValue);
       }
-      else
-      {
-         const double sourceValueAsDecimal = getValueAsDecimal(pValueToCast);
 
-         if(pTargetTypeUsage.mType->isInteger())
-         {
-            setValueAsInteger((int64_t)sourceValueAsDecimal, pOutValue);
-         }
-         else
-         {
-            setValueAsDecimal(sourceValueAsDecimal, pOutValue);
-         }
-      }
-   }
-   else if(sourceTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
-      pTargetTypeUsage.mType->mCategory == TypeCategory::StructOrClass)
-   {
-      performInheritanceCast(pContext, pValueToCast, pTargetTypeUsage, pOutValue);
+      pContext.mReturnValues.emplace_back();
+      pContext.mReturnValues.back().initOnStack(pFunction->mReturnTypeUsage, &pContext.mStack);
    }
 }
 
-void Environment::performIntegerCast(ExecutionContext& pContext, const Value& pValueToCast,
-   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+void Environment::callFunction(ExecutionContext& pContext, Function* pFunction,
+   const CflatSTLVector(Expression*)& pArguments, Value* pOutReturnValue)
 {
-   setValueAsInteger(getValueAsInteger(pValueToCast), pOutValue);
-}
+   StatementFunctionDeclaration* statement = pFunction->mDeclaration;
+   CflatAssert(statement->mParameterTypes.size() == pArguments.size());
 
-void Environment::performIntegerFloatCast(ExecutionContext& pContext, const Value& pValueToCast,
-   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
-{
-   Type* sourceType = pValueToCast.mTypeUsage.mType;
-   Type* targetType = pTargetTypeUsage.mType;
+   beginFunctionCall(pContext, pFunction, pOutReturnValue);
 
-   CflatAssert(sourceType->mCategory == TypeCategory::BuiltIn);
-   CflatAssert(targetType->mCategory == TypeCategory::BuiltIn);
+   const size_t localFrameBase = pContext.mLocalInstancesHolder.getInstancesCount();
 
-   if(sourceType->isInteger() && targetType->isDecimal())
+   // the arguments are evaluated in the frame of the caller, so the parameters are registered
+   // one scope level deeper (which keeps them alive while evaluating calls within arguments)
+   // and without identifier, so they do not hide any variable used by the arguments
+   pContext.mScopeLevel++;
+
+   for(size_t i = 0u; i < pArguments.size(); i++)
    {
-      const int64_t integerValue = getValueAsInteger(pValueToCast);
-      setValueAsDecimal((double)integerValue, pOutValue);
+      const Identifier anonymousIdentifier;
+      Instance* parameterInstance =
+         registerInstance(pContext, statement->mParameterTypes[i], anonymousIdentifier);
+
+      Value argumentValue;
+      argumentValue.mValueInitializationHint = ValueInitializationHint::Stack;
+      evaluateExpression(pContext, pArguments[i], &argumentValue);
+
+      assignValue(pContext, argumentValue, &parameterInstance->mValue, true);
    }
-   else if(sourceType->isDecimal() && targetType->isInteger())
+
+   for(size_t i = 0u; i < pArguments.size(); i++)
    {
-      const double decimalValue = getValueAsDecimal(pValueToCast);
-      setValueAsInteger((int64_t)decimalValue, pOutValue);
+      pContext.mLocalInstancesHolder.setInstanceIdentifier(localFrameBase + i,
+         statement->mParameterIdentifiers[i]);
    }
+
+   pContext.mScopeLevel--;
+
+   executeFunctionBody(pContext, pFunction, localFrameBase, pOutReturnValue);
 }
 
-void Environment::performFloatCast(ExecutionContext& pContext, const Value& pValueToCast,
-   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+void Environment::callFunction(ExecutionContext& pContext, Function* pFunction,
+   const CflatArgsVector(Value)& pArguments, Value* pOutReturnValue)
 {
-   Type* sourceType = pValueToCast.mTypeUsage.mType;
-   Type* targetType = pTargetTypeUsage.mType;
+   StatementFunctionDeclaration* statement = pFunction->mDeclaration;
+   CflatAssert(pFunction->mParameters.size() == pArguments.size());
 
-   CflatAssert(sourceType->mCategory == TypeCategory::BuiltIn);
-   CflatAssert(targetType->mCategory == TypeCategory::BuiltIn);
+   beginFunctionCall(pContext, pFunction, pOutReturnValue);
 
-   const double decimalValue = getValueAsDecimal(pValueToCast);
-   setValueAsDecimal(decimalValue, pOutValue);
+   const size_t localFrameBase = pContext.mLocalInstancesHolder.getInstancesCount();
+
+   for(size_t i = 0u; i < pArguments.size(); i++)
+   {
+      const TypeUsage parameterType = statement->mParameterTypes[i];
+      const Identifier& parameterIdentifier = statement->mParameterIdentifiers[i];
+
+      pContext.mScopeLevel++;
+      Instance* argumentInstance = registerInstance(pContext, parameterType, parameterIdentifier);
+      pContext.mScopeLevel--;
+
+      assignValue(pContext, pArguments[i], &argumentInstance->mValue, true);
+   }
+
+   executeFunctionBody(pContext, pFunction, localFrameBase, pOutReturnValue);
 }
 
-void Environment::performInheritanceCast(ExecutionContext& pContext, const Value& pValueToCast,
-   const TypeUsage& pTargetTypeUsage, Value* pOutValue)
+void Environment::executeFunctionBody(ExecutionContext& pContext, Function* pFunction,
+   size_t pLocalFrameBase, Value* pOutReturnValue)
 {
-   CflatAssert(pValueToCast.mTypeUsage.mType->mCategory == TypeCategory::StructOrClass);
-   CflatAssert(pTargetTypeUsage.mType->mCategory == TypeCategory::StructOrClass);
+   StatementFunctionDeclaration* statement = pFunction->mDeclaration;
 
-   Struct* sourceType = static_cast<Struct*>(pValueToCast.mTypeUsage.mType);
-   Struct* targetType = static_cast<Struct*>(pTargetTypeUsage.mType);
+   pContext.mNamespaceStack.push_back(statement->mNamespace);
 
-   char* ptr = nullptr;
+   const size_t previousLocalFrameBase = pContext.mLocalFrameBase;
+   pContext.mLocalFrameBase = pLocalFrameBase;
 
-   if(sourceType == targetType)
+   for(size_t i = 0u; i < pFunction->mUsingDirectives.size(); i++)
    {
-      ptr = CflatValueAs(&pValueToCast, char*);
-   }
-   else if(sourceType->derivedFrom(targetType))
-   {
-      ptr = CflatValueAs(&pValueToCast, char*) + sourceType->getOffset(targetType);
+      pContext.mUsingDirectives.push_back(pFunction->mUsingDirectives[i]);
+      pContext.mUsingDirectives.back().mBlockLevel = 0u;
    }
-   else if(targetType->derivedFrom(sourceType))
+
+   // the timer hook measures the run time of each top-level call, not the time in between
+   if(mTimerHook && pContext.mCallStack.empty())
    {
-      ptr = CflatValueAs(&pValueToCast, char*) - targetType->getOffset(sourceType);
+      resetTimerHook(pContext);
    }
 
-   pOutValue->set(&ptr);
-}
+   pContext.mCallStack.emplace_back(statement->mProgram, pFunction);
 
-void Environment::assignValue(ExecutionContext& pContext, const Value& pSource, Value* pTarget,
-   bool pDeclaration)
-{
-   const TypeUsage typeUsage = pTarget->mTypeUsage;
-   const TypeHelper::Compatibility compatibility =
-      TypeHelper::getCompatibility(typeUsage, pSource.mTypeUsage);
+   // the profiler gets captured, so the call gets closed even if it is detached meanwhile
+   Profiler* profiler = pContext.mProfiler;
 
-   if(compatibility == TypeHelper::Compatibility::ImplicitCastableInteger)
-   {
-      performIntegerCast(pContext, pSource, typeUsage, pTarget);
-   }
-   else if(compatibility == TypeHelper::Compatibility::ImplicitCastableIntegerFloat)
+   if(profiler)
    {
-      performIntegerFloatCast(pContext, pSource, typeUsage, pTarget);
+      profiler->beginFunctionCall(pFunction);
    }
-   else if(compatibility == TypeHelper::Compatibility::ImplicitCastableFloat)
+
+   if(mFunctionHook)
    {
-      performFloatCast(pContext, pSource, typeUsage, pTarget);
+      mFunctionHook(this, pContext.mCallStack, FunctionHookEvent::Enter);
    }
-   else if(compatibility == TypeHelper::Compatibility::ImplicitCastableInheritance)
+
+   if(statement->mBytecode)
    {
-      performInheritanceCast(pContext, pSource, typeUsage, pTarget);
+      execute(pContext, *statement->mBytecode);
    }
    else
    {
-      bool valueAssigned = false;
+      execute(pContext, statement->mBody);
+   }
 
-      if(!pTarget->mTypeUsage.isPointer() &&
-         pTarget->mTypeUsage.mType->mCategory == TypeCategory::StructOrClass)
-      {
-         Struct* type = static_cast<Struct*>(pTarget->mTypeUsage.mType);
+   // suspended time-sliced call: the frame of the function stays in place until it gets resumed
+   if(pContext.mSlicedCall.mSuspended &&
+      pContext.mCallStack.size() == pContext.mSlicedCall.mCallDepth)
+   {
+      pContext.mSlicedCall.mPreviousLocalFrameBase = previousLocalFrameBase;
+      pContext.mSlicedCall.mProfiler = profiler;
+      return;
+   }
 
-         CflatArgsVector(Value) args;
-         args.push_back(pSource);
+   endFunctionBody(pContext, pFunction, previousLocalFrameBase, profiler, pOutReturnValue);
+}
 
-         const Identifier operatorIdentifier("operator=");
-         Method* operatorMethod = findMethod(type, operatorIdentifier, args);
+void Environment::endFunctionBody(ExecutionContext& pContext, Function* pFunction,
+   size_t pPreviousLocalFrameBase, Profiler* pProfiler, Value* pOutReturnValue)
+{
+   if(mFunctionHook)
+   {
+      mFunctionHook(this, pContext.mCallStack, FunctionHookEvent::Exit);
+   }
 
-         if(operatorMethod && operatorMethod->mReturnTypeUsage.mType == type)
-         {
-            Value thisPtrValue;
-            thisPtrValue.mValueInitializationHint = ValueInitializationHint::Stack;
-            getAddressOfValue(pContext, *pTarget, &thisPtrValue);
+   if(pProfiler)
+   {
+      pProfiler->endCall();
+   }
 
-            operatorMethod->execute(thisPtrValue, args, pTarget);
+   pContext.mCallStack.pop_back();
 
-            valueAssigned = true;
-         }
-      }
+   for(size_t i = 0u; i < pFunction->mUsingDirectives.size(); i++)
+   {
+      pContext.mUsingDirectives.pop_back();
+   }
 
-      if(!valueAssigned)
-      {
-         if(pDeclaration)
-         {
-            *pTarget = pSource;
-         }
-         else
-         {
-            pTarget->assign(pSource.mValueBuffer);
-         }
-      }
+   if(mExecutionHook && pContext.mCallStack.empty())
+   {
+      mExecutionHook(this, pContext.mCallStack);
    }
-}
 
-void Environment::execute(ExecutionContext& pContext, const Program& pProgram)
-{
-   pContext.mJumpStatement = JumpStatement::None;
+   pContext.mNamespaceStack.pop_back();
+   pContext.mLocalFrameBase = pPreviousLocalFrameBase;
 
-   pContext.mCallStack.emplace_back(&pProgram);
+   const bool mustReturnValue =
+      pFunction->mReturnTypeUsage.mType && pFunction->mReturnTypeUsage.mType != mTypeVoid;
 
-   for(size_t i = 0u; i < pProgram.mStatements.size(); i++)
+   if(mustReturnValue)
    {
-      execute(pContext, pProgram.mStatements[i]);
-
-      if(!mErrorMessage.empty())
+      if(pOutReturnValue)
       {
-         break;
+         pOutReturnValue->set(pContext.mReturnValues.back().mValueBuffer);
       }
-   }
-
-   pContext.mCallStack.pop_back();
 
-   if(mExecutionHook)
-   {
-      mExecutionHook(this, pContext.mCallStack);
+      pContext.mReturnValues.pop_back();
    }
 
-   pContext.mUsingDirectives.clear();
+   pContext.mJumpStatement = JumpStatement::None;
 }
 
-void Environment::assertValueInitialization(ExecutionContext& pContext, const TypeUsage& pTypeUsage,
-   Value* pOutValue)
+void Environment::startExecutionBudget(SlicedCall& pCall, const ExecutionBudget& pBudget)
 {
-   if(pOutValue->mValueBufferType == ValueBufferType::Uninitialized)
+   pCall.mInstructionsBudget = pBudget.mInstructionsCount;
+   pCall.mExecutedInstructionsCount = 0u;
+   pCall.mDeadline = pBudget.mMicroseconds > 0u
+      ? getTime() + (uint64_t)pBudget.mMicroseconds * 1000u
+      : 0u;
+   pCall.mBudgetExhausted = false;
+}
+
+bool Environment::consumeExecutionBudget(SlicedCall& pCall)
+{
+   if(!pCall.mBudgetExhausted)
    {
-      if(pTypeUsage.isReference())
-      {
-         pOutValue->initExternal(pTypeUsage);
-      }
-      else if(pOutValue->mValueInitializationHint == ValueInitializationHint::Stack)
+      pCall.mExecutedInstructionsCount++;
+
+      if(pCall.mInstructionsBudget > 0u &&
+         pCall.mExecutedInstructionsCount > pCall.mInstructionsBudget)
       {
-         pOutValue->initOnStack(pTypeUsage, &pContext.mStack);
+         pCall.mBudgetExhausted = true;
       }
-      else
+      else if(pCall.mDeadline > 0u &&
+         (pCall.mExecutedInstructionsCount % kTimerHookCheckInterval) == 0u &&
+         getTime() >= pCall.mDeadline)
       {
-         pOutValue->initOnHeap(pTypeUsage);
+         pCall.mBudgetExhausted = true;
       }
    }
+
+   return pCall.mBudgetExhausted;
 }
 
-int64_t Environment::getValueAsInteger(const Value& pValue)
+ExecutionStatus Environment::endSlicedFunctionCall(ExecutionContext& pContext)
 {
-   const bool signedType =
-      !pValue.mTypeUsage.isPointer() &&
-      pValue.mTypeUsage.mType->mCategory == TypeCategory::BuiltIn &&
-      pValue.mTypeUsage.mType->mIdentifier.mName[0] == 'i';
-
-   const size_t typeUsageSize = pValue.mTypeUsage.getSize();
-   int64_t valueAsInteger = 0;
-
-   if(typeUsageSize == sizeof(int32_t))
-   {
-      valueAsInteger = signedType
-         ? (int64_t)CflatValueAs(&pValue, int32_t)
-         : (int64_t)CflatValueAs(&pValue, uint32_t);
-   }
-   else if(typeUsageSize == sizeof(int64_t))
+   if(pContext.mSlicedCall.mSuspended)
    {
-      valueAsInteger = CflatValueAs(&pValue, int64_t);
+      return ExecutionStatus::Suspended;
    }
-   else if(typeUsageSize == sizeof(int16_t))
+
+   // the budget can only run out without suspending the call within the calls it makes
+   const bool budgetExhausted = pContext.mSlicedCall.mBudgetExhausted;
+
+   CflatInvokeDtor(SlicedCall, &pContext.mSlicedCall);
+   CflatInvokeCtor(SlicedCall, &pContext.mSlicedCall);
+
+   if(!pContext.mErrorMessage.empty())
    {
-      valueAsInteger = signedType
-         ? (int64_t)CflatValueAs(&pValue, int16_t)
-         : (int64_t)CflatValueAs(&pValue, uint16_t);
+      return ExecutionStatus::Failed;
    }
-   else if(typeUsageSize == sizeof(int8_t))
+
+   return budgetExhausted ? ExecutionStatus::CompletedOverBudget : ExecutionStatus::Completed;
+}
+
+bool Environment::checkSuspendedSlicedCalls(const Program* pProgram, const Statement* pDeclaration)
+{
+   // a suspended call resumes the bytecode it was running, so the function cannot be replaced
+   // (either the given declaration, or any function of the program if none) until it ends
+   for(size_t i = 0u; i <= mExecutionContexts.size(); i++)
    {
-      valueAsInteger = signedType
-         ? (int64_t)CflatValueAs(&pValue, int8_t)
-         : (int64_t)CflatValueAs(&pValue, uint8_t);
+      const ExecutionContext* context =
+         i < mExecutionContexts.size() ? mExecutionContexts[i] : &mExecutionContext;
+      const Function* function = context->mSlicedCall.mFunction;
+
+      if(!function || !context->mSlicedCall.mSuspended || function->mProgram != pProgram)
+         continue;
+
+      if(pDeclaration && (const Statement*)function->mDeclaration != pDeclaration)
+         continue;
+
+      mErrorMessage.assign("[Compile Error] '");
+      mErrorMessage.append(pProgram->mIdentifier.mName);
+      mErrorMessage.append("': '");
+      mErrorMessage.append(function->mIdentifier.mName);
+      mErrorMessage.append("' cannot be replaced while a time-sliced call to it is suspended");
+      return false;
    }
-   else
+
+   return true;
+}
+
+ExecutionContext& Environment::getCurrentExecutionContext()
+{
+   if(gExecutionContextBinding.mEnvironment == this && gExecutionContextBinding.mContext)
    {
-      CflatAssert(false); // Unsupported
+      return *gExecutionContextBinding.mContext;
    }
 
-   return valueAsInteger;
+   return mExecutionContext;
+}
+
+uint32_t Environment::getId() const
+{
+   return mId;
+}
+
+Allocator* Environment::getAllocator()
+{
+   return mAllocator;
+}
+
+const Memory::StringsPool::Stats& Environment::getLiteralStringsStats() const
+{
+   return mLiteralStringsPool.getStats();
+}
+
+void Environment::compactLiteralStrings()
+{
+   mLiteralStringsPool.compact();
+}
+
+Namespace* Environment::getGlobalNamespace()
+{
+   return &mGlobalNamespace;
+}
+
+Namespace* Environment::getNamespace(const Identifier& pIdentifier)
+{
+   return mGlobalNamespace.getNamespace(pIdentifier);
 }
 
-double Environment::getValueAsDecimal(const Value& pValue)
+Namespace* Environment::requestNamespace(const Identifier& pIdentifier)
 {
-   const size_t typeUsageSize = pValue.mTypeUsage.getSize();
-   double valueAsDecimal = 0.0;
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   if(typeUsageSize == sizeof(float))
-   {
-      valueAsDecimal = (double)CflatValueAs(&pValue, float);
-   }
-   else if(typeUsageSize == sizeof(double))
-   {
-      valueAsDecimal = CflatValueAs(&pValue, double);
-   }
-   else
-   {
-      CflatAssert(false); // Unsupported
-   }
+   return mGlobalNamespace.requestNamespace(pIdentifier);
+}
 
-   return valueAsDecimal;
+Type* Environment::getType(const Identifier& pIdentifier)
+{
+   return mGlobalNamespace.getType(pIdentifier);
 }
 
-void Environment::setValueAsInteger(int64_t pInteger, Value* pOutValue)
+Type* Environment::getType(const Identifier& pIdentifier, const CflatArgsVector(TypeUsage)& pTemplateTypes)
 {
-   const size_t typeUsageSize = pOutValue->mTypeUsage.getSize();
+   return mGlobalNamespace.getType(pIdentifier, pTemplateTypes);
+}
 
-   if(typeUsageSize == sizeof(int32_t))
-   {
-      const int32_t value = (int32_t)pInteger;
-      pOutValue->assign(&value);
-   }
-   else if(typeUsageSize == sizeof(int64_t))
-   {
-      pOutValue->assign(&pInteger);
-   }
-   else if(typeUsageSize == sizeof(int16_t))
-   {
-      const int16_t value = (int16_t)pInteger;
-      pOutValue->assign(&value);
-   }
-   else if(typeUsageSize == sizeof(int8_t))
-   {
-      const int8_t value = (int8_t)pInteger;
-      pOutValue->assign(&value);
-   }
-   else
-   {
-      CflatAssert(false); // Unsupported
-   }
+TypeUsage Environment::getTypeUsage(const char* pTypeName, Namespace* pNamespace)
+{
+   Memory::AllocatorScope allocatorScope(mAllocator);
+
+   mTypesParsingContext.mTokenIndex = 0u;
+
+   mTypesParsingContext.mNamespaceStack.clear();
+   mTypesParsingContext.mNamespaceStack.push_back(pNamespace ? pNamespace : &mGlobalNamespace);
+
+   mTypesParsingContext.mCode = pTypeName;
+   Tokenizer::tokenize(pTypeName, mTypesParsingContext.mTokens);
+   matchBrackets(mTypesParsingContext);
+
+   return parseTypeUsage(mTypesParsingContext, 0u);
 }
 
-void Environment::setValueAsDecimal(double pDecimal, Value* pOutValue)
+Function* Environment::registerFunction(const Identifier& pIdentifier)
 {
-   const size_t typeUsageSize = pOutValue->mTypeUsage.getSize();
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   if(typeUsageSize == sizeof(float))
-   {
-      const float value = (float)pDecimal;
-      pOutValue->assign(&value);
-   }
-   else if(typeUsageSize == sizeof(double))
-   {
-      pOutValue->assign(&pDecimal);
-   }
-   else
-   {
-      CflatAssert(false); // Unsupported
-   }
+   return mGlobalNamespace.registerFunction(pIdentifier);
 }
 
-void Environment::getTypeFullName(Type* pType, CflatSTLString* pOutString)
+Function* Environment::getFunction(const Identifier& pIdentifier)
 {
-   if(pType->mNamespace->getFullIdentifier().mHash != 0u)
-   {
-      pOutString->append(pType->mNamespace->getFullIdentifier().mName);
-      pOutString->append("::");
-   }
+   return mGlobalNamespace.getFunction(pIdentifier);
+}
 
-   pOutString->append(pType->mIdentifier.mName);
+Function* Environment::getFunction(const Identifier& pIdentifier,
+   const CflatArgsVector(TypeUsage)& pParameterTypes)
+{
+   return mGlobalNamespace.getFunction(pIdentifier, pParameterTypes);
+}
 
-   if(pType->mCategory == TypeCategory::StructOrClass)
-   {
-      Struct* structOrClassType = static_cast<Struct*>(pType);
-      
-      if(!structOrClassType->mTemplateTypes.empty())
-      {
-         pOutString->append("<");
+Function* Environment::getFunction(const Identifier& pIdentifier,
+   const CflatArgsVector(Value)& pArguments)
+{
+   return mGlobalNamespace.getFunction(pIdentifier, pArguments);
+}
 
-         for(size_t i = 0u; i < structOrClassType->mTemplateTypes.size(); i++)
-         {
-            if(i > 0u)
-            {
-               pOutString->append(", ");
-            }
+CflatSTLVector(Function*)* Environment::getFunctions(const Identifier& pIdentifier)
+{
+   return mGlobalNamespace.getFunctions(pIdentifier);
+}
 
-            getTypeFullName(structOrClassType->mTemplateTypes[i].mType, pOutString);
-         }
+void Environment::setVariable(const TypeUsage& pTypeUsage, const Identifier& pIdentifier,
+   const Value& pValue)
+{
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-         pOutString->append(">");
-      }
-   }
+   mGlobalNamespace.setVariable(pTypeUsage, pIdentifier, pValue);
 }
 
-Method* Environment::getDefaultConstructor(Type* pType)
+Value* Environment::getVariable(const Identifier& pIdentifier)
 {
-   CflatAssert(pType->mCategory == TypeCategory::StructOrClass);
+   return mGlobalNamespace.getVariable(pIdentifier);
+}
 
-   Method* defaultConstructor = nullptr;
-   Struct* type = static_cast<Struct*>(pType);
+ExecutionContext* Environment::createExecutionContext()
+{
+   return createExecutionContext(mExecutionContext.mStack.mSegmentSize,
+      mExecutionContext.mStack.mGrowable);
+}
 
-   for(size_t i = 0u; i < type->mMethods.size(); i++)
-   {
-      if(type->mMethods[i].mParameters.empty() &&
-         type->mMethods[i].mIdentifier.mHash == 0u)
-      {
-         defaultConstructor = &type->mMethods[i];
-         break;
-      }
-   }
+ExecutionContext* Environment::createExecutionContext(size_t pStackSize, bool pGrowableStack)
+{
+   Memory::AllocatorScope allocatorScope(mAllocator);
+
+   ExecutionContext* context =
+      (ExecutionContext*)CflatAllocate(sizeof(ExecutionContext), Values);
+   CflatInvokeCtor(ExecutionContext, context)(&mGlobalNamespace, pStackSize, pGrowableStack);
+   mExecutionContexts.push_back(context);
 
-   return defaultConstructor;
+   return context;
 }
 
-Method* Environment::getDestructor(Type* pType)
+void Environment::destroyExecutionContext(ExecutionContext* pContext)
 {
-   CflatAssert(pType->mCategory == TypeCategory::StructOrClass);
+   CflatAssert(pContext);
+   CflatAssert(pContext->mCallStack.empty());
 
-   Method* destructor = nullptr;
-   Struct* type = static_cast<Struct*>(pType);
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   for(size_t i = 0u; i < type->mMethods.size(); i++)
+   if(gExecutionContextBinding.mContext == pContext)
    {
-      if(type->mMethods[i].mIdentifier.mName[0] == '~')
+      gExecutionContextBinding.mEnvironment = nullptr;
+      gExecutionContextBinding.mContext = nullptr;
+   }
+
+   for(size_t i = 0u; i < mExecutionContexts.size(); i++)
+   {
+      if(mExecutionContexts[i] == pContext)
       {
-         destructor = &type->mMethods[i];
+         mExecutionContexts.erase(mExecutionContexts.begin() + i);
          break;
       }
    }
 
-   return destructor;
+   CflatInvokeDtor(ExecutionContext, pContext);
+   CflatDeallocate(pContext);
 }
 
-Method* Environment::findConstructor(Type* pType, const CflatArgsVector(TypeUsage)& pParameterTypes)
+void Environment::setExecutionContext(ExecutionContext* pContext)
 {
-   const Identifier emptyId;
-   return findMethod(pType, emptyId, pParameterTypes);
+   // unbinding leaves the binding of any other environment in place
+   if(!pContext && gExecutionContextBinding.mEnvironment != this)
+   {
+      return;
+   }
+
+   gExecutionContextBinding.mEnvironment = pContext ? this : nullptr;
+   gExecutionContextBinding.mContext = pContext;
 }
 
-Method* Environment::findConstructor(Type* pType, const CflatArgsVector(Value)& pArguments)
+Environment::ExecutionContextScope::ExecutionContextScope(Environment* pEnvironment,
+   ExecutionContext* pContext)
+   : mPreviousEnvironment(gExecutionContextBinding.mEnvironment)
+   , mPreviousContext(gExecutionContextBinding.mContext)
 {
-   const Identifier emptyId;
-   return findMethod(pType, emptyId, pArguments);
+   gExecutionContextBinding.mEnvironment = pEnvironment;
+   gExecutionContextBinding.mContext = pContext;
 }
 
-Method* Environment::findMethod(Type* pType, const Identifier& pIdentifier)
+Environment::ExecutionContextScope::~ExecutionContextScope()
 {
-   CflatAssert(pType->mCategory == TypeCategory::StructOrClass);
+   gExecutionContextBinding.mEnvironment = mPreviousEnvironment;
+   gExecutionContextBinding.mContext = mPreviousContext;
+}
 
-   Method* method = nullptr;
-   Struct* type = static_cast<Struct*>(pType);
+void Environment::voidFunctionCall(Function* pFunction)
+{
+   CflatAssert(pFunction);
 
-   for(size_t i = 0u; i < type->mMethods.size(); i++)
-   {
-      if(type->mMethods[i].mIdentifier == pIdentifier)
-      {
-         method = &type->mMethods[i];
-         break;
-      }
-   }
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   return method;
+   getCurrentExecutionContext().mErrorMessage.clear();
+
+   Value returnValue;
+
+   CflatArgsVector(Value) args;
+   pFunction->execute(args, &returnValue);
 }
 
-Method* Environment::findMethod(Type* pType, const Identifier& pIdentifier,
-   const CflatArgsVector(TypeUsage)& pParameterTypes, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+ExecutionStatus Environment::beginSlicedFunctionCall(Function* pFunction,
+   const void* const* pArgumentsData, Value* pOutReturnValue, const ExecutionBudget& pBudget)
 {
-   CflatAssert(pType->mCategory == TypeCategory::StructOrClass);
-
-   Method* method = nullptr;
-   Struct* type = static_cast<Struct*>(pType);
+   CflatAssert(pFunction);
+   CflatAssert(pFunction->execute);
+   CflatAssert(pFunction->mParameters.empty() || pArgumentsData);
 
-   // first pass: look for a perfect argument match
-   for(size_t i = 0u; i < type->mMethods.size(); i++)
-   {
-      if(type->mMethods[i].mIdentifier == pIdentifier &&         
-         type->mMethods[i].mParameters.size() == pParameterTypes.size() &&
-         type->mMethods[i].mTemplateTypes == pTemplateTypes)
-      {
-         bool parametersMatch = true;
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-         for(size_t j = 0u; j < pParameterTypes.size(); j++)
-         {
-            const TypeHelper::Compatibility compatibility =
-               TypeHelper::getCompatibility(type->mMethods[i].mParameters[j], pParameterTypes[j]);
+   ExecutionContext& context = getCurrentExecutionContext();
+   CflatAssert(!context.mSlicedCall.mFunction);
 
-            if(compatibility != TypeHelper::Compatibility::PerfectMatch)
-            {
-               parametersMatch = false;
-               break;
-            }
-         }
+   context.mErrorMessage.clear();
 
-         if(parametersMatch)
-         {
-            method = &type->mMethods[i];
-            break;
-         }
-      }
+   // only bytecode can get suspended, so the budget could not be honored otherwise
+   if(!pFunction->mDeclaration || !pFunction->mDeclaration->mBytecode)
+   {
+      context.mErrorMessage.assign("[Runtime Error] '");
+      context.mErrorMessage.append(pFunction->mIdentifier.mName);
+      context.mErrorMessage.append("': time-sliced calls require a script function loaded in bytecode mode");
+      return ExecutionStatus::Failed;
    }
 
-   // second pass: look for a compatible argument match
-   if(!method)
-   {
-      for(size_t i = 0u; i < type->mMethods.size(); i++)
-      {
-         if(type->mMethods[i].mIdentifier == pIdentifier &&
-            type->mMethods[i].mParameters.size() == pParameterTypes.size() &&
-            type->mMethods[i].mTemplateTypes == pTemplateTypes)
-         {
-            bool parametersMatch = true;
+   // the parameters get copied when the call begins, so the arguments can refer to the data
+   // directly instead of taking space in the stack below the frame of the function
+   CflatArgsVector(Value) args;
+   args.resize(pFunction->mParameters.size());
 
-            for(size_t j = 0u; j < pParameterTypes.size(); j++)
-            {
-               const TypeHelper::Compatibility compatibility =
-                  TypeHelper::getCompatibility(type->mMethods[i].mParameters[j], pParameterTypes[j]);
+   for(size_t i = 0u; i < pFunction->mParameters.size(); i++)
+   {
+      args[i].initExternal(pFunction->mParameters[i]);
+      args[i].set(pArgumentsData[i]);
+   }
 
-               if(compatibility == TypeHelper::Compatibility::Incompatible)
-               {
-                  parametersMatch = false;
-                  break;
-               }
-            }
+   SlicedCall& slicedCall = context.mSlicedCall;
+   slicedCall.mFunction = pFunction;
+   slicedCall.mReturnValue = pOutReturnValue;
+   slicedCall.mCallDepth = context.mCallStack.size() + 1u;
+   startExecutionBudget(slicedCall, pBudget);
 
-            if(parametersMatch)
-            {
-               method = &type->mMethods[i];
-               break;
-            }
-         }
-      }
-   }
+   callFunction(context, pFunction, args, pOutReturnValue);
 
-   return method;
+   return endSlicedFunctionCall(context);
 }
 
-Method* Environment::findMethod(Type* pType, const Identifier& pIdentifier,
-   const CflatArgsVector(Value)& pArguments, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+ExecutionStatus Environment::resumeSlicedFunctionCall(const ExecutionBudget& pBudget)
 {
-   CflatArgsVector(TypeUsage) typeUsages;
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   for(size_t i = 0u; i < pArguments.size(); i++)
-   {
-      typeUsages.push_back(pArguments[i].mTypeUsage);
-   }
+   ExecutionContext& context = getCurrentExecutionContext();
+   SlicedCall& slicedCall = context.mSlicedCall;
+
+   CflatAssert(slicedCall.mFunction && slicedCall.mSuspended);
+   CflatAssert(context.mCallStack.size() == slicedCall.mCallDepth);
 
-   return findMethod(pType, pIdentifier, typeUsages);
-}
+   context.mErrorMessage.clear();
 
-void Environment::initArgumentsForFunctionCall(Function* pFunction, CflatArgsVector(Value)& pArgs)
-{
-   pArgs.resize(pFunction->mParameters.size());
+   slicedCall.mSuspended = false;
+   startExecutionBudget(slicedCall, pBudget);
 
-   for(size_t i = 0u; i < pFunction->mParameters.size(); i++)
+   if(mTimerHook)
    {
-      const TypeUsage& typeUsage = pFunction->mParameters[i];
+      resetTimerHook(context);
+   }
 
-      if(typeUsage.isReference())
-      {
-         pArgs[i].initExternal(typeUsage);
-      }
-      else
-      {
-         pArgs[i].initOnStack(typeUsage, &mExecutionContext.mStack);
-      }
+   Function* function = slicedCall.mFunction;
+   execute(context, *function->mDeclaration->mBytecode, slicedCall.mInstructionIndex,
+      slicedCall.mBaseBlockLevel, slicedCall.mBaseScopeLevel);
+
+   if(!slicedCall.mSuspended)
+   {
+      endFunctionBody(context, function, slicedCall.mPreviousLocalFrameBase, slicedCall.mProfiler,
+         slicedCall.mReturnValue);
    }
+
+   return endSlicedFunctionCall(context);
 }
 
-void Environment::execute(ExecutionContext& pContext, Statement* pStatement)
+void Environment::cancelSlicedFunctionCall()
 {
-   if(!mErrorMessage.empty())
-      return;
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   pContext.mProgram = pStatement->mProgram;
+   ExecutionContext& context = getCurrentExecutionContext();
+   SlicedCall& slicedCall = context.mSlicedCall;
 
-   pContext.mCallStack.back().mProgram = pStatement->mProgram;
-   pContext.mCallStack.back().mLine = pStatement->mLine;
+   CflatAssert(slicedCall.mFunction && slicedCall.mSuspended);
+   CflatAssert(context.mCallStack.size() == slicedCall.mCallDepth);
 
-   if(mExecutionHook)
+   while(context.mScopeLevel > slicedCall.mBaseScopeLevel)
    {
-      mExecutionHook(this, pContext.mCallStack);
+      decrementScopeLevel(context);
    }
 
-   switch(pStatement->getType())
+   while(context.mBlockLevel > slicedCall.mBaseBlockLevel)
    {
-   case StatementType::Expression:
-      {
-         StatementExpression* statement = static_cast<StatementExpression*>(pStatement);
+      decrementBlockLevel(context);
+   }
 
-         Value unusedValue;
-         unusedValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, statement->mExpression, &unusedValue);
-      }
-      break;
-   case StatementType::Block:
-      {
-         StatementBlock* statement = static_cast<StatementBlock*>(pStatement);
+   slicedCall.mSuspended = false;
+   endFunctionBody(context, slicedCall.mFunction, slicedCall.mPreviousLocalFrameBase,
+      slicedCall.mProfiler, nullptr);
+   endSlicedFunctionCall(context);
+}
 
-         incrementBlockLevel(pContext);
+size_t Environment::batchFunctionCall(Function* pFunction, size_t pElementsCount,
+   const void* const* pArgumentsData, const size_t* pArgumentsStrides,
+   void* pOutReturnValuesData, size_t pReturnValuesStride, CflatSTLVector(BatchCallError)* pOutErrors)
+{
+   CflatAssert(pFunction);
+   CflatAssert(pFunction->execute);
+   CflatAssert(pFunction->mParameters.empty() || (pArgumentsData && pArgumentsStrides));
 
-         if(statement->mAlterScope)
-         {
-            incrementScopeLevel(pContext);
-         }
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-         for(size_t i = 0u; i < statement->mStatements.size(); i++)
-         {
-            execute(pContext, statement->mStatements[i]);
+   ExecutionContext& context = getCurrentExecutionContext();
+   context.mErrorMessage.clear();
 
-            if(pContext.mJumpStatement != JumpStatement::None)
-            {
-               break;
-            }
-         }
+   const bool mustReturnValue =
+      pFunction->mReturnTypeUsage.mType && pFunction->mReturnTypeUsage.mType != mTypeVoid;
 
-         if(statement->mAlterScope)
-         {
-            decrementScopeLevel(pContext);
-         }
+   Value returnValue;
 
-         decrementBlockLevel(pContext);
-      }
-      break;
-   case StatementType::UsingDirective:
-      {
-         StatementUsingDirective* statement =
-            static_cast<StatementUsingDirective*>(pStatement);
+   if(mustReturnValue)
+   {
+      returnValue.initOnStack(pFunction->mReturnTypeUsage, &context.mStack);
+   }
 
-         if(statement->mNamespace)
-         {
-            UsingDirective usingDirective(statement->mNamespace);
-            usingDirective.mBlockLevel = pContext.mBlockLevel;
-            pContext.mUsingDirectives.push_back(usingDirective);
-         }
-         else
-         {
-            registerTypeAlias(pContext, statement->mAliasIdentifier, statement->mAliasTypeUsage);
-         }
-      }
-      break;
-   case StatementType::TypeDefinition:
-      {
-         StatementTypeDefinition* statement =
-            static_cast<StatementTypeDefinition*>(pStatement);
+   CflatArgsVector(Value) args;
+   initArgumentsForFunctionCall(pFunction, args);
 
-         TypeAlias typeAlias(statement->mAlias, statement->mReferencedTypeUsage);
-         typeAlias.mScopeLevel = pContext.mScopeLevel;
-         pContext.mTypeAliases.push_back(typeAlias);
-      }
-      break;
-   case StatementType::NamespaceDeclaration:
+   // script functions are called directly, without going through their type-erased entry point
+   const bool scriptFunction = pFunction->mDeclaration != nullptr;
+
+   CflatSTLString lastErrorMessage;
+   size_t failedElementsCount = 0u;
+
+   for(size_t elementIndex = 0u; elementIndex < pElementsCount; elementIndex++)
+   {
+      for(size_t i = 0u; i < args.size(); i++)
       {
-         StatementNamespaceDeclaration* statement =
-            static_cast<StatementNamespaceDeclaration*>(pStatement);
-         Namespace* ns =
-            pContext.mNamespaceStack.back()->requestNamespace(statement->mNamespaceIdentifier);
+         args[i].set((const char*)pArgumentsData[i] + elementIndex * pArgumentsStrides[i]);
+      }
 
-         pContext.mNamespaceStack.push_back(ns);
-         execute(pContext, statement->mBody);
-         pContext.mNamespaceStack.pop_back();
+      if(scriptFunction)
+      {
+         callFunction(context, pFunction, args, &returnValue);
       }
-      break;
-   case StatementType::VariableDeclaration:
+      else
       {
-         StatementVariableDeclaration* statement = static_cast<StatementVariableDeclaration*>(pStatement);
-
-         const bool isStaticVariable =
-            statement->mStatic && pContext.mScopeLevel > 0u && !statement->mTypeUsage.isConst();
-         Instance* instance = isStaticVariable
-            ? registerStaticInstance(pContext, statement->mTypeUsage, statement->mVariableIdentifier, statement)
-            : registerInstance(pContext, statement->mTypeUsage, statement->mVariableIdentifier);
-
-         const bool isStructOrClassInstance =
-            instance->mTypeUsage.mType &&
-            instance->mTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
-            !instance->mTypeUsage.isPointer() &&
-            !instance->mTypeUsage.isReference();
+         pFunction->execute(args, &returnValue);
+      }
 
-         if(isStructOrClassInstance)
+      if(!context.mErrorMessage.empty())
+      {
+         if(pOutErrors)
          {
-            Method* defaultCtor = getDefaultConstructor(instance->mTypeUsage.mType);
-
-            if(defaultCtor)
-            {
-               instance->mValue.mTypeUsage = instance->mTypeUsage;
-
-               Value thisPtr;
-               thisPtr.mValueInitializationHint = ValueInitializationHint::Stack;
-               getAddressOfValue(pContext, instance->mValue, &thisPtr);
-
-               CflatArgsVector(Value) args;
-               defaultCtor->execute(thisPtr, args, nullptr);
-            }
+            pOutErrors->emplace_back();
+            pOutErrors->back().mElementIndex = elementIndex;
+            pOutErrors->back().mErrorMessage = context.mErrorMessage;
          }
 
-         if(statement->mInitialValue)
-         {
-            Value initialValue;
-            initialValue.mTypeUsage = instance->mTypeUsage;
-            initialValue.mValueInitializationHint = ValueInitializationHint::Stack;
-            evaluateExpression(pContext, statement->mInitialValue, &initialValue);
-            assignValue(pContext, initialValue, &instance->mValue, true);
-         }
+         lastErrorMessage.swap(context.mErrorMessage);
+         context.mErrorMessage.clear();
+         failedElementsCount++;
       }
-      break;
-   case StatementType::FunctionDeclaration:
+      else if(mustReturnValue && pOutReturnValuesData)
       {
-         StatementFunctionDeclaration* statement = static_cast<StatementFunctionDeclaration*>(pStatement);
+         memcpy((char*)pOutReturnValuesData + elementIndex * pReturnValuesStride,
+            returnValue.mValueBuffer, returnValue.mTypeUsage.getSize());
+      }
+   }
 
-         CflatArgsVector(TypeUsage) parameterTypes;
-         toArgsVector(statement->mParameterTypes, parameterTypes);
+   while(!args.empty())
+   {
+      args.pop_back();
+   }
 
-         Namespace* functionNS = pContext.mNamespaceStack.back();
-         Function* function = functionNS->getFunction(statement->mFunctionIdentifier, parameterTypes);
-         CflatAssert(function);
+   // the error of the last element which failed remains available through getErrorMessage
+   context.mErrorMessage.swap(lastErrorMessage);
 
-         function->mProgram = statement->mProgram;
-         function->mLine = statement->mLine;
+   return failedElementsCount;
+}
 
-         statement->mFunction = function;
+Hash Environment::getMacrosHash()
+{
+   CflatSTLString macrosSignature;
 
-         if(statement->mBody)
-         {
-            function->mUsingDirectives = pContext.mUsingDirectives;
-            function->execute =
-               [this, &pContext, function, functionNS, statement]
-               (const CflatArgsVector(Value)& pArguments, Value* pOutReturnValue)
-            {
-               CflatAssert(function->mParameters.size() == pArguments.size());
+   for(MacrosRegistry::const_iterator it = mMacros.begin(); it != mMacros.end(); it++)
+   {
+      const Macro& macro = it->second;
+      macrosSignature.append(macro.mName);
+      macrosSignature.push_back((char)('0' + macro.mParametersCount));
 
-               const bool mustReturnValue =
-                  function->mReturnTypeUsage.mType && function->mReturnTypeUsage.mType != mTypeVoid;
-               
-               if(mustReturnValue)
-               {
-                  if(pOutReturnValue)
-                  {
-                     assertValueInitialization(pContext, function->mReturnTypeUsage, pOutReturnValue);
-                  }
+      for(size_t j = 0u; j < macro.mBody.size(); j++)
+      {
+         macrosSignature.push_back('\n');
+         macrosSignature.append(macro.mBody[j]);
+      }
 
-                  pContext.mReturnValues.emplace_back();
-                  pContext.mReturnValues.back().initOnStack(function->mReturnTypeUsage, &pContext.mStack);
-               }
+      macrosSignature.push_back('\n');
+   }
 
-               pContext.mNamespaceStack.push_back(functionNS);
+   return hash(macrosSignature.c_str());
+}
 
-               for(size_t i = 0u; i < pArguments.size(); i++)
-               {
-                  const TypeUsage parameterType = statement->mParameterTypes[i];
-                  const Identifier& parameterIdentifier = statement->mParameterIdentifiers[i];
+bool Environment::readPrecompiledData(ParsingContext& pContext, const char* pCode,
+   const void* pData, size_t pDataSize)
+{
+   PrecompiledDataHeader header;
 
-                  pContext.mScopeLevel++;
-                  Instance* argumentInstance =
-                     registerInstance(pContext, parameterType, parameterIdentifier);
-                  pContext.mScopeLevel--;
+   if(!readPrecompiledDataHeader(pData, pDataSize, &header) ||
+      header.mCodeHash != hash(pCode) ||
+      header.mMacrosHash != getMacrosHash())
+   {
+      return false;
+   }
 
-                  assignValue(pContext, pArguments[i], &argumentInstance->mValue, true);
-               }
+   const char* cursor = (const char*)pData + sizeof(PrecompiledDataHeader);
+   const char* tokensData = cursor;
+   cursor += header.mTokensCount * sizeof(PrecompiledToken);
 
-               for(size_t i = 0u; i < function->mUsingDirectives.size(); i++)
-               {
-                  pContext.mUsingDirectives.push_back(function->mUsingDirectives[i]);
-                  pContext.mUsingDirectives.back().mBlockLevel = 0u;
-               }
+   // the tokens point straight into the data, which remains valid until the program is loaded
+   const char* tokensCode = cursor;
+   cursor += header.mTokensCodeLength;
 
-               pContext.mCallStack.emplace_back(statement->mProgram, function);
+   if(header.mTokensCodeLength == 0u || tokensCode[header.mTokensCodeLength - 1u] != '\0')
+   {
+      return false;
+   }
 
-               execute(pContext, statement->mBody);
+   const char* dataEnd = (const char*)pData + pDataSize;
 
-               pContext.mCallStack.pop_back();
+   for(uint32_t i = 0u; i < header.mMacroDefinitionsCount; i++)
+   {
+      const char* definition = cursor;
+      const char* body = definition + strnlen(definition, dataEnd - definition) + 1;
 
-               for(size_t i = 0u; i < function->mUsingDirectives.size(); i++)
-               {
-                  pContext.mUsingDirectives.pop_back();
-               }
+      if(body >= dataEnd)
+      {
+         return false;
+      }
 
-               if(mExecutionHook && pContext.mCallStack.empty())
-               {
-                  mExecutionHook(this, pContext.mCallStack);
-               }
+      cursor = body + strnlen(body, dataEnd - body) + 1;
 
-               pContext.mNamespaceStack.pop_back();
+      if(cursor > dataEnd)
+      {
+         return false;
+      }
 
-               if(mustReturnValue)
-               {
-                  if(pOutReturnValue)
-                  {
-                     pOutReturnValue->set(pContext.mReturnValues.back().mValueBuffer);
-                  }
+      defineMacro(definition, body);
 
-                  pContext.mReturnValues.pop_back();
-               }
+      pContext.mMacroDefinitions.emplace_back(definition);
+      pContext.mMacroDefinitions.emplace_back(body);
+   }
 
-               pContext.mJumpStatement = JumpStatement::None;
-            };
-         }
-      }
-      break;
-   case StatementType::If:
-      {
-         StatementIf* statement = static_cast<StatementIf*>(pStatement);
+   pContext.mCode = pCode;
+   pContext.mTokens.resize(header.mTokensCount);
 
-         Value conditionValue;
-         conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, statement->mCondition, &conditionValue);
+   for(uint32_t i = 0u; i < header.mTokensCount; i++)
+   {
+      PrecompiledToken precompiledToken;
+      memcpy(&precompiledToken, tokensData + i * sizeof(PrecompiledToken), sizeof(PrecompiledToken));
 
-         if(getValueAsInteger(conditionValue))
-         {
-            execute(pContext, statement->mIfStatement);
-         }
-         else if(statement->mElseStatement)
-         {
-            execute(pContext, statement->mElseStatement);
-         }
-      }
-      break;
-   case StatementType::Switch:
+      if((precompiledToken.mOffset + precompiledToken.mLength) >= header.mTokensCodeLength)
       {
-         StatementSwitch* statement = static_cast<StatementSwitch*>(pStatement);
+         pContext.mTokens.clear();
+         return false;
+      }
 
-         Value conditionValue;
-         conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, statement->mCondition, &conditionValue);
+      Token& token = pContext.mTokens[i];
+      token.mType = (TokenType)precompiledToken.mType;
+      token.mStart = tokensCode + precompiledToken.mOffset;
+      token.mLength = precompiledToken.mLength;
+      token.mLine = precompiledToken.mLine;
+   }
 
-         const int64_t conditionValueAsInteger = getValueAsInteger(conditionValue);
-         bool statementExecution = false;
+   matchBrackets(pContext);
 
-         for(size_t i = 0u; i < statement->mCaseSections.size(); i++)
-         {
-            const StatementSwitch::CaseSection& caseSection = statement->mCaseSections[i];
+   return true;
+}
 
-            if(!statementExecution)
-            {
-               // case
-               if(caseSection.mExpression)
-               {
-                  Value caseValue;
-                  caseValue.mValueInitializationHint = ValueInitializationHint::Stack;
-                  evaluateExpression(pContext, caseSection.mExpression, &caseValue);
+void Environment::writePrecompiledData(ParsingContext& pContext, const char* pCode,
+   Hash pMacrosHash, CflatSTLVector(char)& pOutData)
+{
+   PrecompiledDataHeader header;
+   header.mMagic = kPrecompiledDataMagic;
+   header.mVersion = kPrecompiledDataVersion;
+   header.mCodeHash = hash(pCode);
+   header.mMacrosHash = pMacrosHash;
+   // the tokens point into either the source code or the macro expansions, so the code of each
+   // one gets written separately
+   size_t tokensCodeLength = 1u;
 
-                  const int64_t caseValueAsInteger = getValueAsInteger(caseValue);
+   for(size_t i = 0u; i < pContext.mTokens.size(); i++)
+   {
+      tokensCodeLength += pContext.mTokens[i].mLength + 1u;
+   }
 
-                  if(caseValueAsInteger == conditionValueAsInteger)
-                  {
-                     statementExecution = true;
-                  }
-               }
-               // default
-               else
-               {
-                  statementExecution = true;
-               }
-            }
+   header.mTokensCount = (uint32_t)pContext.mTokens.size();
+   header.mTokensCodeLength = (uint32_t)tokensCodeLength;
+   header.mMacroDefinitionsCount = (uint32_t)(pContext.mMacroDefinitions.size() / 2u);
 
-            if(statementExecution)
-            {
-               for(size_t j = 0u; j < caseSection.mStatements.size(); j++)
-               {
-                  execute(pContext, caseSection.mStatements[j]);
+   size_t dataSize = sizeof(PrecompiledDataHeader) +
+      pContext.mTokens.size() * sizeof(PrecompiledToken) +
+      tokensCodeLength;
 
-                  if(pContext.mJumpStatement == JumpStatement::Break)
-                  {
-                     break;
-                  }
-               }
-            }
+   for(size_t i = 0u; i < pContext.mMacroDefinitions.size(); i++)
+   {
+      dataSize += pContext.mMacroDefinitions[i].length() + 1u;
+   }
 
-            if(pContext.mJumpStatement == JumpStatement::Break)
-            {
-               pContext.mJumpStatement = JumpStatement::None;
-               break;
-            }
-         }
-      }
-      break;
-   case StatementType::While:
-      {
-         StatementWhile* statement = static_cast<StatementWhile*>(pStatement);
+   pOutData.resize(dataSize);
+   char* cursor = &pOutData[0];
 
-         Value conditionValue;
-         conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
-         evaluateExpression(pContext, statement->mCondition, &conditionValue);
+   memcpy(cursor, &header, sizeof(PrecompiledDataHeader));
+   cursor += sizeof(PrecompiledDataHeader);
 
-         while(getValueAsInteger(conditionValue))
-         {
-            execute(pContext, statement->mLoopStatement);
+   char* tokensCode = cursor + pContext.mTokens.size() * sizeof(PrecompiledToken);
+   size_t tokensCodeOffset = 0u;
 
-            if(pContext.mJumpStatement == JumpStatement::Continue)
-            {
-               pContext.mJumpStatement = JumpStatement::None;
-            }
-            else if(pContext.mJumpStatement == JumpStatement::Break)
-            {
-               pContext.mJumpStatement = JumpStatement::None;
-               break;
-            }
+   for(size_t i = 0u; i < pContext.mTokens.size(); i++)
+   {
+      const Token& token = pContext.mTokens[i];
 
-            evaluateExpression(pContext, statement->mCondition, &conditionValue);
-         }
-      }
-      break;
-   case StatementType::DoWhile:
-      {
-         StatementDoWhile* statement = static_cast<StatementDoWhile*>(pStatement);
+      memcpy(tokensCode + tokensCodeOffset, token.mStart, token.mLength);
+      tokensCode[tokensCodeOffset + token.mLength] = '\n';
 
-         Value conditionValue;
-         conditionValue.mValueInitializationHint = ValueInitializationHint::Stack;
+      PrecompiledToken precompiledToken;
+      precompiledToken.mOffset = (uint32_t)tokensCodeOffset;
+      precompiledToken.mLength = (uint32_t)token.mLength;
+      precompiledToken.mLine = token.mLine;
+      precompiledToken.mType = (uint8_t)token.mType;
+      precompiledToken.mPadding = 0u;
 
-         do
-         {
-            execute(pContext, statement->mLoopStatement);
+      memcpy(cursor, &precompiledToken, sizeof(PrecompiledToken));
+      cursor += sizeof(PrecompiledToken);
 
-            if(pContext.mJumpStatement == JumpStatement::Continue)
-            {
-               pContext.mJumpStatement = JumpStatement::None;
-            }
-            else if(pContext.mJumpStatement == JumpStatement::Break)
-            {
-               pContext.mJumpStatement = JumpStatement::None;
-               break;
-            }
+      tokensCodeOffset += token.mLength + 1u;
+   }
 
-            evaluateExpression(pContext, statement->mCondition, &conditionValue);
-         }
-         while(getValueAsInteger(conditionValue));
-      }
-      break;
-   case StatementType::For:
-      {
-         StatementFor* statement = static_cast<StatementFor*>(pStatement);
+   tokensCode[tokensCodeOffset] = '\0';
+   cursor += tokensCodeLength;
 
-         incrementScopeLevel(pContext);
+   for(size_t i = 0u; i < pContext.mMacroDefinitions.size(); i++)
+   {
+      const CflatSTLString& macroDefinition = pContext.mMacroDefinitions[i];
+      memcpy(cursor, macroDefinition.c_str(), macroDefinition.length() + 1u);
+      cursor += macroDefinition.length() + 1u;
+   }
+}
 
-         if(statement->mInitialization)
-         {
-            execute(pContext, statement->mInitialization);
-         }
+bool Environment::load(const char* pProgramName, const char* pCode,
+   const void* pPrecompiledData, size_t pPrecompiledDataSize,
+   CflatSTLVector(char)* pOutPrecompiledData)
+{
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-         {
-            const bool defaultConditionValue = true;
+   const Identifier programIdentifier(pProgramName);
 
-            Value conditionValue;
-            conditionValue.initOnStack(mTypeUsageBool, &pContext.mStack);
-            conditionValue.set(&defaultConditionValue);
+   Program* program = (Program*)CflatAllocate(sizeof(Program), SyntaxTree);
+   CflatInvokeCtor(Program, program);
 
-            bool conditionMet = defaultConditionValue;
+   program->mIdentifier = programIdentifier;
 
-            if(statement->mCondition)
-            {
-               evaluateExpression(pContext, statement->mCondition, &conditionValue);
-               conditionMet = getValueAsInteger(conditionValue) != 0;
-            }
+   mErrorMessage.clear();
+   mExecutionContext.mErrorMessage.clear();
 
-            while(conditionMet)
-            {
-               execute(pContext, statement->mLoopStatement);
+   ParsingContext parsingContext(&mGlobalNamespace);
+   parsingContext.mProgram = program;
+   parsingContext.mArena = &program->mArena;
 
-               if(pContext.mJumpStatement == JumpStatement::Continue)
-               {
-                  pContext.mJumpStatement = JumpStatement::None;
-               }
-               else if(pContext.mJumpStatement == JumpStatement::Break)
-               {
-                  pContext.mJumpStatement = JumpStatement::None;
-                  break;
-               }
+   if(!readPrecompiledData(parsingContext, pCode, pPrecompiledData, pPrecompiledDataSize))
+   {
+      parsingContext.mMacroDefinitions.clear();
 
-               if(statement->mIncrement)
-               {
-                  Value unusedValue;
-                  evaluateExpression(pContext, statement->mIncrement, &unusedValue);
-               }
+      const Hash macrosHash = pOutPrecompiledData ? getMacrosHash() : 0u;
 
-               if(statement->mCondition)
-               {
-                  evaluateExpression(pContext, statement->mCondition, &conditionValue);
-                  conditionMet = getValueAsInteger(conditionValue) != 0;
-               }
-            }
-         }
+      preprocess(parsingContext, pCode);
 
-         decrementScopeLevel(pContext);
-      }
-      break;
-   case StatementType::ForRangeBased:
+      if(mErrorMessage.empty() && pOutPrecompiledData)
       {
-         StatementForRangeBased* statement = static_cast<StatementForRangeBased*>(pStatement);
+         writePrecompiledData(parsingContext, pCode, macrosHash, *pOutPrecompiledData);
+      }
+   }
 
-         incrementScopeLevel(pContext);
+   if(!mErrorMessage.empty())
+   {
+      CflatInvokeDtor(Program, program);
+      CflatDeallocate(program);
+      return false;
+   }
 
-         {
-            Instance* elementInstance = registerInstance(
-               pContext, statement->mVariableTypeUsage, statement->mVariableIdentifier);
+   return loadTokenized(parsingContext);
+}
 
-            Value collectionDataValue;
-            collectionDataValue.mValueInitializationHint = ValueInitializationHint::Stack;
-            getInstanceDataValue(pContext, statement->mCollection, &collectionDataValue);
+bool Environment::loadTokenized(ParsingContext& pContext)
+{
+   Program* program = pContext.mProgram;
+   const Identifier programIdentifier = program->mIdentifier;
 
-            Value collectionThisValue;
-            collectionThisValue.mValueInitializationHint = ValueInitializationHint::Stack;
-            getAddressOfValue(pContext, collectionDataValue, &collectionThisValue);
+   ProgramsRegistry::const_iterator it = mPrograms.find(programIdentifier.mHash);
 
-            if(collectionDataValue.mTypeUsage.isArray())
-            {
-               size_t elementIndex = 0u;
+   if(it != mPrograms.end() && !checkSuspendedSlicedCalls(it->second, nullptr))
+   {
+      CflatInvokeDtor(Program, program);
+      CflatDeallocate(program);
+      return false;
+   }
 
-               while(elementIndex < collectionDataValue.mTypeUsage.mArraySize)
-               {
-                  const size_t arrayElementSize = statement->mVariableTypeUsage.getSize();
-                  const char* arrayElementData =
-                     collectionDataValue.mValueBuffer + (arrayElementSize * elementIndex);
-                  elementInstance->mValue.set(arrayElementData);
+   parse(pContext);
 
-                  execute(pContext, statement->mLoopStatement);
+   // expressions evaluated while parsing (e.g. array sizes) report their errors as runtime errors
+   if(!mErrorMessage.empty() || !mExecutionContext.mErrorMessage.empty())
+   {
+      CflatInvokeDtor(Program, program);
+      CflatDeallocate(program);
+      return false;
+   }
 
-                  if(pContext.mJumpStatement == JumpStatement::Continue)
-                  {
-                     pContext.mJumpStatement = JumpStatement::None;
-                  }
-                  else if(pContext.mJumpStatement == JumpStatement::Break)
-                  {
-                     pContext.mJumpStatement = JumpStatement::None;
-                     break;
-                  }
+   // global statements always run on the environment's own context, and so do the script
+   // functions called from native functions they might invoke
+   {
+      ExecutionContextScope executionContextScope(this, &mExecutionContext);
+      execute(mExecutionContext, *program);
+   }
 
-                  elementIndex++;
-               }
-            }
-            else
-            {
-               Struct* collectionType = static_cast<Struct*>(collectionDataValue.mTypeUsage.mType);
+   it = mPrograms.find(programIdentifier.mHash);
 
-               Method* collectionBeginMethod =
-                  findMethod(collectionType, "begin", TypeUsage::kEmptyList);
-               Value iteratorValue;
-               iteratorValue.initOnStack(collectionBeginMethod->mReturnTypeUsage, &pContext.mStack);
-               collectionBeginMethod->execute(collectionThisValue, Value::kEmptyList, &iteratorValue);
+   if(it != mPrograms.end())
+   {
+      CflatInvokeDtor(Program, it->second);
+      CflatDeallocate(it->second);
+   }
 
-               Method* collectionEndMethod =
-                  findMethod(collectionType, "end", TypeUsage::kEmptyList);
-               Value collectionEndValue;
-               collectionEndValue.initOnStack(collectionEndMethod->mReturnTypeUsage, &pContext.mStack);
-               collectionEndMethod->execute(collectionThisValue, Value::kEmptyList, &collectionEndValue);
+   mPrograms[programIdentifier.mHash] = program;
 
-               Type* iteratorType = collectionBeginMethod->mReturnTypeUsage.mType;
+   if(!mExecutionContext.mErrorMessage.empty())
+   {
+      return false;
+   }
 
-               Value conditionValue;
-               conditionValue.initOnStack(mTypeUsageBool, &pContext.mStack);
-               applyBinaryOperator(pContext, iteratorValue, collectionEndValue, "!=", &conditionValue);
+   return true;
+}
 
-               while(CflatValueAs(&conditionValue, bool))
-               {
-                  applyUnaryOperator(pContext, iteratorValue, "*", &elementInstance->mValue);
+bool Environment::load(const char* pProgramName, const char* pCode)
+{
+   return load(pProgramName, pCode, nullptr, 0u, nullptr);
+}
 
-                  execute(pContext, statement->mLoopStatement);
+bool Environment::load(const char* pFilePath)
+{
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-                  if(pContext.mJumpStatement == JumpStatement::Continue)
-                  {
-                     pContext.mJumpStatement = JumpStatement::None;
-                  }
-                  else if(pContext.mJumpStatement == JumpStatement::Break)
-                  {
-                     pContext.mJumpStatement = JumpStatement::None;
-                     break;
-                  }
+   SourceFile sourceFile;
 
-                  applyUnaryOperator(pContext, iteratorValue, "++", &iteratorValue);
-                  applyBinaryOperator(pContext, iteratorValue, collectionEndValue, "!=", &conditionValue);
-               }
-            }
-         }
+   if(!sourceFile.read(pFilePath))
+      return false;
 
-         decrementScopeLevel(pContext);
-      }
-      break;
-   case StatementType::Break:
-      {
-         pContext.mJumpStatement = JumpStatement::Break;
-      }
-      break;
-   case StatementType::Continue:
-      {
-         pContext.mJumpStatement = JumpStatement::Continue;
-      }
-      break;
-   case StatementType::Return:
+   return load(pFilePath, sourceFile.getCode());
+}
+
+bool Environment::loadFiles(const char* const* pFilePaths, size_t pFilesCount, uint32_t pReadingThreadsCount)
+{
+   Memory::AllocatorScope allocatorScope(mAllocator);
+
+   struct PendingFile
+   {
+      SourceFile mSourceFile;
+      CflatSTLVector(Token) mTokens;
+      bool mRead;
+      bool mTokenized;
+   };
+
+   PendingFile* pendingFiles =
+      (PendingFile*)CflatAllocate(sizeof(PendingFile) * pFilesCount, SyntaxTree);
+
+   for(size_t i = 0u; i < pFilesCount; i++)
+   {
+      CflatInvokeCtor(PendingFile, &pendingFiles[i]);
+      pendingFiles[i].mRead = false;
+      pendingFiles[i].mTokenized = false;
+   }
+
+   // reading and tokenizing do not touch the environment, whereas preprocessing defines macros
+   // which apply to the files loaded afterwards, so the files with directives get preprocessed
+   // later on, in order
+   std::atomic<size_t> nextFileIndex(0u);
+
+   auto prepareFiles = [&]()
+   {
+      Memory::AllocatorScope allocatorScope(mAllocator);
+
+      for(size_t i = nextFileIndex++; i < pFilesCount; i = nextFileIndex++)
       {
-         StatementReturn* statement = static_cast<StatementReturn*>(pStatement);
+         PendingFile& pendingFile = pendingFiles[i];
+         pendingFile.mRead = pendingFile.mSourceFile.read(pFilePaths[i]);
 
-         if(statement->mExpression)
+         if(pendingFile.mRead && !strchr(pendingFile.mSourceFile.getCode(), '#'))
          {
-            Method* copyConstructor = nullptr;
+            Tokenizer::tokenize(pendingFile.mSourceFile.getCode(), pendingFile.mTokens);
+            pendingFile.mTokenized = true;
+         }
+      }
+   };
+
+   // the calling thread is one of the threads preparing the files
+   const size_t workerThreadsCount = pReadingThreadsCount > 1u && pFilesCount > 1u
+      ? (size_t)pReadingThreadsCount < pFilesCount ? (size_t)pReadingThreadsCount - 1u : pFilesCount - 1u
+      : 0u;
+   std::thread* workerThreads = workerThreadsCount > 0u
+      ? (std::thread*)CflatAllocate(sizeof(std::thread) * workerThreadsCount, SyntaxTree)
+      : nullptr;
+
+   for(size_t i = 0u; i < workerThreadsCount; i++)
+   {
+      CflatInvokeCtor(std::thread, &workerThreads[i])(prepareFiles);
+   }
+
+   prepareFiles();
+
+   for(size_t i = 0u; i < workerThreadsCount; i++)
+   {
+      workerThreads[i].join();
+      workerThreads[i].~thread();
+   }
+
+   if(workerThreads)
+   {
+      CflatDeallocate(workerThreads);
+   }
 
-            const TypeUsage& functionReturnTypeUsage =
-               pContext.mCallStack.back().mFunction->mReturnTypeUsage;
+   // parsing registers types, functions and instances in the environment, so it takes place in
+   // the calling thread
+   bool success = true;
 
-            if(functionReturnTypeUsage.mType &&
-               functionReturnTypeUsage.mType->mCategory == TypeCategory::StructOrClass &&
-               !functionReturnTypeUsage.isPointer() &&
-               !functionReturnTypeUsage.isReference())
-            {
-               TypeUsage typeUsageReference;
-               typeUsageReference.mType = functionReturnTypeUsage.mType;
-               typeUsageReference.mFlags |= (uint8_t)TypeUsageFlags::Reference;
+   for(size_t i = 0u; i < pFilesCount && success; i++)
+   {
+      PendingFile& pendingFile = pendingFiles[i];
 
-               CflatArgsVector(TypeUsage) argumentTypes;
-               argumentTypes.push_back(typeUsageReference);
+      if(!pendingFile.mRead)
+      {
+         success = false;
+         break;
+      }
 
-               copyConstructor = findConstructor(functionReturnTypeUsage.mType, argumentTypes);
+      const char* code = pendingFile.mSourceFile.getCode();
 
-               if(copyConstructor)
-               {
-                  Value returnValue;
-                  evaluateExpression(pContext, statement->mExpression, &returnValue);
-                  pContext.mReturnValues.back() = returnValue;
+      // the macros defined by the files loaded before might require preprocessing it
+      bool preprocessingRequired = !pendingFile.mTokenized;
 
-                  TypeUsage thisPtrTypeUsage;
-                  thisPtrTypeUsage.mType = functionReturnTypeUsage.mType;
-                  thisPtrTypeUsage.mPointerLevel = 1u;
+      for(size_t j = 0u; !preprocessingRequired && !mMacros.empty() && j < pendingFile.mTokens.size(); j++)
+      {
+         const Token& token = pendingFile.mTokens[j];
+         preprocessingRequired =
+            (token.mType == TokenType::Identifier || token.mType == TokenType::Keyword) &&
+            findMacro(token);
+      }
 
-                  Value thisPtrValue;
-                  thisPtrValue.initExternal(thisPtrTypeUsage);
-                  thisPtrValue.set(&pContext.mReturnValues.back().mValueBuffer);
+      if(preprocessingRequired)
+      {
+         success = load(pFilePaths[i], code);
+         continue;
+      }
 
-                  Value referenceValue;
-                  referenceValue.initExternal(typeUsageReference);
-                  referenceValue.set(returnValue.mValueBuffer);
+      Program* program = (Program*)CflatAllocate(sizeof(Program), SyntaxTree);
+      CflatInvokeCtor(Program, program);
+      program->mIdentifier = Identifier(pFilePaths[i]);
 
-                  CflatArgsVector(Value) args;
-                  args.push_back(referenceValue);
-                  copyConstructor->execute(thisPtrValue, args, nullptr);
-               }
-            }
+      mErrorMessage.clear();
+      mExecutionContext.mErrorMessage.clear();
 
-            if(!copyConstructor)
-            {
-               evaluateExpression(pContext, statement->mExpression, &pContext.mReturnValues.back());
-            }
-         }
+      ParsingContext parsingContext(&mGlobalNamespace);
+      parsingContext.mProgram = program;
+      parsingContext.mArena = &program->mArena;
+      parsingContext.mCode = code;
+      parsingContext.mTokens.swap(pendingFile.mTokens);
+      matchBrackets(parsingContext);
 
-         pContext.mJumpStatement = JumpStatement::Return;
-      }
-      break;
-   default:
-      break;
+      success = loadTokenized(parsingContext);
    }
-}
 
-Namespace* Environment::getGlobalNamespace()
-{
-   return &mGlobalNamespace;
-}
+   for(size_t i = 0u; i < pFilesCount; i++)
+   {
+      CflatInvokeDtor(PendingFile, &pendingFiles[i]);
+   }
 
-Namespace* Environment::getNamespace(const Identifier& pIdentifier)
-{
-   return mGlobalNamespace.getNamespace(pIdentifier);
+   CflatDeallocate(pendingFiles);
+
+   return success;
 }
 
-Namespace* Environment::requestNamespace(const Identifier& pIdentifier)
+bool Environment::loadAndPrecompile(const char* pProgramName, const char* pCode,
+   CflatSTLVector(char)& pOutPrecompiledData)
 {
-   return mGlobalNamespace.requestNamespace(pIdentifier);
+   Memory::AllocatorScope allocatorScope(mAllocator);
+
+   pOutPrecompiledData.clear();
+   return load(pProgramName, pCode, nullptr, 0u, &pOutPrecompiledData);
 }
 
-Type* Environment::getType(const Identifier& pIdentifier)
+bool Environment::loadPrecompiled(const char* pProgramName, const char* pCode,
+   const void* pPrecompiledData, size_t pPrecompiledDataSize)
 {
-   return mGlobalNamespace.getType(pIdentifier);
+   return load(pProgramName, pCode, pPrecompiledData, pPrecompiledDataSize, nullptr);
 }
 
-Type* Environment::getType(const Identifier& pIdentifier, const CflatArgsVector(TypeUsage)& pTemplateTypes)
+bool Environment::isPrecompiledDataValid(const char* pCode,
+   const void* pPrecompiledData, size_t pPrecompiledDataSize)
 {
-   return mGlobalNamespace.getType(pIdentifier, pTemplateTypes);
+   PrecompiledDataHeader header;
+
+   return readPrecompiledDataHeader(pPrecompiledData, pPrecompiledDataSize, &header) &&
+      header.mCodeHash == hash(pCode) &&
+      header.mMacrosHash == getMacrosHash();
 }
 
-TypeUsage Environment::getTypeUsage(const char* pTypeName, Namespace* pNamespace)
+bool Environment::reload(const char* pProgramName, const char* pCode)
 {
-   mTypesParsingContext.mTokenIndex = 0u;
+   Memory::AllocatorScope allocatorScope(mAllocator);
 
-   mTypesParsingContext.mNamespaceStack.clear();
-   mTypesParsingContext.mNamespaceStack.push_back(pNamespace ? pNamespace : &mGlobalNamespace);
+   const Identifier programIdentifier(pProgramName);
+   ProgramsRegistry::const_iterator it = mPrograms.find(programIdentifier.mHash);
 
-   mTypesParsingContext.mPreprocessedCode.assign(pTypeName);
-   mTypesParsingContext.mPreprocessedCode.push_back('\n');
+   if(it == mPrograms.end() || it->second->mStatementSources.empty())
+   {
+      return load(pProgramName, pCode);
+   }
 
-   tokenize(mTypesParsingContext);
+   Program* program = it->second;
+   CflatSTLVector(Program::StatementSource)& statementSources = program->mStatementSources;
 
-   return parseTypeUsage(mTypesParsingContext, 0u);
-}
+   mErrorMessage.clear();
+   mExecutionContext.mErrorMessage.clear();
 
-Function* Environment::registerFunction(const Identifier& pIdentifier)
-{
-   return mGlobalNamespace.registerFunction(pIdentifier);
-}
+   ParsingContext parsingContext(&mGlobalNamespace);
+   parsingContext.mProgram = program;
 
-Function* Environment::getFunction(const Identifier& pIdentifier)
-{
-   return mGlobalNamespace.getFunction(pIdentifier);
-}
+   preprocess(parsingContext, pCode);
 
-Function* Environment::getFunction(const Identifier& pIdentifier,
-   const CflatArgsVector(TypeUsage)& pParameterTypes)
-{
-   return mGlobalNamespace.getFunction(pIdentifier, pParameterTypes);
-}
+   // the statements which are only parsed to update the parsing context get released right
+   // away, while each changed function definition gets its own arena, so the memory of the
+   // replaced ones can be released instead of piling up in the arena of the program
+   Memory::Arena discardedStatementsArena(kFunctionArenaChunkSize);
 
-Function* Environment::getFunction(const Identifier& pIdentifier,
-   const CflatArgsVector(Value)& pArguments)
-{
-   return mGlobalNamespace.getFunction(pIdentifier, pArguments);
-}
+   if(!mErrorMessage.empty())
+   {
+      return false;
+   }
 
-CflatSTLVector(Function*)* Environment::getFunctions(const Identifier& pIdentifier)
-{
-   return mGlobalNamespace.getFunctions(pIdentifier);
-}
+   struct StatementReplacement
+   {
+      size_t mStatementSourceIndex;
+      Hash mHash;
+      uint16_t mLine;
+      Statement* mStatement;
+      Memory::Arena* mArena;
+   };
+   CflatSTLVector(StatementReplacement) statementReplacements;
 
-void Environment::setVariable(const TypeUsage& pTypeUsage, const Identifier& pIdentifier,
-   const Value& pValue)
-{
-   mGlobalNamespace.setVariable(pTypeUsage, pIdentifier, pValue);
-}
+   // unchanged statements which start at a different line
+   struct StatementMove
+   {
+      size_t mStatementSourceIndex;
+      int mLinesOffset;
+   };
+   CflatSTLVector(StatementMove) statementMoves;
 
-Value* Environment::getVariable(const Identifier& pIdentifier)
-{
-   return mGlobalNamespace.getVariable(pIdentifier);
-}
+   size_t& tokenIndex = parsingContext.mTokenIndex;
+   size_t statementSourceIndex = 0u;
+   bool incrementalReload = true;
 
-void Environment::voidFunctionCall(Function* pFunction)
-{
-   CflatAssert(pFunction);
+   for(tokenIndex = 0u; tokenIndex < parsingContext.mTokens.size(); tokenIndex++)
+   {
+      Program::StatementSource statementSource;
+      size_t lastTokenIndex = 0u;
 
-   mErrorMessage.clear();
+      if(statementSourceIndex >= statementSources.size() ||
+         !getStatementSource(parsingContext, tokenIndex, &statementSource, &lastTokenIndex))
+      {
+         incrementalReload = false;
+         break;
+      }
 
-   Value returnValue;
+      const Program::StatementSource& previousStatementSource =
+         statementSources[statementSourceIndex++];
+      Statement* previousStatement = previousStatementSource.mStatement;
 
-   CflatArgsVector(Value) args;
-   pFunction->execute(args, &returnValue);
-}
+      const bool isFunctionDefinition = previousStatement &&
+         previousStatement->getType() == StatementType::FunctionDeclaration &&
+         static_cast<StatementFunctionDeclaration*>(previousStatement)->mBody;
+      const bool statementChanged = statementSource.mHash != previousStatementSource.mHash;
 
-bool Environment::load(const char* pProgramName, const char* pCode)
-{
-   const Identifier programIdentifier(pProgramName);
+      if(!statementChanged && statementSource.mLine != previousStatementSource.mLine)
+      {
+         StatementMove statementMove;
+         statementMove.mStatementSourceIndex = statementSourceIndex - 1u;
+         statementMove.mLinesOffset = (int)statementSource.mLine - (int)previousStatementSource.mLine;
+         statementMoves.push_back(statementMove);
+      }
 
-   Program* program = (Program*)CflatMalloc(sizeof(Program));
-   CflatInvokeCtor(Program, program);
+      // unchanged function definitions are kept as they are, without parsing them
+      if(isFunctionDefinition && !statementChanged)
+      {
+         tokenIndex = lastTokenIndex;
+         continue;
+      }
 
-   program->mIdentifier = programIdentifier;
-   program->mCode.assign(pCode);
+      if(statementChanged &&
+         (!isFunctionDefinition || statementSource.mHeaderHash != previousStatementSource.mHeaderHash))
+      {
+         incrementalReload = false;
+         break;
+      }
 
-   mErrorMessage.clear();
+      Memory::Arena* arena = &discardedStatementsArena;
 
-   ParsingContext parsingContext(&mGlobalNamespace);
-   parsingContext.mProgram = program;
+      if(statementChanged)
+      {
+         arena = (Memory::Arena*)CflatAllocate(sizeof(Memory::Arena), SyntaxTree);
+         CflatInvokeCtor(Memory::Arena, arena)(kFunctionArenaChunkSize);
+      }
 
-   preprocess(parsingContext, pCode);
+      parsingContext.mArena = arena;
 
-   if(mErrorMessage.empty())
+      // the rest of the statements get parsed anyway, since they might alter the parsing
+      // context (e.g. using directives), but only changed function definitions are replaced
+      Statement* statement = parseStatement(parsingContext);
+
+      if(!mErrorMessage.empty() || tokenIndex != lastTokenIndex || !statementChanged)
+      {
+         if(statement)
+         {
+            CflatInvokeDtor(Statement, statement);
+         }
+
+         if(statementChanged)
+         {
+            CflatInvokeDtor(Arena, arena);
+            CflatDeallocate(arena);
+         }
+         else
+         {
+            discardedStatementsArena.reset();
+         }
+
+         if(!mErrorMessage.empty() || tokenIndex != lastTokenIndex)
+         {
+            incrementalReload = false;
+            break;
+         }
+
+         continue;
+      }
+
+      StatementReplacement statementReplacement;
+      statementReplacement.mStatementSourceIndex = statementSourceIndex - 1u;
+      statementReplacement.mHash = statementSource.mHash;
+      statementReplacement.mLine = statementSource.mLine;
+      statementReplacement.mStatement = statement;
+      statementReplacement.mArena = arena;
+      statementReplacements.push_back(statementReplacement);
+   }
+
+   if(statementSourceIndex != statementSources.size())
    {
-      tokenize(parsingContext);
-      parse(parsingContext);
+      incrementalReload = false;
    }
 
-   if(!mErrorMessage.empty())
+   for(size_t i = 0u; incrementalReload && i < statementReplacements.size(); i++)
    {
-      CflatInvokeDtor(Program, program);
-      CflatFree(program);
-      return false;
+      const Statement* previousStatement =
+         statementSources[statementReplacements[i].mStatementSourceIndex].mStatement;
+
+      // this leaves the program as it was, like compile errors do
+      if(!checkSuspendedSlicedCalls(program, previousStatement))
+      {
+         incrementalReload = false;
+      }
    }
 
-   execute(mExecutionContext, *program);
+   if(!incrementalReload)
+   {
+      for(size_t i = 0u; i < statementReplacements.size(); i++)
+      {
+         CflatInvokeDtor(Statement, statementReplacements[i].mStatement);
+         CflatInvokeDtor(Arena, statementReplacements[i].mArena);
+         CflatDeallocate(statementReplacements[i].mArena);
+      }
 
-   ProgramsRegistry::const_iterator it = mPrograms.find(programIdentifier.mHash);
+      // on compile errors, the program is left as it was
+      return mErrorMessage.empty() ? load(pProgramName, pCode) : false;
+   }
 
-   if(it != mPrograms.end())
+   for(size_t i = 0u; i < statementMoves.size(); i++)
    {
-      CflatInvokeDtor(Program, it->second);
-      CflatFree(it->second);
+      Program::StatementSource& statementSource =
+         statementSources[statementMoves[i].mStatementSourceIndex];
+      moveStatementLines(statementSource.mStatement, statementMoves[i].mLinesOffset);
+      statementSource.mLine = (uint16_t)(statementSource.mLine + statementMoves[i].mLinesOffset);
    }
 
-   mPrograms[programIdentifier.mHash] = program;
+   mExecutionContext.mJumpStatement = JumpStatement::None;
+   mExecutionContext.mCallStack.emplace_back(program);
 
-   if(!mErrorMessage.empty())
+   for(size_t i = 0u; i < statementReplacements.size(); i++)
    {
-      return false;
+      const StatementReplacement& statementReplacement = statementReplacements[i];
+      Program::StatementSource& statementSource =
+         statementSources[statementReplacement.mStatementSourceIndex];
+
+      StatementFunctionDeclaration* previousStatement =
+         static_cast<StatementFunctionDeclaration*>(statementSource.mStatement);
+
+      // the using directives the function was declared with keep applying
+      CflatSTLVector(UsingDirective) usingDirectives;
+
+      if(previousStatement->mFunction)
+      {
+         usingDirectives = previousStatement->mFunction->mUsingDirectives;
+      }
+
+      for(size_t j = 0u; j < program->mStatements.size(); j++)
+      {
+         if(program->mStatements[j] == previousStatement)
+         {
+            program->mStatements[j] = statementReplacement.mStatement;
+            break;
+         }
+      }
+
+      CflatInvokeDtor(Statement, previousStatement);
+
+      if(statementSource.mArena)
+      {
+         CflatInvokeDtor(Arena, statementSource.mArena);
+         CflatDeallocate(statementSource.mArena);
+      }
+
+      statementSource.mHash = statementReplacement.mHash;
+      statementSource.mLine = statementReplacement.mLine;
+      statementSource.mStatement = statementReplacement.mStatement;
+      statementSource.mArena = statementReplacement.mArena;
+
+      execute(mExecutionContext, statementReplacement.mStatement);
+
+      StatementFunctionDeclaration* statement =
+         static_cast<StatementFunctionDeclaration*>(statementReplacement.mStatement);
+
+      if(statement->mFunction)
+      {
+         statement->mFunction->mUsingDirectives = usingDirectives;
+      }
    }
 
+   mExecutionContext.mCallStack.pop_back();
+
    return true;
 }
 
-bool Environment::load(const char* pFilePath)
+const char* Environment::getErrorMessage()
 {
-   FILE* file = fopen(pFilePath, "rb");
+   if(!mErrorMessage.empty())
+   {
+      return mErrorMessage.c_str();
+   }
 
-   if(!file)
-      return false;
+   const ExecutionContext& context = getCurrentExecutionContext();
+   return context.mErrorMessage.empty() ? nullptr : context.mErrorMessage.c_str();
+}
 
-   fseek(file, 0, SEEK_END);
-   const size_t fileSize = (size_t)ftell(file);
-   rewind(file);
+void Environment::setStackSize(size_t pStackSize, bool pGrowableStack)
+{
+   Memory::AllocatorScope allocatorScope(mAllocator);
+
+   mExecutionContext.mStack.init(pStackSize, pGrowableStack);
+}
 
-   char* code = (char*)CflatMalloc(fileSize + 1u);
-   code[fileSize] = '\0';
+void Environment::setExecutionHook(ExecutionHook pExecutionHook)
+{
+   mExecutionHook = pExecutionHook;
+   updateStatementHooks();
+}
 
-   fread(code, 1u, fileSize, file);
-   fclose(file);
+void Environment::setLineHook(ExecutionHook pLineHook)
+{
+   mLineHook = pLineHook;
+   updateStatementHooks();
+}
 
-   const bool success = load(pFilePath, code);
-   CflatFree(code);
+void Environment::setSampledHook(ExecutionHook pSampledHook, uint32_t pStatementsInterval)
+{
+   mSampledHook = pSampledHook;
+   mSampledHookInterval = pStatementsInterval > 0u ? pStatementsInterval : 1u;
+   updateStatementHooks();
+}
 
-   return success;
+void Environment::setTimerHook(ExecutionHook pTimerHook, uint32_t pIntervalMicroseconds)
+{
+   mTimerHook = pTimerHook;
+   mTimerHookInterval = (uint64_t)pIntervalMicroseconds * 1000u;
+   updateStatementHooks();
 }
 
-const char* Environment::getErrorMessage()
+void Environment::setFunctionHook(FunctionHook pFunctionHook)
 {
-   return mErrorMessage.empty() ? nullptr : mErrorMessage.c_str();
+   mFunctionHook = pFunctionHook;
 }
 
-void Environment::setExecutionHook(ExecutionHook pExecutionHook)
+void Environment::setProfiler(Profiler* pProfiler)
 {
-   mExecutionHook = pExecutionHook;
+   getCurrentExecutionContext().mProfiler = pProfiler;
+}
+
+void Environment::setExecutionMode(ExecutionMode pExecutionMode)
+{
+   mExecutionMode = pExecutionMode;
 }
 
 bool Environment::evaluateExpression(const char* pExpression, Value* pOutValue)
 {
+   Memory::AllocatorScope allocatorScope(mAllocator);
+
+   // the expression gets evaluated in the scope of the program being executed, if any (a scratch
+   // one otherwise), and its nodes live in an arena of their own, released once evaluated
+   Program scratchProgram;
+   Program* const executedProgram = mExecutionContext.mProgram;
+
+   if(!executedProgram)
+   {
+      scratchProgram.mIdentifier = Identifier("expression");
+      mExecutionContext.mProgram = &scratchProgram;
+   }
+
+   Memory::Arena arena(kFunctionArenaChunkSize);
+
    ParsingContext parsingContext(&mGlobalNamespace);
    parsingContext.mProgram = mExecutionContext.mProgram;
+   parsingContext.mArena = &arena;
    parsingContext.mScopeLevel = mExecutionContext.mScopeLevel;
    parsingContext.mNamespaceStack = mExecutionContext.mNamespaceStack;
    parsingContext.mUsingDirectives = mExecutionContext.mUsingDirectives;
    parsingContext.mLocalInstancesHolder = mExecutionContext.mLocalInstancesHolder;
 
    preprocess(parsingContext, pExpression);
-   tokenize(parsingContext);
    
    CflatSTLVector(Token)& tokens = parsingContext.mTokens;
    
@@ -9130,13 +14102,32 @@ bool Environment::evaluateExpression(const char* pExpression, Value* pOutValue)
       {
          CflatAssert(pOutValue);
          evaluateExpression(mExecutionContext, expression, pOutValue);
+
+         // values referring to the data of the nodes (literals) get a copy of it
+         if(pOutValue->mValueBufferType == ValueBufferType::External &&
+            arena.contains(pOutValue->mValueBuffer))
+         {
+            const TypeUsage typeUsage = pOutValue->mTypeUsage;
+            const char* data = pOutValue->mValueBuffer;
+
+            pOutValue->reset();
+            pOutValue->initOnHeap(typeUsage);
+            pOutValue->set(data);
+         }
+
+         CflatInvokeDtor(Expression, expression);
+
+         mExecutionContext.mProgram = executedProgram;
          mErrorMessage.clear();
+         mExecutionContext.mErrorMessage.clear();
 
          return pOutValue->mValueBufferType != ValueBufferType::Uninitialized;
       }
    }
 
+   mExecutionContext.mProgram = executedProgram;
    mErrorMessage.clear();
+   mExecutionContext.mErrorMessage.clear();
 
    return false;
 }
@@ -30,7 +30,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <atomic>
+#include <mutex>
 #include <functional>
 #include <vector>
 #include <deque>
@@ -42,6 +45,9 @@
 #define CflatMalloc  Cflat::Memory::malloc
 #define CflatFree  Cflat::Memory::free
 
+#define CflatAllocate(pSize, pCategory)  Cflat::Memory::allocate(pSize, Cflat::Memory::Category::pCategory)
+#define CflatDeallocate  Cflat::Memory::deallocate
+
 #define CflatHasFlag(pBitMask, pFlag)  ((pBitMask & (int)pFlag) > 0)
 #define CflatSetFlag(pBitMask, pFlag)  (pBitMask |= (int)pFlag)
 #define CflatResetFlag(pBitMask, pFlag)  (pBitMask &= ~((int)pFlag))
@@ -56,16 +62,60 @@
 
 #define CflatArgsVector(T)  Cflat::Memory::StackVector<T, Cflat::kArgsVectorSize>
 
+#define CflatIdentifier(pName) \
+   Cflat::Identifier(pName, std::integral_constant<Cflat::Hash, Cflat::hashIdentifierConstexpr(pName)>::value)
+
 namespace Cflat
 {
    typedef uint32_t Hash;
 
+   class Allocator;
+
    class Memory
    {
    public:
+      // the memory the default allocator takes from the system
       static void* (*malloc)(size_t pSize);
       static void (*free)(void* pPtr);
 
+      enum class Category : uint8_t
+      {
+         Containers,  // STL containers
+         SyntaxTree,  // programs, along with their syntax trees and bytecode
+         Types,       // types, functions and namespaces
+         Values,      // values, stacks and execution contexts
+         Identifiers, // names of the identifiers, which are shared by all the environments
+
+         Count
+      };
+
+      // memory comes from the allocator bound to the calling thread (see AllocatorScope), or from
+      // the default one if there is none, and each allocation remembers where it comes from, so
+      // it goes back to the same allocator when released
+      static void* allocate(size_t pSize, Category pCategory);
+      static void deallocate(void* pPtr);
+
+      static Allocator* getDefaultAllocator();
+
+      // binds the allocator to the calling thread, returning the one previously bound
+      static Allocator* bindAllocator(Allocator* pAllocator);
+
+      class AllocatorScope
+      {
+      private:
+         Allocator* mPreviousAllocator;
+
+      public:
+         AllocatorScope(Allocator* pAllocator)
+            : mPreviousAllocator(bindAllocator(pAllocator))
+         {
+         }
+         ~AllocatorScope()
+         {
+            bindAllocator(mPreviousAllocator);
+         }
+      };
+
       template<typename T>
       class STLAllocator
       {
@@ -94,7 +144,7 @@ namespace Cflat
 
          pointer allocate(size_type pNum, const void* = nullptr)
          {
-            return (pointer)CflatMalloc(pNum * sizeof(T));
+            return (pointer)CflatAllocate(pNum * sizeof(T), Containers);
          }
          void construct(pointer pPtr, const T& pValue)
          {
@@ -106,7 +156,7 @@ namespace Cflat
          }
          void deallocate(pointer pPtr, size_type)
          {
-            CflatFree(pPtr);
+            CflatDeallocate(pPtr);
          }
       };
 
@@ -304,25 +354,86 @@ namespace Cflat
          }
       };
 
-      template<size_t Size>
+      // the memory gets allocated on the first push; when growable, the pool chains additional
+      // segments instead of overflowing, which never move, so pushed data stays where it is;
+      // otherwise, pushes which do not fit return nullptr and flag the overflow
       struct StackPool
       {
-         char mMemory[Size];
-         char* mPointer;
+         struct Segment
+         {
+            Segment* mPrevious;
+            Segment* mNext;
+            char* mPreviousPointer;
+            size_t mSize;
 
-         StackPool()
-            : mPointer(mMemory)
+            char* getMemory() { return reinterpret_cast<char*>(this + 1); }
+         };
+
+         Segment* mSegment;
+         char* mPointer;
+         size_t mSegmentSize;
+         bool mGrowable;
+         bool mOverflown;
+         Category mCategory;
+
+         StackPool(size_t pSize = kEnvironmentStackSize, bool pGrowable = false,
+            Category pCategory = Category::Values)
+            : mSegment(nullptr)
+            , mPointer(nullptr)
+            , mSegmentSize(pSize)
+            , mGrowable(pGrowable)
+            , mOverflown(false)
+            , mCategory(pCategory)
          {
          }
+         StackPool(const StackPool&) = delete;
+         ~StackPool()
+         {
+            releaseSegments();
+         }
+
+         StackPool& operator=(const StackPool&) = delete;
+
+         void init(size_t pSize, bool pGrowable)
+         {
+            CflatAssert(isEmpty());
+            releaseSegments();
 
+            mSegmentSize = pSize;
+            mGrowable = pGrowable;
+         }
          void reset()
          {
-            mPointer = mMemory;
+            if(mSegment)
+            {
+               while(mSegment->mPrevious)
+               {
+                  mSegment = mSegment->mPrevious;
+               }
+
+               mPointer = mSegment->getMemory();
+            }
+
+            mOverflown = false;
+         }
+
+         bool isEmpty() const
+         {
+            return !mSegment || (!mSegment->mPrevious && mPointer == mSegment->getMemory());
          }
 
          const char* push(size_t pSize)
          {
-            CflatAssert((mPointer - mMemory + pSize) < Size);
+            if(!mSegment || (mPointer + pSize) > (mSegment->getMemory() + mSegment->mSize))
+            {
+               if(mSegment && !mGrowable)
+               {
+                  mOverflown = true;
+                  return nullptr;
+               }
+
+               pushSegment(pSize);
+            }
 
             const char* dataPtr = mPointer;
             mPointer += pSize;
@@ -331,71 +442,311 @@ namespace Cflat
          }
          const char* push(const char* pData, size_t pSize)
          {
-            CflatAssert((mPointer - mMemory + pSize) < Size);
-            memcpy(mPointer, pData, pSize);
+            const char* dataPtr = push(pSize);
 
-            const char* dataPtr = mPointer;
-            mPointer += pSize;
+            if(dataPtr)
+            {
+               memcpy((char*)dataPtr, pData, pSize);
+            }
 
             return dataPtr;
          }
          void pop(size_t pSize)
          {
+            CflatAssert(mSegment);
+
             mPointer -= pSize;
-            CflatAssert(mPointer >= mMemory);
+            CflatAssert(mPointer >= mSegment->getMemory());
+
+            if(mPointer == mSegment->getMemory() && mSegment->mPrevious)
+            {
+               mPointer = mSegment->mPreviousPointer;
+               mSegment = mSegment->mPrevious;
+            }
          }
-      };
 
-      template<size_t Size>
-      struct StringsRegistry
-      {
-         char mMemory[Size];
-         char* mPointer;
+      private:
+         void pushSegment(size_t pMinimumSize)
+         {
+            Segment* segment = mSegment ? mSegment->mNext : nullptr;
 
-         typedef CflatSTLMap(Hash, const char*) Registry;
-         Registry mRegistry;
+            if(segment && segment->mSize < pMinimumSize)
+            {
+               mSegment->mNext = nullptr;
+               releaseSegments(segment);
+               segment = nullptr;
+            }
 
-         StringsRegistry()
-            : mPointer(mMemory + 1)
-         {
-            mMemory[0] = '\0';
-            mRegistry[0u] = mMemory;
-         }
+            if(!segment)
+            {
+               const size_t segmentSize = pMinimumSize > mSegmentSize ? pMinimumSize : mSegmentSize;
 
-         const char* registerString(Hash pHash, const char* pString)
+               segment = (Segment*)Memory::allocate(sizeof(Segment) + segmentSize, mCategory);
+               segment->mPrevious = mSegment;
+               segment->mNext = nullptr;
+               segment->mSize = segmentSize;
+
+               if(mSegment)
+               {
+                  mSegment->mNext = segment;
+               }
+            }
+
+            segment->mPreviousPointer = mPointer;
+
+            mSegment = segment;
+            mPointer = segment->getMemory();
+         }
+         void releaseSegments()
          {
-            Registry::const_iterator it = mRegistry.find(pHash);
+            if(mSegment)
+            {
+               reset();
+               releaseSegments(mSegment);
 
-            if(it != mRegistry.end())
+               mSegment = nullptr;
+               mPointer = nullptr;
+            }
+         }
+         void releaseSegments(Segment* pFirstSegment)
+         {
+            while(pFirstSegment)
             {
-               return it->second;
+               Segment* nextSegment = pFirstSegment->mNext;
+               CflatDeallocate(pFirstSegment);
+               pFirstSegment = nextSegment;
             }
+         }
+      };
 
-            char* ptr = mPointer;
-            mRegistry[pHash] = ptr;
-
-            const size_t stringLength = strlen(pString);
-            CflatAssert((mPointer + stringLength) < (mMemory + Size));
+      // memory for objects which are released all at once: allocating is a matter of bumping a
+      // pointer, and the objects end up next to each other in the order they get allocated
+      struct Arena
+      {
+         StackPool mPool;
 
-            memcpy(ptr, pString, stringLength);
-            ptr[stringLength] = '\0';
+         Arena(size_t pChunkSize = kProgramArenaChunkSize)
+            : mPool(pChunkSize, true, Category::SyntaxTree)
+         {
+         }
 
-            mPointer += stringLength + 1;
+         void* allocate(size_t pSize)
+         {
+            const size_t alignment = alignof(std::max_align_t);
+            const size_t alignedSize = (pSize + alignment - 1u) & ~(alignment - 1u);
 
-            return ptr;
+            return const_cast<char*>(mPool.push(alignedSize));
          }
-         const char* retrieveString(Hash pHash)
+         // the memory is kept for the objects allocated afterwards
+         void reset()
          {
-            Registry::const_iterator it = mRegistry.find(pHash);
+            mPool.reset();
+         }
 
-            if(it != mRegistry.end())
+         bool contains(const void* pPtr) const
+         {
+            for(StackPool::Segment* segment = mPool.mSegment; segment; segment = segment->mPrevious)
             {
-               return it->second;
+               const char* memory = segment->getMemory();
+
+               if(pPtr >= memory && pPtr < memory + segment->mSize)
+               {
+                  return true;
+               }
             }
 
-            return mMemory;
+            return false;
          }
       };
+
+      // growable pool for the strings of the literals, where equal strings get shared: each
+      // registration adds a reference to the string, and once all of them are released, its
+      // memory is kept untouched until the pool gets compacted, which makes it available for the
+      // strings registered afterwards
+      class StringsPool
+      {
+      public:
+         struct Stats
+         {
+            size_t mStringsCount;
+            // sizes in bytes of the memory taken by the strings in use, of the maximum it has
+            // reached, and of the chunks reserved by the pool
+            size_t mUsedSize;
+            size_t mPeakUsedSize;
+            size_t mReservedSize;
+            // size in bytes of the memory taken by the released strings, until the next compaction
+            size_t mReleasedSize;
+         };
+
+      private:
+         struct Entry
+         {
+            Hash mHash;
+            uint32_t mReferencesCount;
+            // size of the block, including this header
+            size_t mSize;
+
+            char* getString() { return reinterpret_cast<char*>(this + 1); }
+            // released blocks are linked through the memory of their strings
+            Entry*& getNextFreeEntry() { return *reinterpret_cast<Entry**>(this + 1); }
+         };
+
+         struct Chunk
+         {
+            Chunk* mPrevious;
+            size_t mSize;
+
+            char* getMemory() { return reinterpret_cast<char*>(this + 1); }
+         };
+
+         typedef CflatSTLMap(Hash, Entry*) Registry;
+         Registry mRegistry;
+
+         // lists of released blocks, by block size
+         typedef CflatSTLMap(size_t, Entry*) FreeEntriesRegistry;
+         FreeEntriesRegistry mFreeEntries;
+
+         // released blocks which have not been made available for reuse yet
+         CflatSTLVector(Entry*) mReleasedEntries;
+
+         Chunk* mChunk;
+         size_t mChunkUsedSize;
+
+         Stats mStats;
+
+         Entry* allocateEntry(size_t pSize);
+
+      public:
+         StringsPool();
+         ~StringsPool();
+
+         StringsPool(const StringsPool&) = delete;
+         StringsPool& operator=(const StringsPool&) = delete;
+
+         const char* registerString(Hash pHash, const char* pString);
+         const char* retrieveString(Hash pHash);
+         // the string has to be one returned by registerString
+         void releaseString(const char* pString);
+         // makes the memory of the released strings available for reuse, so any pointer to them
+         // must not be used afterwards
+         void compact();
+
+         const Stats& getStats() const;
+      };
+
+      // growable registry for the names of the identifiers: lookups are lock-free, while the
+      // registration of new names gets serialized, so identifiers can be created from any thread
+      class NamesRegistry
+      {
+      public:
+         struct Stats
+         {
+            size_t mNamesCount;
+            // sizes in bytes of the memory taken by the names, and of the chunks and the tables
+            // reserved by the registry (names are never released, since identifiers point to them)
+            size_t mUsedSize;
+            size_t mReservedSize;
+            size_t mTableCapacity;
+         };
+
+      private:
+         struct Slot
+         {
+            Hash mHash;
+            std::atomic<const char*> mString;
+
+            Slot();
+         };
+
+         struct Table
+         {
+            Table* mPrevious;
+            size_t mCapacity;
+
+            Slot* getSlots() { return reinterpret_cast<Slot*>(this + 1); }
+         };
+
+         struct Chunk
+         {
+            Chunk* mPrevious;
+            size_t mSize;
+
+            char* getMemory() { return reinterpret_cast<char*>(this + 1); }
+         };
+
+         // the tables replaced when growing remain valid, since readers might be still using them
+         std::atomic<Table*> mTable;
+         size_t mNamesCount;
+
+         Chunk* mChunk;
+         size_t mChunkUsedSize;
+         size_t mNamesSize;
+
+         std::mutex mMutex;
+
+         static const char* find(Table* pTable, Hash pHash);
+         static void insert(Table* pTable, Hash pHash, const char* pString);
+
+         Table* createTable(size_t pCapacity, Table* pPrevious);
+         char* allocateString(size_t pLength);
+
+      public:
+         NamesRegistry();
+         ~NamesRegistry();
+
+         NamesRegistry(const NamesRegistry&) = delete;
+         NamesRegistry& operator=(const NamesRegistry&) = delete;
+
+         const char* registerString(Hash pHash, const char* pString);
+         const char* retrieveString(Hash pHash);
+
+         Stats getStats();
+      };
+   };
+
+   // source of the memory requested by an environment (see Environment::Environment), which gets
+   // told the category of each allocation, so it can keep them in separate pools or budgets; the
+   // sizes include a header of 16 bytes, and the memory returned has to be aligned to 16 bytes
+   //
+   // allocators have to be thread-safe: the execution contexts running on other threads (see
+   // Environment::createExecutionContext) and the reading threads of Environment::loadFiles call
+   // them concurrently, and memory can be released from a thread other than the one which
+   // allocated it
+   class Allocator
+   {
+   public:
+      struct Stats
+      {
+         size_t mBytes;
+         size_t mAllocationsCount;
+         size_t mTotalAllocationsCount; // including the ones already released
+      };
+
+   private:
+      std::atomic<size_t> mBytes[(size_t)Memory::Category::Count];
+      std::atomic<size_t> mAllocationsCount[(size_t)Memory::Category::Count];
+      std::atomic<size_t> mTotalAllocationsCount[(size_t)Memory::Category::Count];
+
+      friend class Memory;
+
+   public:
+      Allocator();
+      virtual ~Allocator() {}
+
+      virtual void* allocate(size_t pSize, Memory::Category pCategory) = 0;
+      virtual void deallocate(void* pPtr, size_t pSize, Memory::Category pCategory) = 0;
+
+      // memory currently allocated through Memory::allocate, per category and in total
+      Stats getStats(Memory::Category pCategory) const;
+      Stats getStats() const;
+   };
+
+   // allocator which takes the memory from Memory::malloc and Memory::free
+   class DefaultAllocator : public Allocator
+   {
+   public:
+      virtual void* allocate(size_t pSize, Memory::Category pCategory) override;
+      virtual void deallocate(void* pPtr, size_t pSize, Memory::Category pCategory) override;
    };
 
    template<typename T1, typename T2>
@@ -427,16 +778,32 @@ namespace Cflat
    
 
    Hash hash(const char* pString);
+   Hash hash(const char* pString, size_t pLength);
+
+   // same as hash(), but it can be evaluated at compile time (see CflatIdentifier)
+   constexpr Hash hashConstexpr(const char* pString, Hash pHash = 2166136261u)
+   {
+      return pString[0] != '\0'
+         ? hashConstexpr(pString + 1, (pHash ^ (Hash)pString[0]) * 16777619u)
+         : pHash;
+   }
+
+   // hash of an identifier name at compile time (the empty name has a null hash, see Identifier)
+   constexpr Hash hashIdentifierConstexpr(const char* pName)
+   {
+      return pName[0] != '\0' ? hashConstexpr(pName) : 0u;
+   }
 
 
    struct Program;
    class Namespace;
+   struct StatementFunctionDeclaration;
 
 
    struct Identifier
    {
-      typedef Memory::StringsRegistry<kIdentifierStringsPoolSize> NamesRegistry;
-      static NamesRegistry* smNames;
+      typedef Memory::NamesRegistry NamesRegistry;
+      static std::atomic<NamesRegistry*> smNames;
 
       static NamesRegistry* getNamesRegistry();
       static void releaseNamesRegistry();
@@ -447,6 +814,7 @@ namespace Cflat
 
       Identifier();
       Identifier(const char* pName);
+      Identifier(const char* pName, Hash pHash);
 
       const char* findFirstSeparator() const;
       const char* findLastSeparator() const;
@@ -526,6 +894,7 @@ namespace Cflat
       Uninitialized, // uninitialized
       Stack,         // owned, allocated on the stack
       Heap,          // owned, allocated on the heap
+      Inline,        // owned, stored within the value itself (see kValueInlineBufferSize)
       External       // not owned
    };
 
@@ -535,7 +904,7 @@ namespace Cflat
       Stack // to be allocated on the stack
    };
 
-   typedef Memory::StackPool<kEnvironmentStackSize> EnvironmentStack;
+   typedef Memory::StackPool EnvironmentStack;
 
    struct Value
    {
@@ -546,6 +915,9 @@ namespace Cflat
       ValueInitializationHint mValueInitializationHint;
       char* mValueBuffer;
       EnvironmentStack* mStack;
+      // aligned like heap storage, since types do not record their alignment and registered types
+      // such as SIMD vectors require 16 bytes
+      alignas(16) char mInlineBuffer[kValueInlineBufferSize];
 
       Value();
       Value(const Value& pOther);
@@ -571,6 +943,11 @@ namespace Cflat
       UsingDirective(Namespace* pNamespace);
    };
 
+   // typed entry point of a native function or method (see CflatRegisterNativeFunction), which
+   // takes the data of the arguments and the buffer for the return value (nullptr if void), where
+   // references get returned as the address of the data they refer to
+   typedef void (*NativeCall)(void* pThis, const void* const* pArgumentsData, void* pOutReturnValueData);
+
    struct Function
    {
       Namespace* mNamespace;
@@ -583,6 +960,13 @@ namespace Cflat
       CflatSTLVector(Identifier) mParameterIdentifiers;
       CflatSTLVector(UsingDirective) mUsingDirectives;
 
+      // declaration of the function when defined in a script, which allows calls from scripts to
+      // write the arguments straight into the frame of the function instead of going through
+      // 'execute'
+      StatementFunctionDeclaration* mDeclaration;
+
+      NativeCall mNativeCall;
+
       std::function<void(const CflatArgsVector(Value)& pArgs, Value* pOutReturnValue)> execute;
 
       Function(const Identifier& pIdentifier);
@@ -596,6 +980,8 @@ namespace Cflat
       CflatSTLVector(TypeUsage) mTemplateTypes;
       CflatSTLVector(TypeUsage) mParameters;
 
+      NativeCall mNativeCall;
+
       std::function<void(const Value& pThis, const CflatArgsVector(Value)& pArgs, Value* pOutReturnValue)> execute;
 
       Method(const Identifier& pIdentifier);
@@ -629,16 +1015,17 @@ namespace Cflat
       template<typename T>
       T* registerType(const Identifier& pIdentifier, Namespace* pNamespace, Type* pParent)
       {
-         T* type = (T*)CflatMalloc(sizeof(T));
+         T* type = (T*)CflatAllocate(sizeof(T), Types);
          CflatInvokeCtor(T, type)(pNamespace, pIdentifier);
          
          const Hash hash = type->getHash();
          TypesRegistry::const_iterator it = mTypes.find(hash);
 
-         if(it != mTypes.end())
+         // shared types (see registerSharedTypes) are owned by the holder they come from
+         if(it != mTypes.end() && it->second->mNamespace == pNamespace)
          {
             CflatInvokeDtor(Type, it->second);
-            CflatFree(it->second);
+            CflatDeallocate(it->second);
          }
 
          type->mParent = pParent;
@@ -651,7 +1038,7 @@ namespace Cflat
       T* registerTemplate(const Identifier& pIdentifier, const CflatArgsVector(TypeUsage)& pTemplateTypes,
          Namespace* pNamespace, Type* pParent)
       {
-         T* type = (T*)CflatMalloc(sizeof(T));
+         T* type = (T*)CflatAllocate(sizeof(T), Types);
          CflatInvokeCtor(T, type)(pNamespace, pIdentifier);
 
          type->mTemplateTypes.resize(pTemplateTypes.size());
@@ -660,10 +1047,11 @@ namespace Cflat
          const Hash hash = type->getHash();
          TypesRegistry::const_iterator it = mTypes.find(hash);
 
-         if(it != mTypes.end())
+         // shared types (see registerSharedTypes) are owned by the holder they come from
+         if(it != mTypes.end() && it->second->mNamespace == pNamespace)
          {
             CflatInvokeDtor(Type, it->second);
-            CflatFree(it->second);
+            CflatDeallocate(it->second);
          }
 
          type->mParent = pParent;
@@ -677,6 +1065,12 @@ namespace Cflat
 
       void registerTypeAlias(const Identifier& pIdentifier, const TypeUsage& pTypeUsage);
       const TypeAlias* getTypeAlias(const Identifier& pIdentifier);
+
+      // registers the types and the type aliases of the given holder without taking ownership of
+      // the types, which get unregistered before releasing the holder through the namespace
+      // which owns the rest of them
+      void registerSharedTypes(TypesHolder* pSource);
+      void unregisterSharedTypes(const Namespace* pOwner);
    };
 
    class FunctionsHolder
@@ -700,6 +1094,10 @@ namespace Cflat
 
       CflatSTLVector(Function*)* getFunctions(const Identifier& pIdentifier);
       void getAllFunctions(CflatSTLVector(Function*)* pOutFunctions);
+
+      // same as with the shared types (see TypesHolder::registerSharedTypes)
+      void registerSharedFunctions(FunctionsHolder* pSource);
+      void unregisterSharedFunctions(const Namespace* pOwner);
    };
 
    class InstancesHolder
@@ -707,6 +1105,18 @@ namespace Cflat
    private:
       CflatSTLDeque(Instance) mInstances;
 
+      // instances are indexed by the hash of their identifiers: each bucket holds the index of the
+      // last instance registered in it, and each instance the index of the previous one in its bucket
+      CflatSTLVector(uint32_t) mBuckets;
+      CflatSTLVector(uint32_t) mPreviousInBucket;
+
+      static const uint32_t kInvalidIndex = UINT32_MAX;
+      static const size_t kInitialBucketsCount = 16u;
+
+      uint32_t* getBucket(Hash pHash);
+      void linkInstance(uint32_t pIndex);
+      void rebuildBuckets(size_t pBucketsCount);
+
    public:
       InstancesHolder();
       ~InstancesHolder();
@@ -716,8 +1126,13 @@ namespace Cflat
 
       Instance* registerInstance(const TypeUsage& pTypeUsage, const Identifier& pIdentifier);
       Instance* retrieveInstance(const Identifier& pIdentifier);
+      Instance* retrieveInstance(const Identifier& pIdentifier, size_t* pOutIndex);
+      void setInstanceIdentifier(size_t pIndex, const Identifier& pIdentifier);
       void releaseInstances(uint32_t pScopeLevel, bool pExecuteDestructors);
 
+      size_t getInstancesCount() const;
+      Instance* getInstance(size_t pIndex);
+
       void getAllInstances(CflatSTLVector(Instance*)* pOutInstances);
    };
 
@@ -754,6 +1169,21 @@ namespace Cflat
       FunctionsHolder mFunctionsHolder;
       InstancesHolder mInstancesHolder;
 
+      // positions of the special methods in mMethods, looked up again only when methods get added
+      size_t mDefaultConstructorIndex;
+      size_t mDestructorIndex;
+      size_t mCopyAssignmentOperatorIndex;
+      size_t mSpecialMethodsLookupMethodsCount;
+
+      // optional view of the elements of containers which store them contiguously, which allows
+      // range-based for loops to step through them without calling any methods (see
+      // CflatStructAddContiguousView)
+      typedef void* (*ContiguousDataGetter)(void* pThis);
+      typedef size_t (*ContiguousSizeGetter)(void* pThis);
+      ContiguousDataGetter mContiguousData;
+      ContiguousSizeGetter mContiguousSize;
+      TypeUsage mContiguousElementTypeUsage;
+
       Struct(Namespace* pNamespace, const Identifier& pIdentifier);
 
       virtual Hash getHash() const override;
@@ -761,6 +1191,11 @@ namespace Cflat
       bool derivedFrom(Type* pBaseType) const;
       uint16_t getOffset(Type* pBaseType) const;
 
+      Method* getDefaultConstructor();
+      Method* getDestructor();
+      Method* getCopyAssignmentOperator();
+      void lookUpSpecialMethods();
+
       template<typename T>
       T* registerType(const Identifier& pIdentifier)
       {
@@ -829,7 +1264,7 @@ namespace Cflat
    struct Token
    {
       TokenType mType;
-      char* mStart;
+      const char* mStart;
       size_t mLength;
       uint16_t mLine;
    };
@@ -839,10 +1274,15 @@ namespace Cflat
    {
    public:
       static void tokenize(const char* pCode, CflatSTLVector(Token)& pTokens);
+
+      // skips spaces, line breaks and comments, and returns false when reaching the end of the code
+      static bool skipBlanks(const char*& pCursor, uint16_t& pLine);
+      static Token readToken(const char*& pCursor, uint16_t pLine);
    };
 
 
    struct Expression;
+   struct ExpressionVariableAccess;
 
    struct Statement;
    struct StatementBlock;
@@ -850,7 +1290,6 @@ namespace Cflat
    struct StatementTypeDefinition;
    struct StatementNamespaceDeclaration;
    struct StatementVariableDeclaration;
-   struct StatementFunctionDeclaration;
    struct StatementStructDeclaration;
    struct StatementIf;
    struct StatementSwitch;
@@ -862,14 +1301,36 @@ namespace Cflat
    struct StatementContinue;
    struct StatementReturn;
 
+   struct Bytecode;
+
    class Environment;
+   class Profiler;
 
    struct Program
    {
       Identifier mIdentifier;
-      CflatSTLString mCode;
       CflatSTLVector(Statement*) mStatements;
 
+      // the nodes of the syntax tree live in the arena, so they get released in one go along
+      // with the program (their destructors still run, releasing the memory they own)
+      Memory::Arena mArena;
+
+      // hashes of the tokens of each top-level statement (and of the ones before its body, if
+      // any), used on reload to find out which function definitions have changed: they only
+      // take the lines relative to the first one, so the statements which have just been moved
+      // keep their hashes, and get their lines updated instead
+      struct StatementSource
+      {
+         Hash mHash;
+         Hash mHeaderHash;
+         uint16_t mLine;
+         Statement* mStatement;
+         // arena of a function definition which has replaced the original one on reload, released
+         // when it gets replaced again (null for the statements in the arena of the program)
+         Memory::Arena* mArena;
+      };
+      CflatSTLVector(StatementSource) mStatementSources;
+
       ~Program();
    };
 
@@ -899,10 +1360,15 @@ namespace Cflat
       const Identifier& getIdentifier() const;
       const Identifier& getFullIdentifier() const;
       Namespace* getParent();
+      Environment* getEnvironment();
 
       Namespace* getNamespace(const Identifier& pName);
       Namespace* requestNamespace(const Identifier& pName);
 
+      // shares the types and the functions of the given namespace and its children, which have to
+      // outlive this one, and copies their instances
+      void registerShared(Namespace* pSource);
+
       template<typename T>
       T* registerType(const Identifier& pIdentifier)
       {
@@ -1010,15 +1476,30 @@ namespace Cflat
       EnvironmentStack mStack;
 
    protected:
-      Context(ContextType pType, Namespace* pGlobalNamespace);
+      Context(ContextType pType, Namespace* pGlobalNamespace, size_t pStackSize, bool pGrowableStack);
    };
 
    struct ParsingContext : Context
    {
-      CflatSTLString mPreprocessedCode;
+      // source code being parsed: the tokens point into it, except for the ones which come from
+      // macro expansions, whose code is kept in the arena
+      const char* mCode;
+      Memory::Arena mMacroExpansionsArena;
+
+      // arena where the nodes of the syntax tree get allocated: the one of the program, unless
+      // the statements being parsed are going to be replaced or discarded on their own
+      Memory::Arena* mArena;
+
       CflatSTLVector(Token) mTokens;
       size_t mTokenIndex;
 
+      // for each bracket token, index of the token which matches it, so the parser can skip the
+      // tokens enclosed by a pair of brackets without scanning them (see matchBrackets)
+      CflatSTLVector(uint32_t) mMatchingTokenIndices;
+
+      // definition and body of each macro defined by the program, stored one after the other
+      CflatSTLVector(CflatSTLString) mMacroDefinitions;
+
       struct RegisteredInstance
       {
          Identifier mIdentifier;
@@ -1027,8 +1508,32 @@ namespace Cflat
       };
       CflatSTLVector(RegisteredInstance) mRegisteredInstances;
 
+      // constants of built-in types initialized with constant expressions, whose values are
+      // already known while parsing and get inlined into the expressions which read them
+      struct ConstantInstance
+      {
+         Instance* mInstance;
+         uint32_t mScopeLevel;
+      };
+      CflatSTLVector(ConstantInstance) mConstantInstances;
+
+      // static local variables, which live in their declarations instead of in a frame, and are
+      // only visible by name while parsing the scope they get declared in
+      struct StaticInstance
+      {
+         Instance* mInstance;
+         uint32_t mScopeLevel;
+      };
+      CflatSTLVector(StaticInstance) mStaticInstances;
+
       Identifier mCurrentFunctionIdentifier;
 
+      // index of the first local instance in the frame of the function being parsed, and index
+      // of the first local instance declared inside the switch being parsed (if any), since the
+      // latter are only registered during execution when their case section gets executed
+      size_t mLocalFrameBase;
+      size_t mSwitchLocalsBase;
+
       struct LocalNamespace
       {
          Namespace* mNamespace;
@@ -1048,6 +1553,62 @@ namespace Cflat
       Reinterpret
    };
 
+   enum class OperatorType : uint8_t
+   {
+      None,
+
+      // binary
+      Add,
+      Subtract,
+      Multiply,
+      Divide,
+      Modulo,
+      BitwiseAnd,
+      BitwiseOr,
+      BitwiseXor,
+      ShiftLeft,
+      ShiftRight,
+      Equal,
+      NotEqual,
+      Less,
+      Greater,
+      LessOrEqual,
+      GreaterOrEqual,
+      LogicalAnd,
+      LogicalOr,
+
+      // unary
+      LogicalNot,
+      BitwiseNot,
+      Negate,
+      Increment,
+      Decrement,
+      Dereference,
+
+      // assignment
+      Assign,
+      AddAssign,
+      SubtractAssign,
+      MultiplyAssign,
+      DivideAssign,
+      BitwiseAndAssign,
+      BitwiseOrAssign,
+
+      Count
+   };
+
+   // type-specialized implementation of a binary operation, chosen at parse time when both
+   // operands are known to be of the same built-in type (or when both are pointers)
+   enum class OperationKernel : uint8_t
+   {
+      Generic,
+      Int32,
+      Int64,
+      Float,
+      Double,
+      Pointer
+   };
+
    struct CallStackEntry
    {
       const Program* mProgram;
@@ -1067,13 +1628,193 @@ namespace Cflat
       Return
    };
 
+   // limits for each slice of a time-sliced function call (0 for no limit), which gets suspended
+   // once any of them is reached (see Environment::beginSlicedFunctionCall)
+   struct ExecutionBudget
+   {
+      uint32_t mInstructionsCount;
+      uint32_t mMicroseconds;
+   };
+
+   enum class ExecutionStatus : uint8_t
+   {
+      Completed,           // the call has returned
+      CompletedOverBudget, // the call has returned, but past the budget of its last slice, since
+                           // the calls it makes run to completion without getting suspended
+      Suspended,           // the call has run out of budget, and can be resumed
+      Failed               // the call has been interrupted by a runtime error (or it could not
+                           // be sliced, see Environment::beginSlicedFunctionCall)
+   };
+
+   struct SlicedCall
+   {
+      Function* mFunction;
+      Value* mReturnValue;
+      Profiler* mProfiler;
+
+      // size of the call stack while executing the function itself, which is the only level
+      // the call can get suspended at (nested calls always run to completion)
+      size_t mCallDepth;
+      size_t mPreviousLocalFrameBase;
+
+      // where the bytecode of the function continues once resumed
+      uint32_t mInstructionIndex;
+      uint32_t mBaseBlockLevel;
+      uint32_t mBaseScopeLevel;
+
+      // budget of the current slice
+      uint32_t mInstructionsBudget;
+      uint32_t mExecutedInstructionsCount;
+      uint64_t mDeadline;
+      bool mBudgetExhausted;
+
+      bool mSuspended;
+
+      SlicedCall();
+   };
+
    struct ExecutionContext : Context
    {
       JumpStatement mJumpStatement;
       Memory::StackVector<Value, kMaxNestedFunctionCalls> mReturnValues;
       CallStack mCallStack;
 
-      ExecutionContext(Namespace* pGlobalNamespace);
+      // index of the first local instance in the frame of the function being executed
+      size_t mLocalFrameBase;
+
+      // runtime errors are kept per context, so the contexts can run scripts concurrently
+      CflatSTLString mErrorMessage;
+
+      // state of the hooks which do not fire on every statement
+      const Program* mLineHookProgram;
+      uint16_t mLineHookLine;
+      size_t mLineHookCallDepth;
+      uint32_t mSampledHookCounter;
+      uint32_t mTimerHookCounter;
+      uint64_t mTimerHookTime;
+
+      // profiler attached to the context, if any (see Environment::setProfiler)
+      Profiler* mProfiler;
+
+      // time-sliced function call in progress, if any
+      SlicedCall mSlicedCall;
+
+      ExecutionContext(Namespace* pGlobalNamespace,
+         size_t pStackSize = kEnvironmentStackSize, bool pGrowableStack = false);
+   };
+
+   enum class ExecutionMode : uint8_t
+   {
+      SyntaxTree, // function bodies are executed walking the statement tree
+      Bytecode    // function bodies are lowered to a flat instruction stream after parsing
+   };
+
+   enum class FunctionHookEvent : uint8_t
+   {
+      Enter,
+      Exit
+   };
+
+   // runtime error raised by one of the elements of a batched function call
+   struct BatchCallError
+   {
+      size_t mElementIndex;
+      CflatSTLString mErrorMessage;
+   };
+
+   // call counts and timings (in nanoseconds) of the functions called while attached to an
+   // execution context (see Environment::setProfiler), both script and native ones, along with the
+   // time spent on each line of the programs, which includes the native calls made from them;
+   // profilers are not thread-safe, so the contexts running on other threads need profilers of
+   // their own, which can be merged afterwards
+   class Profiler
+   {
+   public:
+      struct FunctionRecord
+      {
+         const void* mFunction;
+         CflatSTLString mName;
+         uint64_t mCallsCount;
+         uint64_t mInclusiveTime;
+         uint64_t mExclusiveTime;
+         uint32_t mActiveCallsCount;
+      };
+
+      struct LineRecord
+      {
+         Identifier mProgramIdentifier;
+         uint16_t mLine;
+         uint64_t mExecutionsCount;
+         uint64_t mTime;
+      };
+
+      struct TraceEvent
+      {
+         size_t mFunctionRecordIndex;
+         uint64_t mStartTime;
+         uint64_t mDuration;
+         uint32_t mTrackIndex; // each merged profiler gets its own tracks in the trace
+      };
+
+   private:
+      struct Frame
+      {
+         size_t mFunctionRecordIndex;
+         uint64_t mStartTime;
+         uint64_t mChildrenTime;
+         size_t mCallerLineRecordIndex;
+         bool mScriptFunction;
+      };
+
+      typedef const void* FunctionKey;
+      typedef CflatSTLMap(FunctionKey, size_t) FunctionRecordsRegistry;
+      typedef CflatSTLMap(uint64_t, size_t) LineRecordsRegistry;
+
+      CflatSTLVector(FunctionRecord) mFunctionRecords;
+      FunctionRecordsRegistry mFunctionRecordsRegistry;
+      CflatSTLVector(LineRecord) mLineRecords;
+      LineRecordsRegistry mLineRecordsRegistry;
+      CflatSTLVector(TraceEvent) mTraceEvents;
+      CflatSTLVector(Frame) mFrames;
+
+      size_t mCurrentLineRecordIndex;
+      uint64_t mCurrentLineStartTime;
+      uint64_t mStartTime;
+      uint32_t mTracksCount;
+      bool mTraceEnabled;
+
+      size_t getFunctionRecordIndex(const void* pFunction, const Namespace* pNamespace,
+         const Type* pOwnerType, const Identifier& pIdentifier);
+      void beginCall(size_t pFunctionRecordIndex, bool pScriptFunction);
+      void chargeCurrentLine(uint64_t pTime);
+
+   public:
+      // the trace keeps an event per call, so it grows for as long as the profiler is attached
+      Profiler(bool pTraceEnabled = false);
+
+      void reset();
+
+      // adds the records and the trace events of the given profiler, which must not be attached
+      void merge(const Profiler& pOther);
+
+      const CflatSTLVector(FunctionRecord)& getFunctionRecords() const;
+      const CflatSTLVector(LineRecord)& getLineRecords() const;
+      const CflatSTLVector(TraceEvent)& getTraceEvents() const;
+
+      const FunctionRecord* getFunctionRecord(const char* pName) const;
+      const LineRecord* getLineRecord(const char* pProgramName, uint16_t pLine) const;
+
+      // functions sorted by exclusive time and lines sorted by time, as plain text
+      void writeReport(CflatSTLString* pOutReport) const;
+      // trace in the JSON format used by chrome://tracing and Perfetto
+      void writeChromeTrace(CflatSTLString* pOutTrace) const;
+
+      // invoked by the environment
+      void beginFunctionCall(const Function* pFunction);
+      void beginMethodCall(const Method* pMethod, const Type* pOwnerType);
+      void endCall();
+      void beginLine(const Program* pProgram, uint16_t pLine);
+      void endLine();
    };
 
 
@@ -1123,23 +1864,29 @@ namespace Cflat
          NullPointerAccess,
          InvalidArrayIndex,
          DivisionByZero,
+         StackOverflow,
 
          Count
       };
 
-      CflatSTLVector(Macro) mMacros;
+      Allocator* mAllocator;
+
+      typedef CflatSTLMap(Hash, Macro) MacrosRegistry;
+      MacrosRegistry mMacros;
 
       typedef CflatSTLMap(Hash, Program*) ProgramsRegistry;
       ProgramsRegistry mPrograms;
 
-      typedef Memory::StringsRegistry<kLiteralStringsPoolSize> LiteralStringsPool;
-      LiteralStringsPool mLiteralStringsPool;
+      // the literals of a program get released along with its syntax tree (e.g. when reloading it)
+      Memory::StringsPool mLiteralStringsPool;
 
-      typedef CflatSTLMap(uint64_t, Value) StaticValuesRegistry;
-      StaticValuesRegistry mStaticValues;
+      // serializes the initialization of static local variables, which runs only once, on the
+      // first execution context which gets to their declaration
+      std::recursive_mutex mStaticInitializationMutex;
 
       ParsingContext mTypesParsingContext;
       ExecutionContext mExecutionContext;
+      CflatSTLVector(ExecutionContext*) mExecutionContexts;
       CflatSTLString mErrorMessage;
 
       Namespace mGlobalNamespace;
@@ -1147,6 +1894,7 @@ namespace Cflat
       Type* mTypeAuto;
       Type* mTypeVoid;
       Type* mTypeInt32;
+      Type* mTypeInt64;
       Type* mTypeUInt32;
       Type* mTypeFloat;
       Type* mTypeDouble;
@@ -1159,8 +1907,34 @@ namespace Cflat
       typedef void (*ExecutionHook)(Environment* pEnvironment, const CallStack& pCallStack);
       ExecutionHook mExecutionHook;
 
+      // hooks which fire when the line being executed changes, every given number of statements
+      // and once the given time (in nanoseconds) has elapsed since the last time
+      ExecutionHook mLineHook;
+      ExecutionHook mSampledHook;
+      uint32_t mSampledHookInterval;
+      ExecutionHook mTimerHook;
+      uint64_t mTimerHookInterval;
+
+      typedef void (*FunctionHook)(Environment* pEnvironment, const CallStack& pCallStack,
+         FunctionHookEvent pEvent);
+      FunctionHook mFunctionHook;
+
+      // whether any of the above has to be invoked before each statement, so the execution
+      // only checks this flag (and the profiler of the context) when none of them is set
+      bool mStatementHooksEnabled;
+
+      ExecutionMode mExecutionMode;
+
+      // unique among all the environments created, so cached lookups can tell apart an
+      // environment created at the address of a destroyed one
+      uint32_t mId;
+
       void registerBuiltInTypes();
 
+      void updateStatementHooks();
+      void executeStatementHooks(ExecutionContext& pContext, const Statement* pStatement);
+      void resetTimerHook(ExecutionContext& pContext);
+
       TypeUsage parseTypeUsage(ParsingContext& pContext, size_t pTokenLastIndex);
 
       void throwPreprocessorError(ParsingContext& pContext, PreprocessorError pError,
@@ -1169,10 +1943,28 @@ namespace Cflat
          const char* pArg1 = "", const char* pArg2 = "");
       void throwCompileErrorUnexpectedSymbol(ParsingContext& pContext);
 
+      const Macro* findMacro(const Token& pToken);
       void preprocess(ParsingContext& pContext, const char* pCode);
-      void tokenize(ParsingContext& pContext);
+      bool preprocessDirective(ParsingContext& pContext, const char*& pCursor);
+      bool expandMacro(ParsingContext& pContext, const Macro& pMacro, const Token& pNameToken,
+         const char*& pCursor, uint16_t& pLine);
       void parse(ParsingContext& pContext);
 
+      Hash getMacrosHash();
+      bool readPrecompiledData(ParsingContext& pContext, const char* pCode,
+         const void* pData, size_t pDataSize);
+      void writePrecompiledData(ParsingContext& pContext, const char* pCode, Hash pMacrosHash,
+         CflatSTLVector(char)& pOutData);
+
+      bool load(const char* pProgramName, const char* pCode,
+         const void* pPrecompiledData, size_t pPrecompiledDataSize,
+         CflatSTLVector(char)* pOutPrecompiledData);
+      bool loadTokenized(ParsingContext& pContext);
+
+      bool getStatementSource(ParsingContext& pContext, size_t pFirstTokenIndex,
+         Program::StatementSource* pOutStatementSource, size_t* pOutLastTokenIndex);
+      void moveStatementLines(Statement* pStatement, int pLinesOffset);
+
       Expression* parseExpression(ParsingContext& pContext, size_t pTokenLastIndex,
          bool pNullAllowed = false);
       Expression* parseExpressionSingleToken(ParsingContext& pContext);
@@ -1188,6 +1980,7 @@ namespace Cflat
       Expression* parseExpressionMethodCall(ParsingContext& pContext, Expression* pMemberAccess);
       Expression* parseExpressionObjectConstruction(ParsingContext& pContext, Type* pType);
 
+      void matchBrackets(ParsingContext& pContext);
       size_t findClosureTokenIndex(ParsingContext& pContext, char pOpeningChar, char pClosureChar,
          size_t pTokenIndexLimit = 0u);
       size_t findOpeningTokenIndex(ParsingContext& pContext, char pOpeningChar, char pClosureChar,
@@ -1227,8 +2020,18 @@ namespace Cflat
 
       bool parseFunctionCallArguments(ParsingContext& pContext, CflatSTLVector(Expression*)* pArguments,
          CflatSTLVector(TypeUsage)* pTemplateTypes = nullptr);
+      void bindVariableAccess(ParsingContext& pContext, Instance* pInstance,
+         ExpressionVariableAccess* pVariableAccess);
 
       TypeUsage getTypeUsage(Context& pContext, Expression* pExpression);
+      OperationKernel getOperationKernel(const TypeUsage& pLeft, const TypeUsage& pRight);
+
+      static bool isFoldable(const TypeUsage& pTypeUsage);
+      const Value* getConstantValue(ParsingContext& pContext, Expression* pExpression);
+      void inlineConstant(ParsingContext& pContext, Expression** pExpression);
+      Expression* foldConstantExpression(ParsingContext& pContext, Expression* pExpression);
+      Statement* eliminateDeadBranches(ParsingContext& pContext, Statement* pStatement);
+      void buildSwitchCaseLookup(ParsingContext& pContext, StatementSwitch* pStatement);
 
       Type* findType(const Context& pContext, const Identifier& pIdentifier,
          const CflatArgsVector(TypeUsage)& pTemplateTypes = TypeUsage::kEmptyList);
@@ -1244,9 +2047,9 @@ namespace Cflat
 
       Instance* registerInstance(Context& pContext, const TypeUsage& pTypeUsage,
          const Identifier& pIdentifier);
-      Instance* registerStaticInstance(Context& pContext, const TypeUsage& pTypeUsage,
-         const Identifier& pIdentifier, void* pUniquePtr);
       Instance* retrieveInstance(Context& pContext, const Identifier& pIdentifier);
+      Instance* retrieveInstance(ExecutionContext& pContext,
+         const ExpressionVariableAccess* pVariableAccess);
 
       void incrementBlockLevel(Context& pContext);
       void decrementBlockLevel(Context& pContext);
@@ -1254,6 +2057,7 @@ namespace Cflat
       void decrementScopeLevel(Context& pContext);
 
       void throwRuntimeError(ExecutionContext& pContext, RuntimeError pError, const char* pArg = "");
+      void throwStackOverflowError(ExecutionContext& pContext);
 
       void evaluateExpression(ExecutionContext& pContext, Expression* pExpression, Value* pOutValue);
       void getInstanceDataValue(ExecutionContext& pContext, Expression* pExpression, Value* pOutValue);
@@ -1263,12 +2067,17 @@ namespace Cflat
       void prepareArgumentsForFunctionCall(ExecutionContext& pContext,
          const CflatSTLVector(TypeUsage)& pParameters, const CflatArgsVector(Value)& pOriginalValues,
          CflatArgsVector(Value)& pPreparedValues);
-      void applyUnaryOperator(ExecutionContext& pContext, const Value& pOperand, const char* pOperator,
+      void prepareArgumentsForNativeCall(ExecutionContext& pContext,
+         const CflatSTLVector(TypeUsage)& pParameters, const CflatArgsVector(Value)& pOriginalValues,
+         CflatArgsVector(Value)& pConvertedValues, const void** pOutArgumentsData);
+      void applyUnaryOperator(ExecutionContext& pContext, const Value& pOperand, OperatorType pOperator,
          Value* pOutValue);
       void applyBinaryOperator(ExecutionContext& pContext, const Value& pLeft, const Value& pRight,
-         const char* pOperator, Value* pOutValue);
+         OperatorType pOperator, Value* pOutValue);
+      void applyOverloadedBinaryOperator(ExecutionContext& pContext, const Value& pLeft,
+         const Value& pRight, Method* pOperatorMethod, Function* pOperatorFunction, Value* pOutValue);
       void performAssignment(ExecutionContext& pContext, const Value& pValue,
-         const char* pOperator, Value* pInstanceDataValue);
+         OperatorType pOperator, OperationKernel pKernel, Value* pInstanceDataValue);
       void performStaticCast(ExecutionContext& pContext, const Value& pValueToCast,
          const TypeUsage& pTargetTypeUsage, Value* pOutValue);
       void performIntegerCast(ExecutionContext& pContext, const Value& pValueToCast,
@@ -1308,11 +2117,47 @@ namespace Cflat
 
       void execute(ExecutionContext& pContext, const Program& pProgram);
       void execute(ExecutionContext& pContext, Statement* pStatement);
+      void execute(ExecutionContext& pContext, const Bytecode& pBytecode);
+      void initializeVariable(ExecutionContext& pContext, StatementVariableDeclaration* pStatement,
+         Instance* pInstance);
+      void execute(ExecutionContext& pContext, const Bytecode& pBytecode, uint32_t pInstructionIndex,
+         uint32_t pBaseBlockLevel, uint32_t pBaseScopeLevel);
+
+      ExecutionContext& getCurrentExecutionContext();
+
+      void beginFunctionCall(ExecutionContext& pContext, Function* pFunction, Value* pOutReturnValue);
+      void callFunction(ExecutionContext& pContext, Function* pFunction,
+         const CflatSTLVector(Expression*)& pArguments, Value* pOutReturnValue);
+      void callFunction(ExecutionContext& pContext, Function* pFunction,
+         const CflatArgsVector(Value)& pArguments, Value* pOutReturnValue);
+      void executeFunctionBody(ExecutionContext& pContext, Function* pFunction,
+         size_t pLocalFrameBase, Value* pOutReturnValue);
+      void endFunctionBody(ExecutionContext& pContext, Function* pFunction,
+         size_t pPreviousLocalFrameBase, Profiler* pProfiler, Value* pOutReturnValue);
+
+      void startExecutionBudget(SlicedCall& pCall, const ExecutionBudget& pBudget);
+      bool consumeExecutionBudget(SlicedCall& pCall);
+      ExecutionStatus endSlicedFunctionCall(ExecutionContext& pContext);
+      bool checkSuspendedSlicedCalls(const Program* pProgram, const Statement* pDeclaration);
 
    public:
-      Environment();
+      // the memory requested while the environment is in use (loading scripts, calling functions,
+      // registering types, ...) comes from the given allocator (the default one if none), which
+      // has to outlive both the environment and the memory it hands out (e.g. precompiled data)
+      Environment(Allocator* pAllocator = nullptr);
+      // clone of the given environment, which has to have no programs loaded: the types and the
+      // functions registered in it get shared instead of registered again, so it has to outlive
+      // the clone and remain unaltered, whereas its variables and macros get copied
+      Environment(Environment* pBaseEnvironment, Allocator* pAllocator = nullptr);
       ~Environment();
 
+      uint32_t getId() const;
+      Allocator* getAllocator();
+      const Memory::StringsPool::Stats& getLiteralStringsStats() const;
+      // reuses the memory of the literals released by replaced programs and functions, which
+      // remain valid until then (no script code must be executing while compacting)
+      void compactLiteralStrings();
+
       void defineMacro(const char* pDefinition, const char* pBody);
 
       Namespace* getGlobalNamespace();
@@ -1322,11 +2167,13 @@ namespace Cflat
       template<typename T>
       T* registerType(const Identifier& pIdentifier)
       {
+         Memory::AllocatorScope allocatorScope(mAllocator);
          return mGlobalNamespace.registerType<T>(pIdentifier);
       }
       template<typename T>
       T* registerTemplate(const Identifier& pIdentifier, const CflatArgsVector(TypeUsage)& pTemplateTypes)
       {
+         Memory::AllocatorScope allocatorScope(mAllocator);
          return mGlobalNamespace.registerTemplate<T>(pIdentifier, pTemplateTypes);
       }
       Type* getType(const Identifier& pIdentifier);
@@ -1343,6 +2190,29 @@ namespace Cflat
       void setVariable(const TypeUsage& pTypeUsage, const Identifier& pIdentifier, const Value& pValue);
       Value* getVariable(const Identifier& pIdentifier);
 
+      // additional contexts to execute script functions from other threads: the context set on a
+      // thread gets used by all function calls made from it (nullptr for the default context);
+      // each thread holds a single binding, so setting a context replaces the one another
+      // environment might have set on the thread, unlike ExecutionContextScope
+      ExecutionContext* createExecutionContext();
+      ExecutionContext* createExecutionContext(size_t pStackSize, bool pGrowableStack);
+      void destroyExecutionContext(ExecutionContext* pContext);
+      void setExecutionContext(ExecutionContext* pContext);
+
+      // binds the context to the calling thread while in scope, and restores the previous binding
+      // afterwards (which might belong to another environment), so it can be used from native
+      // functions called by scripts
+      class ExecutionContextScope
+      {
+      private:
+         const Environment* mPreviousEnvironment;
+         ExecutionContext* mPreviousContext;
+
+      public:
+         ExecutionContextScope(Environment* pEnvironment, ExecutionContext* pContext);
+         ~ExecutionContextScope();
+      };
+
       void voidFunctionCall(Function* pFunction);
       template<typename ...Args>
       void voidFunctionCall(Function* pFunction, Args... pArgs)
@@ -1352,7 +2222,8 @@ namespace Cflat
          constexpr size_t argsCount = sizeof...(Args);
          CflatAssert(argsCount == pFunction->mParameters.size());
 
-         mErrorMessage.clear();
+         Memory::AllocatorScope allocatorScope(mAllocator);
+         getCurrentExecutionContext().mErrorMessage.clear();
 
          Cflat::Value returnValue;
 
@@ -1378,10 +2249,13 @@ namespace Cflat
       {
          CflatAssert(pFunction);
 
-         mErrorMessage.clear();
+         Memory::AllocatorScope allocatorScope(mAllocator);
+
+         ExecutionContext& context = getCurrentExecutionContext();
+         context.mErrorMessage.clear();
 
          Cflat::Value returnValue;
-         returnValue.initOnStack(pFunction->mReturnTypeUsage, &mExecutionContext.mStack);
+         returnValue.initOnStack(pFunction->mReturnTypeUsage, &context.mStack);
 
          CflatArgsVector(Value) args;
 
@@ -1397,10 +2271,13 @@ namespace Cflat
          constexpr size_t argsCount = sizeof...(Args);
          CflatAssert(argsCount == pFunction->mParameters.size());
 
-         mErrorMessage.clear();
+         Memory::AllocatorScope allocatorScope(mAllocator);
+
+         ExecutionContext& context = getCurrentExecutionContext();
+         context.mErrorMessage.clear();
 
          Cflat::Value returnValue;
-         returnValue.initOnStack(pFunction->mReturnTypeUsage, &mExecutionContext.mStack);
+         returnValue.initOnStack(pFunction->mReturnTypeUsage, &context.mStack);
 
          CflatArgsVector(Value) args;
          initArgumentsForFunctionCall(pFunction, args);
@@ -1422,14 +2299,257 @@ namespace Cflat
          return *(reinterpret_cast<ReturnType*>(returnValue.mValueBuffer));
       }
 
+      // calls the function once per element, taking the data of each argument from its array at
+      // the given stride in bytes (0 to pass the same data to all the elements), and writing the
+      // return values (if any) the same way; the arguments and the return value are set up once
+      // for the whole batch, and the number of elements which failed gets returned, along with
+      // their errors in pOutErrors (if not null)
+      size_t batchFunctionCall(Function* pFunction, size_t pElementsCount,
+         const void* const* pArgumentsData, const size_t* pArgumentsStrides,
+         void* pOutReturnValuesData = nullptr, size_t pReturnValuesStride = 0u,
+         CflatSTLVector(BatchCallError)* pOutErrors = nullptr);
+
+      // calls the function with a budget for each slice of its execution (only script functions
+      // loaded in bytecode mode, the call fails otherwise), taking the data of the arguments as the
+      // native calls do; when the budget runs out, the call gets suspended at the next instruction
+      // of the function itself, keeping its state in the execution context until it gets resumed
+      // (or cancelled), and the return value has to stay valid until it completes; meanwhile,
+      // loading or reloading the program fails if it would replace the function
+      ExecutionStatus beginSlicedFunctionCall(Function* pFunction, const void* const* pArgumentsData,
+         Value* pOutReturnValue, const ExecutionBudget& pBudget);
+      ExecutionStatus resumeSlicedFunctionCall(const ExecutionBudget& pBudget);
+      void cancelSlicedFunctionCall();
+
       bool load(const char* pProgramName, const char* pCode);
       bool load(const char* pFilePath);
 
+      // loads the files one after the other, in the given order, as load does (stops at the first
+      // one which fails to load); the given threads only read and tokenize the files up front,
+      // allocating through the allocator of the environment (which has to be thread-safe, see
+      // Allocator), while preprocessing files with directives, parsing and executing stay serial
+      bool loadFiles(const char* const* pFilePaths, size_t pFilesCount, uint32_t pReadingThreadsCount);
+
+      // re-parses only the function definitions which have changed, keeping the state of the
+      // program; any other change makes it fall back to load
+      bool reload(const char* pProgramName, const char* pCode);
+
+      // the precompiled data holds the program already preprocessed and tokenized, and it is only
+      // used when it matches both the code and the macros defined in the environment
+      bool loadAndPrecompile(const char* pProgramName, const char* pCode,
+         CflatSTLVector(char)& pOutPrecompiledData);
+      bool loadPrecompiled(const char* pProgramName, const char* pCode,
+         const void* pPrecompiledData, size_t pPrecompiledDataSize);
+      bool isPrecompiledDataValid(const char* pCode,
+         const void* pPrecompiledData, size_t pPrecompiledDataSize);
+
       const char* getErrorMessage();
 
+      void setStackSize(size_t pStackSize, bool pGrowableStack = false);
       void setExecutionHook(ExecutionHook pExecutionHook);
+      void setLineHook(ExecutionHook pLineHook);
+      void setSampledHook(ExecutionHook pSampledHook, uint32_t pStatementsInterval);
+      void setTimerHook(ExecutionHook pTimerHook, uint32_t pIntervalMicroseconds);
+      void setFunctionHook(FunctionHook pFunctionHook);
+      // attaches the profiler to the execution context bound to the calling thread (see
+      // setExecutionContext), so it only records the calls made from that thread
+      void setProfiler(Profiler* pProfiler);
+      void setExecutionMode(ExecutionMode pExecutionMode);
+      // evaluates the expression in the scope of the program being executed, if any (e.g. from an
+      // execution hook), or in the global scope otherwise, without keeping anything of it around
       bool evaluateExpression(const char* pExpression, Value* pOutValue);
    };
+
+
+   //
+   //  Native calls
+   //
+   template<size_t ...Indices>
+   struct IndexSequence
+   {
+   };
+
+   template<size_t Count, size_t ...Indices>
+   struct MakeIndexSequence : MakeIndexSequence<Count - 1u, Count - 1u, Indices...>
+   {
+   };
+
+   template<size_t ...Indices>
+   struct MakeIndexSequence<0u, Indices...>
+   {
+      typedef IndexSequence<Indices...> Type;
+   };
+
+   template<typename T>
+   typename std::remove_reference<T>::type& getNativeArgument(const void* pData)
+   {
+      return *reinterpret_cast<typename std::remove_reference<T>::type*>(const_cast<void*>(pData));
+   }
+
+   template<typename ReturnType>
+   struct NativeCallInvoker
+   {
+      template<typename Callable>
+      static void invoke(void* pOutReturnValueData, const Callable& pCallable)
+      {
+         // same as 'Value::set', which is what the 'execute' functions use for the return value
+         const typename std::remove_reference<ReturnType>::type& returnValue = pCallable();
+
+         if(pOutReturnValueData)
+         {
+            memcpy(pOutReturnValueData, &returnValue, sizeof(returnValue));
+         }
+      }
+   };
+
+   template<typename ReturnType>
+   struct NativeCallInvoker<ReturnType&>
+   {
+      template<typename Callable>
+      static void invoke(void* pOutReturnValueData, const Callable& pCallable)
+      {
+         // the caller binds the return value to the address, as 'Value::set' does for references
+         ReturnType& returnValue = pCallable();
+
+         if(pOutReturnValueData)
+         {
+            *reinterpret_cast<const void**>(pOutReturnValueData) = &returnValue;
+         }
+      }
+   };
+
+   template<>
+   struct NativeCallInvoker<void>
+   {
+      template<typename Callable>
+      static void invoke(void*, const Callable& pCallable)
+      {
+         pCallable();
+      }
+   };
+
+   template<typename FunctionType, FunctionType pFunction>
+   struct NativeFunction;
+
+   template<typename ReturnType, typename ...Args, ReturnType(*pFunction)(Args...)>
+   struct NativeFunction<ReturnType(*)(Args...), pFunction>
+   {
+      static void call(void*, const void* const* pArgumentsData, void* pOutReturnValueData)
+      {
+         invoke(pArgumentsData, pOutReturnValueData, typename MakeIndexSequence<sizeof...(Args)>::Type());
+      }
+
+      template<size_t ...Indices>
+      static void invoke(const void* const* pArgumentsData, void* pOutReturnValueData,
+         IndexSequence<Indices...>)
+      {
+         (void)pArgumentsData;
+         NativeCallInvoker<ReturnType>::invoke(pOutReturnValueData, [pArgumentsData]() -> ReturnType
+         {
+            return pFunction(getNativeArgument<Args>(pArgumentsData[Indices])...);
+         });
+      }
+   };
+
+   template<typename MethodType, MethodType pMethod>
+   struct NativeMethod;
+
+   template<typename StructType, typename ReturnType, typename ...Args,
+      ReturnType(StructType::*pMethod)(Args...)>
+   struct NativeMethod<ReturnType(StructType::*)(Args...), pMethod>
+   {
+      static void call(void* pThis, const void* const* pArgumentsData, void* pOutReturnValueData)
+      {
+         invoke(static_cast<StructType*>(pThis), pArgumentsData, pOutReturnValueData,
+            typename MakeIndexSequence<sizeof...(Args)>::Type());
+      }
+
+      template<size_t ...Indices>
+      static void invoke(StructType* pThis, const void* const* pArgumentsData, void* pOutReturnValueData,
+         IndexSequence<Indices...>)
+      {
+         (void)pArgumentsData;
+         NativeCallInvoker<ReturnType>::invoke(pOutReturnValueData, [pThis, pArgumentsData]() -> ReturnType
+         {
+            return (pThis->*pMethod)(getNativeArgument<Args>(pArgumentsData[Indices])...);
+         });
+      }
+   };
+
+   template<typename StructType, typename ReturnType, typename ...Args,
+      ReturnType(StructType::*pMethod)(Args...) const>
+   struct NativeMethod<ReturnType(StructType::*)(Args...) const, pMethod>
+   {
+      static void call(void* pThis, const void* const* pArgumentsData, void* pOutReturnValueData)
+      {
+         invoke(static_cast<const StructType*>(pThis), pArgumentsData, pOutReturnValueData,
+            typename MakeIndexSequence<sizeof...(Args)>::Type());
+      }
+
+      template<size_t ...Indices>
+      static void invoke(const StructType* pThis, const void* const* pArgumentsData,
+         void* pOutReturnValueData, IndexSequence<Indices...>)
+      {
+         (void)pArgumentsData;
+         NativeCallInvoker<ReturnType>::invoke(pOutReturnValueData, [pThis, pArgumentsData]() -> ReturnType
+         {
+            return (pThis->*pMethod)(getNativeArgument<Args>(pArgumentsData[Indices])...);
+         });
+      }
+   };
+
+   // parses a comma-separated list of parameter types, as stringified by the native call macros
+   template<typename OwnerType>
+   void getNativeParameterTypes(OwnerType* pOwner, const char* pParameterTypes,
+      CflatSTLVector(TypeUsage)* pOutParameters)
+   {
+      char typeName[kDefaultLocalStringBufferSize];
+      size_t typeNameLength = 0u;
+      int templateLevel = 0;
+
+      for(const char* cursor = pParameterTypes; ; cursor++)
+      {
+         if(*cursor == '\0' || (*cursor == ',' && templateLevel == 0))
+         {
+            while(typeNameLength > 0u && typeName[typeNameLength - 1u] == ' ')
+            {
+               typeNameLength--;
+            }
+
+            if(typeNameLength > 0u)
+            {
+               typeName[typeNameLength] = '\0';
+               pOutParameters->push_back(pOwner->getTypeUsage(typeName));
+               CflatAssert(pOutParameters->back().mType);
+            }
+
+            if(*cursor == '\0')
+            {
+               break;
+            }
+
+            typeNameLength = 0u;
+            continue;
+         }
+
+         if(*cursor == '<')
+         {
+            templateLevel++;
+         }
+         else if(*cursor == '>')
+         {
+            templateLevel--;
+         }
+
+         if(typeNameLength > 0u || *cursor != ' ')
+         {
+            CflatAssert(typeNameLength < (kDefaultLocalStringBufferSize - 1u));
+            typeName[typeNameLength++] = *cursor;
+         }
+      }
+   }
+
+   void bindNativeCall(Function* pFunction, NativeCall pNativeCall);
+   void bindNativeCall(Method* pMethod, NativeCall pNativeCall);
 }
 
 
@@ -1459,7 +2579,7 @@ namespace Cflat
 //
 #define CflatRegisterFunctionVoid(pEnvironmentPtr, pVoid, pFunctionName) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
       { \
          CflatAssert(function->mParameters.size() == pArguments.size()); \
@@ -1469,7 +2589,7 @@ namespace Cflat
 #define CflatRegisterFunctionVoidParams1(pEnvironmentPtr, pVoid, pFunctionName, \
    pParam0Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
       { \
@@ -1484,7 +2604,7 @@ namespace Cflat
    pParam0Type, \
    pParam1Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
@@ -1502,7 +2622,7 @@ namespace Cflat
    pParam1Type, \
    pParam2Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam2Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1523,7 +2643,7 @@ namespace Cflat
    pParam2Type, \
    pParam3Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam2Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1547,7 +2667,7 @@ namespace Cflat
    pParam3Type, \
    pParam4Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam2Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1568,7 +2688,7 @@ namespace Cflat
    }
 #define CflatRegisterFunctionReturn(pEnvironmentPtr, pReturnType, pFunctionName) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
       { \
@@ -1582,7 +2702,7 @@ namespace Cflat
 #define CflatRegisterFunctionReturnParams1(pEnvironmentPtr, pReturnType, pFunctionName, \
    pParam0Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
@@ -1601,7 +2721,7 @@ namespace Cflat
    pParam0Type, \
    pParam1Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1623,7 +2743,7 @@ namespace Cflat
    pParam1Type, \
    pParam2Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1648,7 +2768,7 @@ namespace Cflat
    pParam2Type, \
    pParam3Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1676,7 +2796,7 @@ namespace Cflat
    pParam3Type, \
    pParam4Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1702,7 +2822,7 @@ namespace Cflat
 
 #define CflatRegisterTemplateFunctionVoid(pEnvironmentPtr, pTemplateType, pVoid, pFunctionName) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
       { \
@@ -1713,7 +2833,7 @@ namespace Cflat
 #define CflatRegisterTemplateFunctionVoidParams1(pEnvironmentPtr, pTemplateType, pVoid, pFunctionName, \
    pParam0Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
@@ -1729,7 +2849,7 @@ namespace Cflat
    pParam0Type, \
    pParam1Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1748,7 +2868,7 @@ namespace Cflat
    pParam1Type, \
    pParam2Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1770,7 +2890,7 @@ namespace Cflat
    pParam2Type, \
    pParam3Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1795,7 +2915,7 @@ namespace Cflat
    pParam3Type, \
    pParam4Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1817,7 +2937,7 @@ namespace Cflat
    }
 #define CflatRegisterTemplateFunctionReturn(pEnvironmentPtr, pTemplateType, pReturnType, pFunctionName) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
@@ -1832,7 +2952,7 @@ namespace Cflat
 #define CflatRegisterTemplateFunctionReturnParams1(pEnvironmentPtr, pTemplateType, pReturnType, pFunctionName, \
    pParam0Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1852,7 +2972,7 @@ namespace Cflat
    pParam0Type, \
    pParam1Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1875,7 +2995,7 @@ namespace Cflat
    pParam1Type, \
    pParam2Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1901,7 +3021,7 @@ namespace Cflat
    pParam2Type, \
    pParam3Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1930,7 +3050,7 @@ namespace Cflat
    pParam3Type, \
    pParam4Type) \
    { \
-      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(#pFunctionName); \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -1956,13 +3076,26 @@ namespace Cflat
    }
 
 
+//
+//  Native function definition (typed entry point, called by scripts with the argument data)
+//
+#define CflatRegisterNativeFunction(pEnvironmentPtr, pReturnType, pFunctionName, ...) \
+   { \
+      Cflat::Function* function = (pEnvironmentPtr)->registerFunction(CflatIdentifier(#pFunctionName)); \
+      function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
+      Cflat::getNativeParameterTypes(pEnvironmentPtr, #__VA_ARGS__, &function->mParameters); \
+      Cflat::bindNativeCall(function, \
+         &Cflat::NativeFunction<pReturnType(*)(__VA_ARGS__), &pFunctionName>::call); \
+   }
+
+
 
 //
 //  Type definition: Built-in types
 //
 #define CflatRegisterBuiltInType(pEnvironmentPtr, pType) \
    { \
-      Cflat::BuiltInType* type = (pEnvironmentPtr)->registerType<Cflat::BuiltInType>(#pType); \
+      Cflat::BuiltInType* type = (pEnvironmentPtr)->registerType<Cflat::BuiltInType>(CflatIdentifier(#pType)); \
       type->mSize = sizeof(pType); \
    }
 
@@ -1971,21 +3104,21 @@ namespace Cflat
 //  Type definition: Enums
 //
 #define CflatRegisterEnum(pOwnerPtr, pType) \
-   Cflat::Enum* type = (pOwnerPtr)->registerType<Cflat::Enum>(#pType); \
+   Cflat::Enum* type = (pOwnerPtr)->registerType<Cflat::Enum>(CflatIdentifier(#pType)); \
    type->mSize = sizeof(pType);
 #define CflatRegisterNestedEnum(pOwnerPtr, pParentType, pType) \
    using pType = pParentType::pType; \
-   CflatRegisterEnum(static_cast<Cflat::Struct*>((pOwnerPtr)->getType(#pParentType)), pType);
+   CflatRegisterEnum(static_cast<Cflat::Struct*>((pOwnerPtr)->getType(CflatIdentifier(#pParentType))), pType);
 
 #define CflatEnumAddValue(pOwnerPtr, pType, pValueName) \
    { \
       const pType enumValueInstance = pValueName; \
       Cflat::Value enumValue; \
-      enumValue.mTypeUsage.mType = (pOwnerPtr)->getType(#pType); \
+      enumValue.mTypeUsage.mType = (pOwnerPtr)->getType(CflatIdentifier(#pType)); \
       CflatSetFlag(enumValue.mTypeUsage.mFlags, Cflat::TypeUsageFlags::Const); \
       enumValue.initOnHeap(enumValue.mTypeUsage); \
       enumValue.set(&enumValueInstance); \
-      const Cflat::Identifier identifier(#pValueName); \
+      const Cflat::Identifier identifier(CflatIdentifier(#pValueName)); \
       (pOwnerPtr)->setVariable(enumValue.mTypeUsage, identifier, enumValue); \
    }
 #define CflatNestedEnumAddValue(pOwnerPtr, pParentType, pType, pValueName) \
@@ -1994,8 +3127,8 @@ namespace Cflat
       Cflat::TypeUsage enumTypeUsage; \
       enumTypeUsage.mType = type; \
       CflatSetFlag(enumTypeUsage.mFlags, Cflat::TypeUsageFlags::Const); \
-      const Cflat::Identifier identifier(#pValueName); \
-      Cflat::Struct* parentType = static_cast<Cflat::Struct*>((pOwnerPtr)->getType(#pParentType)); \
+      const Cflat::Identifier identifier(CflatIdentifier(#pValueName)); \
+      Cflat::Struct* parentType = static_cast<Cflat::Struct*>((pOwnerPtr)->getType(CflatIdentifier(#pParentType))); \
       Cflat::Instance* instance = parentType->mInstancesHolder.registerInstance(enumTypeUsage, identifier); \
       instance->mValue.initOnHeap(enumTypeUsage); \
       instance->mValue.set(&enumValueInstance); \
@@ -2006,19 +3139,19 @@ namespace Cflat
 //  Type definition: EnumClasses
 //
 #define CflatRegisterEnumClass(pOwnerPtr, pType) \
-   Cflat::EnumClass* type = (pOwnerPtr)->registerType<Cflat::EnumClass>(#pType); \
+   Cflat::EnumClass* type = (pOwnerPtr)->registerType<Cflat::EnumClass>(CflatIdentifier(#pType)); \
    type->mSize = sizeof(pType);
 
 #define CflatEnumClassAddValue(pOwnerPtr, pType, pValueName) \
    { \
       const pType enumValueInstance = pType::pValueName; \
       Cflat::Value enumValue; \
-      enumValue.mTypeUsage.mType = (pOwnerPtr)->getType(#pType); \
+      enumValue.mTypeUsage.mType = (pOwnerPtr)->getType(CflatIdentifier(#pType)); \
       CflatSetFlag(enumValue.mTypeUsage.mFlags, Cflat::TypeUsageFlags::Const); \
       enumValue.initOnHeap(enumValue.mTypeUsage); \
       enumValue.set(&enumValueInstance); \
-      const Cflat::Identifier identifier(#pValueName); \
-      Cflat::Namespace* ns = (pOwnerPtr)->requestNamespace(#pType); \
+      const Cflat::Identifier identifier(CflatIdentifier(#pValueName)); \
+      Cflat::Namespace* ns = (pOwnerPtr)->requestNamespace(CflatIdentifier(#pType)); \
       ns->setVariable(enumValue.mTypeUsage, identifier, enumValue); \
    }
 
@@ -2027,16 +3160,16 @@ namespace Cflat
 //  Type definition: Structs
 //
 #define CflatRegisterStruct(pOwnerPtr, pType) \
-   Cflat::Struct* type = (pOwnerPtr)->registerType<Cflat::Struct>(#pType); \
+   Cflat::Struct* type = (pOwnerPtr)->registerType<Cflat::Struct>(CflatIdentifier(#pType)); \
    type->mSize = sizeof(pType);
 #define CflatRegisterNestedStruct(pOwnerPtr, pParentType, pType) \
    using pType = pParentType::pType; \
-   CflatRegisterStruct(static_cast<Cflat::Struct*>((pOwnerPtr)->getType(#pParentType)), pType);
+   CflatRegisterStruct(static_cast<Cflat::Struct*>((pOwnerPtr)->getType(CflatIdentifier(#pParentType))), pType);
 
 #define CflatStructAddBaseType(pEnvironmentPtr, pType, pBaseType) \
    { \
       Cflat::BaseType baseType; \
-      baseType.mType = (pEnvironmentPtr)->getType(#pBaseType); CflatValidateType(baseType.mType); \
+      baseType.mType = (pEnvironmentPtr)->getType(CflatIdentifier(#pBaseType)); CflatValidateType(baseType.mType); \
       pType* derivedTypePtr = reinterpret_cast<pType*>(0x1); \
       pBaseType* baseTypePtr = static_cast<pBaseType*>(derivedTypePtr); \
       baseType.mOffset = (uint16_t)((char*)baseTypePtr - (char*)derivedTypePtr); \
@@ -2054,7 +3187,7 @@ namespace Cflat
    }
 #define CflatStructAddMember(pEnvironmentPtr, pStructType, pMemberType, pMemberName) \
    { \
-      Cflat::Member member(#pMemberName); \
+      Cflat::Member member(CflatIdentifier(#pMemberName)); \
       member.mTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pMemberType); CflatValidateTypeUsage(member.mTypeUsage); \
       member.mTypeUsage.mArraySize = (uint16_t)(sizeof(pStructType::pMemberName) / sizeof(pMemberType)); \
       member.mOffset = (uint16_t)offsetof(pStructType, pMemberName); \
@@ -2067,7 +3200,20 @@ namespace Cflat
       Cflat::Value value; \
       value.initExternal(typeUsage); \
       value.set(&pStructType::pMemberName); \
-      static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->setStaticMember(typeUsage, #pMemberName, value); \
+      static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->setStaticMember(typeUsage, #pMemberName, value); \
+   }
+#define CflatStructAddContiguousView(pEnvironmentPtr, pStructType, pElementType) \
+   { \
+      type->mContiguousElementTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pElementType); \
+      CflatValidateTypeUsage(type->mContiguousElementTypeUsage); \
+      type->mContiguousData = [](void* pThis) -> void* \
+      { \
+         return (void*)reinterpret_cast<pStructType*>(pThis)->data(); \
+      }; \
+      type->mContiguousSize = [](void* pThis) -> size_t \
+      { \
+         return (size_t)reinterpret_cast<pStructType*>(pThis)->size(); \
+      }; \
    }
 #define CflatStructAddConstructor(pEnvironmentPtr, pStructType) \
    { \
@@ -2412,7 +3558,7 @@ namespace Cflat
 
 #define CflatStructAddStaticMethodVoid(pEnvironmentPtr, pStructType, pVoid, pMethodName) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
       { \
          CflatAssert(function->mParameters.size() == pArguments.size()); \
@@ -2422,7 +3568,7 @@ namespace Cflat
 #define CflatStructAddStaticMethodVoidParams1(pEnvironmentPtr, pStructType, pVoid, pMethodName, \
    pParam0Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
       { \
@@ -2437,7 +3583,7 @@ namespace Cflat
    pParam0Type, \
    pParam1Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
@@ -2455,7 +3601,7 @@ namespace Cflat
    pParam1Type, \
    pParam2Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam2Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2476,7 +3622,7 @@ namespace Cflat
    pParam2Type, \
    pParam3Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam2Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2500,7 +3646,7 @@ namespace Cflat
    pParam3Type, \
    pParam4Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam2Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2521,7 +3667,7 @@ namespace Cflat
    }
 #define CflatStructAddStaticMethodReturn(pEnvironmentPtr, pStructType, pReturnType, pMethodName) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
       { \
@@ -2535,7 +3681,7 @@ namespace Cflat
 #define CflatStructAddStaticMethodReturnParams1(pEnvironmentPtr, pStructType, pReturnType, pMethodName, \
    pParam0Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
@@ -2554,7 +3700,7 @@ namespace Cflat
    pParam0Type, \
    pParam1Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2576,7 +3722,7 @@ namespace Cflat
    pParam1Type, \
    pParam2Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2601,7 +3747,7 @@ namespace Cflat
    pParam2Type, \
    pParam3Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2629,7 +3775,7 @@ namespace Cflat
    pParam3Type, \
    pParam4Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2655,7 +3801,7 @@ namespace Cflat
 
 #define CflatStructAddStaticTemplateMethodVoid(pEnvironmentPtr, pStructType, pTemplateType, pVoid, pMethodName) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
       { \
@@ -2666,7 +3812,7 @@ namespace Cflat
 #define CflatStructAddStaticTemplateMethodVoidParams1(pEnvironmentPtr, pStructType, pTemplateType, pVoid, pMethodName, \
    pParam0Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
@@ -2682,7 +3828,7 @@ namespace Cflat
    pParam0Type, \
    pParam1Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2701,7 +3847,7 @@ namespace Cflat
    pParam1Type, \
    pParam2Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2723,7 +3869,7 @@ namespace Cflat
    pParam2Type, \
    pParam3Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2748,7 +3894,7 @@ namespace Cflat
    pParam3Type, \
    pParam4Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam1Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2770,7 +3916,7 @@ namespace Cflat
    }
 #define CflatStructAddStaticTemplateMethodReturn(pEnvironmentPtr, pStructType, pTemplateType, pReturnType, pMethodName) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->execute = [function](const CflatArgsVector(Cflat::Value)& pArguments, Cflat::Value* pOutReturnValue) \
@@ -2785,7 +3931,7 @@ namespace Cflat
 #define CflatStructAddStaticTemplateMethodReturnParams1(pEnvironmentPtr, pStructType, pTemplateType, pReturnType, pMethodName, \
    pParam0Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2805,7 +3951,7 @@ namespace Cflat
    pParam0Type, \
    pParam1Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2828,7 +3974,7 @@ namespace Cflat
    pParam1Type, \
    pParam2Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2854,7 +4000,7 @@ namespace Cflat
    pParam2Type, \
    pParam3Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2883,7 +4029,7 @@ namespace Cflat
    pParam3Type, \
    pParam4Type) \
    { \
-      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(#pStructType))->registerStaticMethod(#pMethodName); \
+      Cflat::Function* function = static_cast<Cflat::Struct*>((pEnvironmentPtr)->getType(CflatIdentifier(#pStructType)))->registerStaticMethod(CflatIdentifier(#pMethodName)); \
       function->mTemplateTypes.push_back((pEnvironmentPtr)->getTypeUsage(#pTemplateType)); CflatValidateTypeUsage(function->mTemplateTypes.back()); \
       function->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(function->mReturnTypeUsage); \
       function->mParameters.push_back((pEnvironmentPtr)->getTypeUsage(#pParam0Type)); CflatValidateTypeUsage(function->mParameters.back()); \
@@ -2908,16 +4054,29 @@ namespace Cflat
       }; \
    }
 
+#define CflatStructAddNativeMethod(pEnvironmentPtr, pStructType, pReturnType, pMethodName, ...) \
+   { \
+      _CflatStructAddMethod(pEnvironmentPtr, pStructType, pMethodName); \
+      _CflatStructNativeMethodDefine(pEnvironmentPtr, pStructType, pReturnType, pMethodName, \
+         pReturnType(pStructType::*)(__VA_ARGS__), __VA_ARGS__); \
+   }
+#define CflatStructAddNativeConstMethod(pEnvironmentPtr, pStructType, pReturnType, pMethodName, ...) \
+   { \
+      _CflatStructAddMethod(pEnvironmentPtr, pStructType, pMethodName); \
+      _CflatStructNativeMethodDefine(pEnvironmentPtr, pStructType, pReturnType, pMethodName, \
+         pReturnType(pStructType::*)(__VA_ARGS__) const, __VA_ARGS__); \
+   }
+
 
 //
 //  Type definition: Classes
 //
 #define CflatRegisterClass(pOwnerPtr, pType) \
-   Cflat::Class* type = (pOwnerPtr)->registerType<Cflat::Class>(#pType); \
+   Cflat::Class* type = (pOwnerPtr)->registerType<Cflat::Class>(CflatIdentifier(#pType)); \
    type->mSize = sizeof(pType);
 #define CflatRegisterNestedClass(pOwnerPtr, pParentType, pType) \
    using pType = pParentType::pType; \
-   CflatRegisterClass(static_cast<Cflat::Struct*>((pOwnerPtr)->getType(#pParentType)), pType);
+   CflatRegisterClass(static_cast<Cflat::Struct*>((pOwnerPtr)->getType(CflatIdentifier(#pParentType))), pType);
 
 #define CflatClassAddBaseType(pEnvironmentPtr, pType, pBaseType) \
    { \
@@ -2993,6 +4152,10 @@ namespace Cflat
    { \
       CflatStructAddDestructor(pEnvironmentPtr, pClassType) \
    }
+#define CflatClassAddContiguousView(pEnvironmentPtr, pClassType, pElementType) \
+   { \
+      CflatStructAddContiguousView(pEnvironmentPtr, pClassType, pElementType) \
+   }
 #define CflatClassAddMethodVoid(pEnvironmentPtr, pClassType, pVoid, pMethodName) \
    { \
       CflatStructAddMethodVoid(pEnvironmentPtr, pClassType, pVoid, pMethodName) \
@@ -3430,6 +4593,16 @@ namespace Cflat
    }
 
 
+#define CflatClassAddNativeMethod(pEnvironmentPtr, pClassType, pReturnType, pMethodName, ...) \
+   { \
+      CflatStructAddNativeMethod(pEnvironmentPtr, pClassType, pReturnType, pMethodName, __VA_ARGS__); \
+   }
+#define CflatClassAddNativeConstMethod(pEnvironmentPtr, pClassType, pReturnType, pMethodName, ...) \
+   { \
+      CflatStructAddNativeConstMethod(pEnvironmentPtr, pClassType, pReturnType, pMethodName, __VA_ARGS__); \
+   }
+
+
 //
 //  Type definition: Templates
 //
@@ -3474,7 +4647,7 @@ namespace Cflat
    }
 #define _CflatStructAddMethod(pEnvironmentPtr, pStructType, pMethodName) \
    { \
-      Cflat::Method method(#pMethodName); \
+      Cflat::Method method(CflatIdentifier(#pMethodName)); \
       type->mMethods.push_back(method); \
    }
 #define _CflatStructConstructorDefine(pEnvironmentPtr, pStructType) \
@@ -3891,6 +5064,14 @@ namespace Cflat
          pOutReturnValue->set(&result); \
       }; \
    }
+#define _CflatStructNativeMethodDefine(pEnvironmentPtr, pStructType, pReturnType, pMethodName, \
+      pMethodType, ...) \
+   { \
+      Cflat::Method* method = &type->mMethods.back(); \
+      method->mReturnTypeUsage = (pEnvironmentPtr)->getTypeUsage(#pReturnType); CflatValidateTypeUsage(method->mReturnTypeUsage); \
+      Cflat::getNativeParameterTypes(pEnvironmentPtr, #__VA_ARGS__, &method->mParameters); \
+      Cflat::bindNativeCall(method, &Cflat::NativeMethod<pMethodType, &pStructType::pMethodName>::call); \
+   }
 #define _CflatStructMethodDefineTemplateType(pEnvironmentPtr, pStructType, pMethodName, pTemplateType) \
    { \
       Cflat::Method* method = &type->mMethods.back(); \
@@ -41,14 +41,30 @@ namespace Cflat
   static const size_t kArgsVectorSize = 16u;
   // Maximum number of nested function calls in an execution context
   static const size_t kMaxNestedFunctionCalls = 16u;
+  // Size in bytes of the buffer within each value, which holds the data of small types
+  // (scalars, pointers) without using the environment stack or the heap
+  static const size_t kValueInlineBufferSize = 16u;
 
-  // Size in bytes for the strings pool used to hold identifiers
+  // Size in bytes for each of the chunks of the strings pool used to hold identifiers
   static const size_t kIdentifierStringsPoolSize = 32768u;
-  // Size in bytes for the strings pool used to hold literals
+  // Initial number of slots in the table of identifier names (must be a power of two)
+  static const size_t kIdentifierNamesTableInitialCapacity = 1024u;
+  // Size in bytes for each of the chunks of the strings pool used to hold literals
   static const size_t kLiteralStringsPoolSize = 4096u;
 
-  // Size in bytes for the environment stack
+  // Default size in bytes for the environment stack (for each of its segments, if growable)
   static const size_t kEnvironmentStackSize = 8192u;
+  // Size in bytes for each of the segments of the stack used while parsing
+  static const size_t kParsingStackSegmentSize = 1024u;
+  // Size in bytes for each of the chunks of the arena which holds the syntax tree of a program
+  static const size_t kProgramArenaChunkSize = 16384u;
+  // Size in bytes for each of the chunks of the arenas which hold the function definitions
+  // replaced on reload
+  static const size_t kFunctionArenaChunkSize = 4096u;
+
+  // Number of statements executed between checks of the clock, while a timer hook is set (also
+  // the number of instructions between checks of the time budget of a time-sliced call)
+  static const uint32_t kTimerHookCheckInterval = 64u;
 
   // Size in bytes for local string buffers
   static const size_t kDefaultLocalStringBufferSize = 256u;
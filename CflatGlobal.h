@@ -79,13 +79,19 @@ namespace CflatGlobal
    CflatValueAsArray(CflatGlobal::getEnvironment()->getVariable(#pIdentifier), pElementType)
 
 //
-//  Function calls
+//  Function calls (each call site looks the function up only once per environment and thread)
 //
 # define CflatArg(pArg) &pArg
 # define CflatVoidCall(pFunction, ...) \
    { \
       Cflat::Environment* env = CflatGlobal::getEnvironment(); \
-      Cflat::Function* function = env->getFunction(#pFunction); \
+      thread_local Cflat::Function* function = nullptr; \
+      thread_local uint32_t functionEnvironmentId = 0u; \
+      if(functionEnvironmentId != env->getId()) \
+      { \
+         function = env->getFunction(#pFunction); \
+         functionEnvironmentId = function ? env->getId() : 0u; \
+      } \
       if(function) \
       { \
          env->voidFunctionCall(function, __VA_ARGS__); \
@@ -98,7 +104,13 @@ namespace CflatGlobal
 # define CflatReturnCall(pLValue, pReturnType, pFunction, ...) \
    { \
       Cflat::Environment* env = CflatGlobal::getEnvironment(); \
-      Cflat::Function* function = env->getFunction(#pFunction); \
+      thread_local Cflat::Function* function = nullptr; \
+      thread_local uint32_t functionEnvironmentId = 0u; \
+      if(functionEnvironmentId != env->getId()) \
+      { \
+         function = env->getFunction(#pFunction); \
+         functionEnvironmentId = function ? env->getId() : 0u; \
+      } \
       if(function) \
       { \
          pLValue = env->returnFunctionCall<pReturnType>(function, __VA_ARGS__); \
@@ -93,6 +93,17 @@ namespace Cflat
 #define CflatRegisterSTLVector(pEnvironmentPtr, T) \
    CflatRegisterSTLVectorCustom(pEnvironmentPtr, std::vector, T)
 #define CflatRegisterSTLVectorCustom(pEnvironmentPtr, pContainer, T) \
+   _CflatRegisterSTLVectorCustom(pEnvironmentPtr, pContainer, T, {})
+
+// range-based for loops over vectors registered this way step through the elements in place,
+// through data() and size(), instead of calling the iterator methods for each element
+#define CflatRegisterSTLVectorContiguous(pEnvironmentPtr, T) \
+   CflatRegisterSTLVectorContiguousCustom(pEnvironmentPtr, std::vector, T)
+#define CflatRegisterSTLVectorContiguousCustom(pEnvironmentPtr, pContainer, T) \
+   _CflatRegisterSTLVectorCustom(pEnvironmentPtr, pContainer, T, \
+      CflatClassAddContiguousView(pEnvironmentPtr, pContainer<T>, T))
+
+#define _CflatRegisterSTLVectorCustom(pEnvironmentPtr, pContainer, T, pContiguousView) \
    { \
       CflatRegisterTemplateClassTypes1(pEnvironmentPtr, pContainer, T); \
       CflatClassAddConstructor(pEnvironmentPtr, pContainer<T>); \
@@ -249,6 +260,7 @@ namespace Cflat
          }; \
          type->mMethods.push_back(method); \
       } \
+      pContiguousView \
    }
 #define CflatRegisterSTLMap(pEnvironmentPtr, K, V) \
    CflatRegisterSTLMapCustom(pEnvironmentPtr, std::map, std::pair, K, V)
@@ -0,0 +1,584 @@
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//  Cflat benchmarks
+//
+//  Each benchmark reports the average time per run, along with the number of
+//  allocations and releases per run, counted through Cflat::Memory.
+//
+//  Usage: benchmarks [name filter]
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "../CflatHelper.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+   size_t gAllocationsCount = 0u;
+   size_t gReleasesCount = 0u;
+
+   const char* gNameFilter = nullptr;
+
+   void* countedMalloc(size_t pSize)
+   {
+      gAllocationsCount++;
+      return ::malloc(pSize);
+   }
+
+   void countedFree(void* pPtr)
+   {
+      if(pPtr)
+      {
+         gReleasesCount++;
+      }
+
+      ::free(pPtr);
+   }
+
+   template<typename Run>
+   void measure(const char* pName, uint32_t pRunsCount, Run pRun)
+   {
+      if(gNameFilter && !strstr(pName, gNameFilter))
+         return;
+
+      // the first run warms up the caches (and any lazy initialization), so it does not count
+      pRun();
+
+      const size_t allocationsCount = gAllocationsCount;
+      const size_t releasesCount = gReleasesCount;
+      const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+      for(uint32_t i = 0u; i < pRunsCount; i++)
+      {
+         pRun();
+      }
+
+      const std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+      const double elapsedMicroseconds =
+         std::chrono::duration<double, std::micro>(endTime - startTime).count();
+
+      printf("%-28s %10u %16.3f %16.1f %16.1f\n",
+         pName,
+         pRunsCount,
+         elapsedMicroseconds / (double)pRunsCount,
+         (double)(gAllocationsCount - allocationsCount) / (double)pRunsCount,
+         (double)(gReleasesCount - releasesCount) / (double)pRunsCount);
+   }
+
+   void load(Cflat::Environment& pEnv, const char* pProgramName, const char* pCode)
+   {
+      if(!pEnv.load(pProgramName, pCode))
+      {
+         printf("Error loading '%s': %s\n", pProgramName, pEnv.getErrorMessage());
+         exit(1);
+      }
+   }
+
+   int nativeAdd(int pA, int pB)
+   {
+      return pA + pB;
+   }
+
+   class Accumulator
+   {
+   private:
+      int mTotal;
+
+   public:
+      Accumulator() : mTotal(0) {}
+
+      void add(int pValue) { mTotal += pValue; }
+      int getTotal() const { return mTotal; }
+   };
+
+   std::string generateLargeScript(int pFunctionsCount, int pChangedFunctionIndex = -1)
+   {
+      std::string code;
+      char buffer[256];
+
+      code.append("int counter = 0;\n");
+
+      for(int i = 0; i < pFunctionsCount; i++)
+      {
+         snprintf(buffer, sizeof(buffer),
+            "int function%d(int pValue)\n"
+            "{\n"
+            "  int result = pValue * %d + 1;\n"
+            "  for(int i = 0; i < 4; i++)\n"
+            "  {\n"
+            "    if(result > %d)\n"
+            "    {\n"
+            "      result = result - i;\n"
+            "    }\n"
+            "  }\n"
+            "  counter = counter + %d;\n"
+            "  return result;\n"
+            "}\n",
+            i, i % 7, i * 3, i == pChangedFunctionIndex ? 2 : 1);
+         code.append(buffer);
+      }
+
+      return code;
+   }
+}
+
+
+void benchmarkArithmeticLoop()
+{
+   Cflat::Environment env;
+   load(env, "arithmetic",
+      "int run()\n"
+      "{\n"
+      "  int result = 0;\n"
+      "  for(int i = 0; i < 10000; i++)\n"
+      "  {\n"
+      "    result = (result + i * 3) % 1024;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n");
+
+   Cflat::Function* function = env.getFunction("run");
+
+   measure("ArithmeticLoop", 100u, [&]()
+   {
+      env.returnFunctionCall<int>(function);
+   });
+}
+
+void benchmarkRecursiveCalls()
+{
+   Cflat::Environment env;
+   load(env, "fib",
+      "int fib(int pN)\n"
+      "{\n"
+      "  if(pN < 2)\n"
+      "  {\n"
+      "    return pN;\n"
+      "  }\n"
+      "  return fib(pN - 1) + fib(pN - 2);\n"
+      "}\n");
+
+   // the recursion depth is limited by kMaxNestedFunctionCalls
+   Cflat::Function* function = env.getFunction("fib");
+   const int n = 14;
+
+   measure("RecursiveCalls (fib 14)", 20u, [&]()
+   {
+      env.returnFunctionCall<int>(function, &n);
+   });
+}
+
+void benchmarkNativeCalls()
+{
+   Cflat::Environment env;
+   CflatRegisterFunctionReturnParams2(&env, int, nativeAdd, int, int);
+
+   load(env, "native",
+      "int run()\n"
+      "{\n"
+      "  int result = 0;\n"
+      "  for(int i = 0; i < 10000; i++)\n"
+      "  {\n"
+      "    result = nativeAdd(result, i) % 1024;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n");
+
+   Cflat::Function* function = env.getFunction("run");
+
+   measure("NativeCalls", 100u, [&]()
+   {
+      env.returnFunctionCall<int>(function);
+   });
+}
+
+void benchmarkEntityCalls()
+{
+   Cflat::Environment env;
+   load(env, "entities",
+      "float advance(float pPosition, float pSpeed, float pDeltaTime)\n"
+      "{\n"
+      "  return pPosition + pSpeed * pDeltaTime;\n"
+      "}\n");
+
+   struct Entity
+   {
+      float position;
+      float speed;
+   };
+
+   const size_t entitiesCount = 1000u;
+   std::vector<Entity> entities(entitiesCount);
+   const float deltaTime = 0.016f;
+
+   for(size_t i = 0u; i < entitiesCount; i++)
+   {
+      entities[i].position = 0.0f;
+      entities[i].speed = (float)i;
+   }
+
+   Cflat::Function* function = env.getFunction("advance");
+
+   measure("EntityCalls (1000 calls)", 100u, [&]()
+   {
+      for(size_t i = 0u; i < entitiesCount; i++)
+      {
+         entities[i].position = env.returnFunctionCall<float>(function,
+            &entities[i].position, &entities[i].speed, &deltaTime);
+      }
+   });
+
+   measure("EntityCalls (batched)", 100u, [&]()
+   {
+      const void* argumentsData[] = { &entities[0].position, &entities[0].speed, &deltaTime };
+      const size_t argumentsStrides[] = { sizeof(Entity), sizeof(Entity), 0u };
+
+      env.batchFunctionCall(function, entitiesCount, argumentsData, argumentsStrides,
+         &entities[0].position, sizeof(Entity));
+   });
+}
+
+void benchmarkMethodCalls()
+{
+   Cflat::Environment env;
+
+   {
+      CflatRegisterClass(&env, Accumulator);
+      CflatClassAddConstructor(&env, Accumulator);
+      CflatClassAddMethodVoidParams1(&env, Accumulator, void, add, int);
+      CflatClassAddMethodReturn(&env, Accumulator, int, getTotal);
+   }
+
+   load(env, "methods",
+      "Accumulator accumulator;\n"
+      "int run()\n"
+      "{\n"
+      "  for(int i = 0; i < 10000; i++)\n"
+      "  {\n"
+      "    accumulator.add(i);\n"
+      "  }\n"
+      "  return accumulator.getTotal();\n"
+      "}\n");
+
+   Cflat::Function* function = env.getFunction("run");
+
+   measure("MethodCalls", 100u, [&]()
+   {
+      env.returnFunctionCall<int>(function);
+   });
+}
+
+void benchmarkVectorIteration()
+{
+   Cflat::Environment env;
+   CflatRegisterSTLVector(&env, int);
+
+   load(env, "vector",
+      "std::vector<int> vec;\n"
+      "int run()\n"
+      "{\n"
+      "  int sum = 0;\n"
+      "  for(auto it = vec.begin(); it != vec.end(); it++)\n"
+      "  {\n"
+      "    sum = sum + *it;\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n");
+
+   std::vector<int>& vec = CflatValueAs(env.getVariable("vec"), std::vector<int>);
+
+   for(int i = 0; i < 10000; i++)
+   {
+      vec.push_back(i % 100);
+   }
+
+   Cflat::Function* function = env.getFunction("run");
+
+   measure("VectorIteration", 100u, [&]()
+   {
+      env.returnFunctionCall<int>(function);
+   });
+}
+
+void benchmarkVectorRangeBasedFor(bool pContiguous)
+{
+   Cflat::Environment env;
+
+   if(pContiguous)
+   {
+      CflatRegisterSTLVectorContiguous(&env, int);
+   }
+   else
+   {
+      CflatRegisterSTLVector(&env, int);
+   }
+
+   load(env, "vector",
+      "std::vector<int> vec;\n"
+      "int run()\n"
+      "{\n"
+      "  int sum = 0;\n"
+      "  for(int value : vec)\n"
+      "  {\n"
+      "    sum = sum + value;\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n");
+
+   std::vector<int>& vec = CflatValueAs(env.getVariable("vec"), std::vector<int>);
+
+   for(int i = 0; i < 10000; i++)
+   {
+      vec.push_back(i % 100);
+   }
+
+   Cflat::Function* function = env.getFunction("run");
+
+   measure(pContiguous ? "VectorRangeFor (contiguous)" : "VectorRangeFor", 100u, [&]()
+   {
+      env.returnFunctionCall<int>(function);
+   });
+}
+
+void benchmarkSwitch()
+{
+   Cflat::Environment env;
+   load(env, "switch",
+      "int run()\n"
+      "{\n"
+      "  int result = 0;\n"
+      "  for(int i = 0; i < 10000; i++)\n"
+      "  {\n"
+      "    switch(i % 8)\n"
+      "    {\n"
+      "    case 0: result += 1; break;\n"
+      "    case 1: result += 2; break;\n"
+      "    case 2: result += 3; break;\n"
+      "    case 3: result += 4; break;\n"
+      "    case 4: result += 5; break;\n"
+      "    case 5: result += 6; break;\n"
+      "    case 6: result += 7; break;\n"
+      "    default: result += 8; break;\n"
+      "    }\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n");
+
+   Cflat::Function* function = env.getFunction("run");
+
+   measure("Switch", 100u, [&]()
+   {
+      env.returnFunctionCall<int>(function);
+   });
+}
+
+void benchmarkStringBuilding()
+{
+   Cflat::Environment env;
+   Cflat::Helper::registerStdString(&env);
+
+   load(env, "strings",
+      "std::string str;\n"
+      "void run()\n"
+      "{\n"
+      "  str.assign(\"\");\n"
+      "  for(int i = 0; i < 1000; i++)\n"
+      "  {\n"
+      "    str.append(\"text\");\n"
+      "  }\n"
+      "}\n");
+
+   Cflat::Function* function = env.getFunction("run");
+
+   measure("StringBuilding", 100u, [&]()
+   {
+      env.voidFunctionCall(function);
+   });
+}
+
+void benchmarkLoad()
+{
+   const std::string code = generateLargeScript(500);
+
+   measure("Load (500 functions)", 20u, [&]()
+   {
+      Cflat::Environment env;
+      load(env, "large", code.c_str());
+   });
+}
+
+void benchmarkLoadLongExpressions()
+{
+   // deeply nested parentheses and function calls in every function
+   std::string code;
+   char buffer[64];
+
+   for(int i = 0; i < 50; i++)
+   {
+      snprintf(buffer, sizeof(buffer), "int function%d(int pValue)\n{\n  return ", i);
+      code.append(buffer);
+
+      for(int j = 0; j < 100; j++)
+      {
+         code.append(i > 0 && j % 2 == 0 ? "function0(pValue + " : "(pValue + ");
+      }
+
+      code.append("1");
+
+      for(int j = 0; j < 100; j++)
+      {
+         snprintf(buffer, sizeof(buffer), ") * %d", j % 3 + 1);
+         code.append(buffer);
+      }
+
+      code.append(";\n}\n");
+   }
+
+   measure("Load (long expressions)", 20u, [&]()
+   {
+      Cflat::Environment env;
+      load(env, "expressions", code.c_str());
+   });
+}
+
+void benchmarkLoadWithMacros()
+{
+   const std::string code = "#define SCALE(x)  ((x) * 2)\n" + generateLargeScript(500);
+
+   measure("Load (500 functions, macros)", 20u, [&]()
+   {
+      Cflat::Environment env;
+      char definition[32];
+      char body[32];
+
+      // engine-side macros, none of which appear in the script
+      for(int i = 0; i < 300; i++)
+      {
+         snprintf(definition, sizeof(definition), "ENGINE_MACRO_%d", i);
+         snprintf(body, sizeof(body), "%d", i);
+         env.defineMacro(definition, body);
+      }
+
+      load(env, "large", code.c_str());
+   });
+}
+
+void benchmarkHotReload()
+{
+   const std::string code = generateLargeScript(500);
+   const std::string changedCode = generateLargeScript(500, 250);
+
+   Cflat::Environment env;
+   load(env, "large", code.c_str());
+
+   bool changed = false;
+
+   measure("HotReload (1 of 500 changed)", 20u, [&]()
+   {
+      changed = !changed;
+
+      if(!env.reload("large", changed ? changedCode.c_str() : code.c_str()))
+      {
+         printf("Error reloading: %s\n", env.getErrorMessage());
+         exit(1);
+      }
+   });
+}
+
+void registerEngineTypes(Cflat::Environment& pEnv)
+{
+   Cflat::Helper::registerStdString(&pEnv);
+   Cflat::Helper::registerStdOut(&pEnv);
+
+   CflatRegisterSTLVector(&pEnv, int);
+   CflatRegisterSTLVector(&pEnv, float);
+   CflatRegisterFunctionReturnParams2(&pEnv, int, nativeAdd, int, int);
+
+   {
+      CflatRegisterClass(&pEnv, Accumulator);
+      CflatClassAddConstructor(&pEnv, Accumulator);
+      CflatClassAddMethodVoidParams1(&pEnv, Accumulator, void, add, int);
+      CflatClassAddMethodReturn(&pEnv, Accumulator, int, getTotal);
+   }
+
+   char definition[32];
+   char body[32];
+
+   for(int i = 0; i < 300; i++)
+   {
+      snprintf(definition, sizeof(definition), "ENGINE_MACRO_%d", i);
+      snprintf(body, sizeof(body), "%d", i);
+      pEnv.defineMacro(definition, body);
+   }
+}
+
+void benchmarkEnvironmentSetup()
+{
+   const char* code =
+      "Accumulator accumulator;\n"
+      "std::vector<int> values;\n"
+      "std::string name;\n"
+      "int run()\n"
+      "{\n"
+      "  accumulator.add(nativeAdd(ENGINE_MACRO_42, 1));\n"
+      "  return accumulator.getTotal();\n"
+      "}\n";
+
+   measure("Setup (registration)", 100u, [&]()
+   {
+      Cflat::Environment env;
+      registerEngineTypes(env);
+      load(env, "sandbox", code);
+   });
+
+   Cflat::Environment baseEnv;
+   registerEngineTypes(baseEnv);
+
+   measure("Setup (clone)", 100u, [&]()
+   {
+      Cflat::Environment env(&baseEnv);
+      load(env, "sandbox", code);
+   });
+}
+
+
+int main(int pArgumentsCount, char** pArguments)
+{
+   if(pArgumentsCount > 1)
+   {
+      gNameFilter = pArguments[1];
+   }
+
+   Cflat::Memory::malloc = countedMalloc;
+   Cflat::Memory::free = countedFree;
+
+   printf("%-28s %10s %16s %16s %16s\n",
+      "Benchmark", "Runs", "Time/run (us)", "Allocs/run", "Frees/run");
+
+   benchmarkArithmeticLoop();
+   benchmarkRecursiveCalls();
+   benchmarkNativeCalls();
+   benchmarkEntityCalls();
+   benchmarkMethodCalls();
+   benchmarkVectorIteration();
+   benchmarkVectorRangeBasedFor(false);
+   benchmarkVectorRangeBasedFor(true);
+   benchmarkSwitch();
+   benchmarkStringBuilding();
+   benchmarkLoad();
+   benchmarkLoadWithMacros();
+   benchmarkLoadLongExpressions();
+   benchmarkHotReload();
+   benchmarkEnvironmentSetup();
+
+   Cflat::Identifier::releaseNamesRegistry();
+
+   return 0;
+}
@@ -3,6 +3,9 @@
 
 #include "../CflatHelper.h"
 
+#include <memory>
+#include <thread>
+
 TEST(Namespaces, DirectChild)
 {
    Cflat::Environment env;
@@ -132,6 +135,49 @@ TEST(Preprocessor, DefinedMacroReplacementWithArgument)
    EXPECT_EQ(var, 42);
 }
 
+TEST(Preprocessor, DefinedMacroReplacementWithMultipleArguments)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "#define MAX(a, b)  ((a) > (b) ? (a) : (b))\n"
+      "#define CONCAT(a, b)  a ## b\n"
+      "#define NAME(name)  #name\n"
+      "int CONCAT(my, Var) = MAX((1 + 2) * 4, 10 - 8);\n"
+      "const char* str = NAME(myVar);\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("myVar"), int), 12);
+   EXPECT_EQ(strcmp(CflatValueAs(env.getVariable("str"), const char*), "myVar"), 0);
+}
+
+TEST(Preprocessor, MacroReplacementOnWholeTokens)
+{
+   Cflat::Environment env;
+
+   char definition[32];
+   char body[32];
+
+   for(int i = 0; i < 300; i++)
+   {
+      snprintf(definition, sizeof(definition), "VALUE_%d", i);
+      snprintf(body, sizeof(body), "%d", i);
+      env.defineMacro(definition, body);
+   }
+
+   env.defineMacro("VALUE", "42");
+
+   const char* code =
+      "int VALUE_COUNT = VALUE + VALUE_250;\n"
+      "const char* str = \"VALUE\";\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("VALUE_COUNT"), int), 292);
+   EXPECT_EQ(strcmp(CflatValueAs(env.getVariable("str"), const char*), "VALUE"), 0);
+}
+
 TEST(Cflat, VariableDeclaration)
 {
    Cflat::Environment env;
@@ -489,6 +535,68 @@ TEST(Cflat, ArrayDeclaration)
 }
 
 
+TEST(Cflat, ValueInlineStorage)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "double var1 = 42.0;\n"
+      "int var2[2] = { 1, 2 };\n"
+      "double var3[4] = { 1.0, 2.0, 3.0, 4.0 };\n"
+      "int var4 = var2[0] + var2[1] * 2;\n"
+      "var3[3] = var1 + var3[0];\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Value* var1 = env.getVariable("var1");
+   EXPECT_EQ(var1->mValueBufferType, Cflat::ValueBufferType::Inline);
+   EXPECT_EQ(var1->mValueBuffer, var1->mInlineBuffer);
+   EXPECT_FLOAT_EQ(CflatValueAs(var1, double), 42.0);
+
+   Cflat::Value* var2 = env.getVariable("var2");
+   EXPECT_EQ(var2->mValueBufferType, Cflat::ValueBufferType::Inline);
+   EXPECT_EQ(CflatValueAsArrayElement(var2, 1, int), 2);
+
+   Cflat::Value* var3 = env.getVariable("var3");
+   EXPECT_EQ(var3->mValueBufferType, Cflat::ValueBufferType::Heap);
+   EXPECT_FLOAT_EQ(CflatValueAsArrayElement(var3, 3, double), 43.0);
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("var4"), int), 5);
+}
+
+TEST(Cflat, ValueInlineStorageAlignment)
+{
+   Cflat::Environment env;
+
+   struct alignas(16) TestVector
+   {
+      float x;
+      float y;
+      float z;
+      float w;
+   };
+
+   {
+      CflatRegisterStruct(&env, TestVector);
+      CflatStructAddMember(&env, TestVector, float, x);
+      CflatStructAddMember(&env, TestVector, float, y);
+      CflatStructAddMember(&env, TestVector, float, z);
+      CflatStructAddMember(&env, TestVector, float, w);
+   }
+
+   const char* code =
+      "bool flag = true;\n"
+      "TestVector vector;\n"
+      "vector.w = 42.0f;\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Value* vector = env.getVariable("vector");
+   EXPECT_EQ(vector->mValueBufferType, Cflat::ValueBufferType::Inline);
+   EXPECT_EQ((uintptr_t)vector->mValueBuffer % alignof(TestVector), 0u);
+   EXPECT_FLOAT_EQ(CflatValueAs(vector, TestVector).w, 42.0f);
+}
+
 TEST(Cflat, ArrayDeclarationWithStaticConstSize)
 {
    Cflat::Environment env;
@@ -595,6 +703,31 @@ TEST(Cflat, ArrayElementAccessThroughPointer)
    EXPECT_EQ(CflatValueAs(env.getVariable("var3"), int), 4200);
 }
 
+TEST(Cflat, ArrayElementAccessWithShadowedArray)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "float values[] = { 1.5f, 2.5f };\n"
+      "int sum(int* values, int pCount)\n"
+      "{\n"
+      "  int result = 0;\n"
+      "  for(int i = 0; i < pCount; i++)\n"
+      "  {\n"
+      "    result += values[i];\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n"
+      "int array[] = { 42, 420, 4200 };\n"
+      "int var1 = sum(&array[0], 3);\n"
+      "float var2 = values[1];\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("var1"), int), 4662);
+   EXPECT_FLOAT_EQ(CflatValueAs(env.getVariable("var2"), float), 2.5f);
+}
+
 TEST(Cflat, VariableIncrement)
 {
    Cflat::Environment env;
@@ -799,6 +932,64 @@ TEST(Cflat, EnumClass)
    EXPECT_EQ(CflatValueAs(env.getVariable("var2"), TestEnum), TestEnum::kSecondValue);
 }
 
+TEST(Cflat, ConstantFolding)
+{
+   Cflat::Environment env;
+
+   enum TestEnum
+   {
+      kFirstValue,
+      kSecondValue
+   };
+
+   {
+      CflatRegisterEnum(&env, TestEnum);
+      CflatEnumAddValue(&env, TestEnum, kFirstValue);
+      CflatEnumAddValue(&env, TestEnum, kSecondValue);
+   }
+
+   const char* code =
+      "const int kCount = 4;\n"
+      "const float kScale = kCount * 0.5f;\n"
+      "const TestEnum kMode = kSecondValue;\n"
+      "int result = 0;\n"
+      "float scaled = 0.0f;\n"
+      "void func()\n"
+      "{\n"
+      "  const int kOffset = (kCount + 1) * 10;\n"
+      "  for(int i = 0; i < kCount; i++)\n"
+      "  {\n"
+      "    result += kOffset + (int)sizeof(int);\n"
+      "  }\n"
+      "  if(kMode == kFirstValue)\n"
+      "  {\n"
+      "    result = -1;\n"
+      "  }\n"
+      "  else if(kCount > 2)\n"
+      "  {\n"
+      "    scaled = kScale * 2.0f;\n"
+      "  }\n"
+      "  switch(kMode)\n"
+      "  {\n"
+      "  case kFirstValue:\n"
+      "    result = -2;\n"
+      "    break;\n"
+      "  case kSecondValue:\n"
+      "    result += 1;\n"
+      "  default:\n"
+      "    result += 1;\n"
+      "  }\n"
+      "  result += kCount > 2 ? kCount : 0;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   env.voidFunctionCall(env.getFunction("func"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("result"), int), (4 * 54) + 2 + 4);
+   EXPECT_FLOAT_EQ(CflatValueAs(env.getVariable("scaled"), float), 4.0f);
+   EXPECT_FLOAT_EQ(CflatValueAs(env.getVariable("kScale"), float), 2.0f);
+}
+
 TEST(Cflat, ComparisonOperators)
 {
    Cflat::Environment env;
@@ -930,6 +1121,38 @@ TEST(Cflat, BitwiseOperators)
    EXPECT_EQ(CflatValueAs(env.getVariable("iop6"), int), 0x08 >> 3);
 }
 
+TEST(Cflat, TypedOperators)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int64_t lop1 = 3000000;\n"
+      "int64_t lop2 = lop1 * lop1;\n"
+      "double dop1 = 0.5;\n"
+      "double dop2 = dop1 * 5.0;\n"
+      "bool dop3 = dop1 == 0.25;\n"
+      "float fop1 = 1.5f;\n"
+      "fop1 += 2.0f;\n"
+      "int iop1 = 7;\n"
+      "iop1 -= 10;\n"
+      "int iop2 = -iop1;\n"
+      "int* ptr1 = &iop1;\n"
+      "int* ptr2 = &iop2;\n"
+      "bool pop1 = ptr1 == ptr2;\n"
+      "bool pop2 = ptr1 != ptr2;\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("lop2"), int64_t), 9000000000000);
+   EXPECT_DOUBLE_EQ(CflatValueAs(env.getVariable("dop2"), double), 2.5);
+   EXPECT_FALSE(CflatValueAs(env.getVariable("dop3"), bool));
+   EXPECT_FLOAT_EQ(CflatValueAs(env.getVariable("fop1"), float), 3.5f);
+   EXPECT_EQ(CflatValueAs(env.getVariable("iop1"), int), -3);
+   EXPECT_EQ(CflatValueAs(env.getVariable("iop2"), int), 3);
+   EXPECT_FALSE(CflatValueAs(env.getVariable("pop1"), bool));
+   EXPECT_TRUE(CflatValueAs(env.getVariable("pop2"), bool));
+}
+
 TEST(Cflat, BinaryOperatorPrecedence)
 {
    Cflat::Environment env;
@@ -1010,6 +1233,24 @@ TEST(Cflat, ConditionalExpressionAsFunctionCallArgument)
    EXPECT_EQ(CflatValueAs(env.getVariable("result"), int), 2);
 }
 
+TEST(Cflat, NestedBracketsInExpressions)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int func(int arg1, int arg2) { return arg1 - arg2; }\n"
+      "int values[] = { 1, 2, 3, 4 };\n"
+      "int var1 = ((1 + 2) * (3 + (4 - 1))) - values[(1 + 1) * 1] * 2;\n"
+      "int var2 = func((var1 < 10 ? 20 : 0), func(values[func(3, 1)], (2)));\n"
+      "bool var3 = (var1 < 13) && (values[3] > var1 - 10);\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("var1"), int), 12);
+   EXPECT_EQ(CflatValueAs(env.getVariable("var2"), int), -1);
+   EXPECT_EQ(CflatValueAs(env.getVariable("var3"), bool), true);
+}
+
 TEST(Cflat, ImplicitCastBetweenIntegerAndFloat)
 {
    Cflat::Environment env;
@@ -1129,6 +1370,77 @@ TEST(Cflat, SwitchStatementDefault)
    EXPECT_EQ(CflatValueAs(env.getVariable("var"), int), 1042);
 }
 
+TEST(Cflat, SwitchStatementConstantCases)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "const int kRed = 0;\n"
+      "const int kGreen = 1;\n"
+      "const int kBlue = 2;\n"
+      "const int kWhite = 3;\n"
+      "int dense(int pValue)\n"
+      "{\n"
+      "  int result = -1;\n"
+      "  switch(pValue)\n"
+      "  {\n"
+      "  case kRed:\n"
+      "    result = 10;\n"
+      "    break;\n"
+      "  case kGreen:\n"
+      "    result = 15;\n"
+      "  case kBlue:\n"
+      "    result += 5;\n"
+      "    break;\n"
+      "  case kWhite:\n"
+      "    result = 30;\n"
+      "    break;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n"
+      "int sparse(int pValue)\n"
+      "{\n"
+      "  int result = 0;\n"
+      "  switch(pValue)\n"
+      "  {\n"
+      "  case -1000:\n"
+      "    result = 1;\n"
+      "    break;\n"
+      "  case 7:\n"
+      "    result = 2;\n"
+      "    break;\n"
+      "  case 100000:\n"
+      "    result = 3;\n"
+      "    break;\n"
+      "  default:\n"
+      "    result = -1;\n"
+      "    break;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* denseFunction = env.getFunction("dense");
+   Cflat::Function* sparseFunction = env.getFunction("sparse");
+
+   const int denseValues[] = { 0, 1, 2, 3, 4, -1 };
+   const int denseResults[] = { 10, 20, 4, 30, -1, -1 };
+
+   for(size_t i = 0u; i < sizeof(denseValues) / sizeof(int); i++)
+   {
+      EXPECT_EQ(env.returnFunctionCall<int>(denseFunction, &denseValues[i]), denseResults[i]);
+   }
+
+   const int sparseValues[] = { -1000, 7, 100000, 8, 0 };
+   const int sparseResults[] = { 1, 2, 3, -1, -1 };
+
+   for(size_t i = 0u; i < sizeof(sparseValues) / sizeof(int); i++)
+   {
+      EXPECT_EQ(env.returnFunctionCall<int>(sparseFunction, &sparseValues[i]), sparseResults[i]);
+   }
+}
+
 TEST(Cflat, WhileStatement)
 {
    Cflat::Environment env;
@@ -1596,6 +1908,54 @@ TEST(Cflat, RangeBasedForWithStdVectorAndAuto)
    EXPECT_EQ(vec[1], 52);
 }
 
+TEST(Cflat, RangeBasedForWithContiguousStdVector)
+{
+   Cflat::Environment env;
+
+   CflatRegisterSTLVectorContiguous(&env, int);
+
+   const char* code =
+      "std::vector<int> vec;\n"
+      "int sum = 0;\n"
+      "void func()\n"
+      "{\n"
+      "  for(auto& val : vec)\n"
+      "  {\n"
+      "    val += 10;\n"
+      "  }\n"
+      "  for(int val : vec)\n"
+      "  {\n"
+      "    if(val > 30)\n"
+      "    {\n"
+      "      break;\n"
+      "    }\n"
+      "    sum += val;\n"
+      "  }\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   std::vector<int>& vec = CflatValueAs(env.getVariable("vec"), std::vector<int>);
+   vec.push_back(1);
+   vec.push_back(2);
+   vec.push_back(42);
+   vec.push_back(3);
+
+   // the elements get accessed in place, without calling 'begin', 'end' or the iterator methods
+   Cflat::Profiler profiler;
+   env.setProfiler(&profiler);
+   env.voidFunctionCall(env.getFunction("func"));
+   env.setProfiler(nullptr);
+
+   EXPECT_EQ(vec[0], 11);
+   EXPECT_EQ(vec[1], 12);
+   EXPECT_EQ(vec[2], 52);
+   EXPECT_EQ(vec[3], 13);
+   EXPECT_EQ(CflatValueAs(env.getVariable("sum"), int), 23);
+
+   EXPECT_EQ(profiler.getFunctionRecords().size(), 1u);
+}
+
 TEST(Cflat, TypeUsagesWithTemplateArguments)
 {
    Cflat::Environment env;
@@ -2622,6 +2982,137 @@ TEST(Cflat, RecursiveFunctionCall)
    EXPECT_EQ(CflatValueAs(env.getVariable("fac5"), int), 120);
 }
 
+TEST(Cflat, FunctionLocalVariablesAndShadowing)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int value = 100;\n"
+      "int readGlobal()\n"
+      "{\n"
+      "  return value;\n"
+      "}\n"
+      "int func(int pArg)\n"
+      "{\n"
+      "  int value = pArg;\n"
+      "  static int counter = 0;\n"
+      "  int result = 0;\n"
+      "  {\n"
+      "    int value = pArg * 2;\n"
+      "    result += value;\n"
+      "  }\n"
+      "  result += value;\n"
+      "  result += readGlobal();\n"
+      "  result += ++counter;\n"
+      "  return result;\n"
+      "}\n"
+      "int var1 = func(1);\n"
+      "int var2 = func(2);\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("var1"), int), 104);
+   EXPECT_EQ(CflatValueAs(env.getVariable("var2"), int), 108);
+}
+
+TEST(Cflat, ManyVariablesAndShadowing)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int v0 = 0; int v1 = 1; int v2 = 2; int v3 = 3; int v4 = 4; int v5 = 5; int v6 = 6;\n"
+      "int v7 = 7; int v8 = 8; int v9 = 9; int v10 = 10; int v11 = 11; int v12 = 12;\n"
+      "int v13 = 13; int v14 = 14; int v15 = 15; int v16 = 16; int v17 = 17; int v18 = 18;\n"
+      "int func(int v0)\n"
+      "{\n"
+      "  int result = v0;\n"
+      "  {\n"
+      "    int v1 = 10; int v2 = 20; int v3 = 30; int v4 = 40; int v5 = 50; int v6 = 60;\n"
+      "    int v7 = 70; int v8 = 80; int v9 = 90; int v10 = 100; int v11 = 110; int v12 = 120;\n"
+      "    int v13 = 130; int v14 = 140; int v15 = 150; int v16 = 160; int v17 = 170;\n"
+      "    {\n"
+      "      int v0 = 1000;\n"
+      "      result += v0 + v1 + v17;\n"
+      "    }\n"
+      "    result += v0 + v16;\n"
+      "  }\n"
+      "  result += v0 + v1 + v17 + v18;\n"
+      "  return result;\n"
+      "}\n"
+      "int var = func(5);\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("var"), int), 5 + 1180 + 165 + 41);
+   EXPECT_EQ(CflatValueAs(env.getVariable("v0"), int), 0);
+   EXPECT_EQ(CflatValueAs(env.getVariable("v18"), int), 18);
+}
+
+TEST(Cflat, FunctionLocalVariablesInSwitch)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int func(int pArg)\n"
+      "{\n"
+      "  int result = 0;\n"
+      "  switch(pArg)\n"
+      "  {\n"
+      "  case 0:\n"
+      "    int first = 1;\n"
+      "    result += first;\n"
+      "  case 1:\n"
+      "    int second = 10;\n"
+      "    result += second;\n"
+      "    break;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n"
+      "int var1 = func(0);\n"
+      "int var2 = func(1);\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("var1"), int), 11);
+   EXPECT_EQ(CflatValueAs(env.getVariable("var2"), int), 10);
+}
+
+TEST(Cflat, NestedFunctionCallsAsArguments)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int add(int a, int b)\n"
+      "{\n"
+      "  return a + b;\n"
+      "}\n"
+      "int twice(int a)\n"
+      "{\n"
+      "  return add(a, a);\n"
+      "}\n"
+      "void increment(int& pValue)\n"
+      "{\n"
+      "  pValue++;\n"
+      "}\n"
+      "int a = 3;\n"
+      "int b = twice(add(a, 1));\n"
+      "int c = add(add(1, 2), add(3, twice(2)));\n"
+      "int counter = 0;\n"
+      "void func()\n"
+      "{\n"
+      "  increment(counter);\n"
+      "  increment(counter);\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("b"), int), 8);
+   EXPECT_EQ(CflatValueAs(env.getVariable("c"), int), 10);
+
+   env.voidFunctionCall(env.getFunction("func"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("counter"), int), 2);
+}
+
 TEST(Cflat, OperatorOverload)
 {
    Cflat::Environment env;
@@ -2660,24 +3151,325 @@ TEST(Cflat, OperatorOverload)
    EXPECT_EQ(testStruct2.var2, 110);
 }
 
-TEST(Cflat, RegisteringDerivedClass)
+TEST(Cflat, OperatorOverloadInLoop)
 {
    Cflat::Environment env;
 
-   Cflat::Helper::registerStdString(&env);
+   static int assignmentsCount = 0;
 
-   class TestClass : public std::string
+   struct TestStruct
    {
-   public:
-      int mInternalValue;
+      int var;
 
-      TestClass() : mInternalValue(0) {}
-      void setInternalValue(int pValue) { mInternalValue = pValue; }
-   };
+      TestStruct() = default;
+      TestStruct(const TestStruct&) = default;
 
-   {
-      CflatRegisterClass(&env, TestClass);
-      CflatClassAddBaseType(&env, TestClass, std::string);
+      TestStruct& operator=(const TestStruct& pOther)
+      {
+         var = pOther.var;
+         assignmentsCount++;
+         return *this;
+      }
+      const TestStruct operator+(int pValue) const
+      {
+         TestStruct other;
+         other.var = var + pValue;
+         return other;
+      }
+   };
+
+   {
+      CflatRegisterStruct(&env, TestStruct);
+      CflatStructAddMember(&env, TestStruct, int, var);
+      CflatStructAddMethodReturnParams1(&env, TestStruct, TestStruct&, operator=, const TestStruct&);
+      CflatStructAddMethodReturnParams1(&env, TestStruct, const TestStruct, operator+, int);
+   }
+
+   const char* code =
+      "TestStruct testStruct;\n"
+      "void func()\n"
+      "{\n"
+      "  testStruct.var = 0;\n"
+      "  for(int i = 0; i < 10; i++)\n"
+      "  {\n"
+      "    testStruct = testStruct + i;\n"
+      "  }\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   env.voidFunctionCall(env.getFunction("func"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("testStruct"), TestStruct).var, 45);
+   EXPECT_EQ(assignmentsCount, 10);
+
+   env.voidFunctionCall(env.getFunction("func"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("testStruct"), TestStruct).var, 45);
+   EXPECT_EQ(assignmentsCount, 20);
+}
+
+TEST(Cflat, OperatorOverloadAfterRegisteringMoreMethods)
+{
+   Cflat::Environment env;
+
+   struct TestStruct
+   {
+      int var;
+
+      const TestStruct operator+(int pValue) const
+      {
+         TestStruct other;
+         other.var = var + pValue;
+         return other;
+      }
+      int getVar() const { return var; }
+      void setVar(int pValue) { var = pValue; }
+      void reset() { var = 0; }
+      void increment() { var++; }
+      void decrement() { var--; }
+   };
+
+   {
+      CflatRegisterStruct(&env, TestStruct);
+      CflatStructAddMember(&env, TestStruct, int, var);
+      CflatStructAddMethodReturnParams1(&env, TestStruct, const TestStruct, operator+, int);
+   }
+
+   const char* code =
+      "TestStruct testStruct;\n"
+      "void func()\n"
+      "{\n"
+      "  testStruct.var = 40;\n"
+      "  testStruct = testStruct + 2;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Struct* testStructType = static_cast<Cflat::Struct*>(env.getType("TestStruct"));
+   const Cflat::Method* methodsData = testStructType->mMethods.data();
+
+   {
+      Cflat::Struct* type = testStructType;
+      CflatStructAddMethodReturn(&env, TestStruct, int, getVar);
+      CflatStructAddMethodVoidParams1(&env, TestStruct, void, setVar, int);
+      CflatStructAddMethodVoid(&env, TestStruct, void, reset);
+      CflatStructAddMethodVoid(&env, TestStruct, void, increment);
+      CflatStructAddMethodVoid(&env, TestStruct, void, decrement);
+   }
+
+   EXPECT_NE(testStructType->mMethods.data(), methodsData);
+
+   env.voidFunctionCall(env.getFunction("func"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("testStruct"), TestStruct).var, 42);
+}
+
+static float nativeScale(float pValue, int pFactor)
+{
+   return pValue * (float)pFactor;
+}
+
+static void nativeAccumulate(int& pTotal, int pValue)
+{
+   pTotal += pValue;
+}
+
+struct TestStructWithNativeMethods
+{
+   int value;
+   TestStructWithNativeMethods() : value(0) {}
+   void add(int pValue) { value += pValue; }
+   int getScaled(int pScale) const { return value * pScale; }
+};
+
+TEST(Cflat, NativeFunctionAndMethodCalls)
+{
+   Cflat::Environment env;
+
+   CflatRegisterNativeFunction(&env, float, nativeScale, float, int);
+   CflatRegisterNativeFunction(&env, void, nativeAccumulate, int&, int);
+
+   {
+      CflatRegisterStruct(&env, TestStructWithNativeMethods);
+      CflatStructAddConstructor(&env, TestStructWithNativeMethods);
+      CflatStructAddMember(&env, TestStructWithNativeMethods, int, value);
+      CflatStructAddNativeMethod(&env, TestStructWithNativeMethods, void, add, int);
+      CflatStructAddNativeConstMethod(&env, TestStructWithNativeMethods, int, getScaled, int);
+   }
+
+   const char* code =
+      "const float scaled = nativeScale(2, 3);\n"
+      "int total = 0;\n"
+      "TestStructWithNativeMethods test;\n"
+      "void func()\n"
+      "{\n"
+      "  for(int i = 0; i < 5; i++)\n"
+      "  {\n"
+      "    nativeAccumulate(total, i);\n"
+      "    test.add(i);\n"
+      "  }\n"
+      "}\n"
+      "int getScaled(int pScale)\n"
+      "{\n"
+      "  TestStructWithNativeMethods* testPtr = &test;\n"
+      "  return testPtr->getScaled(pScale);\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   EXPECT_FLOAT_EQ(CflatValueAs(env.getVariable("scaled"), float), 6.0f);
+
+   env.voidFunctionCall(env.getFunction("func"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("total"), int), 10);
+   EXPECT_EQ(CflatValueAs(env.getVariable("test"), TestStructWithNativeMethods).value, 10);
+
+   const int scale = 3;
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("getScaled"), &scale), 30);
+
+   // calls made from the host go through the native call as well
+   const float value = 1.5f;
+   const int factor = 4;
+   EXPECT_FLOAT_EQ(env.returnFunctionCall<float>(env.getFunction("nativeScale"), &value, &factor), 6.0f);
+}
+
+static int gNativeCounter = 0;
+
+static int& nativeGetCounter()
+{
+   return gNativeCounter;
+}
+
+struct TestStructWithNativeReferences
+{
+   int value;
+   TestStructWithNativeReferences() : value(0) {}
+   int& getValueRef() { return value; }
+   const int& getConstValueRef() const { return value; }
+};
+
+TEST(Cflat, NativeCallsReturningReferences)
+{
+   Cflat::Environment env;
+
+   CflatRegisterNativeFunction(&env, int&, nativeGetCounter);
+
+   {
+      CflatRegisterStruct(&env, TestStructWithNativeReferences);
+      CflatStructAddConstructor(&env, TestStructWithNativeReferences);
+      CflatStructAddMember(&env, TestStructWithNativeReferences, int, value);
+      CflatStructAddNativeMethod(&env, TestStructWithNativeReferences, int&, getValueRef);
+      CflatStructAddNativeConstMethod(&env, TestStructWithNativeReferences, const int&, getConstValueRef);
+   }
+
+   const char* code =
+      "TestStructWithNativeReferences test;\n"
+      "int counterCopy = 0;\n"
+      "int valueCopy = 0;\n"
+      "void func()\n"
+      "{\n"
+      "  int& counter = nativeGetCounter();\n"
+      "  counter = 42;\n"
+      "  counterCopy = nativeGetCounter();\n"
+      "  int& value = test.getValueRef();\n"
+      "  value = 7;\n"
+      "  valueCopy = test.getConstValueRef();\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   gNativeCounter = 0;
+   env.voidFunctionCall(env.getFunction("func"));
+   EXPECT_FALSE(env.getErrorMessage());
+
+   EXPECT_EQ(gNativeCounter, 42);
+   EXPECT_EQ(CflatValueAs(env.getVariable("counterCopy"), int), 42);
+   EXPECT_EQ(CflatValueAs(env.getVariable("test"), TestStructWithNativeReferences).value, 7);
+   EXPECT_EQ(CflatValueAs(env.getVariable("valueCopy"), int), 7);
+}
+
+TEST(Cflat, BatchFunctionCall)
+{
+   struct Entity
+   {
+      int position;
+      int speed;
+      int result;
+   };
+
+   Cflat::Environment env;
+
+   CflatRegisterNativeFunction(&env, float, nativeScale, float, int);
+
+   const char* code =
+      "int calls = 0;\n"
+      "int advance(int pPosition, int pSpeed, int pSteps)\n"
+      "{\n"
+      "  calls++;\n"
+      "  return pPosition + (pSpeed * pSteps) / pSpeed;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* function = env.getFunction("advance");
+   EXPECT_TRUE(function);
+
+   // array of structures for the positions and the speeds, plus the same steps for all of them
+   Entity entities[4] = { { 0, 1, -1 }, { 10, 2, -1 }, { 20, 0, -1 }, { 30, 4, -1 } };
+   const int steps = 3;
+
+   const void* argumentsData[] = { &entities[0].position, &entities[0].speed, &steps };
+   const size_t argumentsStrides[] = { sizeof(Entity), sizeof(Entity), 0u };
+
+   CflatSTLVector(Cflat::BatchCallError) errors;
+   const size_t failedElementsCount = env.batchFunctionCall(function, 4u,
+      argumentsData, argumentsStrides, &entities[0].result, sizeof(Entity), &errors);
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("calls"), int), 4);
+   EXPECT_EQ(entities[0].result, 3);
+   EXPECT_EQ(entities[1].result, 13);
+   EXPECT_EQ(entities[2].result, -1);
+   EXPECT_EQ(entities[3].result, 33);
+
+   EXPECT_EQ(failedElementsCount, 1u);
+   EXPECT_EQ(errors.size(), 1u);
+   EXPECT_EQ(errors[0].mElementIndex, 2u);
+   EXPECT_EQ(strcmp(errors[0].mErrorMessage.c_str(),
+      "[Runtime Error] 'test' -- Line 5: division by zero"), 0);
+   EXPECT_EQ(strcmp(env.getErrorMessage(),
+      "[Runtime Error] 'test' -- Line 5: division by zero"), 0);
+
+   // structure of arrays, through a native function
+   const float values[3] = { 1.0f, 2.0f, 3.0f };
+   const int factors[3] = { 2, 3, 4 };
+   float results[3] = {};
+
+   const void* nativeArgumentsData[] = { values, factors };
+   const size_t nativeArgumentsStrides[] = { sizeof(float), sizeof(int) };
+
+   EXPECT_EQ(env.batchFunctionCall(env.getFunction("nativeScale"), 3u,
+      nativeArgumentsData, nativeArgumentsStrides, results, sizeof(float)), 0u);
+   EXPECT_FALSE(env.getErrorMessage());
+
+   EXPECT_FLOAT_EQ(results[0], 2.0f);
+   EXPECT_FLOAT_EQ(results[1], 6.0f);
+   EXPECT_FLOAT_EQ(results[2], 12.0f);
+}
+
+TEST(Cflat, RegisteringDerivedClass)
+{
+   Cflat::Environment env;
+
+   Cflat::Helper::registerStdString(&env);
+
+   class TestClass : public std::string
+   {
+   public:
+      int mInternalValue;
+
+      TestClass() : mInternalValue(0) {}
+      void setInternalValue(int pValue) { mInternalValue = pValue; }
+   };
+
+   {
+      CflatRegisterClass(&env, TestClass);
+      CflatClassAddBaseType(&env, TestClass, std::string);
       CflatClassAddConstructor(&env, TestClass);
       CflatClassAddMethodVoidParams1(&env, TestClass, void, setInternalValue, int);
    }
@@ -2965,6 +3757,74 @@ TEST(Cflat, CastReinterpret)
    EXPECT_EQ(other->otherMember, 42);
 }
 
+TEST(Cflat, GrowableStack)
+{
+   Cflat::Environment env;
+   env.setStackSize(64u, true);
+
+   const char* code =
+      "int sumDown(int pValue)\n"
+      "{\n"
+      "  int values[8];\n"
+      "  for(int i = 0; i < 8; i++)\n"
+      "  {\n"
+      "    values[i] = pValue;\n"
+      "  }\n"
+      "  if(pValue == 0) return 0;\n"
+      "  return values[7] + sumDown(pValue - 1);\n"
+      "}\n"
+      "int result = sumDown(10);\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   EXPECT_EQ(CflatValueAs(env.getVariable("result"), int), 55);
+
+   Cflat::ExecutionContext* context = env.createExecutionContext(16u, true);
+   env.setExecutionContext(context);
+
+   const int arg = 12;
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("sumDown"), &arg), 78);
+   EXPECT_TRUE(context->mStack.isEmpty());
+
+   env.setExecutionContext(nullptr);
+   env.destroyExecutionContext(context);
+}
+
+TEST(RuntimeErrors, StackOverflow)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int sumDown(int pValue)\n"
+      "{\n"
+      "  int values[8];\n"
+      "  for(int i = 0; i < 8; i++)\n"
+      "  {\n"
+      "    values[i] = pValue;\n"
+      "  }\n"
+      "  if(pValue == 0) return 0;\n"
+      "  return values[7] + sumDown(pValue - 1);\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::ExecutionContext* context = env.createExecutionContext(256u, false);
+   env.setExecutionContext(context);
+
+   const int arg = 100;
+   env.returnFunctionCall<int>(env.getFunction("sumDown"), &arg);
+   ASSERT_TRUE(env.getErrorMessage());
+   EXPECT_TRUE(strstr(env.getErrorMessage(), "stack overflow"));
+   EXPECT_TRUE(context->mStack.isEmpty());
+   EXPECT_FALSE(context->mStack.mOverflown);
+
+   const int smallArg = 3;
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("sumDown"), &smallArg), 6);
+   EXPECT_FALSE(env.getErrorMessage());
+
+   env.setExecutionContext(nullptr);
+   env.destroyExecutionContext(context);
+}
+
 TEST(Cflat, Logging)
 {
    Cflat::Environment env;
@@ -2987,40 +3847,1125 @@ TEST(Cflat, Logging)
    std::cout.rdbuf(coutBuf);
 }
 
-TEST(Debugging, ExpressionEvaluation)
+TEST(Bytecode, LoopStatements)
+{
+   Cflat::Environment env;
+   env.setExecutionMode(Cflat::ExecutionMode::Bytecode);
+
+   const char* code =
+      "int sum(int pCount)\n"
+      "{\n"
+      "  int result = 0;\n"
+      "  for(int i = 0; i < pCount; i++)\n"
+      "  {\n"
+      "    if(i % 2 == 0)\n"
+      "    {\n"
+      "      continue;\n"
+      "    }\n"
+      "    int j = 0;\n"
+      "    while(true)\n"
+      "    {\n"
+      "      if(++j > i) break;\n"
+      "      result += j;\n"
+      "    }\n"
+      "  }\n"
+      "  do { result++; } while(result < 0);\n"
+      "  return result;\n"
+      "}\n"
+      "int var = sum(6);\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   EXPECT_EQ(CflatValueAs(env.getVariable("var"), int), 23);
+}
+
+TEST(Bytecode, SwitchStatement)
+{
+   Cflat::Environment env;
+   env.setExecutionMode(Cflat::ExecutionMode::Bytecode);
+
+   const char* code =
+      "int classify(int pValue)\n"
+      "{\n"
+      "  int result = 0;\n"
+      "  switch(pValue)\n"
+      "  {\n"
+      "  case 1:\n"
+      "    result += 10;\n"
+      "  case 2:\n"
+      "    result += 20;\n"
+      "    break;\n"
+      "  case 3:\n"
+      "    return 3;\n"
+      "  default:\n"
+      "    result = -1;\n"
+      "  }\n"
+      "  return result;\n"
+      "}\n"
+      "int var1 = classify(1);\n"
+      "int var2 = classify(2);\n"
+      "int var3 = classify(3);\n"
+      "int var4 = classify(4);\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   EXPECT_EQ(CflatValueAs(env.getVariable("var1"), int), 30);
+   EXPECT_EQ(CflatValueAs(env.getVariable("var2"), int), 20);
+   EXPECT_EQ(CflatValueAs(env.getVariable("var3"), int), 3);
+   EXPECT_EQ(CflatValueAs(env.getVariable("var4"), int), -1);
+}
+
+TEST(Bytecode, ReturnFromNestedScopes)
 {
    Cflat::Environment env;
+   env.setExecutionMode(Cflat::ExecutionMode::Bytecode);
+
+   static int staticVar = 0;
 
    struct TestStruct
    {
-      int var1;
-      int var2;
-
-      int getVar1(int pFactor = 1) { return var1 * pFactor; }
+      ~TestStruct() { staticVar++; }
    };
 
    {
       CflatRegisterStruct(&env, TestStruct);
-      CflatStructAddMember(&env, TestStruct, int, var1);
-      CflatStructAddMember(&env, TestStruct, int, var2);
-      CflatStructAddMethodReturn(&env, TestStruct, int, getVar1);
-      CflatStructAddMethodReturnParams1(&env, TestStruct, int, getVar1, int);
+      CflatStructAddDestructor(&env, TestStruct);
    }
 
    const char* code =
-      "float testValue = 42.0f;\n"
-      "TestStruct testStruct;\n"
-      "testStruct.var1 = 42;\n"
-      "testStruct.var2 = 100;\n"
-      "int unused = 0;\n";
-
-   env.setExecutionHook([](Cflat::Environment* pEnvironment, const Cflat::CallStack& pCallStack)
-   {
-      if(!pCallStack.empty() && pCallStack.back().mLine == 6u)
-      {
-         Cflat::Value testValue;
-         EXPECT_TRUE(pEnvironment->evaluateExpression("testValue", &testValue));
-         EXPECT_FLOAT_EQ(CflatValueAs(&testValue, float), 42.0f);
+      "int find(int pValue)\n"
+      "{\n"
+      "  TestStruct outer;\n"
+      "  for(int i = 0; i < 10; i++)\n"
+      "  {\n"
+      "    TestStruct inner;\n"
+      "    if(i == pValue)\n"
+      "    {\n"
+      "      return i;\n"
+      "    }\n"
+      "  }\n"
+      "  return -1;\n"
+      "}\n"
+      "int factorial(int pNum)\n"
+      "{\n"
+      "  if(pNum <= 1) return 1;\n"
+      "  return pNum * factorial(pNum - 1);\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   const int findArg = 3;
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("find"), &findArg), 3);
+   EXPECT_EQ(staticVar, 5);
+
+   const int factorialArg = 5;
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("factorial"), &factorialArg), 120);
+}
+
+TEST(Bytecode, TimeSlicedFunctionCall)
+{
+   Cflat::Environment env;
+   env.setExecutionMode(Cflat::ExecutionMode::Bytecode);
+
+   const char* code =
+      "int squaresCount = 0;\n"
+      "int square(int pValue)\n"
+      "{\n"
+      "  squaresCount++;\n"
+      "  return pValue * pValue;\n"
+      "}\n"
+      "int sumOfSquares(int pCount, int pDivisor)\n"
+      "{\n"
+      "  int total = 0;\n"
+      "  for(int i = 1; i <= pCount; i++)\n"
+      "  {\n"
+      "    total += square(i);\n"
+      "  }\n"
+      "  return total / pDivisor;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* function = env.getFunction("sumOfSquares");
+   EXPECT_TRUE(function);
+
+   const int count = 100;
+   const int divisor = 1;
+   const void* argumentsData[] = { &count, &divisor };
+   const Cflat::ExecutionBudget budget = { 50u, 0u };
+
+   Cflat::Value returnValue;
+   Cflat::ExecutionStatus status =
+      env.beginSlicedFunctionCall(function, argumentsData, &returnValue, budget);
+   int slicesCount = 1;
+
+   while(status == Cflat::ExecutionStatus::Suspended && slicesCount < 1000)
+   {
+      EXPECT_LT(CflatValueAs(env.getVariable("squaresCount"), int), count);
+      status = env.resumeSlicedFunctionCall(budget);
+      slicesCount++;
+   }
+
+   EXPECT_EQ(status, Cflat::ExecutionStatus::Completed);
+   EXPECT_GT(slicesCount, 2);
+   EXPECT_EQ(CflatValueAs(env.getVariable("squaresCount"), int), count);
+   EXPECT_EQ(CflatValueAs(&returnValue, int), 338350);
+
+   // a suspended call can be cancelled, and runtime errors end the call
+   EXPECT_EQ(env.beginSlicedFunctionCall(function, argumentsData, &returnValue, budget),
+      Cflat::ExecutionStatus::Suspended);
+   env.cancelSlicedFunctionCall();
+
+   const int zeroDivisor = 0;
+   const void* failingArgumentsData[] = { &count, &zeroDivisor };
+   const Cflat::ExecutionBudget unlimitedBudget = { 0u, 0u };
+
+   EXPECT_EQ(env.beginSlicedFunctionCall(function, failingArgumentsData, &returnValue, unlimitedBudget),
+      Cflat::ExecutionStatus::Failed);
+   EXPECT_EQ(strcmp(env.getErrorMessage(),
+      "[Runtime Error] 'test' -- Line 14: division by zero"), 0);
+
+   EXPECT_EQ(env.returnFunctionCall<int>(function, &count, &divisor), 338350);
+   EXPECT_FALSE(env.getErrorMessage());
+}
+
+TEST(Bytecode, TimeSlicedFunctionCallOverBudget)
+{
+   const char* code =
+      "int sumUpTo(int pCount)\n"
+      "{\n"
+      "  int total = 0;\n"
+      "  for(int i = 1; i <= pCount; i++)\n"
+      "  {\n"
+      "    total += i;\n"
+      "  }\n"
+      "  return total;\n"
+      "}\n"
+      "int func(int pCount)\n"
+      "{\n"
+      "  return sumUpTo(pCount);\n"
+      "}\n";
+
+   const int count = 100;
+   const void* argumentsData[] = { &count };
+   const Cflat::ExecutionBudget budget = { 50u, 0u };
+
+   // the loop runs within a nested call, which cannot get suspended
+   {
+      Cflat::Environment env;
+      env.setExecutionMode(Cflat::ExecutionMode::Bytecode);
+      EXPECT_TRUE(env.load("test", code));
+
+      Cflat::Value returnValue;
+      EXPECT_EQ(env.beginSlicedFunctionCall(env.getFunction("func"), argumentsData, &returnValue, budget),
+         Cflat::ExecutionStatus::CompletedOverBudget);
+      EXPECT_EQ(CflatValueAs(&returnValue, int), 5050);
+   }
+
+   // functions without bytecode cannot get sliced at all
+   {
+      Cflat::Environment env;
+      EXPECT_TRUE(env.load("test", code));
+
+      Cflat::Value returnValue;
+      EXPECT_EQ(env.beginSlicedFunctionCall(env.getFunction("func"), argumentsData, &returnValue, budget),
+         Cflat::ExecutionStatus::Failed);
+      EXPECT_TRUE(env.getErrorMessage());
+   }
+}
+
+TEST(Bytecode, TimeSlicedFunctionCallAcrossReloads)
+{
+   Cflat::Environment env;
+   env.setExecutionMode(Cflat::ExecutionMode::Bytecode);
+
+   const char* code =
+      "int getVersion()\n"
+      "{\n"
+      "  return 1;\n"
+      "}\n"
+      "int sumOfSquares(int pCount)\n"
+      "{\n"
+      "  int total = 0;\n"
+      "  for(int i = 1; i <= pCount; i++)\n"
+      "  {\n"
+      "    total += i * i;\n"
+      "  }\n"
+      "  return total;\n"
+      "}\n";
+   const char* codeWithOtherFunctionChanged =
+      "int getVersion()\n"
+      "{\n"
+      "  return 2;\n"
+      "}\n"
+      "int sumOfSquares(int pCount)\n"
+      "{\n"
+      "  int total = 0;\n"
+      "  for(int i = 1; i <= pCount; i++)\n"
+      "  {\n"
+      "    total += i * i;\n"
+      "  }\n"
+      "  return total;\n"
+      "}\n";
+   const char* codeWithSlicedFunctionChanged =
+      "int getVersion()\n"
+      "{\n"
+      "  return 2;\n"
+      "}\n"
+      "int sumOfSquares(int pCount)\n"
+      "{\n"
+      "  int total = 0;\n"
+      "  for(int i = 1; i <= pCount; i++)\n"
+      "  {\n"
+      "    total += i;\n"
+      "  }\n"
+      "  return total;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   const int count = 100;
+   const void* argumentsData[] = { &count };
+   const Cflat::ExecutionBudget budget = { 50u, 0u };
+
+   Cflat::Value returnValue;
+   EXPECT_EQ(env.beginSlicedFunctionCall(env.getFunction("sumOfSquares"), argumentsData, &returnValue, budget),
+      Cflat::ExecutionStatus::Suspended);
+
+   // the other functions can still be replaced
+   EXPECT_TRUE(env.reload("test", codeWithOtherFunctionChanged));
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("getVersion")), 2);
+
+   // but not the function being sliced, neither on reload nor on load
+   EXPECT_FALSE(env.reload("test", codeWithSlicedFunctionChanged));
+   EXPECT_EQ(strcmp(env.getErrorMessage(),
+      "[Compile Error] 'test': 'sumOfSquares' cannot be replaced while a time-sliced call to it is suspended"), 0);
+   EXPECT_FALSE(env.load("test", codeWithSlicedFunctionChanged));
+   EXPECT_TRUE(env.getErrorMessage());
+
+   Cflat::ExecutionStatus status = Cflat::ExecutionStatus::Suspended;
+   int slicesCount = 1;
+
+   while(status == Cflat::ExecutionStatus::Suspended && slicesCount < 1000)
+   {
+      status = env.resumeSlicedFunctionCall(budget);
+      slicesCount++;
+   }
+
+   EXPECT_EQ(status, Cflat::ExecutionStatus::Completed);
+   EXPECT_EQ(CflatValueAs(&returnValue, int), 338350);
+
+   // once the call has completed, the function can be replaced
+   EXPECT_TRUE(env.reload("test", codeWithSlicedFunctionChanged));
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("sumOfSquares"), &count), 5050);
+}
+
+TEST(Threading, FunctionCallsOnSeparateContexts)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int add(int pA, int pB)\n"
+      "{\n"
+      "  return pA + pB;\n"
+      "}\n"
+      "int sumUpTo(int pCount)\n"
+      "{\n"
+      "  int total = 0;\n"
+      "  for(int i = 1; i <= pCount; i++)\n"
+      "  {\n"
+      "    total = add(total, i);\n"
+      "  }\n"
+      "  return total;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* function = env.getFunction("sumUpTo");
+   EXPECT_TRUE(function);
+
+   const int kThreadsCount = 4;
+   const int kCallsCount = 200;
+   int results[kThreadsCount] = {};
+
+   Cflat::ExecutionContext* contexts[kThreadsCount];
+   std::thread threads[kThreadsCount];
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      contexts[i] = env.createExecutionContext();
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i] = std::thread([&env, function, &contexts, &results, i]()
+      {
+         env.setExecutionContext(contexts[i]);
+
+         const int count = 100 + i;
+
+         for(int j = 0; j < kCallsCount; j++)
+         {
+            results[i] += env.returnFunctionCall<int>(function, &count) == count * (count + 1) / 2;
+         }
+
+         env.setExecutionContext(nullptr);
+      });
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i].join();
+      env.destroyExecutionContext(contexts[i]);
+
+      EXPECT_EQ(results[i], kCallsCount);
+   }
+}
+
+static std::atomic<int> gStaticInitializationsCount(0);
+
+static int nativeInitializeStatic()
+{
+   gStaticInitializationsCount++;
+   return 1000;
+}
+
+TEST(Threading, StaticLocalVariablesOnSeparateContexts)
+{
+   Cflat::Environment env;
+
+   CflatRegisterNativeFunction(&env, int, nativeInitializeStatic);
+
+   const char* code =
+      "int getValue(int pIndex)\n"
+      "{\n"
+      "  static int base = nativeInitializeStatic();\n"
+      "  static int offsets[4] = { 1, 2, 3, 4 };\n"
+      "  int value = base + offsets[pIndex];\n"
+      "  {\n"
+      "    static int base = 10000;\n"
+      "    value += base;\n"
+      "  }\n"
+      "  return value;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* function = env.getFunction("getValue");
+   EXPECT_TRUE(function);
+
+   const int kThreadsCount = 4;
+   const int kCallsCount = 200;
+   int results[kThreadsCount] = {};
+
+   Cflat::ExecutionContext* contexts[kThreadsCount];
+   std::thread threads[kThreadsCount];
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      contexts[i] = env.createExecutionContext();
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i] = std::thread([&env, function, &contexts, &results, i]()
+      {
+         env.setExecutionContext(contexts[i]);
+
+         for(int j = 0; j < kCallsCount; j++)
+         {
+            results[i] += env.returnFunctionCall<int>(function, &i) == 11001 + i;
+         }
+
+         env.setExecutionContext(nullptr);
+      });
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i].join();
+      env.destroyExecutionContext(contexts[i]);
+
+      EXPECT_EQ(results[i], kCallsCount);
+   }
+
+   // the static variables got initialized once, and the global namespace got no instances added
+   EXPECT_EQ(gStaticInitializationsCount.load(), 1);
+   EXPECT_FALSE(env.getVariable("base"));
+}
+
+TEST(Threading, NestedContextBindingsOfOtherEnvironments)
+{
+   Cflat::Environment env1;
+   Cflat::Environment env2;
+
+   const char* code =
+      "int divide(int pA, int pB)\n"
+      "{\n"
+      "  return pA / pB;\n"
+      "}\n";
+
+   EXPECT_TRUE(env1.load("test", code));
+   EXPECT_TRUE(env2.load("test", code));
+
+   Cflat::ExecutionContext* context1 = env1.createExecutionContext();
+   Cflat::ExecutionContext* context2 = env2.createExecutionContext();
+   env1.setExecutionContext(context1);
+
+   const int a = 42;
+   const int b = 2;
+   const int zero = 0;
+
+   {
+      Cflat::Environment::ExecutionContextScope executionContextScope(&env2, context2);
+      env2.returnFunctionCall<int>(env2.getFunction("divide"), &a, &zero);
+      EXPECT_FALSE(context2->mErrorMessage.empty());
+   }
+
+   // unbinding another environment keeps the binding of the first one
+   env2.setExecutionContext(nullptr);
+
+   env1.returnFunctionCall<int>(env1.getFunction("divide"), &a, &zero);
+   EXPECT_FALSE(context1->mErrorMessage.empty());
+
+   EXPECT_EQ(env1.returnFunctionCall<int>(env1.getFunction("divide"), &a, &b), 21);
+   EXPECT_TRUE(context1->mErrorMessage.empty());
+
+   env1.setExecutionContext(nullptr);
+   env1.destroyExecutionContext(context1);
+   env2.destroyExecutionContext(context2);
+}
+
+TEST(Threading, BatchFunctionCallsSplitAcrossContexts)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int square(int pValue)\n"
+      "{\n"
+      "  return pValue * pValue;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* function = env.getFunction("square");
+   EXPECT_TRUE(function);
+
+   const int kThreadsCount = 4;
+   const size_t kElementsPerThread = 256u;
+   const size_t kElementsCount = kThreadsCount * kElementsPerThread;
+
+   std::vector<int> values(kElementsCount);
+   std::vector<int> results(kElementsCount, 0);
+
+   for(size_t i = 0u; i < kElementsCount; i++)
+   {
+      values[i] = (int)i;
+   }
+
+   Cflat::ExecutionContext* contexts[kThreadsCount];
+   std::thread threads[kThreadsCount];
+   size_t failedElementsCounts[kThreadsCount] = {};
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      contexts[i] = env.createExecutionContext();
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i] = std::thread([&, i]()
+      {
+         env.setExecutionContext(contexts[i]);
+
+         const size_t firstElement = i * kElementsPerThread;
+         const void* argumentsData[] = { &values[firstElement] };
+         const size_t argumentsStrides[] = { sizeof(int) };
+
+         failedElementsCounts[i] = env.batchFunctionCall(function, kElementsPerThread,
+            argumentsData, argumentsStrides, &results[firstElement], sizeof(int));
+
+         env.setExecutionContext(nullptr);
+      });
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i].join();
+      env.destroyExecutionContext(contexts[i]);
+
+      EXPECT_EQ(failedElementsCounts[i], 0u);
+   }
+
+   for(size_t i = 0u; i < kElementsCount; i++)
+   {
+      EXPECT_EQ(results[i], (int)(i * i));
+   }
+}
+
+TEST(Threading, IdentifiersCreatedConcurrently)
+{
+   const int kThreadsCount = 4;
+   const int kNamesCount = 2000;
+   const char* names[kThreadsCount][kNamesCount] = {};
+
+   std::thread threads[kThreadsCount];
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i] = std::thread([&names, i]()
+      {
+         char buffer[32];
+
+         for(int j = 0; j < kNamesCount; j++)
+         {
+            snprintf(buffer, sizeof(buffer), "concurrentName%d", j);
+            names[i][j] = Cflat::Identifier(buffer).mName;
+         }
+      });
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i].join();
+   }
+
+   for(int j = 0; j < kNamesCount; j++)
+   {
+      for(int i = 1; i < kThreadsCount; i++)
+      {
+         EXPECT_EQ(names[i][j], names[0][j]);
+      }
+   }
+
+   EXPECT_EQ(strcmp(names[0][kNamesCount - 1], "concurrentName1999"), 0);
+}
+
+TEST(Cflat, IdentifierWithCompileTimeHash)
+{
+   const Cflat::Identifier identifier = CflatIdentifier("compileTimeHashedName");
+   const Cflat::Identifier runtimeIdentifier("compileTimeHashedName");
+
+   EXPECT_EQ(identifier.mHash, runtimeIdentifier.mHash);
+   EXPECT_EQ(identifier.mName, runtimeIdentifier.mName);
+   EXPECT_TRUE(identifier == runtimeIdentifier);
+}
+
+TEST(Cflat, EmptyIdentifierWithCompileTimeHash)
+{
+   const Cflat::Identifier identifier = CflatIdentifier("");
+   const Cflat::Identifier emptyIdentifier;
+
+   EXPECT_EQ(identifier.mHash, 0u);
+   EXPECT_TRUE(identifier == emptyIdentifier);
+}
+
+TEST(Cflat, LoadFromFile)
+{
+   Cflat::Environment env;
+
+   const char* filePath = "cflat_load_from_file_test.cpp";
+   const char* code =
+      "// no directives nor macros: the tokens point into the file contents\r\n"
+      "int var1 = 42; /* block\r\n"
+      "   comment */\r\n"
+      "float var2 = 1.5f;";
+
+   FILE* file = fopen(filePath, "wb");
+   ASSERT_TRUE(file);
+   fwrite(code, 1u, strlen(code), file);
+   fclose(file);
+
+   EXPECT_TRUE(env.load(filePath));
+   remove(filePath);
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("var1"), int), 42);
+   EXPECT_FLOAT_EQ(CflatValueAs(env.getVariable("var2"), float), 1.5f);
+
+   EXPECT_FALSE(env.load("missing_file.cpp"));
+}
+
+TEST(Cflat, LoadFiles)
+{
+   Cflat::Environment env;
+
+   const char* filePaths[] =
+   {
+      "cflat_load_files_test_1.cpp",
+      "cflat_load_files_test_2.cpp",
+      "cflat_load_files_test_3.cpp",
+      "cflat_load_files_test_4.cpp"
+   };
+   const char* codes[] =
+   {
+      "struct TestStruct { int var1; int var2; };\n",
+      "#define FACTOR  3\n"
+      "int multiply(int pValue) { return pValue * FACTOR; }\n",
+      "int var1 = multiply(4);\n",
+      "TestStruct testStruct;\n"
+      "int var2 = FACTOR + var1;\n"
+   };
+   const size_t filesCount = sizeof(filePaths) / sizeof(const char*);
+
+   for(size_t i = 0u; i < filesCount; i++)
+   {
+      FILE* file = fopen(filePaths[i], "wb");
+      ASSERT_TRUE(file);
+      fwrite(codes[i], 1u, strlen(codes[i]), file);
+      fclose(file);
+   }
+
+   EXPECT_TRUE(env.loadFiles(filePaths, filesCount, 4u));
+
+   for(size_t i = 0u; i < filesCount; i++)
+   {
+      remove(filePaths[i]);
+   }
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("var1"), int), 12);
+   EXPECT_EQ(CflatValueAs(env.getVariable("var2"), int), 15);
+   EXPECT_TRUE(env.getVariable("testStruct"));
+
+   const char* missingFilePaths[] = { "missing_file.cpp" };
+   EXPECT_FALSE(env.loadFiles(missingFilePaths, 1u, 2u));
+}
+
+TEST(Threading, ClonesOnSeparateThreads)
+{
+   Cflat::Environment baseEnv;
+   CflatRegisterFunctionReturnParams2(&baseEnv, int, add, int, int);
+
+   const char* code =
+      "int total = 0;\n"
+      "int sumUpTo(int pCount)\n"
+      "{\n"
+      "  for(int i = 1; i <= pCount; i++)\n"
+      "  {\n"
+      "    total = add(total, i);\n"
+      "  }\n"
+      "  return total;\n"
+      "}\n";
+
+   const int kThreadsCount = 4;
+   bool results[kThreadsCount] = {};
+
+   std::unique_ptr<Cflat::Environment> envs[kThreadsCount];
+   std::thread threads[kThreadsCount];
+
+   // the clones get created from the thread which owns the base environment
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      envs[i].reset(new Cflat::Environment(&baseEnv));
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i] = std::thread([&envs, &results, code, i]()
+      {
+         Cflat::Environment* env = envs[i].get();
+         const int count = 100 + i;
+
+         results[i] = env->load("test", code) &&
+            env->returnFunctionCall<int>(env->getFunction("sumUpTo"), &count) == count * (count + 1) / 2;
+      });
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i].join();
+      EXPECT_TRUE(results[i]);
+   }
+}
+
+TEST(Precompiled, LoadFromPrecompiledData)
+{
+   const char* code =
+      "#define FACTOR  4\n"
+      "int multiply(int pValue)\n"
+      "{\n"
+      "  return pValue * FACTOR;\n"
+      "}\n"
+      "int result = multiply(10);\n";
+
+   CflatSTLVector(char) precompiledData;
+
+   {
+      Cflat::Environment env;
+      EXPECT_TRUE(env.loadAndPrecompile("test", code, precompiledData));
+      EXPECT_EQ(CflatValueAs(env.getVariable("result"), int), 40);
+   }
+
+   EXPECT_FALSE(precompiledData.empty());
+
+   Cflat::Environment env;
+   EXPECT_TRUE(env.isPrecompiledDataValid(code, &precompiledData[0], precompiledData.size()));
+   EXPECT_TRUE(env.loadPrecompiled("test", code, &precompiledData[0], precompiledData.size()));
+   EXPECT_EQ(CflatValueAs(env.getVariable("result"), int), 40);
+
+   // the macros defined by the program are available for the programs loaded afterwards
+   EXPECT_TRUE(env.load("test2", "int otherResult = FACTOR * 2;\n"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("otherResult"), int), 8);
+}
+
+TEST(Precompiled, OutdatedPrecompiledData)
+{
+   const char* code =
+      "int value = 10;\n";
+   const char* modifiedCode =
+      "int value = 20;\n";
+
+   CflatSTLVector(char) precompiledData;
+
+   {
+      Cflat::Environment env;
+      EXPECT_TRUE(env.loadAndPrecompile("test", code, precompiledData));
+   }
+
+   Cflat::Environment env;
+   EXPECT_FALSE(env.isPrecompiledDataValid(modifiedCode, &precompiledData[0], precompiledData.size()));
+   EXPECT_TRUE(env.loadPrecompiled("test", modifiedCode, &precompiledData[0], precompiledData.size()));
+   EXPECT_EQ(CflatValueAs(env.getVariable("value"), int), 20);
+
+   env.defineMacro("VALUE", "30");
+   EXPECT_FALSE(env.isPrecompiledDataValid(code, &precompiledData[0], precompiledData.size()));
+
+   const char invalidData[] = "invalid";
+   EXPECT_FALSE(env.isPrecompiledDataValid(code, invalidData, sizeof(invalidData)));
+   EXPECT_TRUE(env.loadPrecompiled("test", code, invalidData, sizeof(invalidData)));
+   EXPECT_EQ(CflatValueAs(env.getVariable("value"), int), 10);
+}
+
+TEST(HotReload, ChangedFunctionKeepsState)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int counter = 0;\n"
+      "void increment()\n"
+      "{\n"
+      "  counter += 1;\n"
+      "}\n"
+      "int getCounter()\n"
+      "{\n"
+      "  return counter;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* incrementFunction = env.getFunction("increment");
+   Cflat::Function* getCounterFunction = env.getFunction("getCounter");
+   env.voidFunctionCall(incrementFunction);
+   env.voidFunctionCall(incrementFunction);
+   EXPECT_EQ(env.returnFunctionCall<int>(getCounterFunction), 2);
+
+   const char* changedCode =
+      "int counter = 0;\n"
+      "void increment()\n"
+      "{\n"
+      "  counter += 10;\n"
+      "}\n"
+      "int getCounter()\n"
+      "{\n"
+      "  return counter;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.reload("test", changedCode));
+   EXPECT_EQ(env.getFunction("increment"), incrementFunction);
+   EXPECT_EQ(env.returnFunctionCall<int>(getCounterFunction), 2);
+
+   env.voidFunctionCall(incrementFunction);
+   EXPECT_EQ(env.returnFunctionCall<int>(getCounterFunction), 12);
+
+   // a compile error leaves the program as it was
+   const char* invalidCode =
+      "int counter = 0;\n"
+      "void increment()\n"
+      "{\n"
+      "  counter += undefinedVariable;\n"
+      "}\n"
+      "int getCounter()\n"
+      "{\n"
+      "  return counter;\n"
+      "}\n";
+
+   EXPECT_FALSE(env.reload("test", invalidCode));
+   EXPECT_TRUE(env.getErrorMessage());
+
+   env.voidFunctionCall(incrementFunction);
+   EXPECT_EQ(env.returnFunctionCall<int>(getCounterFunction), 22);
+}
+
+TEST(HotReload, MovedStatementsKeepStateAndGetTheirLinesUpdated)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int counter = 0;\n"
+      "int divide(int pDivisor)\n"
+      "{\n"
+      "  counter += 1;\n"
+      "  return 10 / pDivisor;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* divideFunction = env.getFunction("divide");
+   const int divisor = 0;
+   env.returnFunctionCall<int>(divideFunction, &divisor);
+   EXPECT_EQ(strcmp(env.getErrorMessage(), "[Runtime Error] 'test' -- Line 5: division by zero"), 0);
+   EXPECT_EQ(CflatValueAs(env.getVariable("counter"), int), 1);
+
+   // a line added at the top moves every statement, without forcing a full load
+   CflatSTLString movedCode("// comment\n");
+   movedCode.append(code);
+
+   EXPECT_TRUE(env.reload("test", movedCode.c_str()));
+   EXPECT_EQ(CflatValueAs(env.getVariable("counter"), int), 1);
+   EXPECT_EQ(divideFunction->mLine, 3u);
+
+   env.returnFunctionCall<int>(divideFunction, &divisor);
+   EXPECT_EQ(strcmp(env.getErrorMessage(), "[Runtime Error] 'test' -- Line 6: division by zero"), 0);
+   EXPECT_EQ(CflatValueAs(env.getVariable("counter"), int), 2);
+
+   // lines added inside a function definition make it get replaced
+   const char* changedCode =
+      "// comment\n"
+      "int counter = 0;\n"
+      "int divide(int pDivisor)\n"
+      "{\n"
+      "  counter += 1;\n"
+      "\n"
+      "  return 10 / pDivisor;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.reload("test", changedCode));
+   env.returnFunctionCall<int>(divideFunction, &divisor);
+   EXPECT_EQ(strcmp(env.getErrorMessage(), "[Runtime Error] 'test' -- Line 7: division by zero"), 0);
+   EXPECT_EQ(CflatValueAs(env.getVariable("counter"), int), 3);
+}
+
+TEST(HotReload, RepeatedReloadsDoNotGrowTheProgram)
+{
+   Cflat::DefaultAllocator allocator;
+   Cflat::Environment env(&allocator);
+
+   const char* code =
+      "int counter = 0;\n"
+      "void increment()\n"
+      "{\n"
+      "  counter += 1;\n"
+      "}\n";
+   const char* changedCode =
+      "int counter = 0;\n"
+      "void increment()\n"
+      "{\n"
+      "  int step = 10;\n"
+      "  counter += step;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   EXPECT_TRUE(env.reload("test", changedCode));
+   EXPECT_TRUE(env.reload("test", code));
+
+   // the replaced function definitions get released along with their syntax trees
+   const size_t syntaxTreeBytes = allocator.getStats(Cflat::Memory::Category::SyntaxTree).mBytes;
+
+   for(int i = 0; i < 256; i++)
+   {
+      EXPECT_TRUE(env.reload("test", (i % 2) == 0 ? changedCode : code));
+   }
+
+   EXPECT_EQ(allocator.getStats(Cflat::Memory::Category::SyntaxTree).mBytes, syntaxTreeBytes);
+
+   env.voidFunctionCall(env.getFunction("increment"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("counter"), int), 1);
+}
+
+TEST(HotReload, OtherChangesFallBackToLoad)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int counter = 5;\n"
+      "int getCounter()\n"
+      "{\n"
+      "  return counter;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Value* counterValue = env.getVariable("counter");
+   CflatValueAs(counterValue, int) = 50;
+
+   const char* changedCode =
+      "int counter = 5;\n"
+      "int offset = 1;\n"
+      "int getCounter()\n"
+      "{\n"
+      "  return counter + offset;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.reload("test", changedCode));
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("getCounter")), 6);
+}
+
+TEST(HotReload, ChangedConstant)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "const int kBonus = 5;\n"
+      "int getScore(int pBase)\n"
+      "{\n"
+      "  return pBase + kBonus * 2;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   const int base = 1;
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("getScore"), &base), 11);
+
+   const char* changedCode =
+      "const int kBonus = 50;\n"
+      "int getScore(int pBase)\n"
+      "{\n"
+      "  return pBase + kBonus * 2;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.reload("test", changedCode));
+   EXPECT_EQ(env.returnFunctionCall<int>(env.getFunction("getScore"), &base), 101);
+}
+
+TEST(HotReload, ChangedLiteralsGetReleased)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "const char* getName()\n"
+      "{\n"
+      "  return \"first name\";\n"
+      "}\n"
+      "const char* getTitle()\n"
+      "{\n"
+      "  return \"first name\";\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   EXPECT_EQ(strcmp(env.returnFunctionCall<const char*>(env.getFunction("getName")), "first name"), 0);
+
+   // equal literals share the same string
+   const Cflat::Memory::StringsPool::Stats initialStats = env.getLiteralStringsStats();
+   EXPECT_EQ(initialStats.mStringsCount, 1u);
+   EXPECT_GT(initialStats.mUsedSize, 0u);
+   EXPECT_EQ(env.returnFunctionCall<const char*>(env.getFunction("getName")),
+      env.returnFunctionCall<const char*>(env.getFunction("getTitle")));
+
+   // the literal of the replaced function gets released, and its memory reused after compacting
+   const char* changedCode =
+      "const char* getName()\n"
+      "{\n"
+      "  return \"other name\";\n"
+      "}\n"
+      "const char* getTitle()\n"
+      "{\n"
+      "  return \"first name\";\n"
+      "}\n";
+
+   for(int i = 0; i < 8; i++)
+   {
+      EXPECT_TRUE(env.reload("test", (i % 2) == 0 ? changedCode : code));
+      // "first name" is still referenced by getTitle, while "other name" is not
+      EXPECT_EQ(env.getLiteralStringsStats().mReleasedSize, (i % 2) == 0 ? 0u : initialStats.mUsedSize);
+      env.compactLiteralStrings();
+      EXPECT_EQ(env.getLiteralStringsStats().mReleasedSize, 0u);
+   }
+
+   EXPECT_EQ(strcmp(env.returnFunctionCall<const char*>(env.getFunction("getName")), "first name"), 0);
+
+   const Cflat::Memory::StringsPool::Stats reloadStats = env.getLiteralStringsStats();
+   EXPECT_EQ(reloadStats.mStringsCount, 1u);
+   EXPECT_EQ(reloadStats.mUsedSize, initialStats.mUsedSize);
+   EXPECT_EQ(reloadStats.mPeakUsedSize, initialStats.mUsedSize * 2u);
+   EXPECT_EQ(reloadStats.mReservedSize, initialStats.mReservedSize);
+
+   // so do the literals of the programs replaced by loading them again
+   const char* otherCode =
+      "const char* getName()\n"
+      "{\n"
+      "  return \"another name\";\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", otherCode));
+   EXPECT_EQ(strcmp(env.returnFunctionCall<const char*>(env.getFunction("getName")), "another name"), 0);
+   EXPECT_EQ(env.getLiteralStringsStats().mStringsCount, 1u);
+   EXPECT_EQ(env.getLiteralStringsStats().mReservedSize, initialStats.mReservedSize);
+}
+
+TEST(Cflat, LiteralStringsKeptByTheHostAcrossReloads)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "const char* getName()\n"
+      "{\n"
+      "  return \"first name\";\n"
+      "}\n";
+   const char* changedCode =
+      "const char* getName()\n"
+      "{\n"
+      "  return \"other name\";\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   const char* name = env.returnFunctionCall<const char*>(env.getFunction("getName"));
+
+   // the released literal remains intact until the host compacts the pool
+   for(int i = 0; i < 4; i++)
+   {
+      EXPECT_TRUE(env.reload("test", (i % 2) == 0 ? changedCode : code));
+      EXPECT_EQ(strcmp(env.returnFunctionCall<const char*>(env.getFunction("getName")),
+         (i % 2) == 0 ? "other name" : "first name"), 0);
+   }
+
+   EXPECT_EQ(strcmp(name, "first name"), 0);
+   EXPECT_GT(env.getLiteralStringsStats().mReleasedSize, 0u);
+
+   env.compactLiteralStrings();
+   EXPECT_EQ(env.getLiteralStringsStats().mReleasedSize, 0u);
+   EXPECT_EQ(strcmp(env.returnFunctionCall<const char*>(env.getFunction("getName")), "first name"), 0);
+}
+
+TEST(Debugging, ExpressionEvaluation)
+{
+   Cflat::Environment env;
+
+   struct TestStruct
+   {
+      int var1;
+      int var2;
+
+      int getVar1(int pFactor = 1) { return var1 * pFactor; }
+   };
+
+   {
+      CflatRegisterStruct(&env, TestStruct);
+      CflatStructAddMember(&env, TestStruct, int, var1);
+      CflatStructAddMember(&env, TestStruct, int, var2);
+      CflatStructAddMethodReturn(&env, TestStruct, int, getVar1);
+      CflatStructAddMethodReturnParams1(&env, TestStruct, int, getVar1, int);
+   }
+
+   const char* code =
+      "float testValue = 42.0f;\n"
+      "TestStruct testStruct;\n"
+      "testStruct.var1 = 42;\n"
+      "testStruct.var2 = 100;\n"
+      "int unused = 0;\n";
+
+   env.setExecutionHook([](Cflat::Environment* pEnvironment, const Cflat::CallStack& pCallStack)
+   {
+      if(!pCallStack.empty() && pCallStack.back().mLine == 6u)
+      {
+         Cflat::Value testValue;
+         EXPECT_TRUE(pEnvironment->evaluateExpression("testValue", &testValue));
+         EXPECT_FLOAT_EQ(CflatValueAs(&testValue, float), 42.0f);
 
          Cflat::Value var1;
          EXPECT_TRUE(pEnvironment->evaluateExpression("testStruct.var1", &var1));
@@ -3047,6 +4992,507 @@ TEST(Debugging, ExpressionEvaluation)
    EXPECT_TRUE(env.load("test", code));
 }
 
+TEST(Debugging, ExpressionEvaluationOutsideExecution)
+{
+   Cflat::DefaultAllocator allocator;
+   Cflat::Environment env(&allocator);
+
+   const char* code =
+      "float testValue = 42.0f;\n"
+      "int getValue(int pFactor)\n"
+      "{\n"
+      "  return 10 * pFactor;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Value literal;
+   EXPECT_TRUE(env.evaluateExpression("100", &literal));
+   EXPECT_EQ(CflatValueAs(&literal, int), 100);
+
+   Cflat::Value testValue;
+   EXPECT_TRUE(env.evaluateExpression("testValue", &testValue));
+   EXPECT_FLOAT_EQ(CflatValueAs(&testValue, float), 42.0f);
+
+   EXPECT_FALSE(env.evaluateExpression("undefinedVariable", &testValue));
+
+   // the nodes of the evaluated expressions do not pile up in the program
+   Cflat::Value warmUpValue;
+   EXPECT_TRUE(env.evaluateExpression("getValue(2) + 1", &warmUpValue));
+
+   const size_t syntaxTreeBytes = allocator.getStats(Cflat::Memory::Category::SyntaxTree).mBytes;
+
+   for(int i = 0; i < 256; i++)
+   {
+      Cflat::Value value;
+      EXPECT_TRUE(env.evaluateExpression("getValue(2) + 1", &value));
+      EXPECT_EQ(CflatValueAs(&value, int), 21);
+   }
+
+   EXPECT_EQ(allocator.getStats(Cflat::Memory::Category::SyntaxTree).mBytes, syntaxTreeBytes);
+}
+
+TEST(Debugging, Profiler)
+{
+   Cflat::Environment env;
+
+   CflatRegisterNativeFunction(&env, void, nativeAccumulate, int&, int);
+
+   const char* code =
+      "int total = 0;\n"
+      "void accumulate(int pValue)\n"
+      "{\n"
+      "  nativeAccumulate(total, pValue);\n"
+      "}\n"
+      "void func()\n"
+      "{\n"
+      "  for(int i = 0; i < 4; i++)\n"
+      "  {\n"
+      "    accumulate(i);\n"
+      "  }\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Profiler profiler(true);
+   env.setProfiler(&profiler);
+   env.voidFunctionCall(env.getFunction("func"));
+   env.setProfiler(nullptr);
+
+   EXPECT_EQ(CflatValueAs(env.getVariable("total"), int), 6);
+
+   const Cflat::Profiler::FunctionRecord* funcRecord = profiler.getFunctionRecord("func");
+   ASSERT_TRUE(funcRecord);
+   EXPECT_EQ(funcRecord->mCallsCount, 1u);
+
+   const Cflat::Profiler::FunctionRecord* accumulateRecord = profiler.getFunctionRecord("accumulate");
+   ASSERT_TRUE(accumulateRecord);
+   EXPECT_EQ(accumulateRecord->mCallsCount, 4u);
+
+   const Cflat::Profiler::FunctionRecord* nativeRecord =
+      profiler.getFunctionRecord("nativeAccumulate");
+   ASSERT_TRUE(nativeRecord);
+   EXPECT_EQ(nativeRecord->mCallsCount, 4u);
+
+   EXPECT_GE(funcRecord->mInclusiveTime, accumulateRecord->mInclusiveTime);
+   EXPECT_GE(accumulateRecord->mInclusiveTime,
+      accumulateRecord->mExclusiveTime + nativeRecord->mInclusiveTime);
+
+   const Cflat::Profiler::LineRecord* loopBodyRecord = profiler.getLineRecord("test", 10u);
+   ASSERT_TRUE(loopBodyRecord);
+   EXPECT_EQ(loopBodyRecord->mExecutionsCount, 4u);
+
+   const Cflat::Profiler::LineRecord* nativeCallRecord = profiler.getLineRecord("test", 4u);
+   ASSERT_TRUE(nativeCallRecord);
+   EXPECT_EQ(nativeCallRecord->mExecutionsCount, 4u);
+
+   EXPECT_EQ(profiler.getTraceEvents().size(), 9u);
+
+   CflatSTLString trace;
+   profiler.writeChromeTrace(&trace);
+   EXPECT_EQ(trace.find("{\"traceEvents\":["), 0u);
+   EXPECT_NE(trace.find("\"name\":\"nativeAccumulate\""), std::string::npos);
+
+   CflatSTLString report;
+   profiler.writeReport(&report);
+   EXPECT_NE(report.find("accumulate"), std::string::npos);
+   EXPECT_NE(report.find("test:10"), std::string::npos);
+}
+
+TEST(Debugging, ProfilersOnSeparateContexts)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int accumulate(int pTotal, int pValue)\n"
+      "{\n"
+      "  return pTotal + pValue;\n"
+      "}\n"
+      "int func(int pCount)\n"
+      "{\n"
+      "  int total = 0;\n"
+      "  for(int i = 0; i < pCount; i++)\n"
+      "  {\n"
+      "    total = accumulate(total, i);\n"
+      "  }\n"
+      "  return total;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* function = env.getFunction("func");
+
+   const int kThreadsCount = 4;
+   const int kCount = 50;
+
+   Cflat::ExecutionContext* contexts[kThreadsCount];
+   Cflat::Profiler* profilers[kThreadsCount];
+   std::thread threads[kThreadsCount];
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      contexts[i] = env.createExecutionContext();
+      profilers[i] = new Cflat::Profiler(true);
+   }
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i] = std::thread([&env, function, &contexts, &profilers, i]()
+      {
+         env.setExecutionContext(contexts[i]);
+         env.setProfiler(profilers[i]);
+
+         const int count = kCount;
+         EXPECT_EQ(env.returnFunctionCall<int>(function, &count), count * (count - 1) / 2);
+
+         env.setProfiler(nullptr);
+         env.setExecutionContext(nullptr);
+      });
+   }
+
+   Cflat::Profiler profiler(true);
+
+   for(int i = 0; i < kThreadsCount; i++)
+   {
+      threads[i].join();
+      env.destroyExecutionContext(contexts[i]);
+
+      profiler.merge(*profilers[i]);
+      delete profilers[i];
+   }
+
+   const Cflat::Profiler::FunctionRecord* funcRecord = profiler.getFunctionRecord("func");
+   ASSERT_TRUE(funcRecord);
+   EXPECT_EQ(funcRecord->mCallsCount, (uint64_t)kThreadsCount);
+
+   const Cflat::Profiler::FunctionRecord* accumulateRecord = profiler.getFunctionRecord("accumulate");
+   ASSERT_TRUE(accumulateRecord);
+   EXPECT_EQ(accumulateRecord->mCallsCount, (uint64_t)(kThreadsCount * kCount));
+
+   const Cflat::Profiler::LineRecord* loopBodyRecord = profiler.getLineRecord("test", 10u);
+   ASSERT_TRUE(loopBodyRecord);
+   EXPECT_EQ(loopBodyRecord->mExecutionsCount, (uint64_t)(kThreadsCount * kCount));
+
+   EXPECT_EQ(profiler.getTraceEvents().size(), (size_t)(kThreadsCount * (kCount + 1)));
+
+   CflatSTLString trace;
+   profiler.writeChromeTrace(&trace);
+   EXPECT_NE(trace.find("\"tid\":4"), std::string::npos);
+}
+
+TEST(Debugging, LightweightHooks)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int total = 0;\n"
+      "void accumulate(int pValue)\n"
+      "{\n"
+      "  total += pValue;\n"
+      "}\n"
+      "void func()\n"
+      "{\n"
+      "  for(int i = 0; i < 100; i++) accumulate(i);\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   static int functionEnterCount = 0;
+   static int functionExitCount = 0;
+   static int lineChangesCount = 0;
+   static int samplesCount = 0;
+   static int timerTicksCount = 0;
+
+   env.setFunctionHook([](Cflat::Environment*, const Cflat::CallStack& pCallStack,
+      Cflat::FunctionHookEvent pEvent)
+   {
+      EXPECT_FALSE(pCallStack.empty());
+      (pEvent == Cflat::FunctionHookEvent::Enter ? functionEnterCount : functionExitCount)++;
+   });
+   env.setLineHook([](Cflat::Environment*, const Cflat::CallStack&)
+   {
+      lineChangesCount++;
+   });
+   env.setSampledHook([](Cflat::Environment*, const Cflat::CallStack&)
+   {
+      samplesCount++;
+   }, 10u);
+   env.setTimerHook([](Cflat::Environment*, const Cflat::CallStack&)
+   {
+      timerTicksCount++;
+   }, 0u);
+
+   env.voidFunctionCall(env.getFunction("func"));
+   EXPECT_EQ(CflatValueAs(env.getVariable("total"), int), 4950);
+
+   EXPECT_EQ(functionEnterCount, 101);
+   EXPECT_EQ(functionExitCount, 101);
+
+   // body and loop of 'func', then the body and the statement of 'accumulate' on each call,
+   // and back to the loop after each call but the last one
+   EXPECT_EQ(lineChangesCount, 301);
+   EXPECT_GT(samplesCount, 0);
+   EXPECT_GT(timerTicksCount, 0);
+
+   env.setFunctionHook(nullptr);
+   env.setLineHook(nullptr);
+   env.setSampledHook(nullptr, 0u);
+   env.setTimerHook(nullptr, 0u);
+
+   const int previousSamplesCount = samplesCount;
+   env.voidFunctionCall(env.getFunction("func"));
+
+   EXPECT_EQ(functionEnterCount, 101);
+   EXPECT_EQ(samplesCount, previousSamplesCount);
+}
+
+TEST(Cflat, TimerHookMeasuresEachCall)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int total = 0;\n"
+      "void func()\n"
+      "{\n"
+      "  for(int i = 0; i < 100; i++)\n"
+      "  {\n"
+      "    total += i;\n"
+      "  }\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   static int timerTicksCount = 0;
+
+   env.setTimerHook([](Cflat::Environment*, const Cflat::CallStack&)
+   {
+      timerTicksCount++;
+   }, 50000u);
+
+   env.voidFunctionCall(env.getFunction("func"));
+   std::this_thread::sleep_for(std::chrono::milliseconds(100));
+   env.voidFunctionCall(env.getFunction("func"));
+
+   // the time between the calls does not count towards the interval
+   EXPECT_EQ(timerTicksCount, 0);
+
+   env.setTimerHook(nullptr, 0u);
+}
+
+TEST(Memory, AllocatorPerEnvironment)
+{
+   Cflat::DefaultAllocator allocator1;
+   Cflat::DefaultAllocator allocator2;
+
+   {
+      Cflat::Environment env1(&allocator1);
+      Cflat::Environment env2(&allocator2);
+
+      EXPECT_EQ(env1.getAllocator(), &allocator1);
+      EXPECT_EQ(env2.getAllocator(), &allocator2);
+
+      const char* code =
+         "struct TestStruct\n"
+         "{\n"
+         "  int a; int b; int c; int d; int e;\n"
+         "};\n"
+         "TestStruct testStruct;\n"
+         "int func(int pValue)\n"
+         "{\n"
+         "  TestStruct copy = testStruct;\n"
+         "  copy.e = pValue;\n"
+         "  return copy.e;\n"
+         "}\n";
+
+      EXPECT_TRUE(env1.load("test", code));
+
+      const int value = 3;
+      EXPECT_EQ(env1.returnFunctionCall<int>(env1.getFunction("func"), &value), 3);
+
+      EXPECT_GT(allocator1.getStats(Cflat::Memory::Category::SyntaxTree).mBytes, 0u);
+      EXPECT_GT(allocator1.getStats(Cflat::Memory::Category::Types).mBytes, 0u);
+      EXPECT_GT(allocator1.getStats(Cflat::Memory::Category::Containers).mBytes, 0u);
+      EXPECT_GT(allocator1.getStats(Cflat::Memory::Category::Values).mTotalAllocationsCount, 0u);
+
+      // nothing loaded in the second environment, and identifiers are shared by all of them
+      EXPECT_EQ(allocator2.getStats(Cflat::Memory::Category::SyntaxTree).mBytes, 0u);
+      EXPECT_GT(allocator2.getStats(Cflat::Memory::Category::Types).mBytes, 0u);
+      EXPECT_EQ(allocator1.getStats(Cflat::Memory::Category::Identifiers).mTotalAllocationsCount, 0u);
+      EXPECT_EQ(allocator2.getStats(Cflat::Memory::Category::Identifiers).mTotalAllocationsCount, 0u);
+   }
+
+   EXPECT_EQ(allocator1.getStats().mBytes, 0u);
+   EXPECT_EQ(allocator1.getStats().mAllocationsCount, 0u);
+   EXPECT_EQ(allocator2.getStats().mBytes, 0u);
+   EXPECT_EQ(allocator2.getStats().mAllocationsCount, 0u);
+}
+
+TEST(Memory, CustomAllocator)
+{
+   // keeps a budget for the syntax trees, and counts the calls per category
+   class TestAllocator : public Cflat::Allocator
+   {
+   public:
+      size_t mSyntaxTreeBudget;
+      size_t mSyntaxTreeBytes;
+      size_t mCallsCount[(size_t)Cflat::Memory::Category::Count];
+
+      TestAllocator(size_t pSyntaxTreeBudget)
+         : mSyntaxTreeBudget(pSyntaxTreeBudget)
+         , mSyntaxTreeBytes(0u)
+         , mCallsCount()
+      {
+      }
+
+      virtual void* allocate(size_t pSize, Cflat::Memory::Category pCategory) override
+      {
+         if(pCategory == Cflat::Memory::Category::SyntaxTree)
+         {
+            mSyntaxTreeBytes += pSize;
+         }
+
+         mCallsCount[(size_t)pCategory]++;
+         return malloc(pSize);
+      }
+      virtual void deallocate(void* pPtr, size_t pSize, Cflat::Memory::Category pCategory) override
+      {
+         if(pCategory == Cflat::Memory::Category::SyntaxTree)
+         {
+            mSyntaxTreeBytes -= pSize;
+         }
+
+         free(pPtr);
+      }
+   };
+
+   TestAllocator allocator(1024u * 1024u);
+
+   {
+      Cflat::Environment env(&allocator);
+
+      const char* code =
+         "int var = 42;\n";
+
+      EXPECT_TRUE(env.load("test", code));
+      EXPECT_EQ(CflatValueAs(env.getVariable("var"), int), 42);
+
+      EXPECT_GT(allocator.mSyntaxTreeBytes, 0u);
+      EXPECT_LE(allocator.mSyntaxTreeBytes, allocator.mSyntaxTreeBudget);
+
+      const Cflat::Allocator::Stats stats = allocator.getStats(Cflat::Memory::Category::Containers);
+      EXPECT_EQ(stats.mTotalAllocationsCount,
+         allocator.mCallsCount[(size_t)Cflat::Memory::Category::Containers]);
+   }
+
+   EXPECT_EQ(allocator.mSyntaxTreeBytes, 0u);
+   EXPECT_EQ(allocator.getStats().mAllocationsCount, 0u);
+}
+
+TEST(Memory, IdentifierNamesStats)
+{
+   Cflat::Identifier::NamesRegistry* names = Cflat::Identifier::getNamesRegistry();
+   const Cflat::Identifier::NamesRegistry::Stats initialStats = names->getStats();
+
+   Cflat::Identifier identifier("identifierNamesStatsTest");
+   Cflat::Identifier sameIdentifier("identifierNamesStatsTest");
+
+   const Cflat::Identifier::NamesRegistry::Stats stats = names->getStats();
+   EXPECT_EQ(stats.mNamesCount, initialStats.mNamesCount + 1u);
+   EXPECT_EQ(stats.mUsedSize, initialStats.mUsedSize + strlen("identifierNamesStatsTest") + 1u);
+   EXPECT_GE(stats.mReservedSize, stats.mUsedSize + stats.mTableCapacity);
+   EXPECT_GE(stats.mTableCapacity, stats.mNamesCount * 2u);
+}
+
+static int scaleValue(int pValue)
+{
+   return pValue * 3;
+}
+
+TEST(Cloning, SharedRegistrations)
+{
+   struct TestStruct
+   {
+      int value;
+
+      int getDoubleValue() { return value * 2; }
+   };
+
+   Cflat::Environment baseEnv;
+   baseEnv.defineMacro("SCALE(x)", "scaleValue(x)");
+
+   CflatRegisterFunctionReturnParams1(&baseEnv, int, scaleValue, int);
+
+   {
+      CflatRegisterStruct(&baseEnv, TestStruct);
+      CflatStructAddMember(&baseEnv, TestStruct, int, value);
+      CflatStructAddMethodReturn(&baseEnv, TestStruct, int, getDoubleValue);
+   }
+
+   const int level = 5;
+   Cflat::Value levelValue;
+   levelValue.initOnHeap(baseEnv.getTypeUsage("int"));
+   levelValue.set(&level);
+   baseEnv.setVariable(levelValue.mTypeUsage, "Game::level", levelValue);
+
+   Cflat::Environment env(&baseEnv);
+
+   // types and functions are the same ones, whereas variables are copies
+   EXPECT_EQ(env.getTypeUsage("int").mType, baseEnv.getTypeUsage("int").mType);
+   EXPECT_EQ(env.getType("TestStruct"), baseEnv.getType("TestStruct"));
+   EXPECT_EQ(env.getFunction("scaleValue"), baseEnv.getFunction("scaleValue"));
+   EXPECT_NE(env.getVariable("Game::level"), baseEnv.getVariable("Game::level"));
+
+   const char* code =
+      "TestStruct testStruct;\n"
+      "testStruct.value = SCALE(Game::level);\n"
+      "int doubleValue = testStruct.getDoubleValue();\n"
+      "Game::level = 10;\n";
+
+   EXPECT_TRUE(env.load("test", code));
+   EXPECT_EQ(CflatValueAs(env.getVariable("doubleValue"), int), 30);
+   EXPECT_EQ(CflatValueAs(env.getVariable("Game::level"), int), 10);
+
+   EXPECT_EQ(CflatValueAs(baseEnv.getVariable("Game::level"), int), 5);
+   EXPECT_FALSE(baseEnv.getVariable("doubleValue"));
+}
+
+TEST(Cloning, IndependentClones)
+{
+   Cflat::Environment baseEnv;
+   CflatRegisterFunctionReturnParams1(&baseEnv, int, scaleValue, int);
+
+   Cflat::Environment env2(&baseEnv);
+
+   const char* code2 =
+      "int result = scaleValue(2);\n";
+
+   EXPECT_TRUE(env2.load("test", code2));
+
+   // redefining a shared function does not alter the base environment
+   {
+      Cflat::Environment env1(&baseEnv);
+
+      const char* code1 =
+         "int scaleValue(int pValue)\n"
+         "{\n"
+         "  return pValue * 10;\n"
+         "}\n"
+         "struct TestStruct { int value; };\n"
+         "int result = scaleValue(2);\n";
+
+      EXPECT_TRUE(env1.load("test", code1));
+      EXPECT_EQ(CflatValueAs(env1.getVariable("result"), int), 20);
+      EXPECT_NE(env1.getFunction("scaleValue"), baseEnv.getFunction("scaleValue"));
+      EXPECT_FALSE(baseEnv.getType("TestStruct"));
+   }
+
+   EXPECT_EQ(CflatValueAs(env2.getVariable("result"), int), 6);
+
+   const int value = 2;
+   EXPECT_EQ(env2.returnFunctionCall<int>(env2.getFunction("scaleValue"), &value), 6);
+   EXPECT_EQ(baseEnv.returnFunctionCall<int>(baseEnv.getFunction("scaleValue"), &value), 6);
+}
+
 TEST(PreprocessorErrors, InvalidMacroArgumentCount)
 {
    Cflat::Environment env;
@@ -3072,6 +5518,21 @@ TEST(CompileErrors, VoidVariable)
       "[Compile Error] 'test' -- Line 1: invalid type ('void')"), 0);
 }
 
+TEST(CompileErrors, LineAfterComments)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "/* block\n"
+      "   comment */\n"
+      "int var1 = 0; // line comment\n"
+      "void var2;\n";
+
+   EXPECT_FALSE(env.load("test", code));
+   EXPECT_EQ(strcmp(env.getErrorMessage(),
+      "[Compile Error] 'test' -- Line 4: invalid type ('void')"), 0);
+}
+
 TEST(CompileErrors, InvalidAssignment)
 {
    Cflat::Environment env;
@@ -3176,3 +5637,36 @@ TEST(RuntimeErrors, DivisionByZero)
    EXPECT_EQ(strcmp(env.getErrorMessage(),
       "[Runtime Error] 'test' -- Line 1: division by zero"), 0);
 }
+
+TEST(RuntimeErrors, ErrorPerExecutionContext)
+{
+   Cflat::Environment env;
+
+   const char* code =
+      "int divide(int pA, int pB)\n"
+      "{\n"
+      "  return pA / pB;\n"
+      "}\n";
+
+   EXPECT_TRUE(env.load("test", code));
+
+   Cflat::Function* function = env.getFunction("divide");
+   Cflat::ExecutionContext* context = env.createExecutionContext();
+
+   const int dividend = 10;
+   const int divisor = 0;
+
+   env.setExecutionContext(context);
+   env.returnFunctionCall<int>(function, &dividend, &divisor);
+   EXPECT_EQ(strcmp(env.getErrorMessage(),
+      "[Runtime Error] 'test' -- Line 3: division by zero"), 0);
+
+   env.setExecutionContext(nullptr);
+   EXPECT_FALSE(env.getErrorMessage());
+
+   const int validDivisor = 2;
+   EXPECT_EQ(env.returnFunctionCall<int>(function, &dividend, &validDivisor), 5);
+   EXPECT_FALSE(env.getErrorMessage());
+
+   env.destroyExecutionContext(context);
+}